@@ -0,0 +1,76 @@
+#include "EditorComponentsPch.h"
+#include "ResourceMemoryWindow.h"
+#include "Resources\ResidencyManager.h"
+
+namespace DerydocaEngine::Components
+{
+
+	// Formats a number of bytes as megabytes, or a dash when there is nothing to show
+	static std::string formatMegabytes(size_t const& bytes)
+	{
+		if (bytes == 0)
+		{
+			return "-";
+		}
+
+		char text[32];
+		snprintf(text, sizeof(text), "%.2f MB", bytes / (1024.0f * 1024.0f));
+		return text;
+	}
+
+	ResourceMemoryWindow::ResourceMemoryWindow()
+	{
+	}
+
+	ResourceMemoryWindow::~ResourceMemoryWindow()
+	{
+	}
+
+	void ResourceMemoryWindow::renderWindow()
+	{
+		ImGui::Columns(7, "ResourceMemoryColumns");
+		ImGui::Text("Type");
+		ImGui::NextColumn();
+		ImGui::Text("Resident");
+		ImGui::NextColumn();
+		ImGui::Text("Referenced");
+		ImGui::NextColumn();
+		ImGui::Text("CPU");
+		ImGui::NextColumn();
+		ImGui::Text("GPU");
+		ImGui::NextColumn();
+		ImGui::Text("Budget (CPU/GPU)");
+		ImGui::NextColumn();
+		ImGui::Text("Unloaded");
+		ImGui::NextColumn();
+		ImGui::Separator();
+
+		size_t totalCpuBytes = 0;
+		size_t totalGpuBytes = 0;
+		for (auto const& typeStatistics : Resources::ResidencyManager::getInstance().getStatistics())
+		{
+			totalCpuBytes += typeStatistics.cpuBytes;
+			totalGpuBytes += typeStatistics.gpuBytes;
+
+			ImGui::Text("%s", typeStatistics.name.c_str());
+			ImGui::NextColumn();
+			ImGui::Text("%zu", typeStatistics.residentCount);
+			ImGui::NextColumn();
+			ImGui::Text("%zu", typeStatistics.referencedCount);
+			ImGui::NextColumn();
+			ImGui::Text("%s", formatMegabytes(typeStatistics.cpuBytes).c_str());
+			ImGui::NextColumn();
+			ImGui::Text("%s", formatMegabytes(typeStatistics.gpuBytes).c_str());
+			ImGui::NextColumn();
+			ImGui::Text("%s / %s", formatMegabytes(typeStatistics.cpuBudget).c_str(), formatMegabytes(typeStatistics.gpuBudget).c_str());
+			ImGui::NextColumn();
+			ImGui::Text("%zu", typeStatistics.evictionCount);
+			ImGui::NextColumn();
+		}
+
+		ImGui::Columns(1);
+		ImGui::Separator();
+		ImGui::Text("Total: %s CPU, %s GPU", formatMegabytes(totalCpuBytes).c_str(), formatMegabytes(totalGpuBytes).c_str());
+	}
+
+}
\ No newline at end of file
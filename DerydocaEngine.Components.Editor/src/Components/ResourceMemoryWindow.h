@@ -0,0 +1,19 @@
+#pragma once
+#include "Components\EditorWindowComponent.h"
+
+namespace DerydocaEngine::Components
+{
+	class ResourceMemoryWindow : public EditorWindowComponent, SelfRegister<ResourceMemoryWindow>
+	{
+	public:
+		GENINSTANCE(ResourceMemoryWindow);
+
+		ResourceMemoryWindow();
+		~ResourceMemoryWindow();
+
+		virtual void renderWindow();
+		virtual std::string getWindowTitle() { return "Resource Memory"; }
+		virtual ImGuiWindowFlags getWindowFlags() { return 0; }
+	private:
+	};
+}
\ No newline at end of file
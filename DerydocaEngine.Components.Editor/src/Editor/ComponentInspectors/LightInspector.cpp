@@ -11,7 +11,23 @@ void DerydocaEngine::Editor::Inspector::ComponentInspectors::LightInspector::ren
 	if (light->isCastingShadows())
 	{
 		ImGui::SliderFloat("Shadow Softness", &light->getShadowSoftness(), 0.0f, 0.03f);
-		Dgui::InputProjection("Shadow Projection", light->getProjection());
+		if (light->usesShadowCascades())
+		{
+			ImGui::SliderInt("Shadow Cascades", &light->getShadowCascadeCount(), 1, Rendering::ShadowCascades::MAX_CASCADES);
+			ImGui::Combo("Cascade Split Scheme", (int*)&light->getShadowCascadeSplitScheme(), "Uniform\0Logarithmic\0Practical\0");
+			ImGui::SliderFloat("Cascade Split Lambda", &light->getShadowCascadeSplitLambda(), 0.0f, 1.0f);
+			ImGui::DragFloat("Shadow Distance", &light->getShadowDistance(), 1.0f, 1.0f, 10000.0f);
+			ImGui::DragFloat("Shadow Caster Distance", &light->getShadowCasterDistance(), 1.0f, 0.0f, 10000.0f);
+			for (int i = 0; i < light->getShadowCascadeCount(); i++)
+			{
+				std::string intervalLabel = "Cascade " + std::to_string(i) + " Update Interval";
+				ImGui::SliderInt(intervalLabel.c_str(), &light->getShadowCascadeUpdateInterval(i), 1, 8);
+			}
+		}
+		else
+		{
+			Dgui::InputProjection("Shadow Projection", light->getProjection());
+		}
 	}
 
 }
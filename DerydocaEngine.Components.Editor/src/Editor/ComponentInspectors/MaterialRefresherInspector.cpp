@@ -5,5 +5,9 @@ void DerydocaEngine::Editor::Inspector::ComponentInspectors::MaterialRefresherIn
 {
 	auto materialRefresher = std::static_pointer_cast<Components::MaterialRefresher>(object);
 
-	ImGui::TextWrapped("This will refresh a material attached to this object whenever the source files have been modified.");
+	ImGui::TextWrapped("Shaders are reloaded automatically whenever their source files change. This recompiles the shader of the material attached to this object on request.");
+	if (ImGui::Button("Refresh"))
+	{
+		materialRefresher->refreshMaterial();
+	}
 }
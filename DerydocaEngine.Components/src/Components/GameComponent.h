@@ -8,6 +8,7 @@
 #include "GameObject.h"
 #include "ObjectLibrary.h"
 #include "Helpers\YamlTools.h"
+#include "Resources\ResourceLoader.h"
 #include "TypeNameLookup.h"
 
 struct Resource;
@@ -156,6 +157,27 @@ namespace DerydocaEngine::Components
 			return ObjectLibrary::getInstance().getResourceObjectPointer<T>(resourceId);
 		}
 
+		/*
+		Starts loading a resource without waiting for it. The component should render a fallback
+		until the handle is resident.
+
+		@param node Node the resource ID is stored in
+		@param resourceName Name of the field holding the resource ID
+		@return Handle of the load, or null if the resource could not be found
+		*/
+		inline std::shared_ptr<Resources::ResourceHandle> loadResourceAsync(const YAML::Node& node, const std::string& resourceName)
+		{
+			YAML::Node resourceIdNode = node[resourceName];
+			if (resourceIdNode == nullptr || !resourceIdNode.IsScalar())
+			{
+				return nullptr;
+			}
+
+			boost::uuids::uuid resourceId = resourceIdNode.as<boost::uuids::uuid>();
+
+			return Resources::ResourceLoader::getInstance().load(ObjectLibrary::getInstance().getResource(resourceId));
+		}
+
 		template<typename T>
 		inline std::vector<std::shared_ptr<T>> loadComponents(const YAML::Node& node, const std::string& componentCollectionName)
 		{
@@ -3,6 +3,8 @@
 
 #include <GL\glew.h>
 #include <iostream>
+#include "Components\Camera.h"
+#include "Rendering\GeometryArena.h"
 #include "Rendering\LightManager.h"
 #include "Rendering\Material.h"
 #include "Rendering\GraphicsAPI.h"
@@ -22,11 +24,25 @@ namespace DerydocaEngine::Components
 		m_shadowFBO(0),
 		m_matrixStack(std::make_shared<Rendering::MatrixStack>()),
 		m_shadowMapMaterial(nullptr),
+		m_indirectDrawKeywords({ "INDIRECT_DRAW" }),
 		m_projection(),
 		m_shadowBias(),
 		m_shadowMapFilterType(ShadowMapFilterType::Nearest),
-		m_shadowSoftness(0.01f)
+		m_shadowSoftness(0.01f),
+		m_shadowCascadeCount(1),
+		m_shadowCascadeSplitScheme(Rendering::ShadowCascades::SplitScheme::Practical),
+		m_shadowCascadeSplitLambda(0.75f),
+		m_shadowDistance(100.0f),
+		m_shadowCasterDistance(50.0f),
+		m_shadowCascadeUpdateIntervals(),
+		m_cascadeProjections(),
+		m_cascadeShadowMatrices(),
+		m_cascadeSplitDepths(),
+		m_shadowCascadeFrame(0),
+		m_lastShadowCascadeCount(0)
 	{
+		m_shadowCascadeUpdateIntervals.fill(1);
+		m_cascadeSplitDepths.fill(0.0f);
 	}
 
 	Light::~Light()
@@ -45,10 +61,28 @@ namespace DerydocaEngine::Components
 
 	glm::mat4 Light::getShadowMatrix(glm::mat4 const& objectModelMatrix)
 	{
+		// Shaders that are not cascade aware fall back to the cascade covering the largest area
+		if (usesShadowCascades())
+		{
+			return getCascadeShadowMatrix(glm::clamp(m_shadowCascadeCount, 1, Rendering::ShadowCascades::MAX_CASCADES) - 1, objectModelMatrix);
+		}
+
 		glm::mat4 model = getGameObject()->getTransform()->getModel();
 		return (m_shadowBias * m_projection.getProjectionMatrix() * m_projection.getViewMatrix(model)) * objectModelMatrix;
 	}
 
+	glm::vec4 Light::getCascadeSplitDepths() const
+	{
+		// Pad unused cascades with the last split so they are never selected
+		int cascadeCount = glm::clamp(m_shadowCascadeCount, 1, Rendering::ShadowCascades::MAX_CASCADES);
+		glm::vec4 splits;
+		for (int i = 0; i < Rendering::ShadowCascades::MAX_CASCADES; i++)
+		{
+			splits[i] = m_cascadeSplitDepths[glm::min(i, cascadeCount - 1)];
+		}
+		return splits;
+	}
+
 	void Light::init()
 	{
 		auto sp = std::static_pointer_cast<Light>(shared_from_this());
@@ -108,6 +142,45 @@ namespace DerydocaEngine::Components
 		{
 			m_shadowSoftness = shadowSoftnessNode.as<float>();
 		}
+
+		YAML::Node shadowCascadeCountNode = node["shadowCascadeCount"];
+		if (shadowCascadeCountNode)
+		{
+			m_shadowCascadeCount = glm::clamp(shadowCascadeCountNode.as<int>(), 1, Rendering::ShadowCascades::MAX_CASCADES);
+		}
+
+		YAML::Node shadowCascadeSplitSchemeNode = node["shadowCascadeSplitScheme"];
+		if (shadowCascadeSplitSchemeNode)
+		{
+			m_shadowCascadeSplitScheme = (Rendering::ShadowCascades::SplitScheme)shadowCascadeSplitSchemeNode.as<int>();
+		}
+
+		YAML::Node shadowCascadeSplitLambdaNode = node["shadowCascadeSplitLambda"];
+		if (shadowCascadeSplitLambdaNode)
+		{
+			m_shadowCascadeSplitLambda = shadowCascadeSplitLambdaNode.as<float>();
+		}
+
+		YAML::Node shadowDistanceNode = node["shadowDistance"];
+		if (shadowDistanceNode)
+		{
+			m_shadowDistance = shadowDistanceNode.as<float>();
+		}
+
+		YAML::Node shadowCasterDistanceNode = node["shadowCasterDistance"];
+		if (shadowCasterDistanceNode)
+		{
+			m_shadowCasterDistance = shadowCasterDistanceNode.as<float>();
+		}
+
+		YAML::Node shadowCascadeUpdateIntervalsNode = node["shadowCascadeUpdateIntervals"];
+		if (shadowCascadeUpdateIntervalsNode && shadowCascadeUpdateIntervalsNode.IsSequence())
+		{
+			for (size_t i = 0; i < shadowCascadeUpdateIntervalsNode.size() && i < m_shadowCascadeUpdateIntervals.size(); i++)
+			{
+				m_shadowCascadeUpdateIntervals[i] = glm::max(shadowCascadeUpdateIntervalsNode[i].as<int>(), 1);
+			}
+		}
 	}
 
 	void Light::preDestroy()
@@ -116,8 +189,14 @@ namespace DerydocaEngine::Components
 		Rendering::LightManager::getInstance().removeLight(sp);
 	}
 
-	void Light::renderShadowMap(const std::vector<std::shared_ptr<Scenes::Scene>> scenes)
+	void Light::renderShadowMap(const std::vector<std::shared_ptr<Scenes::Scene>> scenes, std::shared_ptr<Camera> const& camera)
 	{
+		if (usesShadowCascades() && camera)
+		{
+			renderShadowCascades(scenes, camera);
+			return;
+		}
+
 		auto prevFramebufferId = Rendering::GraphicsAPI::getCurrentFramebufferID();
 		Rendering::GraphicsAPI::bindFramebuffer(m_shadowFBO);
 		glClear(GL_DEPTH_BUFFER_BIT);
@@ -130,10 +209,15 @@ namespace DerydocaEngine::Components
 		// Draw all meshes with the shadow map shader to the framebuffer
 		m_shadowMapMaterial->bind();
 		std::shared_ptr<Components::Transform> trans = getGameObject()->getTransform();
+		bool queueCasters = beginShadowCasterQueue();
 		for (auto scene : scenes)
 		{
 			scene->getRoot()->renderMesh(m_matrixStack, m_shadowMapMaterial, m_projection, trans);
 		}
+		if (queueCasters)
+		{
+			flushShadowCasters();
+		}
 
 		glCullFace(GL_BACK);
 		glPolygonOffset(0.0f, 0.0f);
@@ -141,6 +225,118 @@ namespace DerydocaEngine::Components
 		Rendering::GraphicsAPI::bindFramebuffer(prevFramebufferId);
 	}
 
+	void Light::renderShadowCascades(const std::vector<std::shared_ptr<Scenes::Scene>> scenes, std::shared_ptr<Camera> const& camera)
+	{
+		int cascadeCount = glm::clamp(m_shadowCascadeCount, 1, Rendering::ShadowCascades::MAX_CASCADES);
+
+		// Redraw every cascade when the layout of the atlas changes
+		if (cascadeCount != m_lastShadowCascadeCount)
+		{
+			m_shadowCascadeFrame = 0;
+			m_lastShadowCascadeCount = cascadeCount;
+		}
+
+		// Split the camera's view distance between the cascades
+		Rendering::Projection cameraProjection = camera->getProjection();
+		glm::mat4 cameraModel = camera->getGameObject()->getTransform()->getModel();
+		float shadowDistance = glm::clamp(m_shadowDistance, cameraProjection.getZNear(), cameraProjection.getZFar());
+		std::vector<float> splits = Rendering::ShadowCascades::calculateSplitDepths(
+			cameraProjection.getZNear(),
+			shadowDistance,
+			cascadeCount,
+			m_shadowCascadeSplitScheme,
+			m_shadowCascadeSplitLambda);
+
+		auto prevFramebufferId = Rendering::GraphicsAPI::getCurrentFramebufferID();
+		Rendering::GraphicsAPI::bindFramebuffer(m_shadowFBO);
+		glEnable(GL_SCISSOR_TEST);
+		glEnable(GL_CULL_FACE);
+		glCullFace(GL_FRONT);
+		glEnable(GL_POLYGON_OFFSET_FILL);
+		glPolygonOffset(2.5f, 10.0f);
+
+		m_shadowMapMaterial->bind();
+		std::shared_ptr<Components::Transform> trans = getGameObject()->getTransform();
+		glm::mat4 lightView = glm::inverse(trans->getModel());
+
+		for (int i = 0; i < cascadeCount; i++)
+		{
+			// Distant cascades can be refreshed less often, staggered so they do not all land on the same frame
+			int updateInterval = glm::max(m_shadowCascadeUpdateIntervals[i], 1);
+			if (m_shadowCascadeFrame != 0 && (m_shadowCascadeFrame + i) % updateInterval != 0)
+			{
+				continue;
+			}
+
+			// Fit an orthographic projection around this slice of the camera frustum
+			float sliceNear = i == 0 ? cameraProjection.getZNear() : splits[i - 1];
+			auto corners = Rendering::ShadowCascades::calculateFrustumSliceCorners(
+				cameraModel,
+				cameraProjection.getFov(),
+				cameraProjection.getAspectRatio(),
+				sliceNear,
+				splits[i]);
+			glm::ivec4 viewport = Rendering::ShadowCascades::getAtlasViewport(i, cascadeCount, m_shadowMapWidth, m_shadowMapHeight);
+			auto cascade = Rendering::ShadowCascades::fitCascade(lightView, corners, glm::min(viewport.z, viewport.w), m_shadowCasterDistance);
+
+			Rendering::Projection& projection = m_cascadeProjections[i];
+			projection.setProjectionMode(Rendering::ProjectionMode::Orthographic);
+			projection.setOrthographicBounds(cascade.bounds);
+			projection.setZNear(cascade.zNear);
+			projection.setZFar(cascade.zFar);
+			projection.recalculateProjectionMatrix();
+
+			// Store the matrices the cascade was rendered with so skipped frames still sample it correctly
+			m_cascadeShadowMatrices[i] = Rendering::ShadowCascades::getAtlasBiasMatrix(i, cascadeCount) * projection.getProjectionMatrix() * lightView;
+			m_cascadeSplitDepths[i] = splits[i];
+
+			// Only clear and draw to this cascade's tile of the atlas
+			glViewport(viewport.x, viewport.y, viewport.z, viewport.w);
+			glScissor(viewport.x, viewport.y, viewport.z, viewport.w);
+			glClear(GL_DEPTH_BUFFER_BIT);
+
+			// Draw all meshes that fall within this cascade with the shadow map shader
+			bool queueCasters = beginShadowCasterQueue();
+			for (auto scene : scenes)
+			{
+				scene->getRoot()->renderMesh(m_matrixStack, m_shadowMapMaterial, projection, trans);
+			}
+			if (queueCasters)
+			{
+				flushShadowCasters();
+			}
+		}
+
+		glDisable(GL_SCISSOR_TEST);
+		glCullFace(GL_BACK);
+		glPolygonOffset(0.0f, 0.0f);
+		glFlush();
+		Rendering::GraphicsAPI::bindFramebuffer(prevFramebufferId);
+
+		m_shadowCascadeFrame++;
+	}
+
+	bool Light::beginShadowCasterQueue()
+	{
+		// Casters are only merged once the variant that reads per draw matrices is built, and never
+		// with a shader that does not declare it
+		auto indirectShader = m_shadowMapMaterial->getShader(m_indirectDrawKeywords.getKey(*m_shadowMapMaterial));
+		if (!indirectShader || indirectShader == m_shadowMapMaterial->getShader())
+		{
+			return false;
+		}
+
+		return Rendering::GeometryArena::getInstance().beginDrawQueue();
+	}
+
+	void Light::flushShadowCasters()
+	{
+		// Casters that were not queued, such as skinned meshes, were already drawn with the base variant
+		m_shadowMapMaterial->bind(m_indirectDrawKeywords.getKey(*m_shadowMapMaterial));
+		Rendering::GeometryArena::getInstance().flushDraws();
+		m_shadowMapMaterial->bind();
+	}
+
 	void Light::generateShadowMap()
 	{
 		GLfloat border[] = { 1.0f, 0.0f, 0.0f, 0.0f };
@@ -6,10 +6,17 @@
 #include "Rendering\MatrixStack.h"
 #include "Components\Transform.h"
 #include "Rendering\Projection.h"
+#include "Rendering\RendererKeywords.h"
+#include "Rendering\ShadowCascades.h"
 #include "Scenes\Scene.h"
 
-namespace DerydocaEngine::Rendering {
-	class Material;
+namespace DerydocaEngine {
+	namespace Components {
+		class Camera;
+	}
+	namespace Rendering {
+		class Material;
+	}
 }
 
 namespace DerydocaEngine::Components
@@ -69,14 +76,27 @@ namespace DerydocaEngine::Components
 		glm::mat4 getShadowMatrix(glm::mat4 const& objectModelMatrix);
 		float& getShadowSoftness() { return m_shadowSoftness; }
 		float getShadowSoftness() const { return m_shadowSoftness; }
+		int& getShadowCascadeCount() { return m_shadowCascadeCount; }
+		int getShadowCascadeCount() const { return m_shadowCascadeCount; }
+		Rendering::ShadowCascades::SplitScheme& getShadowCascadeSplitScheme() { return m_shadowCascadeSplitScheme; }
+		float& getShadowCascadeSplitLambda() { return m_shadowCascadeSplitLambda; }
+		float& getShadowDistance() { return m_shadowDistance; }
+		float& getShadowCasterDistance() { return m_shadowCasterDistance; }
+		int& getShadowCascadeUpdateInterval(int const& cascadeIndex) { return m_shadowCascadeUpdateIntervals[cascadeIndex]; }
+		glm::mat4 getCascadeShadowMatrix(int const& cascadeIndex, glm::mat4 const& objectModelMatrix) const { return m_cascadeShadowMatrices[cascadeIndex] * objectModelMatrix; }
+		glm::vec4 getCascadeSplitDepths() const;
+		bool usesShadowCascades() const { return m_lightType == LightType::Directional; }
 
 		virtual void init();
 		virtual void deserialize(const YAML::Node& node);
 		virtual void preDestroy();
 
-		void renderShadowMap(const std::vector<std::shared_ptr<Scenes::Scene>> scenes);
+		void renderShadowMap(const std::vector<std::shared_ptr<Scenes::Scene>> scenes, std::shared_ptr<Camera> const& camera);
 	private:
 		void generateShadowMap();
+		void renderShadowCascades(const std::vector<std::shared_ptr<Scenes::Scene>> scenes, std::shared_ptr<Camera> const& camera);
+		bool beginShadowCasterQueue();
+		void flushShadowCasters();
 		int getShadowMapFilterTypeEnum();
 
 		LightType m_lightType;
@@ -90,10 +110,23 @@ namespace DerydocaEngine::Components
 		unsigned int m_shadowFBO;
 		std::shared_ptr<Rendering::MatrixStack> m_matrixStack;
 		std::shared_ptr<Rendering::Material> m_shadowMapMaterial;
+		// Selects the shadow map shader variant that reads each caster's matrix from the merged draw's data
+		Rendering::RendererKeywords m_indirectDrawKeywords;
 		Rendering::Projection m_projection;
 		glm::mat4 m_shadowBias;
 		ShadowMapFilterType m_shadowMapFilterType;
 		float m_shadowSoftness;
+		int m_shadowCascadeCount;
+		Rendering::ShadowCascades::SplitScheme m_shadowCascadeSplitScheme;
+		float m_shadowCascadeSplitLambda;
+		float m_shadowDistance;
+		float m_shadowCasterDistance;
+		std::array<int, Rendering::ShadowCascades::MAX_CASCADES> m_shadowCascadeUpdateIntervals;
+		std::array<Rendering::Projection, Rendering::ShadowCascades::MAX_CASCADES> m_cascadeProjections;
+		std::array<glm::mat4, Rendering::ShadowCascades::MAX_CASCADES> m_cascadeShadowMatrices;
+		std::array<float, Rendering::ShadowCascades::MAX_CASCADES> m_cascadeSplitDepths;
+		unsigned long m_shadowCascadeFrame;
+		int m_lastShadowCascadeCount;
 	};
 
 }
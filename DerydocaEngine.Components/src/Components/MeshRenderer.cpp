@@ -3,6 +3,7 @@
 
 #include "Components\Camera.h"
 #include "Rendering\CameraManager.h"
+#include "Rendering\Culling.h"
 #include "GameObject.h"
 #include "Rendering\LightManager.h"
 #include "Rendering\Material.h"
@@ -11,6 +12,7 @@
 #include "Rendering\Shader.h"
 #include "Rendering\ShaderLibrary.h"
 #include "Rendering\Texture.h"
+#include "Rendering\TextureStreaming.h"
 #include "Components\Transform.h"
 
 namespace DerydocaEngine::Components
@@ -19,14 +21,22 @@ namespace DerydocaEngine::Components
 	MeshRenderer::MeshRenderer() :
 		m_mesh(),
 		m_material(),
-		m_meshRendererCamera()
+		m_meshHandle(),
+		m_materialHandle(),
+		m_meshRendererCamera(),
+		m_rendererKeywords(),
+		m_layoutKeywords(nullptr)
 	{
 	}
 
 	MeshRenderer::MeshRenderer(std::shared_ptr<Rendering::Mesh> mesh, std::shared_ptr<Rendering::Material> material) :
 		m_mesh(mesh),
 		m_material(material),
-		m_meshRendererCamera()
+		m_meshHandle(),
+		m_materialHandle(),
+		m_meshRendererCamera(),
+		m_rendererKeywords(),
+		m_layoutKeywords(nullptr)
 	{
 	}
 
@@ -36,15 +46,20 @@ namespace DerydocaEngine::Components
 
 	void MeshRenderer::deserialize(const YAML::Node& compNode)
 	{
-		auto material = getResourcePointer<Rendering::Material>(compNode, "Material");
-		setMaterial(material);
-
-		auto mesh = getResourcePointer<Rendering::Mesh>(compNode, "Mesh");
-		setMesh(mesh);
+		// Load the mesh in the background, nothing is drawn until it is resident
+		m_meshHandle = loadResourceAsync(compNode, "Mesh");
 
 		YAML::Node renderTextureSourceNode = compNode["RenderTextureSource"];
-		if (renderTextureSourceNode && renderTextureSourceNode.IsScalar())
+		if (!renderTextureSourceNode || !renderTextureSourceNode.IsScalar())
+		{
+			m_materialHandle = loadResourceAsync(compNode, "Material");
+		}
+		else
 		{
+			// The render texture is bound to the material right away, so it cannot wait for the material
+			auto material = getResourcePointer<Rendering::Material>(compNode, "Material");
+			setMaterial(material);
+
 			// Get the name that should be used to bind this texture to the shader
 			std::string renderTextureName = "RenderTexture";
 			YAML::Node renderTextureNameNode = compNode["RenderTextureName"];
@@ -70,13 +85,37 @@ namespace DerydocaEngine::Components
 
 	void MeshRenderer::render(std::shared_ptr<Rendering::MatrixStack> const matrixStack)
 	{
-		m_material->bind();
-		m_material->getShader()->updateViaActiveCamera(matrixStack);
-		Rendering::LightManager::getInstance().bindLightsToShader(matrixStack, getGameObject()->getTransform(), m_material->getShader());
+		if (!resolveResources())
+		{
+			return;
+		}
+
+		// Compressed vertex layouts are read by the shader variant that decodes them. Layouts share their
+		// keyword lists, so they are only resolved again when the mesh's layout changes.
+		auto const& layoutKeywords = m_mesh->getVertexLayout().getShaderKeywords();
+		if (&layoutKeywords != m_layoutKeywords)
+		{
+			m_rendererKeywords.setKeywords(layoutKeywords);
+			m_layoutKeywords = &layoutKeywords;
+		}
+		Rendering::ShaderVariantKey rendererKey = m_rendererKeywords.getKey(*m_material);
+
+		auto shader = m_material->getShader(rendererKey);
+		if (!shader)
+		{
+			// Wait for a variant that can read the mesh's vertices
+			return;
+		}
+		m_material->bind(rendererKey);
+		shader->updateViaActiveCamera(matrixStack);
+		Rendering::LightManager::getInstance().bindLightsToShader(matrixStack, getGameObject()->getTransform(), shader);
+
+		// Ask for the texture levels this mesh needs at its size on screen
+		Rendering::TextureStreaming::requestLevels(*m_material, *m_mesh, matrixStack->getMatrix());
 
 		m_mesh->draw();
 
-		m_material->unbind();
+		m_material->unbind(rendererKey);
 	}
 
 	void MeshRenderer::renderMesh(
@@ -86,9 +125,45 @@ namespace DerydocaEngine::Components
 		const std::shared_ptr<Transform> projectionTransform
 	)
 	{
+		if (!resolveResources())
+		{
+			return;
+		}
+
+		// Skip meshes that fall outside of the projection, such as casters outside of a shadow cascade
+		glm::mat4 mvp = projection.getInverseViewProjectionMatrix(projectionTransform->getModel()) * matrixStack->getMatrix();
+		if (!Rendering::Culling::isBoxInsideClipVolume(mvp, m_mesh->getBoundsMin(), m_mesh->getBoundsMax()))
+		{
+			return;
+		}
+
+		// Passes that merge their draws bind the shader and issue the draw once every caster is queued
+		if (m_mesh->queueDraw(mvp))
+		{
+			return;
+		}
+
 		material->bind();
 		material->getShader()->update(matrixStack, projection, projectionTransform);
 		m_mesh->draw();
 	}
 
+	bool MeshRenderer::resolveResources()
+	{
+		// Pick up assets that became resident since the last frame
+		if (m_meshHandle && m_meshHandle->isResident())
+		{
+			m_mesh = m_meshHandle->get<Rendering::Mesh>();
+			m_meshHandle = nullptr;
+		}
+
+		if (m_materialHandle && m_materialHandle->isResident())
+		{
+			m_material = m_materialHandle->get<Rendering::Material>();
+			m_materialHandle = nullptr;
+		}
+
+		return m_mesh && m_material;
+	}
+
 }
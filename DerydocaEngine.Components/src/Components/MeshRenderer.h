@@ -1,5 +1,6 @@
 #pragma once
 #include "Components\GameComponent.h"
+#include "Rendering\RendererKeywords.h"
 
 namespace DerydocaEngine {
 	namespace Components {
@@ -10,6 +11,9 @@ namespace DerydocaEngine {
 		class Material;
 		class Mesh;
 	}
+	namespace Resources {
+		class ResourceHandle;
+	}
 }
 
 namespace DerydocaEngine::Components
@@ -29,20 +33,27 @@ namespace DerydocaEngine::Components
 			const Rendering::Projection& projection,
 			const std::shared_ptr<Transform> projectionTransform
 		);
-		std::shared_ptr<Rendering::Material> getMaterial() { return m_material; }
-		std::shared_ptr<Rendering::Mesh> getMesh() { return m_mesh; }
+		std::shared_ptr<Rendering::Material> getMaterial() { resolveResources(); return m_material; }
+		std::shared_ptr<Rendering::Mesh> getMesh() { resolveResources(); return m_mesh; }
 		std::shared_ptr<Camera> getMeshRendererCamera() { return m_meshRendererCamera; }
 
 		virtual void deserialize(const YAML::Node& compNode);
 		virtual void init();
 		virtual void preDestroy();
 
-		void setMesh(std::shared_ptr<Rendering::Mesh> const& mesh) { m_mesh = mesh; }
-		void setMaterial(std::shared_ptr<Rendering::Material> const& material) { m_material = material; }
+		void setMesh(std::shared_ptr<Rendering::Mesh> const& mesh) { m_mesh = mesh; m_meshHandle = nullptr; }
+		void setMaterial(std::shared_ptr<Rendering::Material> const& material) { m_material = material; m_materialHandle = nullptr; }
 	private:
+		bool resolveResources();
+
 		std::shared_ptr<Rendering::Mesh> m_mesh;
 		std::shared_ptr<Rendering::Material> m_material;
+		std::shared_ptr<Resources::ResourceHandle> m_meshHandle;
+		std::shared_ptr<Resources::ResourceHandle> m_materialHandle;
 		std::shared_ptr<Camera> m_meshRendererCamera;
+		// Keywords of the mesh's vertex layout, enabled per renderer instead of on the shared material
+		Rendering::RendererKeywords m_rendererKeywords;
+		std::vector<std::string> const* m_layoutKeywords;
 	};
 
 }
@@ -4,6 +4,7 @@
 #include "Rendering\LightManager.h"
 #include "Rendering\Material.h"
 #include "Rendering\Shader.h"
+#include "Rendering\TextureStreaming.h"
 
 namespace DerydocaEngine::Components
 {
@@ -36,6 +37,9 @@ namespace DerydocaEngine::Components
 		if (!m_mesh)
 		{
 			m_mesh = std::make_unique<Rendering::Mesh>();
+
+			// Components are regenerated one at a time, so the mesh keeps the rest of its streams
+			m_mesh->setCpuDataPinned(true);
 		}
 
 		if (m_dirtyComponents & Rendering::MeshComponents::Positions)
@@ -92,6 +96,9 @@ namespace DerydocaEngine::Components
 		m_material->getShader()->updateViaActiveCamera(matrixStack);
 		Rendering::LightManager::getInstance().bindLightsToShader(matrixStack, getGameObject()->getTransform(), m_material->getShader());
 
+		// Ask for the texture levels this mesh needs at its size on screen
+		Rendering::TextureStreaming::requestLevels(*m_material, *m_mesh, matrixStack->getMatrix());
+
 		m_mesh->draw();
 
 		m_material->unbind();
@@ -1,7 +1,11 @@
 #include "EngineComponentsPch.h"
 #include "SkinnedMeshRenderer.h"
 
+#include <algorithm>
+#include "Animation\AnimationLod.h"
+#include "Animation\AnimationSystem.h"
 #include "Components\Camera.h"
+#include "Rendering\BonePaletteBuffer.h"
 #include "Rendering\CameraManager.h"
 #include "GameObject.h"
 #include "Rendering\LightManager.h"
@@ -10,6 +14,7 @@
 #include "Rendering\RenderTexture.h"
 #include "Rendering\Shader.h"
 #include "Rendering\ShaderLibrary.h"
+#include "Rendering\TextureStreaming.h"
 #include "Resources\Serializers\SkeletonResourceSerializer.h"
 #include "Rendering\Texture.h"
 #include "Components\Transform.h"
@@ -22,13 +27,18 @@ namespace DerydocaEngine::Components
 		m_material(),
 		m_SkinnedMeshRendererCamera(),
 		m_animation(),
-		m_time(0.0f),
-		m_boneMatrices()
+		m_animationInstance(),
+		m_rendererKeywords({ "SKINNED" }),
+		m_layoutKeywords(nullptr)
 	{
 	}
 
 	SkinnedMeshRenderer::~SkinnedMeshRenderer()
 	{
+		if (m_animationInstance)
+		{
+			Animation::AnimationSystem::getInstance().removeInstance(m_animationInstance);
+		}
 	}
 
 	void SkinnedMeshRenderer::deserialize(const YAML::Node& compNode)
@@ -39,6 +49,53 @@ namespace DerydocaEngine::Components
 		m_mesh = getResourcePointer<Rendering::Mesh>(compNode, "Mesh");
 
 		m_animation = getResourcePointer<Animation::AnimationData>(compNode, "Animation");
+		m_animationInstance = std::make_shared<Animation::AnimationInstance>(m_animation, m_mesh->getSkeleton());
+
+		// Instances can start part way into the animation and play it at their own speed
+		YAML::Node animationTimeNode = compNode["AnimationTime"];
+		if (animationTimeNode && animationTimeNode.IsScalar())
+		{
+			m_animationInstance->setTime(animationTimeNode.as<float>());
+		}
+
+		YAML::Node animationSpeedNode = compNode["AnimationSpeed"];
+		if (animationSpeedNode && animationSpeedNode.IsScalar())
+		{
+			m_animationInstance->setSpeed(animationSpeedNode.as<float>());
+		}
+
+		// Characters whose pose is changed after it is sampled can ignore the animation's pose cache
+		YAML::Node animationLiveSamplingNode = compNode["AnimationLiveSampling"];
+		if (animationLiveSamplingNode && animationLiveSamplingNode.IsScalar())
+		{
+			m_animationInstance->setLiveSampling(animationLiveSamplingNode.as<bool>());
+		}
+
+		// Distant characters can be animated less often, each level given as a screen size and the frames between poses
+		YAML::Node animationLodNode = compNode["AnimationLod"];
+		if (animationLodNode && animationLodNode.IsSequence())
+		{
+			Animation::AnimationLodSettings lodSettings = m_animationInstance->getLodSettings();
+			lodSettings.levels.clear();
+			for (size_t i = 0; i < animationLodNode.size(); i++)
+			{
+				YAML::Node screenSizeNode = animationLodNode[i]["ScreenSize"];
+				YAML::Node updateIntervalNode = animationLodNode[i]["UpdateInterval"];
+				if (screenSizeNode && updateIntervalNode)
+				{
+					lodSettings.levels.push_back({ screenSizeNode.as<float>(), static_cast<unsigned int>(glm::max(updateIntervalNode.as<int>(), 1)) });
+				}
+			}
+			m_animationInstance->setLodSettings(lodSettings);
+		}
+
+		YAML::Node animationLodInterpolateNode = compNode["AnimationLodInterpolate"];
+		if (animationLodInterpolateNode && animationLodInterpolateNode.IsScalar())
+		{
+			Animation::AnimationLodSettings lodSettings = m_animationInstance->getLodSettings();
+			lodSettings.interpolate = animationLodInterpolateNode.as<bool>();
+			m_animationInstance->setLodSettings(lodSettings);
+		}
 
 		YAML::Node renderTextureSourceNode = compNode["RenderTextureSource"];
 		if (renderTextureSourceNode && renderTextureSourceNode.IsScalar())
@@ -59,22 +116,87 @@ namespace DerydocaEngine::Components
 
 	void SkinnedMeshRenderer::init()
 	{
-		m_boneMatrices.resize(m_mesh->getSkeleton()->getNumBones());
 		m_animation->optimizeForSkeleton(m_mesh->getSkeleton());
+
+		// The pose is evaluated along with every other instance before the scene renders
+		Animation::AnimationSystem::getInstance().addInstance(m_animationInstance);
+	}
+
+	void SkinnedMeshRenderer::update(const float deltaTime)
+	{
+		m_animationInstance->advance(deltaTime);
 	}
 
 	void SkinnedMeshRenderer::render(std::shared_ptr<Rendering::MatrixStack> const matrixStack)
 	{
-		m_material->bind();
-		m_material->getShader()->updateViaActiveCamera(matrixStack);
-		m_animation->loadPose(m_time, m_boneMatrices, m_mesh->getSkeleton());
-		m_material->setMat4Array("BoneMatrices", m_boneMatrices);
+		// Tell the animation system how large the character is, which sets its update rate next frame
+		unsigned int animationFrame = Animation::AnimationSystem::getInstance().getFrame();
+		bool culled = m_animationInstance->isCulled(animationFrame);
+		auto camera = Rendering::CameraManager::getInstance().getCurrentCamera();
+		if (camera)
+		{
+			Rendering::Projection const& projection = camera->getProjection();
+			glm::mat4 viewModelMatrix = projection.getViewMatrix(camera->getGameObject()->getTransform()->getModel()) * matrixStack->getMatrix();
+			float screenSize = Animation::AnimationLod::calculateScreenSize(projection.getProjectionMatrix(), viewModelMatrix, m_mesh->getBoundsMin(), m_mesh->getBoundsMax());
+			if (screenSize > 0.0f)
+			{
+				m_animationInstance->setScreenSize(screenSize, animationFrame);
+			}
+			else
+			{
+				culled = false;
+			}
+		}
+
+		// Characters that just came into view were skipped by this frame's evaluation, and scenes rendered
+		// without the animation system running still need a first pose, so those are sampled now
+		Rendering::BonePaletteBuffer& paletteBuffer = Rendering::BonePaletteBuffer::getInstance();
+		if (!m_animationInstance->hasPose() || (culled && m_animationInstance->needsEvaluation()))
+		{
+			m_animationInstance->evaluate();
+		}
+		int paletteOffset = m_animationInstance->getPaletteOffset(paletteBuffer.getFrame());
+		if (paletteOffset < 0)
+		{
+			paletteOffset = paletteBuffer.write(m_animationInstance->getBoneTransforms());
+			m_animationInstance->setPaletteOffset(paletteOffset, paletteBuffer.getFrame());
+		}
+		if (paletteOffset < 0)
+		{
+			return;
+		}
+
+		// The keywords of the mesh's vertex layout follow the skinned one, and change if the mesh is reloaded
+		auto const& layoutKeywords = m_mesh->getVertexLayout().getShaderKeywords();
+		if (&layoutKeywords != m_layoutKeywords)
+		{
+			std::vector<std::string> keywords = { "SKINNED" };
+			keywords.insert(keywords.end(), layoutKeywords.begin(), layoutKeywords.end());
+			m_rendererKeywords.setKeywords(keywords);
+			m_layoutKeywords = &layoutKeywords;
+		}
+		Rendering::ShaderVariantKey rendererKey = m_rendererKeywords.getKey(*m_material);
+
+		// Render with the skinned variant of the shader once it has been built
+		auto shader = m_material->getShader(rendererKey);
+		if (!shader)
+		{
+			// Wait for a variant that can read the mesh's vertices
+			return;
+		}
+		m_material->bind(rendererKey);
+		shader->updateViaActiveCamera(matrixStack);
+		paletteBuffer.bind(*shader, paletteOffset, static_cast<int>(m_animationInstance->getBoneTransforms().size()));
+
+		Rendering::LightManager::getInstance().bindLightsToShader(matrixStack, getGameObject()->getTransform(), shader);
 
-		Rendering::LightManager::getInstance().bindLightsToShader(matrixStack, getGameObject()->getTransform(), m_material->getShader());
+		// Ask for the texture levels this mesh needs at its size on screen
+		Rendering::TextureStreaming::requestLevels(*m_material, *m_mesh, matrixStack->getMatrix());
 
 		m_mesh->draw();
+		paletteBuffer.countDraw(1);
 
-		m_material->unbind();
+		m_material->unbind(rendererKey);
 	}
 
 	void SkinnedMeshRenderer::renderMesh(
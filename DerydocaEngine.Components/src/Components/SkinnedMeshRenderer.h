@@ -1,7 +1,9 @@
 #pragma once
 #include "Animation\AnimationData.h"
+#include "Animation\AnimationInstance.h"
 #include "Components\GameComponent.h"
 #include "Animation\Skeleton.h"
+#include "Rendering\RendererKeywords.h"
 
 namespace DerydocaEngine {
 	namespace Components {
@@ -30,9 +32,10 @@ namespace DerydocaEngine::Components
 			const Rendering::Projection& projection,
 			const std::shared_ptr<Transform> projectionTransform
 		);
-		virtual void update(const float deltaTime) { m_time += deltaTime; }
+		virtual void update(const float deltaTime);
 		std::shared_ptr<Rendering::Material> getMaterial() { return m_material; }
 		std::shared_ptr<Camera> getSkinnedMeshRendererCamera() { return m_SkinnedMeshRendererCamera; }
+		std::shared_ptr<Animation::AnimationInstance> getAnimationInstance() const { return m_animationInstance; }
 
 		void deserialize(const YAML::Node& compNode);
 
@@ -43,8 +46,11 @@ namespace DerydocaEngine::Components
 		std::shared_ptr<Rendering::Material> m_material;
 		std::shared_ptr<Camera> m_SkinnedMeshRendererCamera;
 		std::shared_ptr<Animation::AnimationData> m_animation;
-		float m_time;
-		std::vector<glm::mat4> m_boneMatrices;
+		std::shared_ptr<Animation::AnimationInstance> m_animationInstance;
+		// Enabled per renderer instead of on the material, which other renderers may share
+		Rendering::RendererKeywords m_rendererKeywords;
+		// Keywords of the mesh's vertex layout that were last added to the skinned one
+		std::vector<std::string> const* m_layoutKeywords;
 	};
 
 }
@@ -150,7 +150,8 @@ namespace DerydocaEngine::Ext
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
 		delete[] data;
 
-		// Attach these to the torus's vertex array
+		// Attach these to the torus's vertex array, which must not be shared with other meshes
+		m_mesh->setStorage(Rendering::MeshStorage::Dedicated);
 		glBindVertexArray(m_mesh->getVao());
 		glBindBuffer(GL_ARRAY_BUFFER, m_initVel);
 		glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, 0, NULL);
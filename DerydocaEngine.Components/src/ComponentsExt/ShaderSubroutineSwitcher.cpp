@@ -11,36 +11,100 @@ namespace DerydocaEngine::Ext
 
 	void ShaderSubroutineSwitcher::init()
 	{
-		setSubroutine(GL_VERTEX_SHADER, m_subroutineName);
+		m_pending = true;
+		applyToMaterial();
 	}
 
 	void ShaderSubroutineSwitcher::deserialize(const YAML::Node& compNode)
 	{
-		m_subroutineName = compNode["SubroutineName"].as<std::string>();
+		YAML::Node subroutineNameNode = compNode["SubroutineName"];
+		if (subroutineNameNode)
+		{
+			m_subroutineName = subroutineNameNode.as<std::string>();
+		}
+
+		YAML::Node keywordsNode = compNode["Keywords"];
+		if (keywordsNode && keywordsNode.IsSequence())
+		{
+			for (size_t i = 0; i < keywordsNode.size(); i++)
+			{
+				m_keywords.push_back(keywordsNode[i].as<std::string>());
+			}
+		}
 	}
 
-	void ShaderSubroutineSwitcher::setSubroutine(unsigned int const& program, std::string const& subroutineName)
+	void ShaderSubroutineSwitcher::update(const float deltaTime)
 	{
-		if (subroutineName.empty())
+		// The mesh renderer's material may still have been loading when the scene started
+		if (m_pending)
+		{
+			applyToMaterial();
+		}
+	}
+
+	void ShaderSubroutineSwitcher::applyToMaterial()
+	{
+		auto material = getMaterialCopy();
+		if (material == nullptr)
 		{
-			std::cout << "Unable to set the subroutine for this component because a subroutine name was not supplied.\n";
 			return;
 		}
 
-		// Get the shader from the attached mesh renderer
+		// Keywords select a shader variant once instead of switching subroutines on every draw
+		if (!m_keywords.empty())
+		{
+			setKeywords(material, m_keywords);
+			return;
+		}
+
+		setSubroutine(material, GL_VERTEX_SHADER, m_subroutineName);
+	}
+
+	std::shared_ptr<Rendering::Material> ShaderSubroutineSwitcher::getMaterialCopy()
+	{
+		// Get the material from the attached mesh renderer
 		auto mr = getComponent<Components::MeshRenderer>();
 		if (mr == nullptr)
 		{
 			std::cout << "No mesh renderer found for ShaderSubroutineSwitcher object.\n";
-			return;
+			m_pending = false;
+			return nullptr;
 		}
+
+		// Wait for a material that is loaded asynchronously, since replacing it now would discard it once it arrives
+		auto sourceMaterial = mr->getMaterial();
+		if (sourceMaterial == nullptr)
+		{
+			return nullptr;
+		}
+		m_pending = false;
+
 		// Copy the material from the mesh renderer
 		auto material = std::make_shared<Rendering::Material>();
-		material->copyFrom(mr->getMaterial());
+		material->copyFrom(sourceMaterial);
 
 		// Set the mesh renderer's material to our copy
 		mr->setMaterial(material);
 
+		return material;
+	}
+
+	void ShaderSubroutineSwitcher::setKeywords(std::shared_ptr<Rendering::Material> const& material, std::vector<std::string> const& keywords)
+	{
+		for (auto const& keyword : keywords)
+		{
+			material->enableKeyword(keyword);
+		}
+	}
+
+	void ShaderSubroutineSwitcher::setSubroutine(std::shared_ptr<Rendering::Material> const& material, unsigned int const& program, std::string const& subroutineName)
+	{
+		if (subroutineName.empty())
+		{
+			std::cout << "Unable to set the subroutine for this component because a subroutine name was not supplied.\n";
+			return;
+		}
+
 		// Get the shader from the material
 		auto shader = material->getShader();
 		if (shader == nullptr)
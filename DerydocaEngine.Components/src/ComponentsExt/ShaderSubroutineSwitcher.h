@@ -10,15 +10,22 @@ namespace DerydocaEngine::Ext
 	public:
 		GENINSTANCE(ShaderSubroutineSwitcher);
 
-		ShaderSubroutineSwitcher() {}
+		ShaderSubroutineSwitcher() : m_pending(false) {}
 		~ShaderSubroutineSwitcher() {}
 
 		virtual void init();
 		virtual void deserialize(const YAML::Node& compNode);
+		virtual void update(const float deltaTime);
 	private:
-		void setSubroutine(unsigned int const& program, std::string const& subroutineName);
+		void applyToMaterial();
+		std::shared_ptr<Rendering::Material> getMaterialCopy();
+		void setSubroutine(std::shared_ptr<Rendering::Material> const& material, unsigned int const& program, std::string const& subroutineName);
+		void setKeywords(std::shared_ptr<Rendering::Material> const& material, std::vector<std::string> const& keywords);
 
 		std::string m_subroutineName;
+		std::vector<std::string> m_keywords;
+		// Set until the mesh renderer's material has loaded and been copied
+		bool m_pending;
 	};
 
 }
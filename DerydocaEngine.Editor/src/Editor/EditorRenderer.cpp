@@ -1,6 +1,8 @@
 #include "EditorPch.h"
 #include "EditorRenderer.h"
 #include "Settings\EngineSettings.h"
+#include "Animation\AnimationSystem.h"
+#include "Rendering\BonePaletteBuffer.h"
 #include "Rendering\CameraManager.h"
 #include "Rendering\Gui\DearImgui.h"
 #include "Scenes\SceneManager.h"
@@ -9,6 +11,7 @@
 #include "Rendering\GraphicsAPI.h"
 #include "Rendering\LightManager.h"
 #include "ObjectLibrary.h"
+#include "Resources\ResourceLoader.h"
 
 namespace DerydocaEngine::Editor
 {
@@ -61,7 +64,7 @@ namespace DerydocaEngine::Editor
 
 		// Render the scenes
 		Rendering::CameraManager::getInstance().renderCamerasToAttachedRenderTextures(scenes);
-		Rendering::LightManager::getInstance().renderShadowMaps(scenes, camera->getGameObject()->getTransform());
+		Rendering::LightManager::getInstance().renderShadowMaps(scenes, camera);
 		Rendering::CameraManager::getInstance().setCurrentCamera(camera);
 		camera->renderScenesToActiveBuffer(scenes, textureW, textureH);
 
@@ -85,6 +88,10 @@ namespace DerydocaEngine::Editor
 			}
 		}
 
+		// Evaluate the poses of every animated instance together, then upload their palettes in one go before anything is drawn
+		Animation::AnimationSystem::getInstance().update();
+		Rendering::BonePaletteBuffer::getInstance().update();
+
 		// Render editor GUI
 		EditorGUI::getInstance().render();
 		m_editorGuiScene->getRoot()->renderEditorGUI();
@@ -126,7 +133,15 @@ namespace DerydocaEngine::Editor
 		if (editorComponentsSceneResource != nullptr)
 		{
 			scene->LoadFromFile(editorComponentsSceneResource->getSourceFilePath());
-			scene->setUp();
+
+			// The editor's own scenes are always fully loaded before they are shown
+			Resources::ResourceDependencySet dependencies;
+			{
+				Resources::ResourceLoader::Recording recording(dependencies);
+				scene->setUp();
+			}
+			Resources::ResourceLoader::getInstance().waitFor(dependencies);
+
 			scene->getRoot()->init();
 			scene->getRoot()->postInit();
 		}
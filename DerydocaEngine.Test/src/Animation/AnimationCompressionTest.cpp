@@ -0,0 +1,146 @@
+#include "EngineTestPch.h"
+#include "Animation\AnimationCompression.h"
+#include "Animation\AnimationTestRig.h"
+
+using namespace DerydocaEngine::Animation;
+
+// Furthest a point near the skin may move in the tests, a hundredth of the distance between bones
+static const float TEST_TOLERANCE = 0.01f;
+
+static float getRotationAngle(glm::quat const& a, glm::quat const& b)
+{
+	return 2.0f * std::acos(std::min(std::abs(glm::dot(a, b)), 1.0f));
+}
+
+TEST(AnimationCompression, DecodedRotation_Matches_When_AnyComponentIsLargest)
+{
+	std::vector<glm::quat> rotations = {
+		glm::quat(),
+		glm::quat(0.0f, 1.0f, 0.0f, 0.0f),
+		glm::angleAxis(-2.5f, glm::normalize(glm::vec3(0.2f, -1.0f, 0.4f))),
+		glm::angleAxis(3.0f, glm::normalize(glm::vec3(0.1f, 0.3f, -1.0f))),
+		glm::quat(-0.5f, 0.5f, -0.5f, 0.5f),
+		-glm::angleAxis(0.7f, glm::normalize(glm::vec3(1.0f, 1.0f, 0.0f)))
+	};
+
+	for (auto const& rotation : rotations)
+	{
+		uint16_t values[AnimationCompression::VALUES_PER_KEY];
+		AnimationCompression::encodeRotation(rotation, values);
+		glm::quat decoded = AnimationCompression::decodeRotation(values);
+
+		EXPECT_NEAR(1.0f, glm::length(decoded), 1e-5f);
+		EXPECT_LT(getRotationAngle(rotation, decoded), 2e-4f);
+	}
+}
+
+TEST(AnimationCompression, DecodedVector_Matches_When_WithinRange)
+{
+	CompressedTrack track;
+	track.rangeMin = glm::vec3(-2.0f, 0.5f, 3.0f);
+	track.rangeExtent = glm::vec3(4.0f, 0.0f, 0.25f);
+
+	for (glm::vec3 const& vector : { glm::vec3(-2.0f, 0.5f, 3.0f), glm::vec3(2.0f, 0.5f, 3.25f), glm::vec3(0.123f, 0.5f, 3.1f) })
+	{
+		uint16_t values[AnimationCompression::VALUES_PER_KEY];
+		AnimationCompression::encodeVector(vector, track, values);
+		glm::vec3 decoded = AnimationCompression::decodeVector(values, track);
+
+		EXPECT_NEAR(vector.x, decoded.x, 4.0f / 65535.0f);
+		EXPECT_FLOAT_EQ(vector.y, decoded.y);
+		EXPECT_NEAR(vector.z, decoded.z, 0.25f / 65535.0f);
+	}
+}
+
+TEST(AnimationCompression, ConstantTracks_Keep_OneKey)
+{
+	std::vector<AnimationKey<glm::vec3>> positionKeys;
+	std::vector<AnimationKey<glm::quat>> rotationKeys;
+	std::vector<AnimationKey<glm::vec3>> scaleKeys;
+	for (int key = 0; key < 10; key++)
+	{
+		positionKeys.push_back(AnimationKey<glm::vec3>(key * 0.1, glm::vec3(1.0f, 2.0f, 3.0f)));
+		rotationKeys.push_back(AnimationKey<glm::quat>(key * 0.1, glm::angleAxis(0.5f, glm::vec3(0.0f, 1.0f, 0.0f))));
+		scaleKeys.push_back(AnimationKey<glm::vec3>(key * 0.1, glm::vec3(1.0f)));
+	}
+	std::vector<AnimationChannel> channels = { AnimationChannel("Bone", positionKeys, rotationKeys, scaleKeys) };
+
+	CompressedAnimation compressed;
+	AnimationCompression::CompressionReport report;
+	ASSERT_TRUE(AnimationCompression::compress(channels, 0.9, {}, AnimationCompression::CompressionSettings(), compressed, report));
+
+	ASSERT_EQ(3u, compressed.tracks.size());
+	for (auto const& track : compressed.tracks)
+	{
+		EXPECT_EQ(1u, track.keyCount);
+	}
+	EXPECT_EQ(30u, report.rawKeyCount);
+	EXPECT_EQ(3u, report.compressedKeyCount);
+}
+
+TEST(AnimationCompression, CompressedAnimation_Is_Smaller_When_KeysAreSmooth)
+{
+	auto skeleton = AnimationTestRig::createSkeleton();
+	std::vector<AnimationChannel> channels = AnimationTestRig::createChannels(skeleton);
+
+	AnimationCompression::CompressionSettings settings;
+	settings.tolerance = TEST_TOLERANCE;
+
+	CompressedAnimation compressed;
+	AnimationCompression::CompressionReport report;
+	ASSERT_TRUE(AnimationCompression::compress(channels, 2.0, AnimationTestRig::createHierarchy(skeleton), settings, compressed, report));
+
+	EXPECT_LT(report.compressedKeyCount, report.rawKeyCount);
+	EXPECT_LT(report.compressedSize * 2, report.rawSize);
+	EXPECT_EQ(AnimationCompression::getRawSize(channels), report.rawSize);
+	EXPECT_EQ(compressed.getSize(), report.compressedSize);
+	EXPECT_GT(report.maxError, 0.0f);
+
+	// The bone that only has one key keeps it, for every track
+	for (int kind = 0; kind < AnimationCompression::TrackKindCount; kind++)
+	{
+		EXPECT_EQ(1u, compressed.tracks[1 * AnimationCompression::TrackKindCount + kind].keyCount);
+	}
+}
+
+TEST(AnimationCompression, CompressedPose_Is_WithinReportedError)
+{
+	auto skeleton = AnimationTestRig::createSkeleton();
+	auto animation = AnimationTestRig::createAnimation(skeleton);
+	auto compressedAnimation = AnimationTestRig::createAnimation(skeleton);
+
+	AnimationCompression::CompressionSettings settings;
+	settings.tolerance = TEST_TOLERANCE;
+	AnimationCompression::CompressionReport report;
+	ASSERT_TRUE(compressedAnimation->compress(AnimationTestRig::createHierarchy(skeleton), settings, report));
+	ASSERT_TRUE(compressedAnimation->isCompressed());
+	compressedAnimation->optimizeForSkeleton(skeleton);
+
+	// Where each bone sits when bound, which the skinning matrices move to where it sits in the pose
+	std::vector<glm::vec4> bindPositions;
+	for (auto const& inverseBindTransform : skeleton->getInverseBindTransforms())
+	{
+		bindPositions.push_back(glm::inverse(inverseBindTransform) * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+	}
+
+	AnimationCursor cursor;
+	AnimationCursor compressedCursor;
+	std::vector<glm::mat4> boneTransforms;
+	std::vector<glm::mat4> compressedBoneTransforms;
+	float largestError = 0.0f;
+	for (int frame = 0; frame < 150; frame++)
+	{
+		float time = frame / 60.0f;
+		animation->samplePose(time, cursor, boneTransforms, skeleton);
+		compressedAnimation->samplePose(time, compressedCursor, compressedBoneTransforms, skeleton);
+
+		for (size_t bone = 0; bone < bindPositions.size(); bone++)
+		{
+			glm::vec4 position = boneTransforms[bone] * bindPositions[bone];
+			glm::vec4 compressedPosition = compressedBoneTransforms[bone] * bindPositions[bone];
+			largestError = std::max(largestError, glm::length(glm::vec3(position - compressedPosition)));
+		}
+	}
+
+	EXPECT_LE(largestError, report.maxError + 1e-4f);
+}
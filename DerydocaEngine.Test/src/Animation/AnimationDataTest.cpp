@@ -0,0 +1,212 @@
+#include "EngineTestPch.h"
+#include "Animation\AnimationData.h"
+#include "Animation\AnimationTestRig.h"
+
+#include <glm/gtx/quaternion.hpp>
+#include <glm/gtx/transform.hpp>
+
+using namespace DerydocaEngine::Animation;
+
+// How far sampled matrices may drift from the reference, mostly from blending rotations with a normalized lerp
+static const float POSE_TOLERANCE = 2e-3f;
+
+static const int BENCHMARK_CHARACTER_COUNT = 1000;
+static const int BENCHMARK_FRAME_COUNT = 60;
+
+// Samples poses the way animations were sampled before they had cursors, one bone at a time,
+// searching every key from the start and composing each transform from its parts
+class ReferenceSampler
+{
+public:
+	ReferenceSampler(std::vector<AnimationChannel> const& channels, double const& duration) :
+		m_channels(),
+		m_duration(duration)
+	{
+		for (auto const& channel : channels)
+		{
+			m_channels[channel.boneName] = channel;
+		}
+	}
+
+	void loadPose(float const& time, std::vector<glm::mat4>& boneTransforms, std::shared_ptr<Skeleton> const& skeleton)
+	{
+		float animationTime = (float)fmod(time, m_duration);
+		size_t boneCount = skeleton->getNumBones();
+		std::vector<glm::mat4> globalTransforms(boneCount);
+		boneTransforms.resize(boneCount);
+
+		for (size_t bone = 0; bone < boneCount; bone++)
+		{
+			glm::mat4 boneTransform = skeleton->getRestTransforms()[bone];
+			auto channel = m_channels.find(skeleton->getBoneName((unsigned int)bone));
+			if (channel != m_channels.end())
+			{
+				glm::vec3 translation = interpolate(channel->second.positionKeys, animationTime, glm::vec3(), [](glm::vec3 const& a, glm::vec3 const& b, float f) { return a + f * (b - a); });
+				glm::quat rotation = interpolate(channel->second.rotationKeys, animationTime, glm::quat(), [](glm::quat const& a, glm::quat const& b, float f) { return glm::slerp(a, b, f); });
+				glm::vec3 scale = interpolate(channel->second.scaleKeys, animationTime, glm::vec3(1.0f), [](glm::vec3 const& a, glm::vec3 const& b, float f) { return a + f * (b - a); });
+				boneTransform = glm::translate(translation) * glm::toMat4(rotation) * glm::scale(scale);
+			}
+
+			int parent = skeleton->getParentIndices()[bone];
+			globalTransforms[bone] = parent < 0 ? boneTransform : globalTransforms[parent] * boneTransform;
+			boneTransforms[bone] = skeleton->getGlobalInverseTransform() * globalTransforms[bone] * skeleton->getInverseBindTransforms()[bone];
+		}
+	}
+private:
+	template <typename T, typename Interpolate>
+	static T interpolate(std::vector<AnimationKey<T>> const& keys, float const& time, T const& defaultValue, Interpolate interpolateKeys)
+	{
+		if (keys.empty())
+		{
+			return defaultValue;
+		}
+		if (keys.size() == 1)
+		{
+			return keys[0].value;
+		}
+
+		size_t index = 0;
+		while (index + 2 < keys.size() && time >= keys[index + 1].time)
+		{
+			index++;
+		}
+		float factor = (time - (float)keys[index].time) / (float)(keys[index + 1].time - keys[index].time);
+		return interpolateKeys(keys[index].value, keys[index + 1].value, factor);
+	}
+
+	std::map<std::string, AnimationChannel> m_channels;
+	double m_duration;
+};
+
+static std::vector<AnimationChannel> getChannels(AnimationData& animation)
+{
+	std::vector<AnimationChannel> channels;
+	for (unsigned int bone = 0; ; bone++)
+	{
+		unsigned int channelIndex = animation.getBoneId(AnimationTestRig::getBoneName(bone));
+		if (channelIndex == (unsigned int)-1)
+		{
+			break;
+		}
+		channels.push_back(*animation.getChannel(channelIndex));
+	}
+	return channels;
+}
+
+static float getLargestDifference(std::vector<glm::mat4> const& a, std::vector<glm::mat4> const& b)
+{
+	float largestDifference = 0.0f;
+	for (size_t bone = 0; bone < a.size(); bone++)
+	{
+		for (int column = 0; column < 4; column++)
+		{
+			for (int row = 0; row < 4; row++)
+			{
+				largestDifference = std::max(largestDifference, std::abs(a[bone][column][row] - b[bone][column][row]));
+			}
+		}
+	}
+	return largestDifference;
+}
+
+TEST(AnimationData, PoseMatchesReference_When_PlayingForwardThroughLoops)
+{
+	auto skeleton = AnimationTestRig::createSkeleton();
+	auto animation = AnimationTestRig::createAnimation(skeleton);
+	animation->optimizeForSkeleton(skeleton);
+	ReferenceSampler reference(getChannels(*animation), animation->getDuration());
+
+	AnimationCursor cursor;
+	std::vector<glm::mat4> sampled(skeleton->getNumBones());
+	std::vector<glm::mat4> expected;
+	for (int frame = 0; frame < 300; frame++)
+	{
+		float time = frame / 60.0f;
+		animation->samplePose(time, cursor, sampled, skeleton);
+		reference.loadPose(time, expected, skeleton);
+		ASSERT_LT(getLargestDifference(sampled, expected), POSE_TOLERANCE) << "at " << time << " seconds";
+	}
+}
+
+TEST(AnimationData, CursorMatchesSearch_When_SkippingAheadAndBack)
+{
+	auto skeleton = AnimationTestRig::createSkeleton();
+	auto animation = AnimationTestRig::createAnimation(skeleton);
+	animation->optimizeForSkeleton(skeleton);
+
+	// Jumps of varying length cross many keys at once, wrap around the end and go back in time
+	AnimationCursor cursor;
+	std::vector<glm::mat4> sampled(skeleton->getNumBones());
+	std::vector<glm::mat4> searched(skeleton->getNumBones());
+	float times[] = { 0.0f, 0.01f, 0.7f, 0.71f, 1.9f, 2.05f, 1.5f, 0.2f, 3.99f, 4.0f };
+	for (float time : times)
+	{
+		animation->samplePose(time, cursor, sampled, skeleton);
+		animation->loadPose(time, searched, skeleton);
+		EXPECT_EQ(getLargestDifference(sampled, searched), 0.0f) << "at " << time << " seconds";
+	}
+}
+
+TEST(AnimationData, UnanimatedBoneStaysAtRest_When_AnimationIsNotOptimizedForSkeleton)
+{
+	auto skeleton = AnimationTestRig::createSkeleton(1, 3);
+	auto animation = AnimationTestRig::createAnimation(skeleton);
+
+	std::vector<glm::mat4> boneTransforms;
+	animation->loadPose(0.3f, boneTransforms, skeleton);
+	ASSERT_EQ(skeleton->getNumBones(), boneTransforms.size());
+
+	ReferenceSampler reference(getChannels(*animation), animation->getDuration());
+	std::vector<glm::mat4> expected;
+	reference.loadPose(0.3f, expected, skeleton);
+	EXPECT_LT(getLargestDifference(boneTransforms, expected), POSE_TOLERANCE);
+
+	// The last bone has no channel, so it only moves with its parent
+	unsigned int bone = (unsigned int)skeleton->getNumBones() - 1;
+	int parent = skeleton->getParentIndices()[bone];
+	glm::mat4 restPose = boneTransforms[parent] * glm::inverse(skeleton->getInverseBindTransforms()[parent]) * skeleton->getRestTransforms()[bone] * skeleton->getInverseBindTransforms()[bone];
+	EXPECT_LT(getLargestDifference({ boneTransforms[bone] }, { restPose }), POSE_TOLERANCE);
+}
+
+TEST(AnimationData, DISABLED_Benchmark_SampleThousandCharacters)
+{
+	auto skeleton = AnimationTestRig::createSkeleton();
+	auto animation = AnimationTestRig::createAnimation(skeleton, 4.0);
+	animation->optimizeForSkeleton(skeleton);
+	ReferenceSampler reference(getChannels(*animation), animation->getDuration());
+
+	// Every character plays the animation from a different point
+	std::vector<float> startTimes(BENCHMARK_CHARACTER_COUNT);
+	for (int i = 0; i < BENCHMARK_CHARACTER_COUNT; i++)
+	{
+		startTimes[i] = (float)(animation->getDuration() * i / BENCHMARK_CHARACTER_COUNT);
+	}
+
+	std::vector<std::vector<glm::mat4>> boneTransforms(BENCHMARK_CHARACTER_COUNT, std::vector<glm::mat4>(skeleton->getNumBones()));
+	auto timeFrames = [&](std::function<void(int const&, float const&)> const& sample) {
+		auto startTime = std::chrono::high_resolution_clock::now();
+		for (int frame = 0; frame < BENCHMARK_FRAME_COUNT; frame++)
+		{
+			for (int i = 0; i < BENCHMARK_CHARACTER_COUNT; i++)
+			{
+				sample(i, startTimes[i] + frame / 60.0f);
+			}
+		}
+		std::chrono::duration<double, std::milli> sampleTime = std::chrono::high_resolution_clock::now() - startTime;
+		return sampleTime.count() / BENCHMARK_FRAME_COUNT;
+	};
+
+	double referenceTime = timeFrames([&](int const& i, float const& time) { reference.loadPose(time, boneTransforms[i], skeleton); });
+	double searchTime = timeFrames([&](int const& i, float const& time) { animation->loadPose(time, boneTransforms[i], skeleton); });
+
+	std::vector<AnimationCursor> cursors(BENCHMARK_CHARACTER_COUNT);
+	double cursorTime = timeFrames([&](int const& i, float const& time) { animation->samplePose(time, cursors[i], boneTransforms[i], skeleton); });
+
+	printf("Sampled %d characters of %zu bones in %.2fms a frame scanning keys from the start, %.2fms searching keys and %.2fms with cursors (%.2fx)\n",
+		BENCHMARK_CHARACTER_COUNT,
+		skeleton->getNumBones(),
+		referenceTime,
+		searchTime,
+		cursorTime,
+		referenceTime / cursorTime);
+}
@@ -0,0 +1,168 @@
+#include "EngineTestPch.h"
+#include "Animation\AnimationLod.h"
+#include "Animation\AnimationSystem.h"
+#include "Animation\AnimationTestRig.h"
+
+using namespace DerydocaEngine::Animation;
+
+static const float FRAME_TIME = 1.0f / 60.0f;
+
+TEST(AnimationLod, UpdateInterval_Is_FirstLevelTheScreenSizeReaches)
+{
+	std::vector<AnimationLodLevel> levels = { { 0.2f, 1 }, { 0.08f, 2 }, { 0.02f, 4 } };
+
+	EXPECT_EQ(1u, AnimationLod::calculateUpdateInterval(levels, 0.5f));
+	EXPECT_EQ(2u, AnimationLod::calculateUpdateInterval(levels, 0.1f));
+	EXPECT_EQ(4u, AnimationLod::calculateUpdateInterval(levels, 0.05f));
+	EXPECT_EQ(4u, AnimationLod::calculateUpdateInterval(levels, 0.001f));
+	EXPECT_EQ(1u, AnimationLod::calculateUpdateInterval({}, 0.001f));
+}
+
+TEST(AnimationLod, ScreenSize_Shrinks_When_BoundsMoveAway)
+{
+	glm::mat4 projection = glm::perspective(glm::radians(60.0f), 1.0f, 0.1f, 1000.0f);
+	glm::vec3 boundsMin(-0.5f, 0.0f, -0.5f);
+	glm::vec3 boundsMax(0.5f, 2.0f, 0.5f);
+
+	float nearSize = AnimationLod::calculateScreenSize(projection, glm::translate(glm::mat4(), glm::vec3(0.0f, 0.0f, -5.0f)), boundsMin, boundsMax);
+	float farSize = AnimationLod::calculateScreenSize(projection, glm::translate(glm::mat4(), glm::vec3(0.0f, 0.0f, -50.0f)), boundsMin, boundsMax);
+	float behindSize = AnimationLod::calculateScreenSize(projection, glm::translate(glm::mat4(), glm::vec3(0.0f, 0.0f, 50.0f)), boundsMin, boundsMax);
+
+	EXPECT_GT(nearSize, 0.0f);
+	EXPECT_NEAR(nearSize / 10.0f, farSize, nearSize * 0.02f);
+	EXPECT_EQ(0.0f, behindSize);
+}
+
+TEST(AnimationSystem, ReducedRatePoses_Are_SpreadEvenlyOverFrames)
+{
+	auto skeleton = AnimationTestRig::createSkeleton();
+	auto animation = AnimationTestRig::createAnimation(skeleton);
+	animation->optimizeForSkeleton(skeleton);
+
+	AnimationSystem& system = AnimationSystem::getInstance();
+	AnimationLodSettings lodSettings;
+	lodSettings.levels = { { 0.0f, 4 } };
+	std::vector<std::shared_ptr<AnimationInstance>> crowd;
+	for (int i = 0; i < 16; i++)
+	{
+		auto instance = std::make_shared<AnimationInstance>(animation, skeleton);
+		instance->setLodSettings(lodSettings);
+		crowd.push_back(instance);
+		system.addInstance(instance);
+	}
+
+	// The first frame samples every instance, since none has been seen by a camera yet
+	auto runFrame = [&]() {
+		for (auto const& instance : crowd)
+		{
+			instance->advance(FRAME_TIME);
+		}
+		system.update();
+		for (auto const& instance : crowd)
+		{
+			instance->setScreenSize(0.01f, system.getFrame());
+		}
+	};
+	runFrame();
+	EXPECT_EQ(crowd.size(), system.getStatistics().lastFramePoseCount);
+
+	// A quarter of the crowd samples each frame after that, and every instance samples once per interval
+	for (int frame = 0; frame < 8; frame++)
+	{
+		runFrame();
+		EXPECT_EQ(crowd.size() / 4, system.getStatistics().lastFramePoseCount);
+	}
+
+	crowd.clear();
+	system.update();
+}
+
+TEST(AnimationSystem, CulledInstance_OnlyAdvancesTime_When_NoCameraSeesIt)
+{
+	auto skeleton = AnimationTestRig::createSkeleton();
+	auto animation = AnimationTestRig::createAnimation(skeleton);
+	animation->optimizeForSkeleton(skeleton);
+
+	AnimationSystem& system = AnimationSystem::getInstance();
+	auto instance = std::make_shared<AnimationInstance>(animation, skeleton);
+	system.addInstance(instance);
+
+	instance->advance(FRAME_TIME);
+	system.update();
+	instance->setScreenSize(0.5f, system.getFrame());
+	std::vector<glm::mat4> seenPose = instance->getBoneTransforms();
+
+	// The frame after it was last seen is still evaluated, every one after that is skipped
+	for (int frame = 0; frame < 10; frame++)
+	{
+		instance->advance(FRAME_TIME);
+		system.update();
+	}
+	EXPECT_TRUE(instance->isCulled(system.getFrame()));
+	EXPECT_TRUE(instance->needsEvaluation());
+	EXPECT_EQ(0u, system.getStatistics().lastFramePoseCount);
+	EXPECT_NEAR(11.0f * FRAME_TIME, instance->getTime(), 0.0001f);
+	EXPECT_NE(seenPose, instance->getBoneTransforms());
+
+	// Once a camera sees it again, the next frame samples the pose at the current time
+	instance->setScreenSize(0.5f, system.getFrame());
+	instance->advance(FRAME_TIME);
+	system.update();
+	EXPECT_FALSE(instance->needsEvaluation());
+
+	std::vector<glm::mat4> expected;
+	animation->loadPose(instance->getTime(), expected, skeleton);
+	EXPECT_EQ(expected, instance->getBoneTransforms());
+
+	instance.reset();
+	system.update();
+}
+
+TEST(AnimationInstance, InterpolatedPose_BlendsBetweenReducedRatePoses)
+{
+	auto skeleton = AnimationTestRig::createSkeleton();
+	auto animation = AnimationTestRig::createAnimation(skeleton);
+	animation->optimizeForSkeleton(skeleton);
+
+	AnimationInstance instance(animation, skeleton);
+	AnimationLodSettings lodSettings;
+	lodSettings.levels = { { 0.0f, 2 } };
+	lodSettings.interpolate = true;
+	instance.setLodSettings(lodSettings);
+
+	// Sample a first pose, then reach the next update frame so a blend towards the second pose starts
+	unsigned int frame = 1;
+	instance.evaluate(instance.getEvaluation(frame));
+	instance.setScreenSize(0.01f, frame);
+	std::vector<glm::mat4> firstPose;
+	animation->loadPose(0.0f, firstPose, skeleton);
+	instance.setTime(0.2f);
+	while (instance.getEvaluation(++frame) != AnimationInstance::Evaluation::SampleBlendTarget)
+	{
+		instance.setScreenSize(0.01f, frame);
+		ASSERT_LT(frame, 10u);
+	}
+	instance.evaluate(AnimationInstance::Evaluation::SampleBlendTarget);
+	instance.setScreenSize(0.01f, frame);
+	EXPECT_EQ(firstPose, instance.getBoneTransforms());
+
+	// Half way to the next update the palette is half way between the two poses
+	instance.setTime(0.3f);
+	frame++;
+	ASSERT_EQ(AnimationInstance::Evaluation::Blend, instance.getEvaluation(frame));
+	instance.evaluate(AnimationInstance::Evaluation::Blend);
+
+	std::vector<glm::mat4> secondPose;
+	animation->loadPose(0.2f, secondPose, skeleton);
+	for (size_t bone = 0; bone < secondPose.size(); bone++)
+	{
+		glm::mat4 halfway = firstPose[bone] * 0.5f + secondPose[bone] * 0.5f;
+		for (int column = 0; column < 4; column++)
+		{
+			for (int row = 0; row < 4; row++)
+			{
+				EXPECT_NEAR(halfway[column][row], instance.getBoneTransforms()[bone][column][row], 0.0001f);
+			}
+		}
+	}
+}
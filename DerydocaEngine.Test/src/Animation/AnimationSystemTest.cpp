@@ -0,0 +1,132 @@
+#include "EngineTestPch.h"
+#include "Animation\AnimationSystem.h"
+#include "Animation\AnimationTestRig.h"
+
+#include <thread>
+
+using namespace DerydocaEngine::Animation;
+
+static const int CROWD_SIZE = 64;
+static const int BENCHMARK_CROWD_SIZES[] = { 250, 1000, 4000 };
+static const int BENCHMARK_FRAME_COUNT = 30;
+
+static std::vector<std::shared_ptr<AnimationInstance>> createCrowd(int const& size, std::shared_ptr<AnimationData> const& animation, std::shared_ptr<Skeleton> const& skeleton)
+{
+	// Every instance starts at a different point and plays at a different speed
+	std::vector<std::shared_ptr<AnimationInstance>> crowd;
+	for (int i = 0; i < size; i++)
+	{
+		auto instance = std::make_shared<AnimationInstance>(animation, skeleton);
+		instance->setTime((float)(animation->getDuration() * i / size));
+		instance->setSpeed(0.5f + (i % 7) * 0.25f);
+		crowd.push_back(instance);
+	}
+	return crowd;
+}
+
+TEST(AnimationSystem, ParallelPosesMatchSerialPoses_When_InstancesPlayAtTheirOwnSpeed)
+{
+	auto skeleton = AnimationTestRig::createSkeleton();
+	auto animation = AnimationTestRig::createAnimation(skeleton);
+	animation->optimizeForSkeleton(skeleton);
+
+	AnimationSystem& system = AnimationSystem::getInstance();
+	system.setThreadCount(4);
+	auto crowd = createCrowd(CROWD_SIZE, animation, skeleton);
+	for (auto const& instance : crowd)
+	{
+		system.addInstance(instance);
+	}
+
+	std::vector<glm::mat4> expected;
+	for (int frame = 0; frame < 20; frame++)
+	{
+		for (auto const& instance : crowd)
+		{
+			instance->advance(1.0f / 60.0f);
+		}
+		system.update();
+		ASSERT_EQ((size_t)CROWD_SIZE, system.getStatistics().lastFramePoseCount);
+
+		for (auto const& instance : crowd)
+		{
+			EXPECT_FALSE(instance->needsEvaluation());
+			animation->loadPose(instance->getTime(), expected, skeleton);
+			ASSERT_EQ(expected, instance->getBoneTransforms());
+		}
+	}
+
+	// Instances that did not move are not evaluated again, and released ones are dropped
+	crowd[0]->advance(0.1f);
+	system.update();
+	EXPECT_EQ(1u, system.getStatistics().lastFramePoseCount);
+
+	crowd.clear();
+	system.update();
+	EXPECT_EQ(0u, system.getInstanceCount());
+	system.setThreadCount(0);
+}
+
+TEST(AnimationInstance, PaletteOffsetIsDropped_When_PoseChangesAfterItWasWritten)
+{
+	auto skeleton = AnimationTestRig::createSkeleton();
+	auto animation = AnimationTestRig::createAnimation(skeleton);
+	AnimationInstance instance(animation, skeleton);
+	instance.evaluate();
+
+	instance.setPaletteOffset(128, 7);
+	EXPECT_EQ(128, instance.getPaletteOffset(7));
+	EXPECT_EQ(-1, instance.getPaletteOffset(8));
+
+	// The palette stays valid while only the playhead moves, since it still shows the last pose, until the pose is evaluated again
+	instance.advance(0.1f);
+	EXPECT_EQ(128, instance.getPaletteOffset(7));
+	instance.evaluate();
+	EXPECT_EQ(-1, instance.getPaletteOffset(7));
+}
+
+TEST(AnimationSystem, DISABLED_Benchmark_CrowdScalingWithThreads)
+{
+	auto skeleton = AnimationTestRig::createSkeleton();
+	auto animation = AnimationTestRig::createAnimation(skeleton, 4.0);
+	animation->optimizeForSkeleton(skeleton);
+
+	AnimationSystem& system = AnimationSystem::getInstance();
+	unsigned int coreCount = std::max(std::thread::hardware_concurrency(), 1u);
+	for (int crowdSize : BENCHMARK_CROWD_SIZES)
+	{
+		auto crowd = createCrowd(crowdSize, animation, skeleton);
+		for (auto const& instance : crowd)
+		{
+			system.addInstance(instance);
+		}
+
+		double singleThreadTime = 0.0;
+		for (unsigned int threadCount = 1; threadCount <= coreCount; threadCount *= 2)
+		{
+			system.setThreadCount(threadCount);
+			double frameTime = 0.0;
+			for (int frame = 0; frame < BENCHMARK_FRAME_COUNT; frame++)
+			{
+				for (auto const& instance : crowd)
+				{
+					instance->advance(1.0f / 60.0f);
+				}
+				system.update();
+				frameTime += system.getStatistics().lastEvaluateTime;
+			}
+			frameTime /= BENCHMARK_FRAME_COUNT;
+			if (threadCount == 1)
+			{
+				singleThreadTime = frameTime;
+			}
+
+			printf("%d characters of %zu bones on %u threads: %.3fms per frame (%.2fx)\n",
+				crowdSize, skeleton->getNumBones(), threadCount, frameTime, singleThreadTime / frameTime);
+		}
+
+		crowd.clear();
+		system.update();
+	}
+	system.setThreadCount(0);
+}
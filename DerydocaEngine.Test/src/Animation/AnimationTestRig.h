@@ -0,0 +1,113 @@
+#pragma once
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include "Animation\AnimationData.h"
+#include "Animation\Skeleton.h"
+
+// Synthetic characters for the animation tests and benchmarks, shaped like a spine with limbs hanging off it
+namespace AnimationTestRig
+{
+
+	static const int SPINE_LENGTH = 4;
+	static const int LIMB_COUNT = 5;
+	static const int LIMB_LENGTH = 12;
+	static const int KEYS_PER_SECOND = 30;
+
+	inline std::string getBoneName(unsigned int const& boneId)
+	{
+		return "Bone" + std::to_string(boneId);
+	}
+
+	inline unsigned int addBone(DerydocaEngine::Animation::Skeleton& skeleton, int const& parentIndex, int const& depth)
+	{
+		// Each bone sits a unit above its parent, and binding moves it back to the origin
+		glm::mat4 inverseBindTransform = glm::translate(glm::mat4(), glm::vec3(0.0f, -(float)depth, 0.0f));
+		glm::mat4 restTransform = glm::translate(glm::mat4(), glm::vec3(0.0f, parentIndex < 0 ? 0.0f : 1.0f, 0.0f));
+		return skeleton.addBone(getBoneName((unsigned int)skeleton.getNumBones()), parentIndex, inverseBindTransform, restTransform);
+	}
+
+	/* Creates a skeleton with a spine, and limbs that branch off its last bone */
+	inline std::shared_ptr<DerydocaEngine::Animation::Skeleton> createSkeleton(int const& limbCount = LIMB_COUNT, int const& limbLength = LIMB_LENGTH)
+	{
+		auto skeleton = std::make_shared<DerydocaEngine::Animation::Skeleton>(glm::translate(glm::mat4(), glm::vec3(0.0f, 0.5f, 0.0f)));
+
+		int spine = (int)addBone(*skeleton, -1, 0);
+		for (int i = 1; i < SPINE_LENGTH; i++)
+		{
+			spine = (int)addBone(*skeleton, spine, i);
+		}
+
+		for (int limb = 0; limb < limbCount; limb++)
+		{
+			int parent = spine;
+			for (int i = 0; i < limbLength; i++)
+			{
+				parent = (int)addBone(*skeleton, parent, SPINE_LENGTH + i);
+			}
+		}
+
+		return skeleton;
+	}
+
+	/*
+	Creates the channels of a looping animation that keys every bone of a skeleton, except that the
+	second bone only has a single key for each track and the last bone is not animated at all.
+	*/
+	inline std::vector<DerydocaEngine::Animation::AnimationChannel> createChannels(std::shared_ptr<DerydocaEngine::Animation::Skeleton> const& skeleton, double const& duration = 2.0)
+	{
+		using namespace DerydocaEngine::Animation;
+
+		unsigned int boneCount = (unsigned int)skeleton->getNumBones();
+		int keyCount = (int)(duration * KEYS_PER_SECOND) + 1;
+
+		std::vector<AnimationChannel> channels;
+		for (unsigned int bone = 0; bone + 1 < boneCount; bone++)
+		{
+			std::vector<AnimationKey<glm::vec3>> positionKeys;
+			std::vector<AnimationKey<glm::quat>> rotationKeys;
+			std::vector<AnimationKey<glm::vec3>> scaleKeys;
+
+			int boneKeyCount = bone == 1 ? 1 : keyCount;
+			glm::vec3 axis = glm::normalize(glm::vec3(1.0f + bone % 3, 0.5f * (bone % 5), 1.0f));
+			for (int key = 0; key < boneKeyCount; key++)
+			{
+				double time = duration * key / (keyCount - 1);
+				float phase = (float)(time / duration * 6.2831853) * (1 + bone % 3) + bone;
+
+				positionKeys.push_back(AnimationKey<glm::vec3>(time, glm::vec3(0.1f * std::sin(phase), 1.0f, 0.05f * std::cos(phase))));
+				rotationKeys.push_back(AnimationKey<glm::quat>(time, glm::angleAxis(0.6f * std::sin(phase), axis)));
+				scaleKeys.push_back(AnimationKey<glm::vec3>(time, glm::vec3(1.0f + 0.05f * std::sin(phase * 0.5f))));
+			}
+
+			channels.push_back(AnimationChannel(getBoneName(bone), positionKeys, rotationKeys, scaleKeys));
+		}
+
+		return channels;
+	}
+
+	inline std::shared_ptr<DerydocaEngine::Animation::AnimationData> createAnimation(std::shared_ptr<DerydocaEngine::Animation::Skeleton> const& skeleton, double const& duration = 2.0)
+	{
+		return std::make_shared<DerydocaEngine::Animation::AnimationData>("Test", duration, createChannels(skeleton, duration));
+	}
+
+	/* Gets where each channel made by createChannels sits in the skeleton */
+	inline std::vector<DerydocaEngine::Animation::AnimationCompression::ChannelHierarchy> createHierarchy(std::shared_ptr<DerydocaEngine::Animation::Skeleton> const& skeleton)
+	{
+		// Every channel animates the bone with the same index, and each bone is a unit from its parent
+		std::vector<int> const& parentIndices = skeleton->getParentIndices();
+		std::vector<float> extents(parentIndices.size(), 0.0f);
+		for (size_t bone = parentIndices.size(); bone-- > 1;)
+		{
+			extents[parentIndices[bone]] = std::max(extents[parentIndices[bone]], extents[bone] + 1.0f);
+		}
+
+		std::vector<DerydocaEngine::Animation::AnimationCompression::ChannelHierarchy> hierarchy(parentIndices.size() - 1);
+		for (size_t bone = 0; bone < hierarchy.size(); bone++)
+		{
+			hierarchy[bone].parentChannel = parentIndices[bone];
+			hierarchy[bone].extent = extents[bone];
+		}
+		return hierarchy;
+	}
+
+}
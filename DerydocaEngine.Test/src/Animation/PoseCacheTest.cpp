@@ -0,0 +1,189 @@
+#include "EngineTestPch.h"
+#include "Animation\AnimationInstance.h"
+#include "Animation\PoseCache.h"
+#include "Animation\AnimationTestRig.h"
+
+#include <chrono>
+
+using namespace DerydocaEngine::Animation;
+
+static const int BENCHMARK_CROWD_SIZE = 1000;
+static const int BENCHMARK_FRAME_COUNT = 60;
+
+static void expectPosesNear(std::vector<glm::mat4> const& expected, std::vector<glm::mat4> const& actual, float const& tolerance)
+{
+	ASSERT_EQ(expected.size(), actual.size());
+	for (size_t bone = 0; bone < expected.size(); bone++)
+	{
+		for (int column = 0; column < 4; column++)
+		{
+			for (int row = 0; row < 4; row++)
+			{
+				EXPECT_NEAR(expected[bone][column][row], actual[bone][column][row], tolerance);
+			}
+		}
+	}
+}
+
+TEST(PoseCache, CachedPoses_MatchSampledPoses_When_LookedUpOnAFrame)
+{
+	auto skeleton = AnimationTestRig::createSkeleton();
+	auto animation = AnimationTestRig::createAnimation(skeleton);
+	animation->optimizeForSkeleton(skeleton);
+
+	PoseCacheSettings settings;
+	settings.sampleRate = 60.0f;
+	PoseCache cache;
+	ASSERT_TRUE(cache.build(*animation, skeleton, settings));
+	EXPECT_FALSE(cache.isEmpty());
+	EXPECT_EQ((size_t)std::ceil(animation->getDuration() * 60.0), cache.getFrameCount());
+
+	std::vector<glm::mat4> expected;
+	std::vector<glm::mat4> actual;
+	for (size_t frame = 0; frame < cache.getFrameCount(); frame += 7)
+	{
+		float time = (float)(animation->getDuration() * frame / cache.getFrameCount());
+		animation->loadPose(time, expected, skeleton);
+		cache.loadPose(time, actual);
+		expectPosesNear(expected, actual, 0.0001f);
+	}
+
+	// In between frames, and a loop later, the blended entries stay close to the sampled pose
+	float time = (float)(animation->getDuration() * 2.5 / cache.getFrameCount() + animation->getDuration());
+	animation->loadPose(time, expected, skeleton);
+	cache.loadPose(time, actual);
+	expectPosesNear(expected, actual, 0.05f);
+}
+
+TEST(PoseCache, SampleRate_IsLowered_When_TableExceedsItsLimit)
+{
+	auto skeleton = AnimationTestRig::createSkeleton();
+	auto animation = AnimationTestRig::createAnimation(skeleton, 4.0);
+	animation->optimizeForSkeleton(skeleton);
+	size_t frameSize = skeleton->getNumBones() * sizeof(glm::mat4);
+
+	// A limit of half the table's size halves the rate
+	PoseCacheSettings settings;
+	settings.sampleRate = 30.0f;
+	settings.minSampleRate = 10.0f;
+	settings.maxKilobytes = (size_t)(animation->getDuration() * 15.0) * frameSize / 1024 + 1;
+	PoseCache cache;
+	ASSERT_TRUE(cache.build(*animation, skeleton, settings));
+	EXPECT_LE(cache.getSize(), settings.maxKilobytes * 1024);
+	EXPECT_NEAR(15.0f, cache.getSampleRate(), 0.5f);
+
+	// Below the lowest rate allowed there is no table at all
+	settings.maxKilobytes = (size_t)(animation->getDuration() * 5.0) * frameSize / 1024;
+	EXPECT_FALSE(cache.build(*animation, skeleton, settings));
+	EXPECT_TRUE(cache.isEmpty());
+	EXPECT_EQ(0u, cache.getSize());
+}
+
+TEST(PoseCache, Instance_SamplesLive_When_LiveSamplingIsForced)
+{
+	auto skeleton = AnimationTestRig::createSkeleton();
+	auto animation = AnimationTestRig::createAnimation(skeleton);
+	PoseCacheSettings settings;
+	settings.enabled = true;
+	settings.interpolate = false;
+	animation->setPoseCacheSettings(settings);
+	animation->optimizeForSkeleton(skeleton);
+
+	// Half way between two frames of the table, so the nearest entry is off from the sampled pose
+	float time = 1.5f / settings.sampleRate;
+	AnimationInstance cachedInstance(animation, skeleton);
+	cachedInstance.setTime(time);
+	cachedInstance.evaluate();
+	EXPECT_TRUE(cachedInstance.usesPoseCache());
+
+	AnimationInstance liveInstance(animation, skeleton);
+	liveInstance.setLiveSampling(true);
+	liveInstance.setTime(time);
+	liveInstance.evaluate();
+	EXPECT_FALSE(liveInstance.usesPoseCache());
+
+	std::vector<glm::mat4> expected;
+	animation->loadPose(time, expected, skeleton);
+	EXPECT_EQ(expected, liveInstance.getBoneTransforms());
+	EXPECT_NE(expected, cachedInstance.getBoneTransforms());
+
+	// Another skeleton has no table of its own, so it is sampled live too
+	auto otherSkeleton = AnimationTestRig::createSkeleton();
+	AnimationInstance otherInstance(animation, otherSkeleton);
+	EXPECT_FALSE(otherInstance.usesPoseCache());
+}
+
+TEST(PoseCache, EachSkeleton_KeepsItsOwnCache_When_AnimationIsShared)
+{
+	auto skeleton = AnimationTestRig::createSkeleton();
+	auto otherSkeleton = AnimationTestRig::createSkeleton();
+	auto animation = AnimationTestRig::createAnimation(skeleton);
+	PoseCacheSettings settings;
+	settings.enabled = true;
+	animation->setPoseCacheSettings(settings);
+
+	// Binding the animation to a second skeleton leaves the first skeleton's table as it was
+	animation->optimizeForSkeleton(skeleton);
+	const PoseCache* cache = animation->getPoseCache(skeleton);
+	ASSERT_NE(nullptr, cache);
+	animation->optimizeForSkeleton(otherSkeleton);
+	animation->optimizeForSkeleton(skeleton);
+	EXPECT_EQ(cache, animation->getPoseCache(skeleton));
+	EXPECT_NE(nullptr, animation->getPoseCache(otherSkeleton));
+	EXPECT_NE(cache, animation->getPoseCache(otherSkeleton));
+
+	// A skeleton created after another was freed has no table, even if it reuses the address
+	otherSkeleton.reset();
+	auto newSkeleton = AnimationTestRig::createSkeleton();
+	EXPECT_EQ(nullptr, animation->getPoseCache(newSkeleton));
+	AnimationInstance instance(animation, newSkeleton);
+	EXPECT_FALSE(instance.usesPoseCache());
+}
+
+TEST(PoseCache, DISABLED_Benchmark_CachedVersusLiveSampling)
+{
+	auto skeleton = AnimationTestRig::createSkeleton();
+	auto animation = AnimationTestRig::createAnimation(skeleton, 4.0);
+	PoseCacheSettings settings;
+	settings.enabled = true;
+	animation->setPoseCacheSettings(settings);
+	animation->optimizeForSkeleton(skeleton);
+
+	for (int mode = 0; mode < 3; mode++)
+	{
+		bool live = mode == 0;
+		settings.interpolate = mode == 2;
+		if (!live)
+		{
+			animation->setPoseCacheSettings(settings);
+			animation->optimizeForSkeleton(skeleton);
+		}
+
+		std::vector<std::shared_ptr<AnimationInstance>> crowd;
+		for (int i = 0; i < BENCHMARK_CROWD_SIZE; i++)
+		{
+			auto instance = std::make_shared<AnimationInstance>(animation, skeleton);
+			instance->setTime((float)(animation->getDuration() * i / BENCHMARK_CROWD_SIZE));
+			instance->setLiveSampling(live);
+			crowd.push_back(instance);
+		}
+
+		auto startTime = std::chrono::high_resolution_clock::now();
+		for (int frame = 0; frame < BENCHMARK_FRAME_COUNT; frame++)
+		{
+			for (auto const& instance : crowd)
+			{
+				instance->advance(1.0f / 60.0f);
+				instance->evaluate();
+			}
+		}
+		std::chrono::duration<double, std::milli> time = std::chrono::high_resolution_clock::now() - startTime;
+
+		printf("%s: %d characters of %zu bones in %.3fms per frame, %.1f KB of table\n",
+			live ? "Live sampling" : settings.interpolate ? "Cached, blended" : "Cached, nearest",
+			BENCHMARK_CROWD_SIZE,
+			skeleton->getNumBones(),
+			time.count() / BENCHMARK_FRAME_COUNT,
+			live ? 0.0f : animation->getPoseCache(skeleton)->getSize() / 1024.0f);
+	}
+}
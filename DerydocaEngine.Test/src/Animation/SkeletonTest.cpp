@@ -0,0 +1,36 @@
+#include "EngineTestPch.h"
+#include "Animation\Skeleton.h"
+#include "Animation\AnimationTestRig.h"
+
+using namespace DerydocaEngine::Animation;
+
+TEST(Skeleton, ParentsComeBeforeChildren_When_SkeletonIsBuilt)
+{
+	auto skeleton = AnimationTestRig::createSkeleton();
+	ASSERT_EQ((size_t)(AnimationTestRig::SPINE_LENGTH + AnimationTestRig::LIMB_COUNT * AnimationTestRig::LIMB_LENGTH), skeleton->getNumBones());
+
+	std::vector<int> const& parentIndices = skeleton->getParentIndices();
+	EXPECT_EQ(-1, parentIndices[0]);
+	for (size_t bone = 1; bone < skeleton->getNumBones(); bone++)
+	{
+		EXPECT_GE(parentIndices[bone], 0);
+		EXPECT_LT(parentIndices[bone], (int)bone);
+	}
+
+	EXPECT_EQ(skeleton->getNumBones(), skeleton->getInverseBindTransforms().size());
+	EXPECT_EQ(skeleton->getNumBones(), skeleton->getRestTransforms().size());
+	EXPECT_EQ(skeleton->getNumBones(), skeleton->getNameHashes().size());
+}
+
+TEST(Skeleton, BoneIsFoundByName_When_NameIsInSkeleton)
+{
+	auto skeleton = AnimationTestRig::createSkeleton();
+
+	for (unsigned int bone = 0; bone < skeleton->getNumBones(); bone++)
+	{
+		EXPECT_EQ(bone, skeleton->getBoneID(AnimationTestRig::getBoneName(bone)));
+		EXPECT_EQ(Skeleton::hashBoneName(AnimationTestRig::getBoneName(bone)), skeleton->getNameHashes()[bone]);
+	}
+	EXPECT_EQ((unsigned int)-1, skeleton->getBoneID("Missing"));
+	EXPECT_EQ(AnimationTestRig::getBoneName(0), skeleton->getName());
+}
@@ -0,0 +1,121 @@
+#include "EngineTestPch.h"
+#include "Files\FileWatcher.h"
+#include <condition_variable>
+#include <mutex>
+
+using namespace DerydocaEngine::Files;
+
+namespace fs = boost::filesystem;
+
+// Collects the batches handed to a watcher's listeners
+class BatchRecorder
+{
+public:
+	FileWatcher::Listener getListener()
+	{
+		return [this](std::vector<std::string> const& changedFiles) {
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_batches.push_back(changedFiles);
+			m_batchReceived.notify_all();
+		};
+	}
+
+	bool waitForBatches(size_t const& count)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return m_batchReceived.wait_for(lock, std::chrono::seconds(10), [&]() { return m_batches.size() >= count; });
+	}
+
+	std::vector<std::vector<std::string>> getBatches()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_batches;
+	}
+private:
+	std::mutex m_mutex;
+	std::condition_variable m_batchReceived;
+	std::vector<std::vector<std::string>> m_batches;
+};
+
+static void writeFile(fs::path const& path, std::string const& contents)
+{
+	std::ofstream file(path.string(), std::ios::binary | std::ios::trunc);
+	file << contents;
+}
+
+static void expectBurstIsCoalesced(bool const& forcePolling)
+{
+	fs::path directory = fs::temp_directory_path() / fs::unique_path();
+	fs::create_directories(directory / "textures");
+	writeFile(directory / "shader.vs", "a");
+
+	BatchRecorder recorder;
+	{
+		FileWatcher watcher(forcePolling);
+		watcher.setCoalescingDelay(200);
+		watcher.setPollingInterval(50);
+		watcher.addListener(recorder.getListener());
+		watcher.watchDirectory(directory);
+
+		// Give the watcher time to take its initial look at the directory
+		std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+		writeFile(directory / "shader.vs", "changed");
+		writeFile(directory / "textures" / "grass.png", "new");
+		writeFile(directory / "shader.vs", "changed again");
+
+		ASSERT_TRUE(recorder.waitForBatches(1));
+		std::this_thread::sleep_for(std::chrono::milliseconds(500));
+	}
+
+	auto batches = recorder.getBatches();
+	ASSERT_EQ(batches.size(), 1u);
+	std::vector<std::string> expected = {
+		(fs::absolute(directory).lexically_normal() / "shader.vs").string(),
+		(fs::absolute(directory).lexically_normal() / "textures" / "grass.png").string()
+	};
+	std::sort(expected.begin(), expected.end());
+	EXPECT_EQ(batches[0], expected);
+
+	fs::remove_all(directory);
+}
+
+TEST(FileWatcher, BurstOfChangesIsReportedOnce_When_Watching)
+{
+	expectBurstIsCoalesced(false);
+}
+
+TEST(FileWatcher, BurstOfChangesIsReportedOnce_When_Polling)
+{
+	expectBurstIsCoalesced(true);
+}
+
+TEST(FileWatcher, FilesInNewDirectoriesAreReported_When_DirectoryIsCreated)
+{
+	fs::path directory = fs::temp_directory_path() / fs::unique_path();
+	fs::create_directories(directory);
+
+	BatchRecorder recorder;
+	{
+		FileWatcher watcher;
+		watcher.setCoalescingDelay(200);
+		watcher.addListener(recorder.getListener());
+		watcher.watchDirectory(directory);
+		std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+		fs::create_directories(directory / "models");
+		writeFile(directory / "models" / "cube.obj", "v 0 0 0");
+
+		ASSERT_TRUE(recorder.waitForBatches(1));
+	}
+
+	std::string expected = (fs::absolute(directory).lexically_normal() / "models" / "cube.obj").string();
+	bool found = false;
+	for (auto const& batch : recorder.getBatches())
+	{
+		found |= std::find(batch.begin(), batch.end(), expected) != batch.end();
+	}
+	EXPECT_TRUE(found);
+
+	fs::remove_all(directory);
+}
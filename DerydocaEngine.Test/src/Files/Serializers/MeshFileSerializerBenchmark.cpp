@@ -0,0 +1,80 @@
+#include "EngineTestPch.h"
+#include "Files\Serializers\MeshFileSerializer.h"
+#include <boost/uuid/uuid_io.hpp>
+
+using namespace DerydocaEngine::Files::Serializers;
+
+namespace fs = boost::filesystem;
+
+// Emits resource nodes with every generated ID replaced by the order it first appeared in, so nodes
+// generated by different imports can be compared
+static std::string emitWithoutIds(YAML::Node const& resources)
+{
+	std::map<std::string, int> idIndices;
+	auto replaceId = [&](YAML::Node node) {
+		std::string id = node.as<std::string>();
+		auto search = idIndices.find(id);
+		int index = search == idIndices.end() ? static_cast<int>(idIndices.size()) : search->second;
+		idIndices.emplace(id, index);
+		node = "#" + std::to_string(index);
+	};
+
+	YAML::Node copy = YAML::Clone(resources);
+	for (size_t i = 0; i < copy.size(); i++)
+	{
+		replaceId(copy[i]["ID"]);
+		if (copy[i]["Skeleton"])
+		{
+			replaceId(copy[i]["Skeleton"]);
+		}
+	}
+
+	YAML::Node root;
+	root["Resources"] = copy;
+	YAML::Emitter out;
+	out.SetIndent(2);
+	out.SetMapFormat(YAML::Block);
+	out << root;
+	return out.c_str();
+}
+
+TEST(MeshSerializer, DISABLED_Benchmark_GenerateResourceNodesOfExampleModels)
+{
+	std::vector<std::string> modelFiles;
+	for (fs::directory_iterator it{ fs::path("..") / "exampleProject" / "models" }; it != fs::directory_iterator{}; it++)
+	{
+		std::string extension = it->path().extension().string();
+		if (extension == ".fbx" || extension == ".obj")
+		{
+			modelFiles.push_back(it->path().string());
+		}
+	}
+	std::sort(modelFiles.begin(), modelFiles.end());
+	ASSERT_FALSE(modelFiles.empty());
+
+	MeshSerializer serializer;
+	double totalFullTime = 0.0;
+	double totalMetadataTime = 0.0;
+	for (auto const& modelFile : modelFiles)
+	{
+		auto startTime = std::chrono::high_resolution_clock::now();
+		YAML::Node fullNodes = serializer.generateResourceNodes(modelFile, true);
+		std::chrono::duration<double, std::milli> fullTime = std::chrono::high_resolution_clock::now() - startTime;
+
+		startTime = std::chrono::high_resolution_clock::now();
+		YAML::Node metadataNodes = serializer.generateResourceNodes(modelFile, false);
+		std::chrono::duration<double, std::milli> metadataTime = std::chrono::high_resolution_clock::now() - startTime;
+
+		printf("%s: %.2fms with a full import, %.2fms with a metadata import\n", modelFile.c_str(), fullTime.count(), metadataTime.count());
+		totalFullTime += fullTime.count();
+		totalMetadataTime += metadataTime.count();
+
+		EXPECT_EQ(emitWithoutIds(metadataNodes), emitWithoutIds(fullNodes)) << modelFile;
+	}
+
+	printf("Generated the resource nodes of %d models in %.2fms with a full import and %.2fms with a metadata import (%.2fx)\n",
+		static_cast<int>(modelFiles.size()),
+		totalFullTime,
+		totalMetadataTime,
+		totalFullTime / totalMetadataTime);
+}
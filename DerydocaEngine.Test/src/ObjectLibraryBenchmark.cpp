@@ -0,0 +1,134 @@
+#include "EngineTestPch.h"
+#include "ObjectLibrary.h"
+#include <thread>
+#include <boost/uuid/uuid_io.hpp>
+
+using namespace DerydocaEngine;
+
+namespace fs = boost::filesystem;
+
+static const int BENCHMARK_ASSET_COUNT = 50000;
+static const int BENCHMARK_ASSETS_PER_DIRECTORY = 100;
+
+static boost::uuids::uuid benchmarkAssetId(int const& assetIndex)
+{
+	// Every thousandth asset reuses the ID of the asset before it, which must keep the ID
+	int idIndex = assetIndex % 1000 == 999 ? assetIndex - 1 : assetIndex;
+
+	boost::uuids::uuid id = {};
+	id.data[0] = 0xbe;
+	id.data[12] = static_cast<uint8_t>(idIndex >> 24);
+	id.data[13] = static_cast<uint8_t>(idIndex >> 16);
+	id.data[14] = static_cast<uint8_t>(idIndex >> 8);
+	id.data[15] = static_cast<uint8_t>(idIndex);
+	return id;
+}
+
+static std::string benchmarkAssetPath(fs::path const& root, int const& assetIndex)
+{
+	int directoryIndex = assetIndex / BENCHMARK_ASSETS_PER_DIRECTORY;
+	char name[32];
+	snprintf(name, sizeof(name), "asset_%05d.png", assetIndex);
+	return (root / std::to_string(directoryIndex / 10) / std::to_string(directoryIndex % 10) / name).string();
+}
+
+static void createBenchmarkProject(fs::path const& root)
+{
+	// Only build the tree once, it is reused by later runs
+	fs::path completeMarker = root.string() + ".complete";
+	if (fs::exists(completeMarker))
+	{
+		return;
+	}
+
+	for (int i = 0; i < BENCHMARK_ASSET_COUNT; i++)
+	{
+		std::string assetPath = benchmarkAssetPath(root, i);
+		fs::create_directories(fs::path(assetPath).parent_path());
+		std::ofstream(assetPath).close();
+		std::ofstream meta(assetPath + ".derymeta");
+		meta << "Resources:\n  - ID: " << boost::uuids::to_string(benchmarkAssetId(i)) << "\n";
+	}
+
+	std::ofstream(completeMarker.string()).close();
+}
+
+TEST(ObjectLibrary, DISABLED_Benchmark_LoadDirectoryOfFiftyThousandAssets)
+{
+	fs::path root = fs::temp_directory_path() / "DerydocaEngineObjectLibraryBenchmark";
+	createBenchmarkProject(root);
+
+	ObjectLibrary& library = ObjectLibrary::getInstance();
+	auto timeLoad = [&](unsigned int const& threadCount) {
+		library.setLoadThreadCount(threadCount);
+		auto startTime = std::chrono::high_resolution_clock::now();
+		library.loadDirectory(root);
+		std::chrono::duration<double, std::milli> loadTime = std::chrono::high_resolution_clock::now() - startTime;
+		return loadTime.count();
+	};
+
+	// The first load warms up the file system cache and registers every resource. Later loads
+	// parse the same files, but the resources they find are already registered.
+	timeLoad(0);
+	double sequentialTime = timeLoad(1);
+	double parallelTime = timeLoad(0);
+	library.setLoadThreadCount(0);
+
+	printf("Loaded %d assets in %.2fms on one thread and %.2fms on %u threads (%.2fx)\n",
+		BENCHMARK_ASSET_COUNT,
+		sequentialTime,
+		parallelTime,
+		std::thread::hardware_concurrency(),
+		sequentialTime / parallelTime);
+
+	// Duplicate IDs must go to the file that comes first, no matter which thread parsed it first
+	for (int i = 0; i < BENCHMARK_ASSET_COUNT; i += 37)
+	{
+		int ownerIndex = i % 1000 == 999 ? i - 1 : i;
+		auto resource = library.getResource(benchmarkAssetId(i));
+		ASSERT_NE(resource, nullptr);
+		EXPECT_EQ(resource->getSourceFilePath(), benchmarkAssetPath(root, ownerIndex));
+	}
+	for (int i = 999; i < BENCHMARK_ASSET_COUNT; i += 1000)
+	{
+		EXPECT_EQ(library.getResource(benchmarkAssetId(i))->getSourceFilePath(), benchmarkAssetPath(root, i - 1));
+	}
+}
+
+TEST(ObjectLibrary, DISABLED_Benchmark_LoadDirectoryOfFiftyThousandAssetsFromResourceIndex)
+{
+	fs::path root = fs::temp_directory_path() / "DerydocaEngineObjectLibraryBenchmark";
+	fs::path indexDirectory = fs::temp_directory_path() / "DerydocaEngineObjectLibraryBenchmarkIndex";
+	createBenchmarkProject(root);
+	fs::remove_all(indexDirectory);
+
+	ObjectLibrary& library = ObjectLibrary::getInstance();
+	auto timeLoad = [&]() {
+		auto startTime = std::chrono::high_resolution_clock::now();
+		library.loadDirectory(root);
+		std::chrono::duration<double, std::milli> loadTime = std::chrono::high_resolution_clock::now() - startTime;
+		return loadTime.count();
+	};
+
+	// Warm up the file system cache, then parse every meta file and build the index
+	library.setIndexDirectory(std::string());
+	timeLoad();
+	library.setIndexDirectory(indexDirectory.string());
+	double coldTime = timeLoad();
+	double warmTime = timeLoad();
+	library.setIndexDirectory(std::string());
+
+	printf("Loaded %d assets in %.2fms without an index and %.2fms from the index (%.2fx)\n",
+		BENCHMARK_ASSET_COUNT,
+		coldTime,
+		warmTime,
+		coldTime / warmTime);
+
+	for (int i = 0; i < BENCHMARK_ASSET_COUNT; i += 37)
+	{
+		int ownerIndex = i % 1000 == 999 ? i - 1 : i;
+		auto resource = library.getResource(benchmarkAssetId(i));
+		ASSERT_NE(resource, nullptr);
+		EXPECT_EQ(resource->getSourceFilePath(), benchmarkAssetPath(root, ownerIndex));
+	}
+}
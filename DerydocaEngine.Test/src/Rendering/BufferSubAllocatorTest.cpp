@@ -0,0 +1,111 @@
+#include "EngineTestPch.h"
+#include "Rendering\BufferSubAllocator.h"
+
+using namespace DerydocaEngine::Rendering;
+
+TEST(BufferSubAllocator, AllocationsDoNotOverlap_When_AllocatedBackToBack)
+{
+	BufferSubAllocator allocator(100);
+
+	auto a = allocator.allocate(30);
+	auto b = allocator.allocate(50);
+
+	ASSERT_NE(a, BufferSubAllocator::INVALID_ALLOCATION);
+	ASSERT_NE(b, BufferSubAllocator::INVALID_ALLOCATION);
+	EXPECT_GE(allocator.getOffset(b), allocator.getOffset(a) + allocator.getSize(a));
+	EXPECT_EQ(allocator.getUsedSize(), 80u);
+	EXPECT_FLOAT_EQ(allocator.getOccupancy(), 0.8f);
+}
+
+TEST(BufferSubAllocator, AllocationFails_When_NoRangeIsLargeEnough)
+{
+	BufferSubAllocator allocator(100);
+
+	allocator.allocate(60);
+
+	EXPECT_EQ(allocator.allocate(50), BufferSubAllocator::INVALID_ALLOCATION);
+	EXPECT_EQ(allocator.allocate(0), BufferSubAllocator::INVALID_ALLOCATION);
+}
+
+TEST(BufferSubAllocator, FreeRangesMerge_When_NeighboursAreReleased)
+{
+	BufferSubAllocator allocator(90);
+	auto a = allocator.allocate(30);
+	auto b = allocator.allocate(30);
+	auto c = allocator.allocate(30);
+
+	allocator.free(a);
+	allocator.free(c);
+	EXPECT_EQ(allocator.getFreeRangeCount(), 2u);
+	EXPECT_GT(allocator.getFragmentation(), 0.0f);
+
+	allocator.free(b);
+	EXPECT_EQ(allocator.getFreeRangeCount(), 1u);
+	EXPECT_EQ(allocator.getLargestFreeRange(), 90u);
+	EXPECT_FLOAT_EQ(allocator.getFragmentation(), 0.0f);
+}
+
+TEST(BufferSubAllocator, SmallestFittingRangeIsUsed_When_SeveralRangesAreFree)
+{
+	BufferSubAllocator allocator(100);
+	auto a = allocator.allocate(40);
+	allocator.allocate(10);
+	auto c = allocator.allocate(20);
+	allocator.allocate(30);
+	allocator.free(a);
+	allocator.free(c);
+
+	auto d = allocator.allocate(15);
+
+	EXPECT_EQ(allocator.getOffset(d), 50u);
+}
+
+TEST(BufferSubAllocator, FreeSpaceIsContiguous_When_Defragmented)
+{
+	BufferSubAllocator allocator(100);
+	auto a = allocator.allocate(20);
+	auto b = allocator.allocate(20);
+	auto c = allocator.allocate(20);
+	auto d = allocator.allocate(20);
+	allocator.free(a);
+	allocator.free(c);
+	EXPECT_EQ(allocator.allocate(30), BufferSubAllocator::INVALID_ALLOCATION);
+
+	auto moves = allocator.defragment();
+
+	ASSERT_EQ(moves.size(), 2u);
+	EXPECT_EQ(moves[0].sourceOffset, 20u);
+	EXPECT_EQ(moves[0].destinationOffset, 0u);
+	EXPECT_EQ(moves[1].sourceOffset, 60u);
+	EXPECT_EQ(moves[1].destinationOffset, 20u);
+	EXPECT_EQ(allocator.getOffset(b), 0u);
+	EXPECT_EQ(allocator.getOffset(d), 20u);
+	EXPECT_EQ(allocator.getFreeRangeCount(), 1u);
+	EXPECT_NE(allocator.allocate(60), BufferSubAllocator::INVALID_ALLOCATION);
+}
+
+TEST(BufferSubAllocator, TrailingFreeRangeIsExtended_When_Grown)
+{
+	BufferSubAllocator allocator(50);
+	allocator.allocate(40);
+
+	allocator.grow(100);
+
+	EXPECT_EQ(allocator.getCapacity(), 100u);
+	EXPECT_EQ(allocator.getFreeRangeCount(), 1u);
+	EXPECT_EQ(allocator.getLargestFreeRange(), 60u);
+}
+
+TEST(BufferSubAllocator, FreeIsIgnored_When_AllocationIsUnknown)
+{
+	BufferSubAllocator allocator(50);
+	auto a = allocator.allocate(10);
+	allocator.free(a);
+
+	allocator.free(a);
+	allocator.free(BufferSubAllocator::INVALID_ALLOCATION);
+
+	EXPECT_EQ(allocator.getUsedSize(), 0u);
+	EXPECT_EQ(allocator.getFreeRangeCount(), 1u);
+	EXPECT_FALSE(allocator.isAllocated(a));
+}
@@ -0,0 +1,139 @@
+#include "EngineTestPch.h"
+#include "Rendering\CookedMesh.h"
+
+using namespace DerydocaEngine::Rendering;
+
+static PackedMeshData createTestMesh(std::vector<uint8_t>& vertexData, std::vector<unsigned int>& indices)
+{
+	vertexData = std::vector<uint8_t>(3 * 12);
+	for (size_t i = 0; i < vertexData.size(); i++)
+	{
+		vertexData[i] = static_cast<uint8_t>(i);
+	}
+	indices = { 0, 1, 2 };
+
+	PackedMeshData mesh;
+	mesh.layout = VertexLayout::uncompressed();
+	mesh.layout.texCoords = TexCoordEncoding::Unorm16;
+	mesh.attributes.push_back({ 0, 3, VertexAttributeType::Float, false, false, 0 });
+	mesh.stride = 12;
+	mesh.uncompressedStride = 12;
+	mesh.vertexData = vertexData.data();
+	mesh.vertexCount = 3;
+	mesh.indices = indices.data();
+	mesh.indexCount = indices.size();
+	mesh.boundsMin = glm::vec3(-1.0f, -2.0f, -3.0f);
+	mesh.boundsMax = glm::vec3(1.0f, 2.0f, 3.0f);
+	mesh.uvDensity = 0.25f;
+	mesh.flags = DerydocaEngine::Rendering::MeshFlags::load_adjacent;
+	return mesh;
+}
+
+TEST(CookedMesh, MeshIsUnchanged_When_WrittenAndRead)
+{
+	std::vector<uint8_t> vertexData;
+	std::vector<unsigned int> indices;
+	PackedMeshData mesh = createTestMesh(vertexData, indices);
+	CookedMeshSource source;
+	source.sourceHash = 1;
+	source.sourceSize = 2;
+	source.sourceWriteTime = 3;
+	source.settingsHash = 4;
+	std::vector<CookedBoneBinding> boneBindings = { { "Hips", 0 }, { "Spine", 7 } };
+
+	std::vector<uint8_t> file;
+	CookedMesh::write(file, source, mesh, boneBindings);
+
+	CookedMeshSource readSource;
+	PackedMeshData readMesh;
+	std::vector<CookedBoneBinding> readBoneBindings;
+	ASSERT_TRUE(CookedMesh::read(file.data(), file.size(), readSource, readMesh, readBoneBindings));
+
+	EXPECT_EQ(readSource.sourceHash, 1u);
+	EXPECT_EQ(readSource.sourceSize, 2u);
+	EXPECT_EQ(readSource.sourceWriteTime, 3);
+	EXPECT_EQ(readSource.settingsHash, 4u);
+	EXPECT_TRUE(readMesh.layout == mesh.layout);
+	ASSERT_EQ(readMesh.attributes.size(), 1u);
+	EXPECT_EQ(readMesh.attributes[0].components, 3);
+	EXPECT_EQ(readMesh.stride, 12u);
+	EXPECT_EQ(readMesh.vertexCount, 3u);
+	EXPECT_EQ(memcmp(readMesh.vertexData, vertexData.data(), vertexData.size()), 0);
+	ASSERT_EQ(readMesh.indexCount, 3u);
+	EXPECT_EQ(readMesh.indices[2], 2u);
+	EXPECT_EQ(readMesh.boundsMax, mesh.boundsMax);
+	EXPECT_EQ(readMesh.uvDensity, mesh.uvDensity);
+	EXPECT_EQ(readMesh.flags, DerydocaEngine::Rendering::MeshFlags::load_adjacent);
+	ASSERT_EQ(readBoneBindings.size(), 2u);
+	EXPECT_EQ(readBoneBindings[1].name, "Spine");
+	EXPECT_EQ(readBoneBindings[1].boneId, 7u);
+}
+
+TEST(CookedMesh, StreamsPointIntoFile_When_Read)
+{
+	std::vector<uint8_t> vertexData;
+	std::vector<unsigned int> indices;
+	PackedMeshData mesh = createTestMesh(vertexData, indices);
+	std::vector<uint8_t> file;
+	CookedMesh::write(file, CookedMeshSource(), mesh, {});
+
+	CookedMeshSource readSource;
+	PackedMeshData readMesh;
+	std::vector<CookedBoneBinding> readBoneBindings;
+	ASSERT_TRUE(CookedMesh::read(file.data(), file.size(), readSource, readMesh, readBoneBindings));
+
+	EXPECT_GE(readMesh.vertexData, file.data());
+	EXPECT_LT(readMesh.vertexData, file.data() + file.size());
+	EXPECT_EQ((readMesh.vertexData - file.data()) % 16, 0);
+	EXPECT_EQ((reinterpret_cast<const uint8_t*>(readMesh.indices) - file.data()) % 4, 0);
+}
+
+TEST(CookedMesh, ReadFails_When_FileIsTruncated)
+{
+	std::vector<uint8_t> vertexData;
+	std::vector<unsigned int> indices;
+	PackedMeshData mesh = createTestMesh(vertexData, indices);
+	std::vector<uint8_t> file;
+	CookedMesh::write(file, CookedMeshSource(), mesh, {});
+
+	CookedMeshSource readSource;
+	PackedMeshData readMesh;
+	std::vector<CookedBoneBinding> readBoneBindings;
+	EXPECT_FALSE(CookedMesh::read(file.data(), file.size() - 4, readSource, readMesh, readBoneBindings));
+	EXPECT_FALSE(CookedMesh::read(file.data(), 8, readSource, readMesh, readBoneBindings));
+}
+
+TEST(CookedMesh, ReadFails_When_MagicDoesNotMatch)
+{
+	std::vector<uint8_t> vertexData;
+	std::vector<unsigned int> indices;
+	PackedMeshData mesh = createTestMesh(vertexData, indices);
+	std::vector<uint8_t> file;
+	CookedMesh::write(file, CookedMeshSource(), mesh, {});
+	file[0] = 'X';
+
+	CookedMeshSource readSource;
+	PackedMeshData readMesh;
+	std::vector<CookedBoneBinding> readBoneBindings;
+	EXPECT_FALSE(CookedMesh::read(file.data(), file.size(), readSource, readMesh, readBoneBindings));
+}
+
+TEST(CookedMesh, SourceIsReplaced_When_Updated)
+{
+	std::vector<uint8_t> vertexData;
+	std::vector<unsigned int> indices;
+	PackedMeshData mesh = createTestMesh(vertexData, indices);
+	std::vector<uint8_t> file;
+	CookedMesh::write(file, CookedMeshSource(), mesh, {});
+
+	CookedMeshSource source;
+	source.sourceWriteTime = 42;
+	CookedMesh::updateSource(file, source);
+
+	CookedMeshSource readSource;
+	PackedMeshData readMesh;
+	std::vector<CookedBoneBinding> readBoneBindings;
+	ASSERT_TRUE(CookedMesh::read(file.data(), file.size(), readSource, readMesh, readBoneBindings));
+	EXPECT_EQ(readSource.sourceWriteTime, 42);
+	EXPECT_EQ(memcmp(readMesh.vertexData, vertexData.data(), vertexData.size()), 0);
+}
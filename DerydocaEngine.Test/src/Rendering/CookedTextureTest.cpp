@@ -0,0 +1,168 @@
+#include "EngineTestPch.h"
+#include "Rendering\CookedTexture.h"
+
+using namespace DerydocaEngine::Rendering;
+
+static CompressedTextureData createTestTexture(std::vector<std::vector<uint8_t>>& levelData)
+{
+	// 8x4 with levels of 4x2, 2x1 and 1x1, each a single row of blocks
+	CompressedTextureData texture;
+	texture.format = TextureCompressionFormat::BC7;
+	levelData = { std::vector<uint8_t>(32), std::vector<uint8_t>(16), std::vector<uint8_t>(16), std::vector<uint8_t>(16) };
+	int width = 8;
+	int height = 4;
+	for (size_t i = 0; i < levelData.size(); i++)
+	{
+		for (size_t j = 0; j < levelData[i].size(); j++)
+		{
+			levelData[i][j] = static_cast<uint8_t>(i * 16 + j);
+		}
+
+		CompressedTextureLevel level;
+		level.width = width;
+		level.height = height;
+		level.data = levelData[i].data();
+		level.size = levelData[i].size();
+		texture.levels.push_back(level);
+		width = std::max(width / 2, 1);
+		height = std::max(height / 2, 1);
+	}
+	return texture;
+}
+
+TEST(CookedTexture, TextureIsUnchanged_When_WrittenAndRead)
+{
+	std::vector<std::vector<uint8_t>> levelData;
+	CompressedTextureData texture = createTestTexture(levelData);
+	CookedTextureSource source;
+	source.sourceHash = 1;
+	source.sourceSize = 2;
+	source.sourceWriteTime = 3;
+	source.settingsHash = 4;
+
+	std::vector<uint8_t> file;
+	CookedTexture::write(file, source, texture);
+
+	CookedTextureSource readSource;
+	CompressedTextureData readTexture;
+	ASSERT_TRUE(CookedTexture::read(file.data(), file.size(), readSource, readTexture));
+
+	EXPECT_EQ(readSource.sourceHash, 1u);
+	EXPECT_EQ(readSource.sourceSize, 2u);
+	EXPECT_EQ(readSource.sourceWriteTime, 3);
+	EXPECT_EQ(readSource.settingsHash, 4u);
+	EXPECT_EQ(readTexture.format, TextureCompressionFormat::BC7);
+	ASSERT_EQ(readTexture.levels.size(), 4u);
+	for (size_t i = 0; i < readTexture.levels.size(); i++)
+	{
+		EXPECT_EQ(readTexture.levels[i].width, texture.levels[i].width);
+		EXPECT_EQ(readTexture.levels[i].height, texture.levels[i].height);
+		ASSERT_EQ(readTexture.levels[i].size, levelData[i].size());
+		EXPECT_EQ(memcmp(readTexture.levels[i].data, levelData[i].data(), levelData[i].size()), 0);
+	}
+}
+
+TEST(CookedTexture, FileIsAValidDds_When_Written)
+{
+	std::vector<std::vector<uint8_t>> levelData;
+	CompressedTextureData texture = createTestTexture(levelData);
+
+	std::vector<uint8_t> file;
+	CookedTexture::write(file, CookedTextureSource(), texture);
+
+	uint32_t headerSize;
+	uint32_t mipMapCount;
+	char fourCC[4];
+	uint32_t dxgiFormat;
+	memcpy(&headerSize, file.data() + 4, 4);
+	memcpy(&mipMapCount, file.data() + 28, 4);
+	memcpy(fourCC, file.data() + 84, 4);
+	memcpy(&dxgiFormat, file.data() + 128, 4);
+	EXPECT_EQ(memcmp(file.data(), "DDS ", 4), 0);
+	EXPECT_EQ(headerSize, 124u);
+	EXPECT_EQ(mipMapCount, 4u);
+	EXPECT_EQ(memcmp(fourCC, "DX10", 4), 0);
+	EXPECT_EQ(dxgiFormat, 98u);
+	EXPECT_EQ(file.size(), 148u + 32u + 16u * 3u);
+}
+
+TEST(CookedTexture, ReadFails_When_FileIsTruncated)
+{
+	std::vector<std::vector<uint8_t>> levelData;
+	CompressedTextureData texture = createTestTexture(levelData);
+	std::vector<uint8_t> file;
+	CookedTexture::write(file, CookedTextureSource(), texture);
+
+	CookedTextureSource readSource;
+	CompressedTextureData readTexture;
+	EXPECT_FALSE(CookedTexture::read(file.data(), file.size() - 1, readSource, readTexture));
+	EXPECT_FALSE(CookedTexture::read(file.data(), 100, readSource, readTexture));
+}
+
+TEST(CookedTexture, SourceIsReplaced_When_Updated)
+{
+	std::vector<std::vector<uint8_t>> levelData;
+	CompressedTextureData texture = createTestTexture(levelData);
+	std::vector<uint8_t> file;
+	CookedTexture::write(file, CookedTextureSource(), texture);
+
+	CookedTextureSource source;
+	source.sourceWriteTime = 42;
+	CookedTexture::updateSource(file, source);
+
+	CookedTextureSource readSource;
+	CompressedTextureData readTexture;
+	ASSERT_TRUE(CookedTexture::read(file.data(), file.size(), readSource, readTexture));
+	EXPECT_EQ(readSource.sourceWriteTime, 42);
+	EXPECT_EQ(memcmp(readTexture.levels[0].data, levelData[0].data(), levelData[0].size()), 0);
+}
+
+TEST(CookedTexture, FacesAreUnchanged_When_CubemapIsWrittenAndRead)
+{
+	// 4x4 faces with levels of 2x2 and 1x1, each level a single block
+	CompressedTextureData texture;
+	texture.format = TextureCompressionFormat::BC1;
+	texture.faceCount = 6;
+	std::vector<std::vector<uint8_t>> levelData;
+	for (int face = 0; face < 6; face++)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			levelData.push_back(std::vector<uint8_t>(8, static_cast<uint8_t>(face * 3 + i)));
+		}
+	}
+	for (size_t i = 0; i < levelData.size(); i++)
+	{
+		CompressedTextureLevel level;
+		level.width = 4 >> (i % 3);
+		level.height = 4 >> (i % 3);
+		level.data = levelData[i].data();
+		level.size = levelData[i].size();
+		texture.levels.push_back(level);
+	}
+
+	std::vector<uint8_t> file;
+	CookedTexture::write(file, CookedTextureSource(), texture);
+
+	uint32_t mipMapCount;
+	uint32_t caps2;
+	uint32_t miscFlag;
+	memcpy(&mipMapCount, file.data() + 28, 4);
+	memcpy(&caps2, file.data() + 112, 4);
+	memcpy(&miscFlag, file.data() + 136, 4);
+	EXPECT_EQ(mipMapCount, 3u);
+	EXPECT_EQ(caps2, 0xFE00u);
+	EXPECT_EQ(miscFlag, 4u);
+	EXPECT_EQ(file.size(), 148u + 6u * 3u * 8u);
+
+	CookedTextureSource readSource;
+	CompressedTextureData readTexture;
+	ASSERT_TRUE(CookedTexture::read(file.data(), file.size(), readSource, readTexture));
+	EXPECT_EQ(readTexture.faceCount, 6);
+	ASSERT_EQ(readTexture.levels.size(), levelData.size());
+	for (size_t i = 0; i < readTexture.levels.size(); i++)
+	{
+		EXPECT_EQ(readTexture.levels[i].width, texture.levels[i].width);
+		EXPECT_EQ(memcmp(readTexture.levels[i].data, levelData[i].data(), levelData[i].size()), 0);
+	}
+}
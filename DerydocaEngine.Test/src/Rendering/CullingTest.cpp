@@ -0,0 +1,14 @@
+#include "EngineTestPch.h"
+#include "Rendering\Culling.h"
+
+using namespace DerydocaEngine::Rendering;
+
+TEST(Culling, BoxIsRejected_When_OutsideOfClipVolume)
+{
+	glm::mat4 projection = glm::ortho(-1.0f, 1.0f, -1.0f, 1.0f, 0.1f, 10.0f);
+
+	EXPECT_TRUE(Culling::isBoxInsideClipVolume(projection, glm::vec3(-0.5f, -0.5f, -2.0f), glm::vec3(0.5f, 0.5f, -1.0f)));
+	EXPECT_TRUE(Culling::isBoxInsideClipVolume(projection, glm::vec3(-5.0f, -5.0f, -2.0f), glm::vec3(5.0f, 5.0f, -1.0f)));
+	EXPECT_FALSE(Culling::isBoxInsideClipVolume(projection, glm::vec3(2.0f, -0.5f, -2.0f), glm::vec3(3.0f, 0.5f, -1.0f)));
+	EXPECT_FALSE(Culling::isBoxInsideClipVolume(projection, glm::vec3(-0.5f, -0.5f, 1.0f), glm::vec3(0.5f, 0.5f, 2.0f)));
+}
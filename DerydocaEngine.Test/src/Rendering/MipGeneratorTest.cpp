@@ -0,0 +1,204 @@
+#include "EngineTestPch.h"
+#include "Rendering\MipGenerator.h"
+
+#include <cmath>
+
+using namespace DerydocaEngine::Rendering;
+
+static MipSettings createSettings(MipFilter const& filter, bool const& srgb)
+{
+	MipSettings settings;
+	settings.filter = filter;
+	settings.srgb = srgb;
+	return settings;
+}
+
+// Leaf shaped cutout, with alpha fading out towards the edge of a disc and a ragged border
+static std::vector<uint8_t> createCutoutImage(int const& size)
+{
+	std::vector<uint8_t> rgba(static_cast<size_t>(size) * size * 4);
+	for (int y = 0; y < size; y++)
+	{
+		for (int x = 0; x < size; x++)
+		{
+			float dx = (x + 0.5f) / size - 0.5f;
+			float dy = (y + 0.5f) / size - 0.5f;
+			float distance = std::sqrt(dx * dx + dy * dy) * 2.0f;
+			float alpha = std::max(1.0f - distance, 0.0f) * (((x / 2 + y / 3) % 3) == 0 ? 0.6f : 1.0f);
+
+			uint8_t* pixel = rgba.data() + (static_cast<size_t>(y) * size + x) * 4;
+			pixel[0] = 40;
+			pixel[1] = 160;
+			pixel[2] = 30;
+			pixel[3] = static_cast<uint8_t>(alpha * 255.0f);
+		}
+	}
+	return rgba;
+}
+
+TEST(MipGenerator, ChainEndsAtOnePixel)
+{
+	std::vector<uint8_t> pixels(300 * 20, 7);
+	std::vector<MipLevel> levels;
+	MipGenerator::generate(pixels.data(), 300, 20, 1, MipSettings(), levels);
+
+	ASSERT_EQ(levels.size(), 9u);
+	EXPECT_EQ(levels[0].data, pixels);
+	EXPECT_EQ(levels[1].width, 150);
+	EXPECT_EQ(levels[1].height, 10);
+	EXPECT_EQ(levels[8].width, 1);
+	EXPECT_EQ(levels[8].height, 1);
+	for (auto const& level : levels)
+	{
+		EXPECT_EQ(level.data.size(), static_cast<size_t>(level.width) * level.height);
+	}
+}
+
+TEST(MipGenerator, BoxAveragesSquares_When_ImageIsLinear)
+{
+	std::vector<uint8_t> pixels = {
+		0, 10, 100, 0,
+		20, 30, 200, 4
+	};
+	std::vector<MipLevel> levels;
+	MipGenerator::generate(pixels.data(), 4, 2, 1, createSettings(MipFilter::Box, false), levels);
+
+	ASSERT_EQ(levels.size(), 3u);
+	ASSERT_EQ(levels[1].data.size(), 2u);
+	EXPECT_EQ(levels[1].data[0], 15);
+	EXPECT_EQ(levels[1].data[1], 76);
+	EXPECT_EQ(levels[2].data[0], 46);
+}
+
+TEST(MipGenerator, ColorsAreAveragedAsLinearLight_When_ImageIsSrgb)
+{
+	// Half black and half white is half as bright, which sRGB encodes as 188 rather than 128
+	std::vector<uint8_t> pixels = {
+		0, 0, 0, 0, 255, 255, 255, 255,
+		255, 255, 255, 255, 0, 0, 0, 0
+	};
+	std::vector<MipLevel> levels;
+	MipGenerator::generate(pixels.data(), 2, 2, 4, createSettings(MipFilter::Box, true), levels);
+
+	ASSERT_EQ(levels.size(), 2u);
+	EXPECT_EQ(levels[1].data[0], 188);
+	EXPECT_EQ(levels[1].data[1], 188);
+	EXPECT_EQ(levels[1].data[2], 188);
+	EXPECT_EQ(levels[1].data[3], 128);
+
+	MipGenerator::generate(pixels.data(), 2, 2, 4, createSettings(MipFilter::Box, false), levels);
+	EXPECT_EQ(levels[1].data[0], 128);
+}
+
+TEST(MipGenerator, ConstantImageIsUnchanged_When_FilteredWithKaiser)
+{
+	std::vector<uint8_t> pixels(37 * 23 * 3);
+	for (size_t i = 0; i < pixels.size(); i += 3)
+	{
+		pixels[i] = 200;
+		pixels[i + 1] = 16;
+		pixels[i + 2] = 98;
+	}
+
+	std::vector<MipLevel> levels;
+	MipGenerator::generate(pixels.data(), 37, 23, 3, createSettings(MipFilter::Kaiser, true), levels);
+
+	ASSERT_EQ(levels.size(), 6u);
+	for (auto const& level : levels)
+	{
+		for (size_t i = 0; i < level.data.size(); i += 3)
+		{
+			ASSERT_EQ(level.data[i], 200);
+			ASSERT_EQ(level.data[i + 1], 16);
+			ASSERT_EQ(level.data[i + 2], 98);
+		}
+	}
+}
+
+TEST(MipGenerator, CheckerboardBecomesGray_When_FilteredWithKaiser)
+{
+	std::vector<uint8_t> pixels(16 * 16);
+	for (int y = 0; y < 16; y++)
+	{
+		for (int x = 0; x < 16; x++)
+		{
+			pixels[y * 16 + x] = (x + y) % 2 == 0 ? 255 : 0;
+		}
+	}
+
+	std::vector<MipLevel> levels;
+	MipGenerator::generate(pixels.data(), 16, 16, 1, createSettings(MipFilter::Kaiser, false), levels);
+
+	// The edges repeat their last pixel, which breaks the pattern, so only the inside is checked
+	for (int y = 2; y < 6; y++)
+	{
+		for (int x = 2; x < 6; x++)
+		{
+			EXPECT_NEAR(levels[1].data[y * 8 + x], 128, 1) << x << ", " << y;
+		}
+	}
+}
+
+TEST(MipGenerator, NormalsKeepUnitLength_When_NormalMapIsFiltered)
+{
+	// Two normals tilted 45 degrees apart, whose plain average is shorter than one
+	std::vector<uint8_t> pixels = {
+		218, 128, 218, 37, 128, 218,
+		218, 128, 218, 37, 128, 218
+	};
+	MipSettings settings;
+	settings.normalMap = true;
+
+	std::vector<MipLevel> levels;
+	MipGenerator::generate(pixels.data(), 2, 2, 3, settings, levels);
+
+	ASSERT_EQ(levels.size(), 2u);
+	float x = levels[1].data[0] / 127.5f - 1.0f;
+	float y = levels[1].data[1] / 127.5f - 1.0f;
+	float z = levels[1].data[2] / 127.5f - 1.0f;
+	EXPECT_NEAR(std::sqrt(x * x + y * y + z * z), 1.0f, 0.02f);
+	EXPECT_EQ(levels[1].data[2], 255);
+}
+
+TEST(MipGenerator, AlphaCoverageIsPreserved_When_CutoffIsSet)
+{
+	const int size = 128;
+	const float cutoff = 0.5f;
+	std::vector<uint8_t> rgba = createCutoutImage(size);
+
+	MipSettings settings;
+	settings.alphaCutoff = cutoff;
+	std::vector<MipLevel> preserved;
+	MipGenerator::generate(rgba.data(), size, size, 4, settings, preserved);
+
+	std::vector<MipLevel> plain;
+	MipGenerator::generate(rgba.data(), size, size, 4, MipSettings(), plain);
+
+	float coverage = MipGenerator::calculateAlphaCoverage(preserved[0], 4, cutoff);
+	ASSERT_GT(coverage, 0.05f);
+
+	// Levels below 8x8 are too coarse to match the coverage closely
+	float largestPlainError = 0.0f;
+	for (size_t i = 1; i < preserved.size() - 3; i++)
+	{
+		EXPECT_NEAR(MipGenerator::calculateAlphaCoverage(preserved[i], 4, cutoff), coverage, 0.03f) << "Level " << i;
+		largestPlainError = std::max(largestPlainError, std::abs(MipGenerator::calculateAlphaCoverage(plain[i], 4, cutoff) - coverage));
+	}
+	EXPECT_GT(largestPlainError, 0.03f);
+
+	// Color is not touched by the alpha scale
+	EXPECT_EQ(preserved[3].data[(8 * preserved[3].width + 8) * 4 + 1], plain[3].data[(8 * plain[3].width + 8) * 4 + 1]);
+}
+
+TEST(MipGenerator, NamesAreUnchanged_When_ConvertedAndParsed)
+{
+	for (auto filter : { MipFilter::Box, MipFilter::Kaiser })
+	{
+		MipFilter parsed;
+		ASSERT_TRUE(MipGenerator::stringToFilter(MipGenerator::filterToString(filter), parsed));
+		EXPECT_EQ(parsed, filter);
+	}
+
+	MipFilter parsed;
+	EXPECT_FALSE(MipGenerator::stringToFilter("Lanczos", parsed));
+}
@@ -0,0 +1,116 @@
+#include "EngineTestPch.h"
+#include "Rendering\ShaderPreprocessor.h"
+
+using namespace DerydocaEngine::Rendering;
+
+struct ShaderPreprocessorTest : testing::Test
+{
+	std::map<std::string, std::string> files;
+	ShaderPreprocessor preprocessor;
+
+	ShaderPreprocessorTest() :
+		files(),
+		preprocessor([this](std::string const& path, std::string& contents) {
+			auto it = files.find(path);
+			if (it == files.end())
+			{
+				return false;
+			}
+			contents = it->second;
+			return true;
+		})
+	{
+	}
+};
+
+TEST_F(ShaderPreprocessorTest, KeywordsAreDefinedAfterVersion_When_KeywordsAreEnabled)
+{
+	std::string output = preprocessor.process("#version 400\nvoid main() {}\n", "shaders/a.vs", { "SHADOWS", "SKINNED" });
+
+	EXPECT_EQ(output, "#version 400\n#define SHADOWS\n#define SKINNED\n#line 2\nvoid main() {}\n");
+}
+
+TEST_F(ShaderPreprocessorTest, SourceIsUnchanged_When_ThereIsNothingToExpand)
+{
+	std::string output = preprocessor.process("void main() {}\n", "shaders/a.vs", {});
+
+	EXPECT_EQ(output, "void main() {}\n");
+}
+
+TEST_F(ShaderPreprocessorTest, IncludeIsExpanded_When_PathIsRelativeToIncludingFile)
+{
+	files["shaders/include/lighting.glsl"] = "vec4 light() { return vec4(1.0); }\n";
+
+	std::string output = preprocessor.process("#version 400\n#include \"include/lighting.glsl\"\nvoid main() {}\n", "shaders/a.vs", {});
+
+	EXPECT_EQ(output, "#version 400\n#line 2\n#line 1\nvec4 light() { return vec4(1.0); }\n#line 3\nvoid main() {}\n");
+	EXPECT_TRUE(preprocessor.getErrors().empty());
+}
+
+TEST_F(ShaderPreprocessorTest, IncludeIsExpandedOnce_When_IncludedTwice)
+{
+	files["shaders/common.glsl"] = "float x;\n";
+	files["shaders/lighting.glsl"] = "#include \"common.glsl\"\nfloat y;\n";
+
+	std::string output = preprocessor.process("#include \"common.glsl\"\n#include \"lighting.glsl\"\n", "shaders/a.vs", {});
+
+	EXPECT_EQ(output.find("float x;"), output.rfind("float x;"));
+	EXPECT_NE(output.find("float y;"), std::string::npos);
+}
+
+TEST_F(ShaderPreprocessorTest, IncludeDoesNotRecurseForever_When_FilesIncludeEachOther)
+{
+	files["shaders/a.glsl"] = "#include \"b.glsl\"\nfloat a;\n";
+	files["shaders/b.glsl"] = "#include \"a.glsl\"\nfloat b;\n";
+
+	std::string output = preprocessor.process("#include \"a.glsl\"\n", "shaders/main.vs", {});
+
+	EXPECT_NE(output.find("float a;"), std::string::npos);
+	EXPECT_NE(output.find("float b;"), std::string::npos);
+	EXPECT_TRUE(preprocessor.getErrors().empty());
+}
+
+TEST_F(ShaderPreprocessorTest, ParentDirectoryIsResolved_When_IncludePathHasDotDot)
+{
+	files["shaders/include/common.glsl"] = "float x;\n";
+
+	std::string output = preprocessor.process("#include \"..\\include\\common.glsl\"\n", "shaders\\stages\\a.vs", {});
+
+	EXPECT_NE(output.find("float x;"), std::string::npos);
+	EXPECT_TRUE(preprocessor.getErrors().empty());
+}
+
+TEST_F(ShaderPreprocessorTest, ErrorIsReported_When_IncludeIsMissing)
+{
+	preprocessor.process("#include \"missing.glsl\"\n", "shaders/a.vs", {});
+
+	EXPECT_EQ(preprocessor.getErrors().size(), 1);
+}
+
+TEST_F(ShaderPreprocessorTest, KeywordsAreDeclared_When_PragmaKeywordsIsUsed)
+{
+	files["shaders/common.glsl"] = "#pragma keywords SKINNED SHADOWS\n";
+
+	std::string output = preprocessor.process("#pragma keywords SHADOWS INSTANCED\n#include \"common.glsl\"\n", "shaders/a.vs", {});
+
+	std::vector<std::string> expected = { "SHADOWS", "INSTANCED", "SKINNED" };
+	EXPECT_EQ(preprocessor.getDeclaredKeywords(), expected);
+	EXPECT_EQ(output.find("#pragma keywords"), std::string::npos);
+}
+
+TEST_F(ShaderPreprocessorTest, PragmaIsKept_When_ItOnlyStartsWithKeywords)
+{
+	std::string output = preprocessor.process("#pragma keywordsExtra SHADOWS\n", "shaders/a.vs", {});
+
+	EXPECT_TRUE(preprocessor.getDeclaredKeywords().empty());
+	EXPECT_EQ(output, "#pragma keywordsExtra SHADOWS\n");
+}
+
+TEST_F(ShaderPreprocessorTest, FileCanBeProcessed_When_ReadThroughTheFileReader)
+{
+	files["shaders/a.vs"] = "#version 330\r\nvoid main() {}\r\n";
+
+	std::string output = preprocessor.processFile("shaders/a.vs", { "INSTANCED" });
+
+	EXPECT_EQ(output, "#version 330\n#define INSTANCED\n#line 2\nvoid main() {}\n");
+}
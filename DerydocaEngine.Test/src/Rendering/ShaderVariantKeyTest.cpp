@@ -0,0 +1,43 @@
+#include "EngineTestPch.h"
+#include "Rendering\ShaderVariantKey.h"
+
+using namespace DerydocaEngine::Rendering;
+
+TEST(ShaderVariantKey, KeyIsDefault_When_NoKeywordsAreEnabled)
+{
+	auto key = ShaderVariantKey::fromKeywords({ "SHADOWS", "SKINNED" }, {});
+
+	EXPECT_TRUE(key.isDefault());
+	EXPECT_EQ(key.getName({ "SHADOWS", "SKINNED" }), "");
+}
+
+TEST(ShaderVariantKey, KeyIsIndependentOfOrder_When_KeywordsAreEnabledInAnyOrder)
+{
+	std::vector<std::string> declared = { "SHADOWS", "SKINNED", "INSTANCED" };
+
+	auto keyA = ShaderVariantKey::fromKeywords(declared, { "INSTANCED", "SHADOWS" });
+	auto keyB = ShaderVariantKey::fromKeywords(declared, { "SHADOWS", "INSTANCED" });
+
+	EXPECT_EQ(keyA, keyB);
+	EXPECT_EQ(keyA.getMask(), 0x5u);
+}
+
+TEST(ShaderVariantKey, UndeclaredKeywordsAreIgnored_When_BuildingKey)
+{
+	std::vector<std::string> declared = { "SHADOWS" };
+
+	auto key = ShaderVariantKey::fromKeywords(declared, { "SHADOWS", "SKINNED" });
+
+	EXPECT_EQ(key, ShaderVariantKey::fromKeywords(declared, { "SHADOWS" }));
+}
+
+TEST(ShaderVariantKey, KeywordsRoundTrip_When_ConvertedBackFromKey)
+{
+	std::vector<std::string> declared = { "SHADOWS", "SKINNED", "INSTANCED" };
+
+	auto key = ShaderVariantKey::fromKeywords(declared, { "INSTANCED", "SKINNED" });
+
+	std::vector<std::string> expected = { "SKINNED", "INSTANCED" };
+	EXPECT_EQ(key.getKeywords(declared), expected);
+	EXPECT_EQ(key.getName(declared), "SKINNED|INSTANCED");
+}
@@ -0,0 +1,71 @@
+#include "EngineTestPch.h"
+#include "Rendering\ShadowCascades.h"
+
+using namespace DerydocaEngine::Rendering;
+
+TEST(ShadowCascades, SplitsAreEvenlySpaced_When_SchemeIsUniform)
+{
+	auto splits = ShadowCascades::calculateSplitDepths(0.0f, 100.0f, 4, ShadowCascades::Uniform, 0.0f);
+
+	ASSERT_EQ(splits.size(), 4);
+	EXPECT_FLOAT_EQ(splits[0], 25.0f);
+	EXPECT_FLOAT_EQ(splits[1], 50.0f);
+	EXPECT_FLOAT_EQ(splits[2], 75.0f);
+	EXPECT_FLOAT_EQ(splits[3], 100.0f);
+}
+
+TEST(ShadowCascades, SplitsGrowGeometrically_When_SchemeIsLogarithmic)
+{
+	auto splits = ShadowCascades::calculateSplitDepths(1.0f, 1000.0f, 3, ShadowCascades::Logarithmic, 0.0f);
+
+	ASSERT_EQ(splits.size(), 3);
+	EXPECT_NEAR(splits[0], 10.0f, 0.001f);
+	EXPECT_NEAR(splits[1], 100.0f, 0.01f);
+	EXPECT_FLOAT_EQ(splits[2], 1000.0f);
+}
+
+TEST(ShadowCascades, SplitsAreClampedToMaxCascades_When_TooManyCascadesAreRequested)
+{
+	auto splits = ShadowCascades::calculateSplitDepths(0.1f, 50.0f, 16, ShadowCascades::Practical, 0.5f);
+
+	EXPECT_EQ(splits.size(), ShadowCascades::MAX_CASCADES);
+	EXPECT_FLOAT_EQ(splits.back(), 50.0f);
+}
+
+TEST(ShadowCascades, CascadeDoesNotMove_When_CameraMovesLessThanATexel)
+{
+	glm::mat4 lightView = glm::lookAt(glm::vec3(0.0f, 10.0f, 0.0f), glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f));
+	glm::mat4 cameraA = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	glm::mat4 cameraB = glm::translate(glm::mat4(1.0f), glm::vec3(0.0001f, 1.0f, 0.0f));
+
+	auto cascadeA = ShadowCascades::fitCascade(lightView, ShadowCascades::calculateFrustumSliceCorners(cameraA, 60.0f, 1.0f, 0.1f, 10.0f), 1024, 0.0f);
+	auto cascadeB = ShadowCascades::fitCascade(lightView, ShadowCascades::calculateFrustumSliceCorners(cameraB, 60.0f, 1.0f, 0.1f, 10.0f), 1024, 0.0f);
+
+	EXPECT_EQ(cascadeA.bounds, cascadeB.bounds);
+}
+
+TEST(ShadowCascades, CascadeCoversSlice_When_Fitted)
+{
+	glm::mat4 lightView = glm::lookAt(glm::vec3(0.0f, 10.0f, 0.0f), glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f));
+	auto corners = ShadowCascades::calculateFrustumSliceCorners(glm::mat4(1.0f), 60.0f, 1.5f, 1.0f, 20.0f);
+
+	auto cascade = ShadowCascades::fitCascade(lightView, corners, 512, 5.0f);
+	glm::mat4 viewProjection = glm::ortho(cascade.bounds.x, cascade.bounds.y, cascade.bounds.z, cascade.bounds.w, cascade.zNear, cascade.zFar) * lightView;
+
+	for (auto const& corner : corners)
+	{
+		glm::vec4 clip = viewProjection * glm::vec4(corner, 1.0f);
+		EXPECT_LE(glm::abs(clip.x), clip.w);
+		EXPECT_LE(glm::abs(clip.y), clip.w);
+		EXPECT_LE(glm::abs(clip.z), clip.w);
+	}
+}
+
+TEST(ShadowCascades, TilesDoNotOverlap_When_AtlasHasFourCascades)
+{
+	auto tile0 = ShadowCascades::getAtlasViewport(0, 4, 2048, 2048);
+	auto tile3 = ShadowCascades::getAtlasViewport(3, 4, 2048, 2048);
+
+	EXPECT_EQ(tile0, glm::ivec4(0, 0, 1024, 1024));
+	EXPECT_EQ(tile3, glm::ivec4(1024, 1024, 1024, 1024));
+}
@@ -0,0 +1,181 @@
+#include "EngineTestPch.h"
+#include "Rendering\TextureCompression.h"
+
+using namespace DerydocaEngine::Rendering;
+
+static const TextureCompressionFormat ALL_FORMATS[] = {
+	TextureCompressionFormat::BC1,
+	TextureCompressionFormat::BC3,
+	TextureCompressionFormat::BC4,
+	TextureCompressionFormat::BC5,
+	TextureCompressionFormat::BC7
+};
+
+// Smooth gradients in every channel with some noise on top, which is roughly what photos look like
+static std::vector<uint8_t> createTestImage(int const& width, int const& height)
+{
+	std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+	uint32_t noise = 12345;
+	for (int y = 0; y < height; y++)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			noise = noise * 1103515245 + 12345;
+			int offset = static_cast<int>((noise >> 16) % 9) - 4;
+			uint8_t* pixel = rgba.data() + (static_cast<size_t>(y) * width + x) * 4;
+			pixel[0] = static_cast<uint8_t>(std::min(std::max(x * 255 / (width - 1) + offset, 0), 255));
+			pixel[1] = static_cast<uint8_t>(std::min(std::max(y * 255 / (height - 1) + offset, 0), 255));
+			pixel[2] = static_cast<uint8_t>(std::min(std::max((x + y) * 255 / (width + height - 2) + offset, 0), 255));
+			pixel[3] = static_cast<uint8_t>(255 - y * 255 / (height - 1));
+		}
+	}
+	return rgba;
+}
+
+static double compressAndMeasure(std::vector<uint8_t> const& rgba, int const& width, int const& height, TextureCompressionFormat const& format, TextureCompressionQuality const& quality)
+{
+	std::vector<uint8_t> blocks;
+	TextureCompression::compress(rgba.data(), width, height, format, quality, blocks);
+	EXPECT_EQ(blocks.size(), TextureCompression::getLevelSize(format, width, height));
+
+	std::vector<uint8_t> decompressed;
+	TextureCompression::decompress(blocks.data(), width, height, format, decompressed);
+	return TextureCompression::calculatePsnr(rgba.data(), decompressed.data(), width, height, format);
+}
+
+TEST(TextureCompression, BlockIsExact_When_EveryPixelIsTheSameColor)
+{
+	std::vector<uint8_t> rgba(4 * 4 * 4);
+	for (size_t i = 0; i < rgba.size(); i += 4)
+	{
+		rgba[i] = 200;
+		rgba[i + 1] = 16;
+		rgba[i + 2] = 98;
+		rgba[i + 3] = 128;
+	}
+
+	// BC1 and BC3 round colors to 5:6:5. BC7 shares the lowest bit of every channel, so the
+	// channels are all even here.
+	for (auto format : { TextureCompressionFormat::BC4, TextureCompressionFormat::BC5, TextureCompressionFormat::BC7 })
+	{
+		EXPECT_TRUE(std::isinf(compressAndMeasure(rgba, 4, 4, format, TextureCompressionQuality::Normal))) << TextureCompression::formatToString(format);
+	}
+}
+
+TEST(TextureCompression, PsnrIsAboveThreshold_When_GradientIsCompressed)
+{
+	std::vector<uint8_t> rgba = createTestImage(64, 48);
+
+	EXPECT_GT(compressAndMeasure(rgba, 64, 48, TextureCompressionFormat::BC1, TextureCompressionQuality::Normal), 32.0);
+	EXPECT_GT(compressAndMeasure(rgba, 64, 48, TextureCompressionFormat::BC3, TextureCompressionQuality::Normal), 34.0);
+	EXPECT_GT(compressAndMeasure(rgba, 64, 48, TextureCompressionFormat::BC4, TextureCompressionQuality::Normal), 38.0);
+	EXPECT_GT(compressAndMeasure(rgba, 64, 48, TextureCompressionFormat::BC5, TextureCompressionQuality::Normal), 38.0);
+	EXPECT_GT(compressAndMeasure(rgba, 64, 48, TextureCompressionFormat::BC7, TextureCompressionQuality::Normal), 38.0);
+}
+
+TEST(TextureCompression, PsnrDoesNotDrop_When_QualityIsRaised)
+{
+	std::vector<uint8_t> rgba = createTestImage(64, 64);
+
+	for (auto format : ALL_FORMATS)
+	{
+		double fast = compressAndMeasure(rgba, 64, 64, format, TextureCompressionQuality::Fast);
+		double normal = compressAndMeasure(rgba, 64, 64, format, TextureCompressionQuality::Normal);
+		double high = compressAndMeasure(rgba, 64, 64, format, TextureCompressionQuality::High);
+		EXPECT_GE(normal, fast - 0.1) << TextureCompression::formatToString(format);
+		EXPECT_GE(high, normal) << TextureCompression::formatToString(format);
+	}
+}
+
+TEST(TextureCompression, EdgesAreRepeated_When_SizeIsNotAMultipleOfFour)
+{
+	// Any pixel read from outside the image would show up as a large error in a single color image
+	std::vector<uint8_t> rgba(13 * 7 * 4, 136);
+
+	for (auto format : ALL_FORMATS)
+	{
+		EXPECT_EQ(TextureCompression::getLevelSize(format, 13, 7), 4u * 2u * TextureCompression::getBlockSize(format));
+		EXPECT_GT(compressAndMeasure(rgba, 13, 7, format, TextureCompressionQuality::Normal), 30.0) << TextureCompression::formatToString(format);
+	}
+}
+
+TEST(TextureCompression, MipChainEndsAtOnePixel)
+{
+	EXPECT_EQ(TextureCompression::getLevelCount(1, 1), 1);
+	EXPECT_EQ(TextureCompression::getLevelCount(256, 256), 9);
+	EXPECT_EQ(TextureCompression::getLevelCount(300, 20), 9);
+}
+
+TEST(TextureCompression, LevelsAreUnchanged_When_CompressedTogether)
+{
+	std::vector<uint8_t> rgba = createTestImage(64, 32);
+	std::vector<MipLevel> levels;
+	MipGenerator::generate(rgba.data(), 64, 32, 4, MipSettings(), levels);
+
+	std::vector<std::vector<uint8_t>> compressedLevels;
+	TextureCompression::compressLevels(levels, TextureCompressionFormat::BC7, TextureCompressionQuality::Normal, compressedLevels);
+
+	ASSERT_EQ(compressedLevels.size(), levels.size());
+	for (size_t i = 0; i < levels.size(); i++)
+	{
+		std::vector<uint8_t> blocks;
+		TextureCompression::compress(levels[i].data.data(), levels[i].width, levels[i].height, TextureCompressionFormat::BC7, TextureCompressionQuality::Normal, blocks);
+		EXPECT_EQ(compressedLevels[i], blocks) << "Level " << i;
+	}
+}
+
+TEST(TextureCompression, MissingChannelsAreZero_When_ImageIsExpanded)
+{
+	unsigned char pixels[] = { 10, 20, 30, 40 };
+	std::vector<uint8_t> rgba;
+	TextureCompression::expandToRgba(pixels, 2, 1, 2, rgba);
+
+	std::vector<uint8_t> expected = { 10, 20, 0, 255, 30, 40, 0, 255 };
+	EXPECT_EQ(rgba, expected);
+}
+
+TEST(TextureCompression, NamesAreUnchanged_When_ConvertedAndParsed)
+{
+	for (auto format : ALL_FORMATS)
+	{
+		TextureCompressionFormat parsed;
+		ASSERT_TRUE(TextureCompression::stringToFormat(TextureCompression::formatToString(format), parsed));
+		EXPECT_EQ(parsed, format);
+	}
+
+	TextureCompressionQuality quality;
+	EXPECT_TRUE(TextureCompression::stringToQuality("High", quality));
+	EXPECT_EQ(quality, TextureCompressionQuality::High);
+	EXPECT_FALSE(TextureCompression::stringToQuality("Best", quality));
+
+	TextureCompressionFormat format;
+	EXPECT_FALSE(TextureCompression::stringToFormat("DXT1", format));
+}
+
+TEST(TextureCompression, DISABLED_Benchmark_CompressQualityPresets)
+{
+	int size = 1024;
+	std::vector<uint8_t> rgba = createTestImage(size, size);
+
+	for (auto format : ALL_FORMATS)
+	{
+		for (auto quality : { TextureCompressionQuality::Fast, TextureCompressionQuality::Normal, TextureCompressionQuality::High })
+		{
+			auto startTime = std::chrono::high_resolution_clock::now();
+			std::vector<uint8_t> blocks;
+			TextureCompression::compress(rgba.data(), size, size, format, quality, blocks);
+			std::chrono::duration<double, std::milli> compressTime = std::chrono::high_resolution_clock::now() - startTime;
+
+			std::vector<uint8_t> decompressed;
+			TextureCompression::decompress(blocks.data(), size, size, format, decompressed);
+			double psnr = TextureCompression::calculatePsnr(rgba.data(), decompressed.data(), size, size, format);
+
+			printf("%s (%s): %.2fms, %.1f megapixels per second, PSNR %.2f dB\n",
+				TextureCompression::formatToString(format).c_str(),
+				TextureCompression::qualityToString(quality).c_str(),
+				compressTime.count(),
+				size * size / 1000.0 / compressTime.count(),
+				psnr);
+		}
+	}
+}
@@ -0,0 +1,54 @@
+#include "EngineTestPch.h"
+#include "Rendering\TextureImage.h"
+#include "vendor\stb_image_write.h"
+
+using namespace DerydocaEngine::Rendering;
+
+static std::string writeTestImage()
+{
+	// Two pixels wide and three rows tall, each row has its own shade
+	unsigned char pixels[] = {
+		10, 10,
+		20, 20,
+		30, 30
+	};
+	std::string fileName = (boost::filesystem::temp_directory_path() / "TextureImageTest.png").string();
+	stbi_write_png(fileName.c_str(), 2, 3, 1, pixels, 2);
+	return fileName;
+}
+
+TEST(TextureImage, RowsAreInFileOrder_When_NotFlipped)
+{
+	std::string fileName = writeTestImage();
+
+	TextureImage image;
+	ASSERT_TRUE(image.load(fileName, false));
+
+	EXPECT_EQ(image.getWidth(), 2);
+	EXPECT_EQ(image.getHeight(), 3);
+	EXPECT_EQ(image.getChannels(), 1);
+	EXPECT_EQ(image.getData()[0], 10);
+	EXPECT_EQ(image.getData()[2], 20);
+	EXPECT_EQ(image.getData()[4], 30);
+}
+
+TEST(TextureImage, RowsAreReversed_When_Flipped)
+{
+	std::string fileName = writeTestImage();
+
+	TextureImage image;
+	ASSERT_TRUE(image.load(fileName, true));
+
+	EXPECT_EQ(image.getData()[0], 30);
+	EXPECT_EQ(image.getData()[1], 30);
+	EXPECT_EQ(image.getData()[2], 20);
+	EXPECT_EQ(image.getData()[4], 10);
+}
+
+TEST(TextureImage, LoadFails_When_FileDoesNotExist)
+{
+	TextureImage image;
+	EXPECT_FALSE(image.load("TextureImageTest_missing.png", true));
+	EXPECT_FALSE(image.isLoaded());
+	EXPECT_EQ(image.getWidth(), 0);
+}
@@ -0,0 +1,36 @@
+#include "EngineTestPch.h"
+#include "Rendering\TextureStreaming.h"
+
+using namespace DerydocaEngine::Rendering;
+
+TEST(TextureStreaming, DensityIsUvSpanPerUnit_When_QuadIsMapped)
+{
+	// A 2x2 quad showing the whole texture spans half a UV per unit
+	std::vector<glm::vec3> positions = { { 0, 0, 0 }, { 2, 0, 0 }, { 2, 2, 0 }, { 0, 2, 0 } };
+	std::vector<glm::vec2> texCoords = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+	std::vector<unsigned int> indices = { 0, 1, 2, 0, 2, 3 };
+	EXPECT_FLOAT_EQ(TextureStreaming::calculateUvDensity(positions, texCoords, indices, 3), 0.5f);
+
+	// Adjacency indices keep the corners at every other index
+	std::vector<unsigned int> adjacentIndices = { 0, 3, 1, 3, 2, 3, 0, 1, 2, 1, 3, 1 };
+	EXPECT_FLOAT_EQ(TextureStreaming::calculateUvDensity(positions, texCoords, adjacentIndices, 6), 0.5f);
+}
+
+TEST(TextureStreaming, DensityIsZero_When_MeshHasNoUvs)
+{
+	std::vector<glm::vec3> positions = { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 } };
+	std::vector<unsigned int> indices = { 0, 1, 2 };
+	EXPECT_EQ(TextureStreaming::calculateUvDensity(positions, std::vector<glm::vec2>(), indices, 3), 0.0f);
+}
+
+TEST(TextureStreaming, LevelHalvesTexels_When_PixelsPerTexelHalve)
+{
+	EXPECT_EQ(TextureStreaming::calculateRequiredLevel(1024.0f, 1024.0f, 11), 0);
+	EXPECT_EQ(TextureStreaming::calculateRequiredLevel(1024.0f, 2048.0f, 11), 0);
+	EXPECT_EQ(TextureStreaming::calculateRequiredLevel(1024.0f, 512.0f, 11), 1);
+	EXPECT_EQ(TextureStreaming::calculateRequiredLevel(1024.0f, 300.0f, 11), 1);
+	EXPECT_EQ(TextureStreaming::calculateRequiredLevel(1024.0f, 256.0f, 11), 2);
+	EXPECT_EQ(TextureStreaming::calculateRequiredLevel(1024.0f, 0.01f, 11), 10);
+	EXPECT_EQ(TextureStreaming::calculateRequiredLevel(1024.0f, 0.0f, 11), 10);
+	EXPECT_EQ(TextureStreaming::calculateRequiredLevel(1024.0f, 1.0f, 1), 0);
+}
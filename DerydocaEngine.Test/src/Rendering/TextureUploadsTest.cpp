@@ -0,0 +1,128 @@
+#include "EngineTestPch.h"
+#include "Rendering\TextureUploads.h"
+
+using namespace DerydocaEngine::Rendering;
+
+static void paintRect(std::vector<uint8_t>& image, int const& width, int const& channels, TextureUploads::UploadRect const& rect, uint8_t const& value)
+{
+	for (int y = rect.y; y < rect.y + rect.height; y++)
+	{
+		for (int x = rect.x; x < rect.x + rect.width; x++)
+		{
+			for (int c = 0; c < channels; c++)
+			{
+				image[(static_cast<size_t>(y) * width + x) * channels + c] = value;
+			}
+		}
+	}
+}
+
+static TextureUploads::UploadRect createRect(int const& x, int const& y, int const& width, int const& height)
+{
+	TextureUploads::UploadRect rect;
+	rect.x = x;
+	rect.y = y;
+	rect.width = width;
+	rect.height = height;
+	return rect;
+}
+
+TEST(TextureUploads, NothingIsDirty_When_ImagesMatch)
+{
+	std::vector<uint8_t> previous(64 * 64, 7);
+	std::vector<uint8_t> current(previous);
+
+	std::vector<TextureUploads::UploadRect> rects;
+	TextureUploads::findDirtyRects(previous.data(), current.data(), 64, 64, 1, 16, rects);
+
+	EXPECT_TRUE(rects.empty());
+}
+
+TEST(TextureUploads, ChangedTileIsDirty_When_OnePixelChanges)
+{
+	std::vector<uint8_t> previous(64 * 64 * 4, 0);
+	std::vector<uint8_t> current(previous);
+	paintRect(current, 64, 4, createRect(37, 5, 1, 1), 255);
+
+	std::vector<TextureUploads::UploadRect> rects;
+	TextureUploads::findDirtyRects(previous.data(), current.data(), 64, 64, 4, 16, rects);
+
+	ASSERT_EQ(1u, rects.size());
+	EXPECT_EQ(32, rects[0].x);
+	EXPECT_EQ(0, rects[0].y);
+	EXPECT_EQ(16, rects[0].width);
+	EXPECT_EQ(16, rects[0].height);
+}
+
+TEST(TextureUploads, NeighbouringTilesAreMerged_When_ARowOfGlyphsChanges)
+{
+	std::vector<uint8_t> previous(80 * 64, 0);
+	std::vector<uint8_t> current(previous);
+	paintRect(current, 80, 1, createRect(2, 20, 40, 4), 200);
+	paintRect(current, 80, 1, createRect(70, 20, 2, 2), 200);
+
+	std::vector<TextureUploads::UploadRect> rects;
+	TextureUploads::findDirtyRects(previous.data(), current.data(), 80, 64, 1, 16, rects);
+
+	// The first three tiles of the row are one run, the last tile is separated by a clean tile
+	ASSERT_EQ(2u, rects.size());
+	EXPECT_EQ(0, rects[0].x);
+	EXPECT_EQ(16, rects[0].y);
+	EXPECT_EQ(48, rects[0].width);
+	EXPECT_EQ(64, rects[1].x);
+	EXPECT_EQ(16, rects[1].width);
+}
+
+TEST(TextureUploads, EdgeTilesAreClipped_When_SizeIsNotAMultipleOfTheTileSize)
+{
+	std::vector<uint8_t> previous(50 * 40, 0);
+	std::vector<uint8_t> current(previous);
+	paintRect(current, 50, 1, createRect(49, 39, 1, 1), 1);
+
+	std::vector<TextureUploads::UploadRect> rects;
+	TextureUploads::findDirtyRects(previous.data(), current.data(), 50, 40, 1, 16, rects);
+
+	ASSERT_EQ(1u, rects.size());
+	EXPECT_EQ(48, rects[0].x);
+	EXPECT_EQ(32, rects[0].y);
+	EXPECT_EQ(2, rects[0].width);
+	EXPECT_EQ(8, rects[0].height);
+}
+
+TEST(TextureUploads, ChunksCoverRectWithinBudget_When_RectIsSplitIntoRows)
+{
+	TextureUploads::UploadRect rect = createRect(8, 4, 100, 30);
+
+	std::vector<TextureUploads::UploadRect> chunks;
+	TextureUploads::splitIntoChunks(rect, 4, 4000, chunks);
+
+	int coveredRows = 0;
+	for (auto const& chunk : chunks)
+	{
+		EXPECT_EQ(rect.x, chunk.x);
+		EXPECT_EQ(rect.width, chunk.width);
+		EXPECT_EQ(rect.y + coveredRows, chunk.y);
+		EXPECT_LE(static_cast<size_t>(chunk.width) * chunk.height * 4, 4000u);
+		coveredRows += chunk.height;
+	}
+	EXPECT_EQ(rect.height, coveredRows);
+	EXPECT_EQ(3u, chunks.size());
+}
+
+TEST(TextureUploads, RowsAreSplitIntoColumns_When_ARowIsLargerThanTheBudget)
+{
+	TextureUploads::UploadRect rect = createRect(0, 0, 1000, 2);
+
+	std::vector<TextureUploads::UploadRect> chunks;
+	TextureUploads::splitIntoChunks(rect, 4, 1600, chunks);
+
+	size_t coveredBytes = 0;
+	for (auto const& chunk : chunks)
+	{
+		EXPECT_EQ(1, chunk.height);
+		EXPECT_LE(static_cast<size_t>(chunk.width) * 4, 1600u);
+		coveredBytes += static_cast<size_t>(chunk.width) * chunk.height * 4;
+	}
+	EXPECT_EQ(1000u * 2 * 4, coveredBytes);
+	EXPECT_EQ(6u, chunks.size());
+}
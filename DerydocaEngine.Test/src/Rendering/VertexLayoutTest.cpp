@@ -0,0 +1,114 @@
+#include "EngineTestPch.h"
+#include "Rendering\VertexLayout.h"
+
+#include <glm/gtc/packing.hpp>
+
+using namespace DerydocaEngine;
+using namespace DerydocaEngine::Rendering;
+
+TEST(VertexLayout, OctahedralNormalsRoundTrip_When_EncodedAndDecoded)
+{
+	std::vector<glm::vec3> normals = {
+		glm::vec3(0.0f, 0.0f, 1.0f),
+		glm::vec3(0.0f, 0.0f, -1.0f),
+		glm::normalize(glm::vec3(1.0f, 2.0f, 3.0f)),
+		glm::normalize(glm::vec3(-0.3f, 0.7f, -0.6f)),
+		glm::normalize(glm::vec3(0.9f, -0.1f, -0.2f))
+	};
+
+	for (auto const& normal : normals)
+	{
+		glm::vec2 encoded = glm::unpackSnorm2x16(glm::packSnorm2x16(VertexPacking::encodeOctahedral(normal)));
+		glm::vec3 decoded = VertexPacking::decodeOctahedral(encoded);
+
+		EXPECT_GT(glm::dot(normal, decoded), 0.99999f);
+	}
+}
+
+TEST(VertexLayout, BitangentSignIsNegative_When_FrameIsMirrored)
+{
+	glm::vec3 normal(0.0f, 0.0f, 1.0f);
+	glm::vec3 tangent(1.0f, 0.0f, 0.0f);
+
+	EXPECT_EQ(VertexPacking::calculateBitangentSign(normal, tangent, glm::vec3(0.0f, 1.0f, 0.0f)), 1.0f);
+	EXPECT_EQ(VertexPacking::calculateBitangentSign(normal, tangent, glm::vec3(0.0f, -1.0f, 0.0f)), -1.0f);
+}
+
+TEST(VertexLayout, QuantizedBoneWeightsSumToOne_When_RoundingWouldDrift)
+{
+	std::array<float, Animation::MAX_BONES> weights = { 0.333f, 0.333f, 0.334f, 0.0f };
+
+	auto quantized = VertexPacking::quantizeBoneWeights(weights, 0xFF);
+
+	EXPECT_EQ(quantized[0] + quantized[1] + quantized[2] + quantized[3], 0xFFu);
+	EXPECT_EQ(quantized[3], 0u);
+}
+
+TEST(VertexLayout, TexCoordsUseUnorm16_When_InUnitRange)
+{
+	std::vector<glm::vec2> texCoords = { glm::vec2(0.0f, 0.0f), glm::vec2(1.0f, 0.5f) };
+
+	EXPECT_EQ(VertexLayout::selectForMesh(texCoords, 0).texCoords, TexCoordEncoding::Unorm16);
+}
+
+TEST(VertexLayout, TexCoordsFallBackToFloat_When_RangeIsTooLargeForHalf)
+{
+	std::vector<glm::vec2> tiledTexCoords = { glm::vec2(-1.0f, 0.0f), glm::vec2(1.5f, 1.0f) };
+	std::vector<glm::vec2> wideTexCoords = { glm::vec2(0.0f, 0.0f), glm::vec2(64.0f, 1.0f) };
+
+	EXPECT_EQ(VertexLayout::selectForMesh(tiledTexCoords, 0).texCoords, TexCoordEncoding::HalfFloat);
+	EXPECT_EQ(VertexLayout::selectForMesh(wideTexCoords, 0).texCoords, TexCoordEncoding::Float);
+}
+
+TEST(VertexLayout, BoneIndicesStayWide_When_SkeletonHasTooManyBones)
+{
+	std::vector<glm::vec2> texCoords;
+
+	EXPECT_TRUE(VertexLayout::selectForMesh(texCoords, 256).compactBoneIndices);
+	EXPECT_FALSE(VertexLayout::selectForMesh(texCoords, 257).compactBoneIndices);
+}
+
+TEST(VertexLayout, NormalsUseOctahedral_When_MeshAsksForIt)
+{
+	std::vector<glm::vec2> texCoords;
+
+	EXPECT_EQ(VertexLayout::selectForMesh(texCoords, 0).normals, NormalEncoding::Packed1010102);
+	EXPECT_TRUE(VertexLayout::selectForMesh(texCoords, 0).getShaderKeywords().empty());
+	EXPECT_EQ(VertexLayout::selectForMesh(texCoords, 0, true).normals, NormalEncoding::Octahedral);
+	EXPECT_EQ(VertexLayout::selectForMesh(texCoords, 0, true).getShaderKeywords(), std::vector<std::string>({ "OCTAHEDRAL_NORMALS" }));
+}
+
+TEST(VertexLayout, CompressedVertexIsSmaller_When_BuiltFromSameStreams)
+{
+	std::vector<glm::vec3> positions = { glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f) };
+	std::vector<glm::vec3> normals(3, glm::vec3(0.0f, 0.0f, 1.0f));
+	std::vector<glm::vec2> texCoords = { glm::vec2(0.0f), glm::vec2(1.0f, 0.0f), glm::vec2(0.0f, 1.0f) };
+	std::vector<glm::vec3> tangents(3, glm::vec3(1.0f, 0.0f, 0.0f));
+	std::vector<glm::vec3> bitangents(3, glm::vec3(0.0f, -1.0f, 0.0f));
+	std::vector<Color> colors(3, Color(1.0f, 0.5f, 0.0f));
+	std::vector<Animation::VertexBoneWeights> boneWeights(3);
+	VertexStreams streams = { &positions, &normals, &texCoords, &tangents, &bitangents, &colors, &boneWeights };
+
+	VertexBufferBuilder uncompressed(VertexLayout::uncompressed(), streams);
+	VertexBufferBuilder compressed(VertexLayout::selectForMesh(texCoords, 1), streams);
+
+	// Position (12) + normal (4) + tangent (4) + uv (4) + color (4) + indices (4) + weights (4)
+	EXPECT_EQ(compressed.getStride(), 36u);
+	EXPECT_EQ(uncompressed.getUncompressedStride(), 104u);
+	EXPECT_EQ(compressed.getUncompressedStride(), uncompressed.getUncompressedStride());
+
+	std::vector<uint8_t> buffer;
+	compressed.build(buffer);
+	ASSERT_EQ(buffer.size(), compressed.getStride() * 3);
+
+	// The mirrored frame stores a negative handedness in the tangent's w
+	for (auto const& attribute : compressed.getAttributes())
+	{
+		if (attribute.location == 3)
+		{
+			uint32_t packedTangent;
+			memcpy(&packedTangent, buffer.data() + attribute.offset, sizeof(packedTangent));
+			EXPECT_EQ(glm::unpackSnorm3x10_1x2(packedTangent).w, -1.0f);
+		}
+	}
+}
@@ -0,0 +1,334 @@
+#include "EngineTestPch.h"
+#include "Resources\MipResidencyPlanner.h"
+
+#include <functional>
+#include <map>
+#include <random>
+
+using namespace DerydocaEngine::Resources;
+
+// Level sizes of a square BC1 texture, 8 bytes per 4x4 block
+static std::vector<size_t> createLevelSizes(int const& size)
+{
+	std::vector<size_t> levelSizes;
+	for (int levelSize = size; levelSize > 0; levelSize /= 2)
+	{
+		size_t blocks = static_cast<size_t>((levelSize + 3) / 4);
+		levelSizes.push_back(blocks * blocks * 8);
+	}
+	return levelSizes;
+}
+
+static size_t sumLevels(std::vector<size_t> const& levelSizes, int const& firstLevel)
+{
+	size_t bytes = 0;
+	for (size_t i = firstLevel; i < levelSizes.size(); i++)
+	{
+		bytes += levelSizes[i];
+	}
+	return bytes;
+}
+
+TEST(MipResidencyPlanner, LevelsLoadOneAtATime_When_Requested)
+{
+	MipResidencyPlanner planner;
+	int textureId = planner.add(createLevelSizes(256), 2);
+	std::vector<MipResidencyPlanner::LevelChange> loads;
+	std::vector<MipResidencyPlanner::LevelChange> evictions;
+
+	for (int expectedLevel = 1; expectedLevel >= 0; expectedLevel--)
+	{
+		uint64_t frame = 2 - expectedLevel;
+		planner.request(textureId, 0, frame);
+		planner.plan(frame, loads, evictions);
+		ASSERT_EQ(loads.size(), 1u);
+		EXPECT_EQ(loads[0].textureId, textureId);
+		EXPECT_EQ(loads[0].level, expectedLevel);
+		EXPECT_TRUE(evictions.empty());
+
+		// Nothing more is planned while the level is loading
+		std::vector<MipResidencyPlanner::LevelChange> moreLoads;
+		planner.plan(frame, moreLoads, evictions);
+		EXPECT_TRUE(moreLoads.empty());
+
+		planner.completeLoad(textureId);
+		EXPECT_EQ(planner.getResidentLevel(textureId), expectedLevel);
+	}
+
+	MipResidencyPlanner::Statistics statistics = planner.getStatistics();
+	EXPECT_EQ(statistics.residentBytes, statistics.fullBytes);
+	EXPECT_EQ(statistics.pendingBytes, 0u);
+	EXPECT_EQ(statistics.loadCount, 2u);
+}
+
+TEST(MipResidencyPlanner, LargestLevelWins_When_RequestedTwiceInAFrame)
+{
+	MipResidencyPlanner planner;
+	int textureId = planner.add(createLevelSizes(256), 4);
+	planner.request(textureId, 2, 1);
+	planner.request(textureId, 3, 1);
+
+	std::vector<MipResidencyPlanner::LevelChange> loads;
+	std::vector<MipResidencyPlanner::LevelChange> evictions;
+	for (uint64_t frame = 1; frame < 10; frame++)
+	{
+		planner.plan(frame, loads, evictions);
+		for (auto const& load : loads)
+		{
+			planner.completeLoad(load.textureId);
+		}
+	}
+
+	EXPECT_EQ(planner.getResidentLevel(textureId), 2);
+}
+
+TEST(MipResidencyPlanner, LevelsAreKept_When_BudgetIsNotExceeded)
+{
+	MipResidencyPlanner planner;
+	planner.setRequestLifetime(2);
+	int textureId = planner.add(createLevelSizes(64), 2);
+
+	std::vector<MipResidencyPlanner::LevelChange> loads;
+	std::vector<MipResidencyPlanner::LevelChange> evictions;
+	for (uint64_t frame = 1; frame < 20; frame++)
+	{
+		if (frame < 5)
+		{
+			planner.request(textureId, 0, frame);
+		}
+		planner.plan(frame, loads, evictions);
+		EXPECT_TRUE(evictions.empty());
+		for (auto const& load : loads)
+		{
+			planner.completeLoad(load.textureId);
+		}
+	}
+
+	EXPECT_EQ(planner.getResidentLevel(textureId), 0);
+}
+
+TEST(MipResidencyPlanner, LeastRecentlyRequestedLevelsAreEvicted_When_BudgetIsExceeded)
+{
+	std::vector<size_t> levelSizes = createLevelSizes(64);
+	MipResidencyPlanner planner;
+	planner.setRequestLifetime(1);
+	planner.setMemoryBudget(sumLevels(levelSizes, 0) + sumLevels(levelSizes, 2) * 2);
+	int oldTextureId = planner.add(levelSizes, 2);
+	int recentTextureId = planner.add(levelSizes, 2);
+	int newTextureId = planner.add(levelSizes, 2);
+
+	std::vector<MipResidencyPlanner::LevelChange> loads;
+	std::vector<MipResidencyPlanner::LevelChange> evictions;
+	auto runFrames = [&](uint64_t const& firstFrame, uint64_t const& endFrame, int const& textureId)
+	{
+		for (uint64_t frame = firstFrame; frame < endFrame; frame++)
+		{
+			planner.request(textureId, 0, frame);
+			planner.plan(frame, loads, evictions);
+			for (auto const& load : loads)
+			{
+				planner.completeLoad(load.textureId);
+			}
+		}
+	};
+
+	runFrames(1, 5, oldTextureId);
+	EXPECT_EQ(planner.getResidentLevel(oldTextureId), 0);
+
+	// The second texture only fits by dropping the first one back to its smallest levels
+	runFrames(10, 15, recentTextureId);
+	EXPECT_EQ(planner.getResidentLevel(oldTextureId), 2);
+	EXPECT_EQ(planner.getResidentLevel(recentTextureId), 0);
+
+	runFrames(20, 25, newTextureId);
+	EXPECT_EQ(planner.getResidentLevel(recentTextureId), 2);
+	EXPECT_EQ(planner.getResidentLevel(newTextureId), 0);
+
+	MipResidencyPlanner::Statistics statistics = planner.getStatistics();
+	EXPECT_LE(statistics.peakResidentBytes, planner.getMemoryBudget());
+	EXPECT_EQ(statistics.evictionCount, 2u);
+}
+
+TEST(MipResidencyPlanner, LoadIsDeferred_When_NothingCanBeEvicted)
+{
+	std::vector<size_t> levelSizes = createLevelSizes(64);
+	MipResidencyPlanner planner;
+	planner.setMemoryBudget(sumLevels(levelSizes, 1));
+	int textureId = planner.add(levelSizes, 1);
+
+	std::vector<MipResidencyPlanner::LevelChange> loads;
+	std::vector<MipResidencyPlanner::LevelChange> evictions;
+	planner.request(textureId, 0, 1);
+	planner.plan(1, loads, evictions);
+
+	EXPECT_TRUE(loads.empty());
+	EXPECT_EQ(planner.getStatistics().deferredCount, 1u);
+	EXPECT_EQ(planner.getResidentLevel(textureId), 1);
+}
+
+TEST(MipResidencyPlanner, BudgetsHold_When_ThousandsOfTexturesAreStreamed)
+{
+	const int textureCount = 2000;
+	const uint64_t frameCount = 600;
+	const int visibleCount = 300;
+	const int residentSize = 64;
+	const size_t uploadBudget = 4 * 1024 * 1024;
+
+	std::mt19937 random(1234);
+	std::uniform_int_distribution<int> sizeDistribution(8, 12);
+	std::uniform_int_distribution<int> latencyDistribution(0, 4);
+	std::uniform_int_distribution<int> percentDistribution(0, 99);
+
+	MipResidencyPlanner planner;
+	planner.setUploadBudget(uploadBudget);
+
+	struct Texture
+	{
+		int id;
+		std::vector<size_t> levelSizes;
+		int smallestLevel;
+	};
+	std::vector<Texture> textures;
+	std::map<int, size_t> textureIndices;
+	size_t smallestBytes = 0;
+	size_t fullBytes = 0;
+	for (int i = 0; i < textureCount; i++)
+	{
+		Texture texture;
+		int size = 1 << sizeDistribution(random);
+		texture.levelSizes = createLevelSizes(size);
+		texture.smallestLevel = 0;
+		while ((size >> texture.smallestLevel) > residentSize)
+		{
+			texture.smallestLevel++;
+		}
+		texture.id = planner.add(texture.levelSizes, texture.smallestLevel);
+		smallestBytes += sumLevels(texture.levelSizes, texture.smallestLevel);
+		fullBytes += sumLevels(texture.levelSizes, 0);
+		textureIndices[texture.id] = textures.size();
+		textures.push_back(texture);
+	}
+
+	// Only a quarter of what every level would take fits, so the view moving keeps evicting
+	size_t memoryBudget = smallestBytes + (fullBytes - smallestBytes) / 4;
+	planner.setMemoryBudget(memoryBudget);
+
+	struct Load
+	{
+		int textureId;
+		uint64_t completeFrame;
+	};
+	std::vector<Load> inFlight;
+	std::vector<MipResidencyPlanner::LevelChange> loads;
+	std::vector<MipResidencyPlanner::LevelChange> evictions;
+
+	auto runFrame = [&](uint64_t const& frame, std::function<void()> const& makeRequests)
+	{
+		// Finish reads that are done, with a few failing
+		for (auto it = inFlight.begin(); it != inFlight.end();)
+		{
+			if (it->completeFrame > frame)
+			{
+				it++;
+				continue;
+			}
+
+			if (percentDistribution(random) < 2)
+			{
+				planner.cancelLoad(it->textureId);
+			}
+			else
+			{
+				planner.completeLoad(it->textureId);
+			}
+			it = inFlight.erase(it);
+		}
+
+		makeRequests();
+		planner.plan(frame, loads, evictions);
+
+		size_t plannedBytes = 0;
+		for (auto const& load : loads)
+		{
+			plannedBytes += textures[textureIndices[load.textureId]].levelSizes[load.level];
+			inFlight.push_back({ load.textureId, frame + latencyDistribution(random) });
+		}
+		ASSERT_TRUE(plannedBytes <= uploadBudget || loads.size() == 1) << "Frame " << frame;
+
+		MipResidencyPlanner::Statistics statistics = planner.getStatistics();
+		ASSERT_LE(statistics.residentBytes + statistics.pendingBytes, memoryBudget) << "Frame " << frame;
+	};
+
+	// A window of visible textures slides over every texture, each asking for random levels
+	auto startTime = std::chrono::high_resolution_clock::now();
+	for (uint64_t frame = 1; frame <= frameCount; frame++)
+	{
+		runFrame(frame, [&]()
+		{
+			int firstVisible = static_cast<int>(frame * (textureCount - visibleCount) / frameCount);
+			for (int i = firstVisible; i < firstVisible + visibleCount; i++)
+			{
+				if (percentDistribution(random) < 50)
+				{
+					std::uniform_int_distribution<int> levelDistribution(0, textures[i].smallestLevel);
+					planner.request(textures[i].id, levelDistribution(random), frame);
+				}
+			}
+		});
+		if (HasFatalFailure())
+		{
+			return;
+		}
+
+		if (frame % 50 == 0)
+		{
+			for (auto const& texture : textures)
+			{
+				ASSERT_LE(planner.getResidentLevel(texture.id), texture.smallestLevel);
+			}
+		}
+	}
+	std::chrono::duration<double, std::milli> planTime = std::chrono::high_resolution_clock::now() - startTime;
+
+	MipResidencyPlanner::Statistics statistics = planner.getStatistics();
+	EXPECT_EQ(statistics.textureCount, static_cast<size_t>(textureCount));
+	EXPECT_EQ(statistics.fullBytes, fullBytes);
+	EXPECT_GT(statistics.loadCount, 0u);
+	EXPECT_GT(statistics.evictionCount, 0u);
+	EXPECT_LE(statistics.peakResidentBytes, memoryBudget);
+
+	// Once the view settles on a few textures, they all reach the levels they ask for
+	std::vector<int> settledTextures;
+	for (int i = 0; i < 20; i++)
+	{
+		settledTextures.push_back(i * textureCount / 20);
+	}
+	for (uint64_t frame = frameCount + 1; frame <= frameCount + 400; frame++)
+	{
+		runFrame(frame, [&]()
+		{
+			for (int i : settledTextures)
+			{
+				planner.request(textures[i].id, 0, frame);
+			}
+		});
+		if (HasFatalFailure())
+		{
+			return;
+		}
+	}
+
+	for (int i : settledTextures)
+	{
+		EXPECT_EQ(planner.getResidentLevel(textures[i].id), 0) << "Texture " << i;
+	}
+
+	printf("Planned %d textures over %d frames in %.2fms, %zu levels loaded and %zu dropped, %.1f MB resident of %.1f MB\n",
+		textureCount,
+		static_cast<int>(frameCount),
+		planTime.count(),
+		statistics.loadCount,
+		statistics.evictionCount,
+		statistics.residentBytes / (1024.0f * 1024.0f),
+		statistics.fullBytes / (1024.0f * 1024.0f));
+}
@@ -0,0 +1,112 @@
+#include "EngineTestPch.h"
+#include "Resources\ResourceIndex.h"
+
+using namespace DerydocaEngine::Resources;
+
+static const char* TEST_META_FILE =
+	"Resources:\n"
+	"  - ID: 0c3f8ab1-7d8e-4b1e-9a39-4e0f5ad3b8f2\n"
+	"    Type: Mesh\n"
+	"    MeshIndex: 2\n"
+	"    Flags:\n"
+	"      - load_adjacent\n"
+	"      - ~\n"
+	"    Empty: \"\"\n";
+
+TEST(ResourceIndex, NodeIsUnchanged_When_EncodedAndDecoded)
+{
+	YAML::Node node = YAML::Load(TEST_META_FILE);
+
+	std::vector<uint8_t> encoded;
+	ResourceIndex::encodeNode(node, encoded);
+
+	YAML::Node decoded;
+	ASSERT_TRUE(ResourceIndex::decodeNode(encoded.data(), encoded.size(), decoded));
+
+	YAML::Emitter expected;
+	expected << node;
+	YAML::Emitter actual;
+	actual << decoded;
+	EXPECT_STREQ(actual.c_str(), expected.c_str());
+	EXPECT_EQ(decoded["Resources"][0]["MeshIndex"].as<int>(), 2);
+	EXPECT_TRUE(decoded["Resources"][0]["Flags"][1].IsNull());
+}
+
+TEST(ResourceIndex, DecodeFails_When_NodeIsTruncated)
+{
+	YAML::Node node = YAML::Load(TEST_META_FILE);
+	std::vector<uint8_t> encoded;
+	ResourceIndex::encodeNode(node, encoded);
+
+	YAML::Node decoded;
+	EXPECT_FALSE(ResourceIndex::decodeNode(encoded.data(), encoded.size() - 1, decoded));
+	EXPECT_FALSE(ResourceIndex::decodeNode(encoded.data(), 3, decoded));
+}
+
+TEST(ResourceIndex, IndexIsUnchanged_When_WrittenAndRead)
+{
+	std::vector<uint8_t> nodes;
+	ResourceIndex::encodeNode(YAML::Load(TEST_META_FILE)["Resources"], nodes);
+
+	IndexedMetaFile metaFile;
+	metaFile.sourceFilePath = "Assets\\Models\\cube.fbx";
+	metaFile.stamp.size = 1;
+	metaFile.stamp.writeTime = 2;
+	metaFile.stamp.hash = 3;
+	metaFile.resourceNodes = nodes.data();
+	metaFile.resourceNodesSize = nodes.size();
+
+	boost::uuids::uuid resourceId = {};
+	resourceId.data[15] = 7;
+	IndexedTreeNode root;
+	root.name = "__projectRoot__";
+	root.children = { 1 };
+	IndexedTreeNode models;
+	models.name = "Models";
+	models.resources = { resourceId };
+
+	std::vector<uint8_t> file;
+	ResourceIndex::write(file, { metaFile }, 42, { root, models });
+
+	std::vector<IndexedMetaFile> readMetaFiles;
+	uint64_t readTreeHash;
+	std::vector<IndexedTreeNode> readTree;
+	ASSERT_TRUE(ResourceIndex::read(file.data(), file.size(), readMetaFiles, readTreeHash, readTree));
+
+	ASSERT_EQ(readMetaFiles.size(), 1u);
+	EXPECT_EQ(readMetaFiles[0].sourceFilePath, metaFile.sourceFilePath);
+	EXPECT_EQ(readMetaFiles[0].stamp.size, 1u);
+	EXPECT_EQ(readMetaFiles[0].stamp.writeTime, 2);
+	EXPECT_EQ(readMetaFiles[0].stamp.hash, 3u);
+	ASSERT_EQ(readMetaFiles[0].resourceNodesSize, nodes.size());
+	EXPECT_GE(readMetaFiles[0].resourceNodes, file.data());
+	EXPECT_EQ(memcmp(readMetaFiles[0].resourceNodes, nodes.data(), nodes.size()), 0);
+	EXPECT_EQ(readTreeHash, 42u);
+	ASSERT_EQ(readTree.size(), 2u);
+	EXPECT_EQ(readTree[0].children, std::vector<uint32_t>{ 1 });
+	EXPECT_EQ(readTree[1].name, "Models");
+	ASSERT_EQ(readTree[1].resources.size(), 1u);
+	EXPECT_EQ(readTree[1].resources[0], resourceId);
+}
+
+TEST(ResourceIndex, ReadFails_When_FileIsTruncatedOrCorrupt)
+{
+	std::vector<uint8_t> file;
+	IndexedTreeNode root;
+	root.children = { 1 };
+	ResourceIndex::write(file, {}, 0, { root, IndexedTreeNode() });
+
+	std::vector<IndexedMetaFile> metaFiles;
+	uint64_t treeHash;
+	std::vector<IndexedTreeNode> tree;
+	EXPECT_TRUE(ResourceIndex::read(file.data(), file.size(), metaFiles, treeHash, tree));
+	EXPECT_FALSE(ResourceIndex::read(file.data(), file.size() - 4, metaFiles, treeHash, tree));
+	EXPECT_FALSE(ResourceIndex::read(file.data(), 8, metaFiles, treeHash, tree));
+
+	// Children must refer to nodes of the tree
+	ResourceIndex::write(file, {}, 0, { root });
+	EXPECT_FALSE(ResourceIndex::read(file.data(), file.size(), metaFiles, treeHash, tree));
+
+	file[0] = 'X';
+	EXPECT_FALSE(ResourceIndex::read(file.data(), file.size(), metaFiles, treeHash, tree));
+}
@@ -0,0 +1,323 @@
+#include "EnginePch.h"
+#include "Animation\AnimationCompression.h"
+
+namespace DerydocaEngine::Animation::AnimationCompression
+{
+
+	static const float TIME_QUANTIZATION_STEPS = 65535.0f;
+
+	// Deepest chain of channels followed when walking up the hierarchy, in case it loops
+	static const int MAX_HIERARCHY_DEPTH = 256;
+
+	static glm::vec3 lerpVector(glm::vec3 const& start, glm::vec3 const& end, float const& factor)
+	{
+		return start + factor * (end - start);
+	}
+
+	// Blends rotations the way the sampler does, with a normalized lerp along the shortest arc
+	static glm::quat nlerpRotation(glm::quat const& start, glm::quat const& end, float const& factor)
+	{
+		glm::quat target = glm::dot(start, end) < 0.0f ? -end : end;
+		glm::quat blended(
+			start.w + factor * (target.w - start.w),
+			start.x + factor * (target.x - start.x),
+			start.y + factor * (target.y - start.y),
+			start.z + factor * (target.z - start.z));
+		return glm::normalize(blended);
+	}
+
+	static float rotationAngle(glm::quat const& a, glm::quat const& b)
+	{
+		double dot = std::min(std::abs((double)a.x * b.x + (double)a.y * b.y + (double)a.z * b.z + (double)a.w * b.w), 1.0);
+		return (float)(2.0 * std::acos(dot));
+	}
+
+	static float largestDifference(glm::vec3 const& a, glm::vec3 const& b)
+	{
+		glm::vec3 difference = glm::abs(a - b);
+		return std::max(difference.x, std::max(difference.y, difference.z));
+	}
+
+	static uint16_t quantizeTime(double const& time, float const& timeScale)
+	{
+		return (uint16_t)std::min(std::max(std::round(time * timeScale), 0.0), (double)TIME_QUANTIZATION_STEPS);
+	}
+
+	/*
+	Removes every key of a track that interpolating the keys around it rebuilds within the error
+	budget, then writes the keys that are left. Keys are quantized before they are compared, so the
+	error includes everything the sampler will see.
+
+	@param encode Quantizes a value into the values of a key
+	@param decode Rebuilds a value from the values of a key
+	@param interpolate Blends two values the way the sampler does
+	@param measure Gets how far a point near the skin moves between two values
+	@return Largest error of the track
+	*/
+	template <typename T, typename Encode, typename Decode, typename Interpolate, typename Measure>
+	static float compressTrack(
+		std::vector<AnimationKey<T>> const& keys,
+		float const& budget,
+		CompressedTrack& track,
+		CompressedAnimation& compressed,
+		Encode encode,
+		Decode decode,
+		Interpolate interpolate,
+		Measure measure)
+	{
+		track.firstKey = (unsigned int)compressed.keyTimes.size();
+		track.keyCount = 0;
+		if (keys.empty())
+		{
+			return 0.0f;
+		}
+
+		size_t keyCount = keys.size();
+		std::vector<uint16_t> values(keyCount * VALUES_PER_KEY);
+		std::vector<uint16_t> times(keyCount);
+		std::vector<T> decoded(keyCount);
+		for (size_t i = 0; i < keyCount; i++)
+		{
+			encode(keys[i].value, values.data() + i * VALUES_PER_KEY);
+			decoded[i] = decode(values.data() + i * VALUES_PER_KEY);
+			times[i] = quantizeTime(keys[i].time, compressed.timeScale);
+		}
+
+		// Measures the error of every source key between two kept keys, returning the largest
+		auto measureSegment = [&](size_t const& start, size_t const& end) {
+			float error = 0.0f;
+			float segmentLength = (float)times[end] - (float)times[start];
+			for (size_t i = start + 1; i < end; i++)
+			{
+				float time = (float)keys[i].time * compressed.timeScale;
+				float factor = segmentLength > 0.0f ? std::min(std::max((time - times[start]) / segmentLength, 0.0f), 1.0f) : 0.0f;
+				error = std::max(error, measure(interpolate(decoded[start], decoded[end], factor), keys[i].value));
+			}
+			return error;
+		};
+
+		// A track that never leaves its first key only needs that key
+		float constantError = 0.0f;
+		for (size_t i = 0; i < keyCount; i++)
+		{
+			constantError = std::max(constantError, measure(decoded[0], keys[i].value));
+		}
+
+		std::vector<size_t> keptKeys = { 0 };
+		float trackError = constantError;
+		if (constantError > budget)
+		{
+			// Each kept key reaches as far ahead as it can while every key it skips stays within the budget
+			trackError = measure(decoded[0], keys[0].value);
+			size_t start = 0;
+			while (start + 1 < keyCount)
+			{
+				size_t end = start + 1;
+				float segmentError = 0.0f;
+				for (size_t candidate = start + 2; candidate < keyCount; candidate++)
+				{
+					float candidateError = measureSegment(start, candidate);
+					if (candidateError > budget)
+					{
+						break;
+					}
+					end = candidate;
+					segmentError = candidateError;
+				}
+
+				trackError = std::max(trackError, std::max(segmentError, measure(decoded[end], keys[end].value)));
+				keptKeys.push_back(end);
+				start = end;
+			}
+		}
+
+		for (size_t key : keptKeys)
+		{
+			compressed.keyTimes.push_back(times[key]);
+			compressed.keyValues.insert(compressed.keyValues.end(), values.begin() + key * VALUES_PER_KEY, values.begin() + (key + 1) * VALUES_PER_KEY);
+		}
+		track.keyCount = (unsigned int)keptKeys.size();
+
+		return trackError;
+	}
+
+	static void setVectorRange(std::vector<AnimationKey<glm::vec3>> const& keys, CompressedTrack& track)
+	{
+		if (keys.empty())
+		{
+			return;
+		}
+
+		glm::vec3 rangeMin = keys[0].value;
+		glm::vec3 rangeMax = keys[0].value;
+		for (auto const& key : keys)
+		{
+			rangeMin = glm::min(rangeMin, key.value);
+			rangeMax = glm::max(rangeMax, key.value);
+		}
+		track.rangeMin = rangeMin;
+		track.rangeExtent = rangeMax - rangeMin;
+	}
+
+	// Number of channels in the longest chain that passes through each channel, from a root down to a leaf
+	static std::vector<int> getChainLengths(std::vector<ChannelHierarchy> const& hierarchy, size_t const& channelCount)
+	{
+		auto getParent = [&](size_t const& channel) {
+			int parent = channel < hierarchy.size() ? hierarchy[channel].parentChannel : -1;
+			return parent >= 0 && (size_t)parent < channelCount ? parent : -1;
+		};
+
+		std::vector<int> depths(channelCount, 0);
+		std::vector<int> heights(channelCount, 0);
+		for (size_t channel = 0; channel < channelCount; channel++)
+		{
+			int distance = 1;
+			for (int parent = getParent(channel); parent >= 0 && distance < MAX_HIERARCHY_DEPTH; parent = getParent(parent), distance++)
+			{
+				heights[parent] = std::max(heights[parent], distance);
+				depths[channel] = distance;
+			}
+		}
+
+		std::vector<int> chainLengths(channelCount);
+		for (size_t channel = 0; channel < channelCount; channel++)
+		{
+			chainLengths[channel] = depths[channel] + heights[channel] + 1;
+		}
+		return chainLengths;
+	}
+
+	bool compress(
+		std::vector<AnimationChannel> const& channels,
+		double const& duration,
+		std::vector<ChannelHierarchy> const& hierarchy,
+		CompressionSettings const& settings,
+		CompressedAnimation& compressed,
+		CompressionReport& report)
+	{
+		auto compressStartTime = std::chrono::high_resolution_clock::now();
+
+		report = CompressionReport();
+		compressed = CompressedAnimation();
+		if (channels.empty() || duration <= 0.0 || settings.tolerance <= 0.0f)
+		{
+			return false;
+		}
+
+		compressed.timeScale = (float)(TIME_QUANTIZATION_STEPS / duration);
+		compressed.tracks.resize(channels.size() * TrackKindCount);
+
+		std::vector<int> chainLengths = getChainLengths(hierarchy, channels.size());
+		std::vector<float> channelErrors(channels.size());
+		for (size_t i = 0; i < channels.size(); i++)
+		{
+			AnimationChannel const& channel = channels[i];
+
+			// The channel's share of the tolerance is split evenly between its three tracks. Rotating
+			// or scaling a bone moves the skin by up to its reach, moving it only by the translation.
+			float budget = settings.tolerance / chainLengths[i] / TrackKindCount;
+			float reach = (i < hierarchy.size() ? hierarchy[i].extent : 0.0f) + settings.shellDistance;
+
+			CompressedTrack& positionTrack = compressed.tracks[i * TrackKindCount + PositionTrack];
+			setVectorRange(channel.positionKeys, positionTrack);
+			float positionError = compressTrack(channel.positionKeys, budget, positionTrack, compressed,
+				[&](glm::vec3 const& value, uint16_t* values) { encodeVector(value, positionTrack, values); },
+				[&](const uint16_t* values) { return decodeVector(values, positionTrack); },
+				lerpVector,
+				[](glm::vec3 const& a, glm::vec3 const& b) { return glm::length(a - b); });
+
+			CompressedTrack& rotationTrack = compressed.tracks[i * TrackKindCount + RotationTrack];
+			float rotationError = compressTrack(channel.rotationKeys, budget, rotationTrack, compressed,
+				encodeRotation,
+				decodeRotation,
+				nlerpRotation,
+				[&](glm::quat const& a, glm::quat const& b) { return rotationAngle(a, b) * reach; });
+
+			CompressedTrack& scaleTrack = compressed.tracks[i * TrackKindCount + ScaleTrack];
+			setVectorRange(channel.scaleKeys, scaleTrack);
+			float scaleError = compressTrack(channel.scaleKeys, budget, scaleTrack, compressed,
+				[&](glm::vec3 const& value, uint16_t* values) { encodeVector(value, scaleTrack, values); },
+				[&](const uint16_t* values) { return decodeVector(values, scaleTrack); },
+				lerpVector,
+				[&](glm::vec3 const& a, glm::vec3 const& b) { return largestDifference(a, b) * reach; });
+
+			channelErrors[i] = positionError + rotationError + scaleError;
+			report.rawKeyCount += channel.positionKeys.size() + channel.rotationKeys.size() + channel.scaleKeys.size();
+		}
+
+		// The error of every bone moves the bones below it, so errors add up down each chain
+		for (size_t i = 0; i < channels.size(); i++)
+		{
+			float error = 0.0f;
+			int channel = (int)i;
+			for (int depth = 0; channel >= 0 && (size_t)channel < channels.size() && depth < MAX_HIERARCHY_DEPTH; depth++)
+			{
+				error += channelErrors[channel];
+				channel = (size_t)channel < hierarchy.size() ? hierarchy[channel].parentChannel : -1;
+			}
+			report.maxError = std::max(report.maxError, error);
+		}
+
+		report.rawSize = getRawSize(channels);
+		report.compressedSize = compressed.getSize();
+		report.compressedKeyCount = compressed.keyTimes.size();
+
+		std::chrono::duration<double, std::milli> compressTime = std::chrono::high_resolution_clock::now() - compressStartTime;
+		report.compressTime = compressTime.count();
+		return true;
+	}
+
+	size_t getRawSize(std::vector<AnimationChannel> const& channels)
+	{
+		size_t size = 0;
+		for (auto const& channel : channels)
+		{
+			size += channel.positionKeys.size() * sizeof(AnimationKey<glm::vec3>);
+			size += channel.rotationKeys.size() * sizeof(AnimationKey<glm::quat>);
+			size += channel.scaleKeys.size() * sizeof(AnimationKey<glm::vec3>);
+		}
+		return size;
+	}
+
+	void encodeRotation(glm::quat const& rotation, uint16_t* values)
+	{
+		glm::quat normalized = glm::normalize(rotation);
+		float components[4] = { normalized.x, normalized.y, normalized.z, normalized.w };
+
+		int largest = 0;
+		for (int i = 1; i < 4; i++)
+		{
+			if (std::abs(components[i]) > std::abs(components[largest]))
+			{
+				largest = i;
+			}
+		}
+
+		// The largest component is rebuilt as a positive number, so the quaternion is flipped to match
+		float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+		int value = 0;
+		for (int i = 0; i < 4; i++)
+		{
+			if (i == largest)
+			{
+				continue;
+			}
+			float normalizedComponent = (components[i] * sign + INVERSE_SQRT_2) / (2.0f * INVERSE_SQRT_2);
+			float quantized = std::min(std::max(std::round(normalizedComponent * ROTATION_QUANTIZATION_STEPS), 0.0f), ROTATION_QUANTIZATION_STEPS);
+			values[value++] = (uint16_t)((uint16_t)quantized << 1);
+		}
+
+		values[0] |= (uint16_t)(largest & 1);
+		values[1] |= (uint16_t)((largest >> 1) & 1);
+	}
+
+	void encodeVector(glm::vec3 const& vector, CompressedTrack const& track, uint16_t* values)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			float normalized = track.rangeExtent[i] > 0.0f ? (vector[i] - track.rangeMin[i]) / track.rangeExtent[i] : 0.0f;
+			values[i] = (uint16_t)std::min(std::max(std::round(normalized * VECTOR_QUANTIZATION_STEPS), 0.0f), VECTOR_QUANTIZATION_STEPS);
+		}
+	}
+
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/vec3.hpp>
+
+#include "Animation\AnimationChannel.h"
+
+namespace DerydocaEngine::Animation
+{
+
+	/* Keys of one position, rotation or scale track within a compressed animation */
+	struct CompressedTrack
+	{
+		unsigned int firstKey = 0;
+		unsigned int keyCount = 0;
+		/* Range the quantized positions or scales cover, unused by rotations */
+		glm::vec3 rangeMin = glm::vec3(0.0f);
+		glm::vec3 rangeExtent = glm::vec3(0.0f);
+	};
+
+	/*
+	Compact form of an animation's keys, sampled without expanding it. Every channel has a position,
+	rotation and scale track in that order. Each key has a 16 bit time and three 16 bit values:
+	positions and scales are quantized within the range of their track, and rotations keep the three
+	smallest components of the quaternion, with the index of the largest in the low bits.
+	*/
+	struct CompressedAnimation
+	{
+		/* Multiplies a time in seconds to get it in the units of the key times */
+		float timeScale = 0.0f;
+		std::vector<CompressedTrack> tracks;
+		std::vector<uint16_t> keyTimes;
+		std::vector<uint16_t> keyValues;
+
+		bool isEmpty() const { return tracks.empty(); }
+		size_t getSize() const { return tracks.size() * sizeof(CompressedTrack) + (keyTimes.size() + keyValues.size()) * sizeof(uint16_t); }
+	};
+
+	/*
+	Import time compression of animation channels. Keys that can be rebuilt by interpolating their
+	neighbours are removed, as long as the error stays within a tolerance measured as how far a point
+	near the skin could move. A bone's error moves every bone below it as well, so each bone gets a
+	share of the tolerance based on the longest chain of bones it is part of.
+	*/
+	namespace AnimationCompression
+	{
+
+		enum TrackKind
+		{
+			PositionTrack,
+			RotationTrack,
+			ScaleTrack,
+			TrackKindCount
+		};
+
+		static const int VALUES_PER_KEY = 3;
+		static const float INVERSE_SQRT_2 = 0.70710678f;
+		static const float ROTATION_QUANTIZATION_STEPS = 32767.0f;
+		static const float VECTOR_QUANTIZATION_STEPS = 65535.0f;
+
+		struct CompressionSettings
+		{
+			/*
+			Largest distance removing keys may move a point near the skin from where the source keys put
+			it. Quantizing the keys that are left adds a little more, which the report includes.
+			*/
+			float tolerance = 0.001f;
+			/* Distance from a bone to the skin it moves, added to the reach of each bone */
+			float shellDistance = 0.05f;
+		};
+
+		/* Where a channel sits in the hierarchy of the nodes it animates */
+		struct ChannelHierarchy
+		{
+			/* Index of the nearest animated ancestor, or -1 if none is animated */
+			int parentChannel = -1;
+			/* Distance from the node to its furthest descendant in the rest pose */
+			float extent = 0.0f;
+		};
+
+		struct CompressionReport
+		{
+			size_t rawSize = 0;
+			size_t compressedSize = 0;
+			size_t rawKeyCount = 0;
+			size_t compressedKeyCount = 0;
+			/* Largest distance a point near the skin can move, summed down each chain of bones */
+			float maxError = 0.0f;
+			double compressTime = 0.0;
+		};
+
+		/*
+		Compresses the keys of an animation's channels.
+
+		@param channels Channels to compress
+		@param duration Duration of the animation in seconds
+		@param hierarchy Place of each channel in the hierarchy, or empty to treat every channel as a root
+		@param settings Tolerance of the compression
+		@param compressed Receives the compressed tracks
+		@param report Receives the sizes before and after and the largest error
+		@return True if the channels could be compressed
+		*/
+		bool compress(
+			std::vector<AnimationChannel> const& channels,
+			double const& duration,
+			std::vector<ChannelHierarchy> const& hierarchy,
+			CompressionSettings const& settings,
+			CompressedAnimation& compressed,
+			CompressionReport& report);
+
+		/* Gets how many bytes the keys of uncompressed channels take up */
+		size_t getRawSize(std::vector<AnimationChannel> const& channels);
+
+		void encodeRotation(glm::quat const& rotation, uint16_t* values);
+		void encodeVector(glm::vec3 const& vector, CompressedTrack const& track, uint16_t* values);
+
+		inline glm::quat decodeRotation(const uint16_t* values)
+		{
+			int largest = (values[0] & 1) | ((values[1] & 1) << 1);
+
+			float components[4];
+			float sumOfSquares = 0.0f;
+			int value = 0;
+			for (int i = 0; i < 4; i++)
+			{
+				if (i == largest)
+				{
+					continue;
+				}
+				float component = (values[value++] >> 1) * (2.0f * INVERSE_SQRT_2 / ROTATION_QUANTIZATION_STEPS) - INVERSE_SQRT_2;
+				components[i] = component;
+				sumOfSquares += component * component;
+			}
+			components[largest] = std::sqrt(std::max(1.0f - sumOfSquares, 0.0f));
+
+			return glm::quat(components[3], components[0], components[1], components[2]);
+		}
+
+		inline glm::vec3 decodeVector(const uint16_t* values, CompressedTrack const& track)
+		{
+			return track.rangeMin + track.rangeExtent * glm::vec3(values[0], values[1], values[2]) * (1.0f / VECTOR_QUANTIZATION_STEPS);
+		}
+
+	}
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <glm/mat4x4.hpp>
+#include <vector>
+#include "Animation\LocalPose.h"
+
+namespace DerydocaEngine::Animation {
+
+	class AnimationData;
+	class Skeleton;
+
+	/*
+	Where one instance is in an animation, kept between samples so each track carries on from the
+	key it was last at instead of searching its keys again. Also holds the instance's scratch
+	buffers, so sampling a pose does not allocate once the buffers have grown.
+	*/
+	struct AnimationCursor
+	{
+		AnimationCursor() :
+			animation(nullptr),
+			skeleton(nullptr),
+			layoutVersion(0),
+			lastTime(0.0f),
+			boneChannels(),
+			keyIndices(),
+			localPose(),
+			localTransforms(),
+			modelTransforms()
+		{
+		}
+
+		/* Animation the key indices belong to, the cursor starts over when it samples another one */
+		const AnimationData* animation;
+		/* Skeleton the bone channels were mapped for */
+		const Skeleton* skeleton;
+		/* Layout of the animation's channels the cursor was set up for, which changes when they are reordered */
+		unsigned int layoutVersion;
+		float lastTime;
+		/* Index of the channel that animates each bone of the skeleton, or -1 if none does */
+		std::vector<int> boneChannels;
+		/* Index of the key before the playhead, for the position, rotation and scale track of each channel */
+		std::vector<unsigned int> keyIndices;
+		LocalPose localPose;
+		std::vector<glm::mat4> localTransforms;
+		std::vector<glm::mat4> modelTransforms;
+	};
+
+}
@@ -6,20 +6,89 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/transform.hpp>
 #include <glm/gtx/quaternion.hpp>
+#include "Helpers\Statistics.h"
 
 namespace DerydocaEngine::Animation {
+
+	// Keys a track steps over before it gives up and searches, for when an instance skips ahead
+	static const unsigned int MAX_CURSOR_STEPS = 4;
+
+	/*
+	Finds the keys of a track that surround a point in time.
+
+	@param keyTimes Times of the track's keys
+	@param keyCount Number of keys in the track, which must be at least two
+	@param time Time to find the keys around, in the units of the key times
+	@param seek Whether to search every key instead of carrying on from the key index
+	@param keyIndex Index of the key before the time within the track, which is updated
+	@return How far the time is between the key and the one after it, from 0 to 1
+	*/
+	template <typename Time>
+	static float findKeys(const Time* keyTimes, unsigned int const& keyCount, float const& time, bool const& seek, unsigned int& keyIndex)
+	{
+		unsigned int lastIndex = keyCount - 2;
+
+		if (seek || keyIndex > lastIndex || time < keyTimes[keyIndex])
+		{
+			// Binary search for the last key at or before the time
+			keyIndex = (unsigned int)(std::upper_bound(keyTimes + 1, keyTimes + lastIndex + 1, time) - keyTimes) - 1;
+		}
+		else
+		{
+			// Playing forward usually crosses no more than a key or two per frame, so step over them
+			unsigned int steps = 0;
+			while (keyIndex < lastIndex && time >= keyTimes[keyIndex + 1])
+			{
+				keyIndex++;
+				if (++steps == MAX_CURSOR_STEPS && keyIndex < lastIndex && time >= keyTimes[keyIndex + 1])
+				{
+					keyIndex = (unsigned int)(std::upper_bound(keyTimes + keyIndex + 1, keyTimes + lastIndex + 1, time) - keyTimes) - 1;
+					break;
+				}
+			}
+		}
+
+		// Get a normalized percentage of the current playhead between the two nearest keys
+		float deltaTime = (float)keyTimes[keyIndex + 1] - (float)keyTimes[keyIndex];
+		float factor = deltaTime > 0.0f ? (time - (float)keyTimes[keyIndex]) / deltaTime : 0.0f;
+		return std::min(std::max(factor, 0.0f), 1.0f);
+	}
+
 	AnimationData::AnimationData() :
 		m_name(),
 		m_duration(),
-		m_channels()
+		m_channels(),
+		m_channelTracks(),
+		m_positionTimes(),
+		m_positionValues(),
+		m_rotationTimes(),
+		m_rotationValues(),
+		m_scaleTimes(),
+		m_scaleValues(),
+		m_compressed(),
+		m_layoutVersion(0),
+		m_poseCacheSettings(),
+		m_poseCaches()
 	{
 	}
 
 	AnimationData::AnimationData(const std::string& name, const double duration, const std::vector<AnimationChannel>& channels) :
 		m_name(name),
 		m_duration(duration),
-		m_channels(channels)
+		m_channels(channels),
+		m_channelTracks(),
+		m_positionTimes(),
+		m_positionValues(),
+		m_rotationTimes(),
+		m_rotationValues(),
+		m_scaleTimes(),
+		m_scaleValues(),
+		m_compressed(),
+		m_layoutVersion(0),
+		m_poseCacheSettings(),
+		m_poseCaches()
 	{
+		buildTracks();
 	}
 
 	const unsigned int AnimationData::getBoneId(const std::string& boneName)
@@ -52,166 +121,373 @@ namespace DerydocaEngine::Animation {
 		return getChannel(boneId);
 	}
 
-	void AnimationData::loadPose(float time, std::vector<glm::mat4>& boneTransforms, const std::shared_ptr<Skeleton>& skeleton)
+	void AnimationData::loadPose(float time, std::vector<glm::mat4>& boneTransforms, const std::shared_ptr<Skeleton>& skeleton) const
 	{
-		// Convert the animation time into the range of the animation duration
-		float animationTime = (float)fmod(time, m_duration);
-
-		// Recursively set the bone positions
-		const glm::mat4 parentTransform;
-		loadPose(animationTime, boneTransforms, skeleton->getGlobalInverseTransform(), skeleton->getRootBone(), parentTransform);
+		// Without a cursor of its own, every track is searched from scratch
+		AnimationCursor cursor;
+		samplePose(time, cursor, boneTransforms, skeleton);
 	}
 
-	void AnimationData::loadPose(float animationTime, std::vector<glm::mat4>& boneTransforms, const glm::mat4 & globalInverseTransform, const std::shared_ptr<Animation::Bone> bone, const glm::mat4 & parentTransform)
+	void AnimationData::samplePose(float time, AnimationCursor& cursor, std::vector<glm::mat4>& boneTransforms, const std::shared_ptr<Skeleton>& skeleton) const
 	{
-		// Calculate the transformation of the current bone
-		glm::mat4 boneTransform = bone->getOffset();
-		const AnimationChannel* channel = getChannel(bone->getID());
-		if (channel)
+		// Convert the animation time into the range of the animation duration
+		float animationTime = m_duration > 0.0 ? (float)fmod(time, m_duration) : 0.0f;
+		if (animationTime < 0.0f)
 		{
-			glm::vec3 translation;
-			calcInterpolatedTranslation(translation, animationTime, channel);
+			animationTime += (float)m_duration;
+		}
 
-			glm::quat rotation;
-			calcInterpolatedRotation(rotation, animationTime, channel);
+		// A cursor that was used for another animation or skeleton starts over, mapping the channels to bones again
+		bool restart = cursor.animation != this || cursor.skeleton != skeleton.get() || cursor.layoutVersion != m_layoutVersion;
+		if (restart)
+		{
+			cursor.animation = this;
+			cursor.skeleton = skeleton.get();
+			cursor.layoutVersion = m_layoutVersion;
+			cursor.keyIndices.assign(m_channels.size() * 3, 0);
+			mapChannelsToBones(*skeleton, cursor.boneChannels);
+		}
 
-			glm::vec3 scale;
-			calcInterpolatedScale(scale, animationTime, channel);
+		// As does one that has to go back in time, searching every track
+		bool seek = restart || animationTime < cursor.lastTime;
+		cursor.lastTime = animationTime;
 
-			boneTransform = glm::translate(translation) * glm::toMat4(rotation) * glm::scale(scale);
+		// Gather the keys around the playhead for every bone
+		LocalPose& localPose = cursor.localPose;
+		const std::vector<int>& boneChannels = cursor.boneChannels;
+		size_t boneCount = boneChannels.size();
+		if (localPose.getBoneCount() != boneCount)
+		{
+			localPose.resize(boneCount);
 		}
 
-		// Combine the bone's transform with all parent transforms that have come before it
-		glm::mat4 globalTransformation = parentTransform * boneTransform;
+		for (size_t i = 0; i < boneCount; i++)
+		{
+			int channelIndex = boneChannels[i];
+			if (channelIndex < 0)
+			{
+				continue;
+			}
+
+			unsigned int* keyIndices = cursor.keyIndices.data() + channelIndex * 3;
+			if (m_compressed.isEmpty())
+			{
+				setKeys(i, m_channelTracks[channelIndex], animationTime, seek, keyIndices, localPose);
+			}
+			else
+			{
+				setCompressedKeys(i, channelIndex, animationTime, seek, keyIndices, localPose);
+			}
+		}
 
-		// Store the bone transform information
-		boneTransforms[bone->getID()] = globalInverseTransform * globalTransformation * bone->getOffset();
+		// Interpolate the keys and build the local transform of every bone in one pass
+		localPose.evaluate(cursor.localTransforms);
 
-		// Recursively load all child bones
-		for (size_t i = 0; i < bone->getNumChildren(); i++)
+		// Then combine each bone's transform with its parent's, which always comes before it
+		cursor.modelTransforms.resize(boneCount);
+		if (boneTransforms.size() < boneCount)
 		{
-			//glm::mat4 globalTransformation;
-			loadPose(animationTime, boneTransforms, globalInverseTransform, bone->getChildBone((unsigned int)i), globalTransformation);
+			boneTransforms.resize(boneCount);
 		}
-	}
 
-	void AnimationData::calcInterpolatedScale(glm::vec3 & scale, const float animationTime, const AnimationChannel* channel)
-	{
-		switch (channel->scaleKeys.size())
-		{
-		case 0:
-			scale = glm::vec3(1.0f);
-			break;
-		case 1:
-			scale = channel->scaleKeys[0].value;
-			break;
-		default:
-			// Get the indices surrounding the current playhead
-			size_t scalingIndex = getPrevIndex(channel->scaleKeys, animationTime);
-			size_t nextScalingIndex = scalingIndex + 1;
-			assert(nextScalingIndex < channel->scaleKeys.size());
-			
-			// Get the amount of time that exists between the two different animation keys
-			float deltaTime = (float)(channel->scaleKeys[nextScalingIndex].time - channel->scaleKeys[scalingIndex].time);
-
-			// Get a normalized percentage of the current playhead between the two nearest keys
-			float factor = (animationTime - (float)channel->scaleKeys[scalingIndex].time) / deltaTime;
-			assert(factor >= 0.0f && factor <= 1.0f);
-
-			// Calculate the final value
-			const glm::vec3 start = channel->scaleKeys[scalingIndex].value;
-			const glm::vec3 end = channel->scaleKeys[nextScalingIndex].value;
-			glm::vec3 delta = end - start;
-			scale = start + factor * delta;
-			break;
+		const glm::mat4& globalInverseTransform = skeleton->getGlobalInverseTransform();
+		const std::vector<int>& parentIndices = skeleton->getParentIndices();
+		const std::vector<glm::mat4>& inverseBindTransforms = skeleton->getInverseBindTransforms();
+		const std::vector<glm::mat4>& restTransforms = skeleton->getRestTransforms();
+		for (size_t i = 0; i < boneCount; i++)
+		{
+			// Bones that are not animated stay in their rest pose
+			const glm::mat4& localTransform = boneChannels[i] < 0 ? restTransforms[i] : cursor.localTransforms[i];
+			int parentIndex = parentIndices[i];
+			cursor.modelTransforms[i] = parentIndex < 0 ? localTransform : cursor.modelTransforms[parentIndex] * localTransform;
+
+			boneTransforms[i] = globalInverseTransform * cursor.modelTransforms[i] * inverseBindTransforms[i];
 		}
 	}
 
-	void AnimationData::calcInterpolatedRotation(glm::quat & rotation, const float animationTime, const AnimationChannel* channel)
+	void AnimationData::setKeys(size_t const& bone, ChannelTracks const& tracks, float const& time, bool const& seek, unsigned int* keyIndices, LocalPose& localPose) const
 	{
-		switch (channel->rotationKeys.size())
-		{
-		case 0:
-			rotation = glm::quat();
-			break;
-		case 1:
-			rotation = channel->rotationKeys[0].value;
-			break;
-		default:
-			// Get the indices surrounding the current playhead
-			size_t prevIndex = getPrevIndex(channel->rotationKeys, animationTime);
-			size_t nextIndex = prevIndex + 1;
-			assert(nextIndex < channel->rotationKeys.size());
-
-			// Get the amount of time that exists between the two different animation keys
-			float deltaTime = (float)(channel->rotationKeys[nextIndex].time - channel->rotationKeys[prevIndex].time);
-
-			// Get a normalized percentage of the current playhead between the two nearest keys
-			float factor = (animationTime - (float)channel->rotationKeys[prevIndex].time) / deltaTime;
-			assert(factor >= 0.0f && factor <= 1.0f);
-
-			// Calculate the final value
-			const glm::quat start = channel->rotationKeys[prevIndex].value;
-			const glm::quat end = channel->rotationKeys[nextIndex].value;
-			rotation = glm::slerp(start, end, factor);
-			break;
+		if (tracks.position.count > 1)
+		{
+			float factor = findKeys(m_positionTimes.data() + tracks.position.first, tracks.position.count, time, seek, keyIndices[0]);
+			size_t key = tracks.position.first + keyIndices[0];
+			localPose.setTranslation(bone, m_positionValues[key], m_positionValues[key + 1], factor);
+		}
+		else if (tracks.position.count == 1)
+		{
+			localPose.setTranslation(bone, m_positionValues[tracks.position.first], m_positionValues[tracks.position.first], 0.0f);
+		}
+		else
+		{
+			localPose.setTranslation(bone, glm::vec3(), glm::vec3(), 0.0f);
+		}
+
+		if (tracks.rotation.count > 1)
+		{
+			float factor = findKeys(m_rotationTimes.data() + tracks.rotation.first, tracks.rotation.count, time, seek, keyIndices[1]);
+			size_t key = tracks.rotation.first + keyIndices[1];
+			localPose.setRotation(bone, m_rotationValues[key], m_rotationValues[key + 1], factor);
+		}
+		else if (tracks.rotation.count == 1)
+		{
+			localPose.setRotation(bone, m_rotationValues[tracks.rotation.first], m_rotationValues[tracks.rotation.first], 0.0f);
+		}
+		else
+		{
+			localPose.setRotation(bone, glm::quat(), glm::quat(), 0.0f);
+		}
+
+		if (tracks.scale.count > 1)
+		{
+			float factor = findKeys(m_scaleTimes.data() + tracks.scale.first, tracks.scale.count, time, seek, keyIndices[2]);
+			size_t key = tracks.scale.first + keyIndices[2];
+			localPose.setScale(bone, m_scaleValues[key], m_scaleValues[key + 1], factor);
+		}
+		else if (tracks.scale.count == 1)
+		{
+			localPose.setScale(bone, m_scaleValues[tracks.scale.first], m_scaleValues[tracks.scale.first], 0.0f);
+		}
+		else
+		{
+			localPose.setScale(bone, glm::vec3(1.0f), glm::vec3(1.0f), 0.0f);
 		}
 	}
 
-	void AnimationData::calcInterpolatedTranslation(glm::vec3 & position, const float animationTime, const AnimationChannel* channel)
+	void AnimationData::setCompressedKeys(size_t const& bone, size_t const& channel, float const& time, bool const& seek, unsigned int* keyIndices, LocalPose& localPose) const
 	{
-		switch (channel->positionKeys.size())
-		{
-		case 0:
-			position = glm::vec3();
-			break;
-		case 1:
-			position = channel->positionKeys[0].value;
-			break;
-		default:
-			// Get the indices surrounding the current playhead
-			size_t prevIndex = getPrevIndex(channel->positionKeys, animationTime);
-			size_t nextIndex = prevIndex + 1;
-			assert(nextIndex < channel->positionKeys.size());
-
-			// Get the amount of time that exists between the two different animation keys
-			float deltaTime = (float)(channel->positionKeys[nextIndex].time - channel->positionKeys[prevIndex].time);
-
-			// Get a normalized percentage of the current playhead between the two nearest keys
-			float factor = (animationTime - (float)channel->positionKeys[prevIndex].time) / deltaTime;
-			assert(factor >= 0.0f && factor <= 1.0f);
-
-			// Calculate the final value
-			const glm::vec3 start = channel->positionKeys[prevIndex].value;
-			const glm::vec3 end = channel->positionKeys[nextIndex].value;
-			glm::vec3 delta = end - start;
-			position = start + factor * delta;
-			break;
+		using namespace AnimationCompression;
+
+		// Key times are stored in steps across the duration rather than seconds
+		float keyTime = time * m_compressed.timeScale;
+		const CompressedTrack* tracks = m_compressed.tracks.data() + channel * TrackKindCount;
+
+		// Finds the keys of a track around the time, decoding the values of the first and second
+		auto findCompressedKeys = [&](CompressedTrack const& track, unsigned int& keyIndex, const uint16_t*& start, const uint16_t*& end) {
+			float factor = 0.0f;
+			if (track.keyCount > 1)
+			{
+				factor = findKeys(m_compressed.keyTimes.data() + track.firstKey, track.keyCount, keyTime, seek, keyIndex);
+				start = m_compressed.keyValues.data() + (track.firstKey + keyIndex) * VALUES_PER_KEY;
+				end = start + VALUES_PER_KEY;
+			}
+			else
+			{
+				start = m_compressed.keyValues.data() + track.firstKey * VALUES_PER_KEY;
+				end = start;
+			}
+			return factor;
+		};
+
+		const uint16_t* start;
+		const uint16_t* end;
+
+		CompressedTrack const& positionTrack = tracks[PositionTrack];
+		if (positionTrack.keyCount > 0)
+		{
+			float factor = findCompressedKeys(positionTrack, keyIndices[0], start, end);
+			localPose.setTranslation(bone, decodeVector(start, positionTrack), decodeVector(end, positionTrack), factor);
+		}
+		else
+		{
+			localPose.setTranslation(bone, glm::vec3(), glm::vec3(), 0.0f);
+		}
+
+		CompressedTrack const& rotationTrack = tracks[RotationTrack];
+		if (rotationTrack.keyCount > 0)
+		{
+			float factor = findCompressedKeys(rotationTrack, keyIndices[1], start, end);
+			localPose.setRotation(bone, decodeRotation(start), decodeRotation(end), factor);
+		}
+		else
+		{
+			localPose.setRotation(bone, glm::quat(), glm::quat(), 0.0f);
+		}
+
+		CompressedTrack const& scaleTrack = tracks[ScaleTrack];
+		if (scaleTrack.keyCount > 0)
+		{
+			float factor = findCompressedKeys(scaleTrack, keyIndices[2], start, end);
+			localPose.setScale(bone, decodeVector(start, scaleTrack), decodeVector(end, scaleTrack), factor);
+		}
+		else
+		{
+			localPose.setScale(bone, glm::vec3(1.0f), glm::vec3(1.0f), 0.0f);
 		}
 	}
 
-	void AnimationData::optimizeForSkeleton(const std::shared_ptr<Skeleton>& skeleton)
+	void AnimationData::buildTracks()
 	{
-		const std::shared_ptr<Bone> rootBone = skeleton->getRootBone();
-		optimizeForSkeleton(rootBone);
+		m_channelTracks.resize(m_channels.size());
+		m_positionTimes.clear();
+		m_positionValues.clear();
+		m_rotationTimes.clear();
+		m_rotationValues.clear();
+		m_scaleTimes.clear();
+		m_scaleValues.clear();
 
-		std::sort(m_channels.begin(), m_channels.end());
+		for (size_t i = 0; i < m_channels.size(); i++)
+		{
+			const AnimationChannel& channel = m_channels[i];
+			ChannelTracks& tracks = m_channelTracks[i];
+
+			tracks.position.first = (unsigned int)m_positionTimes.size();
+			tracks.position.count = (unsigned int)channel.positionKeys.size();
+			for (auto const& key : channel.positionKeys)
+			{
+				m_positionTimes.push_back((float)key.time);
+				m_positionValues.push_back(key.value);
+			}
+
+			tracks.rotation.first = (unsigned int)m_rotationTimes.size();
+			tracks.rotation.count = (unsigned int)channel.rotationKeys.size();
+			for (auto const& key : channel.rotationKeys)
+			{
+				m_rotationTimes.push_back((float)key.time);
+				m_rotationValues.push_back(key.value);
+			}
+
+			tracks.scale.first = (unsigned int)m_scaleTimes.size();
+			tracks.scale.count = (unsigned int)channel.scaleKeys.size();
+			for (auto const& key : channel.scaleKeys)
+			{
+				m_scaleTimes.push_back((float)key.time);
+				m_scaleValues.push_back(key.value);
+			}
+		}
 	}
 
-	void AnimationData::optimizeForSkeleton(const std::shared_ptr<Bone> bone)
+	void AnimationData::mapChannelsToBones(const Skeleton& skeleton, std::vector<int>& boneChannels) const
 	{
+		boneChannels.assign(skeleton.getNumBones(), -1);
 		for (size_t i = 0; i < m_channels.size(); i++)
 		{
-			if (m_channels[i].boneName == bone->getName())
+			unsigned int boneId = skeleton.getBoneID(m_channels[i].boneName);
+			if (boneId != (unsigned int)-1 && boneChannels[boneId] < 0)
+			{
+				boneChannels[boneId] = (int)i;
+			}
+		}
+	}
+
+	void AnimationData::optimizeForSkeleton(const std::shared_ptr<Skeleton>& skeleton)
+	{
+		// Channels take the ID of the bone they animate, and channels without a bone go to the end
+		for (auto& channel : m_channels)
+		{
+			channel.id = skeleton->getBoneID(channel.boneName);
+		}
+
+		std::vector<size_t> order(m_channels.size());
+		for (size_t i = 0; i < order.size(); i++)
+		{
+			order[i] = i;
+		}
+		std::stable_sort(order.begin(), order.end(), [&](size_t const& a, size_t const& b) { return m_channels[a].id < m_channels[b].id; });
+
+		std::vector<AnimationChannel> channels;
+		channels.reserve(m_channels.size());
+		for (size_t index : order)
+		{
+			channels.push_back(std::move(m_channels[index]));
+		}
+		m_channels = std::move(channels);
+
+		// Compressed tracks belong to their channel, so they move along with it
+		if (!m_compressed.isEmpty())
+		{
+			std::vector<CompressedTrack> tracks;
+			tracks.reserve(m_compressed.tracks.size());
+			for (size_t index : order)
 			{
-				m_channels[i].id = bone->getID();
+				auto channelTracks = m_compressed.tracks.begin() + index * AnimationCompression::TrackKindCount;
+				tracks.insert(tracks.end(), channelTracks, channelTracks + AnimationCompression::TrackKindCount);
 			}
+			m_compressed.tracks = std::move(tracks);
+		}
+
+		// The channels moved, so their keys are gathered again in the new order
+		buildTracks();
+		m_layoutVersion++;
+
+		// Bake the poses once for every instance that will play the animation on this skeleton. A table
+		// that did not fit stays in the map empty, so it is not attempted again for the same skeleton.
+		if (!m_poseCacheSettings.enabled || m_poseCaches.find(skeleton) != m_poseCaches.end())
+		{
+			return;
+		}
+
+		for (auto it = m_poseCaches.begin(); it != m_poseCaches.end();)
+		{
+			if (it->first.expired())
+			{
+				it = m_poseCaches.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		PoseCache& poseCache = m_poseCaches[skeleton];
+		bool built = poseCache.build(*this, skeleton, m_poseCacheSettings);
+		if (!Helpers::Statistics::isEnabled())
+		{
+			return;
+		}
+
+		if (built)
+		{
+			printf("Baked animation %s into a pose cache of %zu frames at %.1f per second, %.1f KB\n",
+				m_name.c_str(),
+				poseCache.getFrameCount(),
+				poseCache.getSampleRate(),
+				poseCache.getSize() / 1024.0f);
+		}
+		else
+		{
+			printf("Animation %s does not fit its pose cache limit of %zu KB, so it is sampled live\n",
+				m_name.c_str(),
+				m_poseCacheSettings.maxKilobytes);
+		}
+	}
+
+	const PoseCache* AnimationData::getPoseCache(std::shared_ptr<Skeleton> const& skeleton) const
+	{
+		auto search = m_poseCaches.find(skeleton);
+		return search == m_poseCaches.end() || search->second.isEmpty() ? nullptr : &search->second;
+	}
+
+	bool AnimationData::compress(std::vector<AnimationCompression::ChannelHierarchy> const& hierarchy, AnimationCompression::CompressionSettings const& settings, AnimationCompression::CompressionReport& report)
+	{
+		if (!m_compressed.isEmpty())
+		{
+			return false;
+		}
+
+		CompressedAnimation compressed;
+		if (!AnimationCompression::compress(m_channels, m_duration, hierarchy, settings, compressed, report))
+		{
+			return false;
 		}
+		m_compressed = std::move(compressed);
 
-		for (unsigned int i = 0; i < bone->getNumChildren(); i++)
+		// Only the compressed keys are sampled from now on, so the originals are released
+		for (auto& channel : m_channels)
 		{
-			optimizeForSkeleton(bone->getChildBone(i));
+			std::vector<AnimationKey<glm::vec3>>().swap(channel.positionKeys);
+			std::vector<AnimationKey<glm::quat>>().swap(channel.rotationKeys);
+			std::vector<AnimationKey<glm::vec3>>().swap(channel.scaleKeys);
 		}
+		buildTracks();
+		m_positionTimes.shrink_to_fit();
+		m_positionValues.shrink_to_fit();
+		m_rotationTimes.shrink_to_fit();
+		m_rotationValues.shrink_to_fit();
+		m_scaleTimes.shrink_to_fit();
+		m_scaleValues.shrink_to_fit();
+		m_layoutVersion++;
+
+		return true;
 	}
 
 }
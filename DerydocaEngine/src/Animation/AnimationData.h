@@ -1,7 +1,12 @@
 #pragma once
+#include <map>
+#include <memory>
 #include <vector>
 #include <glm/mat4x4.hpp>
 #include "Animation\AnimationChannel.h"
+#include "Animation\AnimationCompression.h"
+#include "Animation\AnimationCursor.h"
+#include "Animation\PoseCache.h"
 #include "Animation\Skeleton.h"
 
 namespace DerydocaEngine::Animation {
@@ -16,33 +21,104 @@ namespace DerydocaEngine::Animation {
 		const unsigned int getBoneId(const std::string & boneName);
 		const AnimationChannel* getChannel(unsigned int boneId);
 		const AnimationChannel* getChannel(const std::string & boneName);
-		void loadPose(float time, std::vector<glm::mat4>& boneTransforms, const std::shared_ptr<Skeleton>& skeleton);
+		void loadPose(float time, std::vector<glm::mat4>& boneTransforms, const std::shared_ptr<Skeleton>& skeleton) const;
+
+		/*
+		Samples the pose of a skeleton at a point in the animation, carrying on from where the cursor
+		was last time. Playing forward only steps each track past the keys it crossed, while jumping
+		back, such as when the animation loops, searches the keys again. Only the cursor is written
+		to, so instances with cursors of their own can be sampled from several threads at once.
+
+		@param time Time in seconds, which wraps around the duration of the animation
+		@param cursor Where the instance being posed was in the animation, which is updated
+		@param boneTransforms Receives the skinning matrix of each bone, indexed by bone ID
+		@param skeleton Skeleton to pose
+		*/
+		void samplePose(float time, AnimationCursor& cursor, std::vector<glm::mat4>& boneTransforms, const std::shared_ptr<Skeleton>& skeleton) const;
+
+		/*
+		Orders the channels by the bone they animate in a skeleton, and bakes the pose cache for the
+		skeleton if the animation has one enabled and it was not already baked for it.
+
+		@param skeleton Skeleton the animation is played on
+		*/
 		void optimizeForSkeleton(const std::shared_ptr<Skeleton>& skeleton);
 
+		/*
+		Replaces the keys of the animation with a compressed copy, which is sampled without expanding
+		it. The keys of the channels are released, so their names are all that remains of them.
+
+		@param hierarchy Place of each channel in the node hierarchy, in the order of the channels
+		@param settings Tolerance of the compression
+		@param report Receives the sizes before and after and the largest error
+		@return True if the animation was compressed
+		*/
+		bool compress(std::vector<AnimationCompression::ChannelHierarchy> const& hierarchy, AnimationCompression::CompressionSettings const& settings, AnimationCompression::CompressionReport& report);
+		bool isCompressed() const { return !m_compressed.isEmpty(); }
+
+		/*
+		Sets how the animation is baked into a pose cache when it is bound to a skeleton. Changing
+		the settings drops the cache, which is baked again the next time the animation is bound.
+
+		@param settings Whether to bake the cache, and its rate and size limit
+		*/
+		void setPoseCacheSettings(PoseCacheSettings const& settings) { m_poseCacheSettings = settings; m_poseCaches.clear(); }
+		const PoseCacheSettings& getPoseCacheSettings() const { return m_poseCacheSettings; }
+
+		/*
+		Gets the table of the animation's palettes baked for a skeleton, shared by every instance
+		playing the animation on it.
+
+		@param skeleton Skeleton the animation is played on
+		@return The table, or null if none was baked for the skeleton or it did not fit
+		*/
+		const PoseCache* getPoseCache(std::shared_ptr<Skeleton> const& skeleton) const;
+
 	private:
+		/* Range of a channel's keys within one of the key arrays */
+		struct KeyTrack
+		{
+			unsigned int first = 0;
+			unsigned int count = 0;
+		};
+
+		struct ChannelTracks
+		{
+			KeyTrack position;
+			KeyTrack rotation;
+			KeyTrack scale;
+		};
+
 		std::string m_name;
 		double m_duration;
 		std::vector<AnimationChannel> m_channels;
 
-		void loadPose(float animationTime, std::vector<glm::mat4>& boneTransforms, const glm::mat4& globalInverseTransform, const std::shared_ptr<Animation::Bone> bone, const glm::mat4& parentTransform);
-		void calcInterpolatedScale(glm::vec3& scale, const float animationTime, const AnimationChannel* channel);
-		void calcInterpolatedRotation(glm::quat & rotation, const float animationTime, const AnimationChannel* channel);
-		void calcInterpolatedTranslation(glm::vec3 & position, const float animationTime, const AnimationChannel* channel);
-		void optimizeForSkeleton(const std::shared_ptr<Bone> bone);
+		// Key times and values of every channel, with each kind of key in its own arrays
+		std::vector<ChannelTracks> m_channelTracks;
+		std::vector<float> m_positionTimes;
+		std::vector<glm::vec3> m_positionValues;
+		std::vector<float> m_rotationTimes;
+		std::vector<glm::quat> m_rotationValues;
+		std::vector<float> m_scaleTimes;
+		std::vector<glm::vec3> m_scaleValues;
 
-		template <typename T>
-		size_t getPrevIndex(const std::vector<AnimationKey<T>> & animationKeys, float animationTime)
-		{
-			for (size_t i = 0; i < animationKeys.size() - 1; i++)
-			{
-				if (animationTime < animationKeys[i + 1].time)
-				{
-					return i;
-				}
-			}
-
-			return 0;
-		}
+		// Keys of every channel once the animation is compressed, which replace the arrays above
+		CompressedAnimation m_compressed;
+
+		// Changes whenever the channels are reordered or their keys replaced, so cursors know to start over
+		unsigned int m_layoutVersion;
+
+		PoseCacheSettings m_poseCacheSettings;
+		// One table per skeleton the animation is played on. The weak pointers keep a freed skeleton's
+		// entry from matching a new skeleton at the same address, and are dropped on the next bake.
+		std::map<std::weak_ptr<Skeleton>, PoseCache, std::owner_less<>> m_poseCaches;
+
+		void buildTracks();
+		void mapChannelsToBones(const Skeleton& skeleton, std::vector<int>& boneChannels) const;
+
+		// Sets the keys each track of a bone's channel falls between at a point in time
+		void setKeys(size_t const& bone, ChannelTracks const& tracks, float const& time, bool const& seek, unsigned int* keyIndices, LocalPose& localPose) const;
+		void setCompressedKeys(size_t const& bone, size_t const& channel, float const& time, bool const& seek, unsigned int* keyIndices, LocalPose& localPose) const;
 	};
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,153 @@
+#include "EnginePch.h"
+#include "Animation\AnimationInstance.h"
+
+#include <algorithm>
+#include "Animation\AnimationData.h"
+#include "Animation\PaletteBlend.h"
+#include "Animation\Skeleton.h"
+
+namespace DerydocaEngine::Animation {
+
+	AnimationInstance::AnimationInstance(std::shared_ptr<AnimationData> const& animation, std::shared_ptr<Skeleton> const& skeleton) :
+		m_animation(animation),
+		m_skeleton(skeleton),
+		m_cursor(),
+		m_time(0.0f),
+		m_speed(1.0f),
+		m_liveSampling(false),
+		m_evaluated(false),
+		m_evaluatedTime(0.0f),
+		m_boneTransforms(skeleton ? skeleton->getNumBones() : 0),
+		m_lodSettings(),
+		m_lodPhase(0),
+		m_hasScreenSize(false),
+		m_screenSize(0.0f),
+		m_screenSizeFrame(0),
+		m_blendSource(),
+		m_blendTarget(),
+		m_blending(false),
+		m_blendStartTime(0.0f),
+		m_blendDuration(0.0f),
+		m_paletteOffset(-1),
+		m_paletteFrame(0)
+	{
+	}
+
+	void AnimationInstance::evaluate(Evaluation const& evaluation)
+	{
+		if (!m_animation || !m_skeleton || evaluation == Evaluation::None)
+		{
+			return;
+		}
+
+		if (evaluation == Evaluation::Blend)
+		{
+			blend();
+		}
+		else if (evaluation == Evaluation::SampleBlendTarget && m_evaluated)
+		{
+			// Start from the pose the last blend was heading to, so each sampled pose is shown in full one interval late
+			if (m_blending)
+			{
+				m_blendSource.swap(m_blendTarget);
+			}
+			else
+			{
+				m_blendSource = m_boneTransforms;
+			}
+			samplePose(m_blendTarget);
+			m_boneTransforms = m_blendSource;
+			m_blendStartTime = m_time;
+			m_blendDuration = m_time - m_evaluatedTime;
+			m_blending = m_blendDuration != 0.0f;
+			m_evaluatedTime = m_time;
+		}
+		else
+		{
+			samplePose(m_boneTransforms);
+			m_evaluatedTime = m_time;
+			m_evaluated = true;
+			m_blending = false;
+		}
+
+		// Whatever was copied into the shared palette buffer is now out of date
+		m_paletteOffset = -1;
+	}
+
+	AnimationInstance::Evaluation AnimationInstance::getEvaluation(unsigned int const& frame) const
+	{
+		if (!needsEvaluation())
+		{
+			return Evaluation::None;
+		}
+
+		// Instances no renderer has reported on are animated every frame
+		if (!m_evaluated || !m_hasScreenSize)
+		{
+			return Evaluation::Sample;
+		}
+
+		// Nobody would see the pose, so only the playhead moves until a camera sees the instance again
+		if (isCulled(frame))
+		{
+			return Evaluation::None;
+		}
+
+		unsigned int updateInterval = AnimationLod::calculateUpdateInterval(m_lodSettings.levels, m_screenSize);
+		if (updateInterval <= 1)
+		{
+			return Evaluation::Sample;
+		}
+
+		if (AnimationLod::isUpdateFrame(frame, updateInterval, m_lodPhase))
+		{
+			return m_lodSettings.interpolate ? Evaluation::SampleBlendTarget : Evaluation::Sample;
+		}
+
+		return m_lodSettings.interpolate && m_blending ? Evaluation::Blend : Evaluation::None;
+	}
+
+	void AnimationInstance::setScreenSize(float const& screenSize, unsigned int const& frame)
+	{
+		if (!m_hasScreenSize || m_screenSizeFrame != frame)
+		{
+			m_screenSize = screenSize;
+		}
+		else
+		{
+			m_screenSize = std::max(m_screenSize, screenSize);
+		}
+		m_screenSizeFrame = frame;
+		m_hasScreenSize = true;
+	}
+
+	bool AnimationInstance::usesPoseCache() const
+	{
+		return !m_liveSampling && m_animation && m_animation->getPoseCache(m_skeleton) != nullptr;
+	}
+
+	void AnimationInstance::samplePose(std::vector<glm::mat4>& boneTransforms)
+	{
+		const PoseCache* poseCache = m_liveSampling ? nullptr : m_animation->getPoseCache(m_skeleton);
+		if (poseCache)
+		{
+			poseCache->loadPose(m_time, boneTransforms);
+		}
+		else
+		{
+			m_animation->samplePose(m_time, m_cursor, boneTransforms, m_skeleton);
+		}
+	}
+
+	void AnimationInstance::blend()
+	{
+		if (!m_blending || m_blendSource.size() != m_boneTransforms.size() || m_blendTarget.size() != m_boneTransforms.size())
+		{
+			return;
+		}
+
+		float weight = glm::clamp((m_time - m_blendStartTime) / m_blendDuration, 0.0f, 1.0f);
+		PaletteBlend::lerp(m_blendSource.data(), m_blendTarget.data(), weight, m_boneTransforms.size(), m_boneTransforms.data());
+	}
+
+}
@@ -0,0 +1,154 @@
+#pragma once
+#include <glm/mat4x4.hpp>
+#include <memory>
+#include <vector>
+#include "Animation\AnimationCursor.h"
+#include "Animation\AnimationLod.h"
+
+namespace DerydocaEngine::Animation {
+
+	class AnimationData;
+	class Skeleton;
+
+	/*
+	One character playing an animation, with its own playback time and speed and the bone palette
+	last sampled for it. Instances are advanced during the update, then evaluated together by the
+	animation system before anything renders, so rendering only reads the finished palette.
+
+	Once a renderer reports how large the instance is on screen, its pose is sampled at the rate of
+	its LOD level, and not at all while no camera sees it. The playhead keeps moving either way.
+	Animations with a pose cache baked for the instance's skeleton are looked up in it rather than
+	sampled, unless the instance asks for live sampling.
+	*/
+	class AnimationInstance
+	{
+	public:
+		/* Work an instance needs in a frame's evaluation */
+		enum class Evaluation
+		{
+			// The palette is current, or the instance waits for its next frame
+			None,
+			// Sample the pose at the playhead
+			Sample,
+			// Sample the pose at the playhead as the next one to blend to
+			SampleBlendTarget,
+			// Blend between the last two sampled poses
+			Blend
+		};
+
+		AnimationInstance(std::shared_ptr<AnimationData> const& animation, std::shared_ptr<Skeleton> const& skeleton);
+
+		/*
+		Moves the playhead forward by an amount of time, scaled by the playback speed.
+
+		@param deltaTime Time since the last update in seconds
+		*/
+		void advance(float const& deltaTime) { m_time += deltaTime * m_speed; }
+
+		/*
+		Samples the pose at the playhead into the bone palette, or blends towards it. Only touches
+		the instance itself, so different instances can be evaluated on different threads at the
+		same time.
+
+		@param evaluation Work to do, which samples the pose straight into the palette by default
+		*/
+		void evaluate(Evaluation const& evaluation = Evaluation::Sample);
+
+		/*
+		Picks the work the instance needs in a frame from its screen size and LOD settings.
+
+		@param frame Frame being evaluated
+		@return Work to pass to evaluate
+		*/
+		Evaluation getEvaluation(unsigned int const& frame) const;
+
+		/* Whether the palette is missing or was sampled at another time than the playhead */
+		bool needsEvaluation() const { return !m_evaluated || m_evaluatedTime != m_time; }
+
+		std::shared_ptr<AnimationData> getAnimation() const { return m_animation; }
+		std::shared_ptr<Skeleton> getSkeleton() const { return m_skeleton; }
+		float getTime() const { return m_time; }
+		void setTime(float const& time) { m_time = time; }
+		float getSpeed() const { return m_speed; }
+		void setSpeed(float const& speed) { m_speed = speed; }
+
+		/*
+		Forces the pose to be sampled from the animation's keys even when the animation has a pose
+		cache, for instances whose pose is changed after it is sampled, such as by blending with
+		another animation or by inverse kinematics.
+
+		@param liveSampling True to ignore the pose cache
+		*/
+		void setLiveSampling(bool const& liveSampling) { m_liveSampling = liveSampling; }
+		bool getLiveSampling() const { return m_liveSampling; }
+
+		/* Whether the pose is looked up in the animation's pose cache instead of sampled */
+		bool usesPoseCache() const;
+
+		const AnimationLodSettings& getLodSettings() const { return m_lodSettings; }
+		void setLodSettings(AnimationLodSettings const& lodSettings) { m_lodSettings = lodSettings; }
+		unsigned int getLodPhase() const { return m_lodPhase; }
+		void setLodPhase(unsigned int const& lodPhase) { m_lodPhase = lodPhase; }
+
+		/*
+		Records how large the instance appears to a camera that sees it. When several cameras see
+		it in the same frame, the largest size is kept.
+
+		@param screenSize Fraction of the screen's height the instance covers
+		@param frame Frame of the animation system the instance was rendered in
+		*/
+		void setScreenSize(float const& screenSize, unsigned int const& frame);
+
+		/* Whether the evaluation of a frame skipped the instance because no camera saw it the frame before */
+		bool isCulled(unsigned int const& frame) const { return m_hasScreenSize && m_screenSizeFrame + 1 < frame; }
+
+		/* Whether a pose has been sampled at all */
+		bool hasPose() const { return m_evaluated; }
+
+		/* Skinning matrix of each bone, indexed by bone ID, as of the last evaluation */
+		const std::vector<glm::mat4>& getBoneTransforms() const { return m_boneTransforms; }
+
+		/*
+		Records where the palette was copied to in a buffer shared by every instance.
+
+		@param offset Index of the palette's first matrix in the buffer
+		@param frame Frame of the buffer the palette was written in
+		*/
+		void setPaletteOffset(int const& offset, unsigned int const& frame) { m_paletteOffset = offset; m_paletteFrame = frame; }
+
+		/*
+		Gets where the palette was copied to in the shared buffer.
+
+		@param frame Current frame of the buffer
+		@return Index of the palette's first matrix, or -1 if the palette was not written this frame or has changed since
+		*/
+		int getPaletteOffset(unsigned int const& frame) const { return m_paletteFrame == frame ? m_paletteOffset : -1; }
+	private:
+		void samplePose(std::vector<glm::mat4>& boneTransforms);
+		void blend();
+
+		std::shared_ptr<AnimationData> m_animation;
+		std::shared_ptr<Skeleton> m_skeleton;
+		AnimationCursor m_cursor;
+		float m_time;
+		float m_speed;
+		bool m_liveSampling;
+		bool m_evaluated;
+		float m_evaluatedTime;
+		std::vector<glm::mat4> m_boneTransforms;
+		AnimationLodSettings m_lodSettings;
+		unsigned int m_lodPhase;
+		bool m_hasScreenSize;
+		float m_screenSize;
+		unsigned int m_screenSizeFrame;
+		// Poses blended between at reduced rates, and the playhead times they span
+		std::vector<glm::mat4> m_blendSource;
+		std::vector<glm::mat4> m_blendTarget;
+		bool m_blending;
+		float m_blendStartTime;
+		float m_blendDuration;
+		int m_paletteOffset;
+		unsigned int m_paletteFrame;
+	};
+
+}
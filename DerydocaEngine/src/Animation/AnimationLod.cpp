@@ -0,0 +1,51 @@
+#include "EnginePch.h"
+#include "Animation\AnimationLod.h"
+
+#include <algorithm>
+#include "Rendering\Culling.h"
+
+namespace DerydocaEngine::Animation::AnimationLod
+{
+
+	// Keeps a camera inside of the bounds from dividing by zero
+	static const float MIN_DISTANCE = 0.01f;
+
+	float calculateScreenSize(glm::mat4 const& projectionMatrix, glm::mat4 const& viewModelMatrix, glm::vec3 const& boundsMin, glm::vec3 const& boundsMax)
+	{
+		if (!Rendering::Culling::isBoxInsideClipVolume(projectionMatrix * viewModelMatrix, boundsMin, boundsMax))
+		{
+			return 0.0f;
+		}
+
+		float scale = std::max(
+			glm::length(glm::vec3(viewModelMatrix[0])),
+			std::max(glm::length(glm::vec3(viewModelMatrix[1])), glm::length(glm::vec3(viewModelMatrix[2]))));
+		float radius = glm::length(boundsMax - boundsMin) * 0.5f * scale;
+
+		// The projection maps half of the screen's height to 1, and orthographic projections show every distance at the same size
+		float screenSize = radius * projectionMatrix[1][1];
+		if (projectionMatrix[3][3] != 1.0f)
+		{
+			glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+			float distance = glm::length(glm::vec3(viewModelMatrix * glm::vec4(center, 1.0f)));
+			screenSize /= std::max(distance, MIN_DISTANCE);
+		}
+
+		return screenSize;
+	}
+
+	unsigned int calculateUpdateInterval(std::vector<AnimationLodLevel> const& levels, float const& screenSize)
+	{
+		for (auto const& level : levels)
+		{
+			if (screenSize >= level.screenSize)
+			{
+				return std::max(level.updateInterval, 1u);
+			}
+		}
+
+		// Smaller than every level, so use the slowest rate there is
+		return levels.empty() ? 1 : std::max(levels.back().updateInterval, 1u);
+	}
+
+}
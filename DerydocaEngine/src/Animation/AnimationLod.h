@@ -0,0 +1,74 @@
+#pragma once
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <vector>
+
+namespace DerydocaEngine::Animation
+{
+
+	/* How often a character is animated once it covers at least a part of the screen */
+	struct AnimationLodLevel
+	{
+		// Fraction of the screen's height the character's bounds cover
+		float screenSize;
+		// Number of frames between poses, where 1 is every frame
+		unsigned int updateInterval;
+	};
+
+	/* Update rates of a character by how large it appears on screen */
+	struct AnimationLodSettings
+	{
+		// Levels ordered from the largest screen size to the smallest, a character uses the first one it is large enough for
+		std::vector<AnimationLodLevel> levels = {
+			{ 0.2f, 1 },
+			{ 0.08f, 2 },
+			{ 0.0f, 4 }
+		};
+		// Blend from one reduced rate pose to the next in the frames in between, which shows each pose an interval late
+		bool interpolate = false;
+	};
+
+	/*
+	Picks how often a character's pose is sampled from how large it is on screen. Characters that
+	are small or far away are animated every few frames instead of every frame, with each one
+	given its own phase so the ones that share a rate do not all sample on the same frame.
+	*/
+	namespace AnimationLod
+	{
+
+		/*
+		Calculates how much of the screen's height the bounding sphere of a box covers.
+
+		@param projectionMatrix Projection matrix of the camera
+		@param viewModelMatrix Matrix from the box's space to the camera's space
+		@param boundsMin Minimum corner of the box
+		@param boundsMax Maximum corner of the box
+		@return Fraction of the screen's height covered, or 0 if the box is outside of the camera's view
+		*/
+		float calculateScreenSize(glm::mat4 const& projectionMatrix, glm::mat4 const& viewModelMatrix, glm::vec3 const& boundsMin, glm::vec3 const& boundsMax);
+
+		/*
+		Gets how many frames apart a character of a given screen size should be animated.
+
+		@param levels Levels ordered from the largest screen size to the smallest
+		@param screenSize Fraction of the screen's height the character covers
+		@return Number of frames between poses, which is 1 if there are no levels
+		*/
+		unsigned int calculateUpdateInterval(std::vector<AnimationLodLevel> const& levels, float const& screenSize);
+
+		/*
+		Tests if a character animated at a reduced rate samples its pose on a frame.
+
+		@param frame Frame being updated
+		@param updateInterval Number of frames between poses
+		@param phase Offset of the character's frames, so characters with different phases spread over the interval
+		@return True if the pose should be sampled this frame
+		*/
+		inline bool isUpdateFrame(unsigned int const& frame, unsigned int const& updateInterval, unsigned int const& phase)
+		{
+			return updateInterval <= 1 || (frame + phase) % updateInterval == 0;
+		}
+
+	}
+
+}
@@ -0,0 +1,119 @@
+#include "EnginePch.h"
+#include "Animation\AnimationSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include "Helpers\ParallelFor.h"
+
+namespace DerydocaEngine::Animation
+{
+
+	AnimationSystem::AnimationSystem() :
+		m_instances(),
+		m_activeInstances(),
+		m_pendingInstances(),
+		m_threadCount(0),
+		m_frame(0),
+		m_addedInstanceCount(0),
+		m_statistics()
+	{
+	}
+
+	AnimationSystem::~AnimationSystem()
+	{
+	}
+
+	void AnimationSystem::addInstance(std::weak_ptr<AnimationInstance> const& instance)
+	{
+		// Consecutive instances get consecutive phases, so those at the same reduced rate take turns
+		auto lockedInstance = instance.lock();
+		if (!lockedInstance)
+		{
+			return;
+		}
+		lockedInstance->setLodPhase(m_addedInstanceCount++);
+		m_instances.push_back(instance);
+	}
+
+	void AnimationSystem::removeInstance(std::shared_ptr<AnimationInstance> const& instance)
+	{
+		m_instances.erase(std::remove_if(m_instances.begin(), m_instances.end(), [&](std::weak_ptr<AnimationInstance> const& other) {
+			auto otherInstance = other.lock();
+			return !otherInstance || otherInstance == instance;
+		}), m_instances.end());
+		m_activeInstances.erase(std::remove(m_activeInstances.begin(), m_activeInstances.end(), instance), m_activeInstances.end());
+	}
+
+	void AnimationSystem::update()
+	{
+		// Gather the instances that need work this frame, dropping any that were released
+		m_frame++;
+		m_activeInstances.clear();
+		m_pendingInstances.clear();
+		size_t sampleCount = 0;
+		m_instances.erase(std::remove_if(m_instances.begin(), m_instances.end(), [&](std::weak_ptr<AnimationInstance> const& instance) {
+			auto lockedInstance = instance.lock();
+			if (!lockedInstance)
+			{
+				return true;
+			}
+			m_activeInstances.push_back(lockedInstance);
+
+			AnimationInstance::Evaluation evaluation = lockedInstance->getEvaluation(m_frame);
+			if (evaluation == AnimationInstance::Evaluation::None)
+			{
+				if (lockedInstance->needsEvaluation())
+				{
+					m_statistics.skippedPoseCount++;
+				}
+				return false;
+			}
+			if (evaluation != AnimationInstance::Evaluation::Blend)
+			{
+				sampleCount++;
+			}
+			m_pendingInstances.push_back({ lockedInstance, evaluation });
+			return false;
+		}), m_instances.end());
+
+		m_statistics.lastFramePoseCount = sampleCount;
+		m_statistics.lastEvaluateTime = 0.0;
+		if (m_pendingInstances.empty())
+		{
+			return;
+		}
+
+		auto evaluateStartTime = std::chrono::high_resolution_clock::now();
+
+		Helpers::parallelFor(m_pendingInstances.size(), [&](size_t const& i) {
+			m_pendingInstances[i].first->evaluate(m_pendingInstances[i].second);
+		}, m_threadCount);
+
+		std::chrono::duration<double, std::milli> evaluateTime = std::chrono::high_resolution_clock::now() - evaluateStartTime;
+		m_statistics.evaluatedPoseCount += sampleCount;
+		m_statistics.blendedPoseCount += m_pendingInstances.size() - sampleCount;
+		m_statistics.evaluateFrameCount++;
+		m_statistics.peakFramePoseCount = std::max(m_statistics.peakFramePoseCount, sampleCount);
+		m_statistics.evaluateTime += evaluateTime.count();
+		m_statistics.lastEvaluateTime = evaluateTime.count();
+		m_statistics.peakEvaluateTime = std::max(m_statistics.peakEvaluateTime, evaluateTime.count());
+
+		m_pendingInstances.clear();
+	}
+
+	void AnimationSystem::printStatistics() const
+	{
+		unsigned int threadCount = m_threadCount > 0 ? m_threadCount : std::max(std::thread::hardware_concurrency(), 1u);
+		printf("Evaluated %zu animation poses and blended %zu over %zu frames on %u threads in %.2fms, at most %zu poses in a frame and %.2fms for a frame, skipped %zu poses by LOD\n",
+			m_statistics.evaluatedPoseCount,
+			m_statistics.blendedPoseCount,
+			m_statistics.evaluateFrameCount,
+			threadCount,
+			m_statistics.evaluateTime,
+			m_statistics.peakFramePoseCount,
+			m_statistics.peakEvaluateTime,
+			m_statistics.skippedPoseCount);
+	}
+
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <memory>
+#include <utility>
+#include <vector>
+#include "Animation\AnimationInstance.h"
+
+namespace DerydocaEngine::Animation
+{
+
+	/*
+	Evaluates the poses of every playing animation instance in one phase between the update and
+	rendering. Instances that moved since they were last evaluated are spread over a pool of
+	threads, so large crowds scale with the number of cores instead of being sampled one at a time
+	in between draw calls. Each instance's LOD settings decide whether it is sampled, blended or
+	skipped in a frame, with instances spread over the phases of their update interval.
+	*/
+	class AnimationSystem
+	{
+	public:
+		static AnimationSystem& getInstance()
+		{
+			static AnimationSystem instance;
+			return instance;
+		}
+
+		/* Counters of the poses evaluated so far */
+		struct Statistics
+		{
+			size_t evaluatedPoseCount = 0;
+			size_t blendedPoseCount = 0;
+			size_t skippedPoseCount = 0;
+			size_t evaluateFrameCount = 0;
+			size_t lastFramePoseCount = 0;
+			size_t peakFramePoseCount = 0;
+			double evaluateTime = 0.0;
+			double lastEvaluateTime = 0.0;
+			double peakEvaluateTime = 0.0;
+		};
+
+		/*
+		Starts evaluating an instance every frame. The system only keeps a weak reference, so an
+		instance that is released stops being evaluated.
+
+		@param instance Instance to evaluate
+		*/
+		void addInstance(std::weak_ptr<AnimationInstance> const& instance);
+		void removeInstance(std::shared_ptr<AnimationInstance> const& instance);
+
+		/*
+		Evaluates every instance whose playhead moved since it was last evaluated and that is due
+		for a pose this frame. Must be called once per frame after the scene is updated and before
+		it renders.
+		*/
+		void update();
+
+		/* Number of the frame last updated, which renderers report screen sizes for */
+		unsigned int getFrame() const { return m_frame; }
+
+		/*
+		Sets how many threads evaluate the instances, which includes the calling thread.
+
+		@param threadCount Number of threads, or 0 to use every core
+		*/
+		void setThreadCount(unsigned int const& threadCount) { m_threadCount = threadCount; }
+		unsigned int getThreadCount() const { return m_threadCount; }
+
+		size_t getInstanceCount() const { return m_instances.size(); }
+		Statistics getStatistics() const { return m_statistics; }
+
+		/* Gets every instance that was still alive during the last update, whether it moved or not */
+		const std::vector<std::shared_ptr<AnimationInstance>>& getActiveInstances() const { return m_activeInstances; }
+
+		/* Prints how many poses were evaluated, on how many threads and how long it took */
+		void printStatistics() const;
+
+		void operator=(AnimationSystem const&) = delete;
+	private:
+		AnimationSystem();
+		AnimationSystem(AnimationSystem const&);
+		~AnimationSystem();
+
+		std::vector<std::weak_ptr<AnimationInstance>> m_instances;
+		std::vector<std::shared_ptr<AnimationInstance>> m_activeInstances;
+		// Instances evaluated this frame, kept between frames so gathering them does not allocate
+		std::vector<std::pair<std::shared_ptr<AnimationInstance>, AnimationInstance::Evaluation>> m_pendingInstances;
+		unsigned int m_threadCount;
+		unsigned int m_frame;
+		unsigned int m_addedInstanceCount;
+		Statistics m_statistics;
+	};
+
+}
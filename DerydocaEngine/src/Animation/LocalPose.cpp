@@ -0,0 +1,227 @@
+#include "EnginePch.h"
+#include "Animation\LocalPose.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#include <xmmintrin.h>
+#define LOCAL_POSE_SSE
+#endif
+
+namespace DerydocaEngine::Animation {
+
+	// Every value of a component is held for four bones at once, so a group of bones fits in one SSE register
+#ifdef LOCAL_POSE_SSE
+	typedef __m128 Lanes;
+
+	static inline Lanes loadLanes(const float* values) { return _mm_loadu_ps(values); }
+	static inline Lanes setLanes(float const& value) { return _mm_set1_ps(value); }
+	static inline Lanes addLanes(Lanes const& a, Lanes const& b) { return _mm_add_ps(a, b); }
+	static inline Lanes subtractLanes(Lanes const& a, Lanes const& b) { return _mm_sub_ps(a, b); }
+	static inline Lanes multiplyLanes(Lanes const& a, Lanes const& b) { return _mm_mul_ps(a, b); }
+	static inline Lanes divideLanes(Lanes const& a, Lanes const& b) { return _mm_div_ps(a, b); }
+	static inline Lanes sqrtLanes(Lanes const& a) { return _mm_sqrt_ps(a); }
+
+	// Flips the sign of every value whose lane in the condition is negative
+	static inline Lanes flipWhereNegative(Lanes const& value, Lanes const& condition)
+	{
+		Lanes signMask = _mm_and_ps(_mm_cmplt_ps(condition, _mm_setzero_ps()), _mm_set1_ps(-0.0f));
+		return _mm_xor_ps(value, signMask);
+	}
+
+	// Turns four components of four bones into four columns, one for each bone
+	static inline void storeColumns(float* matrices, int const& column, Lanes x, Lanes y, Lanes z, Lanes w)
+	{
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		_mm_storeu_ps(matrices + column * 4, x);
+		_mm_storeu_ps(matrices + 16 + column * 4, y);
+		_mm_storeu_ps(matrices + 32 + column * 4, z);
+		_mm_storeu_ps(matrices + 48 + column * 4, w);
+	}
+#else
+	struct Lanes
+	{
+		float values[4];
+	};
+
+	static inline Lanes loadLanes(const float* values) { return { { values[0], values[1], values[2], values[3] } }; }
+	static inline Lanes setLanes(float const& value) { return { { value, value, value, value } }; }
+
+	template <typename Operation>
+	static inline Lanes combineLanes(Lanes const& a, Lanes const& b, Operation operation)
+	{
+		return { { operation(a.values[0], b.values[0]), operation(a.values[1], b.values[1]), operation(a.values[2], b.values[2]), operation(a.values[3], b.values[3]) } };
+	}
+
+	static inline Lanes addLanes(Lanes const& a, Lanes const& b) { return combineLanes(a, b, [](float x, float y) { return x + y; }); }
+	static inline Lanes subtractLanes(Lanes const& a, Lanes const& b) { return combineLanes(a, b, [](float x, float y) { return x - y; }); }
+	static inline Lanes multiplyLanes(Lanes const& a, Lanes const& b) { return combineLanes(a, b, [](float x, float y) { return x * y; }); }
+	static inline Lanes divideLanes(Lanes const& a, Lanes const& b) { return combineLanes(a, b, [](float x, float y) { return x / y; }); }
+	static inline Lanes sqrtLanes(Lanes const& a) { return { { std::sqrt(a.values[0]), std::sqrt(a.values[1]), std::sqrt(a.values[2]), std::sqrt(a.values[3]) } }; }
+
+	static inline Lanes flipWhereNegative(Lanes const& value, Lanes const& condition)
+	{
+		return combineLanes(value, condition, [](float x, float c) { return c < 0.0f ? -x : x; });
+	}
+
+	static inline void storeColumns(float* matrices, int const& column, Lanes const& x, Lanes const& y, Lanes const& z, Lanes const& w)
+	{
+		for (int bone = 0; bone < 4; bone++)
+		{
+			float* destination = matrices + bone * 16 + column * 4;
+			destination[0] = x.values[bone];
+			destination[1] = y.values[bone];
+			destination[2] = z.values[bone];
+			destination[3] = w.values[bone];
+		}
+	}
+#endif
+
+	static inline Lanes lerpLanes(Lanes const& start, Lanes const& end, Lanes const& factor)
+	{
+		return addLanes(start, multiplyLanes(factor, subtractLanes(end, start)));
+	}
+
+	LocalPose::LocalPose() :
+		m_boneCount(0),
+		m_stride(0),
+		m_streams()
+	{
+	}
+
+	void LocalPose::resize(size_t const& boneCount)
+	{
+		m_boneCount = boneCount;
+		m_stride = (boneCount + 3) / 4 * 4;
+		m_streams.assign(StreamCount * m_stride, 0.0f);
+
+		// The padding after the last bone stays at the identity too, so it normalizes cleanly
+		std::fill_n(getStream(RotationStartW), m_stride, 1.0f);
+		std::fill_n(getStream(RotationEndW), m_stride, 1.0f);
+		for (Stream stream : { ScaleStartX, ScaleStartY, ScaleStartZ, ScaleEndX, ScaleEndY, ScaleEndZ })
+		{
+			std::fill_n(getStream(stream), m_stride, 1.0f);
+		}
+	}
+
+	void LocalPose::setTranslation(size_t const& bone, glm::vec3 const& start, glm::vec3 const& end, float const& factor)
+	{
+		getStream(TranslationStartX)[bone] = start.x;
+		getStream(TranslationStartY)[bone] = start.y;
+		getStream(TranslationStartZ)[bone] = start.z;
+		getStream(TranslationEndX)[bone] = end.x;
+		getStream(TranslationEndY)[bone] = end.y;
+		getStream(TranslationEndZ)[bone] = end.z;
+		getStream(TranslationFactor)[bone] = factor;
+	}
+
+	void LocalPose::setRotation(size_t const& bone, glm::quat const& start, glm::quat const& end, float const& factor)
+	{
+		getStream(RotationStartX)[bone] = start.x;
+		getStream(RotationStartY)[bone] = start.y;
+		getStream(RotationStartZ)[bone] = start.z;
+		getStream(RotationStartW)[bone] = start.w;
+		getStream(RotationEndX)[bone] = end.x;
+		getStream(RotationEndY)[bone] = end.y;
+		getStream(RotationEndZ)[bone] = end.z;
+		getStream(RotationEndW)[bone] = end.w;
+		getStream(RotationFactor)[bone] = factor;
+	}
+
+	void LocalPose::setScale(size_t const& bone, glm::vec3 const& start, glm::vec3 const& end, float const& factor)
+	{
+		getStream(ScaleStartX)[bone] = start.x;
+		getStream(ScaleStartY)[bone] = start.y;
+		getStream(ScaleStartZ)[bone] = start.z;
+		getStream(ScaleEndX)[bone] = end.x;
+		getStream(ScaleEndY)[bone] = end.y;
+		getStream(ScaleEndZ)[bone] = end.z;
+		getStream(ScaleFactor)[bone] = factor;
+	}
+
+	void LocalPose::evaluate(std::vector<glm::mat4>& localTransforms) const
+	{
+		localTransforms.resize(m_boneCount);
+
+		const Lanes one = setLanes(1.0f);
+		const Lanes two = setLanes(2.0f);
+		const Lanes zero = setLanes(0.0f);
+		float matrices[4 * 16];
+
+		for (size_t group = 0; group < m_stride; group += 4)
+		{
+			auto load = [&](Stream const& stream) { return loadLanes(getStream(stream) + group); };
+
+			// Interpolate the translation and scale keys
+			Lanes translationFactor = load(TranslationFactor);
+			Lanes tx = lerpLanes(load(TranslationStartX), load(TranslationEndX), translationFactor);
+			Lanes ty = lerpLanes(load(TranslationStartY), load(TranslationEndY), translationFactor);
+			Lanes tz = lerpLanes(load(TranslationStartZ), load(TranslationEndZ), translationFactor);
+
+			Lanes scaleFactor = load(ScaleFactor);
+			Lanes sx = lerpLanes(load(ScaleStartX), load(ScaleEndX), scaleFactor);
+			Lanes sy = lerpLanes(load(ScaleStartY), load(ScaleEndY), scaleFactor);
+			Lanes sz = lerpLanes(load(ScaleStartZ), load(ScaleEndZ), scaleFactor);
+
+			// Blend the rotations along the shortest arc, then normalize them
+			Lanes ax = load(RotationStartX);
+			Lanes ay = load(RotationStartY);
+			Lanes az = load(RotationStartZ);
+			Lanes aw = load(RotationStartW);
+			Lanes bx = load(RotationEndX);
+			Lanes by = load(RotationEndY);
+			Lanes bz = load(RotationEndZ);
+			Lanes bw = load(RotationEndW);
+			Lanes dot = addLanes(addLanes(multiplyLanes(ax, bx), multiplyLanes(ay, by)), addLanes(multiplyLanes(az, bz), multiplyLanes(aw, bw)));
+			bx = flipWhereNegative(bx, dot);
+			by = flipWhereNegative(by, dot);
+			bz = flipWhereNegative(bz, dot);
+			bw = flipWhereNegative(bw, dot);
+
+			Lanes rotationFactor = load(RotationFactor);
+			Lanes x = lerpLanes(ax, bx, rotationFactor);
+			Lanes y = lerpLanes(ay, by, rotationFactor);
+			Lanes z = lerpLanes(az, bz, rotationFactor);
+			Lanes w = lerpLanes(aw, bw, rotationFactor);
+			Lanes length = sqrtLanes(addLanes(addLanes(multiplyLanes(x, x), multiplyLanes(y, y)), addLanes(multiplyLanes(z, z), multiplyLanes(w, w))));
+			x = divideLanes(x, length);
+			y = divideLanes(y, length);
+			z = divideLanes(z, length);
+			w = divideLanes(w, length);
+
+			// Build the columns of translate * rotate * scale
+			Lanes xx = multiplyLanes(x, x);
+			Lanes yy = multiplyLanes(y, y);
+			Lanes zz = multiplyLanes(z, z);
+			Lanes xy = multiplyLanes(x, y);
+			Lanes xz = multiplyLanes(x, z);
+			Lanes yz = multiplyLanes(y, z);
+			Lanes wx = multiplyLanes(w, x);
+			Lanes wy = multiplyLanes(w, y);
+			Lanes wz = multiplyLanes(w, z);
+
+			storeColumns(matrices, 0,
+				multiplyLanes(subtractLanes(one, multiplyLanes(two, addLanes(yy, zz))), sx),
+				multiplyLanes(multiplyLanes(two, addLanes(xy, wz)), sx),
+				multiplyLanes(multiplyLanes(two, subtractLanes(xz, wy)), sx),
+				zero);
+			storeColumns(matrices, 1,
+				multiplyLanes(multiplyLanes(two, subtractLanes(xy, wz)), sy),
+				multiplyLanes(subtractLanes(one, multiplyLanes(two, addLanes(xx, zz))), sy),
+				multiplyLanes(multiplyLanes(two, addLanes(yz, wx)), sy),
+				zero);
+			storeColumns(matrices, 2,
+				multiplyLanes(multiplyLanes(two, addLanes(xz, wy)), sz),
+				multiplyLanes(multiplyLanes(two, subtractLanes(yz, wx)), sz),
+				multiplyLanes(subtractLanes(one, multiplyLanes(two, addLanes(xx, yy))), sz),
+				zero);
+			storeColumns(matrices, 3, tx, ty, tz, one);
+
+			size_t bonesInGroup = std::min(static_cast<size_t>(4), m_boneCount - group);
+			memcpy(&localTransforms[group][0][0], matrices, bonesInGroup * sizeof(glm::mat4));
+		}
+	}
+
+}
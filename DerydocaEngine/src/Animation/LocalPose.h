@@ -0,0 +1,64 @@
+#pragma once
+#include <glm/mat4x4.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/vec3.hpp>
+#include <vector>
+
+namespace DerydocaEngine::Animation {
+
+	/*
+	Local transforms of a skeleton's bones while a pose is being sampled, held as the two keys each
+	track falls between. Every component is stored in its own array, so interpolating the keys and
+	building the bone matrices runs over four bones at a time.
+	*/
+	class LocalPose
+	{
+	public:
+		LocalPose();
+
+		/*
+		Sizes the pose for a number of bones, leaving every bone at the identity transform.
+
+		@param boneCount Number of bones in the pose
+		*/
+		void resize(size_t const& boneCount);
+
+		void setTranslation(size_t const& bone, glm::vec3 const& start, glm::vec3 const& end, float const& factor);
+		void setRotation(size_t const& bone, glm::quat const& start, glm::quat const& end, float const& factor);
+		void setScale(size_t const& bone, glm::vec3 const& start, glm::vec3 const& end, float const& factor);
+
+		/*
+		Interpolates the keys of every bone and builds the translate * rotate * scale matrix of each.
+		Rotations are blended with a normalized lerp, which is indistinguishable from a slerp between
+		neighbouring keys.
+
+		@param localTransforms Receives a matrix per bone, relative to its parent
+		*/
+		void evaluate(std::vector<glm::mat4>& localTransforms) const;
+
+		size_t getBoneCount() const { return m_boneCount; }
+	private:
+		enum Stream
+		{
+			TranslationStartX, TranslationStartY, TranslationStartZ,
+			TranslationEndX, TranslationEndY, TranslationEndZ,
+			TranslationFactor,
+			RotationStartX, RotationStartY, RotationStartZ, RotationStartW,
+			RotationEndX, RotationEndY, RotationEndZ, RotationEndW,
+			RotationFactor,
+			ScaleStartX, ScaleStartY, ScaleStartZ,
+			ScaleEndX, ScaleEndY, ScaleEndZ,
+			ScaleFactor,
+			StreamCount
+		};
+
+		float* getStream(Stream const& stream) { return m_streams.data() + stream * m_stride; }
+		const float* getStream(Stream const& stream) const { return m_streams.data() + stream * m_stride; }
+
+		size_t m_boneCount;
+		// Bones in each stream, rounded up to a whole number of groups of four
+		size_t m_stride;
+		std::vector<float> m_streams;
+	};
+
+}
@@ -0,0 +1,15 @@
+#include "EnginePch.h"
+#include "Animation\PaletteBlend.h"
+
+namespace DerydocaEngine::Animation::PaletteBlend
+{
+
+	void lerp(const glm::mat4* source, const glm::mat4* target, float const& weight, size_t const& boneCount, glm::mat4* result)
+	{
+		for (size_t i = 0; i < boneCount; i++)
+		{
+			result[i] = source[i] * (1.0f - weight) + target[i] * weight;
+		}
+	}
+
+}
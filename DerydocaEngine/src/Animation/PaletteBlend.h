@@ -0,0 +1,19 @@
+#pragma once
+#include <glm/mat4x4.hpp>
+
+namespace DerydocaEngine::Animation::PaletteBlend
+{
+
+	/*
+	Blends two bone palettes. Skinning matrices are blended component by component instead of being
+	decomposed, which is close enough between poses that are only a few frames apart.
+
+	@param source Palette at a weight of 0
+	@param target Palette at a weight of 1
+	@param weight How far to blend towards the target, from 0 to 1
+	@param boneCount Number of matrices in each palette
+	@param result Receives the blended palette, which may be the source or the target
+	*/
+	void lerp(const glm::mat4* source, const glm::mat4* target, float const& weight, size_t const& boneCount, glm::mat4* result);
+
+}
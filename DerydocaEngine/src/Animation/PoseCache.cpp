@@ -0,0 +1,101 @@
+#include "EnginePch.h"
+#include "Animation\PoseCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include "Animation\AnimationData.h"
+#include "Animation\PaletteBlend.h"
+#include "Animation\Skeleton.h"
+
+namespace DerydocaEngine::Animation
+{
+
+	PoseCache::PoseCache() :
+		m_duration(0.0),
+		m_sampleRate(0.0f),
+		m_boneCount(0),
+		m_frameCount(0),
+		m_interpolate(false),
+		m_palettes()
+	{
+	}
+
+	bool PoseCache::build(AnimationData const& animation, std::shared_ptr<Skeleton> const& skeleton, PoseCacheSettings const& settings)
+	{
+		clear();
+
+		size_t boneCount = skeleton ? skeleton->getNumBones() : 0;
+		if (boneCount == 0 || settings.sampleRate <= 0.0f)
+		{
+			return false;
+		}
+
+		// The loop is split into equal steps, so the last frame blends back into the first one
+		double duration = std::max(animation.getDuration(), 0.0);
+		size_t frameCount = std::max(static_cast<size_t>(std::ceil(duration * settings.sampleRate)), static_cast<size_t>(1));
+		size_t maxFrameCount = settings.maxKilobytes * 1024 / (boneCount * sizeof(glm::mat4));
+		if (frameCount > maxFrameCount)
+		{
+			frameCount = maxFrameCount;
+			if (frameCount == 0 || frameCount < duration * settings.minSampleRate)
+			{
+				return false;
+			}
+		}
+
+		m_palettes.resize(frameCount * boneCount);
+		AnimationCursor cursor;
+		std::vector<glm::mat4> palette(boneCount);
+		for (size_t frame = 0; frame < frameCount; frame++)
+		{
+			animation.samplePose(static_cast<float>(duration * frame / frameCount), cursor, palette, skeleton);
+			std::copy(palette.begin(), palette.begin() + boneCount, m_palettes.begin() + frame * boneCount);
+		}
+
+		m_duration = duration;
+		m_sampleRate = duration > 0.0 ? static_cast<float>(frameCount / duration) : 0.0f;
+		m_boneCount = boneCount;
+		m_frameCount = frameCount;
+		m_interpolate = settings.interpolate;
+		return true;
+	}
+
+	void PoseCache::clear()
+	{
+		std::vector<glm::mat4>().swap(m_palettes);
+		m_frameCount = 0;
+	}
+
+	void PoseCache::loadPose(float const& time, std::vector<glm::mat4>& boneTransforms) const
+	{
+		if (m_palettes.empty())
+		{
+			return;
+		}
+
+		// Wrap the time around the loop the same way sampling the animation does
+		double frame = 0.0;
+		if (m_duration > 0.0)
+		{
+			double loopTime = fmod(time, m_duration);
+			if (loopTime < 0.0)
+			{
+				loopTime += m_duration;
+			}
+			frame = loopTime * m_frameCount / m_duration;
+		}
+
+		size_t frameIndex = std::min(static_cast<size_t>(frame), m_frameCount - 1);
+		auto first = m_palettes.begin() + frameIndex * m_boneCount;
+		boneTransforms.resize(m_boneCount);
+		if (!m_interpolate || m_frameCount == 1)
+		{
+			std::copy(first, first + m_boneCount, boneTransforms.begin());
+			return;
+		}
+
+		auto second = m_palettes.begin() + ((frameIndex + 1) % m_frameCount) * m_boneCount;
+		PaletteBlend::lerp(&*first, &*second, static_cast<float>(frame - frameIndex), m_boneCount, boneTransforms.data());
+	}
+
+}
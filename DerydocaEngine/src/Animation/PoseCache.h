@@ -0,0 +1,76 @@
+#pragma once
+#include <glm/mat4x4.hpp>
+#include <memory>
+#include <vector>
+
+namespace DerydocaEngine::Animation
+{
+	class AnimationData;
+	class Skeleton;
+}
+
+namespace DerydocaEngine::Animation
+{
+
+	/* How an animation is baked into a pose cache */
+	struct PoseCacheSettings
+	{
+		bool enabled = false;
+		// Poses per second of the animation
+		float sampleRate = 30.0f;
+		// Largest table of a single animation, which lowers the sample rate to fit
+		size_t maxKilobytes = 4096;
+		// Rate below which the table is too coarse to use, so the animation is sampled live instead
+		float minSampleRate = 10.0f;
+		// Blend the two entries around the playhead instead of taking the one before it
+		bool interpolate = true;
+	};
+
+	/*
+	Table of an animation's bone palettes for one skeleton, sampled at a fixed rate over the whole
+	loop. Every instance playing the animation on that skeleton reads the same table, so a crowd
+	playing the same loop looks its poses up instead of sampling each of them again.
+	*/
+	class PoseCache
+	{
+	public:
+		PoseCache();
+
+		/*
+		Samples an animation over its duration into the table, replacing what was in it.
+
+		@param animation Animation to sample
+		@param skeleton Skeleton to pose
+		@param settings Sample rate and size limit of the table
+		@return True if the table was built, or false if it would not fit at the lowest rate allowed
+		*/
+		bool build(AnimationData const& animation, std::shared_ptr<Skeleton> const& skeleton, PoseCacheSettings const& settings);
+
+		/* Empties the table, so every instance samples the animation live */
+		void clear();
+
+		/* Whether the table holds no poses, either because it was not built or did not fit */
+		bool isEmpty() const { return m_palettes.empty(); }
+
+		/*
+		Looks up the pose at a point in the animation.
+
+		@param time Time in seconds, which wraps around the duration of the animation
+		@param boneTransforms Receives the skinning matrix of each bone, indexed by bone ID
+		*/
+		void loadPose(float const& time, std::vector<glm::mat4>& boneTransforms) const;
+
+		float getSampleRate() const { return m_sampleRate; }
+		size_t getFrameCount() const { return m_frameCount; }
+		size_t getSize() const { return m_palettes.size() * sizeof(glm::mat4); }
+	private:
+		double m_duration;
+		float m_sampleRate;
+		size_t m_boneCount;
+		size_t m_frameCount;
+		bool m_interpolate;
+		// Palette of every frame one after another, each one bone count long
+		std::vector<glm::mat4> m_palettes;
+	};
+
+}
@@ -2,73 +2,64 @@
 #include "Animation\Skeleton.h"
 
 namespace DerydocaEngine::Animation {
+
 	Skeleton::Skeleton() :
-		m_rootTransform(),
-		m_rootBone()
+		m_parentIndices(),
+		m_inverseBindTransforms(),
+		m_restTransforms(),
+		m_nameHashes(),
+		m_names(),
+		m_boneIdsByHash(),
+		m_rootTransform()
 	{
 	}
 
-	Skeleton::Skeleton(const std::shared_ptr<Bone>& rootBone, const glm::mat4& rootTransform) :
-		m_rootTransform(rootTransform),
-		m_rootBone(rootBone)
+	Skeleton::Skeleton(const glm::mat4& rootTransform) :
+		m_parentIndices(),
+		m_inverseBindTransforms(),
+		m_restTransforms(),
+		m_nameHashes(),
+		m_names(),
+		m_boneIdsByHash(),
+		m_rootTransform(rootTransform)
 	{
-		RebuildBoneMaps();
 	}
 
-	const std::shared_ptr<Bone> Skeleton::getBone(unsigned int boneId) const
+	unsigned int Skeleton::addBone(const std::string& name, const int parentIndex, const glm::mat4& inverseBindTransform, const glm::mat4& restTransform)
 	{
-		auto it = m_boneIdMap.find(boneId);
+		assert(parentIndex < (int)m_parentIndices.size());
 
-		return it != m_boneIdMap.end() ? (*it).second : nullptr;
-	}
+		unsigned int boneId = (unsigned int)m_parentIndices.size();
+		size_t nameHash = hashBoneName(name);
 
-	const std::shared_ptr<Bone> Skeleton::getBone(const std::string & boneName) const
-	{
-		return getBone(getBoneID(boneName));
+		m_parentIndices.push_back(parentIndex);
+		m_inverseBindTransforms.push_back(inverseBindTransform);
+		m_restTransforms.push_back(restTransform);
+		m_nameHashes.push_back(nameHash);
+		m_names.push_back(name);
+		m_boneIdsByHash.emplace(nameHash, boneId);
+
+		return boneId;
 	}
 
 	unsigned int Skeleton::getBoneID(const std::string& boneName) const
 	{
-		// Find the element
-		auto it = m_boneNameToIDMap.find(boneName);
-
-		// If it exists, return the bone ID
-		if (it != m_boneNameToIDMap.end())
+		auto range = m_boneIdsByHash.equal_range(hashBoneName(boneName));
+		for (auto it = range.first; it != range.second; it++)
 		{
-			return it->second;
+			if (m_names[it->second] == boneName)
+			{
+				return it->second;
+			}
 		}
 
 		// If the ID was not found, return -1 which will resolve to max unsigned int value
 		return -1;
 	}
 
-	void Skeleton::AddBonesToMap(const std::shared_ptr<Bone>& bone)
-	{
-		m_boneNameToIDMap[bone->getName()] = bone->getID();
-		for (unsigned int i = 0; i < bone->getNumChildren(); i++)
-		{
-			AddBonesToMap(bone->getChildBone(i));
-		}
-	}
-
-	void Skeleton::AddBonesToIdMap(const std::shared_ptr<Bone> & bone)
-	{
-		m_boneIdMap[bone->getID()] = bone;
-		for (unsigned int i = 0; i < bone->getNumChildren(); i++)
-		{
-			AddBonesToIdMap(bone->getChildBone(i));
-		}
-	}
-
-	void Skeleton::RebuildBoneMaps()
+	size_t Skeleton::hashBoneName(const std::string& boneName)
 	{
-		// Load the bone index map
-		m_boneNameToIDMap.clear();
-		AddBonesToMap(m_rootBone);
-
-		// Load the bone ID map
-		m_boneIdMap.clear();
-		AddBonesToIdMap(m_rootBone);
+		return std::hash<std::string>()(boneName);
 	}
 
 }
@@ -1,32 +1,52 @@
 #pragma once
 #include <glm/mat4x4.hpp>
-#include <map>
+#include <string>
+#include <unordered_map>
 #include <vector>
-#include "Animation\Bone.h"
 
 namespace DerydocaEngine::Animation {
 
+	/*
+	Bones of a skeleton held in arrays indexed by bone ID, where every parent comes before its
+	children. Posing a skeleton walks the arrays once from start to end, with each bone's parent
+	already resolved.
+	*/
 	class Skeleton {
 	public:
 		Skeleton();
-		Skeleton(const std::shared_ptr<Bone>& rootBone, const glm::mat4& rootTransform);
+		Skeleton(const glm::mat4& rootTransform);
+
+		/*
+		Adds a bone to the end of the skeleton.
+
+		@param name Name of the bone, which animation channels are matched against
+		@param parentIndex ID of the bone's parent, which must already be in the skeleton, or -1 for the root
+		@param inverseBindTransform Transform from the model into the bone's space when the mesh was bound to it
+		@param restTransform Transform of the bone relative to its parent when it is not animated
+		@return ID of the bone
+		*/
+		unsigned int addBone(const std::string& name, const int parentIndex, const glm::mat4& inverseBindTransform, const glm::mat4& restTransform);
 
 		const glm::mat4& getGlobalInverseTransform() const { return m_rootTransform; }
-		std::string getName() const { return m_rootBone->getName(); }
-		size_t getNumBones() const { return  m_rootBone->getTotalBoneCount(); }
-		const std::shared_ptr<Bone> getRootBone() const { return m_rootBone; };
-		const std::shared_ptr<Bone> getBone(unsigned int boneIndex) const;
-		const std::shared_ptr<Bone> getBone(const std::string& boneName) const;
+		std::string getName() const { return m_names.empty() ? std::string() : m_names[0]; }
+		size_t getNumBones() const { return m_parentIndices.size(); }
+		const std::string& getBoneName(unsigned int boneId) const { return m_names[boneId]; }
 		unsigned int getBoneID(const std::string& boneName) const;
+		const std::vector<int>& getParentIndices() const { return m_parentIndices; }
+		const std::vector<glm::mat4>& getInverseBindTransforms() const { return m_inverseBindTransforms; }
+		const std::vector<glm::mat4>& getRestTransforms() const { return m_restTransforms; }
+		const std::vector<size_t>& getNameHashes() const { return m_nameHashes; }
+
+		static size_t hashBoneName(const std::string& boneName);
 	private:
-		std::map<std::string, unsigned int> m_boneNameToIDMap;
-		std::map<unsigned int, std::shared_ptr<Bone>> m_boneIdMap;
-		std::shared_ptr<Bone> m_rootBone;
+		std::vector<int> m_parentIndices;
+		std::vector<glm::mat4> m_inverseBindTransforms;
+		std::vector<glm::mat4> m_restTransforms;
+		std::vector<size_t> m_nameHashes;
+		std::vector<std::string> m_names;
+		// Bone IDs by name hash, where names that share a hash are told apart by comparing the names
+		std::unordered_multimap<size_t, unsigned int> m_boneIdsByHash;
 		glm::mat4 m_rootTransform;
-
-		void AddBonesToMap(const std::shared_ptr<Bone>& bone);
-		void AddBonesToIdMap(const std::shared_ptr<Bone>& bone);
-		void RebuildBoneMaps();
 	};
 
 }
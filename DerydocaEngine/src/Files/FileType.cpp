@@ -40,7 +40,7 @@ namespace DerydocaEngine::Files
 		{
 			return RasterFontType;
 		}
-		else if (extension == "txt" || extension == "fs" || extension == "gs" || extension == "tes" || extension == "tcs")
+		else if (extension == "txt" || extension == "glsl" || extension == "fs" || extension == "gs" || extension == "tes" || extension == "tcs")
 		{
 			return IgnoredFileType;
 		}
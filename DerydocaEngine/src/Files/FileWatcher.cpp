@@ -0,0 +1,370 @@
+#include "EnginePch.h"
+#include "Files\FileWatcher.h"
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace DerydocaEngine::Files
+{
+
+	namespace fs = boost::filesystem;
+
+	// How long the watcher thread sleeps when nothing changed, before checking for new directories
+	// and whether it has to stop
+	static const int IDLE_WAIT_MILLISECONDS = 250;
+
+	FileWatcher::FileWatcher(bool const& forcePolling) :
+		m_mutex(),
+		m_wakeUp(),
+		m_thread(),
+		m_stopping(false),
+		m_polling(forcePolling),
+		m_coalescingDelay(100),
+		m_pollingInterval(1000),
+		m_listeners(),
+		m_pendingDirectories(),
+		m_directories(),
+		m_changedFiles(),
+		m_fileStamps()
+#ifdef __linux__
+		,
+		m_inotifyDescriptor(-1),
+		m_watchedDirectories()
+#endif
+	{
+#ifdef __linux__
+		if (!m_polling)
+		{
+			m_inotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+			if (m_inotifyDescriptor < 0)
+			{
+				std::cout << "Unable to initialize inotify (" << strerror(errno) << "), polling files for changes instead.\n";
+				m_polling = true;
+			}
+		}
+#else
+		m_polling = true;
+#endif
+	}
+
+	FileWatcher::~FileWatcher()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stopping = true;
+		}
+		m_wakeUp.notify_all();
+
+		if (m_thread.joinable())
+		{
+			m_thread.join();
+		}
+
+#ifdef __linux__
+		if (m_inotifyDescriptor >= 0)
+		{
+			close(m_inotifyDescriptor);
+		}
+#endif
+	}
+
+	void FileWatcher::watchDirectory(fs::path const& directory)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_pendingDirectories.push_back(fs::absolute(directory).lexically_normal());
+			if (!m_thread.joinable())
+			{
+				m_thread = std::thread(&FileWatcher::runWatcher, this);
+			}
+		}
+		m_wakeUp.notify_all();
+	}
+
+	void FileWatcher::addListener(Listener const& listener)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_listeners.push_back(listener);
+	}
+
+	void FileWatcher::runWatcher()
+	{
+		while (true)
+		{
+			std::vector<fs::path> directories;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				if (m_stopping)
+				{
+					return;
+				}
+				directories.swap(m_pendingDirectories);
+			}
+
+			for (auto const& directory : directories)
+			{
+				addDirectory(directory);
+			}
+
+			// Once something changed, only wait for the coalescing delay so the batch is handed over
+			// as soon as the burst of changes is over
+			bool hasChanges = !m_changedFiles.empty();
+			int timeout = hasChanges ? m_coalescingDelay : (m_polling ? m_pollingInterval : IDLE_WAIT_MILLISECONDS);
+			if (!waitForChanges(timeout) && hasChanges)
+			{
+				dispatchChanges();
+			}
+		}
+	}
+
+	bool FileWatcher::waitForChanges(int const& timeoutMilliseconds)
+	{
+#ifdef __linux__
+		if (!m_polling)
+		{
+			return readInotifyEvents(timeoutMilliseconds);
+		}
+#endif
+		return pollChanges(timeoutMilliseconds);
+	}
+
+	void FileWatcher::addDirectory(fs::path const& directory)
+	{
+		m_directories.push_back(directory);
+
+#ifdef __linux__
+		if (!m_polling && !addInotifyWatches(directory))
+		{
+			startPolling();
+			return;
+		}
+#endif
+
+		// Record what the files look like now so only later changes are reported
+		if (m_polling)
+		{
+			scanDirectory(directory, m_fileStamps);
+		}
+	}
+
+	void FileWatcher::dispatchChanges()
+	{
+		std::vector<std::string> changedFiles(m_changedFiles.begin(), m_changedFiles.end());
+		m_changedFiles.clear();
+
+		std::vector<Listener> listeners;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			listeners = m_listeners;
+		}
+
+		for (auto const& listener : listeners)
+		{
+			listener(changedFiles);
+		}
+	}
+
+	void FileWatcher::startPolling()
+	{
+#ifdef __linux__
+		if (m_inotifyDescriptor >= 0)
+		{
+			close(m_inotifyDescriptor);
+			m_inotifyDescriptor = -1;
+		}
+		m_watchedDirectories.clear();
+#endif
+
+		m_polling = true;
+		m_fileStamps.clear();
+		for (auto const& directory : m_directories)
+		{
+			scanDirectory(directory, m_fileStamps);
+		}
+	}
+
+	void FileWatcher::scanDirectory(fs::path const& directory, std::map<std::string, FileStamp>& stamps)
+	{
+		boost::system::error_code error;
+		for (fs::recursive_directory_iterator it(directory, error), end; !error && it != end; it.increment(error))
+		{
+			boost::system::error_code fileError;
+			if (!fs::is_regular_file(it->status(fileError)))
+			{
+				continue;
+			}
+
+			FileStamp stamp;
+			stamp.writeTime = fs::last_write_time(it->path(), fileError);
+			stamp.size = fs::file_size(it->path(), fileError);
+			if (!fileError)
+			{
+				stamps[it->path().string()] = stamp;
+			}
+		}
+	}
+
+	bool FileWatcher::pollChanges(int const& timeoutMilliseconds)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wakeUp.wait_for(lock, std::chrono::milliseconds(timeoutMilliseconds), [this]() {
+				return m_stopping || !m_pendingDirectories.empty();
+			});
+			if (m_stopping)
+			{
+				return false;
+			}
+		}
+
+		std::map<std::string, FileStamp> stamps;
+		for (auto const& directory : m_directories)
+		{
+			scanDirectory(directory, stamps);
+		}
+
+		// Files that are new, were written to, or are gone
+		bool changed = false;
+		for (auto const& stamp : stamps)
+		{
+			auto previousStamp = m_fileStamps.find(stamp.first);
+			if (previousStamp == m_fileStamps.end() ||
+				previousStamp->second.writeTime != stamp.second.writeTime ||
+				previousStamp->second.size != stamp.second.size)
+			{
+				m_changedFiles.insert(stamp.first);
+				changed = true;
+			}
+		}
+		for (auto const& previousStamp : m_fileStamps)
+		{
+			if (stamps.find(previousStamp.first) == stamps.end())
+			{
+				m_changedFiles.insert(previousStamp.first);
+				changed = true;
+			}
+		}
+
+		m_fileStamps.swap(stamps);
+		return changed;
+	}
+
+#ifdef __linux__
+
+	bool FileWatcher::addInotifyWatches(fs::path const& directory)
+	{
+		// inotify is not recursive, so every directory below the watched one needs its own watch
+		std::vector<fs::path> directories = { directory };
+		boost::system::error_code error;
+		for (fs::recursive_directory_iterator it(directory, error), end; !error && it != end; it.increment(error))
+		{
+			boost::system::error_code statusError;
+			if (fs::is_directory(it->status(statusError)))
+			{
+				directories.push_back(it->path());
+			}
+		}
+
+		const uint32_t eventMask = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+		for (auto const& watchedDirectory : directories)
+		{
+			int watchDescriptor = inotify_add_watch(m_inotifyDescriptor, watchedDirectory.string().c_str(), eventMask);
+			if (watchDescriptor < 0)
+			{
+				// The directory may have been removed since it was found
+				if (errno == ENOENT)
+				{
+					continue;
+				}
+
+				std::cout << "Unable to watch " << watchedDirectory << " with inotify (" << strerror(errno) << "), polling files for changes instead.\n";
+				return false;
+			}
+			m_watchedDirectories[watchDescriptor] = watchedDirectory;
+		}
+
+		return true;
+	}
+
+	bool FileWatcher::readInotifyEvents(int const& timeoutMilliseconds)
+	{
+		pollfd descriptor = { m_inotifyDescriptor, POLLIN, 0 };
+		if (poll(&descriptor, 1, timeoutMilliseconds) <= 0)
+		{
+			return false;
+		}
+
+		bool changed = false;
+		alignas(inotify_event) char buffer[4096];
+		while (true)
+		{
+			// The descriptor is non-blocking, so this fails once every queued event was read
+			ssize_t length = read(m_inotifyDescriptor, buffer, sizeof(buffer));
+			if (length <= 0)
+			{
+				break;
+			}
+
+			for (char* position = buffer; position < buffer + length;)
+			{
+				const inotify_event* event = reinterpret_cast<const inotify_event*>(position);
+				position += sizeof(inotify_event) + event->len;
+
+				if (event->mask & IN_Q_OVERFLOW)
+				{
+					std::cout << "The inotify event queue overflowed, some file changes were missed.\n";
+					continue;
+				}
+
+				if (event->mask & IN_IGNORED)
+				{
+					m_watchedDirectories.erase(event->wd);
+					continue;
+				}
+
+				auto watchedDirectory = m_watchedDirectories.find(event->wd);
+				if (watchedDirectory == m_watchedDirectories.end() || event->len == 0)
+				{
+					continue;
+				}
+
+				fs::path path = watchedDirectory->second / event->name;
+				if (!(event->mask & IN_ISDIR))
+				{
+					m_changedFiles.insert(path.string());
+					changed = true;
+					continue;
+				}
+
+				// New directories need watches too, and files may have been written to them before
+				// the watch was added
+				if (event->mask & (IN_CREATE | IN_MOVED_TO))
+				{
+					if (!addInotifyWatches(path))
+					{
+						startPolling();
+						return true;
+					}
+
+					std::map<std::string, FileStamp> stamps;
+					scanDirectory(path, stamps);
+					for (auto const& stamp : stamps)
+					{
+						m_changedFiles.insert(stamp.first);
+					}
+					changed = true;
+				}
+			}
+		}
+
+		return changed;
+	}
+
+#endif
+
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+namespace DerydocaEngine::Files
+{
+
+	/*
+	Watches directory trees for files that are created, modified, moved or deleted. Changes are
+	collected on a background thread and handed to the listeners once no new change has arrived
+	for the coalescing delay, so an editor saving a file in several steps or a folder of assets
+	being copied in results in a single batch of changed files.
+
+	Uses inotify where it is available. Everywhere else, or when inotify runs out of watches, the
+	files are polled at a fixed interval on the background thread instead.
+	*/
+	class FileWatcher
+	{
+	public:
+		/* Receives the absolute paths of every file that changed in a batch, on the watcher thread */
+		using Listener = std::function<void(std::vector<std::string> const& changedFiles)>;
+
+		/*
+		@param forcePolling Whether to poll the files even if inotify is available
+		*/
+		FileWatcher(bool const& forcePolling = false);
+		~FileWatcher();
+
+		/*
+		Starts watching a directory and everything below it. The watcher thread is started by
+		the first directory.
+
+		@param directory Directory to watch
+		*/
+		void watchDirectory(boost::filesystem::path const& directory);
+
+		/*
+		Adds a function that is called with every batch of changes. Listeners are called on the
+		watcher thread, so they must hand anything that touches live objects to another thread.
+
+		@param listener Function to call
+		*/
+		void addListener(Listener const& listener);
+
+		/*
+		Sets how long the watcher waits for more changes before handing a batch to the listeners.
+		Only has an effect before the first directory is watched.
+
+		@param milliseconds Coalescing delay
+		*/
+		void setCoalescingDelay(int const& milliseconds) { m_coalescingDelay = milliseconds; }
+
+		/*
+		Sets how often files are polled when inotify is not used. Only has an effect before the
+		first directory is watched.
+
+		@param milliseconds Polling interval
+		*/
+		void setPollingInterval(int const& milliseconds) { m_pollingInterval = milliseconds; }
+
+		/* Gets whether the files are polled rather than watched with inotify */
+		bool isPolling() const { return m_polling; }
+
+		void operator=(FileWatcher const&) = delete;
+	private:
+		/* What a file looked like when it was last polled */
+		struct FileStamp
+		{
+			std::time_t writeTime;
+			uintmax_t size;
+		};
+
+		FileWatcher(FileWatcher const&);
+
+		void runWatcher();
+		bool waitForChanges(int const& timeoutMilliseconds);
+		void addDirectory(boost::filesystem::path const& directory);
+		void dispatchChanges();
+		void startPolling();
+		void scanDirectory(boost::filesystem::path const& directory, std::map<std::string, FileStamp>& stamps);
+		bool pollChanges(int const& timeoutMilliseconds);
+#ifdef __linux__
+		bool addInotifyWatches(boost::filesystem::path const& directory);
+		bool readInotifyEvents(int const& timeoutMilliseconds);
+#endif
+
+		std::mutex m_mutex;
+		std::condition_variable m_wakeUp;
+		std::thread m_thread;
+		bool m_stopping;
+		std::atomic<bool> m_polling;
+		int m_coalescingDelay;
+		int m_pollingInterval;
+		std::vector<Listener> m_listeners;
+		std::vector<boost::filesystem::path> m_pendingDirectories;
+		std::vector<boost::filesystem::path> m_directories;
+		std::set<std::string> m_changedFiles;
+		std::map<std::string, FileStamp> m_fileStamps;
+#ifdef __linux__
+		int m_inotifyDescriptor;
+		std::map<int, boost::filesystem::path> m_watchedDirectories;
+#endif
+	};
+
+}
@@ -0,0 +1,144 @@
+#include "EnginePch.h"
+#include "Files\MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace DerydocaEngine::Files
+{
+
+	MappedFile::MappedFile() :
+		m_data(nullptr),
+		m_size(0),
+#ifdef _WIN32
+		m_fileHandle(INVALID_HANDLE_VALUE),
+		m_mappingHandle(nullptr)
+#else
+		m_fileDescriptor(-1)
+#endif
+	{
+	}
+
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+#ifdef _WIN32
+
+	bool MappedFile::open(std::string const& filePath)
+	{
+		close();
+
+		m_fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (m_fileHandle == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(m_fileHandle, &fileSize) || fileSize.QuadPart == 0)
+		{
+			close();
+			return false;
+		}
+
+		m_mappingHandle = CreateFileMappingA(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (m_mappingHandle == nullptr)
+		{
+			close();
+			return false;
+		}
+
+		m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+		if (m_data == nullptr)
+		{
+			close();
+			return false;
+		}
+
+		m_size = static_cast<size_t>(fileSize.QuadPart);
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+		if (m_data != nullptr)
+		{
+			UnmapViewOfFile(m_data);
+			m_data = nullptr;
+		}
+
+		if (m_mappingHandle != nullptr)
+		{
+			CloseHandle(m_mappingHandle);
+			m_mappingHandle = nullptr;
+		}
+
+		if (m_fileHandle != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(m_fileHandle);
+			m_fileHandle = INVALID_HANDLE_VALUE;
+		}
+
+		m_size = 0;
+	}
+
+#else
+
+	bool MappedFile::open(std::string const& filePath)
+	{
+		close();
+
+		m_fileDescriptor = ::open(filePath.c_str(), O_RDONLY);
+		if (m_fileDescriptor < 0)
+		{
+			return false;
+		}
+
+		struct stat fileStatus;
+		if (fstat(m_fileDescriptor, &fileStatus) != 0 || fileStatus.st_size == 0)
+		{
+			close();
+			return false;
+		}
+
+		void* data = mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, m_fileDescriptor, 0);
+		if (data == MAP_FAILED)
+		{
+			close();
+			return false;
+		}
+
+		m_data = static_cast<const uint8_t*>(data);
+		m_size = static_cast<size_t>(fileStatus.st_size);
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+		if (m_data != nullptr)
+		{
+			munmap(const_cast<uint8_t*>(m_data), m_size);
+			m_data = nullptr;
+		}
+
+		if (m_fileDescriptor >= 0)
+		{
+			::close(m_fileDescriptor);
+			m_fileDescriptor = -1;
+		}
+
+		m_size = 0;
+	}
+
+#endif
+
+}
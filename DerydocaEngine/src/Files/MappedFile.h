@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace DerydocaEngine::Files
+{
+
+	/*
+	Maps a file into memory as read only. Pages are loaded by the operating system as they are
+	touched, so the contents can be handed straight to the GPU without reading them into a
+	buffer first. The mapping is released when the object is destroyed.
+	*/
+	class MappedFile
+	{
+	public:
+		MappedFile();
+		~MappedFile();
+
+		/*
+		Maps a file, releasing any file that was previously mapped.
+
+		@param filePath Path of the file to map
+		@return True if the file exists, is not empty and was mapped
+		*/
+		bool open(std::string const& filePath);
+
+		/* Releases the mapping */
+		void close();
+
+		bool isOpen() const { return m_data != nullptr; }
+		const uint8_t* getData() const { return m_data; }
+		size_t getSize() const { return m_size; }
+
+		void operator=(MappedFile const&) = delete;
+	private:
+		MappedFile(MappedFile const&);
+
+		const uint8_t* m_data;
+		size_t m_size;
+#ifdef _WIN32
+		void* m_fileHandle;
+		void* m_mappingHandle;
+#else
+		int m_fileDescriptor;
+#endif
+	};
+
+}
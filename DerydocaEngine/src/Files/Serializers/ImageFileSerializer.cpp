@@ -25,6 +25,64 @@ namespace DerydocaEngine::Files::Serializers {
 	{
 		// Create a material resource type
 		auto r = std::make_shared<Resources::TextureResource>();
+
+		// Textures are only compressed when their meta file asks for a format
+		YAML::Node compressionNode = resourceNode["Compression"];
+		if (compressionNode && compressionNode.IsScalar())
+		{
+			Rendering::TextureCompressionFormat compression;
+			if (Rendering::TextureCompression::stringToFormat(compressionNode.as<std::string>(), compression))
+			{
+				r->setCompression(compression);
+			}
+			else
+			{
+				printf("Unknown texture compression format: %s\n", compressionNode.as<std::string>().c_str());
+			}
+		}
+
+		YAML::Node qualityNode = resourceNode["CompressionQuality"];
+		if (qualityNode && qualityNode.IsScalar())
+		{
+			Rendering::TextureCompressionQuality quality;
+			if (Rendering::TextureCompression::stringToQuality(qualityNode.as<std::string>(), quality))
+			{
+				r->setCompressionQuality(quality);
+			}
+			else
+			{
+				printf("Unknown texture compression quality: %s\n", qualityNode.as<std::string>().c_str());
+			}
+		}
+
+		Rendering::MipSettings mipSettings;
+		YAML::Node mipFilterNode = resourceNode["MipFilter"];
+		if (mipFilterNode && mipFilterNode.IsScalar() &&
+			!Rendering::MipGenerator::stringToFilter(mipFilterNode.as<std::string>(), mipSettings.filter))
+		{
+			printf("Unknown texture mip filter: %s\n", mipFilterNode.as<std::string>().c_str());
+		}
+
+		// Color textures are sRGB unless told otherwise, data textures such as masks have to opt out
+		YAML::Node srgbNode = resourceNode["sRGB"];
+		if (srgbNode && srgbNode.IsScalar())
+		{
+			mipSettings.srgb = srgbNode.as<bool>();
+		}
+
+		YAML::Node normalMapNode = resourceNode["NormalMap"];
+		if (normalMapNode && normalMapNode.IsScalar())
+		{
+			mipSettings.normalMap = normalMapNode.as<bool>();
+		}
+
+		YAML::Node alphaCutoffNode = resourceNode["AlphaCutoff"];
+		if (alphaCutoffNode && alphaCutoffNode.IsScalar())
+		{
+			mipSettings.alphaCutoff = alphaCutoffNode.as<float>();
+		}
+		r->setMipSettings(mipSettings);
+
 		return r;
 	}
 
@@ -79,6 +79,35 @@ namespace DerydocaEngine::Files::Serializers {
 			{
 				r->setSlot(resourceNode["Slot"].as<int>());
 			}
+
+			// Cubemaps are only cooked to a single compressed file when their meta asks for a format
+			YAML::Node compressionNode = resourceNode["Compression"];
+			if (compressionNode && compressionNode.IsScalar())
+			{
+				Rendering::TextureCompressionFormat compression;
+				if (Rendering::TextureCompression::stringToFormat(compressionNode.as<std::string>(), compression))
+				{
+					r->setCompression(compression);
+				}
+				else
+				{
+					printf("Unknown texture compression format: %s\n", compressionNode.as<std::string>().c_str());
+				}
+			}
+
+			YAML::Node qualityNode = resourceNode["CompressionQuality"];
+			if (qualityNode && qualityNode.IsScalar())
+			{
+				Rendering::TextureCompressionQuality quality;
+				if (Rendering::TextureCompression::stringToQuality(qualityNode.as<std::string>(), quality))
+				{
+					r->setCompressionQuality(quality);
+				}
+				else
+				{
+					printf("Unknown texture compression quality: %s\n", qualityNode.as<std::string>().c_str());
+				}
+			}
 			return r;
 		}
 		else
@@ -1,6 +1,8 @@
 #include "EnginePch.h"
 #include "Files\Serializers\MeshFileSerializer.h"
 
+#include <algorithm>
+#include <assimp/config.h>
 #include <assimp/Importer.hpp>
 #include "Helpers\AssimpUtils.h"
 #include "Rendering\Mesh.h"
@@ -10,6 +12,33 @@
 
 namespace DerydocaEngine::Files::Serializers {
 
+	// Post processing steps that change how many meshes a scene has, their order or their bones. The
+	// geometry steps are skipped, along with splitting large meshes, which depends on the vertex count
+	// left once identical vertices are joined.
+	static const unsigned int METADATA_POST_PROCESS_FLAGS = aiProcessPreset_TargetRealtime_MaxQuality & ~(
+		aiProcess_CalcTangentSpace |
+		aiProcess_GenSmoothNormals |
+		aiProcess_JoinIdenticalVertices |
+		aiProcess_ImproveCacheLocality |
+		aiProcess_GenUVCoords |
+		aiProcess_SplitLargeMeshes);
+
+	// Whether a scene imported with the metadata steps could be split into more meshes by a full import
+	static bool hasLargeMeshes(const aiScene* scene)
+	{
+		for (unsigned int i = 0; i < scene->mNumMeshes; i++)
+		{
+			// Joining vertices never adds any, so meshes under both limits are never split
+			if (scene->mMeshes[i]->mNumVertices > AI_SLM_DEFAULT_MAX_VERTICES ||
+				scene->mMeshes[i]->mNumFaces > AI_SLM_DEFAULT_MAX_TRIANGLES)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
 	static Rendering::MeshFlags stringToFlag(std::string const& flagString)
 	{
 		if (flagString == "load_adjacent")
@@ -26,15 +55,29 @@ namespace DerydocaEngine::Files::Serializers {
 	}
 
 	YAML::Node MeshSerializer::generateResourceNodes(std::string const& filePath)
+	{
+		return generateResourceNodes(filePath, false);
+	}
+
+	YAML::Node MeshSerializer::generateResourceNodes(std::string const& filePath, bool const& fullImport)
 	{
 		YAML::Node resources;
 
 		Assimp::Importer importer;
 
-		const aiScene* scene = importer.ReadFile(filePath.c_str(), aiProcessPreset_TargetRealtime_MaxQuality);
-
-		std::map<std::string, std::shared_ptr<Animation::Skeleton>> skeletons;
+		// Only the names and layout of the scene are needed, so skip the expensive geometry processing
+		// unless it could change which meshes are found
+		const aiScene* scene = nullptr;
+		if (!fullImport)
+		{
+			scene = importer.ReadFile(filePath.c_str(), METADATA_POST_PROCESS_FLAGS);
+		}
+		if (scene == nullptr || hasLargeMeshes(scene))
+		{
+			scene = importer.ReadFile(filePath.c_str(), aiProcessPreset_TargetRealtime_MaxQuality);
+		}
 
+		// Skeletons are ordered by name
 		std::map<std::string, boost::uuids::uuid> skeletonIdMap;
 
 		for (unsigned int i = 0; i < scene->mNumMeshes; i++)
@@ -56,26 +99,25 @@ namespace DerydocaEngine::Files::Serializers {
 
 			if (mesh->HasBones())
 			{
-				std::shared_ptr<Animation::Skeleton> skeleton = Helpers::AssimpUtils::getSkeleton(scene, i);
+				std::string skeletonName = Helpers::AssimpUtils::getSkeletonName(scene, i);
 
-				if (skeletons.find(skeleton->getName()) == skeletons.end())
+				if (skeletonIdMap.find(skeletonName) == skeletonIdMap.end())
 				{
-					skeletons.emplace(skeleton->getName(), skeleton);
-					skeletonIdMap.emplace(skeleton->getName(), generateUuid());
+					skeletonIdMap.emplace(skeletonName, generateUuid());
 				}
-				resourceNode["Skeleton"] = skeletonIdMap[skeleton->getName()];
+				resourceNode["Skeleton"] = skeletonIdMap[skeletonName];
 			}
 
 			// Add it to the resource node
 			resources.push_back(resourceNode);
 		}
 
-		for each (auto skeleton in skeletons)
+		for (auto const& skeleton : skeletonIdMap)
 		{
 			YAML::Node skeletonResourceNode;
-			skeletonResourceNode["ID"] = skeletonIdMap[skeleton.second->getName()];
+			skeletonResourceNode["ID"] = skeleton.second;
 			skeletonResourceNode["Type"] = "Skeleton";
-			skeletonResourceNode["Name"] = skeleton.second->getName();
+			skeletonResourceNode["Name"] = skeleton.first;
 		
 			resources.push_back(skeletonResourceNode);
 		}
@@ -128,6 +170,20 @@ namespace DerydocaEngine::Files::Serializers {
 				}
 			}
 
+			// Vertex attributes are compressed unless the mesh opts out
+			YAML::Node vertexCompressionNode = resourceNode["VertexCompression"];
+			if (vertexCompressionNode && vertexCompressionNode.IsScalar())
+			{
+				meshResource->setCompressVertices(vertexCompressionNode.as<bool>());
+			}
+
+			// Octahedral normals are only read correctly by shaders that include vertexDecode.glsl
+			YAML::Node octahedralNormalsNode = resourceNode["OctahedralNormals"];
+			if (octahedralNormalsNode && octahedralNormalsNode.IsScalar())
+			{
+				meshResource->setOctahedralNormals(octahedralNormalsNode.as<bool>());
+			}
+
 			return meshResource;
 		}
 		else if (type == "Skeleton")
@@ -144,6 +200,51 @@ namespace DerydocaEngine::Files::Serializers {
 			animationResource->setName(resourceNode["Name"].as<std::string>());
 			animationResource->setType(Resources::AnimationResourceType);
 
+			// Keys are compressed unless the animation opts out
+			YAML::Node compressionNode = resourceNode["Compression"];
+			if (compressionNode && compressionNode.IsScalar())
+			{
+				animationResource->setCompress(compressionNode.as<bool>());
+			}
+
+			YAML::Node compressionToleranceNode = resourceNode["CompressionTolerance"];
+			if (compressionToleranceNode && compressionToleranceNode.IsScalar())
+			{
+				animationResource->setCompressionTolerance(compressionToleranceNode.as<float>());
+			}
+
+			// Crowds playing the same loop can look their poses up in a table baked when the animation is bound to a skeleton
+			YAML::Node poseCacheNode = resourceNode["PoseCache"];
+			if (poseCacheNode && poseCacheNode.IsScalar())
+			{
+				animationResource->setPoseCache(poseCacheNode.as<bool>());
+			}
+
+			YAML::Node poseCacheRateNode = resourceNode["PoseCacheRate"];
+			if (poseCacheRateNode && poseCacheRateNode.IsScalar())
+			{
+				animationResource->setPoseCacheRate(poseCacheRateNode.as<float>());
+			}
+
+			YAML::Node poseCacheKilobytesNode = resourceNode["PoseCacheKB"];
+			if (poseCacheKilobytesNode && poseCacheKilobytesNode.IsScalar())
+			{
+				animationResource->setPoseCacheKilobytes(static_cast<size_t>(std::max(1, poseCacheKilobytesNode.as<int>())));
+			}
+
+			// Clips that would be too coarse below this rate are sampled live instead of cached
+			YAML::Node poseCacheMinRateNode = resourceNode["PoseCacheMinRate"];
+			if (poseCacheMinRateNode && poseCacheMinRateNode.IsScalar())
+			{
+				animationResource->setPoseCacheMinRate(poseCacheMinRateNode.as<float>());
+			}
+
+			YAML::Node poseCacheInterpolateNode = resourceNode["PoseCacheInterpolate"];
+			if (poseCacheInterpolateNode && poseCacheInterpolateNode.IsScalar())
+			{
+				animationResource->setPoseCacheInterpolate(poseCacheInterpolateNode.as<bool>());
+			}
+
 			return animationResource;
 		}
 
@@ -13,6 +13,17 @@ namespace DerydocaEngine::Files::Serializers {
 		~MeshSerializer() {}
 
 		YAML::Node generateResourceNodes(std::string const& filePath);
+
+		/*
+		Generates the resource nodes of a model file.
+
+		@param filePath Path of the model file
+		@param fullImport Import the file with the same post processing used to load it, instead of
+		only the steps that decide which meshes the file contains. Both give the same nodes.
+
+		@return Resource nodes of every mesh, skeleton and animation in the file
+		*/
+		YAML::Node generateResourceNodes(std::string const& filePath, bool const& fullImport);
 		Files::FileType getFileType();
 		std::shared_ptr<Resources::Resource> loadResourceFromMeta(YAML::Node const& resourceNode);
 
@@ -0,0 +1,94 @@
+#include "EnginePch.h"
+#include "Helpers\AssimpImportCache.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+
+namespace DerydocaEngine::Helpers
+{
+
+	AssimpImportCache::AssimpImportCache() :
+		m_mutex(),
+		m_importers(),
+		m_batchDepth(0),
+		m_parseCount(0),
+		m_requestCount(0),
+		m_totalParseTime(0.0)
+	{
+	}
+
+	AssimpImportCache::~AssimpImportCache()
+	{
+	}
+
+	std::shared_ptr<const aiScene> AssimpImportCache::getScene(std::string const& filePath, unsigned int const& postProcessFlags)
+	{
+		auto key = std::make_pair(boost::filesystem::absolute(filePath).lexically_normal().string(), postProcessFlags);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_requestCount++;
+
+			auto it = m_importers.find(key);
+			if (it != m_importers.end())
+			{
+				// Share ownership of the importer so the scene outlives its eviction
+				return std::shared_ptr<const aiScene>(it->second, it->second->GetScene());
+			}
+		}
+
+		// Parse outside of the lock so unrelated files can be imported at the same time
+		auto parseStartTime = std::chrono::high_resolution_clock::now();
+		auto importer = std::make_shared<Assimp::Importer>();
+		const aiScene* scene = importer->ReadFile(filePath.c_str(), postProcessFlags);
+		std::chrono::duration<double, std::milli> parseTime = std::chrono::high_resolution_clock::now() - parseStartTime;
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_parseCount++;
+		m_totalParseTime += parseTime.count();
+
+		if (scene == nullptr)
+		{
+			std::cout << "Unable to import '" << filePath << "': " << importer->GetErrorString() << "\n";
+			return nullptr;
+		}
+
+		if (m_batchDepth > 0)
+		{
+			// Another thread may have imported the same file in the meantime, in which case its copy is kept
+			auto inserted = m_importers.insert({ key, importer });
+			importer = inserted.first->second;
+		}
+
+		return std::shared_ptr<const aiScene>(importer, importer->GetScene());
+	}
+
+	void AssimpImportCache::beginBatch()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_batchDepth++;
+	}
+
+	void AssimpImportCache::endBatch()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		assert(m_batchDepth > 0);
+		m_batchDepth--;
+
+		// Loading is done, so drop every scene nobody is still holding on to
+		if (m_batchDepth == 0)
+		{
+			m_importers.clear();
+		}
+	}
+
+	void AssimpImportCache::printStatistics() const
+	{
+		printf("Imported %d scenes with Assimp in %.2fms for %d requests (%d served from shared import sessions)\n",
+			m_parseCount,
+			m_totalParseTime,
+			m_requestCount,
+			m_requestCount - m_parseCount);
+	}
+
+}
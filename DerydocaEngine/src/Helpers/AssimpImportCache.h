@@ -0,0 +1,87 @@
+#pragma once
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+struct aiScene;
+
+namespace Assimp
+{
+	class Importer;
+}
+
+namespace DerydocaEngine::Helpers
+{
+
+	/*
+	Shares imported Assimp scenes between every resource that is loaded from the same file. While a
+	loading batch is open, each combination of source file and post processing flags is parsed once
+	and handed to every serializer that asks for it. Scenes are evicted when the outermost batch
+	closes, so imported files are not kept in memory once loading is done.
+	*/
+	class AssimpImportCache
+	{
+	public:
+		/*
+		Keeps imported scenes alive for as long as it exists. Batches can be nested.
+		*/
+		class Batch
+		{
+		public:
+			Batch() { AssimpImportCache::getInstance().beginBatch(); }
+			~Batch() { AssimpImportCache::getInstance().endBatch(); }
+
+			void operator=(Batch const&) = delete;
+		private:
+			Batch(Batch const&);
+		};
+
+		static AssimpImportCache& getInstance()
+		{
+			static AssimpImportCache instance;
+			return instance;
+		}
+
+		/*
+		Gets the scene imported from a file, importing it if it was not imported by the current batch.
+
+		@param filePath Path of the file to import
+		@param postProcessFlags Assimp post processing steps to run on the scene
+
+		@return The imported scene, or null if the file could not be imported. The scene stays valid
+		for as long as the pointer is held, even after it is evicted from the cache.
+		*/
+		std::shared_ptr<const aiScene> getScene(std::string const& filePath, unsigned int const& postProcessFlags);
+
+		void beginBatch();
+		void endBatch();
+
+		/* Gets how many times a file was actually parsed */
+		int getParseCount() const { return m_parseCount; }
+
+		/* Gets how many scenes were requested, including requests served from the cache */
+		int getRequestCount() const { return m_requestCount; }
+
+		double getTotalParseTime() const { return m_totalParseTime; }
+
+		/*
+		Prints how many scenes were requested and how many times a file had to be parsed.
+		*/
+		void printStatistics() const;
+
+		void operator=(AssimpImportCache const&) = delete;
+	private:
+		AssimpImportCache();
+		AssimpImportCache(AssimpImportCache const&);
+		~AssimpImportCache();
+
+		std::mutex m_mutex;
+		std::map<std::pair<std::string, unsigned int>, std::shared_ptr<Assimp::Importer>> m_importers;
+		int m_batchDepth;
+		int m_parseCount;
+		int m_requestCount;
+		double m_totalParseTime;
+	};
+
+}
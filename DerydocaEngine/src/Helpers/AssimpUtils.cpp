@@ -14,24 +14,9 @@ namespace DerydocaEngine::Helpers::AssimpUtils {
 		return (*it).second;
 	}
 
-	std::vector<std::shared_ptr<Animation::Bone>> childrenToBones(const aiMesh*& mesh, aiNode*& boneNode, unsigned int& boneIndex, const std::map<std::string, bool>& skeletonMap)
+	void addChildBones(const aiMesh*& mesh, aiNode*& boneNode, const int parentIndex, const std::map<std::string, bool>& skeletonMap, Animation::Skeleton& skeleton)
 	{
-		// Get the number of child bones so that we only allocate once for the bone vector
-		unsigned int numBones = 0;
-		for (unsigned int i = 0; i < boneNode->mNumChildren; i++)
-		{
-			std::string nodeName = boneNode->mChildren[i]->mName.data;
-			if (isBoneInMap(skeletonMap, nodeName))
-			{
-				numBones++;
-			}
-		};
-
-		// Create the vector of bones
-		std::vector<std::shared_ptr<Animation::Bone>> bones(numBones);
-
-		// Create each individual bone in the vector
-		unsigned int childBoneCount = 0;
+		// Bones are added depth first, so every parent comes before its children
 		for (unsigned int i = 0; i < boneNode->mNumChildren; i++)
 		{
 			std::string nodeName = boneNode->mChildren[i]->mName.data;
@@ -39,18 +24,13 @@ namespace DerydocaEngine::Helpers::AssimpUtils {
 			{
 				aiNode* childNode = boneNode->mChildren[i];
 				aiBone* b = findBone(mesh, childNode->mName);
-				glm::mat4 offset = (b == nullptr) ? aiToGlm(childNode->mTransformation) : aiToGlm(b->mOffsetMatrix);
-				std::shared_ptr<Animation::Bone> childBone = std::make_shared<Animation::Bone>(boneIndex++, childNode->mName.data, offset);
+				glm::mat4 restTransform = aiToGlm(childNode->mTransformation);
+				glm::mat4 inverseBindTransform = (b == nullptr) ? restTransform : aiToGlm(b->mOffsetMatrix);
+				unsigned int boneIndex = skeleton.addBone(nodeName, parentIndex, inverseBindTransform, restTransform);
 
-				const std::vector<std::shared_ptr<Animation::Bone>> childBones = childrenToBones(mesh, childNode, boneIndex, skeletonMap);
-				childBone->setChildBones(childBones);
-
-				bones[childBoneCount++] = childBone;
+				addChildBones(mesh, childNode, (int)boneIndex, skeletonMap, skeleton);
 			}
 		}
-
-		// return the bones
-		return bones;
 	}
 
 	glm::mat4 aiToGlm(const aiMatrix4x4 & matrix)
@@ -108,7 +88,8 @@ namespace DerydocaEngine::Helpers::AssimpUtils {
 		return n;
 	}
 
-	std::shared_ptr<Animation::Skeleton> getSkeleton(const aiScene *& scene, unsigned int meshIndex)
+	// Finds the node at the root of the skeleton a mesh is bound to, marking every node that is part of the skeleton
+	static aiNode* findSkeletonRootNode(const aiScene*& scene, unsigned int const& meshIndex, std::map<std::string, bool>& skeletonNodeMap)
 	{
 		aiNode* rootNode = scene->mRootNode;
 
@@ -141,9 +122,6 @@ namespace DerydocaEngine::Helpers::AssimpUtils {
 			parentNodeName = meshNode->mParent->mName;
 		}
 
-		// This map stores a list of node names and a boolean value to mark if it is part of the skeleton
-		std::map<std::string, bool> skeletonNodeMap;
-
 		// Prepopulate all nodes to be marked false in the map
 		scanNodeChildren(rootNode, [&skeletonNodeMap](aiNode*& node) {
 			if (node->mName.length > 0)
@@ -202,19 +180,35 @@ namespace DerydocaEngine::Helpers::AssimpUtils {
 			return true;
 		});
 
-		// Build the bones of the skeleton
-		unsigned int boneIndex = 0;
-		std::shared_ptr<Animation::Bone> rootBone = std::make_shared<Animation::Bone>(boneIndex++, rootNode->mName.data, aiToGlm(rootNode->mTransformation));
-		std::vector<std::shared_ptr<Animation::Bone>> childBones = childrenToBones(mesh, rootNode, boneIndex, skeletonNodeMap);
-		rootBone->setChildBones(childBones);
+		return rootNode;
+	}
+
+	std::shared_ptr<Animation::Skeleton> getSkeleton(const aiScene *& scene, unsigned int meshIndex)
+	{
+		// This map stores a list of node names and a boolean value to mark if it is part of the skeleton
+		std::map<std::string, bool> skeletonNodeMap;
+		aiNode* rootNode = findSkeletonRootNode(scene, meshIndex, skeletonNodeMap);
+		const aiMesh* mesh = scene->mMeshes[meshIndex];
 
 		// Create the skeleton object
-		std::shared_ptr<Animation::Skeleton> skeleton = std::make_shared<Animation::Skeleton>(Animation::Skeleton(rootBone, aiToGlm(scene->mRootNode->mTransformation)));
+		std::shared_ptr<Animation::Skeleton> skeleton = std::make_shared<Animation::Skeleton>(aiToGlm(scene->mRootNode->mTransformation));
+
+		// Add the bones of the skeleton, starting from the root
+		glm::mat4 rootTransform = aiToGlm(rootNode->mTransformation);
+		unsigned int rootIndex = skeleton->addBone(rootNode->mName.data, -1, rootTransform, rootTransform);
+		addChildBones(mesh, rootNode, (int)rootIndex, skeletonNodeMap, *skeleton);
 
 		// Return the generated skeleton
 		return skeleton;
 	}
 
+	std::string getSkeletonName(const aiScene *& scene, unsigned int meshIndex)
+	{
+		// A skeleton is named after its root bone, so the bones do not have to be built
+		std::map<std::string, bool> skeletonNodeMap;
+		return findSkeletonRootNode(scene, meshIndex, skeletonNodeMap)->mName.data;
+	}
+
 	void scanNodeChildren(aiNode *& node, std::function<void(aiNode*&)> func)
 	{
 		func(node);
@@ -303,4 +297,59 @@ namespace DerydocaEngine::Helpers::AssimpUtils {
 		return animation;
 	}
 
+	// Gets the distance from a node to its furthest descendant, using the transforms of the nodes
+	static float getNodeExtent(const aiNode* node, glm::mat4 const& transform)
+	{
+		float extent = glm::length(glm::vec3(transform[3]));
+		for (unsigned int i = 0; i < node->mNumChildren; i++)
+		{
+			const aiNode* child = node->mChildren[i];
+			extent = std::max(extent, getNodeExtent(child, transform * aiToGlm(child->mTransformation)));
+		}
+		return extent;
+	}
+
+	std::vector<Animation::AnimationCompression::ChannelHierarchy> getAnimationHierarchy(const aiScene *& scene, unsigned int animationIndex)
+	{
+		assert(scene->HasAnimations() && animationIndex < scene->mNumAnimations);
+		aiAnimation* aiAnim = scene->mAnimations[animationIndex];
+
+		std::map<const aiNode*, int> nodeChannels;
+		std::vector<aiNode*> channelNodes(aiAnim->mNumChannels, nullptr);
+		for (unsigned int i = 0; i < aiAnim->mNumChannels; i++)
+		{
+			aiNode* node = scene->mRootNode->FindNode(aiAnim->mChannels[i]->mNodeName);
+			channelNodes[i] = node;
+			if (node)
+			{
+				nodeChannels.emplace(node, (int)i);
+			}
+		}
+
+		std::vector<Animation::AnimationCompression::ChannelHierarchy> hierarchy(aiAnim->mNumChannels);
+		for (unsigned int i = 0; i < aiAnim->mNumChannels; i++)
+		{
+			aiNode* node = channelNodes[i];
+			if (!node)
+			{
+				continue;
+			}
+
+			// The parent channel is the one animating the closest node above this one
+			for (aiNode* parent = node->mParent; parent; parent = parent->mParent)
+			{
+				auto parentChannel = nodeChannels.find(parent);
+				if (parentChannel != nodeChannels.end())
+				{
+					hierarchy[i].parentChannel = parentChannel->second;
+					break;
+				}
+			}
+
+			hierarchy[i].extent = getNodeExtent(node, glm::mat4());
+		}
+
+		return hierarchy;
+	}
+
 }
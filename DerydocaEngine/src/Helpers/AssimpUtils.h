@@ -7,6 +7,7 @@
 #include "assimp\scene.h"
 #include "assimp\postprocess.h"
 
+#include "Animation\AnimationCompression.h"
 #include "Animation\AnimationData.h"
 #include "Animation\Skeleton.h"
 
@@ -25,10 +26,21 @@ namespace DerydocaEngine::Helpers::AssimpUtils
 
 	std::shared_ptr<Animation::Skeleton> getSkeleton(const aiScene*& scene, unsigned int meshIndex);
 
+	/*
+	Gets the name getSkeleton would give the skeleton of a mesh, without building its bones.
+	*/
+	std::string getSkeletonName(const aiScene*& scene, unsigned int meshIndex);
+
 	void scanNodeChildren(aiNode*& node, std::function<void(aiNode*&)> func);
 
 	void scanNodeParents(aiNode*& node, std::function<bool(aiNode*&)> func);
 
 	std::shared_ptr<Animation::AnimationData> getAnimation(const aiScene *& scene, unsigned int animationIndex);
 
+	/*
+	Gets where each channel of an animation sits in the node hierarchy, in the order of its channels,
+	so compression can tell how far the error of each channel carries.
+	*/
+	std::vector<Animation::AnimationCompression::ChannelHierarchy> getAnimationHierarchy(const aiScene *& scene, unsigned int animationIndex);
+
 }
\ No newline at end of file
@@ -0,0 +1,25 @@
+#include "EnginePch.h"
+#include "Helpers\HashUtils.h"
+
+namespace DerydocaEngine
+{
+
+	uint64_t hashBytes(uint64_t hash, const void* data, size_t const& length)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < length; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	uint64_t hashString(uint64_t hash, std::string const& value)
+	{
+		uint64_t length = value.size();
+		hash = hashBytes(hash, &length, sizeof(length));
+		return hashBytes(hash, value.data(), value.size());
+	}
+
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace DerydocaEngine
+{
+
+	// Starting value for the hash functions below
+	static constexpr uint64_t HASH_SEED = 14695981039346656037ull;
+
+	/*
+	Adds bytes to a 64-bit FNV-1a hash. Fast and stable across runs, but not suitable where
+	collisions can be forced on purpose.
+	*/
+	uint64_t hashBytes(uint64_t hash, const void* data, size_t const& length);
+
+	/* Adds a string and its length to a hash, so neighbouring strings can not be shifted into each other */
+	uint64_t hashString(uint64_t hash, std::string const& value);
+
+}
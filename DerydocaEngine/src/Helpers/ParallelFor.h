@@ -0,0 +1,55 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace DerydocaEngine::Helpers
+{
+
+	/*
+	Calls a function for every index in a range, spread over several threads, and returns once
+	every call is done. Indices are handed out one at a time, so uneven amounts of work per index
+	still balance out. The calling thread takes part, so nothing is spawned for a single thread.
+
+	@param count Number of indices to process
+	@param function Function called with each index, from any of the threads
+	@param maxThreadCount Maximum number of threads to use, or 0 to use every core
+	*/
+	template<typename Function>
+	void parallelFor(size_t const& count, Function const& function, unsigned int const& maxThreadCount = 0)
+	{
+		unsigned int threadCount = maxThreadCount > 0 ? maxThreadCount : std::max(std::thread::hardware_concurrency(), 1u);
+		threadCount = static_cast<unsigned int>(std::min<size_t>(threadCount, count));
+
+		if (threadCount <= 1)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				function(i);
+			}
+			return;
+		}
+
+		std::atomic<size_t> nextIndex(0);
+		auto runWorker = [&]() {
+			for (size_t i = nextIndex++; i < count; i = nextIndex++)
+			{
+				function(i);
+			}
+		};
+
+		std::vector<std::thread> threads;
+		for (unsigned int i = 1; i < threadCount; i++)
+		{
+			threads.push_back(std::thread(runWorker));
+		}
+		runWorker();
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+	}
+
+}
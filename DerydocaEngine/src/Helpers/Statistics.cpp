@@ -0,0 +1,22 @@
+#include "EnginePch.h"
+#include "Helpers\Statistics.h"
+
+#include <atomic>
+
+namespace DerydocaEngine::Helpers::Statistics
+{
+
+	// Read from loader and animation threads, so it is atomic
+	static std::atomic<bool> statisticsEnabled(false);
+
+	void setEnabled(bool const& enabled)
+	{
+		statisticsEnabled = enabled;
+	}
+
+	bool isEnabled()
+	{
+		return statisticsEnabled;
+	}
+
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+namespace DerydocaEngine::Helpers
+{
+
+	/*
+	Switch for the timing and memory reports the engine's systems can print. Reporting is off
+	unless the engine settings turn it on, so loading and running the engine stays quiet.
+	*/
+	namespace Statistics
+	{
+
+		/*
+		Turns the reports of every system on or off.
+
+		@param enabled True to print reports
+		*/
+		void setEnabled(bool const& enabled);
+
+		/* Whether reports should be printed */
+		bool isEnabled();
+
+	}
+
+}
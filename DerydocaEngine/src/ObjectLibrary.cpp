@@ -9,14 +9,74 @@
 #include "yaml-cpp\yaml.h"
 #include "Helpers\YamlTools.h"
 #include "Files\FileType.h"
+#include "Helpers\ParallelFor.h"
+#include "Helpers\HashUtils.h"
+#include "Helpers\Statistics.h"
+#include "Files\MappedFile.h"
 
 namespace DerydocaEngine
 {
 
 	namespace fs = boost::filesystem;
 
+	// Result of loading the resources of a single meta file
+	struct ObjectLibrary::MetaFileLoad
+	{
+		// Record of the meta file to store in the index, skipped when it has no source file path
+		Resources::IndexedMetaFile indexedFile;
+		// Owns the encoded nodes of a meta file that had to be parsed
+		std::vector<uint8_t> encodedNodes;
+		std::vector<std::shared_ptr<Resources::Resource>> resources;
+		bool parsed = false;
+		bool changed = false;
+	};
+
+	static bool getMetaFileStamp(std::string const& metaFilePath, Resources::MetaFileStamp& stamp)
+	{
+		boost::system::error_code error;
+		uintmax_t size = fs::file_size(metaFilePath, error);
+		if (error)
+		{
+			return false;
+		}
+
+		std::time_t writeTime = fs::last_write_time(metaFilePath, error);
+		if (error)
+		{
+			return false;
+		}
+
+		stamp.size = static_cast<uint64_t>(size);
+		stamp.writeTime = static_cast<int64_t>(writeTime);
+		return true;
+	}
+
+	// Stores a tree depth first, returning the position of the node
+	static uint32_t flattenResourceTree(std::shared_ptr<Resources::ResourceTreeNode> const& node, std::vector<Resources::IndexedTreeNode>& tree)
+	{
+		uint32_t index = static_cast<uint32_t>(tree.size());
+		tree.push_back(Resources::IndexedTreeNode());
+		tree[index].name = node->getName();
+		for (auto const& resource : node->getResources())
+		{
+			tree[index].resources.push_back(resource->getId());
+		}
+
+		for (auto const& child : node->getChildren())
+		{
+			uint32_t childIndex = flattenResourceTree(child, tree);
+			tree[index].children.push_back(childIndex);
+		}
+
+		return index;
+	}
+
 	ObjectLibrary::ObjectLibrary() :
-		m_projectResourceRoot(std::make_shared<Resources::ResourceTreeNode>("__projectRoot__"))
+		m_resources(),
+		m_sceneComponents(),
+		m_projectResourceRoot(std::make_shared<Resources::ResourceTreeNode>("__projectRoot__")),
+		m_loadThreadCount(0),
+		m_indexDirectory()
 	{
 	}
 
@@ -33,7 +93,7 @@ namespace DerydocaEngine
 		std::cout << "Loading project files: " << path << "\n";
 		loadDirectory(path);
 
-		loadResourceTree();
+		loadResourceTree(path);
 	}
 
 	std::shared_ptr<Resources::Resource> ObjectLibrary::getResource(std::string const& uuidString)
@@ -72,81 +132,17 @@ namespace DerydocaEngine
 
 	std::shared_ptr<Resources::Resource> ObjectLibrary::getMetaFile(std::string const& sourceFilePath)
 	{
-		std::string metaFilePath = sourceFilePath + m_metaExtension;
-
-		// Load the meta file
-		YAML::Node file = YAML::LoadFile(metaFilePath);
-		YAML::Node resourcesNode = file["Resources"];
-		if (!resourcesNode)
-		{
-			std::cout << "The meta file '" << metaFilePath.c_str() << "' does not have a resource node assigned it it. This file could not be parsed!\n";
-			return nullptr;
-		}
-
-		// Go through all the resource nodes in the file
-		for (size_t i = 0; i < resourcesNode.size(); i++)
-		{
-			YAML::Node resourceNode = resourcesNode[i];
-
-			// If no ID node is defined, exit out because it is required
-			if (!resourceNode["ID"])
-			{
-				std::cout << "A node was skipped because it was missing an ID parameter.\n";
-				continue;
-			}
-
-			// Get the ID
-			boost::uuids::uuid resourceUuid = resourceNode["ID"].as<boost::uuids::uuid>();
-
-			// Find the serializer related to this source file object
-			auto serializer = Files::Serializers::FileSerializerLibrary::getInstance().getTypeSerializer(sourceFilePath);
-
-			// If the serializer could not be found, continue onto the next resource
-			if (serializer == nullptr)
-			{
-				std::cout << "The file '" << sourceFilePath.c_str() << "' does not have a parser assigned to the extension. This file could not be parsed!\n";
-				continue;
-			}
-
-			// Load the resource object
-			std::shared_ptr<Resources::Resource> resource = serializer->loadResourceFromMeta(resourceNode);
-
-			// If no resource could be parsed from the node, continue on
-			if (resource == nullptr)
-			{
-				std::cout << "Unable to convert node " << i << " to resource. This resource could not be parsed!\n";
-				continue;
-			}
-
-			// Set the common parameters of the resource object
-			resource->setFilePaths(sourceFilePath, metaFilePath);
-			resource->setId(resourceUuid);
-			serializer->postLoadInitialize(resource);
-
-			return resource;
-		}
-
-		return nullptr;
+		auto resources = loadMetaFile(sourceFilePath);
+		return resources.empty() ? nullptr : resources.front();
 	}
 
 	void ObjectLibrary::updateMetaFilesDirectory(const boost::filesystem::path& directory)
 	{
-		fs::directory_iterator it{ directory };
-		while (it != fs::directory_iterator{})
-		{
-			if (is_directory(it->path()))
-			{
-				updateMetaFilesDirectory(it->path().string());
-			}
-			else
-			{
-				if (!endsWith(it->path().string(), m_metaExtension))
-				{
-					updateMetaFiles(it->path().string());
-				}
-			}
-			it++;
-		}
+		// Every file gets its own meta file, so they can all be created at the same time
+		std::vector<std::string> sourceFiles = findSourceFiles(directory);
+		Helpers::parallelFor(sourceFiles.size(), [&](size_t i) {
+			updateMetaFiles(sourceFiles[i]);
+		}, m_loadThreadCount);
 	}
 
 	void ObjectLibrary::updateMetaFiles(std::string const& sourceFilePath)
@@ -172,22 +168,138 @@ namespace DerydocaEngine
 
 	void ObjectLibrary::loadDirectory(const boost::filesystem::path& directory)
 	{
-		fs::directory_iterator it{ directory };
-		while (it != fs::directory_iterator{})
+		auto startTime = std::chrono::high_resolution_clock::now();
+
+		// Map the index left by the last load of this directory. Its records point into the mapping,
+		// so it stays open until the new index is written.
+		std::string indexFilePath = getIndexFilePath(directory, ".deryindex");
+		Files::MappedFile indexFile;
+		std::vector<Resources::IndexedMetaFile> indexedFiles;
+		uint64_t indexedTreeHash;
+		std::vector<Resources::IndexedTreeNode> indexedTree;
+		if (!indexFilePath.empty() && indexFile.open(indexFilePath) &&
+			!Resources::ResourceIndex::read(indexFile.getData(), indexFile.getSize(), indexedFiles, indexedTreeHash, indexedTree))
+		{
+			std::cout << "The resource index '" << indexFilePath << "' is out of date and will be rebuilt.\n";
+			indexedFiles.clear();
+		}
+
+		std::unordered_map<std::string, const Resources::IndexedMetaFile*> indexedFileLookup;
+		for (auto const& indexedFile : indexedFiles)
+		{
+			indexedFileLookup.emplace(indexedFile.sourceFilePath, &indexedFile);
+		}
+
+		// Load the meta files in parallel, each into its own slot. Only meta files that changed since
+		// they were indexed are parsed.
+		std::vector<std::string> sourceFiles = findSourceFiles(directory);
+		std::vector<MetaFileLoad> loads(sourceFiles.size());
+		Helpers::parallelFor(sourceFiles.size(), [&](size_t i) {
+			auto search = indexedFileLookup.find(sourceFiles[i]);
+			try
+			{
+				loadMetaFile(sourceFiles[i], search != indexedFileLookup.end() ? search->second : nullptr, loads[i]);
+			}
+			catch (YAML::Exception const& e)
+			{
+				// Skip the file, so one malformed meta file does not stop the rest of the directory from loading
+				std::cout << "Unable to parse the meta file of '" << sourceFiles[i] << "': " << e.what() << "\n";
+				loads[i] = MetaFileLoad();
+			}
+		}, m_loadThreadCount);
+
+		// Merge in ID order so the map is filled from its end. The sort is stable and the files are
+		// in path order, so the first file to claim an ID keeps it on every run.
+		std::vector<std::shared_ptr<Resources::Resource>> resources;
+		std::vector<Resources::IndexedMetaFile> metaFiles;
+		bool indexChanged = false;
+		int parsedFileCount = 0;
+		for (auto const& load : loads)
 		{
-			if (is_directory(it->path()))
+			resources.insert(resources.end(), load.resources.begin(), load.resources.end());
+			if (!load.indexedFile.sourceFilePath.empty())
 			{
-				loadDirectory(it->path().string());
+				metaFiles.push_back(load.indexedFile);
+			}
+			indexChanged |= load.changed;
+			parsedFileCount += load.parsed ? 1 : 0;
+		}
+		std::stable_sort(resources.begin(), resources.end(), [](std::shared_ptr<Resources::Resource> const& resourceL, std::shared_ptr<Resources::Resource> const& resourceR)
+		{
+			return resourceL->getId() < resourceR->getId();
+		});
+
+		for (auto const& resource : resources)
+		{
+			if (m_resources.empty() || m_resources.rbegin()->first < resource->getId())
+			{
+				m_resources.emplace_hint(m_resources.end(), resource->getId(), resource);
 			}
 			else
 			{
-				if (!endsWith(it->path().string(), m_metaExtension))
+				registerResource(resource);
+			}
+		}
+
+		// Files that were deleted since the last load also leave the index out of date
+		if (!indexFilePath.empty() && (indexChanged || metaFiles.size() != indexedFiles.size() || !indexFile.isOpen()))
+		{
+			std::vector<uint8_t> contents;
+			Resources::ResourceIndex::write(contents, metaFiles, 0, {});
+			indexFile.close();
+			if (!writeIndexFile(indexFilePath, contents))
+			{
+				std::cout << "Unable to write the resource index: " << indexFilePath << "\n";
+			}
+		}
+
+		if (Helpers::Statistics::isEnabled())
+		{
+			std::chrono::duration<double, std::milli> loadTime = std::chrono::high_resolution_clock::now() - startTime;
+			printf("Loaded %d resources from %d files in %.2fms (%d meta files parsed, %d read from the index)\n",
+				static_cast<int>(resources.size()),
+				static_cast<int>(sourceFiles.size()),
+				loadTime.count(),
+				parsedFileCount,
+				static_cast<int>(metaFiles.size()) - parsedFileCount);
+		}
+	}
+
+	std::vector<std::string> ObjectLibrary::findSourceFiles(const boost::filesystem::path& directory) const
+	{
+		std::vector<std::string> sourceFiles;
+
+		// Walk the tree a level at a time, listing every directory of a level in parallel
+		std::vector<fs::path> directories = { directory };
+		while (!directories.empty())
+		{
+			std::vector<std::vector<std::string>> directoryFiles(directories.size());
+			std::vector<std::vector<fs::path>> subdirectories(directories.size());
+			Helpers::parallelFor(directories.size(), [&](size_t i) {
+				for (fs::directory_iterator it{ directories[i] }; it != fs::directory_iterator{}; it++)
 				{
-					loadFile(it->path().string());
+					if (is_directory(it->path()))
+					{
+						subdirectories[i].push_back(it->path());
+					}
+					else if (!endsWith(it->path().string(), m_metaExtension))
+					{
+						directoryFiles[i].push_back(it->path().string());
+					}
 				}
+			}, m_loadThreadCount);
+
+			directories.clear();
+			for (size_t i = 0; i < directoryFiles.size(); i++)
+			{
+				sourceFiles.insert(sourceFiles.end(), directoryFiles[i].begin(), directoryFiles[i].end());
+				directories.insert(directories.end(), subdirectories[i].begin(), subdirectories[i].end());
 			}
-			it++;
 		}
+
+		// Directory listings are in no particular order, so sort to load the same way every time
+		std::sort(sourceFiles.begin(), sourceFiles.end());
+		return sourceFiles;
 	}
 
 	bool ObjectLibrary::createMetaFile(std::string const& sourceFilePath, std::string const& metaFilePath)
@@ -268,8 +380,30 @@ namespace DerydocaEngine
 		return currentNode;
 	}
 
-	void ObjectLibrary::loadResourceTree()
+	void ObjectLibrary::loadResourceTree(const boost::filesystem::path& directory)
 	{
+		auto startTime = std::chrono::high_resolution_clock::now();
+
+		// The tree only has to be rebuilt when a resource was added, removed, moved or renamed
+		uint64_t treeHash = HASH_SEED;
+		for (auto const& resource : m_resources)
+		{
+			treeHash = hashBytes(treeHash, resource.first.data, resource.first.static_size());
+			treeHash = hashString(treeHash, resource.second->getSourceFilePath());
+			treeHash = hashString(treeHash, resource.second->getName());
+		}
+
+		std::string indexFilePath = getIndexFilePath(directory, ".derytree");
+		if (!indexFilePath.empty() && loadIndexedResourceTree(indexFilePath, treeHash))
+		{
+			if (Helpers::Statistics::isEnabled())
+			{
+				std::chrono::duration<double, std::milli> loadTime = std::chrono::high_resolution_clock::now() - startTime;
+				printf("Loaded the resource tree from its index in %.2fms\n", loadTime.count());
+			}
+			return;
+		}
+
 		m_projectResourceRoot->clear();
 
 		for (auto resource : m_resources)
@@ -279,24 +413,157 @@ namespace DerydocaEngine
 		}
 
 		m_projectResourceRoot->sort();
+
+		if (!indexFilePath.empty())
+		{
+			std::vector<Resources::IndexedTreeNode> tree;
+			flattenResourceTree(m_projectResourceRoot, tree);
+
+			std::vector<uint8_t> contents;
+			Resources::ResourceIndex::write(contents, {}, treeHash, tree);
+			if (!writeIndexFile(indexFilePath, contents))
+			{
+				std::cout << "Unable to write the resource tree index: " << indexFilePath << "\n";
+			}
+		}
+
+		if (Helpers::Statistics::isEnabled())
+		{
+			std::chrono::duration<double, std::milli> loadTime = std::chrono::high_resolution_clock::now() - startTime;
+			printf("Built the resource tree in %.2fms\n", loadTime.count());
+		}
+	}
+
+	bool ObjectLibrary::loadIndexedResourceTree(std::string const& indexFilePath, uint64_t const& treeHash)
+	{
+		Files::MappedFile indexFile;
+		std::vector<Resources::IndexedMetaFile> metaFiles;
+		uint64_t indexedTreeHash;
+		std::vector<Resources::IndexedTreeNode> tree;
+		if (!indexFile.open(indexFilePath) ||
+			!Resources::ResourceIndex::read(indexFile.getData(), indexFile.getSize(), metaFiles, indexedTreeHash, tree) ||
+			indexedTreeHash != treeHash ||
+			tree.empty())
+		{
+			return false;
+		}
+
+		// The first node is the root, which already exists
+		std::vector<std::shared_ptr<Resources::ResourceTreeNode>> nodes(tree.size());
+		nodes[0] = m_projectResourceRoot;
+		for (size_t i = 1; i < tree.size(); i++)
+		{
+			nodes[i] = std::make_shared<Resources::ResourceTreeNode>(tree[i].name);
+		}
+
+		m_projectResourceRoot->clear();
+		for (size_t i = 0; i < tree.size(); i++)
+		{
+			for (auto const& child : tree[i].children)
+			{
+				nodes[i]->addChild(nodes[child]);
+			}
+
+			for (auto const& resourceId : tree[i].resources)
+			{
+				auto resource = getResource(resourceId);
+				if (resource == nullptr)
+				{
+					return false;
+				}
+				nodes[i]->addResource(resource);
+			}
+		}
+
+		return true;
 	}
 
 	void ObjectLibrary::loadFile(std::string const& sourceFilePath)
+	{
+		// Register the resources so they can be referenced later
+		for (auto const& resource : loadMetaFile(sourceFilePath))
+		{
+			registerResource(resource);
+		}
+	}
+
+	std::vector<std::shared_ptr<Resources::Resource>> ObjectLibrary::loadMetaFile(std::string const& sourceFilePath) const
 	{
 		std::string metaFilePath = sourceFilePath + m_metaExtension;
 
 		// If the meta file does not exist, skip loading this resource
 		if (!fs::exists(metaFilePath))
 		{
-			return;
+			return std::vector<std::shared_ptr<Resources::Resource>>();
 		}
 
 		// Load the meta file
 		YAML::Node file = YAML::LoadFile(metaFilePath);
-		YAML::Node resourcesNode = file["Resources"];
+		return createResources(sourceFilePath, metaFilePath, file["Resources"]);
+	}
+
+	void ObjectLibrary::loadMetaFile(std::string const& sourceFilePath, const Resources::IndexedMetaFile* indexedFile, MetaFileLoad& load) const
+	{
+		std::string metaFilePath = sourceFilePath + m_metaExtension;
+
+		// If the meta file does not exist, skip loading this resource
+		Resources::MetaFileStamp stamp;
+		if (!getMetaFileStamp(metaFilePath, stamp))
+		{
+			load.changed = indexedFile != nullptr;
+			return;
+		}
+
+		// Use the indexed nodes if the meta file was not touched since it was indexed
+		YAML::Node resourcesNode;
+		if (indexedFile != nullptr &&
+			indexedFile->stamp.size == stamp.size &&
+			indexedFile->stamp.writeTime == stamp.writeTime &&
+			Resources::ResourceIndex::decodeNode(indexedFile->resourceNodes, indexedFile->resourceNodesSize, resourcesNode))
+		{
+			load.indexedFile = *indexedFile;
+			load.resources = createResources(sourceFilePath, metaFilePath, resourcesNode);
+			return;
+		}
+
+		std::ifstream file(metaFilePath, std::ios::binary);
+		std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		stamp.hash = hashBytes(HASH_SEED, contents.data(), contents.size());
+		load.changed = true;
+
+		// The file was touched without changing, so only its stamp has to be updated
+		if (indexedFile != nullptr &&
+			indexedFile->stamp.hash == stamp.hash &&
+			Resources::ResourceIndex::decodeNode(indexedFile->resourceNodes, indexedFile->resourceNodesSize, resourcesNode))
+		{
+			load.indexedFile = *indexedFile;
+			load.indexedFile.stamp = stamp;
+			load.resources = createResources(sourceFilePath, metaFilePath, resourcesNode);
+			return;
+		}
+
+		// Parse the meta file and keep the result for the next load
+		YAML::Node root = YAML::Load(contents);
+		resourcesNode = root["Resources"];
+		load.parsed = true;
+		load.resources = createResources(sourceFilePath, metaFilePath, resourcesNode);
+		if (resourcesNode)
+		{
+			Resources::ResourceIndex::encodeNode(resourcesNode, load.encodedNodes);
+			load.indexedFile.sourceFilePath = sourceFilePath;
+			load.indexedFile.stamp = stamp;
+			load.indexedFile.resourceNodes = load.encodedNodes.data();
+			load.indexedFile.resourceNodesSize = load.encodedNodes.size();
+		}
+	}
+
+	std::vector<std::shared_ptr<Resources::Resource>> ObjectLibrary::createResources(std::string const& sourceFilePath, std::string const& metaFilePath, YAML::Node const& resourcesNode) const
+	{
+		std::vector<std::shared_ptr<Resources::Resource>> resources;
 		if (!resourcesNode)
 		{
 			std::cout << "The meta file '" << metaFilePath.c_str() << "' does not have a resource node assigned it it. This file could not be parsed!\n";
+			return resources;
 		}
 
 		// Go through all the resource nodes in the file
@@ -339,10 +606,47 @@ namespace DerydocaEngine
 			resource->setId(resourceUuid);
 			serializer->postLoadInitialize(resource);
 
-			// Register the resource so it can be referenced later
-			registerResource(resource);
+			resources.push_back(resource);
+		}
+
+		return resources;
+	}
+
+	std::string ObjectLibrary::getIndexFilePath(const boost::filesystem::path& directory, std::string const& extension) const
+	{
+		if (m_indexDirectory.empty())
+		{
+			return std::string();
+		}
+
+		// Every loaded directory gets its own index, named after its absolute path
+		char fileName[17];
+		snprintf(fileName, sizeof(fileName), "%016llx", static_cast<unsigned long long>(hashString(HASH_SEED, fs::absolute(directory).string())));
+		return (fs::path(m_indexDirectory) / (fileName + extension)).string();
+	}
+
+	bool ObjectLibrary::writeIndexFile(std::string const& filePath, std::vector<uint8_t> const& contents) const
+	{
+		boost::system::error_code error;
+		fs::create_directories(fs::path(filePath).parent_path(), error);
+
+		// Write next to the destination and swap it in, so an index is never seen half written
+		std::string temporaryFilePath = filePath + ".tmp";
+		{
+			std::ofstream file(temporaryFilePath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+			{
+				return false;
+			}
+			file.write(reinterpret_cast<const char*>(contents.data()), contents.size());
+			if (!file.good())
+			{
+				return false;
+			}
 		}
 
+		fs::rename(temporaryFilePath, filePath, error);
+		return !error;
 	}
 
 }
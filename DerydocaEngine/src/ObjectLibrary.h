@@ -2,9 +2,11 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 #include <boost/uuid/string_generator.hpp>
 #include <boost/uuid/uuid.hpp>
 #include "Resources\Resource.h"
+#include "Resources\ResourceIndex.h"
 #include "Resources\ResourceTreeNode.h"
 
 namespace DerydocaEngine::Components {
@@ -37,6 +39,23 @@ namespace DerydocaEngine
 		void loadDirectory(const boost::filesystem::path& path);
 		void loadFile(std::string const& sourceFilePath);
 
+		/*
+		Sets how many threads scan directories and parse meta files.
+
+		@param threadCount Maximum number of threads, or 0 to use every core
+		*/
+		void setLoadThreadCount(unsigned int const& threadCount) { m_loadThreadCount = threadCount; }
+
+		/*
+		Sets the directory the parsed meta files of each loaded directory are indexed in, so only meta
+		files that changed since the last run have to be parsed. Indexing is disabled when the
+		directory is empty.
+
+		@param directory Directory to store the indices in
+		*/
+		void setIndexDirectory(std::string const& directory) { m_indexDirectory = directory; }
+		std::string getIndexDirectory() const { return m_indexDirectory; }
+
 		void registerComponent(boost::uuids::uuid const& id, std::shared_ptr<Components::GameComponent> component);
 
 		template<class GameComponentClass>
@@ -75,19 +94,30 @@ namespace DerydocaEngine
 			return pointer;
 		}
 	private:
+		struct MetaFileLoad;
+
 		ObjectLibrary();
 		~ObjectLibrary() {}
 		ObjectLibrary(ObjectLibrary const&) {}
 
 		bool createMetaFile(std::string const& sourceFilePath, std::string const& metaFilePath);
+		std::vector<std::string> findSourceFiles(const boost::filesystem::path& directory) const;
+		std::vector<std::shared_ptr<Resources::Resource>> loadMetaFile(std::string const& sourceFilePath) const;
+		void loadMetaFile(std::string const& sourceFilePath, const Resources::IndexedMetaFile* indexedFile, MetaFileLoad& load) const;
+		std::vector<std::shared_ptr<Resources::Resource>> createResources(std::string const& sourceFilePath, std::string const& metaFilePath, YAML::Node const& resourcesNode) const;
+		std::string getIndexFilePath(const boost::filesystem::path& directory, std::string const& extension) const;
+		bool writeIndexFile(std::string const& filePath, std::vector<uint8_t> const& contents) const;
 		void registerResource(std::shared_ptr<Resources::Resource> resource);
 		std::shared_ptr<Resources::ResourceTreeNode> getResourceTreeNode(const std::string& resourcePath);
-		void loadResourceTree();
+		void loadResourceTree(const boost::filesystem::path& directory);
+		bool loadIndexedResourceTree(std::string const& indexFilePath, uint64_t const& treeHash);
 
 		const std::string m_metaExtension = ".derymeta";
 		std::map<boost::uuids::uuid, std::shared_ptr<Resources::Resource>> m_resources;
 		std::map<boost::uuids::uuid, std::shared_ptr<Components::GameComponent>> m_sceneComponents;
 		std::shared_ptr<Resources::ResourceTreeNode> m_projectResourceRoot;
+		unsigned int m_loadThreadCount;
+		std::string m_indexDirectory;
 	};
 
 }
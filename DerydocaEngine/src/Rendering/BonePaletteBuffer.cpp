@@ -0,0 +1,187 @@
+#include "EnginePch.h"
+#include "Rendering\BonePaletteBuffer.h"
+
+#include <algorithm>
+#include "Animation\AnimationSystem.h"
+#include "Rendering\Shader.h"
+
+namespace DerydocaEngine::Rendering
+{
+
+	// Kept clear of the units materials bind their textures to, next to the shadow jitter texture
+	static const int BONE_PALETTE_TEXTURE_UNIT = 31;
+
+	// Room for a few dozen characters before the buffer first has to grow
+	static const size_t INITIAL_CAPACITY = 4096;
+
+	// Every matrix is four RGBA32F texels, one per column
+	static const size_t TEXELS_PER_MATRIX = 4;
+
+	BonePaletteBuffer::BonePaletteBuffer() :
+		m_bufferId(0),
+		m_textureId(0),
+		m_createFailed(false),
+		m_capacity(0),
+		m_maxMatrices(0),
+		m_palettes(),
+		m_uploadedCount(0),
+		m_frame(0),
+		m_overflowWarned(false),
+		m_statistics()
+	{
+	}
+
+	BonePaletteBuffer::~BonePaletteBuffer()
+	{
+		if (m_textureId)
+		{
+			glDeleteTextures(1, &m_textureId);
+		}
+		if (m_bufferId)
+		{
+			glDeleteBuffers(1, &m_bufferId);
+		}
+	}
+
+	void BonePaletteBuffer::update()
+	{
+		m_frame++;
+		m_palettes.clear();
+		m_uploadedCount = 0;
+		if (m_statistics.lastFrameRejectedCount == 0)
+		{
+			m_overflowWarned = false;
+		}
+		m_statistics.lastFrameRejectedCount = 0;
+
+		// Only characters that are likely to be drawn are uploaded up front, so the upload scales with what is on screen
+		Animation::AnimationSystem& animationSystem = Animation::AnimationSystem::getInstance();
+		unsigned int animationFrame = animationSystem.getFrame();
+		for (auto const& instance : animationSystem.getActiveInstances())
+		{
+			if (instance->isCulled(animationFrame))
+			{
+				m_statistics.culledPaletteCount++;
+				continue;
+			}
+
+			instance->setPaletteOffset(write(instance->getBoneTransforms()), m_frame);
+		}
+
+		upload();
+		m_statistics.frameCount++;
+		m_statistics.lastFrameBytes = m_palettes.size() * sizeof(glm::mat4);
+		m_statistics.peakFrameBytes = std::max(m_statistics.peakFrameBytes, m_statistics.lastFrameBytes);
+	}
+
+	int BonePaletteBuffer::write(std::vector<glm::mat4> const& palette)
+	{
+		if (palette.empty() || !create())
+		{
+			return -1;
+		}
+
+		if (m_palettes.size() + palette.size() > m_maxMatrices)
+		{
+			if (!m_overflowWarned)
+			{
+				std::cout << "The bone palette buffer can not hold more than " << m_maxMatrices << " matrices, so some skinned meshes are not drawn.\n";
+				m_overflowWarned = true;
+			}
+			m_statistics.rejectedPaletteCount++;
+			m_statistics.lastFrameRejectedCount++;
+			return -1;
+		}
+
+		int offset = static_cast<int>(m_palettes.size());
+		m_palettes.insert(m_palettes.end(), palette.begin(), palette.end());
+		m_statistics.paletteCount++;
+		return offset;
+	}
+
+	void BonePaletteBuffer::bind(Shader& shader, int const& offset, int const& stride)
+	{
+		// Palettes written after the frame's upload, such as by scenes rendered without the animation system, go up now
+		upload();
+
+		shader.setTexture("BonePalettes", BONE_PALETTE_TEXTURE_UNIT, GL_TEXTURE_BUFFER, m_textureId);
+		shader.setInt("BonePaletteOffset", offset);
+		shader.setInt("BonePaletteStride", stride);
+	}
+
+	void BonePaletteBuffer::printStatistics() const
+	{
+		printf("Uploaded %zu bone palettes over %zu frames, %.1f KB in %zu uploads with at most %.1f KB in a frame, for %zu skinned draws of %zu instances, %zu palettes skipped off screen, %zu palettes did not fit\n",
+			m_statistics.paletteCount,
+			m_statistics.frameCount,
+			m_statistics.uploadedBytes / 1024.0f,
+			m_statistics.uploadCount,
+			m_statistics.peakFrameBytes / 1024.0f,
+			m_statistics.drawCount,
+			m_statistics.instanceCount,
+			m_statistics.culledPaletteCount,
+			m_statistics.rejectedPaletteCount);
+	}
+
+	bool BonePaletteBuffer::create()
+	{
+		if (m_bufferId || m_createFailed)
+		{
+			return !m_createFailed;
+		}
+
+		GLint maxTexels = 0;
+		glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+		m_maxMatrices = static_cast<size_t>(maxTexels) / TEXELS_PER_MATRIX;
+		if (m_maxMatrices == 0)
+		{
+			std::cout << "Texture buffers are not supported, so skinned meshes can not be drawn.\n";
+			m_createFailed = true;
+			return false;
+		}
+
+		m_capacity = std::min(INITIAL_CAPACITY, m_maxMatrices);
+		glGenBuffers(1, &m_bufferId);
+		glBindBuffer(GL_TEXTURE_BUFFER, m_bufferId);
+		glBufferData(GL_TEXTURE_BUFFER, static_cast<GLsizeiptr>(m_capacity * sizeof(glm::mat4)), nullptr, GL_STREAM_DRAW);
+		glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+		glGenTextures(1, &m_textureId);
+		glBindTexture(GL_TEXTURE_BUFFER, m_textureId);
+		glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, m_bufferId);
+		glBindTexture(GL_TEXTURE_BUFFER, 0);
+		return true;
+	}
+
+	void BonePaletteBuffer::upload()
+	{
+		if (m_uploadedCount >= m_palettes.size() || !m_bufferId)
+		{
+			return;
+		}
+
+		glBindBuffer(GL_TEXTURE_BUFFER, m_bufferId);
+		if (m_palettes.size() > m_capacity || m_uploadedCount == 0)
+		{
+			// A new frame gets fresh storage, so it never waits on draws still reading last frame's palettes
+			while (m_capacity < m_palettes.size())
+			{
+				m_capacity = std::min(m_capacity * 2, m_maxMatrices);
+			}
+			glBufferData(GL_TEXTURE_BUFFER, static_cast<GLsizeiptr>(m_capacity * sizeof(glm::mat4)), nullptr, GL_STREAM_DRAW);
+			m_uploadedCount = 0;
+		}
+
+		size_t matrixCount = m_palettes.size() - m_uploadedCount;
+		glBufferSubData(GL_TEXTURE_BUFFER,
+			static_cast<GLintptr>(m_uploadedCount * sizeof(glm::mat4)),
+			static_cast<GLsizeiptr>(matrixCount * sizeof(glm::mat4)),
+			m_palettes.data() + m_uploadedCount);
+		glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+		m_statistics.uploadedBytes += matrixCount * sizeof(glm::mat4);
+		m_statistics.uploadCount++;
+		m_uploadedCount = m_palettes.size();
+	}
+
+}
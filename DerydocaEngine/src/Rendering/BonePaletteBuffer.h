@@ -0,0 +1,113 @@
+#pragma once
+#include <glm/mat4x4.hpp>
+#include <memory>
+#include <vector>
+
+namespace DerydocaEngine::Rendering
+{
+	class Shader;
+}
+
+namespace DerydocaEngine::Rendering
+{
+
+	/*
+	Texture buffer holding the bone palette of every animated instance for the current frame. The
+	palettes are written into one array and uploaded in a single call, then each skinned draw only
+	sets the offset of its palette and the vertex shader fetches the matrices it needs. Instances
+	of the same mesh written one after another can be drawn with one instanced draw, where each
+	instance steps a palette further along.
+	*/
+	class BonePaletteBuffer
+	{
+	public:
+		static BonePaletteBuffer& getInstance()
+		{
+			static BonePaletteBuffer instance;
+			return instance;
+		}
+
+		/* Counters of the palettes uploaded through the buffer */
+		struct Statistics
+		{
+			size_t uploadedBytes = 0;
+			size_t uploadCount = 0;
+			size_t paletteCount = 0;
+			size_t frameCount = 0;
+			size_t lastFrameBytes = 0;
+			size_t peakFrameBytes = 0;
+			size_t drawCount = 0;
+			size_t instanceCount = 0;
+			// Palettes of instances off screen last frame, which were left to be written if they are drawn
+			size_t culledPaletteCount = 0;
+			// Palette writes that did not fit in the buffer, whose meshes were not drawn
+			size_t rejectedPaletteCount = 0;
+			size_t lastFrameRejectedCount = 0;
+		};
+
+		/*
+		Drops the palettes of the last frame and writes the palette of every active animation
+		instance that was on screen last frame, then uploads them in one call. Instances that come
+		into view write their palette when they are drawn. Must be called on the render thread once
+		per frame, after the animation system has evaluated the instances.
+		*/
+		void update();
+
+		/*
+		Adds a palette to the current frame. It is uploaded with the rest of the frame's palettes,
+		or when it is first bound if the frame's palettes were already uploaded.
+
+		@param palette Skinning matrix of each bone
+		@return Index of the palette's first matrix, or -1 if the buffer is full
+		*/
+		int write(std::vector<glm::mat4> const& palette);
+
+		/*
+		Points a shader at a palette in the buffer. The shader is expected to be bound.
+
+		@param shader Shader to set the palette of
+		@param offset Index of the first palette's first matrix
+		@param stride Number of matrices from one instance's palette to the next, for instanced draws
+		*/
+		void bind(Shader& shader, int const& offset, int const& stride);
+
+		/*
+		Counts a skinned draw for the statistics.
+
+		@param instanceCount Number of instances the draw covered
+		*/
+		void countDraw(unsigned int const& instanceCount) { m_statistics.drawCount++; m_statistics.instanceCount += instanceCount; }
+
+		/* Frame the palettes currently in the buffer were written in */
+		unsigned int getFrame() const { return m_frame; }
+		Statistics getStatistics() const { return m_statistics; }
+
+		/* Prints how much palette data was uploaded, in how many calls, how many skinned draws used it and how many palettes were skipped or did not fit */
+		void printStatistics() const;
+
+		void operator=(BonePaletteBuffer const&) = delete;
+	private:
+		BonePaletteBuffer();
+		BonePaletteBuffer(BonePaletteBuffer const&);
+		~BonePaletteBuffer();
+
+		bool create();
+
+		/* Uploads the palettes written since the last upload, growing the buffer if they do not fit */
+		void upload();
+
+		unsigned int m_bufferId;
+		unsigned int m_textureId;
+		bool m_createFailed;
+		// Capacity of the buffer and largest number the texture buffer can address, in matrices
+		size_t m_capacity;
+		size_t m_maxMatrices;
+		std::vector<glm::mat4> m_palettes;
+		size_t m_uploadedCount;
+		unsigned int m_frame;
+		// Set once the buffer overflowed, so it is only reported again after a frame that fit
+		bool m_overflowWarned;
+		Statistics m_statistics;
+	};
+
+}
@@ -0,0 +1,209 @@
+#include "EnginePch.h"
+#include "Rendering\BufferSubAllocator.h"
+
+namespace DerydocaEngine::Rendering
+{
+
+	BufferSubAllocator::BufferSubAllocator(size_t const& capacity) :
+		m_capacity(capacity),
+		m_usedSize(0),
+		m_nextAllocationId(0),
+		m_allocations(),
+		m_freeRangesByOffset(),
+		m_freeRangesBySize()
+	{
+		if (capacity > 0)
+		{
+			addFreeRange(0, capacity);
+		}
+	}
+
+	BufferSubAllocator::~BufferSubAllocator()
+	{
+	}
+
+	BufferSubAllocator::AllocationId BufferSubAllocator::allocate(size_t const& size)
+	{
+		if (size == 0)
+		{
+			return INVALID_ALLOCATION;
+		}
+
+		// Take the smallest free range that fits to keep large ranges available
+		auto bestFit = m_freeRangesBySize.lower_bound(size);
+		if (bestFit == m_freeRangesBySize.end())
+		{
+			return INVALID_ALLOCATION;
+		}
+
+		size_t rangeOffset = bestFit->second;
+		size_t rangeSize = bestFit->first;
+		removeFreeRange(m_freeRangesByOffset.find(rangeOffset));
+
+		// Return whatever is left of the range to the free list
+		if (rangeSize > size)
+		{
+			addFreeRange(rangeOffset + size, rangeSize - size);
+		}
+
+		AllocationId id = m_nextAllocationId++;
+		if (m_nextAllocationId == INVALID_ALLOCATION)
+		{
+			m_nextAllocationId = 0;
+		}
+
+		m_allocations[id] = { rangeOffset, size };
+		m_usedSize += size;
+		return id;
+	}
+
+	void BufferSubAllocator::free(AllocationId const& allocation)
+	{
+		auto it = m_allocations.find(allocation);
+		if (it == m_allocations.end())
+		{
+			return;
+		}
+
+		size_t offset = it->second.offset;
+		size_t size = it->second.size;
+		m_usedSize -= size;
+		m_allocations.erase(it);
+
+		// Merge with the free range that ends where this one starts
+		auto next = m_freeRangesByOffset.lower_bound(offset);
+		if (next != m_freeRangesByOffset.begin())
+		{
+			auto previous = std::prev(next);
+			if (previous->first + previous->second == offset)
+			{
+				offset = previous->first;
+				size += previous->second;
+				removeFreeRange(previous);
+			}
+		}
+
+		// Merge with the free range that starts where this one ends
+		next = m_freeRangesByOffset.find(offset + size);
+		if (next != m_freeRangesByOffset.end())
+		{
+			size += next->second;
+			removeFreeRange(next);
+		}
+
+		addFreeRange(offset, size);
+	}
+
+	void BufferSubAllocator::grow(size_t const& capacity)
+	{
+		if (capacity <= m_capacity)
+		{
+			return;
+		}
+
+		size_t oldCapacity = m_capacity;
+		m_capacity = capacity;
+
+		// Extend a free range that runs up to the old end of the buffer instead of adding a new one
+		size_t offset = oldCapacity;
+		size_t size = capacity - oldCapacity;
+		if (!m_freeRangesByOffset.empty())
+		{
+			auto last = std::prev(m_freeRangesByOffset.end());
+			if (last->first + last->second == oldCapacity)
+			{
+				offset = last->first;
+				size += last->second;
+				removeFreeRange(last);
+			}
+		}
+
+		addFreeRange(offset, size);
+	}
+
+	std::vector<BufferSubAllocator::Move> BufferSubAllocator::defragment()
+	{
+		std::vector<Move> moves;
+
+		// Visit allocations in the order they appear in the buffer
+		std::vector<std::pair<size_t, AllocationId>> allocationsByOffset;
+		allocationsByOffset.reserve(m_allocations.size());
+		for (auto const& allocation : m_allocations)
+		{
+			allocationsByOffset.push_back({ allocation.second.offset, allocation.first });
+		}
+		std::sort(allocationsByOffset.begin(), allocationsByOffset.end());
+
+		size_t packedOffset = 0;
+		for (auto const& allocation : allocationsByOffset)
+		{
+			Range& range = m_allocations[allocation.second];
+			if (range.offset != packedOffset)
+			{
+				moves.push_back({ range.offset, packedOffset, range.size });
+				range.offset = packedOffset;
+			}
+			packedOffset += range.size;
+		}
+
+		m_freeRangesByOffset.clear();
+		m_freeRangesBySize.clear();
+		if (packedOffset < m_capacity)
+		{
+			addFreeRange(packedOffset, m_capacity - packedOffset);
+		}
+
+		return moves;
+	}
+
+	size_t BufferSubAllocator::getOffset(AllocationId const& allocation) const
+	{
+		auto it = m_allocations.find(allocation);
+		return it == m_allocations.end() ? 0 : it->second.offset;
+	}
+
+	size_t BufferSubAllocator::getSize(AllocationId const& allocation) const
+	{
+		auto it = m_allocations.find(allocation);
+		return it == m_allocations.end() ? 0 : it->second.size;
+	}
+
+	size_t BufferSubAllocator::getLargestFreeRange() const
+	{
+		return m_freeRangesBySize.empty() ? 0 : m_freeRangesBySize.rbegin()->first;
+	}
+
+	float BufferSubAllocator::getOccupancy() const
+	{
+		return m_capacity == 0 ? 0.0f : (float)m_usedSize / (float)m_capacity;
+	}
+
+	float BufferSubAllocator::getFragmentation() const
+	{
+		size_t freeSize = getFreeSize();
+		return freeSize == 0 ? 0.0f : 1.0f - (float)getLargestFreeRange() / (float)freeSize;
+	}
+
+	void BufferSubAllocator::addFreeRange(size_t const& offset, size_t const& size)
+	{
+		m_freeRangesByOffset[offset] = size;
+		m_freeRangesBySize.insert({ size, offset });
+	}
+
+	void BufferSubAllocator::removeFreeRange(std::map<size_t, size_t>::iterator const& rangeByOffset)
+	{
+		// Several ranges can share a size, so find the one at this offset
+		auto sizeRange = m_freeRangesBySize.equal_range(rangeByOffset->second);
+		for (auto it = sizeRange.first; it != sizeRange.second; ++it)
+		{
+			if (it->second == rangeByOffset->first)
+			{
+				m_freeRangesBySize.erase(it);
+				break;
+			}
+		}
+
+		m_freeRangesByOffset.erase(rangeByOffset);
+	}
+
+}
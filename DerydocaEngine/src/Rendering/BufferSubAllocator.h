@@ -0,0 +1,103 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace DerydocaEngine::Rendering
+{
+
+	/*
+	Hands out ranges of a larger buffer. Sizes and offsets are in whatever unit the owner of the
+	buffer uses, such as vertices or indices. Free ranges are tracked both by offset, so neighbours
+	can be merged when a range is released, and by size, so allocations take the smallest range
+	that fits.
+	*/
+	class BufferSubAllocator
+	{
+	public:
+		/* Identifies a single allocation. Stays valid across defragmentation. */
+		typedef uint32_t AllocationId;
+
+		static constexpr AllocationId INVALID_ALLOCATION = 0xFFFFFFFF;
+
+		/* Describes a range of data that has to be copied to complete a defragmentation */
+		struct Move
+		{
+			size_t sourceOffset;
+			size_t destinationOffset;
+			size_t size;
+		};
+
+		BufferSubAllocator(size_t const& capacity);
+		~BufferSubAllocator();
+
+		/*
+		Reserves a range of the buffer.
+
+		@param size Size of the range to reserve
+		@return Id of the allocation, or INVALID_ALLOCATION if no free range is large enough
+		*/
+		AllocationId allocate(size_t const& size);
+
+		/*
+		Releases a range so it can be reused.
+
+		@param allocation Id of the allocation to release
+		*/
+		void free(AllocationId const& allocation);
+
+		/*
+		Extends the buffer. The new space is added at the end of the buffer so existing
+		allocations keep their offsets.
+
+		@param capacity New capacity of the buffer, must be larger than the current capacity
+		*/
+		void grow(size_t const& capacity);
+
+		/*
+		Packs every allocation to the start of the buffer so all free space is in a single range.
+		Allocations keep their relative order.
+
+		@return Ranges that moved, ordered by their destination
+		*/
+		std::vector<Move> defragment();
+
+		size_t getOffset(AllocationId const& allocation) const;
+		size_t getSize(AllocationId const& allocation) const;
+		bool isAllocated(AllocationId const& allocation) const { return m_allocations.find(allocation) != m_allocations.end(); }
+
+		size_t getCapacity() const { return m_capacity; }
+		size_t getUsedSize() const { return m_usedSize; }
+		size_t getFreeSize() const { return m_capacity - m_usedSize; }
+		size_t getAllocationCount() const { return m_allocations.size(); }
+		size_t getFreeRangeCount() const { return m_freeRangesByOffset.size(); }
+		size_t getLargestFreeRange() const;
+
+		/* Gets the ratio of used space to capacity, from 0 to 1 */
+		float getOccupancy() const;
+
+		/*
+		Gets how scattered the free space is, from 0 when it is all in a single range to close to 1
+		when it is split into many small ranges.
+		*/
+		float getFragmentation() const;
+	private:
+		struct Range
+		{
+			size_t offset;
+			size_t size;
+		};
+
+		void addFreeRange(size_t const& offset, size_t const& size);
+		void removeFreeRange(std::map<size_t, size_t>::iterator const& rangeByOffset);
+
+		size_t m_capacity;
+		size_t m_usedSize;
+		AllocationId m_nextAllocationId;
+		std::unordered_map<AllocationId, Range> m_allocations;
+		std::map<size_t, size_t> m_freeRangesByOffset;
+		std::multimap<size_t, size_t> m_freeRangesBySize;
+	};
+
+}
@@ -0,0 +1,268 @@
+#include "EnginePch.h"
+#include "Rendering\CookedMesh.h"
+
+namespace DerydocaEngine::Rendering::CookedMesh
+{
+
+	static const char FILE_MAGIC[4] = { 'D', 'M', 'S', 'H' };
+
+	// Vertex streams are aligned for SIMD friendly access, everything else to its largest member
+	static const size_t VERTEX_DATA_ALIGNMENT = 16;
+	static const size_t RECORD_ALIGNMENT = 4;
+
+	// Sanity limits so a corrupt file can not request absurd allocations
+	static const uint32_t MAX_ATTRIBUTES = 16;
+	static const uint32_t MAX_BONE_BINDINGS = 1 << 16;
+
+	struct FileHeader
+	{
+		char magic[4];
+		uint32_t version;
+		uint64_t sourceHash;
+		uint64_t sourceSize;
+		int64_t sourceWriteTime;
+		uint64_t settingsHash;
+		uint32_t flags;
+		uint8_t normalEncoding;
+		uint8_t texCoordEncoding;
+		uint8_t colorEncoding;
+		uint8_t boneWeightEncoding;
+		uint32_t compactBoneIndices;
+		uint32_t vertexCount;
+		uint32_t indexCount;
+		uint32_t stride;
+		uint32_t uncompressedStride;
+		uint32_t attributeCount;
+		uint32_t boneBindingCount;
+		float boundsMin[3];
+		float boundsMax[3];
+		float uvDensity;
+		uint64_t attributesOffset;
+		uint64_t boneBindingsOffset;
+		uint64_t vertexDataOffset;
+		uint64_t indexDataOffset;
+		uint64_t fileSize;
+	};
+
+	struct FileAttribute
+	{
+		uint32_t location;
+		int32_t components;
+		uint32_t type;
+		uint32_t normalized;
+		uint32_t integer;
+		uint32_t offset;
+	};
+
+	struct FileBoneBinding
+	{
+		uint32_t boneId;
+		uint32_t nameLength;
+	};
+
+	static size_t align(size_t const& offset, size_t const& alignment)
+	{
+		return (offset + alignment - 1) / alignment * alignment;
+	}
+
+	static void setSource(FileHeader& header, CookedMeshSource const& source)
+	{
+		header.sourceHash = source.sourceHash;
+		header.sourceSize = source.sourceSize;
+		header.sourceWriteTime = source.sourceWriteTime;
+		header.settingsHash = source.settingsHash;
+	}
+
+	void write(std::vector<uint8_t>& buffer, CookedMeshSource const& source, PackedMeshData const& mesh, std::vector<CookedBoneBinding> const& boneBindings)
+	{
+		FileHeader header{};
+		memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+		header.version = FORMAT_VERSION;
+		setSource(header, source);
+		header.flags = static_cast<uint32_t>(mesh.flags);
+		header.normalEncoding = static_cast<uint8_t>(mesh.layout.normals);
+		header.texCoordEncoding = static_cast<uint8_t>(mesh.layout.texCoords);
+		header.colorEncoding = static_cast<uint8_t>(mesh.layout.colors);
+		header.boneWeightEncoding = static_cast<uint8_t>(mesh.layout.boneWeights);
+		header.compactBoneIndices = mesh.layout.compactBoneIndices ? 1 : 0;
+		header.vertexCount = static_cast<uint32_t>(mesh.vertexCount);
+		header.indexCount = static_cast<uint32_t>(mesh.indexCount);
+		header.stride = static_cast<uint32_t>(mesh.stride);
+		header.uncompressedStride = static_cast<uint32_t>(mesh.uncompressedStride);
+		header.attributeCount = static_cast<uint32_t>(mesh.attributes.size());
+		header.boneBindingCount = static_cast<uint32_t>(boneBindings.size());
+		for (int i = 0; i < 3; i++)
+		{
+			header.boundsMin[i] = mesh.boundsMin[i];
+			header.boundsMax[i] = mesh.boundsMax[i];
+		}
+		header.uvDensity = mesh.uvDensity;
+
+		// Lay out every section before writing anything
+		size_t offset = sizeof(FileHeader);
+		header.attributesOffset = offset;
+		offset += mesh.attributes.size() * sizeof(FileAttribute);
+		header.boneBindingsOffset = offset;
+		for (auto const& binding : boneBindings)
+		{
+			offset = align(offset + sizeof(FileBoneBinding) + binding.name.size(), RECORD_ALIGNMENT);
+		}
+		header.vertexDataOffset = align(offset, VERTEX_DATA_ALIGNMENT);
+		offset = header.vertexDataOffset + mesh.vertexCount * mesh.stride;
+		header.indexDataOffset = align(offset, RECORD_ALIGNMENT);
+		header.fileSize = header.indexDataOffset + mesh.indexCount * sizeof(unsigned int);
+
+		buffer.assign(static_cast<size_t>(header.fileSize), 0);
+		memcpy(buffer.data(), &header, sizeof(header));
+
+		offset = static_cast<size_t>(header.attributesOffset);
+		for (auto const& attribute : mesh.attributes)
+		{
+			FileAttribute fileAttribute;
+			fileAttribute.location = attribute.location;
+			fileAttribute.components = attribute.components;
+			fileAttribute.type = static_cast<uint32_t>(attribute.type);
+			fileAttribute.normalized = attribute.normalized ? 1 : 0;
+			fileAttribute.integer = attribute.integer ? 1 : 0;
+			fileAttribute.offset = static_cast<uint32_t>(attribute.offset);
+			memcpy(buffer.data() + offset, &fileAttribute, sizeof(fileAttribute));
+			offset += sizeof(fileAttribute);
+		}
+
+		offset = static_cast<size_t>(header.boneBindingsOffset);
+		for (auto const& binding : boneBindings)
+		{
+			FileBoneBinding fileBinding;
+			fileBinding.boneId = binding.boneId;
+			fileBinding.nameLength = static_cast<uint32_t>(binding.name.size());
+			memcpy(buffer.data() + offset, &fileBinding, sizeof(fileBinding));
+			memcpy(buffer.data() + offset + sizeof(fileBinding), binding.name.data(), binding.name.size());
+			offset = align(offset + sizeof(fileBinding) + binding.name.size(), RECORD_ALIGNMENT);
+		}
+
+		if (mesh.vertexCount > 0)
+		{
+			memcpy(buffer.data() + header.vertexDataOffset, mesh.vertexData, mesh.vertexCount * mesh.stride);
+		}
+
+		if (mesh.indexCount > 0)
+		{
+			memcpy(buffer.data() + header.indexDataOffset, mesh.indices, mesh.indexCount * sizeof(unsigned int));
+		}
+	}
+
+	static bool readHeader(const uint8_t* data, size_t const& size, FileHeader& header)
+	{
+		if (data == nullptr || size < sizeof(FileHeader))
+		{
+			return false;
+		}
+
+		memcpy(&header, data, sizeof(header));
+		return memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0 &&
+			header.version == FORMAT_VERSION &&
+			header.fileSize == size;
+	}
+
+	bool read(const uint8_t* data, size_t const& size, CookedMeshSource& source, PackedMeshData& mesh, std::vector<CookedBoneBinding>& boneBindings)
+	{
+		FileHeader header;
+		if (!readHeader(data, size, header))
+		{
+			return false;
+		}
+
+		source.sourceHash = header.sourceHash;
+		source.sourceSize = header.sourceSize;
+		source.sourceWriteTime = header.sourceWriteTime;
+		source.settingsHash = header.settingsHash;
+
+		// Make sure every section lies within the file before touching it
+		if (header.attributeCount > MAX_ATTRIBUTES ||
+			header.boneBindingCount > MAX_BONE_BINDINGS ||
+			header.attributesOffset + header.attributeCount * sizeof(FileAttribute) > size ||
+			header.vertexDataOffset % VERTEX_DATA_ALIGNMENT != 0 ||
+			header.indexDataOffset % RECORD_ALIGNMENT != 0 ||
+			header.vertexDataOffset + (uint64_t)header.vertexCount * header.stride > header.indexDataOffset ||
+			header.indexDataOffset + (uint64_t)header.indexCount * sizeof(unsigned int) > size)
+		{
+			return false;
+		}
+
+		mesh.layout.normals = static_cast<NormalEncoding>(header.normalEncoding);
+		mesh.layout.texCoords = static_cast<TexCoordEncoding>(header.texCoordEncoding);
+		mesh.layout.colors = static_cast<ColorEncoding>(header.colorEncoding);
+		mesh.layout.boneWeights = static_cast<BoneWeightEncoding>(header.boneWeightEncoding);
+		mesh.layout.compactBoneIndices = header.compactBoneIndices != 0;
+		mesh.stride = header.stride;
+		mesh.uncompressedStride = header.uncompressedStride;
+		mesh.vertexCount = header.vertexCount;
+		mesh.indexCount = header.indexCount;
+		mesh.vertexData = data + header.vertexDataOffset;
+		mesh.indices = reinterpret_cast<const unsigned int*>(data + header.indexDataOffset);
+		mesh.boundsMin = glm::vec3(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+		mesh.boundsMax = glm::vec3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]);
+		mesh.uvDensity = header.uvDensity;
+		mesh.flags = static_cast<MeshFlags>(header.flags);
+
+		mesh.attributes.clear();
+		mesh.attributes.reserve(header.attributeCount);
+		size_t offset = static_cast<size_t>(header.attributesOffset);
+		for (uint32_t i = 0; i < header.attributeCount; i++)
+		{
+			FileAttribute fileAttribute;
+			memcpy(&fileAttribute, data + offset, sizeof(fileAttribute));
+			offset += sizeof(fileAttribute);
+
+			VertexAttribute attribute;
+			attribute.location = fileAttribute.location;
+			attribute.components = fileAttribute.components;
+			attribute.type = static_cast<VertexAttributeType>(fileAttribute.type);
+			attribute.normalized = fileAttribute.normalized != 0;
+			attribute.integer = fileAttribute.integer != 0;
+			attribute.offset = fileAttribute.offset;
+			mesh.attributes.push_back(attribute);
+		}
+
+		boneBindings.clear();
+		boneBindings.reserve(header.boneBindingCount);
+		offset = static_cast<size_t>(header.boneBindingsOffset);
+		for (uint32_t i = 0; i < header.boneBindingCount; i++)
+		{
+			FileBoneBinding fileBinding;
+			if (offset + sizeof(fileBinding) > header.vertexDataOffset)
+			{
+				return false;
+			}
+			memcpy(&fileBinding, data + offset, sizeof(fileBinding));
+
+			size_t nameOffset = offset + sizeof(fileBinding);
+			if (nameOffset + fileBinding.nameLength > header.vertexDataOffset)
+			{
+				return false;
+			}
+
+			CookedBoneBinding binding;
+			binding.name = std::string(reinterpret_cast<const char*>(data + nameOffset), fileBinding.nameLength);
+			binding.boneId = fileBinding.boneId;
+			boneBindings.push_back(binding);
+
+			offset = align(nameOffset + fileBinding.nameLength, RECORD_ALIGNMENT);
+		}
+
+		return true;
+	}
+
+	void updateSource(std::vector<uint8_t>& buffer, CookedMeshSource const& source)
+	{
+		FileHeader header;
+		if (!readHeader(buffer.data(), buffer.size(), header))
+		{
+			return;
+		}
+
+		setSource(header, source);
+		memcpy(buffer.data(), &header, sizeof(header));
+	}
+
+}
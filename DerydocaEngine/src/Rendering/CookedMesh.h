@@ -0,0 +1,97 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/vec3.hpp>
+
+#include "MeshFlags.h"
+#include "Rendering\VertexLayout.h"
+
+namespace DerydocaEngine::Rendering
+{
+
+	/*
+	Final GPU ready geometry of a mesh. The vertex and index data is not owned, it points at memory
+	such as a mapped cooked mesh file, which must stay alive until the mesh is created.
+	*/
+	struct PackedMeshData
+	{
+		VertexLayout layout;
+		std::vector<VertexAttribute> attributes;
+		/* Size of a single vertex in bytes */
+		size_t stride = 0;
+		/* Size of a single vertex in bytes if every attribute was stored as full precision floats */
+		size_t uncompressedStride = 0;
+		const uint8_t* vertexData = nullptr;
+		size_t vertexCount = 0;
+		/* Index data, already expanded to the adjacency layout for meshes with the load_adjacent flag */
+		const unsigned int* indices = nullptr;
+		size_t indexCount = 0;
+		glm::vec3 boundsMin = glm::vec3(0.0f);
+		glm::vec3 boundsMax = glm::vec3(0.0f);
+		/* UV units per unit of model space, used to pick the mip levels of streamed textures */
+		float uvDensity = 0.0f;
+		MeshFlags flags{};
+	};
+
+	/* Bone a skinned mesh's vertices were bound to when it was cooked */
+	struct CookedBoneBinding
+	{
+		std::string name;
+		unsigned int boneId;
+	};
+
+	/* Identifies the inputs a cooked mesh was built from */
+	struct CookedMeshSource
+	{
+		/* Hash of the contents of the source file */
+		uint64_t sourceHash = 0;
+		uint64_t sourceSize = 0;
+		int64_t sourceWriteTime = 0;
+		/* Hash of the import settings */
+		uint64_t settingsHash = 0;
+	};
+
+	/*
+	Reads and writes the .derymesh format. A cooked mesh is a fixed header followed by the vertex
+	attributes, the skeleton bindings, the interleaved vertex stream and the index stream. Streams
+	are aligned so they can be used in place from a memory mapped file.
+	*/
+	namespace CookedMesh
+	{
+
+		/* Bump whenever the layout of the file or the way meshes are imported changes */
+		static constexpr uint32_t FORMAT_VERSION = 2;
+
+		/*
+		Serializes a mesh.
+
+		@param buffer Receives the contents of the file
+		@param source Inputs the mesh was built from
+		@param mesh Geometry of the mesh
+		@param boneBindings Bones referenced by the mesh's bone indices, empty if the mesh is not skinned
+		*/
+		void write(std::vector<uint8_t>& buffer, CookedMeshSource const& source, PackedMeshData const& mesh, std::vector<CookedBoneBinding> const& boneBindings);
+
+		/*
+		Reads a cooked mesh without copying its streams.
+
+		@param data Contents of the file
+		@param size Size of the file in bytes
+		@param source Receives the inputs the mesh was built from
+		@param mesh Receives the geometry, pointing into data
+		@param boneBindings Receives the bones referenced by the mesh
+
+		@return False if the data is not a complete cooked mesh of the current version
+		*/
+		bool read(const uint8_t* data, size_t const& size, CookedMeshSource& source, PackedMeshData& mesh, std::vector<CookedBoneBinding>& boneBindings);
+
+		/*
+		Replaces the source stamp of a cooked mesh in place, used when the source file was touched
+		without its contents changing.
+		*/
+		void updateSource(std::vector<uint8_t>& buffer, CookedMeshSource const& source);
+
+	}
+
+}
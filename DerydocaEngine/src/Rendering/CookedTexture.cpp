@@ -0,0 +1,258 @@
+#include "EnginePch.h"
+#include "Rendering\CookedTexture.h"
+
+namespace DerydocaEngine::Rendering::CookedTexture
+{
+
+	static const char FILE_MAGIC[4] = { 'D', 'D', 'S', ' ' };
+	static const char STAMP_MAGIC[4] = { 'D', 'T', 'E', 'X' };
+	static const uint32_t DX10_FOUR_CC = 0x30315844;
+
+	// Values of the DDS header that every cooked texture shares
+	static const uint32_t HEADER_SIZE = 124;
+	static const uint32_t PIXEL_FORMAT_SIZE = 32;
+	static const uint32_t DDSD_CAPS_HEIGHT_WIDTH_PIXELFORMAT_MIPMAPCOUNT_LINEARSIZE = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000;
+	static const uint32_t DDPF_FOURCC = 0x4;
+	static const uint32_t DDSCAPS_COMPLEX_TEXTURE_MIPMAP = 0x8 | 0x1000 | 0x400000;
+	static const uint32_t DDSCAPS2_CUBEMAP_ALL_FACES = 0x200 | 0x400 | 0x800 | 0x1000 | 0x2000 | 0x4000 | 0x8000;
+	static const uint32_t D3D10_RESOURCE_DIMENSION_TEXTURE2D = 3;
+	static const uint32_t D3D10_RESOURCE_MISC_TEXTURECUBE = 0x4;
+	static const int CUBEMAP_FACE_COUNT = 6;
+
+	// Sanity limits so a corrupt file can not request absurd allocations
+	static const uint32_t MAX_DIMENSION = 16384;
+	static const uint32_t MAX_LEVELS = 15;
+
+	struct FilePixelFormat
+	{
+		uint32_t size;
+		uint32_t flags;
+		uint32_t fourCC;
+		uint32_t rgbBitCount;
+		uint32_t rBitMask;
+		uint32_t gBitMask;
+		uint32_t bBitMask;
+		uint32_t aBitMask;
+	};
+
+	struct FileHeader
+	{
+		char magic[4];
+		uint32_t size;
+		uint32_t flags;
+		uint32_t height;
+		uint32_t width;
+		uint32_t pitchOrLinearSize;
+		uint32_t depth;
+		uint32_t mipMapCount;
+		uint32_t reserved1[11];
+		FilePixelFormat pixelFormat;
+		uint32_t caps;
+		uint32_t caps2;
+		uint32_t caps3;
+		uint32_t caps4;
+		uint32_t reserved2;
+		uint32_t dxgiFormat;
+		uint32_t resourceDimension;
+		uint32_t miscFlag;
+		uint32_t arraySize;
+		uint32_t miscFlags2;
+	};
+
+	// Kept in the reserved words of the header, which DDS readers ignore
+	struct FileSourceStamp
+	{
+		char magic[4];
+		uint32_t version;
+		uint64_t sourceHash;
+		uint64_t sourceSize;
+		int64_t sourceWriteTime;
+		uint64_t settingsHash;
+	};
+
+	static_assert(sizeof(FileHeader) == 4 + HEADER_SIZE + 20, "The DDS header must not be padded");
+	static_assert(sizeof(FileSourceStamp) <= sizeof(FileHeader::reserved1), "The source stamp must fit in the reserved words");
+
+	static uint32_t formatToDxgiFormat(TextureCompressionFormat const& format)
+	{
+		switch (format)
+		{
+		case TextureCompressionFormat::BC1:
+			return 71;
+		case TextureCompressionFormat::BC3:
+			return 77;
+		case TextureCompressionFormat::BC4:
+			return 80;
+		case TextureCompressionFormat::BC5:
+			return 83;
+		case TextureCompressionFormat::BC7:
+			return 98;
+		default:
+			return 0;
+		}
+	}
+
+	static TextureCompressionFormat dxgiFormatToFormat(uint32_t const& dxgiFormat)
+	{
+		switch (dxgiFormat)
+		{
+		case 71:
+			return TextureCompressionFormat::BC1;
+		case 77:
+			return TextureCompressionFormat::BC3;
+		case 80:
+			return TextureCompressionFormat::BC4;
+		case 83:
+			return TextureCompressionFormat::BC5;
+		case 98:
+			return TextureCompressionFormat::BC7;
+		default:
+			return TextureCompressionFormat::None;
+		}
+	}
+
+	static void setSource(FileHeader& header, CookedTextureSource const& source)
+	{
+		FileSourceStamp stamp{};
+		memcpy(stamp.magic, STAMP_MAGIC, sizeof(STAMP_MAGIC));
+		stamp.version = FORMAT_VERSION;
+		stamp.sourceHash = source.sourceHash;
+		stamp.sourceSize = source.sourceSize;
+		stamp.sourceWriteTime = source.sourceWriteTime;
+		stamp.settingsHash = source.settingsHash;
+		memcpy(header.reserved1, &stamp, sizeof(stamp));
+	}
+
+	void write(std::vector<uint8_t>& buffer, CookedTextureSource const& source, CompressedTextureData const& texture)
+	{
+		FileHeader header{};
+		memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+		header.size = HEADER_SIZE;
+		header.flags = DDSD_CAPS_HEIGHT_WIDTH_PIXELFORMAT_MIPMAPCOUNT_LINEARSIZE;
+		header.height = texture.levels.empty() ? 0 : static_cast<uint32_t>(texture.levels[0].height);
+		header.width = texture.levels.empty() ? 0 : static_cast<uint32_t>(texture.levels[0].width);
+		header.pitchOrLinearSize = texture.levels.empty() ? 0 : static_cast<uint32_t>(texture.levels[0].size);
+		header.mipMapCount = static_cast<uint32_t>(texture.levels.size() / std::max(texture.faceCount, 1));
+		setSource(header, source);
+		header.pixelFormat.size = PIXEL_FORMAT_SIZE;
+		header.pixelFormat.flags = DDPF_FOURCC;
+		header.pixelFormat.fourCC = DX10_FOUR_CC;
+		header.caps = DDSCAPS_COMPLEX_TEXTURE_MIPMAP;
+		header.dxgiFormat = formatToDxgiFormat(texture.format);
+		header.resourceDimension = D3D10_RESOURCE_DIMENSION_TEXTURE2D;
+		header.arraySize = 1;
+		if (texture.faceCount == CUBEMAP_FACE_COUNT)
+		{
+			// The array size counts whole cubes, the faces are implied by the flag
+			header.caps2 = DDSCAPS2_CUBEMAP_ALL_FACES;
+			header.miscFlag = D3D10_RESOURCE_MISC_TEXTURECUBE;
+		}
+
+		size_t fileSize = sizeof(FileHeader);
+		for (auto const& level : texture.levels)
+		{
+			fileSize += level.size;
+		}
+
+		buffer.assign(fileSize, 0);
+		memcpy(buffer.data(), &header, sizeof(header));
+
+		size_t offset = sizeof(FileHeader);
+		for (auto const& level : texture.levels)
+		{
+			memcpy(buffer.data() + offset, level.data, level.size);
+			offset += level.size;
+		}
+	}
+
+	static bool readHeader(const uint8_t* data, size_t const& size, FileHeader& header, FileSourceStamp& stamp)
+	{
+		if (data == nullptr || size < sizeof(FileHeader))
+		{
+			return false;
+		}
+
+		memcpy(&header, data, sizeof(header));
+		memcpy(&stamp, header.reserved1, sizeof(stamp));
+		return memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0 &&
+			header.size == HEADER_SIZE &&
+			header.pixelFormat.fourCC == DX10_FOUR_CC &&
+			memcmp(stamp.magic, STAMP_MAGIC, sizeof(STAMP_MAGIC)) == 0 &&
+			stamp.version == FORMAT_VERSION;
+	}
+
+	bool read(const uint8_t* data, size_t const& size, CookedTextureSource& source, CompressedTextureData& texture)
+	{
+		FileHeader header;
+		FileSourceStamp stamp;
+		if (!readHeader(data, size, header, stamp))
+		{
+			return false;
+		}
+
+		source.sourceHash = stamp.sourceHash;
+		source.sourceSize = stamp.sourceSize;
+		source.sourceWriteTime = stamp.sourceWriteTime;
+		source.settingsHash = stamp.settingsHash;
+
+		TextureCompressionFormat format = dxgiFormatToFormat(header.dxgiFormat);
+		bool isCubemap = (header.miscFlag & D3D10_RESOURCE_MISC_TEXTURECUBE) != 0;
+		if (format == TextureCompressionFormat::None ||
+			header.resourceDimension != D3D10_RESOURCE_DIMENSION_TEXTURE2D ||
+			header.arraySize != 1 ||
+			header.width == 0 || header.width > MAX_DIMENSION ||
+			header.height == 0 || header.height > MAX_DIMENSION ||
+			(isCubemap && header.width != header.height) ||
+			header.mipMapCount == 0 || header.mipMapCount > MAX_LEVELS)
+		{
+			return false;
+		}
+
+		texture.format = format;
+		texture.faceCount = isCubemap ? CUBEMAP_FACE_COUNT : 1;
+		texture.levels.clear();
+		texture.levels.reserve(header.mipMapCount * texture.faceCount);
+
+		// Make sure every level lies within the file before handing it out. Each face of a cubemap
+		// is stored with its whole mip chain before the next face.
+		size_t offset = sizeof(FileHeader);
+		for (int face = 0; face < texture.faceCount; face++)
+		{
+			int width = static_cast<int>(header.width);
+			int height = static_cast<int>(header.height);
+			for (uint32_t i = 0; i < header.mipMapCount; i++)
+			{
+				CompressedTextureLevel level;
+				level.width = width;
+				level.height = height;
+				level.size = TextureCompression::getLevelSize(format, width, height);
+				level.data = data + offset;
+				if (offset + level.size > size)
+				{
+					return false;
+				}
+				texture.levels.push_back(level);
+
+				offset += level.size;
+				width = std::max(width / 2, 1);
+				height = std::max(height / 2, 1);
+			}
+		}
+
+		return offset == size;
+	}
+
+	void updateSource(std::vector<uint8_t>& buffer, CookedTextureSource const& source)
+	{
+		FileHeader header;
+		FileSourceStamp stamp;
+		if (!readHeader(buffer.data(), buffer.size(), header, stamp))
+		{
+			return;
+		}
+
+		setSource(header, source);
+		memcpy(buffer.data(), &header, sizeof(header));
+	}
+
+}
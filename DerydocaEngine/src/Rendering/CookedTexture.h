@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "Rendering\TextureCompression.h"
+
+namespace DerydocaEngine::Rendering
+{
+
+	/* Identifies the inputs a cooked texture was built from */
+	struct CookedTextureSource
+	{
+		/* Hash of the contents of the source file */
+		uint64_t sourceHash = 0;
+		uint64_t sourceSize = 0;
+		int64_t sourceWriteTime = 0;
+		/* Hash of the compression settings */
+		uint64_t settingsHash = 0;
+	};
+
+	/*
+	Reads and writes cooked textures as DDS files with the DX10 header extension, so they can be
+	inspected with any DDS viewer. The source stamp is kept in the reserved words of the header.
+	Levels follow the header from largest to smallest and are used in place from a memory mapped file.
+	Cubemaps keep all six faces in one file, each face with its full mip chain.
+	*/
+	namespace CookedTexture
+	{
+
+		/* Bump whenever the layout of the file or the way textures are compressed changes */
+		static constexpr uint32_t FORMAT_VERSION = 2;
+
+		/*
+		Serializes a compressed texture.
+
+		@param buffer Receives the contents of the file
+		@param source Inputs the texture was built from
+		@param texture Compressed levels of the texture
+		*/
+		void write(std::vector<uint8_t>& buffer, CookedTextureSource const& source, CompressedTextureData const& texture);
+
+		/*
+		Reads a cooked texture without copying its levels.
+
+		@param data Contents of the file
+		@param size Size of the file in bytes
+		@param source Receives the inputs the texture was built from
+		@param texture Receives the levels, pointing into data
+
+		@return False if the data is not a complete cooked texture of the current version
+		*/
+		bool read(const uint8_t* data, size_t const& size, CookedTextureSource& source, CompressedTextureData& texture);
+
+		/*
+		Replaces the source stamp of a cooked texture in place, used when the source file was
+		touched without its contents changing.
+		*/
+		void updateSource(std::vector<uint8_t>& buffer, CookedTextureSource const& source);
+
+	}
+
+}
@@ -0,0 +1,110 @@
+#include "EnginePch.h"
+#include "Rendering\CubemapImage.h"
+
+#include <algorithm>
+#include "Helpers\ParallelFor.h"
+#include "Rendering\TextureImage.h"
+
+namespace DerydocaEngine::Rendering
+{
+
+	// Channels follow the decoder, so images with one or two channels are grey with an optional alpha
+	static bool hasAlpha(int const& channels)
+	{
+		return channels == 2 || channels == 4;
+	}
+
+	static void convertChannels(const uint8_t* data, int const& pixelCount, int const& channels, int const& targetChannels, std::vector<uint8_t>& converted)
+	{
+		int colorChannels = hasAlpha(channels) ? channels - 1 : channels;
+		int targetColorChannels = hasAlpha(targetChannels) ? targetChannels - 1 : targetChannels;
+
+		converted.resize(static_cast<size_t>(pixelCount) * targetChannels);
+		for (int i = 0; i < pixelCount; i++)
+		{
+			const uint8_t* source = data + static_cast<size_t>(i) * channels;
+			uint8_t* destination = converted.data() + static_cast<size_t>(i) * targetChannels;
+			for (int c = 0; c < targetColorChannels; c++)
+			{
+				destination[c] = source[std::min(c, colorChannels - 1)];
+			}
+			if (hasAlpha(targetChannels))
+			{
+				destination[targetColorChannels] = hasAlpha(channels) ? source[colorChannels] : 255;
+			}
+		}
+	}
+
+	CubemapImage::CubemapImage() :
+		m_faces(),
+		m_channels(0)
+	{
+	}
+
+	CubemapImage::~CubemapImage()
+	{
+	}
+
+	bool CubemapImage::load(std::vector<std::string> const& faceFileNames, MipSettings const& settings)
+	{
+		release();
+		if (faceFileNames.size() != FACE_COUNT)
+		{
+			return false;
+		}
+
+		// Faces are decoded at the same time, the decoder does not share any state between threads
+		TextureImage images[FACE_COUNT];
+		Helpers::parallelFor(FACE_COUNT, [&](size_t face) {
+			images[face].load(faceFileNames[face], false);
+		});
+
+		// Every face has to have the same size and format, or the cubemap is incomplete
+		int colorChannels = 0;
+		bool anyAlpha = false;
+		for (int face = 0; face < FACE_COUNT; face++)
+		{
+			if (!images[face].isLoaded())
+			{
+				std::cout << "Failed to load texture for cubemap: " << faceFileNames[face] << "\n";
+				return false;
+			}
+
+			if (images[face].getWidth() != images[face].getHeight() || images[face].getWidth() != images[0].getWidth())
+			{
+				std::cout << "Cubemap faces must be square and of the same size: " << faceFileNames[face] << "\n";
+				return false;
+			}
+
+			int channels = images[face].getChannels();
+			colorChannels = std::max(colorChannels, hasAlpha(channels) ? channels - 1 : channels);
+			anyAlpha = anyAlpha || hasAlpha(channels);
+		}
+		m_channels = colorChannels + (anyAlpha ? 1 : 0);
+
+		Helpers::parallelFor(FACE_COUNT, [&](size_t face) {
+			TextureImage const& image = images[face];
+			if (image.getChannels() == m_channels)
+			{
+				MipGenerator::generate(image.getData(), image.getWidth(), image.getHeight(), m_channels, settings, m_faces[face]);
+				return;
+			}
+
+			std::vector<uint8_t> converted;
+			convertChannels(image.getData(), image.getWidth() * image.getHeight(), image.getChannels(), m_channels, converted);
+			MipGenerator::generate(converted.data(), image.getWidth(), image.getHeight(), m_channels, settings, m_faces[face]);
+		});
+
+		return true;
+	}
+
+	void CubemapImage::release()
+	{
+		for (auto& face : m_faces)
+		{
+			face.clear();
+		}
+		m_channels = 0;
+	}
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "Rendering\MipGenerator.h"
+
+namespace DerydocaEngine::Rendering
+{
+
+	/*
+	The six faces of a cubemap decoded on the CPU together with their mip chains, waiting to be
+	uploaded. The faces are decoded and filtered on several threads at once, and converted to the
+	same number of channels so they can share a single immutable texture.
+	*/
+	class CubemapImage
+	{
+	public:
+		static constexpr int FACE_COUNT = 6;
+
+		CubemapImage();
+		~CubemapImage();
+
+		/*
+		Decodes every face and builds their mip chains, releasing any faces that were previously loaded.
+
+		@param faceFileNames Paths of the faces in the order +X, -X, +Y, -Y, +Z, -Z
+		@param settings How to filter the levels
+		@return True if every face was decoded and they are all square and of the same size
+		*/
+		bool load(std::vector<std::string> const& faceFileNames, MipSettings const& settings);
+
+		/* Releases the levels of every face */
+		void release();
+
+		bool isLoaded() const { return !m_faces[0].empty(); }
+
+		/* Gets every level of a face, starting with the largest */
+		std::vector<MipLevel> const& getFaceLevels(int const& face) const { return m_faces[face]; }
+		int getSize() const { return isLoaded() ? m_faces[0][0].width : 0; }
+		int getLevelCount() const { return static_cast<int>(m_faces[0].size()); }
+		int getChannels() const { return m_channels; }
+
+		void operator=(CubemapImage const&) = delete;
+	private:
+		CubemapImage(CubemapImage const&);
+
+		std::vector<MipLevel> m_faces[FACE_COUNT];
+		int m_channels;
+	};
+
+}
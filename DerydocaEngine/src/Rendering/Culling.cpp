@@ -0,0 +1,39 @@
+#include "EnginePch.h"
+#include "Rendering\Culling.h"
+
+namespace DerydocaEngine::Rendering::Culling
+{
+
+	bool isBoxInsideClipVolume(glm::mat4 const& mvp, glm::vec3 const& boundsMin, glm::vec3 const& boundsMax)
+	{
+		// Count how many corners are outside of each of the six clip planes
+		int outside[6] = { 0, 0, 0, 0, 0, 0 };
+		for (int i = 0; i < 8; i++)
+		{
+			glm::vec4 corner = mvp * glm::vec4(
+				(i & 1) ? boundsMax.x : boundsMin.x,
+				(i & 2) ? boundsMax.y : boundsMin.y,
+				(i & 4) ? boundsMax.z : boundsMin.z,
+				1.0f);
+
+			if (corner.x < -corner.w) outside[0]++;
+			if (corner.x > corner.w) outside[1]++;
+			if (corner.y < -corner.w) outside[2]++;
+			if (corner.y > corner.w) outside[3]++;
+			if (corner.z < -corner.w) outside[4]++;
+			if (corner.z > corner.w) outside[5]++;
+		}
+
+		// The box can only be rejected if every corner is outside of the same plane
+		for (int i = 0; i < 6; i++)
+		{
+			if (outside[i] == 8)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+namespace DerydocaEngine::Rendering::Culling
+{
+
+	/*
+	Tests if an axis aligned bounding box is at least partially inside of a clip volume.
+
+	@param mvp Model view projection matrix transforming the box into clip space
+	@param boundsMin Minimum corner of the box in model space
+	@param boundsMax Maximum corner of the box in model space
+
+	@return True if any part of the box may be inside of the clip volume
+	*/
+	bool isBoxInsideClipVolume(glm::mat4 const& mvp, glm::vec3 const& boundsMin, glm::vec3 const& boundsMax);
+
+}
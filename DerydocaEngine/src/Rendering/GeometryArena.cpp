@@ -0,0 +1,446 @@
+#include "EnginePch.h"
+#include "Rendering\GeometryArena.h"
+
+#include <GL/glew.h>
+
+namespace DerydocaEngine::Rendering
+{
+
+	// Initial size of a pool, grown by doubling when it runs out of space
+	static const size_t INITIAL_VERTEX_CAPACITY = 1 << 16;
+	static const size_t INITIAL_INDEX_CAPACITY = 1 << 18;
+
+	// Storage buffer binding the shaders of merged draws read their draw data from
+	static const GLuint DRAW_DATA_BINDING = 0;
+
+	static GLenum getGLType(VertexAttributeType const& type)
+	{
+		switch (type)
+		{
+		case VertexAttributeType::HalfFloat:
+			return GL_HALF_FLOAT;
+		case VertexAttributeType::Byte:
+			return GL_BYTE;
+		case VertexAttributeType::UnsignedByte:
+			return GL_UNSIGNED_BYTE;
+		case VertexAttributeType::Short:
+			return GL_SHORT;
+		case VertexAttributeType::UnsignedShort:
+			return GL_UNSIGNED_SHORT;
+		case VertexAttributeType::UnsignedInt:
+			return GL_UNSIGNED_INT;
+		case VertexAttributeType::Int2101010Rev:
+			return GL_INT_2_10_10_10_REV;
+		default:
+			return GL_FLOAT;
+		}
+	}
+
+	static std::string getFormatName(std::vector<VertexAttribute> const& attributes, size_t const& stride)
+	{
+		std::string format = "stride:" + std::to_string(stride);
+		for (auto const& attribute : attributes)
+		{
+			format += " " + std::to_string(attribute.location) +
+				":" + std::to_string(attribute.components) +
+				"x" + std::to_string((int)attribute.type) +
+				(attribute.normalized ? "n" : "") +
+				(attribute.integer ? "i" : "") +
+				"@" + std::to_string(attribute.offset);
+		}
+		return format;
+	}
+
+	GeometryArena::GeometryArena() :
+		m_pools(),
+		m_queueingDraws(false),
+		m_queuedDrawData(),
+		m_indirectCommands(),
+		m_indirectBuffer(0),
+		m_drawDataBuffer(0),
+		m_mergedDrawCount(0),
+		m_multiDrawCount(0)
+	{
+	}
+
+	GeometryArena::~GeometryArena()
+	{
+	}
+
+	GeometryArena::Allocation GeometryArena::allocate(std::vector<VertexAttribute> const& attributes, size_t const& stride, const uint8_t* vertexData, size_t const& vertexCount, const unsigned int* indices, size_t const& indexCount)
+	{
+		Allocation allocation;
+		if (stride == 0 || vertexCount == 0)
+		{
+			return allocation;
+		}
+
+		allocation.pool = findOrCreatePool(attributes, stride);
+		Pool& pool = m_pools[allocation.pool];
+
+		// Copy the vertices into their range of the shared vertex buffer
+		allocation.vertices = allocateRange(pool, *pool.vertexAllocator, false, vertexCount);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, pool.vertexBuffer);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, pool.vertexAllocator->getOffset(allocation.vertices) * stride, vertexCount * stride, vertexData);
+
+		// Indices stay relative to the mesh's first vertex, the base vertex of each draw offsets them
+		if (indexCount > 0)
+		{
+			allocation.indices = allocateRange(pool, *pool.indexAllocator, true, indexCount);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, pool.indexBuffer);
+			glBufferSubData(GL_COPY_WRITE_BUFFER, pool.indexAllocator->getOffset(allocation.indices) * sizeof(unsigned int), indexCount * sizeof(unsigned int), indices);
+		}
+
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		return allocation;
+	}
+
+	void GeometryArena::free(Allocation& allocation)
+	{
+		if (!allocation.isValid())
+		{
+			return;
+		}
+
+		Pool& pool = m_pools[allocation.pool];
+		pool.vertexAllocator->free(allocation.vertices);
+		pool.indexAllocator->free(allocation.indices);
+
+		allocation = Allocation();
+	}
+
+	void GeometryArena::readBack(Allocation const& allocation, std::vector<uint8_t>& vertexData, std::vector<unsigned int>& indices) const
+	{
+		vertexData.clear();
+		indices.clear();
+		if (!allocation.isValid())
+		{
+			return;
+		}
+
+		Pool const& pool = m_pools[allocation.pool];
+		vertexData.resize(pool.vertexAllocator->getSize(allocation.vertices) * pool.stride);
+		glBindBuffer(GL_COPY_READ_BUFFER, pool.vertexBuffer);
+		glGetBufferSubData(GL_COPY_READ_BUFFER, pool.vertexAllocator->getOffset(allocation.vertices) * pool.stride, vertexData.size(), vertexData.data());
+
+		indices.resize(pool.indexAllocator->getSize(allocation.indices));
+		if (!indices.empty())
+		{
+			glBindBuffer(GL_COPY_READ_BUFFER, pool.indexBuffer);
+			glGetBufferSubData(GL_COPY_READ_BUFFER, pool.indexAllocator->getOffset(allocation.indices) * sizeof(unsigned int), indices.size() * sizeof(unsigned int), indices.data());
+		}
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+	}
+
+	void GeometryArena::draw(Allocation const& allocation, unsigned int const& mode, unsigned int const& indexCount, unsigned int const& instanceCount)
+	{
+		if (!allocation.isValid())
+		{
+			return;
+		}
+
+		Pool& pool = m_pools[allocation.pool];
+		size_t firstIndex = pool.indexAllocator->getOffset(allocation.indices);
+		GLint baseVertex = static_cast<GLint>(pool.vertexAllocator->getOffset(allocation.vertices));
+
+		glBindVertexArray(pool.vertexArray);
+		glDrawElementsInstancedBaseVertex(mode, indexCount, GL_UNSIGNED_INT, (void*)(firstIndex * sizeof(unsigned int)), instanceCount, baseVertex);
+		glBindVertexArray(0);
+	}
+
+	bool GeometryArena::beginDrawQueue()
+	{
+		// Shaders find their draw's data through gl_BaseInstanceARB
+		m_queueingDraws = GLEW_ARB_multi_draw_indirect && GLEW_ARB_shader_storage_buffer_object && GLEW_ARB_shader_draw_parameters;
+		return m_queueingDraws;
+	}
+
+	bool GeometryArena::queueDraw(Allocation const& allocation, unsigned int const& mode, unsigned int const& indexCount, DrawData const& drawData)
+	{
+		if (!m_queueingDraws || !allocation.isValid())
+		{
+			return false;
+		}
+
+		Pool& pool = m_pools[allocation.pool];
+		DrawCommand command;
+		command.count = indexCount;
+		command.instanceCount = 1;
+		command.firstIndex = static_cast<unsigned int>(pool.indexAllocator->getOffset(allocation.indices));
+		command.baseVertex = static_cast<int>(pool.vertexAllocator->getOffset(allocation.vertices));
+		command.baseInstance = static_cast<unsigned int>(m_queuedDrawData.size());
+		pool.queuedDraws[mode].push_back(command);
+		m_queuedDrawData.push_back(drawData);
+		return true;
+	}
+
+	void GeometryArena::flushDraws()
+	{
+		m_queueingDraws = false;
+		if (m_queuedDrawData.empty())
+		{
+			return;
+		}
+
+		// Gather the commands of every pool into one buffer so they are uploaded in a single call
+		m_indirectCommands.clear();
+		for (auto const& pool : m_pools)
+		{
+			for (auto const& draws : pool.queuedDraws)
+			{
+				m_indirectCommands.insert(m_indirectCommands.end(), draws.second.begin(), draws.second.end());
+			}
+		}
+
+		if (m_indirectBuffer == 0)
+		{
+			glGenBuffers(1, &m_indirectBuffer);
+			glGenBuffers(1, &m_drawDataBuffer);
+		}
+
+		// Orphan both buffers on every flush so the driver does not wait on the previous pass's draws
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_drawDataBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, m_queuedDrawData.size() * sizeof(DrawData), m_queuedDrawData.data(), GL_STREAM_DRAW);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_DATA_BINDING, m_drawDataBuffer);
+
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_indirectBuffer);
+		glBufferData(GL_DRAW_INDIRECT_BUFFER, m_indirectCommands.size() * sizeof(DrawCommand), m_indirectCommands.data(), GL_STREAM_DRAW);
+
+		size_t commandOffset = 0;
+		for (auto& pool : m_pools)
+		{
+			if (pool.queuedDraws.empty())
+			{
+				continue;
+			}
+
+			glBindVertexArray(pool.vertexArray);
+			for (auto& draws : pool.queuedDraws)
+			{
+				if (draws.second.empty())
+				{
+					continue;
+				}
+
+				glMultiDrawElementsIndirect(draws.first, GL_UNSIGNED_INT, (void*)(commandOffset * sizeof(DrawCommand)), static_cast<GLsizei>(draws.second.size()), 0);
+
+				commandOffset += draws.second.size();
+				m_mergedDrawCount += draws.second.size();
+				m_multiDrawCount++;
+				draws.second.clear();
+			}
+		}
+		glBindVertexArray(0);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_DATA_BINDING, 0);
+
+		m_queuedDrawData.clear();
+	}
+
+	unsigned int GeometryArena::getVertexArray(Allocation const& allocation) const
+	{
+		return allocation.isValid() ? m_pools[allocation.pool].vertexArray : 0;
+	}
+
+	size_t GeometryArena::getBaseVertex(Allocation const& allocation) const
+	{
+		return allocation.isValid() ? m_pools[allocation.pool].vertexAllocator->getOffset(allocation.vertices) : 0;
+	}
+
+	size_t GeometryArena::getFirstIndex(Allocation const& allocation) const
+	{
+		return allocation.isValid() ? m_pools[allocation.pool].indexAllocator->getOffset(allocation.indices) : 0;
+	}
+
+	void GeometryArena::defragment(float const& fragmentationThreshold)
+	{
+		for (auto& pool : m_pools)
+		{
+			if (pool.vertexAllocator->getFragmentation() > fragmentationThreshold ||
+				pool.indexAllocator->getFragmentation() > fragmentationThreshold)
+			{
+				defragmentPool(pool);
+			}
+		}
+	}
+
+	std::vector<GeometryArena::PoolStatistics> GeometryArena::getStatistics() const
+	{
+		std::vector<PoolStatistics> statistics;
+		for (auto const& pool : m_pools)
+		{
+			PoolStatistics poolStatistics;
+			poolStatistics.format = pool.format;
+			poolStatistics.allocationCount = pool.vertexAllocator->getAllocationCount();
+			poolStatistics.vertexCapacityBytes = pool.vertexAllocator->getCapacity() * pool.stride;
+			poolStatistics.vertexUsedBytes = pool.vertexAllocator->getUsedSize() * pool.stride;
+			poolStatistics.indexCapacityBytes = pool.indexAllocator->getCapacity() * sizeof(unsigned int);
+			poolStatistics.indexUsedBytes = pool.indexAllocator->getUsedSize() * sizeof(unsigned int);
+			poolStatistics.freeRangeCount = pool.vertexAllocator->getFreeRangeCount() + pool.indexAllocator->getFreeRangeCount();
+			poolStatistics.vertexFragmentation = pool.vertexAllocator->getFragmentation();
+			poolStatistics.indexFragmentation = pool.indexAllocator->getFragmentation();
+			poolStatistics.defragmentationCount = pool.defragmentationCount;
+			statistics.push_back(poolStatistics);
+		}
+		return statistics;
+	}
+
+	void GeometryArena::printStatistics() const
+	{
+		auto statistics = getStatistics();
+		printf("Geometry arena: %zu pools, %zu draws merged into %zu multi draw calls\n", statistics.size(), m_mergedDrawCount, m_multiDrawCount);
+		for (auto const& pool : statistics)
+		{
+			printf("  [%s] %zu meshes, vertices %.1f/%.1f KB (%.0f%% fragmented), indices %.1f/%.1f KB (%.0f%% fragmented), %zu free ranges, defragmented %d times\n",
+				pool.format.c_str(),
+				pool.allocationCount,
+				pool.vertexUsedBytes / 1024.0f,
+				pool.vertexCapacityBytes / 1024.0f,
+				pool.vertexFragmentation * 100.0f,
+				pool.indexUsedBytes / 1024.0f,
+				pool.indexCapacityBytes / 1024.0f,
+				pool.indexFragmentation * 100.0f,
+				pool.freeRangeCount,
+				pool.defragmentationCount);
+		}
+	}
+
+	int GeometryArena::findOrCreatePool(std::vector<VertexAttribute> const& attributes, size_t const& stride)
+	{
+		std::string format = getFormatName(attributes, stride);
+		for (size_t i = 0; i < m_pools.size(); i++)
+		{
+			if (m_pools[i].format == format)
+			{
+				return static_cast<int>(i);
+			}
+		}
+
+		Pool pool;
+		pool.format = format;
+		pool.attributes = attributes;
+		pool.stride = stride;
+		pool.vertexArray = 0;
+		pool.vertexBuffer = 0;
+		pool.indexBuffer = 0;
+		pool.vertexAllocator = std::make_unique<BufferSubAllocator>(INITIAL_VERTEX_CAPACITY);
+		pool.indexAllocator = std::make_unique<BufferSubAllocator>(INITIAL_INDEX_CAPACITY);
+		pool.defragmentationCount = 0;
+
+		// Allocate storage for both buffers up front
+		glGenBuffers(1, &pool.vertexBuffer);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, pool.vertexBuffer);
+		glBufferData(GL_COPY_WRITE_BUFFER, INITIAL_VERTEX_CAPACITY * stride, nullptr, GL_STATIC_DRAW);
+		glGenBuffers(1, &pool.indexBuffer);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, pool.indexBuffer);
+		glBufferData(GL_COPY_WRITE_BUFFER, INITIAL_INDEX_CAPACITY * sizeof(unsigned int), nullptr, GL_STATIC_DRAW);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		createVertexArray(pool);
+
+		m_pools.push_back(std::move(pool));
+		return static_cast<int>(m_pools.size() - 1);
+	}
+
+	void GeometryArena::createVertexArray(Pool& pool)
+	{
+		if (pool.vertexArray == 0)
+		{
+			glGenVertexArrays(1, &pool.vertexArray);
+		}
+
+		// Point the attributes at the pool's current buffers
+		glBindVertexArray(pool.vertexArray);
+		glBindBuffer(GL_ARRAY_BUFFER, pool.vertexBuffer);
+		GLsizei stride = static_cast<GLsizei>(pool.stride);
+		for (auto const& attribute : pool.attributes)
+		{
+			glEnableVertexAttribArray(attribute.location);
+			if (attribute.integer)
+			{
+				glVertexAttribIPointer(attribute.location, attribute.components, getGLType(attribute.type), stride, (void*)attribute.offset);
+			}
+			else
+			{
+				glVertexAttribPointer(attribute.location, attribute.components, getGLType(attribute.type), attribute.normalized ? GL_TRUE : GL_FALSE, stride, (void*)attribute.offset);
+			}
+		}
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pool.indexBuffer);
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	BufferSubAllocator::AllocationId GeometryArena::allocateRange(Pool& pool, BufferSubAllocator& allocator, bool const& isIndexBuffer, size_t const& size)
+	{
+		auto allocation = allocator.allocate(size);
+		if (allocation != BufferSubAllocator::INVALID_ALLOCATION)
+		{
+			return allocation;
+		}
+
+		// Compact the pool if there is enough space in total, it is just scattered
+		if (allocator.getFreeSize() >= size)
+		{
+			defragmentPool(pool);
+			allocation = allocator.allocate(size);
+			if (allocation != BufferSubAllocator::INVALID_ALLOCATION)
+			{
+				return allocation;
+			}
+		}
+
+		// Otherwise grow the buffer so repeated allocations do not keep reallocating it
+		size_t capacity = std::max(allocator.getCapacity() * 2, allocator.getUsedSize() + size);
+		resizeBuffer(pool, isIndexBuffer, capacity, {});
+		allocator.grow(capacity);
+		return allocator.allocate(size);
+	}
+
+	void GeometryArena::resizeBuffer(Pool& pool, bool const& isIndexBuffer, size_t const& capacity, std::vector<BufferSubAllocator::Move> const& moves)
+	{
+		BufferSubAllocator& allocator = isIndexBuffer ? *pool.indexAllocator : *pool.vertexAllocator;
+		unsigned int& buffer = isIndexBuffer ? pool.indexBuffer : pool.vertexBuffer;
+		size_t unitSize = isIndexBuffer ? sizeof(unsigned int) : pool.stride;
+
+		unsigned int newBuffer = 0;
+		glGenBuffers(1, &newBuffer);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, newBuffer);
+		glBufferData(GL_COPY_WRITE_BUFFER, capacity * unitSize, nullptr, GL_STATIC_DRAW);
+
+		// Copy everything over, then move the ranges that were relocated. Reading from the old
+		// buffer means moved ranges can never overwrite data that still has to be copied.
+		glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, std::min(allocator.getCapacity(), capacity) * unitSize);
+		for (auto const& move : moves)
+		{
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, move.sourceOffset * unitSize, move.destinationOffset * unitSize, move.size * unitSize);
+		}
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		glDeleteBuffers(1, &buffer);
+		buffer = newBuffer;
+
+		createVertexArray(pool);
+	}
+
+	void GeometryArena::defragmentPool(Pool& pool)
+	{
+		auto vertexMoves = pool.vertexAllocator->defragment();
+		if (!vertexMoves.empty())
+		{
+			resizeBuffer(pool, false, pool.vertexAllocator->getCapacity(), vertexMoves);
+		}
+
+		auto indexMoves = pool.indexAllocator->defragment();
+		if (!indexMoves.empty())
+		{
+			resizeBuffer(pool, true, pool.indexAllocator->getCapacity(), indexMoves);
+		}
+
+		pool.defragmentationCount++;
+	}
+
+}
@@ -0,0 +1,205 @@
+#pragma once
+#include <glm/mat4x4.hpp>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Rendering\BufferSubAllocator.h"
+#include "Rendering\VertexLayout.h"
+
+namespace DerydocaEngine::Rendering
+{
+
+	/*
+	Stores the geometry of many meshes in a few large buffers. Meshes that share a vertex format
+	share a pool with a single vertex array, vertex buffer and index buffer, and only own a range
+	of each, so loading and unloading a mesh does not create or delete any GL objects. Passes that
+	draw many meshes with the same state can queue their draws, which are merged into a single
+	multi draw call per pool.
+	*/
+	class GeometryArena
+	{
+	public:
+		/* Ranges of the arena owned by a single mesh */
+		struct Allocation
+		{
+			int pool = -1;
+			BufferSubAllocator::AllocationId vertices = BufferSubAllocator::INVALID_ALLOCATION;
+			BufferSubAllocator::AllocationId indices = BufferSubAllocator::INVALID_ALLOCATION;
+
+			bool isValid() const { return pool >= 0; }
+		};
+
+		/* Occupancy of a single pool */
+		struct PoolStatistics
+		{
+			std::string format;
+			size_t allocationCount;
+			size_t vertexCapacityBytes;
+			size_t vertexUsedBytes;
+			size_t indexCapacityBytes;
+			size_t indexUsedBytes;
+			size_t freeRangeCount;
+			float vertexFragmentation;
+			float indexFragmentation;
+			int defragmentationCount;
+		};
+
+		/*
+		Data of a single queued draw. Vertex shaders read it from an std430 storage buffer at binding 0,
+		at the index the draw passes through gl_BaseInstanceARB.
+		*/
+		struct DrawData
+		{
+			glm::mat4 mvp;
+		};
+
+		static GeometryArena& getInstance()
+		{
+			static GeometryArena instance;
+			return instance;
+		}
+
+		/*
+		Copies the geometry of a mesh into the arena.
+
+		@param attributes Attributes of each vertex
+		@param stride Size of a single vertex in bytes
+		@param vertexData Interleaved vertex data
+		@param vertexCount Number of vertices
+		@param indices Indices of the mesh, relative to its first vertex
+		@param indexCount Number of indices
+
+		@return Ranges of the arena the mesh was placed in
+		*/
+		Allocation allocate(std::vector<VertexAttribute> const& attributes, size_t const& stride, const uint8_t* vertexData, size_t const& vertexCount, const unsigned int* indices, size_t const& indexCount);
+
+		/*
+		Releases the ranges owned by a mesh.
+
+		@param allocation Allocation to release, reset to an invalid allocation
+		*/
+		void free(Allocation& allocation);
+
+		/*
+		Copies the geometry of a mesh back from the GPU, used to move a mesh that has no CPU side copy.
+
+		@param allocation Allocation of the mesh
+		@param vertexData Receives the interleaved vertex data
+		@param indices Receives the indices of the mesh
+		*/
+		void readBack(Allocation const& allocation, std::vector<uint8_t>& vertexData, std::vector<unsigned int>& indices) const;
+
+		/*
+		Draws a mesh stored in the arena.
+
+		@param allocation Allocation of the mesh
+		@param mode Primitive type to draw
+		@param indexCount Number of indices to draw
+		@param instanceCount Number of instances to draw
+		*/
+		void draw(Allocation const& allocation, unsigned int const& mode, unsigned int const& indexCount, unsigned int const& instanceCount = 1);
+
+		/*
+		Starts queueing draws instead of issuing them. The shader bound when they are flushed must read
+		each draw's data from the storage buffer described by DrawData.
+
+		@return False if the driver can not merge draws, in which case nothing is queued
+		*/
+		bool beginDrawQueue();
+
+		/*
+		Queues a draw to be merged with every other queued draw of the same pool and primitive type.
+
+		@param allocation Allocation of the mesh
+		@param mode Primitive type to draw
+		@param indexCount Number of indices to draw
+		@param drawData Data the shader reads for this draw in place of per object uniforms
+		@return False if no queue is open or the mesh is not in the arena, in which case it has to be drawn directly
+		*/
+		bool queueDraw(Allocation const& allocation, unsigned int const& mode, unsigned int const& indexCount, DrawData const& drawData);
+
+		/* Whether draws are being queued */
+		bool isQueueingDraws() const { return m_queueingDraws; }
+
+		/*
+		Issues every queued draw with one glMultiDrawElementsIndirect call per pool and primitive
+		type, and closes the queue. The shader that reads the draw data is expected to be bound.
+		*/
+		void flushDraws();
+
+		/*
+		Gets the vertex array of the pool an allocation lives in. It is shared with every other mesh
+		in the pool and keeps its id when the pool grows or is defragmented.
+		*/
+		unsigned int getVertexArray(Allocation const& allocation) const;
+
+		/* Gets the index of the first vertex of an allocation within its pool's vertex buffer */
+		size_t getBaseVertex(Allocation const& allocation) const;
+
+		/* Gets the index of the first index of an allocation within its pool's index buffer */
+		size_t getFirstIndex(Allocation const& allocation) const;
+
+		/*
+		Packs the allocations of every pool whose free space is too scattered.
+
+		@param fragmentationThreshold Pools with a fragmentation above this value are packed
+		*/
+		void defragment(float const& fragmentationThreshold = 0.5f);
+
+		std::vector<PoolStatistics> getStatistics() const;
+
+		/*
+		Prints the occupancy and fragmentation of every pool, and how many draws were merged.
+		*/
+		void printStatistics() const;
+
+		void operator=(GeometryArena const&) = delete;
+	private:
+		/* Layout of a draw in the indirect buffer, as glMultiDrawElementsIndirect reads it */
+		struct DrawCommand
+		{
+			unsigned int count;
+			unsigned int instanceCount;
+			unsigned int firstIndex;
+			int baseVertex;
+			unsigned int baseInstance;
+		};
+
+		struct Pool
+		{
+			std::string format;
+			std::vector<VertexAttribute> attributes;
+			size_t stride;
+			unsigned int vertexArray;
+			unsigned int vertexBuffer;
+			unsigned int indexBuffer;
+			std::unique_ptr<BufferSubAllocator> vertexAllocator;
+			std::unique_ptr<BufferSubAllocator> indexAllocator;
+			// Queued draws by primitive type
+			std::map<unsigned int, std::vector<DrawCommand>> queuedDraws;
+			int defragmentationCount;
+		};
+
+		GeometryArena();
+		GeometryArena(GeometryArena const&);
+		~GeometryArena();
+
+		int findOrCreatePool(std::vector<VertexAttribute> const& attributes, size_t const& stride);
+		void createVertexArray(Pool& pool);
+		BufferSubAllocator::AllocationId allocateRange(Pool& pool, BufferSubAllocator& allocator, bool const& isIndexBuffer, size_t const& size);
+		void resizeBuffer(Pool& pool, bool const& isIndexBuffer, size_t const& capacity, std::vector<BufferSubAllocator::Move> const& moves);
+		void defragmentPool(Pool& pool);
+
+		std::vector<Pool> m_pools;
+		bool m_queueingDraws;
+		// Data of every queued draw, indexed by the draw's base instance
+		std::vector<DrawData> m_queuedDrawData;
+		std::vector<DrawCommand> m_indirectCommands;
+		unsigned int m_indirectBuffer;
+		unsigned int m_drawDataBuffer;
+		size_t m_mergedDrawCount;
+		size_t m_multiDrawCount;
+	};
+
+}
@@ -99,6 +99,25 @@ namespace DerydocaEngine::Rendering
 					std::string shadowMatrixName = "Lights[" + std::to_string(lightIndex) + "].ShadowMatrix";
 					shader->setMat4(shadowMatrixName, light->getShadowMatrix(matrixStack->getMatrix()));
 				}
+
+				// Set the cascade splits and the shadow matrix of each cascade
+				if (light->usesShadowCascades())
+				{
+					std::string cascadeCountName = "Lights[" + std::to_string(lightIndex) + "].CascadeCount";
+					shader->setInt(cascadeCountName, light->getShadowCascadeCount());
+
+					std::string cascadeSplitsName = "Lights[" + std::to_string(lightIndex) + "].CascadeSplits";
+					shader->setVec4(cascadeSplitsName, light->getCascadeSplitDepths());
+
+					if (matrixStack)
+					{
+						for (int cascadeIndex = 0; cascadeIndex < light->getShadowCascadeCount(); cascadeIndex++)
+						{
+							std::string cascadeMatrixName = "Lights[" + std::to_string(lightIndex) + "].CascadeShadowMatrices[" + std::to_string(cascadeIndex) + "]";
+							shader->setMat4(cascadeMatrixName, light->getCascadeShadowMatrix(cascadeIndex, matrixStack->getMatrix()));
+						}
+					}
+				}
 			}
 
 			// Increase our light index
@@ -115,17 +134,17 @@ namespace DerydocaEngine::Rendering
 		shader->setInt("LightCount", (int)lights.size());
 	}
 
-	void LightManager::renderShadowMaps(const std::vector<std::shared_ptr<Scenes::Scene>> scenes, std::shared_ptr<Components::Transform> cameraTransform)
+	void LightManager::renderShadowMaps(const std::vector<std::shared_ptr<Scenes::Scene>> scenes, std::shared_ptr<Components::Camera> camera)
 	{
 		// Get a list of lights that are visible by the camera
-		auto lights = getLights(cameraTransform);
+		auto lights = getLights(camera->getGameObject()->getTransform());
 
-		// Render the shadown map for each light
+		// Render the shadown map for each light, fitting directional light cascades to the camera
 		for each (auto light in lights)
 		{
 			if (light->isCastingShadows())
 			{
-				light->renderShadowMap(scenes);
+				light->renderShadowMap(scenes, camera);
 			}
 		}
 	}
@@ -6,6 +6,7 @@
 
 namespace DerydocaEngine {
 	namespace Components {
+		class Camera;
 		class Light;
 		struct Transform;
 	}
@@ -44,7 +45,7 @@ namespace DerydocaEngine::Rendering
 				return false;
 			});
 		}
-		void renderShadowMaps(const std::vector<std::shared_ptr<Scenes::Scene>> scenes, std::shared_ptr<Components::Transform> cameraTransform);
+		void renderShadowMaps(const std::vector<std::shared_ptr<Scenes::Scene>> scenes, std::shared_ptr<Components::Camera> camera);
 
 		void operator=(LightManager const&) = delete;
 	private:
@@ -1,9 +1,12 @@
 #include "EnginePch.h"
 #include "Rendering\Material.h"
 
+#include <algorithm>
 #include <gl\glew.h>
 #include "Rendering\Shader.h"
 #include "Rendering\Texture.h"
+#include "Rendering\TextureStreaming.h"
+#include "Resources\TextureStreamer.h"
 #include "Color.h"
 
 namespace DerydocaEngine::Rendering
@@ -21,7 +24,10 @@ namespace DerydocaEngine::Rendering
 		m_mat3Values(),
 		m_mat4Values(),
 		m_mat4ArrayValues(),
-		m_subroutineValues()
+		m_subroutineValues(),
+		m_keywords(),
+		m_variantKey(),
+		m_variantKeyDirty(true)
 	{
 	}
 
@@ -29,12 +35,70 @@ namespace DerydocaEngine::Rendering
 	{
 	}
 
-	void Material::bind() const
+	std::shared_ptr<Rendering::Shader> Material::getShader(ShaderVariantKey const& rendererKey) const
+	{
+		if (!m_shader || (m_keywords.empty() && rendererKey.isDefault()))
+		{
+			return m_shader;
+		}
+
+		// Only rebuild the key when the shader or keywords change
+		if (m_variantKeyDirty)
+		{
+			m_variantKey = ShaderVariantKey::fromKeywords(m_shader->getKeywords(), m_keywords);
+			m_variantKeyDirty = false;
+		}
+
+		ShaderVariantKey variantKey(m_variantKey.getMask() | rendererKey.getMask());
+		if (rendererKey.isDefault())
+		{
+			return m_shader->getVariant(variantKey);
+		}
+
+		// Drawing without the renderer's keywords would misread its vertices, so at most the material's own are left out
+		auto variant = m_shader->getVariant(variantKey, false);
+		if (!variant && variantKey != rendererKey)
+		{
+			variant = m_shader->getVariant(rendererKey, false);
+		}
+		return variant;
+	}
+
+	void Material::enableKeyword(std::string const& keyword)
+	{
+		if (!isKeywordEnabled(keyword))
+		{
+			m_keywords.push_back(keyword);
+			m_variantKeyDirty = true;
+		}
+	}
+
+	void Material::disableKeyword(std::string const& keyword)
+	{
+		auto it = std::find(m_keywords.begin(), m_keywords.end(), keyword);
+		if (it != m_keywords.end())
+		{
+			m_keywords.erase(it);
+			m_variantKeyDirty = true;
+		}
+	}
+
+	bool Material::isKeywordEnabled(std::string const& keyword) const
+	{
+		return std::find(m_keywords.begin(), m_keywords.end(), keyword) != m_keywords.end();
+	}
+
+	void Material::bind(ShaderVariantKey const& rendererKey) const
 	{
 		assert(m_shader);
+		auto shader = getShader(rendererKey);
+		if (!shader)
+		{
+			return;
+		}
 
 		// TODO: Remove this texture binding method
-		m_shader->bind();
+		shader->bind();
 		if (m_texture != NULL)
 		{
 			m_texture->bind(0);
@@ -44,59 +108,64 @@ namespace DerydocaEngine::Rendering
 			int texIndex = 0;
 			for (auto const& x : m_textures)
 			{
-				m_shader->setTexture(x.first, texIndex++, x.second);
+				shader->setTexture(x.first, texIndex++, x.second);
 			}
 		}
 
 		for (auto const& x : m_floatValues)
 		{
-			m_shader->setFloat(x.first, x.second);
+			shader->setFloat(x.first, x.second);
 		}
 
 		for (auto const& x : m_floatArrayValues)
 		{
-			m_shader->setFloatArray(x.first, x.second);
+			shader->setFloatArray(x.first, x.second);
 		}
 
 		for (auto const& x : m_intValues)
 		{
-			m_shader->setInt(x.first, x.second);
+			shader->setInt(x.first, x.second);
 		}
 
 		for (auto const& x : m_vec3Values)
 		{
-			m_shader->setVec3(x.first, x.second);
+			shader->setVec3(x.first, x.second);
 		}
 
 		for (auto const& x : m_vec4Values)
 		{
-			m_shader->setVec4(x.first, x.second);
+			shader->setVec4(x.first, x.second);
 		}
 
 		for (auto const& x : m_mat3Values)
 		{
-			m_shader->setMat3(x.first, x.second);
+			shader->setMat3(x.first, x.second);
 		}
 
 		for (auto const& x : m_mat4Values)
 		{
-			m_shader->setMat4(x.first, x.second);
+			shader->setMat4(x.first, x.second);
 		}
 
 		for (auto const& x : m_mat4ArrayValues)
 		{
-			m_shader->setMat4Array(x.first, x.second);
+			shader->setMat4Array(x.first, x.second);
 		}
 
 		for (auto const& x : m_subroutineValues)
 		{
-			m_shader->setSubroutine(x.first, x.second);
+			shader->setSubroutine(x.first, x.second);
 		}
 
 	}
 
 	void Material::copyFrom(std::shared_ptr<Material> other)
 	{
+		if (!other)
+		{
+			return;
+		}
+
 		m_boolValues = other->m_boolValues;
 		m_floatValues = other->m_floatValues;
 		m_floatArrayValues = other->m_floatArrayValues;
@@ -110,48 +179,76 @@ namespace DerydocaEngine::Rendering
 		m_vec3Values = other->m_vec3Values;
 		m_vec4Values = other->m_vec4Values;
 		m_shader = other->m_shader;
+		m_keywords = other->m_keywords;
+		m_variantKeyDirty = true;
+	}
+
+	void Material::requestTextureLevels(float const& uvPerWorldUnit, float const& pixelsPerWorldUnit) const
+	{
+		auto requestTexture = [&](std::shared_ptr<Texture> const& texture)
+		{
+			if (!texture || !texture->isStreamed())
+			{
+				return;
+			}
+
+			float texelsPerWorldUnit = uvPerWorldUnit * std::max(texture->getWidth(), texture->getHeight());
+			int level = TextureStreaming::calculateRequiredLevel(texelsPerWorldUnit, pixelsPerWorldUnit, texture->getLevelCount());
+			Resources::TextureStreamer::getInstance().request(*texture, level);
+		};
+
+		requestTexture(m_texture);
+		for (auto const& x : m_textures)
+		{
+			requestTexture(x.second);
+		}
 	}
 
-	void Material::unbind()
+	void Material::unbind(ShaderVariantKey const& rendererKey)
 	{
 		assert(m_shader);
+		auto shader = getShader(rendererKey);
+		if (!shader)
+		{
+			return;
+		}
 
 		{
 			int texIndex = 0;
 			for (auto const& x : m_textures)
 			{
-				m_shader->clearTexture(x.first, texIndex++, x.second->getTextureType());
+				shader->clearTexture(x.first, texIndex++, x.second->getTextureType());
 			}
 		}
 
 		for (auto const& x : m_floatValues)
 		{
-			m_shader->clearFloat(x.first);
+			shader->clearFloat(x.first);
 		}
 
 		for (auto const& x : m_intValues)
 		{
-			m_shader->clearInt(x.first);
+			shader->clearInt(x.first);
 		}
 
 		for (auto const& x : m_vec3Values)
 		{
-			m_shader->clearVec3(x.first);
+			shader->clearVec3(x.first);
 		}
 
 		for (auto const& x : m_vec4Values)
 		{
-			m_shader->clearVec4(x.first);
+			shader->clearVec4(x.first);
 		}
 
 		for (auto const& x : m_mat3Values)
 		{
-			m_shader->clearMat3(x.first);
+			shader->clearMat3(x.first);
 		}
 
 		for (auto const& x : m_mat4Values)
 		{
-			m_shader->clearMat4(x.first);
+			shader->clearMat4(x.first);
 		}
 	}
 
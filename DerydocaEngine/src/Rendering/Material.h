@@ -5,7 +5,9 @@
 #include <glm\vec3.hpp>
 #include <glm\vec4.hpp>
 #include <memory>
+#include <string>
 #include <vector>
+#include "Rendering\ShaderVariantKey.h"
 
 namespace DerydocaEngine
 {
@@ -26,12 +28,39 @@ namespace DerydocaEngine::Rendering
 		Material();
 		~Material();
 
-		inline void setShader(std::shared_ptr<Shader> shader) { m_shader = shader; }
-		inline std::shared_ptr<Rendering::Shader> getShader() const { return m_shader; }
+		inline void setShader(std::shared_ptr<Shader> shader) { m_shader = shader; m_variantKeyDirty = true; }
+
+		/*
+		Gets the variant of the material's shader that matches its enabled keywords. The shader
+		itself is returned while the variant is still being built.
+
+		@param rendererKey Keywords the drawing renderer enables on top of the material's own, which
+			leaves a material shared with other renderers as it is. See RendererKeywords. These
+			describe how the renderer's vertices are read, so the shader cannot stand in for them.
+		@return The shader to draw with, or nullptr while no variant with the renderer's keywords is ready
+		*/
+		std::shared_ptr<Rendering::Shader> getShader(ShaderVariantKey const& rendererKey = ShaderVariantKey()) const;
+
+		/* Gets the shader assigned to the material, regardless of its enabled keywords */
+		inline std::shared_ptr<Rendering::Shader> getBaseShader() const { return m_shader; }
+
+		void enableKeyword(std::string const& keyword);
+		void disableKeyword(std::string const& keyword);
+		bool isKeywordEnabled(std::string const& keyword) const;
+		std::vector<std::string> const& getKeywords() const { return m_keywords; }
 		
-		void bind() const;
+		void bind(ShaderVariantKey const& rendererKey = ShaderVariantKey()) const;
 		void copyFrom(std::shared_ptr<Material> other);
-		void unbind();
+
+		/*
+		Asks the texture streamer for the levels the material's streamed textures need to draw a
+		surface.
+
+		@param uvPerWorldUnit UV units the surface spans per world unit
+		@param pixelsPerWorldUnit Screen pixels the surface covers per world unit
+		*/
+		void requestTextureLevels(float const& uvPerWorldUnit, float const& pixelsPerWorldUnit) const;
+		void unbind(ShaderVariantKey const& rendererKey = ShaderVariantKey());
 
 		void setBool(const std::string& name, bool const& value);
 		void setColorRGB(const std::string& name, Color const& value);
@@ -93,6 +122,9 @@ namespace DerydocaEngine::Rendering
 		std::map<std::string, glm::mat4> m_mat4Values;
 		std::map<std::string, std::vector<glm::mat4>> m_mat4ArrayValues;
 		std::map<unsigned int, unsigned int> m_subroutineValues;
+		std::vector<std::string> m_keywords;
+		mutable ShaderVariantKey m_variantKey;
+		mutable bool m_variantKeyDirty;
 	};
 
 }
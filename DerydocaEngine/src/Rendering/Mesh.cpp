@@ -5,6 +5,7 @@
 
 #include "MeshAdjacencyCalculator.h"
 #include "Debug\DebugVisualizer.h"
+#include "Rendering\TextureStreaming.h"
 
 namespace DerydocaEngine::Rendering
 {
@@ -17,7 +18,9 @@ namespace DerydocaEngine::Rendering
 		const std::vector<glm::vec3>& tangents,
 		const std::vector<glm::vec3>& bitangents,
 		const std::vector<Color>& colors,
-		const std::vector<Animation::VertexBoneWeights> boneWeights) :
+		const std::vector<Animation::VertexBoneWeights> boneWeights,
+		const VertexLayout& vertexLayout,
+		const MeshStorage& storage) :
 		m_vertexArrayObject(0),
 		m_vertexArrayBuffers(),
 		m_positions(positions),
@@ -28,18 +31,74 @@ namespace DerydocaEngine::Rendering
 		m_bitangents(bitangents),
 		m_colors(colors),
 		m_boneWeights(boneWeights),
-		m_skeleton()
+		m_skeleton(),
+		m_boundsMin(),
+		m_boundsMax(),
+		m_uvDensity(0.0f),
+		m_vertexLayout(vertexLayout),
+		m_vertexStride(0),
+		m_uncompressedVertexStride(0),
+		m_vertexCount(positions.size()),
+		m_indexCount(indices.size()),
+		m_attributes(),
+		m_enabledAttributes(),
+		m_storage(storage),
+		m_arenaAllocation(),
+		m_cpuDataPinned(false)
 	{
 		// Zero out all buffer handles
 		m_vertexArrayBuffers.fill(0);
 
-		// Generate VAO and VBOs
-		generateVao();
-		bind();
-		generateBuffers();
+		// Find the extents of the mesh for culling, and how its UVs are spread for texture streaming
+		calculateBounds();
+		calculateUvDensity();
+
+		// Generate VAO and VBOs, arena meshes use the ones shared by their pool
+		if (m_storage == MeshStorage::Dedicated)
+		{
+			generateVao();
+			bind();
+			generateBuffers();
+		}
 
 		// Upload mesh component data to the GPU
 		uploadToGpu(MeshComponents::All);
+
+		// Nothing can pin the mesh before it is constructed, so the streams are no longer needed
+		releaseCpuData();
+	}
+
+	Mesh::Mesh(PackedMeshData const& data, MeshStorage const& storage) :
+		m_vertexArrayObject(0),
+		m_vertexArrayBuffers(),
+		m_positions(),
+		m_indices(),
+		m_normals(),
+		m_texCoords(),
+		m_tangents(),
+		m_bitangents(),
+		m_colors(),
+		m_boneWeights(),
+		m_skeleton(),
+		m_flags(data.flags),
+		m_boundsMin(data.boundsMin),
+		m_boundsMax(data.boundsMax),
+		m_uvDensity(data.uvDensity),
+		m_vertexLayout(data.layout),
+		m_vertexStride(data.stride),
+		m_uncompressedVertexStride(data.uncompressedStride),
+		m_vertexCount(data.vertexCount),
+		m_indexCount(data.indexCount),
+		m_attributes(data.attributes),
+		m_enabledAttributes(),
+		m_storage(storage),
+		m_arenaAllocation(),
+		m_cpuDataPinned(false)
+	{
+		m_vertexArrayBuffers.fill(0);
+
+		// The streams are already in their final form, so they go to the GPU as they are
+		uploadPackedData(data.vertexData, data.indices);
 	}
 
 	void Mesh::loadMeshComponentData(
@@ -53,14 +112,29 @@ namespace DerydocaEngine::Rendering
 		const std::vector<Color>& colors,
 		const std::vector<Animation::VertexBoneWeights> boneWeights)
 	{
+		// The interleaved buffer is rebuilt from every stream, and arena meshes are uploaded again as a
+		// whole, so the streams that are not provided must still be here
+		const MeshComponents vertexComponents = (MeshComponents)(MeshComponents::All & ~MeshComponents::Indices);
+		bool needsAllStreams = m_storage == MeshStorage::Arena ?
+			(meshComponentFlags & MeshComponents::All) != MeshComponents::All :
+			(meshComponentFlags & vertexComponents) != 0 && (meshComponentFlags & vertexComponents) != vertexComponents;
+		if (needsAllStreams && !hasCpuData() && m_vertexCount > 0)
+		{
+			std::cout << "Unable to update some components of a mesh whose CPU side copy was released. Pin the mesh's CPU data to update it partially.\n";
+			return;
+		}
+
 		if (meshComponentFlags & MeshComponents::Positions)
 		{
 			m_positions = positions;
+			m_vertexCount = m_positions.size();
+			calculateBounds();
 		}
 
 		if (meshComponentFlags & MeshComponents::Indices)
 		{
 			m_indices = indices;
+			m_indexCount = m_indices.size();
 		}
 
 		if (meshComponentFlags & MeshComponents::Normals)
@@ -93,146 +167,416 @@ namespace DerydocaEngine::Rendering
 			m_boneWeights = boneWeights;
 		}
 
+		if (meshComponentFlags & (MeshComponents::Positions | MeshComponents::Indices | MeshComponents::TexCoords))
+		{
+			calculateUvDensity();
+		}
+
 		uploadToGpu(meshComponentFlags);
+
+		if (!m_cpuDataPinned)
+		{
+			releaseCpuData();
+		}
 	}
 
 	Mesh::~Mesh()
 	{
-		glDeleteVertexArrays(1, &m_vertexArrayObject);
+		GeometryArena::getInstance().free(m_arenaAllocation);
+		releaseDedicatedBuffers();
 	}
 
-	void Mesh::uploadToGpu(const MeshComponents& meshComponentFlags)
+	unsigned int Mesh::getVao() const
 	{
-		assert(m_vertexArrayObject != 0);
+		if (m_storage == MeshStorage::Arena)
+		{
+			return GeometryArena::getInstance().getVertexArray(m_arenaAllocation);
+		}
 
-		bind();
+		return m_vertexArrayObject;
+	}
 
-		// Initialize the vert positions
-		if ((meshComponentFlags & MeshComponents::Positions) && m_positions.size() > 0)
+	void Mesh::setStorage(MeshStorage const& storage)
+	{
+		if (storage == m_storage)
 		{
-			uploadPositions();
+			return;
 		}
 
-		// Initialize the indices buffer
-		if ((meshComponentFlags & MeshComponents::Indices) && m_indices.size() > 0)
+		// Meshes created from packed data have no CPU side copy, so take the geometry from the GPU
+		std::vector<uint8_t> vertexData;
+		std::vector<unsigned int> indices;
+		bool hasStreams = !m_positions.empty();
+		if (!hasStreams)
 		{
-			uploadIndices();
+			readBack(vertexData, indices);
+		}
+
+		if (storage == MeshStorage::Arena)
+		{
+			releaseDedicatedBuffers();
+		}
+		else
+		{
+			GeometryArena::getInstance().free(m_arenaAllocation);
 		}
+		m_storage = storage;
 
-		// Initialize the normals buffer
-		if ((meshComponentFlags & MeshComponents::Normals) && m_normals.size() > 0)
+		// Upload the geometry to its new home
+		if (hasStreams)
+		{
+			if (m_storage == MeshStorage::Dedicated)
+			{
+				generateVao();
+				bind();
+				generateBuffers();
+			}
+			uploadToGpu(MeshComponents::All);
+		}
+		else
 		{
-			uploadNormals();
+			uploadPackedData(vertexData.data(), indices.data());
 		}
+	}
+
+	void Mesh::swap(Mesh& other)
+	{
+		std::swap(m_vertexArrayObject, other.m_vertexArrayObject);
+		std::swap(m_vertexArrayBuffers, other.m_vertexArrayBuffers);
+		std::swap(m_positions, other.m_positions);
+		std::swap(m_indices, other.m_indices);
+		std::swap(m_normals, other.m_normals);
+		std::swap(m_texCoords, other.m_texCoords);
+		std::swap(m_tangents, other.m_tangents);
+		std::swap(m_bitangents, other.m_bitangents);
+		std::swap(m_colors, other.m_colors);
+		std::swap(m_boneWeights, other.m_boneWeights);
+		std::swap(m_skeleton, other.m_skeleton);
+		std::swap(m_flags, other.m_flags);
+		std::swap(m_boundsMin, other.m_boundsMin);
+		std::swap(m_boundsMax, other.m_boundsMax);
+		std::swap(m_uvDensity, other.m_uvDensity);
+		std::swap(m_vertexLayout, other.m_vertexLayout);
+		std::swap(m_vertexStride, other.m_vertexStride);
+		std::swap(m_uncompressedVertexStride, other.m_uncompressedVertexStride);
+		std::swap(m_vertexCount, other.m_vertexCount);
+		std::swap(m_indexCount, other.m_indexCount);
+		std::swap(m_attributes, other.m_attributes);
+		std::swap(m_enabledAttributes, other.m_enabledAttributes);
+		std::swap(m_storage, other.m_storage);
+		std::swap(m_arenaAllocation, other.m_arenaAllocation);
+		std::swap(m_cpuDataPinned, other.m_cpuDataPinned);
+	}
 
-		// Initialize the texture coordinates buffer
-		if ((meshComponentFlags & MeshComponents::TexCoords) && m_texCoords.size() > 0)
+	size_t Mesh::getBaseVertex() const
+	{
+		return m_storage == MeshStorage::Arena ? GeometryArena::getInstance().getBaseVertex(m_arenaAllocation) : 0;
+	}
+
+	size_t Mesh::getFirstIndex() const
+	{
+		return m_storage == MeshStorage::Arena ? GeometryArena::getInstance().getFirstIndex(m_arenaAllocation) : 0;
+	}
+
+	void Mesh::calculateBounds()
+	{
+		if (m_positions.size() == 0)
 		{
-			uploadTexCoords();
+			m_boundsMin = glm::vec3(0.0f);
+			m_boundsMax = glm::vec3(0.0f);
+			return;
 		}
 
-		// Initialize the tangents buffer
-		if ((meshComponentFlags & MeshComponents::Tangents) && m_tangents.size() > 0)
+		m_boundsMin = m_positions[0];
+		m_boundsMax = m_positions[0];
+		for (auto const& position : m_positions)
 		{
-			uploadTangents();
+			m_boundsMin = glm::min(m_boundsMin, position);
+			m_boundsMax = glm::max(m_boundsMax, position);
 		}
+	}
 
-		// Initialize the bitangents buffer
-		if ((meshComponentFlags & MeshComponents::Bitangents) && m_bitangents.size() > 0)
+	void Mesh::calculateUvDensity()
+	{
+		// Streams that were released keep the density they were last measured with
+		if (m_positions.empty() || m_indices.empty())
 		{
-			uploadBitangents();
+			return;
 		}
 
-		// Initialize the color buffer
-		if ((meshComponentFlags & MeshComponents::Colors) && m_colors.size() > 0)
+		int indicesPerTriangle = (m_flags & MeshFlags::load_adjacent) ? 6 : 3;
+		m_uvDensity = TextureStreaming::calculateUvDensity(m_positions, m_texCoords, m_indices, indicesPerTriangle);
+	}
+
+	void Mesh::uploadToGpu(const MeshComponents& meshComponentFlags)
+	{
+		if (m_storage == MeshStorage::Arena)
 		{
-			uploadColors();
+			uploadToArena();
+			return;
 		}
 
-		// Initialize the bone index and weight buffers
-		if ((meshComponentFlags & MeshComponents::BoneWeights) && m_boneWeights.size() > 0)
+		assert(m_vertexArrayObject != 0);
+
+		bind();
+
+		// Every vertex attribute lives in the same interleaved buffer, so changing any of them rebuilds it
+		const MeshComponents vertexComponents = (MeshComponents)(MeshComponents::All & ~MeshComponents::Indices);
+		if ((meshComponentFlags & vertexComponents) && m_vertexCount > 0)
 		{
-			uploadBoneWeights();
+			uploadVertices();
+		}
+
+		// Initialize the indices buffer
+		if ((meshComponentFlags & MeshComponents::Indices) && m_indexCount > 0)
+		{
+			uploadIndices();
 		}
 
 		unbind();
 	}
 
-	void Mesh::draw()
+	void Mesh::draw(unsigned int const& instanceCount)
 	{
+		GLenum mode = m_flags & MeshFlags::load_adjacent ? GL_TRIANGLES_ADJACENCY : GL_TRIANGLES;
+
+		if (m_storage == MeshStorage::Arena)
+		{
+			GeometryArena::getInstance().draw(m_arenaAllocation, mode, static_cast<unsigned int>(getNumIndices()), instanceCount);
+			return;
+		}
+
 		bind();
 
-		GLenum mode = m_flags & MeshFlags::load_adjacent ? GL_TRIANGLES_ADJACENCY : GL_TRIANGLES;
-		glDrawElementsBaseVertex(mode, static_cast<int>(getNumIndices()), GL_UNSIGNED_INT, 0, 0);
+		if (instanceCount == 1)
+		{
+			glDrawElementsBaseVertex(mode, static_cast<int>(getNumIndices()), GL_UNSIGNED_INT, 0, 0);
+		}
+		else
+		{
+			glDrawElementsInstancedBaseVertex(mode, static_cast<int>(getNumIndices()), GL_UNSIGNED_INT, 0, static_cast<int>(instanceCount), 0);
+		}
 
 		unbind();
 	}
 
-	void Mesh::uploadPositions()
+	bool Mesh::queueDraw(glm::mat4 const& mvp)
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, m_vertexArrayBuffers[POSITION_VB]);
-		glBufferData(GL_ARRAY_BUFFER, m_positions.size() * sizeof(glm::vec3), &m_positions[0], GL_STATIC_DRAW);
-		glEnableVertexAttribArray(0);
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
+		if (m_storage != MeshStorage::Arena)
+		{
+			return false;
+		}
+
+		GLenum mode = m_flags & MeshFlags::load_adjacent ? GL_TRIANGLES_ADJACENCY : GL_TRIANGLES;
+		GeometryArena::DrawData drawData;
+		drawData.mvp = mvp;
+		return GeometryArena::getInstance().queueDraw(m_arenaAllocation, mode, static_cast<unsigned int>(getNumIndices()), drawData);
 	}
 
-	void Mesh::uploadTexCoords()
+	static GLenum getGLType(VertexAttributeType const& type)
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, m_vertexArrayBuffers[TEXCOORD_VB]);
-		glBufferData(GL_ARRAY_BUFFER, m_texCoords.size() * sizeof(glm::vec2), &m_texCoords[0], GL_STATIC_DRAW);
-		glEnableVertexAttribArray(1);
-		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, 0);
+		switch (type)
+		{
+		case VertexAttributeType::HalfFloat:
+			return GL_HALF_FLOAT;
+		case VertexAttributeType::Byte:
+			return GL_BYTE;
+		case VertexAttributeType::UnsignedByte:
+			return GL_UNSIGNED_BYTE;
+		case VertexAttributeType::Short:
+			return GL_SHORT;
+		case VertexAttributeType::UnsignedShort:
+			return GL_UNSIGNED_SHORT;
+		case VertexAttributeType::UnsignedInt:
+			return GL_UNSIGNED_INT;
+		case VertexAttributeType::Int2101010Rev:
+			return GL_INT_2_10_10_10_REV;
+		default:
+			return GL_FLOAT;
+		}
 	}
 
-	void Mesh::uploadNormals()
+	void Mesh::buildVertexData(std::vector<uint8_t>& vertexData)
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, m_vertexArrayBuffers[NORMAL_VB]);
-		glBufferData(GL_ARRAY_BUFFER, m_normals.size() * sizeof(glm::vec3), &m_normals[0], GL_STATIC_DRAW);
-		glEnableVertexAttribArray(2);
-		glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 0, 0);
+		VertexStreams streams = { &m_positions, &m_normals, &m_texCoords, &m_tangents, &m_bitangents, &m_colors, &m_boneWeights };
+		VertexBufferBuilder builder(m_vertexLayout, streams);
+
+		builder.build(vertexData);
+		m_vertexStride = builder.getStride();
+		m_uncompressedVertexStride = builder.getUncompressedStride();
+		m_attributes = builder.getAttributes();
 	}
 
-	void Mesh::uploadTangents()
+	void Mesh::uploadVertices()
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, m_vertexArrayBuffers[TANGENT_VB]);
-		glBufferData(GL_ARRAY_BUFFER, m_tangents.size() * sizeof(glm::vec3), &m_tangents[0], GL_STATIC_DRAW);
-		glEnableVertexAttribArray(3);
-		glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, 0, 0);
+		std::vector<uint8_t> vertexData;
+		buildVertexData(vertexData);
+		uploadVertexData(vertexData.data());
 	}
 
-	void Mesh::uploadBitangents()
+	void Mesh::uploadIndices()
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, m_vertexArrayBuffers[BITANGENT_VB]);
-		glBufferData(GL_ARRAY_BUFFER, m_bitangents.size() * sizeof(glm::vec3), &m_bitangents[0], GL_STATIC_DRAW);
-		glEnableVertexAttribArray(4);
-		glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, 0, 0);
+		uploadIndexData(m_indices.data());
 	}
 
-	void Mesh::uploadIndices()
+	void Mesh::uploadVertexData(const uint8_t* vertexData)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, m_vertexArrayBuffers[VERTEX_VB]);
+		glBufferData(GL_ARRAY_BUFFER, getVertexBufferSize(), vertexData, GL_STATIC_DRAW);
+
+		// Attributes that are no longer present must stop reading from the buffer
+		for (auto const& location : m_enabledAttributes)
+		{
+			glDisableVertexAttribArray(location);
+		}
+		m_enabledAttributes.clear();
+
+		GLsizei stride = static_cast<GLsizei>(m_vertexStride);
+		for (auto const& attribute : m_attributes)
+		{
+			glEnableVertexAttribArray(attribute.location);
+			if (attribute.integer)
+			{
+				glVertexAttribIPointer(attribute.location, attribute.components, getGLType(attribute.type), stride, (void*)attribute.offset);
+			}
+			else
+			{
+				glVertexAttribPointer(attribute.location, attribute.components, getGLType(attribute.type), attribute.normalized ? GL_TRUE : GL_FALSE, stride, (void*)attribute.offset);
+			}
+			m_enabledAttributes.push_back(attribute.location);
+		}
+	}
+
+	void Mesh::uploadIndexData(const unsigned int* indices)
 	{
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_vertexArrayBuffers[INDEX_VB]);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(GLuint), &m_indices[0], GL_STATIC_DRAW);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, getIndexBufferSize(), indices, GL_STATIC_DRAW);
 	}
 
-	void Mesh::uploadColors()
+	void Mesh::uploadToArena()
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, m_vertexArrayBuffers[COLOR_VB]);
-		glBufferData(GL_ARRAY_BUFFER, m_colors.size() * sizeof(Color), &m_colors[0], GL_STATIC_DRAW);
-		glEnableVertexAttribArray(5);
-		glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, 0, 0);
+		std::vector<uint8_t> vertexData;
+		if (m_vertexCount > 0)
+		{
+			buildVertexData(vertexData);
+		}
+		uploadToArena(vertexData.data(), m_indices.data());
 	}
 
-	void Mesh::uploadBoneWeights()
+	void Mesh::uploadToArena(const uint8_t* vertexData, const unsigned int* indices)
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, m_vertexArrayBuffers[BONE_INDICES_VB]);
-		glBufferData(GL_ARRAY_BUFFER, m_boneWeights.size() * sizeof(Animation::VertexBoneWeights), &m_boneWeights[0], GL_STATIC_DRAW);
-		glEnableVertexAttribArray(6);
-		glVertexAttribIPointer(6, Animation::MAX_BONES, GL_UNSIGNED_INT, sizeof(Animation::VertexBoneWeights), 0);
+		// The arena packs meshes back to back, so any change moves the mesh to a new range
+		GeometryArena& arena = GeometryArena::getInstance();
+		arena.free(m_arenaAllocation);
+
+		if (m_vertexCount == 0)
+		{
+			return;
+		}
+
+		m_arenaAllocation = arena.allocate(m_attributes, m_vertexStride, vertexData, m_vertexCount, indices, m_indexCount);
+	}
+
+	void Mesh::uploadPackedData(const uint8_t* vertexData, const unsigned int* indices)
+	{
+		if (m_storage == MeshStorage::Arena)
+		{
+			uploadToArena(vertexData, indices);
+			return;
+		}
 
-		glBindBuffer(GL_ARRAY_BUFFER, m_vertexArrayBuffers[BONE_WEIGHTS_VB]);
-		glBufferData(GL_ARRAY_BUFFER, m_boneWeights.size() * sizeof(Animation::VertexBoneWeights), &m_boneWeights[0], GL_STATIC_DRAW);
-		glEnableVertexAttribArray(7);
-		glVertexAttribPointer(7, Animation::MAX_BONES, GL_FLOAT, GL_FALSE, sizeof(Animation::VertexBoneWeights), (void*)(sizeof(unsigned int) * Animation::MAX_BONES));
+		generateVao();
+		bind();
+		generateBuffers();
+		if (m_vertexCount > 0)
+		{
+			uploadVertexData(vertexData);
+		}
+		if (m_indexCount > 0)
+		{
+			uploadIndexData(indices);
+		}
+		unbind();
+	}
+
+	void Mesh::readBack(std::vector<uint8_t>& vertexData, std::vector<unsigned int>& indices) const
+	{
+		if (m_storage == MeshStorage::Arena)
+		{
+			GeometryArena::getInstance().readBack(m_arenaAllocation, vertexData, indices);
+			return;
+		}
+
+		vertexData.resize(getVertexBufferSize());
+		indices.resize(m_indexCount);
+		if (m_vertexArrayObject == 0)
+		{
+			return;
+		}
+
+		glBindBuffer(GL_COPY_READ_BUFFER, m_vertexArrayBuffers[VERTEX_VB]);
+		glGetBufferSubData(GL_COPY_READ_BUFFER, 0, vertexData.size(), vertexData.data());
+		glBindBuffer(GL_COPY_READ_BUFFER, m_vertexArrayBuffers[INDEX_VB]);
+		glGetBufferSubData(GL_COPY_READ_BUFFER, 0, indices.size() * sizeof(unsigned int), indices.data());
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+	}
+
+	void Mesh::releaseDedicatedBuffers()
+	{
+		if (m_vertexArrayObject == 0)
+		{
+			return;
+		}
+
+		glDeleteBuffers(NUM_BUFFERS, &m_vertexArrayBuffers[0]);
+		glDeleteVertexArrays(1, &m_vertexArrayObject);
+		m_vertexArrayBuffers.fill(0);
+		m_vertexArrayObject = 0;
+		m_enabledAttributes.clear();
+	}
+
+	void Mesh::releaseCpuData()
+	{
+		// Swap with empty vectors so the memory is returned rather than just cleared
+		std::vector<glm::vec3>().swap(m_positions);
+		std::vector<unsigned int>().swap(m_indices);
+		std::vector<glm::vec3>().swap(m_normals);
+		std::vector<glm::vec2>().swap(m_texCoords);
+		std::vector<glm::vec3>().swap(m_tangents);
+		std::vector<glm::vec3>().swap(m_bitangents);
+		std::vector<Color>().swap(m_colors);
+		std::vector<Animation::VertexBoneWeights>().swap(m_boneWeights);
+	}
+
+	size_t Mesh::getCpuMemoryUsage() const
+	{
+		return m_positions.capacity() * sizeof(glm::vec3) +
+			m_indices.capacity() * sizeof(unsigned int) +
+			m_normals.capacity() * sizeof(glm::vec3) +
+			m_texCoords.capacity() * sizeof(glm::vec2) +
+			m_tangents.capacity() * sizeof(glm::vec3) +
+			m_bitangents.capacity() * sizeof(glm::vec3) +
+			m_colors.capacity() * sizeof(Color) +
+			m_boneWeights.capacity() * sizeof(Animation::VertexBoneWeights);
+	}
+
+	void Mesh::printMemoryReport(std::string const& meshName) const
+	{
+		size_t vertexCount = getNumVertices();
+		size_t compressedBytes = getVertexBufferSize();
+		size_t uncompressedBytes = m_uncompressedVertexStride * vertexCount;
+		float ratio = uncompressedBytes > 0 ? (float)compressedBytes / (float)uncompressedBytes : 1.0f;
+
+		printf("Mesh '%s': %zu vertices, layout [%s], %zu bytes per vertex (%zu uncompressed), vertex buffer %.1f KB (%.1f KB uncompressed, %.0f%%), index buffer %.1f KB\n",
+			meshName.c_str(),
+			vertexCount,
+			m_vertexLayout.getName().c_str(),
+			m_vertexStride,
+			m_uncompressedVertexStride,
+			compressedBytes / 1024.0f,
+			uncompressedBytes / 1024.0f,
+			ratio * 100.0f,
+			getIndexBufferSize() / 1024.0f);
 	}
 
 	void Mesh::bind()
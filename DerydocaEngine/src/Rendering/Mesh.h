@@ -7,6 +7,9 @@
 #include "Color.h"
 #include "MeshFlags.h"
 #include "Animation\Skeleton.h"
+#include "Rendering\CookedMesh.h"
+#include "Rendering\GeometryArena.h"
+#include "Rendering\VertexLayout.h"
 
 namespace DerydocaEngine::Rendering
 {
@@ -17,13 +20,21 @@ namespace DerydocaEngine::Rendering
 		Tangents = 0x2,
 		Bitangents = 0x4,
 		TexCoords = 0x8,
-		Normals = 0x16,
-		Indices = 0x32,
-		Colors = 0x64,
-		BoneWeights = 0x128,
+		Normals = 0x10,
+		Indices = 0x20,
+		Colors = 0x40,
+		BoneWeights = 0x80,
 		All = Positions | Tangents | Bitangents | TexCoords | Normals | Indices | Colors | BoneWeights
 	};
 
+	/* Where the GPU copy of a mesh's geometry lives */
+	enum class MeshStorage {
+		// The mesh owns its vertex array and buffers
+		Dedicated,
+		// The mesh owns a range of the shared geometry arena
+		Arena
+	};
+
 	class Mesh
 	{
 	public:
@@ -35,7 +46,18 @@ namespace DerydocaEngine::Rendering
 			const std::vector<glm::vec3>& tangents = std::vector<glm::vec3>(),
 			const std::vector<glm::vec3>& bitangents = std::vector<glm::vec3>(),
 			const std::vector<Color>& colors = std::vector<Color>(),
-			const std::vector<Animation::VertexBoneWeights> boneWeights = std::vector<Animation::VertexBoneWeights>());
+			const std::vector<Animation::VertexBoneWeights> boneWeights = std::vector<Animation::VertexBoneWeights>(),
+			const VertexLayout& vertexLayout = VertexLayout::uncompressed(),
+			const MeshStorage& storage = MeshStorage::Dedicated);
+
+		/*
+		Creates a mesh from geometry that is already interleaved and compressed, such as a cooked mesh.
+		The data is uploaded as it is and no CPU side copy is kept.
+
+		@param data Geometry of the mesh
+		@param storage Where the GPU copy of the geometry lives
+		*/
+		Mesh(PackedMeshData const& data, MeshStorage const& storage = MeshStorage::Dedicated);
 
 		~Mesh();
 
@@ -49,40 +71,109 @@ namespace DerydocaEngine::Rendering
 			const std::vector<glm::vec3>& bitangents = std::vector<glm::vec3>(),
 			const std::vector<Color>& colors = std::vector<Color>(),
 			const std::vector<Animation::VertexBoneWeights> boneWeights = std::vector<Animation::VertexBoneWeights>());
-		void draw();
+		/*
+		Draws the mesh, once or several times in one call.
+
+		@param instanceCount Number of instances to draw, which shaders tell apart with gl_InstanceID
+		*/
+		void draw(unsigned int const& instanceCount = 1);
+		/*
+		Queues the mesh to be merged with the other draws of its geometry arena pool while the arena
+		is queueing draws.
+
+		@param mvp Model view projection matrix the shader reads for this draw
+		@return False if the mesh has to be drawn directly instead
+		*/
+		bool queueDraw(glm::mat4 const& mvp);
 		void setFlags(const MeshFlags& flags) { m_flags = flags; }
-		unsigned int getVao() const { return m_vertexArrayObject; }
-		size_t getNumVertices() const { return m_positions.size(); }
-		size_t getNumIndices() const { return m_indices.size(); }
+		unsigned int getVao() const;
+		size_t getNumVertices() const { return m_vertexCount; }
+		size_t getNumIndices() const { return m_indexCount; }
+		glm::vec3 getBoundsMin() const { return m_boundsMin; }
+		glm::vec3 getBoundsMax() const { return m_boundsMax; }
+
+		/* Gets how many UV units the mesh spans per unit of its own space, or 0 if it has no UVs */
+		float getUvDensity() const { return m_uvDensity; }
 		std::shared_ptr<Animation::Skeleton> getSkeleton() { return m_skeleton; }
 		void setSkeleton(const std::shared_ptr<Animation::Skeleton> skeleton) { m_skeleton = skeleton; }
+		VertexLayout getVertexLayout() const { return m_vertexLayout; }
+		size_t getVertexStride() const { return m_vertexStride; }
+		size_t getUncompressedVertexStride() const { return m_uncompressedVertexStride; }
+		size_t getVertexBufferSize() const { return m_vertexStride * getNumVertices(); }
+		size_t getIndexBufferSize() const { return m_indexCount * sizeof(unsigned int); }
+		MeshStorage getStorage() const { return m_storage; }
+
+		/*
+		Moves the mesh's geometry to different storage. Code that attaches its own attributes to the
+		mesh's vertex array must use dedicated storage, since an arena vertex array is shared.
+
+		@param storage Storage to move the geometry to
+		*/
+		void setStorage(MeshStorage const& storage);
+
+		/*
+		Exchanges the geometry of the mesh with another mesh's, such as one that was just reloaded
+		from a changed file.
+
+		@param other Mesh to exchange with
+		*/
+		void swap(Mesh& other);
+
+		/* Gets the offset added to every index when drawing, which is zero for dedicated storage */
+		size_t getBaseVertex() const;
+
+		/* Gets the position of the mesh's first index in its index buffer, which is zero for dedicated storage */
+		size_t getFirstIndex() const;
+
+		/*
+		Prints how much memory the mesh's vertex buffer uses compared to storing every attribute as
+		full precision floats in separate buffers, which is also the number of bytes fetched per draw.
+
+		@param meshName Name to print the report under
+		*/
+		void printMemoryReport(std::string const& meshName) const;
+
+		/*
+		Keeps the CPU side copy of the mesh's vertex streams after they are uploaded. Only pinned meshes
+		can later update some of their components without providing the rest, since every vertex
+		attribute is rebuilt into the same interleaved buffer.
+
+		@param pinned Whether the CPU side copy is kept
+		*/
+		void setCpuDataPinned(bool const& pinned) { m_cpuDataPinned = pinned; }
+		bool isCpuDataPinned() const { return m_cpuDataPinned; }
+		bool hasCpuData() const { return !m_positions.empty() || !m_indices.empty(); }
+
+		/* Gets the number of bytes held by the CPU side copy of the mesh's vertex streams */
+		size_t getCpuMemoryUsage() const;
+
+		/* Gets the number of bytes of the mesh's vertex and index buffers */
+		size_t getGpuMemoryUsage() const { return getVertexBufferSize() + getIndexBufferSize(); }
 
 	private:
 		enum {
-			POSITION_VB,
-			TANGENT_VB,
-			BITANGENT_VB,
-			TEXCOORD_VB,
-			NORMAL_VB,
+			VERTEX_VB,
 			INDEX_VB,
-			COLOR_VB,
-			BONE_INDICES_VB,
-			BONE_WEIGHTS_VB,
 			NUM_BUFFERS
 		};
 
 		Mesh(Mesh const& other) {}
 		void operator=(Mesh const& other) {}
 
+		void calculateBounds();
+		void calculateUvDensity();
 		void uploadToGpu(MeshComponents const& meshComponentFlags);
-		void uploadPositions();
-		void uploadTexCoords();
-		void uploadNormals();
-		void uploadTangents();
-		void uploadBitangents();
+		void buildVertexData(std::vector<uint8_t>& vertexData);
+		void uploadVertices();
 		void uploadIndices();
-		void uploadColors();
-		void uploadBoneWeights();
+		void uploadVertexData(const uint8_t* vertexData);
+		void uploadIndexData(const unsigned int* indices);
+		void uploadToArena();
+		void uploadToArena(const uint8_t* vertexData, const unsigned int* indices);
+		void uploadPackedData(const uint8_t* vertexData, const unsigned int* indices);
+		void readBack(std::vector<uint8_t>& vertexData, std::vector<unsigned int>& indices) const;
+		void releaseDedicatedBuffers();
+		void releaseCpuData();
 		void bind();
 		void unbind();
 		void generateVao();
@@ -100,6 +191,19 @@ namespace DerydocaEngine::Rendering
 		std::vector<Animation::VertexBoneWeights> m_boneWeights;
 		std::shared_ptr<Animation::Skeleton> m_skeleton;
 		MeshFlags m_flags{};
+		glm::vec3 m_boundsMin;
+		glm::vec3 m_boundsMax;
+		float m_uvDensity;
+		VertexLayout m_vertexLayout;
+		size_t m_vertexStride;
+		size_t m_uncompressedVertexStride;
+		size_t m_vertexCount;
+		size_t m_indexCount;
+		std::vector<VertexAttribute> m_attributes;
+		std::vector<unsigned int> m_enabledAttributes;
+		MeshStorage m_storage;
+		GeometryArena::Allocation m_arenaAllocation;
+		bool m_cpuDataPinned;
 	};
 
 }
@@ -0,0 +1,429 @@
+#include "EnginePch.h"
+#include "Rendering\MipGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include "Helpers\ParallelFor.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#include <xmmintrin.h>
+#define MIP_GENERATOR_SSE
+#endif
+
+namespace DerydocaEngine::Rendering::MipGenerator
+{
+
+	// Taps of the Kaiser filter on each side of a destination pixel, in source pixels
+	static const int KAISER_RADIUS = 4;
+	static const int KAISER_TAPS = KAISER_RADIUS * 2;
+	static const float KAISER_ALPHA = 4.0f;
+
+	// Levels with fewer rows than this are filtered on the calling thread, as starting threads costs more
+	static const int MIN_PARALLEL_ROWS = 64;
+
+	// Steps of the search for the alpha scale that restores coverage, enough for 1/4096 precision
+	static const int ALPHA_SCALE_SEARCH_STEPS = 12;
+	static const float MAX_ALPHA_SCALE = 4.0f;
+
+	// Every pixel is held as four floats, so a whole pixel fits in one SSE register
+#ifdef MIP_GENERATOR_SSE
+	typedef __m128 Pixel;
+
+	static inline Pixel loadPixel(const float* pixel) { return _mm_loadu_ps(pixel); }
+	static inline void storePixel(float* pixel, Pixel const& value) { _mm_storeu_ps(pixel, value); }
+	static inline Pixel zeroPixel() { return _mm_setzero_ps(); }
+	static inline Pixel addPixels(Pixel const& a, Pixel const& b) { return _mm_add_ps(a, b); }
+	static inline Pixel scalePixel(Pixel const& pixel, float const& scale) { return _mm_mul_ps(pixel, _mm_set1_ps(scale)); }
+#else
+	struct Pixel
+	{
+		float values[4];
+	};
+
+	static inline Pixel loadPixel(const float* pixel) { return { { pixel[0], pixel[1], pixel[2], pixel[3] } }; }
+	static inline void storePixel(float* pixel, Pixel const& value) { memcpy(pixel, value.values, sizeof(value.values)); }
+	static inline Pixel zeroPixel() { return { { 0.0f, 0.0f, 0.0f, 0.0f } }; }
+	static inline Pixel addPixels(Pixel const& a, Pixel const& b)
+	{
+		return { { a.values[0] + b.values[0], a.values[1] + b.values[1], a.values[2] + b.values[2], a.values[3] + b.values[3] } };
+	}
+	static inline Pixel scalePixel(Pixel const& pixel, float const& scale)
+	{
+		return { { pixel.values[0] * scale, pixel.values[1] * scale, pixel.values[2] * scale, pixel.values[3] * scale } };
+	}
+#endif
+
+	// A level while it is being filtered, with every channel in linear space
+	struct FloatLevel
+	{
+		int width = 0;
+		int height = 0;
+		std::vector<float> pixels;
+	};
+
+	static unsigned int getThreadCount(int const& rows)
+	{
+		return rows < MIN_PARALLEL_ROWS ? 1u : 0u;
+	}
+
+	static float srgbToLinear(float const& value)
+	{
+		return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+	}
+
+	static float linearToSrgb(float const& value)
+	{
+		return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+	}
+
+	static const std::vector<float>& getSrgbToLinearTable()
+	{
+		static const std::vector<float> table = []() {
+			std::vector<float> values(256);
+			for (int i = 0; i < 256; i++)
+			{
+				values[i] = srgbToLinear(i / 255.0f);
+			}
+			return values;
+		}();
+		return table;
+	}
+
+	// Zeroth order modified Bessel function of the first kind, which shapes the Kaiser window
+	static double besselI0(double const& x)
+	{
+		double sum = 1.0;
+		double term = 1.0;
+		for (int k = 1; k < 32; k++)
+		{
+			double factor = x / (2.0 * k);
+			term *= factor * factor;
+			sum += term;
+		}
+		return sum;
+	}
+
+	static const std::vector<float>& getKaiserWeights()
+	{
+		// Halving puts each destination pixel between two source pixels, so the same weights are used
+		// for every destination pixel
+		static const std::vector<float> weights = []() {
+			std::vector<float> values(KAISER_TAPS);
+			double sum = 0.0;
+			for (int i = 0; i < KAISER_TAPS; i++)
+			{
+				double distance = i - KAISER_RADIUS + 0.5;
+				double sincInput = 3.14159265358979 * distance / 2.0;
+				double sinc = std::sin(sincInput) / sincInput;
+				double windowPosition = distance / KAISER_RADIUS;
+				double window = besselI0(KAISER_ALPHA * std::sqrt(std::max(1.0 - windowPosition * windowPosition, 0.0))) / besselI0(KAISER_ALPHA);
+				values[i] = static_cast<float>(sinc * window);
+				sum += values[i];
+			}
+			for (auto& value : values)
+			{
+				value = static_cast<float>(value / sum);
+			}
+			return values;
+		}();
+		return weights;
+	}
+
+	static bool isSrgb(int const& channels, MipSettings const& settings)
+	{
+		return settings.srgb && !settings.normalMap && channels >= 3;
+	}
+
+	static void decodeLevel(const uint8_t* data, int const& width, int const& height, int const& channels, MipSettings const& settings, FloatLevel& level)
+	{
+		level.width = width;
+		level.height = height;
+		level.pixels.resize(static_cast<size_t>(width) * height * 4);
+
+		bool srgb = isSrgb(channels, settings);
+		std::vector<float> const& srgbTable = getSrgbToLinearTable();
+		Helpers::parallelFor(static_cast<size_t>(height), [&](size_t const& y) {
+			for (int x = 0; x < width; x++)
+			{
+				size_t pixel = y * width + x;
+				const uint8_t* in = data + pixel * channels;
+				float* out = level.pixels.data() + pixel * 4;
+				for (int c = 0; c < 4; c++)
+				{
+					if (c >= channels)
+					{
+						out[c] = c == 3 ? 1.0f : 0.0f;
+					}
+					else if (srgb && c < 3)
+					{
+						out[c] = srgbTable[in[c]];
+					}
+					else if (settings.normalMap && c < 3)
+					{
+						out[c] = in[c] / 127.5f - 1.0f;
+					}
+					else
+					{
+						out[c] = in[c] / 255.0f;
+					}
+				}
+
+				// Two channel normal maps only store X and Y, so Z has to be rebuilt before filtering
+				if (settings.normalMap && channels == 2)
+				{
+					out[2] = std::sqrt(std::max(1.0f - out[0] * out[0] - out[1] * out[1], 0.0f));
+				}
+			}
+		}, getThreadCount(height));
+	}
+
+	static void downsampleBox(FloatLevel const& level, FloatLevel& nextLevel)
+	{
+		int width = level.width;
+		int height = level.height;
+		Helpers::parallelFor(static_cast<size_t>(nextLevel.height), [&](size_t const& y) {
+			const float* row0 = level.pixels.data() + static_cast<size_t>(std::min(static_cast<int>(y) * 2, height - 1)) * width * 4;
+			const float* row1 = level.pixels.data() + static_cast<size_t>(std::min(static_cast<int>(y) * 2 + 1, height - 1)) * width * 4;
+			float* out = nextLevel.pixels.data() + y * nextLevel.width * 4;
+			for (int x = 0; x < nextLevel.width; x++)
+			{
+				int x0 = std::min(x * 2, width - 1) * 4;
+				int x1 = std::min(x * 2 + 1, width - 1) * 4;
+				Pixel sum = addPixels(addPixels(loadPixel(row0 + x0), loadPixel(row0 + x1)), addPixels(loadPixel(row1 + x0), loadPixel(row1 + x1)));
+				storePixel(out + x * 4, scalePixel(sum, 0.25f));
+			}
+		}, getThreadCount(nextLevel.height));
+	}
+
+	static void downsampleKaiser(FloatLevel const& level, FloatLevel& nextLevel)
+	{
+		std::vector<float> const& weights = getKaiserWeights();
+		int width = level.width;
+		int height = level.height;
+
+		// The filter is separable, so rows are filtered first into an image that is only half as wide
+		std::vector<float> rows(static_cast<size_t>(nextLevel.width) * height * 4);
+		Helpers::parallelFor(static_cast<size_t>(height), [&](size_t const& y) {
+			const float* in = level.pixels.data() + y * width * 4;
+			float* out = rows.data() + y * nextLevel.width * 4;
+			for (int x = 0; x < nextLevel.width; x++)
+			{
+				Pixel sum = zeroPixel();
+				for (int i = 0; i < KAISER_TAPS; i++)
+				{
+					int sourceX = std::min(std::max(x * 2 - KAISER_RADIUS + 1 + i, 0), width - 1);
+					sum = addPixels(sum, scalePixel(loadPixel(in + sourceX * 4), weights[i]));
+				}
+				storePixel(out + x * 4, sum);
+			}
+		}, getThreadCount(height));
+
+		Helpers::parallelFor(static_cast<size_t>(nextLevel.height), [&](size_t const& y) {
+			float* out = nextLevel.pixels.data() + y * nextLevel.width * 4;
+			for (int x = 0; x < nextLevel.width; x++)
+			{
+				Pixel sum = zeroPixel();
+				for (int i = 0; i < KAISER_TAPS; i++)
+				{
+					int sourceY = std::min(std::max(static_cast<int>(y) * 2 - KAISER_RADIUS + 1 + i, 0), height - 1);
+					sum = addPixels(sum, scalePixel(loadPixel(rows.data() + (static_cast<size_t>(sourceY) * nextLevel.width + x) * 4), weights[i]));
+				}
+				storePixel(out + x * 4, sum);
+			}
+		}, getThreadCount(nextLevel.height));
+	}
+
+	static void renormalize(FloatLevel& level)
+	{
+		size_t pixelCount = static_cast<size_t>(level.width) * level.height;
+		for (size_t i = 0; i < pixelCount; i++)
+		{
+			float* pixel = level.pixels.data() + i * 4;
+			float length = std::sqrt(pixel[0] * pixel[0] + pixel[1] * pixel[1] + pixel[2] * pixel[2]);
+			if (length > 0.0f)
+			{
+				pixel[0] /= length;
+				pixel[1] /= length;
+				pixel[2] /= length;
+			}
+			else
+			{
+				// Opposite normals cancel out, so fall back to pointing straight out of the surface
+				pixel[2] = 1.0f;
+			}
+		}
+	}
+
+	static float calculateAlphaCoverage(FloatLevel const& level, float const& alphaScale, float const& alphaCutoff)
+	{
+		size_t pixelCount = static_cast<size_t>(level.width) * level.height;
+		size_t coveredCount = 0;
+		for (size_t i = 0; i < pixelCount; i++)
+		{
+			if (std::min(level.pixels[i * 4 + 3] * alphaScale, 1.0f) > alphaCutoff)
+			{
+				coveredCount++;
+			}
+		}
+		return static_cast<float>(coveredCount) / pixelCount;
+	}
+
+	static float findAlphaScale(FloatLevel const& level, float const& coverage, float const& alphaCutoff)
+	{
+		// Coverage only grows with the scale, so a binary search finds the closest match
+		float low = 0.0f;
+		float high = MAX_ALPHA_SCALE;
+		for (int i = 0; i < ALPHA_SCALE_SEARCH_STEPS; i++)
+		{
+			float middle = (low + high) * 0.5f;
+			if (calculateAlphaCoverage(level, middle, alphaCutoff) < coverage)
+			{
+				low = middle;
+			}
+			else
+			{
+				high = middle;
+			}
+		}
+		return (low + high) * 0.5f;
+	}
+
+	static uint8_t toByte(float const& value)
+	{
+		return static_cast<uint8_t>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+	}
+
+	static void encodeLevel(FloatLevel const& level, int const& channels, MipSettings const& settings, float const& alphaScale, MipLevel& mipLevel)
+	{
+		mipLevel.width = level.width;
+		mipLevel.height = level.height;
+		mipLevel.data.resize(static_cast<size_t>(level.width) * level.height * channels);
+
+		bool srgb = isSrgb(channels, settings);
+		Helpers::parallelFor(static_cast<size_t>(level.height), [&](size_t const& y) {
+			for (int x = 0; x < level.width; x++)
+			{
+				size_t pixel = y * level.width + x;
+				const float* in = level.pixels.data() + pixel * 4;
+				uint8_t* out = mipLevel.data.data() + pixel * channels;
+				for (int c = 0; c < channels; c++)
+				{
+					if (srgb && c < 3)
+					{
+						out[c] = toByte(linearToSrgb(std::max(in[c], 0.0f)));
+					}
+					else if (settings.normalMap && c < 3)
+					{
+						out[c] = toByte(in[c] * 0.5f + 0.5f);
+					}
+					else if (c == 3)
+					{
+						out[c] = toByte(in[c] * alphaScale);
+					}
+					else
+					{
+						out[c] = toByte(in[c]);
+					}
+				}
+			}
+		}, getThreadCount(level.height));
+	}
+
+	void generate(const uint8_t* data, int const& width, int const& height, int const& channels, MipSettings const& settings, std::vector<MipLevel>& levels)
+	{
+		levels.clear();
+		if (data == nullptr || width <= 0 || height <= 0 || channels <= 0 || channels > 4)
+		{
+			return;
+		}
+
+		MipLevel firstLevel;
+		firstLevel.width = width;
+		firstLevel.height = height;
+		firstLevel.data.assign(data, data + static_cast<size_t>(width) * height * channels);
+		levels.push_back(std::move(firstLevel));
+
+		bool preserveCoverage = settings.alphaCutoff > 0.0f && channels == 4;
+		float coverage = preserveCoverage ? calculateAlphaCoverage(levels[0], channels, settings.alphaCutoff) : 0.0f;
+
+		FloatLevel level;
+		decodeLevel(data, width, height, channels, settings, level);
+
+		// Each level is filtered from the unscaled one before it, so alpha scaling never compounds
+		FloatLevel nextLevel;
+		while (level.width > 1 || level.height > 1)
+		{
+			nextLevel.width = std::max(level.width / 2, 1);
+			nextLevel.height = std::max(level.height / 2, 1);
+			nextLevel.pixels.resize(static_cast<size_t>(nextLevel.width) * nextLevel.height * 4);
+
+			if (settings.filter == MipFilter::Kaiser)
+			{
+				downsampleKaiser(level, nextLevel);
+			}
+			else
+			{
+				downsampleBox(level, nextLevel);
+			}
+
+			if (settings.normalMap)
+			{
+				renormalize(nextLevel);
+			}
+
+			float alphaScale = preserveCoverage ? findAlphaScale(nextLevel, coverage, settings.alphaCutoff) : 1.0f;
+
+			MipLevel mipLevel;
+			encodeLevel(nextLevel, channels, settings, alphaScale, mipLevel);
+			levels.push_back(std::move(mipLevel));
+
+			std::swap(level, nextLevel);
+		}
+	}
+
+	float calculateAlphaCoverage(MipLevel const& level, int const& channels, float const& alphaCutoff)
+	{
+		size_t pixelCount = static_cast<size_t>(level.width) * level.height;
+		if (channels != 4 || pixelCount == 0)
+		{
+			return 1.0f;
+		}
+
+		size_t coveredCount = 0;
+		for (size_t i = 0; i < pixelCount; i++)
+		{
+			if (level.data[i * 4 + 3] / 255.0f > alphaCutoff)
+			{
+				coveredCount++;
+			}
+		}
+		return static_cast<float>(coveredCount) / pixelCount;
+	}
+
+	std::string filterToString(MipFilter const& filter)
+	{
+		switch (filter)
+		{
+		case MipFilter::Kaiser:
+			return "Kaiser";
+		default:
+			return "Box";
+		}
+	}
+
+	bool stringToFilter(std::string const& name, MipFilter& filter)
+	{
+		if (name == "Box")
+		{
+			filter = MipFilter::Box;
+			return true;
+		}
+		if (name == "Kaiser")
+		{
+			filter = MipFilter::Kaiser;
+			return true;
+		}
+		return false;
+	}
+
+}
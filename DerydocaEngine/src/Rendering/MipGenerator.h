@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace DerydocaEngine::Rendering
+{
+
+	/* Filter used to shrink each level of a mip chain into the next */
+	enum class MipFilter
+	{
+		/* Averages each 2x2 square of pixels */
+		Box,
+		/* Kaiser windowed sinc over 8 pixels in each direction, sharper than a box without ringing much */
+		Kaiser
+	};
+
+	/* How the mip chain of a texture is built */
+	struct MipSettings
+	{
+		MipFilter filter = MipFilter::Box;
+		/* Whether the color channels are sRGB encoded, so they are averaged as linear light */
+		bool srgb = true;
+		/* Whether the texture stores tangent space normals, which are renormalized on every level */
+		bool normalMap = false;
+		/*
+		Alpha value that cutout shaders discard below, or 0 when the texture is not a cutout. Smaller
+		levels have their alpha scaled so the same share of pixels passes the test as in the full
+		size image, otherwise cutouts such as foliage thin out and vanish in the distance.
+		*/
+		float alphaCutoff = 0.0f;
+	};
+
+	/* A single level of a mip chain, with the channels of the source image */
+	struct MipLevel
+	{
+		int width = 0;
+		int height = 0;
+		std::vector<uint8_t> data;
+	};
+
+	/*
+	Builds mip chains on the CPU, so the result is the same on every driver and no GPU time is spent
+	on it while loading. Levels are filtered in floating point with a whole RGBA pixel in each SIMD
+	register, and the rows of each level are spread over every core.
+	*/
+	namespace MipGenerator
+	{
+
+		/*
+		Builds the full mip chain of an image, down to 1x1.
+
+		@param data Pixels of the image
+		@param width Width of the image
+		@param height Height of the image
+		@param channels Number of 8 bit channels per pixel. sRGB decoding only applies to images
+		with at least three channels, alpha coverage only to images with four.
+		@param settings How to filter the levels
+		@param levels Receives every level, starting with a copy of the image itself
+		*/
+		void generate(const uint8_t* data, int const& width, int const& height, int const& channels, MipSettings const& settings, std::vector<MipLevel>& levels);
+
+		/*
+		Gets the share of pixels whose alpha is above a cutoff.
+
+		@param level Level to measure
+		@param channels Number of channels per pixel, where the fourth is alpha
+		@param alphaCutoff Alpha value pixels are tested against
+		@return Share of pixels that pass, from 0 to 1
+		*/
+		float calculateAlphaCoverage(MipLevel const& level, int const& channels, float const& alphaCutoff);
+
+		std::string filterToString(MipFilter const& filter);
+
+		/* @return False if no filter has that name */
+		bool stringToFilter(std::string const& name, MipFilter& filter);
+
+	}
+
+}
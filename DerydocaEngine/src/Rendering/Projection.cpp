@@ -10,7 +10,7 @@ namespace DerydocaEngine::Rendering
 		switch (m_projectionMode)
 		{
 		case ProjectionMode::Orthographic:
-			m_projectionMatrix = glm::mat4(); //glm::ortho(-m_orthoSize, m_orthoSize, -m_orthoSize, m_orthoSize, m_zNear, m_zFar);
+			m_projectionMatrix = glm::ortho(m_orthoBounds.x, m_orthoBounds.y, m_orthoBounds.z, m_orthoBounds.w, m_zNear, m_zFar);
 			break;
 		case ProjectionMode::Perspective:
 			m_projectionMatrix = glm::perspective(m_fov * (glm::pi<float>() / 180), m_aspect, m_zNear, m_zFar);
@@ -1,5 +1,6 @@
 #pragma once
 #include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
 
@@ -23,7 +24,8 @@ namespace DerydocaEngine::Rendering
 			m_fov(60.0f),
 			m_aspect(1.0f),
 			m_zNear(0.01f),
-			m_zFar(1000.0f)
+			m_zFar(1000.0f),
+			m_orthoBounds(-1.0f, 1.0f, -1.0f, 1.0f)
 		{
 		}
 
@@ -48,6 +50,13 @@ namespace DerydocaEngine::Rendering
 		void setZNear(float const& zNear) { m_zNear = zNear; }
 		void setZFar(float const& zFar) { m_zFar = zFar; }
 
+		/*
+		Sets the bounds of the view volume when using an orthographic projection.
+
+		@param bounds Left, right, bottom and top edges of the view volume
+		*/
+		void setOrthographicBounds(glm::vec4 const& bounds) { m_orthoBounds = bounds; }
+
 		float& getFov() { return m_fov; }
 		float getFov() const { return m_fov; }
 		float getAspectRatio() const { return m_aspect; }
@@ -55,6 +64,8 @@ namespace DerydocaEngine::Rendering
 		float getZNear() const { return m_zNear; }
 		float& getZFar() { return m_zFar; }
 		float getZFar() const { return m_zFar; }
+		ProjectionMode getProjectionMode() const { return m_projectionMode; }
+		glm::vec4 getOrthographicBounds() const { return m_orthoBounds; }
 	private:
 		glm::mat4 m_projectionMatrix;
 		ProjectionMode m_projectionMode;
@@ -62,6 +73,7 @@ namespace DerydocaEngine::Rendering
 		float m_aspect;
 		float m_zNear;
 		float m_zFar;
+		glm::vec4 m_orthoBounds;
 	};
 
 }
@@ -1,9 +1,16 @@
 #include "EnginePch.h"
 #include "Renderer.h"
 #include "Input\InputManager.h"
+#include "Rendering\GeometryArena.h"
 #include "Rendering\LightManager.h"
 #include "GameObject.h"
 #include "Rendering\MatrixStack.h"
+#include "Rendering\ShaderVariantCompiler.h"
+#include "Rendering\TextureUploader.h"
+#include "Resources\ResidencyManager.h"
+#include "Resources\ResourceLoader.h"
+#include "Resources\ResourceReloader.h"
+#include "Resources\TextureStreamer.h"
 #include "GraphicsAPI.h"
 
 namespace DerydocaEngine::Rendering
@@ -57,9 +64,30 @@ namespace DerydocaEngine::Rendering
 	{
 		while (!m_implementation.getDisplay()->isClosed())
 		{
+			// Finish building any shader variants that became ready since the last frame
+			Rendering::ShaderVariantCompiler::getInstance().update();
+
+			// Upload resources whose files were read since the last frame, within the frame's upload budget
+			Resources::ResourceLoader::getInstance().update();
+
+			// Swap resources whose files changed into the objects that use them before anything is drawn
+			Resources::ResourceReloader::getInstance().update();
+
+			// Copy the next chunks of queued texture uploads through the staging ring, within the frame's upload budget
+			Rendering::TextureUploader::getInstance().update();
+
 			// Have the renderer implementation render a frame
 			m_implementation.renderFrame(m_clock.getDeltaTime());
 
+			// Stream in the texture levels the frame asked for, and drop levels nothing asked for lately
+			Resources::TextureStreamer::getInstance().update();
+
+			// Unload unreferenced resources from any type that went over its memory budget
+			Resources::ResidencyManager::getInstance().update();
+
+			// Pack the geometry pools whose free space the unloaded meshes left scattered
+			Rendering::GeometryArena::getInstance().defragment();
+
 			// Let the display respond to any input events
 			m_implementation.getDisplay()->update();
 
@@ -0,0 +1,50 @@
+#include "EnginePch.h"
+#include "Rendering\RendererKeywords.h"
+
+#include "Rendering\Material.h"
+#include "Rendering\Shader.h"
+
+namespace DerydocaEngine::Rendering
+{
+
+	RendererKeywords::RendererKeywords() :
+		m_keywords(),
+		m_key(),
+		m_shaderKeywordsId(0)
+	{
+	}
+
+	RendererKeywords::RendererKeywords(std::vector<std::string> const& keywords) :
+		m_keywords(keywords),
+		m_key(),
+		m_shaderKeywordsId(0)
+	{
+	}
+
+	void RendererKeywords::setKeywords(std::vector<std::string> const& keywords)
+	{
+		m_keywords = keywords;
+		m_shaderKeywordsId = 0;
+	}
+
+	ShaderVariantKey const& RendererKeywords::getKey(Material const& material)
+	{
+		auto shader = material.getBaseShader();
+		if (!shader)
+		{
+			m_key = ShaderVariantKey();
+			m_shaderKeywordsId = 0;
+			return m_key;
+		}
+
+		// A different shader, or a reloaded one, may declare its keywords in another order
+		if (m_shaderKeywordsId != shader->getKeywordsId())
+		{
+			m_key = ShaderVariantKey::fromKeywords(shader->getKeywords(), m_keywords);
+			m_shaderKeywordsId = shader->getKeywordsId();
+		}
+
+		return m_key;
+	}
+
+}
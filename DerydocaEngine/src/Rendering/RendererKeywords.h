@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Rendering\ShaderVariantKey.h"
+
+namespace DerydocaEngine::Rendering
+{
+	class Material;
+
+	/*
+	Keywords a renderer enables on top of its material's own, such as the keywords of its mesh's
+	vertex layout. They are matched against the keywords the material's shader declares once, and
+	again only when they change or the shader does, so drawing only passes the resolved key.
+	*/
+	class RendererKeywords
+	{
+	public:
+		RendererKeywords();
+		explicit RendererKeywords(std::vector<std::string> const& keywords);
+
+		/*
+		Replaces the keywords, which are resolved again the next time a key is requested.
+
+		@param keywords Keywords the renderer enables
+		*/
+		void setKeywords(std::vector<std::string> const& keywords);
+		std::vector<std::string> const& getKeywords() const { return m_keywords; }
+
+		/*
+		Gets the key of the renderer's keywords for the shader of a material.
+
+		@param material Material being drawn
+		@return Key of the enabled keywords the shader declares
+		*/
+		ShaderVariantKey const& getKey(Material const& material);
+	private:
+		std::vector<std::string> m_keywords;
+		ShaderVariantKey m_key;
+		// Keywords ID of the shader the key was resolved for, 0 before it is first resolved
+		uint64_t m_shaderKeywordsId;
+	};
+
+}
@@ -1,6 +1,7 @@
 #include "EnginePch.h"
 #include "Rendering\Shader.h"
 
+#include <atomic>
 #include <fstream>
 #include <GL/glew.h>
 #include <glm/gtc/type_ptr.hpp>
@@ -12,113 +13,224 @@
 #include "Rendering\Mesh.h"
 #include "Rendering\RenderPass.h"
 #include "Rendering\RenderTexture.h"
+#include "Rendering\ShaderPreprocessor.h"
+#include "Rendering\ShaderProgramCache.h"
+#include "Rendering\ShaderVariantCompiler.h"
 #include "Rendering\Texture.h"
 #include "Components\Transform.h"
 
 namespace DerydocaEngine::Rendering
 {
 
-#define LOAD_SHADER_IF_EXISTS(shaderIndex, shaderType, fileName) \
-{ \
-	if(CheckIfShaderExists(fileName)) \
-	{ \
-		m_shaders[(shaderIndex)] = CreateShader(LoadShader(fileName), shaderType); \
-	} \
-}
-
 	static void CheckShaderError(unsigned int const& shader, unsigned int const& flag, bool const& isProgram, std::string const& errorMessage);
-	static std::string LoadShader(std::string const& fileName);
 	static bool CheckIfShaderExists(std::string const& fileName);
 	static unsigned int CreateShader(std::string const& text, unsigned int const& shaderType);
 
+	// Source of keywords IDs, which start at 1 so renderers can use 0 for a key that was never resolved
+	static std::atomic<uint64_t> s_nextKeywordsId(1);
+
 	Shader::Shader(std::string const& fileName) :
+		Shader(fileName, 0, nullptr)
+	{
+	}
+
+	Shader::Shader(std::string const& fileName, int const& varyingsCount, const char * const * varyings) :
 		m_rendererId(0),
 		m_shaders(),
 		m_uniforms(),
 		m_loadPath(fileName),
 		m_uniformLookup(),
 		m_numPasses(0),
-		m_renderPasses()
+		m_renderPasses(),
+		m_subPassProgram(0),
+		m_varyings(varyings, varyings + std::max(varyingsCount, 0)),
+		m_keywords(),
+		m_keywordsId(s_nextKeywordsId++),
+		m_variantKey(),
+		m_baseShader(),
+		m_variants()
 	{
-		printf("Loading shader: %s\n", fileName.c_str());
+		auto sources = preprocessSources(m_loadPath, {}, m_keywords);
+		loadProgram(sources, varyingsCount, varyings);
+	}
 
-		// Create the shaders
-		LOAD_SHADER_IF_EXISTS(0, GL_VERTEX_SHADER, GetVertexShaderPath());
-		LOAD_SHADER_IF_EXISTS(1, GL_TESS_CONTROL_SHADER, GetTesslleationControlShaderPath());
-		LOAD_SHADER_IF_EXISTS(2, GL_TESS_EVALUATION_SHADER, GetTessellationEvaluationShaderPath());
-		LOAD_SHADER_IF_EXISTS(3, GL_GEOMETRY_SHADER, GetGeometryShaderPath());
-		LOAD_SHADER_IF_EXISTS(4, GL_FRAGMENT_SHADER, GetFragmentShaderPath());
+	Shader::Shader(std::string const& fileName, std::array<std::string, NUM_SHADERS> const& sources, std::vector<std::string> const& keywords, ShaderVariantKey const& variantKey, std::vector<std::string> const& varyings) :
+		m_rendererId(0),
+		m_shaders(),
+		m_uniforms(),
+		m_loadPath(fileName),
+		m_uniformLookup(),
+		m_numPasses(0),
+		m_renderPasses(),
+		m_subPassProgram(0),
+		m_varyings(varyings),
+		m_keywords(keywords),
+		m_keywordsId(s_nextKeywordsId++),
+		m_variantKey(variantKey),
+		m_baseShader(),
+		m_variants()
+	{
+		// Variants capture the same varyings as their base shader
+		std::vector<const char*> varyingNames;
+		for (auto const& varying : m_varyings)
+		{
+			varyingNames.push_back(varying.c_str());
+		}
+		loadProgram(sources, static_cast<int>(varyingNames.size()), varyingNames.data());
+	}
 
-		// Create the program
-		m_rendererId = glCreateProgram();
-		if (0 == m_rendererId)
+	std::array<std::string, Shader::NUM_SHADERS> Shader::preprocessSources(std::string const& loadPath, std::vector<std::string> const& keywords, std::vector<std::string>& declaredKeywords)
+	{
+		std::string stageExtensions[NUM_SHADERS] = { ".vs", ".tcs", ".tes", ".gs", ".fs" };
+
+		// Expand the includes of every stage that exists for this shader
+		std::array<std::string, NUM_SHADERS> sources;
+		ShaderPreprocessor preprocessor;
+		for (unsigned int i = 0; i < NUM_SHADERS; i++)
 		{
-			fprintf(stderr, "Error creating program object..\n");
-			__debugbreak();
+			std::string stagePath = loadPath + stageExtensions[i];
+			if (CheckIfShaderExists(stagePath))
+			{
+				sources[i] = preprocessor.processFile(stagePath, keywords);
+			}
 		}
 
-		// Attach the shaders to the program
-		for (unsigned int i = 0; i < NUM_SHADERS; i++) {
-			// Skip shaders that were not loaded (i.e. shaders w/o geom shaders)
-			if (m_shaders[i] == 0)
+		for (auto const& error : preprocessor.getErrors())
+		{
+			std::cerr << "Shader preprocessor error: " << error << "\n";
+		}
+
+		declaredKeywords = preprocessor.getDeclaredKeywords();
+		return sources;
+	}
+
+	std::shared_ptr<Shader> Shader::getVariant(ShaderVariantKey const& variantKey, bool const& fallback)
+	{
+		// Variants are always looked up through the shader they were built from
+		auto baseShader = m_baseShader.lock();
+		if (baseShader)
+		{
+			return baseShader->getVariant(variantKey, fallback);
+		}
+
+		if (variantKey.isDefault() || m_keywords.empty())
+		{
+			return shared_from_this();
+		}
+
+		auto it = m_variants.find(variantKey.getMask());
+		if (it != m_variants.end())
+		{
+			// Variants that are still compiling, or failed to, fall back to this shader
+			if (it->second)
 			{
-				continue;
+				return it->second;
 			}
+			return fallback ? shared_from_this() : nullptr;
+		}
 
-			glAttachShader(m_rendererId, m_shaders[i]);
+		m_variants[variantKey.getMask()] = nullptr;
+		ShaderVariantCompiler::getInstance().requestVariant(shared_from_this(), variantKey);
+		return fallback ? shared_from_this() : nullptr;
+	}
+
+	void Shader::addVariant(ShaderVariantKey const& variantKey, std::shared_ptr<Shader> const& variant)
+	{
+		if (variant)
+		{
+			variant->m_baseShader = shared_from_this();
+
+			// The variant renders the same passes, through subroutines of its own program
+			if (m_numPasses > 0)
+			{
+				variant->setSubPasses(m_subPassProgram, m_renderPasses, m_numPasses);
+			}
 		}
+		m_variants[variantKey.getMask()] = variant;
+	}
 
-		// Get the vertex attribute locations
-		glBindAttribLocation(m_rendererId, 0, "VertexPosition");
-		glBindAttribLocation(m_rendererId, 1, "VertexTexCoord");
-		glBindAttribLocation(m_rendererId, 2, "VertexNormal");
-		glBindAttribLocation(m_rendererId, 3, "VertexTangent");
-		glBindAttribLocation(m_rendererId, 4, "VertexBitangent");
-		glBindAttribLocation(m_rendererId, 5, "VertexColor");
-		glBindAttribLocation(m_rendererId, 6, "VertexBoneIndices");
-		glBindAttribLocation(m_rendererId, 7, "VertexBoneWeights");
+	void Shader::swapProgram(Shader& other)
+	{
+		std::swap(m_rendererId, other.m_rendererId);
+		std::swap(m_shaders, other.m_shaders);
+		std::swap(m_uniforms, other.m_uniforms);
+		std::swap(m_uniformLookup, other.m_uniformLookup);
+		std::swap(m_keywords, other.m_keywords);
+		m_keywordsId = s_nextKeywordsId++;
+		m_variants.clear();
+	}
 
-		// Bind the output color to 0
-		glBindFragDataLocation(m_rendererId, 0, "FragColor");
+	bool Shader::isLinked() const
+	{
+		GLint linkStatus = GL_FALSE;
+		glGetProgramiv(m_rendererId, GL_LINK_STATUS, &linkStatus);
+		return linkStatus == GL_TRUE;
+	}
 
-		// Link the program
-		glLinkProgram(m_rendererId);
-		CheckShaderError(m_rendererId, GL_LINK_STATUS, true, "Error: Program linking failed: ");
+	void Shader::loadProgram(std::array<std::string, NUM_SHADERS> const& sources, int const& varyingsCount, const char * const * varyings)
+	{
+		std::string variantName = m_variantKey.getName(m_keywords);
+		printf("Loading shader: %s%s\n", m_loadPath.c_str(), variantName.empty() ? "" : (" [" + variantName + "]").c_str());
+		auto loadStartTime = std::chrono::high_resolution_clock::now();
 
-		glValidateProgram(m_rendererId);
-		CheckShaderError(m_rendererId, GL_VALIDATE_STATUS, true, "Error: Program is invalid: ");
+		// Create the program
+		m_rendererId = glCreateProgram();
+		if (0 == m_rendererId)
+		{
+			fprintf(stderr, "Error creating program object..\n");
+			__debugbreak();
+		}
+
+		// Restore the linked program from the binary cache if nothing it was built from has changed
+		ShaderProgramCache& programCache = ShaderProgramCache::getInstance();
+		std::string programName = m_loadPath;
+		if (!variantName.empty())
+		{
+			programName += "#" + variantName;
+		}
+		for (int i = 0; i < varyingsCount; i++)
+		{
+			programName += "|" + std::string(varyings[i]);
+		}
+		uint64_t programKey = programCache.calculateProgramKey(sources, varyingsCount, varyings);
+
+		if (!programCache.loadProgram(m_rendererId, programName, programKey))
+		{
+			compileProgram(sources, varyingsCount, varyings);
+
+			if (isLinked())
+			{
+				programCache.saveProgram(m_rendererId, programName, programKey);
+			}
+		}
 
 		m_uniforms[TRANSFORM_MVP] = glGetUniformLocation(m_rendererId, "MVP");
 		m_uniforms[TRANSFORM_MV] = glGetUniformLocation(m_rendererId, "ModelViewMatrix");
 		m_uniforms[TRANSFORM_NORMAL] = glGetUniformLocation(m_rendererId, "NormalMatrix");
 		m_uniforms[TRANSFORM_PROJECTION] = glGetUniformLocation(m_rendererId, "ProjectionMatrix");
 		m_uniforms[TRANSFORM_MODEL] = glGetUniformLocation(m_rendererId, "ModelMatrix");
+
+		std::chrono::duration<double, std::milli> loadTime = std::chrono::high_resolution_clock::now() - loadStartTime;
+		programCache.recordLoadTime(loadTime.count());
 	}
 
-	Shader::Shader(std::string const& fileName, int const& varyingsCount, const char * const * varyings) :
-		m_rendererId(0),
-		m_shaders(),
-		m_uniforms(),
-		m_loadPath(fileName),
-		m_uniformLookup(),
-		m_numPasses(0),
-		m_renderPasses()
+	void Shader::compileProgram(std::array<std::string, NUM_SHADERS> const& sources, int const& varyingsCount, const char * const * varyings)
 	{
-		printf("Loading shader: %s\n", fileName.c_str());
+		unsigned int shaderTypes[NUM_SHADERS] = {
+			GL_VERTEX_SHADER,
+			GL_TESS_CONTROL_SHADER,
+			GL_TESS_EVALUATION_SHADER,
+			GL_GEOMETRY_SHADER,
+			GL_FRAGMENT_SHADER
+		};
 
 		// Create the shaders
-		LOAD_SHADER_IF_EXISTS(0, GL_VERTEX_SHADER, GetVertexShaderPath());
-		LOAD_SHADER_IF_EXISTS(1, GL_TESS_CONTROL_SHADER, GetTesslleationControlShaderPath());
-		LOAD_SHADER_IF_EXISTS(2, GL_TESS_EVALUATION_SHADER, GetTessellationEvaluationShaderPath());
-		LOAD_SHADER_IF_EXISTS(3, GL_GEOMETRY_SHADER, GetGeometryShaderPath());
-		LOAD_SHADER_IF_EXISTS(4, GL_FRAGMENT_SHADER, GetFragmentShaderPath());
-
-		// Create the program
-		m_rendererId = glCreateProgram();
-		if (0 == m_rendererId)
+		for (unsigned int i = 0; i < NUM_SHADERS; i++)
 		{
-			fprintf(stderr, "Error creating program object..\n");
-			__debugbreak();
+			if (!sources[i].empty())
+			{
+				m_shaders[i] = CreateShader(sources[i], shaderTypes[i]);
+			}
 		}
 
 		// Attach the shaders to the program
@@ -146,7 +258,13 @@ namespace DerydocaEngine::Rendering
 		glBindFragDataLocation(m_rendererId, 0, "FragColor");
 
 		// Bind the varyings
-		setTransformFeedbackVaryings(varyingsCount, varyings);
+		if (varyingsCount > 0)
+		{
+			setTransformFeedbackVaryings(varyingsCount, varyings);
+		}
+
+		// Ask the driver to keep the linked binary around so it can be cached
+		ShaderProgramCache::getInstance().prepareProgram(m_rendererId);
 
 		// Link the program
 		glLinkProgram(m_rendererId);
@@ -154,12 +272,6 @@ namespace DerydocaEngine::Rendering
 
 		glValidateProgram(m_rendererId);
 		CheckShaderError(m_rendererId, GL_VALIDATE_STATUS, true, "Error: Program is invalid: ");
-
-		m_uniforms[TRANSFORM_MVP] = glGetUniformLocation(m_rendererId, "MVP");
-		m_uniforms[TRANSFORM_MV] = glGetUniformLocation(m_rendererId, "ModelViewMatrix");
-		m_uniforms[TRANSFORM_NORMAL] = glGetUniformLocation(m_rendererId, "NormalMatrix");
-		m_uniforms[TRANSFORM_PROJECTION] = glGetUniformLocation(m_rendererId, "ProjectionMatrix");
-		m_uniforms[TRANSFORM_MODEL] = glGetUniformLocation(m_rendererId, "ModelMatrix");
 	}
 
 	Shader::~Shader()
@@ -369,14 +481,25 @@ namespace DerydocaEngine::Rendering
 	void Shader::setSubPasses(unsigned int const& program, RenderPass* const& renderPasses, int const& numPasses)
 	{
 		m_numPasses = numPasses;
+		m_subPassProgram = program;
 
-		delete[] m_renderPasses;
+		RenderPass* previousRenderPasses = m_renderPasses;
 		m_renderPasses = new RenderPass[numPasses];
 		for (int i = 0; i < numPasses; i++)
 		{
 			int subroutineIndex = getSubroutineIndex(program, renderPasses[i].getName());
 			m_renderPasses[i] = RenderPass(&renderPasses[i], subroutineIndex);
 		}
+		delete[] previousRenderPasses;
+
+		// Variants that were already built render the new passes too
+		for (auto const& variant : m_variants)
+		{
+			if (variant.second)
+			{
+				variant.second->setSubPasses(program, m_renderPasses, numPasses);
+			}
+		}
 	}
 
 	void Shader::renderMesh(const std::shared_ptr<Mesh> mesh, std::shared_ptr<RenderTexture> m_renderTexture)
@@ -465,26 +588,6 @@ namespace DerydocaEngine::Rendering
 		return shader;
 	}
 
-	static std::string LoadShader(std::string const& fileName) {
-		std::ifstream file;
-		file.open((fileName).c_str());
-
-		std::string output;
-		std::string line;
-
-		if (file.is_open()) {
-			while (file.good()) {
-				getline(file, line);
-				output.append(line + "\n");
-			}
-		}
-		else {
-			std::cerr << "Unable to load shader: " << fileName << "\n";
-		}
-
-		return output;
-	}
-
 	static bool CheckIfShaderExists(std::string const& fileName)
 	{
 		struct stat buffer;
@@ -1,10 +1,12 @@
 #pragma once
+#include <array>
 #include <map>
 #include <memory>
 #include <string>
 #include <vector>
 #include "Color.h"
 #include "Rendering\Projection.h"
+#include "Rendering\ShaderVariantKey.h"
 
 namespace DerydocaEngine {
 	namespace Components {
@@ -22,13 +24,73 @@ namespace DerydocaEngine {
 namespace DerydocaEngine::Rendering
 {
 
-	class Shader
+	class Shader : public std::enable_shared_from_this<Shader>
 	{
 	public:
+		static const unsigned int NUM_SHADERS = 5;
+
 		Shader(std::string const& fileName);
 		Shader(std::string const& fileName, int const& count, const char *const * varyings);
+
+		/*
+		Creates a variant of a shader from sources that were already preprocessed.
+
+		@param fileName Load path of the shader the variant belongs to
+		@param sources Preprocessed source of each shader stage, empty for stages that are not used
+		@param keywords Keywords declared by the shader
+		@param variantKey Key of the variant
+		@param varyings Transform feedback varyings of the shader the variant belongs to
+		*/
+		Shader(std::string const& fileName, std::array<std::string, NUM_SHADERS> const& sources, std::vector<std::string> const& keywords, ShaderVariantKey const& variantKey, std::vector<std::string> const& varyings);
 		~Shader();
 
+		/*
+		Reads and preprocesses the source of every stage of a shader.
+
+		@param loadPath Load path of the shader, without a stage extension
+		@param keywords Keywords to define
+		@param declaredKeywords Receives the keywords the shader declares
+
+		@return Preprocessed source of each stage, empty for stages that do not exist
+		*/
+		static std::array<std::string, NUM_SHADERS> preprocessSources(std::string const& loadPath, std::vector<std::string> const& keywords, std::vector<std::string>& declaredKeywords);
+
+		/*
+		Gets the variant of this shader built with a set of keywords. Variants are compiled in the
+		background, so this shader is returned until the requested variant is ready.
+
+		@param variantKey Key of the variant
+		@param fallback Whether this shader stands in for a variant that is not ready. Keywords that
+			change how vertices are read cannot be left out, so those variants are requested without it.
+		@return The variant if it is ready, otherwise this shader, or nullptr without a fallback
+		*/
+		std::shared_ptr<Shader> getVariant(ShaderVariantKey const& variantKey, bool const& fallback = true);
+
+		/*
+		Registers a compiled variant of this shader.
+
+		@param variantKey Key of the variant
+		@param variant The compiled variant, or nullptr if it failed to build
+		*/
+		void addVariant(ShaderVariantKey const& variantKey, std::shared_ptr<Shader> const& variant);
+
+		/*
+		Exchanges the linked program with another shader's, such as one that was just built from
+		changed source files. Variants are built again from the new source the next time they are
+		requested.
+
+		@param other Shader to exchange with
+		*/
+		void swapProgram(Shader& other);
+
+		std::vector<std::string> const& getKeywords() const { return m_keywords; }
+
+		/* Identifies the keywords the shader declares, and changes whenever the shader is reloaded */
+		uint64_t getKeywordsId() const { return m_keywordsId; }
+		std::vector<std::string> const& getVaryings() const { return m_varyings; }
+		ShaderVariantKey getVariantKey() const { return m_variantKey; }
+		bool isLinked() const;
+
 		void bind();
 		void update(
 			const std::shared_ptr<MatrixStack>& matrixStack,
@@ -79,10 +141,11 @@ namespace DerydocaEngine::Rendering
 
 		void renderMesh(const std::shared_ptr<Mesh> mesh, std::shared_ptr<RenderTexture> renderTexture);
 	private:
-		static const unsigned int NUM_SHADERS = 5;
 		Shader(Shader const& other) {}
 		void operator=(Shader const& other) {}
 		int getUniformName(std::string const& stringName);
+		void loadProgram(std::array<std::string, NUM_SHADERS> const& sources, int const& varyingsCount, const char *const * varyings);
+		void compileProgram(std::array<std::string, NUM_SHADERS> const& sources, int const& varyingsCount, const char *const * varyings);
 		void setTransformFeedbackVaryings(int const& count, const char *const * varyings);
 
 		enum {
@@ -102,6 +165,14 @@ namespace DerydocaEngine::Rendering
 		std::map<std::string, int> m_uniformLookup;
 		int m_numPasses;
 		RenderPass* m_renderPasses;
+		// Stage the sub pass subroutines belong to, so variants can look up their own indices
+		unsigned int m_subPassProgram;
+		std::vector<std::string> m_varyings;
+		std::vector<std::string> m_keywords;
+		uint64_t m_keywordsId;
+		ShaderVariantKey m_variantKey;
+		std::weak_ptr<Shader> m_baseShader;
+		std::map<uint32_t, std::shared_ptr<Shader>> m_variants;
 	};
 
 }
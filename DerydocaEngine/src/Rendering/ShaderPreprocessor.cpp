@@ -0,0 +1,290 @@
+#include "EnginePch.h"
+#include "Rendering\ShaderPreprocessor.h"
+
+#include <sstream>
+
+namespace DerydocaEngine::Rendering
+{
+
+	// Guards against runaway include chains
+	static const int MAX_INCLUDE_DEPTH = 32;
+
+	static std::string trimStart(std::string const& line)
+	{
+		size_t start = line.find_first_not_of(" \t");
+		return start == std::string::npos ? std::string() : line.substr(start);
+	}
+
+	static bool parseDirective(std::string const& line, std::string& directive, std::string& arguments)
+	{
+		std::string trimmed = trimStart(line);
+		if (trimmed.empty() || trimmed[0] != '#')
+		{
+			return false;
+		}
+
+		// Allow whitespace between the hash and the directive name
+		std::string afterHash = trimStart(trimmed.substr(1));
+		size_t nameEnd = afterHash.find_first_of(" \t");
+		directive = afterHash.substr(0, nameEnd);
+		arguments = nameEnd == std::string::npos ? std::string() : trimStart(afterHash.substr(nameEnd));
+		return true;
+	}
+
+	static std::vector<std::string> splitLines(std::string const& source)
+	{
+		std::vector<std::string> lines;
+		std::string line;
+		std::istringstream stream(source);
+		while (std::getline(stream, line))
+		{
+			if (!line.empty() && line.back() == '\r')
+			{
+				line.pop_back();
+			}
+			lines.push_back(line);
+		}
+		return lines;
+	}
+
+	static std::string normalizePath(std::string const& path)
+	{
+		// Use forward slashes and collapse "." and ".." segments so the same file is always spelled the same way
+		std::string slashed = path;
+		std::replace(slashed.begin(), slashed.end(), '\\', '/');
+
+		bool isAbsolute = !slashed.empty() && slashed[0] == '/';
+		std::vector<std::string> segments;
+		std::string segment;
+		std::istringstream stream(slashed);
+		while (std::getline(stream, segment, '/'))
+		{
+			if (segment.empty() || segment == ".")
+			{
+				continue;
+			}
+
+			if (segment == ".." && !segments.empty() && segments.back() != "..")
+			{
+				segments.pop_back();
+				continue;
+			}
+
+			segments.push_back(segment);
+		}
+
+		std::string normalized = isAbsolute ? "/" : "";
+		for (size_t i = 0; i < segments.size(); i++)
+		{
+			if (i > 0)
+			{
+				normalized += "/";
+			}
+			normalized += segments[i];
+		}
+		return normalized;
+	}
+
+	ShaderPreprocessor::ShaderPreprocessor() :
+		ShaderPreprocessor(&ShaderPreprocessor::readFile)
+	{
+	}
+
+	ShaderPreprocessor::ShaderPreprocessor(FileReader const& fileReader) :
+		m_fileReader(fileReader),
+		m_includedFiles(),
+		m_declaredKeywords(),
+		m_errors()
+	{
+	}
+
+	ShaderPreprocessor::~ShaderPreprocessor()
+	{
+	}
+
+	std::string ShaderPreprocessor::process(std::string const& source, std::string const& sourcePath, std::vector<std::string> const& keywords)
+	{
+		// Every stage is compiled on its own, so includes only need to be unique within a single source
+		m_includedFiles.clear();
+		m_includedFiles.push_back(normalizePath(sourcePath));
+
+		std::string defines;
+		for (auto const& keyword : keywords)
+		{
+			defines += "#define " + keyword + "\n";
+		}
+
+		// Keyword defines must come after #version, which has to be the first statement of the source
+		std::vector<std::string> lines = splitLines(source);
+		size_t versionLine = lines.size();
+		for (size_t i = 0; i < lines.size(); i++)
+		{
+			std::string directive;
+			std::string arguments;
+			if (parseDirective(lines[i], directive, arguments) && directive == "version")
+			{
+				versionLine = i;
+				break;
+			}
+		}
+
+		std::string output;
+		if (versionLine == lines.size())
+		{
+			output += defines;
+			if (!defines.empty())
+			{
+				output += "#line 1\n";
+			}
+			expand(source, sourcePath, 1, output, 0);
+			return output;
+		}
+
+		std::string header;
+		std::string body;
+		for (size_t i = 0; i <= versionLine; i++)
+		{
+			header += lines[i] + "\n";
+		}
+		for (size_t i = versionLine + 1; i < lines.size(); i++)
+		{
+			body += lines[i] + "\n";
+		}
+
+		output += header;
+		output += defines;
+		output += "#line " + std::to_string(versionLine + 2) + "\n";
+		expand(body, sourcePath, (int)versionLine + 2, output, 0);
+		return output;
+	}
+
+	std::string ShaderPreprocessor::processFile(std::string const& path, std::vector<std::string> const& keywords)
+	{
+		std::string source;
+		if (!m_fileReader(path, source))
+		{
+			m_errors.push_back("Unable to read shader file '" + path + "'.");
+			return std::string();
+		}
+
+		return process(source, path, keywords);
+	}
+
+	bool ShaderPreprocessor::readFile(std::string const& path, std::string& contents)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file.is_open())
+		{
+			return false;
+		}
+
+		std::ostringstream stream;
+		stream << file.rdbuf();
+		contents = stream.str();
+		return true;
+	}
+
+	void ShaderPreprocessor::expand(std::string const& source, std::string const& sourcePath, int const& firstLine, std::string& output, int const& depth)
+	{
+		std::vector<std::string> lines = splitLines(source);
+		for (size_t i = 0; i < lines.size(); i++)
+		{
+			int lineNumber = firstLine + (int)i;
+			std::string directive;
+			std::string arguments;
+			if (!parseDirective(lines[i], directive, arguments))
+			{
+				output += lines[i] + "\n";
+				continue;
+			}
+
+			// Only the whole word, so pragmas that merely start with it are passed through
+			size_t pragmaNameEnd = arguments.find_first_of(" \t");
+			if (directive == "pragma" && arguments.substr(0, pragmaNameEnd) == "keywords")
+			{
+				// Strip the declaration but keep the line so line numbers still match the file
+				declareKeywords(pragmaNameEnd == std::string::npos ? std::string() : arguments.substr(pragmaNameEnd));
+				output += "\n";
+			}
+			else if (directive == "version" && depth > 0)
+			{
+				// Only the outermost file decides the GLSL version
+				output += "\n";
+			}
+			else if (directive == "include")
+			{
+				size_t open = arguments.find_first_of("\"<");
+				size_t close = open == std::string::npos ? std::string::npos : arguments.find_first_of("\">", open + 1);
+				if (close == std::string::npos)
+				{
+					m_errors.push_back(sourcePath + "(" + std::to_string(lineNumber) + "): Malformed #include directive.");
+					output += "\n";
+					continue;
+				}
+
+				std::string includePath = resolveIncludePath(sourcePath, arguments.substr(open + 1, close - open - 1));
+				if (std::find(m_includedFiles.begin(), m_includedFiles.end(), includePath) != m_includedFiles.end())
+				{
+					output += "\n";
+					continue;
+				}
+
+				if (depth >= MAX_INCLUDE_DEPTH)
+				{
+					m_errors.push_back(sourcePath + "(" + std::to_string(lineNumber) + "): Includes are nested too deeply.");
+					output += "\n";
+					continue;
+				}
+
+				std::string includeSource;
+				if (!m_fileReader(includePath, includeSource))
+				{
+					m_errors.push_back(sourcePath + "(" + std::to_string(lineNumber) + "): Unable to open include file '" + includePath + "'.");
+					output += "\n";
+					continue;
+				}
+
+				m_includedFiles.push_back(includePath);
+				output += "#line 1\n";
+				expand(includeSource, includePath, 1, output, depth + 1);
+
+				// Resume numbering from the line after the include
+				output += "#line " + std::to_string(lineNumber + 1) + "\n";
+			}
+			else
+			{
+				output += lines[i] + "\n";
+			}
+		}
+	}
+
+	std::string ShaderPreprocessor::resolveIncludePath(std::string const& includingPath, std::string const& includePath) const
+	{
+		std::string slashed = includePath;
+		std::replace(slashed.begin(), slashed.end(), '\\', '/');
+		if ((!slashed.empty() && slashed[0] == '/') || slashed.find(':') != std::string::npos)
+		{
+			return normalizePath(slashed);
+		}
+
+		std::string includingSlashed = includingPath;
+		std::replace(includingSlashed.begin(), includingSlashed.end(), '\\', '/');
+		size_t lastSlash = includingSlashed.find_last_of('/');
+		std::string directory = lastSlash == std::string::npos ? std::string() : includingSlashed.substr(0, lastSlash + 1);
+		return normalizePath(directory + slashed);
+	}
+
+	void ShaderPreprocessor::declareKeywords(std::string const& keywordList)
+	{
+		std::istringstream stream(keywordList);
+		std::string keyword;
+		while (stream >> keyword)
+		{
+			if (std::find(m_declaredKeywords.begin(), m_declaredKeywords.end(), keyword) == m_declaredKeywords.end())
+			{
+				m_declaredKeywords.push_back(keyword);
+			}
+		}
+	}
+
+}
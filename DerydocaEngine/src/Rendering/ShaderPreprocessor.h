@@ -0,0 +1,79 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace DerydocaEngine::Rendering
+{
+
+	/*
+	Expands GLSL source before it is handed to the driver.
+
+	Supported directives:
+	  #include "file"          Inlines another file, resolved relative to the including file. Each file is only included once.
+	  #pragma keywords A B C   Declares keywords the shader can be built with. Each combination of keywords is a separate variant.
+
+	Enabled keywords are injected as #define statements directly after the #version directive.
+	*/
+	class ShaderPreprocessor
+	{
+	public:
+		/* Function used to read the contents of a file, returning false if it could not be read */
+		using FileReader = std::function<bool(std::string const& path, std::string& contents)>;
+
+		ShaderPreprocessor();
+		ShaderPreprocessor(FileReader const& fileReader);
+		~ShaderPreprocessor();
+
+		/*
+		Expands the includes of a shader source and injects the enabled keywords.
+
+		@param source Source of the shader stage
+		@param sourcePath Path of the file the source was read from, used to resolve relative includes
+		@param keywords Keywords to define for this variant
+
+		@return The expanded source
+		*/
+		std::string process(std::string const& source, std::string const& sourcePath, std::vector<std::string> const& keywords);
+
+		/*
+		Reads a shader file and expands it.
+
+		@param path Path of the shader stage file
+		@param keywords Keywords to define for this variant
+
+		@return The expanded source, or an empty string if the file could not be read
+		*/
+		std::string processFile(std::string const& path, std::vector<std::string> const& keywords);
+
+		/*
+		Gets the keywords declared with #pragma keywords by every source processed so far, including
+		the files they included. Keywords are only listed once, in the order they were declared.
+		*/
+		std::vector<std::string> const& getDeclaredKeywords() const { return m_declaredKeywords; }
+
+		/* Gets every error encountered while processing */
+		std::vector<std::string> const& getErrors() const { return m_errors; }
+
+		/*
+		Reads a file from disk.
+
+		@param path Path of the file to read
+		@param contents Receives the contents of the file
+
+		@return True if the file was read
+		*/
+		static bool readFile(std::string const& path, std::string& contents);
+
+	private:
+		void expand(std::string const& source, std::string const& sourcePath, int const& firstLine, std::string& output, int const& depth);
+		std::string resolveIncludePath(std::string const& includingPath, std::string const& includePath) const;
+		void declareKeywords(std::string const& keywordList);
+
+		FileReader m_fileReader;
+		std::vector<std::string> m_includedFiles;
+		std::vector<std::string> m_declaredKeywords;
+		std::vector<std::string> m_errors;
+	};
+
+}
@@ -0,0 +1,203 @@
+#include "EnginePch.h"
+#include "Rendering\ShaderProgramCache.h"
+
+#include <GL/glew.h>
+
+#include "Helpers\HashUtils.h"
+
+namespace DerydocaEngine::Rendering
+{
+
+	// Bump whenever the layout of cached files or the way programs are linked changes
+	static const uint32_t CACHE_FILE_VERSION = 1;
+	static const char CACHE_FILE_MAGIC[4] = { 'D', 'S', 'P', 'B' };
+
+	struct ProgramBinaryHeader
+	{
+		char magic[4];
+		uint32_t version;
+		uint64_t key;
+		uint32_t binaryFormat;
+		uint32_t binaryLength;
+	};
+
+	static std::string getGLString(GLenum const& name)
+	{
+		const GLubyte* value = glGetString(name);
+		return value ? std::string(reinterpret_cast<const char*>(value)) : std::string();
+	}
+
+	ShaderProgramCache::ShaderProgramCache() :
+		m_cacheDirectory(),
+		m_driverIdentifier(),
+		m_supported(-1),
+		m_hitCount(0),
+		m_missCount(0),
+		m_programCount(0),
+		m_totalLoadTime(0.0)
+	{
+	}
+
+	ShaderProgramCache::~ShaderProgramCache()
+	{
+	}
+
+	uint64_t ShaderProgramCache::calculateProgramKey(std::array<std::string, 5> const& sources, int const& varyingsCount, const char *const * varyings)
+	{
+		if (m_driverIdentifier.empty())
+		{
+			m_driverIdentifier = getGLString(GL_VENDOR) + "|" + getGLString(GL_RENDERER) + "|" + getGLString(GL_VERSION);
+		}
+
+		uint64_t hash = HASH_SEED;
+		hash = hashBytes(hash, &CACHE_FILE_VERSION, sizeof(CACHE_FILE_VERSION));
+		hash = hashString(hash, m_driverIdentifier);
+
+		for (auto const& source : sources)
+		{
+			hash = hashString(hash, source);
+		}
+
+		for (int i = 0; i < varyingsCount; i++)
+		{
+			hash = hashString(hash, varyings[i]);
+		}
+
+		return hash;
+	}
+
+	void ShaderProgramCache::prepareProgram(unsigned int const& program)
+	{
+		if (!isSupported())
+		{
+			return;
+		}
+
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+
+	bool ShaderProgramCache::loadProgram(unsigned int const& program, std::string const& programName, uint64_t const& key)
+	{
+		if (!isSupported())
+		{
+			return false;
+		}
+
+		std::ifstream file(getCacheFilePath(programName), std::ios::binary);
+		if (!file.is_open())
+		{
+			m_missCount++;
+			return false;
+		}
+
+		// Reject binaries written by a different version of the cache or for different inputs
+		ProgramBinaryHeader header;
+		file.read(reinterpret_cast<char*>(&header), sizeof(header));
+		if (!file.good() ||
+			memcmp(header.magic, CACHE_FILE_MAGIC, sizeof(CACHE_FILE_MAGIC)) != 0 ||
+			header.version != CACHE_FILE_VERSION ||
+			header.key != key)
+		{
+			m_missCount++;
+			return false;
+		}
+
+		std::vector<char> binary(header.binaryLength);
+		file.read(binary.data(), header.binaryLength);
+		if (!file.good())
+		{
+			m_missCount++;
+			return false;
+		}
+
+		glProgramBinary(program, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+
+		// The driver is free to reject any binary, in which case the program must be compiled from source
+		GLint linkStatus = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+		if (linkStatus == GL_FALSE)
+		{
+			m_missCount++;
+			return false;
+		}
+
+		m_hitCount++;
+		return true;
+	}
+
+	void ShaderProgramCache::saveProgram(unsigned int const& program, std::string const& programName, uint64_t const& key)
+	{
+		if (!isSupported())
+		{
+			return;
+		}
+
+		GLint binaryLength = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+		if (binaryLength <= 0)
+		{
+			return;
+		}
+
+		std::vector<char> binary(binaryLength);
+		GLenum binaryFormat = 0;
+		glGetProgramBinary(program, binaryLength, nullptr, &binaryFormat, binary.data());
+
+		boost::system::error_code error;
+		boost::filesystem::create_directories(m_cacheDirectory, error);
+
+		std::ofstream file(getCacheFilePath(programName), std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			std::cout << "Unable to write shader program cache for: " << programName << "\n";
+			return;
+		}
+
+		ProgramBinaryHeader header;
+		memcpy(header.magic, CACHE_FILE_MAGIC, sizeof(CACHE_FILE_MAGIC));
+		header.version = CACHE_FILE_VERSION;
+		header.key = key;
+		header.binaryFormat = binaryFormat;
+		header.binaryLength = static_cast<uint32_t>(binaryLength);
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(binary.data(), binaryLength);
+	}
+
+	void ShaderProgramCache::printStatistics() const
+	{
+		printf("Loaded %d shader programs in %.2fms (%d restored from the program cache, %d compiled from source)\n",
+			m_programCount,
+			m_totalLoadTime,
+			m_hitCount,
+			m_programCount - m_hitCount);
+	}
+
+	bool ShaderProgramCache::isSupported()
+	{
+		if (m_cacheDirectory.empty())
+		{
+			return false;
+		}
+
+		// Some drivers expose the entry points without supporting a single binary format
+		if (m_supported < 0)
+		{
+			GLint formatCount = 0;
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+			m_supported = formatCount > 0 ? 1 : 0;
+		}
+
+		return m_supported == 1;
+	}
+
+	std::string ShaderProgramCache::getCacheFilePath(std::string const& programName) const
+	{
+		// Name the file after the shader so a changed shader overwrites its stale binary
+		uint64_t pathHash = hashString(HASH_SEED, programName);
+		char fileName[32];
+		snprintf(fileName, sizeof(fileName), "%016llx.bin", (unsigned long long)pathHash);
+		return (boost::filesystem::path(m_cacheDirectory) / fileName).string();
+	}
+
+}
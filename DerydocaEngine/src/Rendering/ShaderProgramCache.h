@@ -0,0 +1,105 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace DerydocaEngine::Rendering
+{
+
+	/*
+	Stores linked shader programs on disk as driver specific binaries so they can be
+	restored with glProgramBinary instead of being compiled from source every launch.
+	*/
+	class ShaderProgramCache
+	{
+	public:
+		static ShaderProgramCache& getInstance()
+		{
+			static ShaderProgramCache instance;
+			return instance;
+		}
+
+		/*
+		Sets the directory the program binaries are stored in. The cache is disabled when the
+		directory is empty.
+
+		@param directory Directory to store program binaries in
+		*/
+		void setCacheDirectory(std::string const& directory) { m_cacheDirectory = directory; }
+		std::string getCacheDirectory() const { return m_cacheDirectory; }
+
+		/*
+		Calculates the key a program binary is validated against. Any change to the stage sources,
+		transform feedback varyings or the graphics driver produces a different key.
+
+		@param sources Source of each shader stage, empty for stages that are not used
+		@param varyingsCount Number of transform feedback varyings
+		@param varyings Names of the transform feedback varyings
+
+		@return Key identifying the program's inputs
+		*/
+		uint64_t calculateProgramKey(std::array<std::string, 5> const& sources, int const& varyingsCount, const char *const * varyings);
+
+		/*
+		Prepares a program so the driver keeps a retrievable binary around after it is linked.
+
+		@param program Program that has not been linked yet
+		*/
+		void prepareProgram(unsigned int const& program);
+
+		/*
+		Attempts to restore a previously linked program from the cache.
+
+		@param program Program to load the binary into
+		@param programName Name identifying the program, unique per shader and set of varyings
+		@param key Key calculated from the program's inputs
+
+		@return True if the program was restored and linked successfully
+		*/
+		bool loadProgram(unsigned int const& program, std::string const& programName, uint64_t const& key);
+
+		/*
+		Writes the binary of a linked program to the cache.
+
+		@param program Program that was linked successfully
+		@param programName Name identifying the program, unique per shader and set of varyings
+		@param key Key calculated from the program's inputs
+		*/
+		void saveProgram(unsigned int const& program, std::string const& programName, uint64_t const& key);
+
+		/*
+		Records how long it took to create a shader program.
+
+		@param milliseconds Time spent creating the program
+		*/
+		void recordLoadTime(double const& milliseconds) { m_totalLoadTime += milliseconds; m_programCount++; }
+
+		int getHitCount() const { return m_hitCount; }
+		int getMissCount() const { return m_missCount; }
+		int getProgramCount() const { return m_programCount; }
+		double getTotalLoadTime() const { return m_totalLoadTime; }
+
+		/*
+		Prints how many programs were restored from the cache and how long all programs took to load.
+		*/
+		void printStatistics() const;
+
+		void operator=(ShaderProgramCache const&) = delete;
+	private:
+		ShaderProgramCache();
+		ShaderProgramCache(ShaderProgramCache const&);
+		~ShaderProgramCache();
+
+		bool isSupported();
+		std::string getCacheFilePath(std::string const& programName) const;
+
+		std::string m_cacheDirectory;
+		std::string m_driverIdentifier;
+		int m_supported;
+		int m_hitCount;
+		int m_missCount;
+		int m_programCount;
+		double m_totalLoadTime;
+	};
+
+}
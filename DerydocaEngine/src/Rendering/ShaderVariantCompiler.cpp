@@ -0,0 +1,74 @@
+#include "EnginePch.h"
+#include "Rendering\ShaderVariantCompiler.h"
+
+#include "Rendering\Shader.h"
+
+namespace DerydocaEngine::Rendering
+{
+
+	ShaderVariantCompiler::ShaderVariantCompiler() :
+		m_pendingVariants(),
+		m_maxProgramsPerUpdate(1)
+	{
+	}
+
+	ShaderVariantCompiler::~ShaderVariantCompiler()
+	{
+	}
+
+	void ShaderVariantCompiler::requestVariant(std::shared_ptr<Shader> const& baseShader, ShaderVariantKey const& variantKey)
+	{
+		PendingVariant pendingVariant;
+		pendingVariant.baseShader = baseShader;
+		pendingVariant.loadPath = baseShader->GetLoadPath();
+		pendingVariant.keywords = baseShader->getKeywords();
+		pendingVariant.varyings = baseShader->getVaryings();
+		pendingVariant.variantKey = variantKey;
+
+		// Reading the stage files and expanding them does not need a GL context
+		std::string loadPath = pendingVariant.loadPath;
+		std::vector<std::string> enabledKeywords = variantKey.getKeywords(pendingVariant.keywords);
+		pendingVariant.sources = std::async(std::launch::async, [loadPath, enabledKeywords]() {
+			std::vector<std::string> declaredKeywords;
+			return Shader::preprocessSources(loadPath, enabledKeywords, declaredKeywords);
+		});
+
+		m_pendingVariants.push_back(std::move(pendingVariant));
+	}
+
+	void ShaderVariantCompiler::update()
+	{
+		int programsBuilt = 0;
+		auto it = m_pendingVariants.begin();
+		while (it != m_pendingVariants.end() && programsBuilt < m_maxProgramsPerUpdate)
+		{
+			// Leave variants whose sources are still being preprocessed for a later frame
+			if (it->sources.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			{
+				++it;
+				continue;
+			}
+
+			auto sources = it->sources.get();
+			auto baseShader = it->baseShader.lock();
+			if (baseShader)
+			{
+				auto variant = std::make_shared<Shader>(it->loadPath, sources, it->keywords, it->variantKey, it->varyings);
+				if (variant->isLinked())
+				{
+					baseShader->addVariant(it->variantKey, variant);
+				}
+				else
+				{
+					// Keep rendering with the base shader rather than a broken program, or skip draws that need the variant
+					std::cerr << "Unable to build variant '" << it->variantKey.getName(it->keywords) << "' of shader: " << it->loadPath << "\n";
+					baseShader->addVariant(it->variantKey, nullptr);
+				}
+				programsBuilt++;
+			}
+
+			it = m_pendingVariants.erase(it);
+		}
+	}
+
+}
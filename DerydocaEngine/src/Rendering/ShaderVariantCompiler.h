@@ -0,0 +1,74 @@
+#pragma once
+#include <array>
+#include <future>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Rendering\ShaderVariantKey.h"
+
+namespace DerydocaEngine::Rendering
+{
+	class Shader;
+}
+
+namespace DerydocaEngine::Rendering
+{
+
+	/*
+	Builds shader variants without stalling the frame that requested them. Reading and
+	preprocessing the stage sources happens on a worker thread, while creating the GL program
+	is spread over frames on the render thread since that is the only thread with a GL context.
+	*/
+	class ShaderVariantCompiler
+	{
+	public:
+		static ShaderVariantCompiler& getInstance()
+		{
+			static ShaderVariantCompiler instance;
+			return instance;
+		}
+
+		/*
+		Queues a variant of a shader to be built.
+
+		@param baseShader Shader the variant is built from
+		@param variantKey Key of the variant to build
+		*/
+		void requestVariant(std::shared_ptr<Shader> const& baseShader, ShaderVariantKey const& variantKey);
+
+		/*
+		Builds the GL programs of variants whose sources are ready. Must be called on the render thread.
+		*/
+		void update();
+
+		/*
+		Sets how many programs may be built during a single call to update.
+
+		@param maxProgramsPerUpdate Maximum number of programs to build per update
+		*/
+		void setMaxProgramsPerUpdate(int const& maxProgramsPerUpdate) { m_maxProgramsPerUpdate = maxProgramsPerUpdate; }
+
+		size_t getPendingCount() const { return m_pendingVariants.size(); }
+
+		void operator=(ShaderVariantCompiler const&) = delete;
+	private:
+		struct PendingVariant
+		{
+			std::weak_ptr<Shader> baseShader;
+			std::string loadPath;
+			std::vector<std::string> keywords;
+			std::vector<std::string> varyings;
+			ShaderVariantKey variantKey;
+			std::future<std::array<std::string, 5>> sources;
+		};
+
+		ShaderVariantCompiler();
+		ShaderVariantCompiler(ShaderVariantCompiler const&);
+		~ShaderVariantCompiler();
+
+		std::list<PendingVariant> m_pendingVariants;
+		int m_maxProgramsPerUpdate;
+	};
+
+}
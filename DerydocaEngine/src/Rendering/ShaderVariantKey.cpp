@@ -0,0 +1,49 @@
+#include "EnginePch.h"
+#include "Rendering\ShaderVariantKey.h"
+
+namespace DerydocaEngine::Rendering
+{
+
+	ShaderVariantKey ShaderVariantKey::fromKeywords(std::vector<std::string> const& declaredKeywords, std::vector<std::string> const& enabledKeywords)
+	{
+		uint32_t mask = 0;
+		size_t keywordCount = std::min(declaredKeywords.size(), MAX_KEYWORDS);
+		for (size_t i = 0; i < keywordCount; i++)
+		{
+			if (std::find(enabledKeywords.begin(), enabledKeywords.end(), declaredKeywords[i]) != enabledKeywords.end())
+			{
+				mask |= (1u << i);
+			}
+		}
+		return ShaderVariantKey(mask);
+	}
+
+	std::vector<std::string> ShaderVariantKey::getKeywords(std::vector<std::string> const& declaredKeywords) const
+	{
+		std::vector<std::string> keywords;
+		size_t keywordCount = std::min(declaredKeywords.size(), MAX_KEYWORDS);
+		for (size_t i = 0; i < keywordCount; i++)
+		{
+			if (m_mask & (1u << i))
+			{
+				keywords.push_back(declaredKeywords[i]);
+			}
+		}
+		return keywords;
+	}
+
+	std::string ShaderVariantKey::getName(std::vector<std::string> const& declaredKeywords) const
+	{
+		std::string name;
+		for (auto const& keyword : getKeywords(declaredKeywords))
+		{
+			if (!name.empty())
+			{
+				name += "|";
+			}
+			name += keyword;
+		}
+		return name;
+	}
+
+}
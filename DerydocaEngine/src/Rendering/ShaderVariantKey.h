@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace DerydocaEngine::Rendering
+{
+
+	/*
+	Identifies a single permutation of a shader. Each bit corresponds to one of the keywords the
+	shader declares, in the order they were declared.
+	*/
+	class ShaderVariantKey
+	{
+	public:
+		/* Maximum number of keywords a single shader can declare */
+		static constexpr size_t MAX_KEYWORDS = 32;
+
+		ShaderVariantKey() :
+			m_mask(0)
+		{
+		}
+
+		explicit ShaderVariantKey(uint32_t const& mask) :
+			m_mask(mask)
+		{
+		}
+
+		/*
+		Builds the key of a variant from a set of enabled keywords. Keywords the shader does not
+		declare are ignored so they all map to the same variant.
+
+		@param declaredKeywords Keywords declared by the shader
+		@param enabledKeywords Keywords that should be enabled
+
+		@return Key of the variant
+		*/
+		static ShaderVariantKey fromKeywords(std::vector<std::string> const& declaredKeywords, std::vector<std::string> const& enabledKeywords);
+
+		/*
+		Gets the keywords that are enabled for this variant.
+
+		@param declaredKeywords Keywords declared by the shader
+		@return Enabled keywords, in declaration order
+		*/
+		std::vector<std::string> getKeywords(std::vector<std::string> const& declaredKeywords) const;
+
+		/*
+		Gets a readable name of the variant, such as "SHADOWS|SKINNED".
+
+		@param declaredKeywords Keywords declared by the shader
+		@return Name of the variant, empty for the default variant
+		*/
+		std::string getName(std::vector<std::string> const& declaredKeywords) const;
+
+		uint32_t getMask() const { return m_mask; }
+		bool isDefault() const { return m_mask == 0; }
+
+		bool operator==(ShaderVariantKey const& other) const { return m_mask == other.m_mask; }
+		bool operator!=(ShaderVariantKey const& other) const { return m_mask != other.m_mask; }
+		bool operator<(ShaderVariantKey const& other) const { return m_mask < other.m_mask; }
+	private:
+		uint32_t m_mask;
+	};
+
+}
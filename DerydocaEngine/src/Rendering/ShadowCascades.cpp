@@ -0,0 +1,149 @@
+#include "EnginePch.h"
+#include "Rendering\ShadowCascades.h"
+
+#include <glm/gtc/constants.hpp>
+
+namespace DerydocaEngine::Rendering::ShadowCascades
+{
+
+	std::vector<float> calculateSplitDepths(
+		float const zNear,
+		float const zFar,
+		int const cascadeCount,
+		SplitScheme const scheme,
+		float const lambda)
+	{
+		int count = glm::clamp(cascadeCount, 1, MAX_CASCADES);
+		std::vector<float> splits;
+		splits.reserve(count);
+
+		for (int i = 1; i <= count; i++)
+		{
+			float p = (float)i / (float)count;
+			float uniformSplit = zNear + (zFar - zNear) * p;
+			float logSplit = zNear * powf(zFar / zNear, p);
+
+			switch (scheme)
+			{
+			case SplitScheme::Uniform:
+				splits.push_back(uniformSplit);
+				break;
+			case SplitScheme::Logarithmic:
+				splits.push_back(logSplit);
+				break;
+			case SplitScheme::Practical:
+			default:
+				splits.push_back(glm::mix(uniformSplit, logSplit, glm::clamp(lambda, 0.0f, 1.0f)));
+				break;
+			}
+		}
+
+		// Make sure floating point error never leaves a gap at the end of the shadow distance
+		splits[count - 1] = zFar;
+
+		return splits;
+	}
+
+	std::array<glm::vec3, 8> calculateFrustumSliceCorners(
+		glm::mat4 const& cameraModel,
+		float const fov,
+		float const aspect,
+		float const sliceNear,
+		float const sliceFar)
+	{
+		float tanHalfFov = tanf(fov * (glm::pi<float>() / 180) * 0.5f);
+		std::array<glm::vec3, 8> corners;
+
+		float distances[] = { sliceNear, sliceFar };
+		for (int d = 0; d < 2; d++)
+		{
+			float halfHeight = distances[d] * tanHalfFov;
+			float halfWidth = halfHeight * aspect;
+			float z = -distances[d];
+
+			corners[d * 4 + 0] = glm::vec3(cameraModel * glm::vec4(-halfWidth, -halfHeight, z, 1.0f));
+			corners[d * 4 + 1] = glm::vec3(cameraModel * glm::vec4(halfWidth, -halfHeight, z, 1.0f));
+			corners[d * 4 + 2] = glm::vec3(cameraModel * glm::vec4(halfWidth, halfHeight, z, 1.0f));
+			corners[d * 4 + 3] = glm::vec3(cameraModel * glm::vec4(-halfWidth, halfHeight, z, 1.0f));
+		}
+
+		return corners;
+	}
+
+	Cascade fitCascade(
+		glm::mat4 const& lightView,
+		std::array<glm::vec3, 8> const& corners,
+		int const resolution,
+		float const casterDistance)
+	{
+		// Find the center of the slice
+		glm::vec3 center = glm::vec3(0.0f);
+		for (auto const& corner : corners)
+		{
+			center += corner;
+		}
+		center /= (float)corners.size();
+
+		// Enclose the slice in a sphere so the cascade size is independent of the camera's rotation
+		float radius = 0.0f;
+		for (auto const& corner : corners)
+		{
+			radius = glm::max(radius, glm::length(corner - center));
+		}
+
+		// Round the radius up so tiny precision changes do not resize the cascade every frame
+		radius = ceilf(radius * 16.0f) / 16.0f;
+
+		// Snap the center to the texel grid of the shadow map in light space
+		glm::vec3 lightSpaceCenter = glm::vec3(lightView * glm::vec4(center, 1.0f));
+		float texelSize = (radius * 2.0f) / (float)glm::max(resolution, 1);
+		lightSpaceCenter.x = floorf(lightSpaceCenter.x / texelSize) * texelSize;
+		lightSpaceCenter.y = floorf(lightSpaceCenter.y / texelSize) * texelSize;
+
+		Cascade cascade;
+		cascade.bounds = glm::vec4(
+			lightSpaceCenter.x - radius,
+			lightSpaceCenter.x + radius,
+			lightSpaceCenter.y - radius,
+			lightSpaceCenter.y + radius);
+
+		// The light looks down -Z, so pull the near plane back toward the light to catch casters outside of the slice
+		cascade.zNear = -(lightSpaceCenter.z + radius + casterDistance);
+		cascade.zFar = -(lightSpaceCenter.z - radius);
+		cascade.splitDepth = 0.0f;
+
+		return cascade;
+	}
+
+	glm::ivec2 getAtlasLayout(int const cascadeCount)
+	{
+		int columns = cascadeCount > 1 ? 2 : 1;
+		int rows = cascadeCount > 2 ? 2 : 1;
+		return glm::ivec2(columns, rows);
+	}
+
+	glm::ivec4 getAtlasViewport(int const cascadeIndex, int const cascadeCount, int const atlasWidth, int const atlasHeight)
+	{
+		glm::ivec2 layout = getAtlasLayout(cascadeCount);
+		int tileWidth = atlasWidth / layout.x;
+		int tileHeight = atlasHeight / layout.y;
+		int column = cascadeIndex % layout.x;
+		int row = cascadeIndex / layout.x;
+		return glm::ivec4(column * tileWidth, row * tileHeight, tileWidth, tileHeight);
+	}
+
+	glm::mat4 getAtlasBiasMatrix(int const cascadeIndex, int const cascadeCount)
+	{
+		glm::ivec2 layout = getAtlasLayout(cascadeCount);
+		float scaleX = 0.5f / (float)layout.x;
+		float scaleY = 0.5f / (float)layout.y;
+		float offsetX = ((float)(cascadeIndex % layout.x) + 0.5f) / (float)layout.x;
+		float offsetY = ((float)(cascadeIndex / layout.x) + 0.5f) / (float)layout.y;
+
+		return glm::mat4(glm::vec4(scaleX, 0.0f, 0.0f, 0.0f),
+			glm::vec4(0.0f, scaleY, 0.0f, 0.0f),
+			glm::vec4(0.0f, 0.0f, 0.5f, 0.0f),
+			glm::vec4(offsetX, offsetY, 0.5f, 1.0f));
+	}
+
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+namespace DerydocaEngine::Rendering::ShadowCascades
+{
+
+	/* Maximum number of cascades a single light can split its shadow map into */
+	const int MAX_CASCADES = 4;
+
+	/* Defines how the camera's view distance is divided between cascades */
+	enum SplitScheme
+	{
+		/* Splits are evenly spaced between the near and far plane */
+		Uniform = 0,
+		/* Splits grow logarithmically so each cascade has a similar texel density on screen */
+		Logarithmic = 1,
+		/* Blend between uniform and logarithmic splits, weighted by the split lambda */
+		Practical = 2
+	};
+
+	/* Resulting fit of a single cascade */
+	struct Cascade
+	{
+		/* Orthographic bounds of the cascade in light view space (left, right, bottom, top) */
+		glm::vec4 bounds;
+		/* Near plane distance along the light's view direction */
+		float zNear;
+		/* Far plane distance along the light's view direction */
+		float zFar;
+		/* Distance from the camera where this cascade ends */
+		float splitDepth;
+	};
+
+	/*
+	Calculates the view depth at which each cascade ends.
+
+	@param zNear Near plane of the camera
+	@param zFar Distance at which shadows stop being rendered
+	@param cascadeCount Number of cascades to split the distance into
+	@param scheme Scheme used to place the splits
+	@param lambda Weight of the logarithmic splits when using the practical scheme
+
+	@return The far distance of each cascade, the last entry always being zFar
+	*/
+	std::vector<float> calculateSplitDepths(
+		float const zNear,
+		float const zFar,
+		int const cascadeCount,
+		SplitScheme const scheme,
+		float const lambda);
+
+	/*
+	Calculates the 8 world space corners of a slice of a perspective camera frustum.
+
+	@param cameraModel Model matrix of the camera's transform
+	@param fov Vertical field of view of the camera, in degrees
+	@param aspect Aspect ratio of the camera
+	@param sliceNear Near distance of the slice
+	@param sliceFar Far distance of the slice
+
+	@return Corners of the slice, near plane first
+	*/
+	std::array<glm::vec3, 8> calculateFrustumSliceCorners(
+		glm::mat4 const& cameraModel,
+		float const fov,
+		float const aspect,
+		float const sliceNear,
+		float const sliceFar);
+
+	/*
+	Fits an orthographic cascade tightly around a frustum slice. The slice is enclosed
+	in a bounding sphere so the cascade size does not change as the camera rotates, and
+	the center is snapped to the shadow map's texel grid to keep shadow edges from
+	shimmering as the camera moves.
+
+	@param lightView View matrix of the light
+	@param corners World space corners of the frustum slice
+	@param resolution Resolution of the cascade's shadow map tile, in texels
+	@param casterDistance Extra distance toward the light to include shadow casters outside of the slice
+
+	@return The fitted cascade
+	*/
+	Cascade fitCascade(
+		glm::mat4 const& lightView,
+		std::array<glm::vec3, 8> const& corners,
+		int const resolution,
+		float const casterDistance);
+
+	/*
+	Gets the number of tile columns and rows used to pack cascades into a single atlas.
+
+	@param cascadeCount Number of cascades in the atlas
+	@return Column and row counts of the atlas
+	*/
+	glm::ivec2 getAtlasLayout(int const cascadeCount);
+
+	/*
+	Gets the tile a cascade is drawn to within the atlas.
+
+	@param cascadeIndex Index of the cascade
+	@param cascadeCount Number of cascades in the atlas
+	@param atlasWidth Width of the atlas in texels
+	@param atlasHeight Height of the atlas in texels
+
+	@return Viewport of the tile (x, y, width, height)
+	*/
+	glm::ivec4 getAtlasViewport(int const cascadeIndex, int const cascadeCount, int const atlasWidth, int const atlasHeight);
+
+	/*
+	Gets a matrix that transforms clip space coordinates of a cascade into texture
+	coordinates of its tile within the atlas.
+
+	@param cascadeIndex Index of the cascade
+	@param cascadeCount Number of cascades in the atlas
+
+	@return Bias matrix for the cascade
+	*/
+	glm::mat4 getAtlasBiasMatrix(int const cascadeIndex, int const cascadeCount);
+
+}
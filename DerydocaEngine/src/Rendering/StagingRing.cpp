@@ -0,0 +1,168 @@
+#include "EnginePch.h"
+#include "Rendering\StagingRing.h"
+
+#include <algorithm>
+
+namespace DerydocaEngine::Rendering
+{
+
+	// Keeps every allocation aligned for any pixel format and for fast copies into it
+	static const size_t ALLOCATION_ALIGNMENT = 16;
+
+	// Waits are checked this often so a lost context can not hang the render thread forever
+	static const GLuint64 FENCE_TIMEOUT_NANOSECONDS = 100000000;
+
+	StagingRing::StagingRing() :
+		m_bufferId(0),
+		m_persistentData(nullptr),
+		m_regionSize(0),
+		m_fences(),
+		m_region(0),
+		m_regionOffset(0),
+		m_mapped(false)
+	{
+	}
+
+	StagingRing::~StagingRing()
+	{
+		destroy();
+	}
+
+	bool StagingRing::create(size_t const& regionSize, int const& regionCount)
+	{
+		destroy();
+		if (regionSize == 0 || regionCount <= 0)
+		{
+			return false;
+		}
+
+		m_regionSize = (regionSize + ALLOCATION_ALIGNMENT - 1) / ALLOCATION_ALIGNMENT * ALLOCATION_ALIGNMENT;
+		m_fences.assign(regionCount, nullptr);
+		m_region = regionCount - 1;
+		m_regionOffset = m_regionSize;
+
+		GLsizeiptr bufferSize = static_cast<GLsizeiptr>(m_regionSize * regionCount);
+		glGenBuffers(1, &m_bufferId);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_bufferId);
+		if (GLEW_ARB_buffer_storage)
+		{
+			// Coherent mapping means writes reach the GPU without flushing, the fences do the rest
+			GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			glBufferStorage(GL_PIXEL_UNPACK_BUFFER, bufferSize, nullptr, flags);
+			m_persistentData = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bufferSize, flags));
+		}
+		else
+		{
+			glBufferData(GL_PIXEL_UNPACK_BUFFER, bufferSize, nullptr, GL_STREAM_DRAW);
+		}
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		if (GLEW_ARB_buffer_storage && m_persistentData == nullptr)
+		{
+			destroy();
+			return false;
+		}
+		return true;
+	}
+
+	void StagingRing::destroy()
+	{
+		if (!m_bufferId)
+		{
+			return;
+		}
+
+		for (int region = 0; region < static_cast<int>(m_fences.size()); region++)
+		{
+			waitForRegion(region);
+		}
+
+		if (m_persistentData != nullptr || m_mapped)
+		{
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_bufferId);
+			glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		}
+		glDeleteBuffers(1, &m_bufferId);
+
+		m_bufferId = 0;
+		m_persistentData = nullptr;
+		m_fences.clear();
+		m_mapped = false;
+	}
+
+	double StagingRing::beginFrame()
+	{
+		if (!m_bufferId)
+		{
+			return 0.0;
+		}
+
+		m_region = (m_region + 1) % static_cast<int>(m_fences.size());
+		m_regionOffset = 0;
+		return waitForRegion(m_region);
+	}
+
+	uint8_t* StagingRing::map(size_t const& size, size_t& offset)
+	{
+		if (!m_bufferId || m_mapped || size > m_regionSize - m_regionOffset)
+		{
+			return nullptr;
+		}
+
+		offset = m_region * m_regionSize + m_regionOffset;
+		m_regionOffset = std::min(m_regionOffset + (size + ALLOCATION_ALIGNMENT - 1) / ALLOCATION_ALIGNMENT * ALLOCATION_ALIGNMENT, m_regionSize);
+
+		if (m_persistentData != nullptr)
+		{
+			return m_persistentData + offset;
+		}
+
+		// The region was fenced before it was handed out, so the driver does not have to wait either
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+		uint8_t* data = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), flags));
+		m_mapped = data != nullptr;
+		return data;
+	}
+
+	void StagingRing::unmap()
+	{
+		if (m_mapped)
+		{
+			glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+			m_mapped = false;
+		}
+	}
+
+	void StagingRing::endFrame()
+	{
+		if (!m_bufferId || m_regionOffset == 0)
+		{
+			return;
+		}
+
+		m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	double StagingRing::waitForRegion(int const& region)
+	{
+		GLsync fence = static_cast<GLsync>(m_fences[region]);
+		if (fence == nullptr)
+		{
+			return 0.0;
+		}
+
+		auto waitStartTime = std::chrono::high_resolution_clock::now();
+		GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+		while (result == GL_TIMEOUT_EXPIRED)
+		{
+			result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT_NANOSECONDS);
+		}
+		glDeleteSync(fence);
+		m_fences[region] = nullptr;
+
+		std::chrono::duration<double, std::milli> waitTime = std::chrono::high_resolution_clock::now() - waitStartTime;
+		return waitTime.count();
+	}
+
+}
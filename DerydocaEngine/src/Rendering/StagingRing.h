@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace DerydocaEngine::Rendering
+{
+
+	/*
+	Pixel buffer that data is written into on the CPU and read from by the GPU, split into one
+	region per frame in flight. Each frame writes into the next region, after waiting on a fence
+	for the GPU to finish reading what was written there the last time around. Where buffer storage
+	is supported the buffer stays mapped for its whole life, otherwise each allocation is mapped
+	without synchronization, which the fences make safe.
+	*/
+	class StagingRing
+	{
+	public:
+		StagingRing();
+		~StagingRing();
+
+		/*
+		Creates the buffer, releasing any buffer that was previously created. Must be called on
+		the render thread.
+
+		@param regionSize Bytes that can be written each frame
+		@param regionCount Number of frames the GPU may fall behind before writing has to wait
+		@return True if the buffer could be created and mapped
+		*/
+		bool create(size_t const& regionSize, int const& regionCount);
+
+		/* Waits for the GPU to finish with every region and releases the buffer */
+		void destroy();
+
+		/*
+		Moves on to the next region, waiting for the GPU to finish reading from it.
+
+		@return Milliseconds spent waiting
+		*/
+		double beginFrame();
+
+		/*
+		Reserves space in the current region. The buffer must be bound as the pixel unpack buffer,
+		and the space released with unmap before the GPU reads from it.
+
+		@param size Number of bytes to reserve
+		@param offset Receives the offset of the space from the start of the buffer
+		@return Memory to write to, or null if the region has no space left
+		*/
+		uint8_t* map(size_t const& size, size_t& offset);
+
+		/* Makes the last reserved space visible to the GPU */
+		void unmap();
+
+		/* Fences what was written this frame, so the region is not written again before it is read */
+		void endFrame();
+
+		bool isCreated() const { return m_bufferId != 0; }
+		bool isPersistent() const { return m_persistentData != nullptr; }
+		unsigned int getBufferId() const { return m_bufferId; }
+		size_t getRegionSize() const { return m_regionSize; }
+
+		void operator=(StagingRing const&) = delete;
+	private:
+		StagingRing(StagingRing const&);
+
+		double waitForRegion(int const& region);
+
+		unsigned int m_bufferId;
+		uint8_t* m_persistentData;
+		size_t m_regionSize;
+		std::vector<void*> m_fences;
+		int m_region;
+		size_t m_regionOffset;
+		bool m_mapped;
+	};
+
+}
@@ -2,16 +2,72 @@
 #include "Rendering\Texture.h"
 
 #include <cassert>
+#include "Rendering\CubemapImage.h"
+#include "Rendering\MipGenerator.h"
+#include "Rendering\TextureCompression.h"
+#include "Rendering\TextureImage.h"
 #include "Rendering\TextureParameters.h"
+#include "Rendering\TextureUploader.h"
+#include "Rendering\TextureUploads.h"
+#include "Resources\TextureStreamer.h"
 
 namespace DerydocaEngine::Rendering
 {
 
+	// Estimates the size of a level from its 8 bit channels, though drivers may pad RGB to four channels
+	static size_t getLevelSize(int const& width, int const& height, int const& channels)
+	{
+		return static_cast<size_t>(width) * height * channels;
+	}
+
+	// Immutable storage needs a sized format, where mutable textures take the pixel format
+	// Atlases are compared in tiles of this size, about the size of a glyph or a small sprite
+	static const int DIRTY_TILE_SIZE = 32;
+
+	static GLenum channelsToSizedFormat(int const& channels)
+	{
+		switch (channels)
+		{
+		case 1:
+			return GL_R8;
+		case 2:
+			return GL_RG8;
+		case 3:
+			return GL_RGB8;
+		default:
+			return GL_RGBA8;
+		}
+	}
+
+	static GLenum compressionFormatToOpenGL(TextureCompressionFormat const& format)
+	{
+		switch (format)
+		{
+		case TextureCompressionFormat::BC1:
+			return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+		case TextureCompressionFormat::BC3:
+			return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		case TextureCompressionFormat::BC4:
+			return GL_COMPRESSED_RED_RGTC1;
+		case TextureCompressionFormat::BC5:
+			return GL_COMPRESSED_RG_RGTC2;
+		case TextureCompressionFormat::BC7:
+			return GL_COMPRESSED_RGBA_BPTC_UNORM;
+		default:
+			return 0;
+		}
+	}
+
 	Texture::Texture() :
 		m_rendererId(0),
 		m_width(0),
 		m_height(0),
-		m_textureType(0)
+		m_textureType(0),
+		m_gpuMemoryUsage(0),
+		m_compressionFormat(TextureCompressionFormat::None),
+		m_levelCount(1),
+		m_residentLevel(0),
+		m_streamingId(0)
 	{
 		m_textureType = GL_TEXTURE_2D;
 	}
@@ -20,22 +76,24 @@ namespace DerydocaEngine::Rendering
 		m_rendererId(0),
 		m_width(0),
 		m_height(0),
-		m_textureType(0)
+		m_textureType(0),
+		m_gpuMemoryUsage(0),
+		m_compressionFormat(TextureCompressionFormat::None),
+		m_levelCount(1),
+		m_residentLevel(0),
+		m_streamingId(0)
 	{
 		// Load the image data
-		int w, h, bpp;
-		stbi_set_flip_vertically_on_load(true);
-		unsigned char* data = stbi_load(fileName.c_str(), &w, &h, &bpp, 0);
-		if (!data)
+		TextureImage image;
+		if (!image.load(fileName, true))
 		{
 			std::cout << "Unable to load image.\n";
 			return;
 		}
 
-		updateBuffer(data, w, h, bpp, params);
-
-		// Free up our memory
-		stbi_image_free(data);
+		std::vector<MipLevel> levels;
+		MipGenerator::generate(image.getData(), image.getWidth(), image.getHeight(), image.getChannels(), MipSettings(), levels);
+		updateMipmappedBuffer(levels, image.getChannels(), params);
 	}
 
 	Texture::Texture(
@@ -49,44 +107,20 @@ namespace DerydocaEngine::Rendering
 		m_rendererId(0),
 		m_width(0),
 		m_height(0),
-		m_textureType(GL_TEXTURE_CUBE_MAP)
+		m_textureType(GL_TEXTURE_CUBE_MAP),
+		m_gpuMemoryUsage(0),
+		m_compressionFormat(TextureCompressionFormat::None),
+		m_levelCount(1),
+		m_residentLevel(0),
+		m_streamingId(0)
 	{
-		// Create the texture handle and set parameters for it
-		glGenTextures(1, &m_rendererId);
-		glBindTexture(m_textureType, m_rendererId);
-
-		// Store the list of sides in a string array so we can easily iterate over them
-		std::string cubemapSourceImages[] = { xpos, xneg, ypos, yneg, zpos, zneg };
-
-		// Loop through each side of the cubemap
-		int w, h, bpp;
-		for (unsigned int i = 0; i < 6; i++)
+		CubemapImage image;
+		if (!image.load({ xpos, xneg, ypos, yneg, zpos, zneg }, MipSettings()))
 		{
-			// Load the data
-			stbi_set_flip_vertically_on_load(false);
-			unsigned char* data = stbi_load(cubemapSourceImages[i].c_str(), &w, &h, &bpp, 0);
-
-			// If the data was loaded
-			if (data)
-			{
-				// Load the image in OpenGL and generate mipmaps
-				glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, w, h, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-				glGenerateMipmap(GL_TEXTURE_2D);
-			}
-			else
-			{
-				std::cout << "Failed to load texture for cubemap\n";
-			}
-			// Free up our memory
-			stbi_image_free(data);
-
-			// Set our parameters
-			glTexParameteri(m_textureType, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-			glTexParameteri(m_textureType, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-			glTexParameteri(m_textureType, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-			glTexParameteri(m_textureType, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-			glTexParameteri(m_textureType, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			return;
 		}
+
+		updateCubemapBuffer(image);
 	}
 
 	Texture::~Texture()
@@ -94,6 +128,29 @@ namespace DerydocaEngine::Rendering
 		deleteTexture();
 	}
 
+	void Texture::swap(Texture& other)
+	{
+		std::swap(m_rendererId, other.m_rendererId);
+		std::swap(m_width, other.m_width);
+		std::swap(m_height, other.m_height);
+		std::swap(m_textureType, other.m_textureType);
+		std::swap(m_gpuMemoryUsage, other.m_gpuMemoryUsage);
+		std::swap(m_compressionFormat, other.m_compressionFormat);
+		std::swap(m_levelCount, other.m_levelCount);
+		std::swap(m_residentLevel, other.m_residentLevel);
+		std::swap(m_streamingId, other.m_streamingId);
+
+		// The streamer has to keep streaming levels into whichever texture now holds its GL texture
+		if (m_streamingId != 0)
+		{
+			Resources::TextureStreamer::getInstance().retarget(m_streamingId, weak_from_this());
+		}
+		if (other.m_streamingId != 0)
+		{
+			Resources::TextureStreamer::getInstance().retarget(other.m_streamingId, other.weak_from_this());
+		}
+	}
+
 	void Texture::bind(const unsigned int unit) const
 	{
 		glActiveTexture(GL_TEXTURE0 + unit);
@@ -125,24 +182,244 @@ namespace DerydocaEngine::Rendering
 
 		GLint pixelFormat = channelsToPixelFormat(channels);
 
-		if (pixelFormat == GL_RED)
+		// delete the old texture if there was one already loaded, along with any pixels still waiting for it
+		TextureUploader::getInstance().cancel(*this);
+		deleteTexture();
+		
+		// Create the texture handle and set parameters for it. Only the storage is allocated here, the
+		// pixels are copied in through the uploader's staging ring so a large image does not stall the frame.
+		glGenTextures(1, &m_rendererId);
+		glBindTexture(m_textureType, m_rendererId);
+		glTexImage2D(m_textureType, 0, pixelFormat, width, height, 0, pixelFormat, GL_UNSIGNED_BYTE, nullptr);
+		glTexParameteri(m_textureType, GL_TEXTURE_WRAP_S, TextureParameters::textureWrapModeToOpenGL(wrapModeS));
+		glTexParameteri(m_textureType, GL_TEXTURE_WRAP_T, TextureParameters::textureWrapModeToOpenGL(wrapModeT));
+		glTexParameteri(m_textureType, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(m_textureType, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		if (data != nullptr)
 		{
-			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			TextureUploads::UploadRect rect;
+			rect.width = width;
+			rect.height = height;
+			TextureUploader::getInstance().upload(*this, rect, data, width, channels, true);
+		}
+		else
+		{
+			glGenerateMipmap(m_textureType);
+		}
+
+		// The mipmap chain adds a third on top of the base level
+		m_gpuMemoryUsage = getLevelSize(width, height, channels) * 4 / 3;
+	}
+
+	void Texture::updateChangedRegions(const unsigned char* previousData, unsigned char* data, const int width, const int height, const int channels, const TextureParameters* params)
+	{
+		if (previousData == nullptr || data == nullptr || !m_rendererId || m_textureType != GL_TEXTURE_2D || width != m_width || height != m_height)
+		{
+			updateBuffer(data, width, height, channels, params);
+			return;
+		}
+
+		std::vector<TextureUploads::UploadRect> rects;
+		TextureUploads::findDirtyRects(previousData, data, width, height, channels, DIRTY_TILE_SIZE, rects);
+
+		// The mip chain only has to be built again once, after the last region is in
+		for (size_t i = 0; i < rects.size(); i++)
+		{
+			TextureUploader::getInstance().upload(*this, rects[i], data, width, channels, i + 1 == rects.size());
+		}
+	}
+
+	void Texture::updateMipmappedBuffer(std::vector<MipLevel> const& levels, const int channels, const TextureParameters* params)
+	{
+		if (levels.empty())
+		{
+			return;
+		}
+
+		m_width = levels[0].width;
+		m_height = levels[0].height;
+		m_textureType = GL_TEXTURE_2D;
+		m_compressionFormat = TextureCompressionFormat::None;
+		m_levelCount = static_cast<int>(levels.size());
+		m_residentLevel = 0;
+
+		TextureWrapMode wrapModeS = TextureWrapMode::REPEAT;
+		TextureWrapMode wrapModeT = TextureWrapMode::REPEAT;
+		if (params != nullptr)
+		{
+			wrapModeS = params->getWrapModeS();
+			wrapModeT = params->getWrapModeT();
 		}
 
-		// delete the old texture if there was one already loaded
 		deleteTexture();
-		
-		// Create the texture handle and set parameters for it
+
+		// Rows of the small levels are rarely a multiple of four bytes
+		GLint pixelFormat = channelsToPixelFormat(channels);
 		glGenTextures(1, &m_rendererId);
 		glBindTexture(m_textureType, m_rendererId);
-		glTexImage2D(m_textureType, 0, pixelFormat, width, height, 0, pixelFormat, GL_UNSIGNED_BYTE, data);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		m_gpuMemoryUsage = 0;
+		for (size_t i = 0; i < levels.size(); i++)
+		{
+			glTexImage2D(m_textureType, static_cast<GLint>(i), pixelFormat, levels[i].width, levels[i].height, 0, pixelFormat, GL_UNSIGNED_BYTE, levels[i].data.data());
+			m_gpuMemoryUsage += getLevelSize(levels[i].width, levels[i].height, channels);
+		}
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glTexParameteri(m_textureType, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levels.size() - 1));
 		glTexParameteri(m_textureType, GL_TEXTURE_WRAP_S, TextureParameters::textureWrapModeToOpenGL(wrapModeS));
 		glTexParameteri(m_textureType, GL_TEXTURE_WRAP_T, TextureParameters::textureWrapModeToOpenGL(wrapModeT));
-		glTexParameteri(m_textureType, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(m_textureType, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 		glTexParameteri(m_textureType, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	}
 
-		glGenerateMipmap(m_textureType);
+	void Texture::updateCompressedBuffer(CompressedTextureData const& texture, const TextureParameters* params, int const& firstLevel)
+	{
+		if (texture.levels.empty())
+		{
+			return;
+		}
+
+		m_width = texture.levels[0].width;
+		m_height = texture.levels[0].height;
+		m_textureType = GL_TEXTURE_2D;
+		m_compressionFormat = texture.format;
+		m_levelCount = static_cast<int>(texture.levels.size());
+		m_residentLevel = std::min(std::max(firstLevel, 0), m_levelCount - 1);
+
+		TextureWrapMode wrapModeS = TextureWrapMode::REPEAT;
+		TextureWrapMode wrapModeT = TextureWrapMode::REPEAT;
+		if (params != nullptr)
+		{
+			wrapModeS = params->getWrapModeS();
+			wrapModeT = params->getWrapModeT();
+		}
+
+		deleteTexture();
+
+		// The mip chain was built when the texture was cooked, so every level is uploaded as it is.
+		// Levels left out stay undefined, and the base level keeps the texture complete without them.
+		GLenum internalFormat = compressionFormatToOpenGL(texture.format);
+		glGenTextures(1, &m_rendererId);
+		glBindTexture(m_textureType, m_rendererId);
+		m_gpuMemoryUsage = 0;
+		for (int i = m_residentLevel; i < m_levelCount; i++)
+		{
+			CompressedTextureLevel const& level = texture.levels[i];
+			glCompressedTexImage2D(m_textureType, i, internalFormat, level.width, level.height, 0, static_cast<GLsizei>(level.size), level.data);
+			m_gpuMemoryUsage += level.size;
+		}
+		glTexParameteri(m_textureType, GL_TEXTURE_BASE_LEVEL, m_residentLevel);
+		glTexParameteri(m_textureType, GL_TEXTURE_MAX_LEVEL, m_levelCount - 1);
+		glTexParameteri(m_textureType, GL_TEXTURE_WRAP_S, TextureParameters::textureWrapModeToOpenGL(wrapModeS));
+		glTexParameteri(m_textureType, GL_TEXTURE_WRAP_T, TextureParameters::textureWrapModeToOpenGL(wrapModeT));
+		glTexParameteri(m_textureType, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(m_textureType, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	}
+
+	void Texture::updateCubemapBuffer(CubemapImage const& image)
+	{
+		if (!image.isLoaded())
+		{
+			return;
+		}
+
+		m_width = image.getSize();
+		m_height = image.getSize();
+		m_textureType = GL_TEXTURE_CUBE_MAP;
+		m_compressionFormat = TextureCompressionFormat::None;
+		m_levelCount = image.getLevelCount();
+		m_residentLevel = 0;
+
+		deleteTexture();
+
+		// Storage for every face and level is allocated at once, so the driver never has to check
+		// whether the faces match before the cubemap is complete
+		GLint pixelFormat = channelsToPixelFormat(image.getChannels());
+		glGenTextures(1, &m_rendererId);
+		glBindTexture(m_textureType, m_rendererId);
+		glTexStorage2D(m_textureType, m_levelCount, channelsToSizedFormat(image.getChannels()), m_width, m_height);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		m_gpuMemoryUsage = 0;
+		for (int face = 0; face < CubemapImage::FACE_COUNT; face++)
+		{
+			std::vector<MipLevel> const& levels = image.getFaceLevels(face);
+			for (int i = 0; i < m_levelCount; i++)
+			{
+				glTexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, i, 0, 0, levels[i].width, levels[i].height, pixelFormat, GL_UNSIGNED_BYTE, levels[i].data.data());
+				m_gpuMemoryUsage += getLevelSize(levels[i].width, levels[i].height, image.getChannels());
+			}
+		}
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		setCubemapParameters();
+	}
+
+	void Texture::updateCompressedCubemapBuffer(CompressedTextureData const& texture)
+	{
+		if (texture.faceCount != CubemapImage::FACE_COUNT || texture.levels.empty())
+		{
+			return;
+		}
+
+		m_width = texture.levels[0].width;
+		m_height = texture.levels[0].height;
+		m_textureType = GL_TEXTURE_CUBE_MAP;
+		m_compressionFormat = texture.format;
+		m_levelCount = static_cast<int>(texture.levels.size()) / texture.faceCount;
+		m_residentLevel = 0;
+
+		deleteTexture();
+
+		GLenum internalFormat = compressionFormatToOpenGL(texture.format);
+		glGenTextures(1, &m_rendererId);
+		glBindTexture(m_textureType, m_rendererId);
+		glTexStorage2D(m_textureType, m_levelCount, internalFormat, m_width, m_height);
+		m_gpuMemoryUsage = 0;
+		for (int face = 0; face < texture.faceCount; face++)
+		{
+			for (int i = 0; i < m_levelCount; i++)
+			{
+				CompressedTextureLevel const& level = texture.levels[face * m_levelCount + i];
+				glCompressedTexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, i, 0, 0, level.width, level.height, internalFormat, static_cast<GLsizei>(level.size), level.data);
+				m_gpuMemoryUsage += level.size;
+			}
+		}
+		setCubemapParameters();
+	}
+
+	void Texture::uploadCompressedLevel(int const& level, const uint8_t* data, size_t const& size)
+	{
+		if (!m_rendererId || m_compressionFormat == TextureCompressionFormat::None || level < 0 || level >= m_residentLevel)
+		{
+			return;
+		}
+
+		glBindTexture(m_textureType, m_rendererId);
+		glCompressedTexImage2D(m_textureType, level, compressionFormatToOpenGL(m_compressionFormat),
+			std::max(m_width >> level, 1), std::max(m_height >> level, 1), 0, static_cast<GLsizei>(size), data);
+		glTexParameteri(m_textureType, GL_TEXTURE_BASE_LEVEL, level);
+		m_gpuMemoryUsage += size;
+		m_residentLevel = level;
+	}
+
+	void Texture::dropLevels(int const& firstLevel)
+	{
+		if (!m_rendererId || m_compressionFormat == TextureCompressionFormat::None || firstLevel <= m_residentLevel || firstLevel >= m_levelCount)
+		{
+			return;
+		}
+
+		// Raise the base level first so the texture stays complete, then redefine the dropped levels
+		// as empty so the driver can release their storage
+		GLenum internalFormat = compressionFormatToOpenGL(m_compressionFormat);
+		glBindTexture(m_textureType, m_rendererId);
+		glTexParameteri(m_textureType, GL_TEXTURE_BASE_LEVEL, firstLevel);
+		for (int i = m_residentLevel; i < firstLevel; i++)
+		{
+			glCompressedTexImage2D(m_textureType, i, internalFormat, 0, 0, 0, 0, nullptr);
+			m_gpuMemoryUsage -= TextureCompression::getLevelSize(m_compressionFormat, std::max(m_width >> i, 1), std::max(m_height >> i, 1));
+		}
+		m_residentLevel = firstLevel;
 	}
 
 	unsigned int Texture::channelsToPixelFormat(const int numChannels) const
@@ -169,4 +446,17 @@ namespace DerydocaEngine::Rendering
 		}
 	}
 
+	void Texture::setCubemapParameters()
+	{
+		// The small levels are only a few texels wide, so without filtering across the edges of the
+		// faces the seams show. It is global state, so enabling it with every cubemap costs nothing.
+		glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+		glTexParameteri(m_textureType, GL_TEXTURE_MAX_LEVEL, m_levelCount - 1);
+		glTexParameteri(m_textureType, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(m_textureType, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(m_textureType, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+		glTexParameteri(m_textureType, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(m_textureType, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	}
+
 }
@@ -1,15 +1,22 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace DerydocaEngine::Rendering {
+	class CubemapImage;
+	struct CompressedTextureData;
+	struct MipLevel;
 	struct TextureParameters;
+	enum class TextureCompressionFormat;
 }
 
 namespace DerydocaEngine::Rendering
 {
 
-	class Texture
+	class Texture : public std::enable_shared_from_this<Texture>
 	{
 	public:
 		Texture();
@@ -29,6 +36,22 @@ namespace DerydocaEngine::Rendering
 		int getHeight() const { return m_height; }
 		unsigned int getTextureType() const { return m_textureType; }
 		unsigned int getRendererId() const { return m_rendererId; }
+
+		/* Gets the size of the texture's storage on the GPU, including its mipmaps */
+		size_t getGpuMemoryUsage() const { return m_gpuMemoryUsage; }
+
+		/*
+		Exchanges the GPU copy of the texture with another texture's, such as one that was just
+		reloaded from a changed file.
+
+		@param other Texture to exchange with
+		*/
+		void swap(Texture& other);
+
+		/*
+		Allocates the texture and queues its pixels to be uploaded over the next frames, within the
+		texture uploader's budget. The pixels are copied, so they can be released once this returns.
+		*/
 		void updateBuffer(
 			unsigned char * data,
 			const int width,
@@ -37,17 +60,95 @@ namespace DerydocaEngine::Rendering
 			const TextureParameters* params
 		);
 
+		/*
+		Uploads only the parts of an image that changed since it was last uploaded, such as an atlas
+		that gained a few glyphs. Falls back to uploading the whole image if its size changed.
+
+		@param previousData Pixels the texture was last given, or null if they are not known
+		@param data New pixels of the image
+		@param width Width of the image
+		@param height Height of the image
+		@param channels Number of 8 bit channels per pixel, which must match the previous pixels
+		@param params Wrap modes of the texture, used if the whole image has to be uploaded
+		*/
+		void updateChangedRegions(const unsigned char* previousData, unsigned char* data, const int width, const int height, const int channels, const TextureParameters* params);
+
+		/*
+		Uploads a texture together with a mip chain that was built on the CPU.
+
+		@param levels Every level of the texture, starting with the largest
+		@param channels Number of 8 bit channels per pixel
+		@param params Wrap modes of the texture, or null to repeat
+		*/
+		void updateMipmappedBuffer(std::vector<MipLevel> const& levels, const int channels, const TextureParameters* params);
+
+		/*
+		Uploads a block compressed texture and its mip chain as they are.
+
+		@param texture Compressed levels of the texture
+		@param params Wrap modes of the texture, or null to repeat
+		@param firstLevel Largest level to upload, larger levels are left out until they are streamed in
+		*/
+		void updateCompressedBuffer(CompressedTextureData const& texture, const TextureParameters* params, int const& firstLevel = 0);
+
+		/*
+		Uploads the faces of a cubemap and their mip chains into immutable storage.
+
+		@param image Decoded faces of the cubemap
+		*/
+		void updateCubemapBuffer(CubemapImage const& image);
+
+		/*
+		Uploads a block compressed cubemap and the mip chains of its faces into immutable storage.
+
+		@param texture Compressed levels of every face
+		*/
+		void updateCompressedCubemapBuffer(CompressedTextureData const& texture);
+
+		/*
+		Uploads the next larger level of a block compressed texture whose larger levels were left out.
+
+		@param level Level to upload, one larger than the largest resident level
+		@param data Compressed blocks of the level
+		@param size Size of the level in bytes
+		*/
+		void uploadCompressedLevel(int const& level, const uint8_t* data, size_t const& size);
+
+		/*
+		Releases the levels of a block compressed texture that are larger than a level.
+
+		@param firstLevel Largest level to keep
+		*/
+		void dropLevels(int const& firstLevel);
+
+		/* Gets the number of levels in the texture's full mip chain */
+		int getLevelCount() const { return m_levelCount; }
+
+		/* Gets the largest level that is uploaded, which is 0 unless the texture is streamed */
+		int getResidentLevel() const { return m_residentLevel; }
+
+		/* Gets the ID the texture streamer knows the texture by, or 0 if it is not streamed */
+		int getStreamingId() const { return m_streamingId; }
+		void setStreamingId(int const& streamingId) { m_streamingId = streamingId; }
+		bool isStreamed() const { return m_streamingId != 0; }
+
 		unsigned int channelsToPixelFormat(const int numChannels) const;
 	protected:
 		unsigned int m_rendererId;
 		int m_width;
 		int m_height;
 		unsigned int m_textureType;
+		size_t m_gpuMemoryUsage;
+		TextureCompressionFormat m_compressionFormat;
+		int m_levelCount;
+		int m_residentLevel;
+		int m_streamingId;
 	private:
 		Texture(Texture const& other) {}
 		void operator=(Texture const& other) {};
 
 		void deleteTexture();
+		void setCubemapParameters();
 	};
 
 }
@@ -0,0 +1,959 @@
+#include "EnginePch.h"
+#include "Rendering\TextureCompression.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <limits>
+#include "Helpers\ParallelFor.h"
+
+namespace DerydocaEngine::Rendering::TextureCompression
+{
+
+	static const int BLOCK_PIXELS = 16;
+
+	// Position along the line between the endpoints of each BC1 index, in 4 color mode
+	static const float BC1_WEIGHTS[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+	// Same as above for blocks in 3 color mode, where the last index is black
+	static const float BC1_THREE_COLOR_WEIGHTS[4] = { 0.0f, 1.0f, 0.5f, 0.0f };
+
+	// Interpolation weights of BC7's 4 bit indices, in 64ths
+	static const int BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	// Marks a BC7 block as mode 6, a single subset with 7 bit RGBA endpoints, a p-bit per endpoint and 4 bit indices
+	static const uint32_t BC7_MODE_6 = 1 << 6;
+
+	// Pixels of a single block, with the edges of the image repeated to fill partial blocks
+	struct Block
+	{
+		uint8_t pixels[BLOCK_PIXELS][4];
+	};
+
+	// Reads and writes bit fields from the least significant bit of a block's first byte upwards
+	struct BlockBits
+	{
+		uint8_t* data;
+		int position;
+
+		void write(uint32_t const& value, int const& bitCount)
+		{
+			for (int i = 0; i < bitCount; i++, position++)
+			{
+				data[position / 8] |= static_cast<uint8_t>(((value >> i) & 1) << (position % 8));
+			}
+		}
+
+		uint32_t read(int const& bitCount)
+		{
+			uint32_t value = 0;
+			for (int i = 0; i < bitCount; i++, position++)
+			{
+				value |= static_cast<uint32_t>((data[position / 8] >> (position % 8)) & 1) << i;
+			}
+			return value;
+		}
+	};
+
+	static int clampToByte(float const& value)
+	{
+		return std::min(std::max(static_cast<int>(std::lround(value)), 0), 255);
+	}
+
+	static void loadBlock(const uint8_t* rgba, int const& width, int const& height, int const& blockX, int const& blockY, Block& block)
+	{
+		for (int y = 0; y < 4; y++)
+		{
+			int sourceY = std::min(blockY * 4 + y, height - 1);
+			for (int x = 0; x < 4; x++)
+			{
+				int sourceX = std::min(blockX * 4 + x, width - 1);
+				memcpy(block.pixels[y * 4 + x], rgba + (static_cast<size_t>(sourceY) * width + sourceX) * 4, 4);
+			}
+		}
+	}
+
+	static void storeBlock(Block const& block, int const& width, int const& height, int const& blockX, int const& blockY, uint8_t* rgba)
+	{
+		for (int y = 0; y < 4 && blockY * 4 + y < height; y++)
+		{
+			for (int x = 0; x < 4 && blockX * 4 + x < width; x++)
+			{
+				memcpy(rgba + (static_cast<size_t>(blockY * 4 + y) * width + blockX * 4 + x) * 4, block.pixels[y * 4 + x], 4);
+			}
+		}
+	}
+
+	// Finds the line through a block's colors that its endpoints are picked from. Only the first
+	// channelCount channels are considered.
+	static void findEndpoints(Block const& block, int const& channelCount, TextureCompressionQuality const& quality, float endpoint0[4], float endpoint1[4])
+	{
+		float mean[4] = {};
+		float minimum[4] = { 255.0f, 255.0f, 255.0f, 255.0f };
+		float maximum[4] = {};
+		for (int i = 0; i < BLOCK_PIXELS; i++)
+		{
+			for (int c = 0; c < channelCount; c++)
+			{
+				float value = block.pixels[i][c];
+				mean[c] += value / BLOCK_PIXELS;
+				minimum[c] = std::min(minimum[c], value);
+				maximum[c] = std::max(maximum[c], value);
+			}
+		}
+
+		float covariance[4][4] = {};
+		for (int i = 0; i < BLOCK_PIXELS; i++)
+		{
+			for (int c = 0; c < channelCount; c++)
+			{
+				for (int d = 0; d < channelCount; d++)
+				{
+					covariance[c][d] += (block.pixels[i][c] - mean[c]) * (block.pixels[i][d] - mean[d]);
+				}
+			}
+		}
+
+		// Start along the diagonal of the bounding box that follows the colors, flipping every
+		// channel that falls as the widest one rises
+		float axis[4] = {};
+		int widest = 0;
+		for (int c = 0; c < channelCount; c++)
+		{
+			axis[c] = maximum[c] - minimum[c];
+			widest = axis[c] > axis[widest] ? c : widest;
+		}
+		for (int c = 0; c < channelCount; c++)
+		{
+			if (covariance[widest][c] < 0.0f)
+			{
+				axis[c] = -axis[c];
+			}
+		}
+
+		// Converge on the principal axis of the colors
+		int iterations = quality == TextureCompressionQuality::Fast ? 0 : 8;
+		for (int iteration = 0; iteration < iterations; iteration++)
+		{
+			float next[4] = {};
+			float length = 0.0f;
+			for (int c = 0; c < channelCount; c++)
+			{
+				for (int d = 0; d < channelCount; d++)
+				{
+					next[c] += covariance[c][d] * axis[d];
+				}
+				length = std::max(length, std::abs(next[c]));
+			}
+			if (length <= 0.0f)
+			{
+				break;
+			}
+			for (int c = 0; c < channelCount; c++)
+			{
+				axis[c] = next[c] / length;
+			}
+		}
+
+		float length = 0.0f;
+		for (int c = 0; c < channelCount; c++)
+		{
+			length += axis[c] * axis[c];
+		}
+		length = std::sqrt(length);
+
+		// Every pixel is the same color
+		if (length <= 0.0f)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				endpoint0[c] = mean[c];
+				endpoint1[c] = mean[c];
+			}
+			return;
+		}
+
+		float minimumProjection = std::numeric_limits<float>::max();
+		float maximumProjection = -std::numeric_limits<float>::max();
+		for (int i = 0; i < BLOCK_PIXELS; i++)
+		{
+			float projection = 0.0f;
+			for (int c = 0; c < channelCount; c++)
+			{
+				projection += (block.pixels[i][c] - mean[c]) * axis[c] / length;
+			}
+			minimumProjection = std::min(minimumProjection, projection);
+			maximumProjection = std::max(maximumProjection, projection);
+		}
+
+		for (int c = 0; c < 4; c++)
+		{
+			endpoint0[c] = std::min(std::max(mean[c] + axis[c] / length * minimumProjection, 0.0f), 255.0f);
+			endpoint1[c] = std::min(std::max(mean[c] + axis[c] / length * maximumProjection, 0.0f), 255.0f);
+		}
+	}
+
+	// Fits the endpoints that best reproduce a block for the weights its pixels were given, where a
+	// weight of 0 is the first endpoint and 1 the second
+	static bool refineEndpoints(Block const& block, int const& channelCount, float const weights[BLOCK_PIXELS], float endpoint0[4], float endpoint1[4])
+	{
+		double a = 0.0;
+		double b = 0.0;
+		double c = 0.0;
+		double sum0[4] = {};
+		double sum1[4] = {};
+		for (int i = 0; i < BLOCK_PIXELS; i++)
+		{
+			double weight = weights[i];
+			a += (1.0 - weight) * (1.0 - weight);
+			b += (1.0 - weight) * weight;
+			c += weight * weight;
+			for (int channel = 0; channel < channelCount; channel++)
+			{
+				sum0[channel] += (1.0 - weight) * block.pixels[i][channel];
+				sum1[channel] += weight * block.pixels[i][channel];
+			}
+		}
+
+		double determinant = a * c - b * b;
+		if (std::abs(determinant) < 1e-6)
+		{
+			return false;
+		}
+
+		for (int channel = 0; channel < channelCount; channel++)
+		{
+			endpoint0[channel] = static_cast<float>(std::min(std::max((c * sum0[channel] - b * sum1[channel]) / determinant, 0.0), 255.0));
+			endpoint1[channel] = static_cast<float>(std::min(std::max((a * sum1[channel] - b * sum0[channel]) / determinant, 0.0), 255.0));
+		}
+		return true;
+	}
+
+	// Picks the closest palette entry for every pixel and returns the squared error of the block
+	static int chooseIndices(Block const& block, int const palette[][4], int const& paletteSize, int const& channelCount, uint8_t indices[BLOCK_PIXELS])
+	{
+		int totalError = 0;
+		for (int i = 0; i < BLOCK_PIXELS; i++)
+		{
+			int bestError = INT_MAX;
+			for (int entry = 0; entry < paletteSize; entry++)
+			{
+				int error = 0;
+				for (int c = 0; c < channelCount; c++)
+				{
+					int difference = block.pixels[i][c] - palette[entry][c];
+					error += difference * difference;
+				}
+				if (error < bestError)
+				{
+					bestError = error;
+					indices[i] = static_cast<uint8_t>(entry);
+				}
+			}
+			totalError += bestError;
+		}
+		return totalError;
+	}
+
+	static uint16_t packRgb565(float const color[4])
+	{
+		int r = std::min(std::max(static_cast<int>(std::lround(color[0] * 31.0f / 255.0f)), 0), 31);
+		int g = std::min(std::max(static_cast<int>(std::lround(color[1] * 63.0f / 255.0f)), 0), 63);
+		int b = std::min(std::max(static_cast<int>(std::lround(color[2] * 31.0f / 255.0f)), 0), 31);
+		return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+	}
+
+	static void unpackRgb565(uint16_t const& packed, int color[4])
+	{
+		int r = (packed >> 11) & 31;
+		int g = (packed >> 5) & 63;
+		int b = packed & 31;
+		color[0] = (r << 3) | (r >> 2);
+		color[1] = (g << 2) | (g >> 4);
+		color[2] = (b << 3) | (b >> 2);
+		color[3] = 255;
+	}
+
+	// Builds the palette of a BC1 color block. BC3 color blocks always use 4 colors, BC1 blocks
+	// switch to 3 colors and transparent black when the first endpoint is not the larger one.
+	static int getBc1Palette(uint16_t const& color0, uint16_t const& color1, bool const& alwaysFourColors, int palette[4][4])
+	{
+		unpackRgb565(color0, palette[0]);
+		unpackRgb565(color1, palette[1]);
+		if (color0 > color1 || alwaysFourColors)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+			}
+			return 4;
+		}
+
+		for (int c = 0; c < 4; c++)
+		{
+			palette[2][c] = (palette[0][c] + palette[1][c] + 1) / 2;
+			palette[3][c] = 0;
+		}
+		return 3;
+	}
+
+	static int encodeBc1Colors(Block const& block, TextureCompressionQuality const& quality, bool const& alwaysFourColors, uint8_t* out)
+	{
+		float endpoint0[4];
+		float endpoint1[4];
+		findEndpoints(block, 3, quality, endpoint0, endpoint1);
+
+		int bestError = INT_MAX;
+		int passes = quality == TextureCompressionQuality::High ? 3 : 1;
+		for (int pass = 0; pass < passes; pass++)
+		{
+			// 4 color mode needs the first endpoint to be the larger one
+			uint16_t color0 = packRgb565(endpoint0);
+			uint16_t color1 = packRgb565(endpoint1);
+			if (color0 < color1)
+			{
+				std::swap(color0, color1);
+				std::swap(endpoint0, endpoint1);
+			}
+
+			int palette[4][4];
+			int paletteSize = getBc1Palette(color0, color1, alwaysFourColors, palette);
+			uint8_t indices[BLOCK_PIXELS];
+			int error = chooseIndices(block, palette, paletteSize, 3, indices);
+			if (error < bestError)
+			{
+				bestError = error;
+				uint32_t packedIndices = 0;
+				for (int i = 0; i < BLOCK_PIXELS; i++)
+				{
+					packedIndices |= static_cast<uint32_t>(indices[i]) << (i * 2);
+				}
+				memcpy(out, &color0, 2);
+				memcpy(out + 2, &color1, 2);
+				memcpy(out + 4, &packedIndices, 4);
+			}
+
+			const float* paletteWeights = paletteSize == 4 ? BC1_WEIGHTS : BC1_THREE_COLOR_WEIGHTS;
+			float weights[BLOCK_PIXELS];
+			for (int i = 0; i < BLOCK_PIXELS; i++)
+			{
+				weights[i] = paletteWeights[indices[i]];
+			}
+			if (error == 0 || !refineEndpoints(block, 3, weights, endpoint0, endpoint1))
+			{
+				break;
+			}
+		}
+
+		return bestError;
+	}
+
+	static void decodeBc1Colors(const uint8_t* in, bool const& alwaysFourColors, Block& block)
+	{
+		uint16_t color0;
+		uint16_t color1;
+		uint32_t packedIndices;
+		memcpy(&color0, in, 2);
+		memcpy(&color1, in + 2, 2);
+		memcpy(&packedIndices, in + 4, 4);
+
+		int palette[4][4];
+		getBc1Palette(color0, color1, alwaysFourColors, palette);
+		for (int i = 0; i < BLOCK_PIXELS; i++)
+		{
+			int* color = palette[(packedIndices >> (i * 2)) & 3];
+			for (int c = 0; c < 4; c++)
+			{
+				block.pixels[i][c] = static_cast<uint8_t>(color[c]);
+			}
+		}
+	}
+
+	// Builds the palette of a BC4 block, which has 6 interpolated values when the first endpoint
+	// is the larger one, and 4 interpolated values with black and white otherwise
+	static void getBc4Palette(int const& value0, int const& value1, int palette[8])
+	{
+		palette[0] = value0;
+		palette[1] = value1;
+		if (value0 > value1)
+		{
+			for (int i = 1; i <= 6; i++)
+			{
+				palette[i + 1] = ((7 - i) * value0 + i * value1 + 3) / 7;
+			}
+			return;
+		}
+
+		for (int i = 1; i <= 4; i++)
+		{
+			palette[i + 1] = ((5 - i) * value0 + i * value1 + 2) / 5;
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+
+	static int evaluateBc4Endpoints(uint8_t const values[BLOCK_PIXELS], int const& value0, int const& value1, uint8_t indices[BLOCK_PIXELS])
+	{
+		int palette[8];
+		getBc4Palette(value0, value1, palette);
+
+		int totalError = 0;
+		for (int i = 0; i < BLOCK_PIXELS; i++)
+		{
+			int bestError = INT_MAX;
+			for (int entry = 0; entry < 8; entry++)
+			{
+				int error = (values[i] - palette[entry]) * (values[i] - palette[entry]);
+				if (error < bestError)
+				{
+					bestError = error;
+					indices[i] = static_cast<uint8_t>(entry);
+				}
+			}
+			totalError += bestError;
+		}
+		return totalError;
+	}
+
+	static int encodeBc4Channel(Block const& block, int const& channel, TextureCompressionQuality const& quality, uint8_t* out)
+	{
+		uint8_t values[BLOCK_PIXELS];
+		int minimum = 255;
+		int maximum = 0;
+		int innerMinimum = 255;
+		int innerMaximum = 0;
+		for (int i = 0; i < BLOCK_PIXELS; i++)
+		{
+			values[i] = block.pixels[i][channel];
+			minimum = std::min(minimum, static_cast<int>(values[i]));
+			maximum = std::max(maximum, static_cast<int>(values[i]));
+			if (values[i] != 0 && values[i] != 255)
+			{
+				innerMinimum = std::min(innerMinimum, static_cast<int>(values[i]));
+				innerMaximum = std::max(innerMaximum, static_cast<int>(values[i]));
+			}
+		}
+
+		int bestValue0 = maximum;
+		int bestValue1 = minimum;
+		uint8_t bestIndices[BLOCK_PIXELS];
+		int bestError = evaluateBc4Endpoints(values, bestValue0, bestValue1, bestIndices);
+
+		auto tryEndpoints = [&](int const& value0, int const& value1) {
+			uint8_t indices[BLOCK_PIXELS];
+			int error = evaluateBc4Endpoints(values, value0, value1, indices);
+			if (error < bestError)
+			{
+				bestError = error;
+				bestValue0 = value0;
+				bestValue1 = value1;
+				memcpy(bestIndices, indices, sizeof(indices));
+			}
+		};
+
+		// Blocks with black or white pixels can leave those to the fixed values of the 4 value mode
+		if (quality != TextureCompressionQuality::Fast && innerMinimum <= innerMaximum)
+		{
+			tryEndpoints(innerMinimum, innerMaximum);
+		}
+
+		if (quality == TextureCompressionQuality::High && bestError > 0)
+		{
+			for (int offset0 = -2; offset0 <= 2; offset0++)
+			{
+				for (int offset1 = -2; offset1 <= 2; offset1++)
+				{
+					int value0 = std::min(std::max(maximum + offset0, 0), 255);
+					int value1 = std::min(std::max(minimum + offset1, 0), 255);
+					if (value0 > value1)
+					{
+						tryEndpoints(value0, value1);
+					}
+				}
+			}
+		}
+
+		uint64_t packedIndices = 0;
+		for (int i = 0; i < BLOCK_PIXELS; i++)
+		{
+			packedIndices |= static_cast<uint64_t>(bestIndices[i]) << (i * 3);
+		}
+		out[0] = static_cast<uint8_t>(bestValue0);
+		out[1] = static_cast<uint8_t>(bestValue1);
+		for (int i = 0; i < 6; i++)
+		{
+			out[2 + i] = static_cast<uint8_t>(packedIndices >> (i * 8));
+		}
+
+		return bestError;
+	}
+
+	static void decodeBc4Channel(const uint8_t* in, int const& channel, Block& block)
+	{
+		int palette[8];
+		getBc4Palette(in[0], in[1], palette);
+
+		uint64_t packedIndices = 0;
+		for (int i = 0; i < 6; i++)
+		{
+			packedIndices |= static_cast<uint64_t>(in[2 + i]) << (i * 8);
+		}
+		for (int i = 0; i < BLOCK_PIXELS; i++)
+		{
+			block.pixels[i][channel] = static_cast<uint8_t>(palette[(packedIndices >> (i * 3)) & 7]);
+		}
+	}
+
+	static void getBc7Palette(int const endpoint0[4], int const endpoint1[4], int palette[16][4])
+	{
+		for (int entry = 0; entry < 16; entry++)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				palette[entry][c] = ((64 - BC7_WEIGHTS[entry]) * endpoint0[c] + BC7_WEIGHTS[entry] * endpoint1[c] + 32) >> 6;
+			}
+		}
+	}
+
+	// Quantizes an endpoint to 7 bits per channel, with a p-bit as the shared lowest bit of every channel
+	static int quantizeBc7Endpoint(float const endpoint[4], int const& pBit, int quantized[4], int expanded[4])
+	{
+		int error = 0;
+		for (int c = 0; c < 4; c++)
+		{
+			quantized[c] = std::min(std::max(static_cast<int>(std::lround((endpoint[c] - pBit) / 2.0f)), 0), 127);
+			expanded[c] = (quantized[c] << 1) | pBit;
+			int difference = clampToByte(endpoint[c]) - expanded[c];
+			error += difference * difference;
+		}
+		return error;
+	}
+
+	static int encodeBc7Block(Block const& block, TextureCompressionQuality const& quality, uint8_t* out)
+	{
+		float endpoint0[4];
+		float endpoint1[4];
+		findEndpoints(block, 4, quality, endpoint0, endpoint1);
+
+		int bestError = INT_MAX;
+		int bestQuantized[2][4];
+		int bestPBits[2];
+		uint8_t bestIndices[BLOCK_PIXELS];
+
+		int passes = quality == TextureCompressionQuality::High ? 3 : 1;
+		for (int pass = 0; pass < passes; pass++)
+		{
+			// Below high quality, each endpoint simply takes the p-bit that reproduces it best
+			int preferredPBits = 0;
+			if (quality != TextureCompressionQuality::High)
+			{
+				int quantized[4];
+				int expanded[4];
+				int pBit0 = quantizeBc7Endpoint(endpoint0, 1, quantized, expanded) < quantizeBc7Endpoint(endpoint0, 0, quantized, expanded) ? 1 : 0;
+				int pBit1 = quantizeBc7Endpoint(endpoint1, 1, quantized, expanded) < quantizeBc7Endpoint(endpoint1, 0, quantized, expanded) ? 1 : 0;
+				preferredPBits = pBit0 | (pBit1 << 1);
+			}
+
+			uint8_t passIndices[BLOCK_PIXELS];
+			int passError = INT_MAX;
+			for (int pBits = 0; pBits < 4; pBits++)
+			{
+				if (quality != TextureCompressionQuality::High && pBits != preferredPBits)
+				{
+					continue;
+				}
+
+				int quantized[2][4];
+				int expanded[2][4];
+				quantizeBc7Endpoint(endpoint0, pBits & 1, quantized[0], expanded[0]);
+				quantizeBc7Endpoint(endpoint1, pBits >> 1, quantized[1], expanded[1]);
+
+				int palette[16][4];
+				getBc7Palette(expanded[0], expanded[1], palette);
+				uint8_t indices[BLOCK_PIXELS];
+				int error = chooseIndices(block, palette, 16, 4, indices);
+				if (error < passError)
+				{
+					passError = error;
+					memcpy(passIndices, indices, sizeof(indices));
+				}
+				if (error < bestError)
+				{
+					bestError = error;
+					memcpy(bestQuantized, quantized, sizeof(quantized));
+					bestPBits[0] = pBits & 1;
+					bestPBits[1] = pBits >> 1;
+					memcpy(bestIndices, indices, sizeof(indices));
+				}
+			}
+
+			float weights[BLOCK_PIXELS];
+			for (int i = 0; i < BLOCK_PIXELS; i++)
+			{
+				weights[i] = BC7_WEIGHTS[passIndices[i]] / 64.0f;
+			}
+			if (bestError == 0 || !refineEndpoints(block, 4, weights, endpoint0, endpoint1))
+			{
+				break;
+			}
+		}
+
+		// The first pixel's index is stored without its highest bit, so it has to be in the lower half
+		if (bestIndices[0] >= 8)
+		{
+			std::swap(bestQuantized[0], bestQuantized[1]);
+			std::swap(bestPBits[0], bestPBits[1]);
+			for (int i = 0; i < BLOCK_PIXELS; i++)
+			{
+				bestIndices[i] = static_cast<uint8_t>(15 - bestIndices[i]);
+			}
+		}
+
+		memset(out, 0, 16);
+		BlockBits bits = { out, 0 };
+		bits.write(BC7_MODE_6, 7);
+		for (int c = 0; c < 4; c++)
+		{
+			bits.write(bestQuantized[0][c], 7);
+			bits.write(bestQuantized[1][c], 7);
+		}
+		bits.write(bestPBits[0], 1);
+		bits.write(bestPBits[1], 1);
+		for (int i = 0; i < BLOCK_PIXELS; i++)
+		{
+			bits.write(bestIndices[i], i == 0 ? 3 : 4);
+		}
+
+		return bestError;
+	}
+
+	static void decodeBc7Block(const uint8_t* in, Block& block)
+	{
+		memset(block.pixels, 0, sizeof(block.pixels));
+		if ((in[0] & 0x7F) != BC7_MODE_6)
+		{
+			return;
+		}
+
+		BlockBits bits = { const_cast<uint8_t*>(in), 7 };
+		int endpoints[2][4];
+		for (int c = 0; c < 4; c++)
+		{
+			endpoints[0][c] = bits.read(7) << 1;
+			endpoints[1][c] = bits.read(7) << 1;
+		}
+		int pBit0 = bits.read(1);
+		int pBit1 = bits.read(1);
+		for (int c = 0; c < 4; c++)
+		{
+			endpoints[0][c] |= pBit0;
+			endpoints[1][c] |= pBit1;
+		}
+
+		int palette[16][4];
+		getBc7Palette(endpoints[0], endpoints[1], palette);
+		for (int i = 0; i < BLOCK_PIXELS; i++)
+		{
+			int* color = palette[bits.read(i == 0 ? 3 : 4)];
+			for (int c = 0; c < 4; c++)
+			{
+				block.pixels[i][c] = static_cast<uint8_t>(color[c]);
+			}
+		}
+	}
+
+	size_t getBlockSize(TextureCompressionFormat const& format)
+	{
+		switch (format)
+		{
+		case TextureCompressionFormat::BC1:
+		case TextureCompressionFormat::BC4:
+			return 8;
+		case TextureCompressionFormat::BC3:
+		case TextureCompressionFormat::BC5:
+		case TextureCompressionFormat::BC7:
+			return 16;
+		default:
+			return 0;
+		}
+	}
+
+	size_t getLevelSize(TextureCompressionFormat const& format, int const& width, int const& height)
+	{
+		size_t blocksX = static_cast<size_t>(std::max((width + 3) / 4, 1));
+		size_t blocksY = static_cast<size_t>(std::max((height + 3) / 4, 1));
+		return blocksX * blocksY * getBlockSize(format);
+	}
+
+	int getLevelCount(int const& width, int const& height)
+	{
+		int levelCount = 1;
+		for (int size = std::max(width, height); size > 1; size /= 2)
+		{
+			levelCount++;
+		}
+		return levelCount;
+	}
+
+	int getChannelCount(TextureCompressionFormat const& format)
+	{
+		switch (format)
+		{
+		case TextureCompressionFormat::BC1:
+			return 3;
+		case TextureCompressionFormat::BC4:
+			return 1;
+		case TextureCompressionFormat::BC5:
+			return 2;
+		default:
+			return 4;
+		}
+	}
+
+	void expandToRgba(const unsigned char* data, int const& width, int const& height, int const& channels, std::vector<uint8_t>& rgba)
+	{
+		size_t pixelCount = static_cast<size_t>(width) * height;
+		rgba.resize(pixelCount * 4);
+		for (size_t i = 0; i < pixelCount; i++)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				rgba[i * 4 + c] = c < channels ? data[i * channels + c] : (c == 3 ? 255 : 0);
+			}
+		}
+	}
+
+	static void compressBlockRow(const uint8_t* rgba, int const& width, int const& height, int const& blockY, TextureCompressionFormat const& format, TextureCompressionQuality const& quality, uint8_t* blocks)
+	{
+		size_t blockSize = getBlockSize(format);
+		int blocksX = std::max((width + 3) / 4, 1);
+		for (int blockX = 0; blockX < blocksX; blockX++)
+		{
+			Block block;
+			loadBlock(rgba, width, height, blockX, blockY, block);
+			uint8_t* out = blocks + (static_cast<size_t>(blockY) * blocksX + blockX) * blockSize;
+
+			switch (format)
+			{
+			case TextureCompressionFormat::BC1:
+				encodeBc1Colors(block, quality, false, out);
+				break;
+			case TextureCompressionFormat::BC3:
+				encodeBc4Channel(block, 3, quality, out);
+				encodeBc1Colors(block, quality, true, out + 8);
+				break;
+			case TextureCompressionFormat::BC4:
+				encodeBc4Channel(block, 0, quality, out);
+				break;
+			case TextureCompressionFormat::BC5:
+				encodeBc4Channel(block, 0, quality, out);
+				encodeBc4Channel(block, 1, quality, out + 8);
+				break;
+			case TextureCompressionFormat::BC7:
+				encodeBc7Block(block, quality, out);
+				break;
+			default:
+				break;
+			}
+		}
+	}
+
+	void compress(const uint8_t* rgba, int const& width, int const& height, TextureCompressionFormat const& format, TextureCompressionQuality const& quality, std::vector<uint8_t>& blocks)
+	{
+		if (getBlockSize(format) == 0)
+		{
+			blocks.clear();
+			return;
+		}
+
+		int blocksY = std::max((height + 3) / 4, 1);
+		blocks.assign(getLevelSize(format, width, height), 0);
+
+		Helpers::parallelFor(static_cast<size_t>(blocksY), [&](size_t const& blockY) {
+			compressBlockRow(rgba, width, height, static_cast<int>(blockY), format, quality, blocks.data());
+		});
+	}
+
+	void compressLevels(std::vector<MipLevel> const& levels, TextureCompressionFormat const& format, TextureCompressionQuality const& quality, std::vector<std::vector<uint8_t>>& blocks)
+	{
+		blocks.assign(levels.size(), std::vector<uint8_t>());
+		if (getBlockSize(format) == 0)
+		{
+			return;
+		}
+
+		// Flatten the rows of blocks of every level into one list of jobs
+		std::vector<std::pair<size_t, int>> rows;
+		for (size_t i = 0; i < levels.size(); i++)
+		{
+			blocks[i].assign(getLevelSize(format, levels[i].width, levels[i].height), 0);
+			int blocksY = std::max((levels[i].height + 3) / 4, 1);
+			for (int blockY = 0; blockY < blocksY; blockY++)
+			{
+				rows.push_back(std::make_pair(i, blockY));
+			}
+		}
+
+		Helpers::parallelFor(rows.size(), [&](size_t const& row) {
+			MipLevel const& level = levels[rows[row].first];
+			compressBlockRow(level.data.data(), level.width, level.height, rows[row].second, format, quality, blocks[rows[row].first].data());
+		});
+	}
+
+	void decompress(const uint8_t* blocks, int const& width, int const& height, TextureCompressionFormat const& format, std::vector<uint8_t>& rgba)
+	{
+		rgba.assign(static_cast<size_t>(width) * height * 4, 0);
+
+		size_t blockSize = getBlockSize(format);
+		if (blockSize == 0)
+		{
+			return;
+		}
+
+		int blocksX = std::max((width + 3) / 4, 1);
+		int blocksY = std::max((height + 3) / 4, 1);
+		for (int blockY = 0; blockY < blocksY; blockY++)
+		{
+			for (int blockX = 0; blockX < blocksX; blockX++)
+			{
+				const uint8_t* in = blocks + (static_cast<size_t>(blockY) * blocksX + blockX) * blockSize;
+
+				// Channels a format does not store are sampled as zero, with opaque alpha
+				Block block;
+				for (int i = 0; i < BLOCK_PIXELS; i++)
+				{
+					block.pixels[i][0] = 0;
+					block.pixels[i][1] = 0;
+					block.pixels[i][2] = 0;
+					block.pixels[i][3] = 255;
+				}
+
+				switch (format)
+				{
+				case TextureCompressionFormat::BC1:
+					decodeBc1Colors(in, false, block);
+					break;
+				case TextureCompressionFormat::BC3:
+					decodeBc1Colors(in + 8, true, block);
+					decodeBc4Channel(in, 3, block);
+					break;
+				case TextureCompressionFormat::BC4:
+					decodeBc4Channel(in, 0, block);
+					break;
+				case TextureCompressionFormat::BC5:
+					decodeBc4Channel(in, 0, block);
+					decodeBc4Channel(in + 8, 1, block);
+					break;
+				case TextureCompressionFormat::BC7:
+					decodeBc7Block(in, block);
+					break;
+				default:
+					break;
+				}
+
+				storeBlock(block, width, height, blockX, blockY, rgba.data());
+			}
+		}
+	}
+
+	double calculatePsnr(const uint8_t* expected, const uint8_t* actual, int const& width, int const& height, TextureCompressionFormat const& format)
+	{
+		int channelCount = getChannelCount(format);
+		size_t pixelCount = static_cast<size_t>(width) * height;
+
+		double squaredError = 0.0;
+		for (size_t i = 0; i < pixelCount; i++)
+		{
+			for (int c = 0; c < channelCount; c++)
+			{
+				double difference = static_cast<double>(expected[i * 4 + c]) - actual[i * 4 + c];
+				squaredError += difference * difference;
+			}
+		}
+
+		if (squaredError == 0.0 || pixelCount == 0)
+		{
+			return std::numeric_limits<double>::infinity();
+		}
+
+		double meanSquaredError = squaredError / (pixelCount * channelCount);
+		return 10.0 * std::log10(255.0 * 255.0 / meanSquaredError);
+	}
+
+	std::string formatToString(TextureCompressionFormat const& format)
+	{
+		switch (format)
+		{
+		case TextureCompressionFormat::BC1:
+			return "BC1";
+		case TextureCompressionFormat::BC3:
+			return "BC3";
+		case TextureCompressionFormat::BC4:
+			return "BC4";
+		case TextureCompressionFormat::BC5:
+			return "BC5";
+		case TextureCompressionFormat::BC7:
+			return "BC7";
+		default:
+			return "None";
+		}
+	}
+
+	bool stringToFormat(std::string const& name, TextureCompressionFormat& format)
+	{
+		static const TextureCompressionFormat formats[] = {
+			TextureCompressionFormat::None,
+			TextureCompressionFormat::BC1,
+			TextureCompressionFormat::BC3,
+			TextureCompressionFormat::BC4,
+			TextureCompressionFormat::BC5,
+			TextureCompressionFormat::BC7
+		};
+
+		for (auto const& candidate : formats)
+		{
+			if (formatToString(candidate) == name)
+			{
+				format = candidate;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	std::string qualityToString(TextureCompressionQuality const& quality)
+	{
+		switch (quality)
+		{
+		case TextureCompressionQuality::Fast:
+			return "Fast";
+		case TextureCompressionQuality::High:
+			return "High";
+		default:
+			return "Normal";
+		}
+	}
+
+	bool stringToQuality(std::string const& name, TextureCompressionQuality& quality)
+	{
+		static const TextureCompressionQuality qualities[] = {
+			TextureCompressionQuality::Fast,
+			TextureCompressionQuality::Normal,
+			TextureCompressionQuality::High
+		};
+
+		for (auto const& candidate : qualities)
+		{
+			if (qualityToString(candidate) == name)
+			{
+				quality = candidate;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+}
@@ -0,0 +1,147 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Rendering\MipGenerator.h"
+
+namespace DerydocaEngine::Rendering
+{
+
+	/* Block compressed format a texture is stored in on the GPU */
+	enum class TextureCompressionFormat
+	{
+		/* Uncompressed, decoded from the source image every load */
+		None,
+		/* RGB at 4 bits per pixel, alpha is dropped */
+		BC1,
+		/* RGBA at 8 bits per pixel, with alpha stored like BC4 */
+		BC3,
+		/* Single channel at 4 bits per pixel */
+		BC4,
+		/* Two channels at 8 bits per pixel, suited to normal maps */
+		BC5,
+		/* RGBA at 8 bits per pixel with the best quality */
+		BC7
+	};
+
+	/* How much time the encoder spends searching for better endpoints */
+	enum class TextureCompressionQuality
+	{
+		/* Endpoints from the bounding box of each block */
+		Fast,
+		/* Endpoints along the principal axis of each block */
+		Normal,
+		/* Principal axis endpoints refined with least squares fitting */
+		High
+	};
+
+	/* A single mip level of a compressed texture */
+	struct CompressedTextureLevel
+	{
+		int width = 0;
+		int height = 0;
+		/* Compressed blocks, not owned */
+		const uint8_t* data = nullptr;
+		size_t size = 0;
+	};
+
+	/*
+	Block compressed texture with its full mip chain, ready to be uploaded as it is. The level data
+	is not owned, it points at memory such as a mapped cooked texture, which must stay alive until
+	the texture is uploaded.
+	*/
+	struct CompressedTextureData
+	{
+		TextureCompressionFormat format = TextureCompressionFormat::None;
+		/* 1 for a 2D texture or 6 for a cubemap, whose levels hold the mip chain of each face in turn */
+		int faceCount = 1;
+		std::vector<CompressedTextureLevel> levels;
+	};
+
+	/*
+	CPU encoder and decoder for the BC formats. Every function works on tightly packed 8 bit RGBA
+	pixels. Single and two channel images are expanded the way OpenGL samples them, so red is the
+	first channel, green the second and anything missing is zero, with opaque alpha.
+	*/
+	namespace TextureCompression
+	{
+
+		/* Gets the size of a single 4x4 block in bytes */
+		size_t getBlockSize(TextureCompressionFormat const& format);
+
+		/* Gets the size of a level in bytes, where partial blocks at the edges take up a full block */
+		size_t getLevelSize(TextureCompressionFormat const& format, int const& width, int const& height);
+
+		/* Gets the number of levels in a full mip chain down to 1x1 */
+		int getLevelCount(int const& width, int const& height);
+
+		/* Gets the number of channels a format stores */
+		int getChannelCount(TextureCompressionFormat const& format);
+
+		/*
+		Expands an image to 8 bit RGBA.
+
+		@param data Pixels of the image
+		@param width Width of the image
+		@param height Height of the image
+		@param channels Number of 8 bit channels per pixel
+		@param rgba Receives the expanded pixels
+		*/
+		void expandToRgba(const unsigned char* data, int const& width, int const& height, int const& channels, std::vector<uint8_t>& rgba);
+
+		/*
+		Compresses a level. Rows of blocks are compressed on every core.
+
+		@param rgba Pixels of the level
+		@param width Width of the level
+		@param height Height of the level
+		@param format Format to compress to
+		@param quality How long to spend on each block
+		@param blocks Receives the compressed blocks
+		*/
+		void compress(const uint8_t* rgba, int const& width, int const& height, TextureCompressionFormat const& format, TextureCompressionQuality const& quality, std::vector<uint8_t>& blocks);
+
+		/*
+		Compresses every level of a mip chain. The rows of blocks of all levels are handed out
+		together, so the small levels run alongside the large ones instead of leaving cores idle.
+
+		@param levels RGBA pixels of each level
+		@param format Format to compress to
+		@param quality How long to spend on each block
+		@param blocks Receives the compressed blocks of each level
+		*/
+		void compressLevels(std::vector<MipLevel> const& levels, TextureCompressionFormat const& format, TextureCompressionQuality const& quality, std::vector<std::vector<uint8_t>>& blocks);
+
+		/*
+		Decompresses a level the way the GPU samples it. BC7 blocks are only decoded if they use
+		mode 6, the only mode the encoder writes.
+
+		@param blocks Compressed blocks
+		@param width Width of the level
+		@param height Height of the level
+		@param format Format of the blocks
+		@param rgba Receives the decompressed pixels
+		*/
+		void decompress(const uint8_t* blocks, int const& width, int const& height, TextureCompressionFormat const& format, std::vector<uint8_t>& rgba);
+
+		/*
+		Calculates the peak signal to noise ratio between two images over the channels a format stores.
+
+		@return PSNR in decibels, or infinity if the images are identical
+		*/
+		double calculatePsnr(const uint8_t* expected, const uint8_t* actual, int const& width, int const& height, TextureCompressionFormat const& format);
+
+		std::string formatToString(TextureCompressionFormat const& format);
+
+		/* @return False if no format has that name */
+		bool stringToFormat(std::string const& name, TextureCompressionFormat& format);
+
+		std::string qualityToString(TextureCompressionQuality const& quality);
+
+		/* @return False if no quality preset has that name */
+		bool stringToQuality(std::string const& name, TextureCompressionQuality& quality);
+
+	}
+
+}
@@ -0,0 +1,62 @@
+#include "EnginePch.h"
+#include "Rendering\TextureImage.h"
+
+#include <algorithm>
+
+namespace DerydocaEngine::Rendering
+{
+
+	TextureImage::TextureImage() :
+		m_data(nullptr),
+		m_width(0),
+		m_height(0),
+		m_channels(0)
+	{
+	}
+
+	TextureImage::~TextureImage()
+	{
+		release();
+	}
+
+	bool TextureImage::load(std::string const& fileName, bool const& flipVertically)
+	{
+		release();
+
+		// stb_image only has a process wide flip setting, so the rows are flipped here instead
+		m_data = stbi_load(fileName.c_str(), &m_width, &m_height, &m_channels, 0);
+		if (!m_data)
+		{
+			m_width = 0;
+			m_height = 0;
+			m_channels = 0;
+			return false;
+		}
+
+		if (flipVertically)
+		{
+			size_t rowSize = static_cast<size_t>(m_width) * m_channels;
+			for (int row = 0; row < m_height / 2; row++)
+			{
+				unsigned char* top = m_data + row * rowSize;
+				unsigned char* bottom = m_data + (m_height - 1 - row) * rowSize;
+				std::swap_ranges(top, top + rowSize, bottom);
+			}
+		}
+
+		return true;
+	}
+
+	void TextureImage::release()
+	{
+		if (m_data)
+		{
+			stbi_image_free(m_data);
+			m_data = nullptr;
+		}
+		m_width = 0;
+		m_height = 0;
+		m_channels = 0;
+	}
+
+}
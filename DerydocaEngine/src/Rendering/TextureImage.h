@@ -0,0 +1,45 @@
+#pragma once
+#include <string>
+
+namespace DerydocaEngine::Rendering
+{
+
+	/*
+	Pixels of an image decoded on the CPU, waiting to be uploaded to a texture. Decoding does
+	not touch any global decoder state, so images can be loaded on several threads at once.
+	*/
+	class TextureImage
+	{
+	public:
+		TextureImage();
+		~TextureImage();
+
+		/*
+		Decodes an image file, releasing any image that was previously loaded.
+
+		@param fileName Path of the image to load
+		@param flipVertically Whether the first row of the image should be its bottom row
+		@return True if the image was decoded
+		*/
+		bool load(std::string const& fileName, bool const& flipVertically);
+
+		/* Releases the pixels of the image */
+		void release();
+
+		bool isLoaded() const { return m_data != nullptr; }
+		unsigned char* getData() const { return m_data; }
+		int getWidth() const { return m_width; }
+		int getHeight() const { return m_height; }
+		int getChannels() const { return m_channels; }
+
+		void operator=(TextureImage const&) = delete;
+	private:
+		TextureImage(TextureImage const&);
+
+		unsigned char* m_data;
+		int m_width;
+		int m_height;
+		int m_channels;
+	};
+
+}
@@ -0,0 +1,119 @@
+#include "EnginePch.h"
+#include "Rendering\TextureStreaming.h"
+
+#include <algorithm>
+#include <cmath>
+#include "Components\Camera.h"
+#include "Components\Transform.h"
+#include "GameObject.h"
+#include "Rendering\CameraManager.h"
+#include "Rendering\Culling.h"
+#include "Rendering\Material.h"
+#include "Rendering\Mesh.h"
+
+namespace DerydocaEngine::Rendering::TextureStreaming
+{
+
+	// Surfaces closer than this are treated as this close, so the camera being inside a mesh's
+	// bounds asks for the largest level instead of dividing by zero
+	static const float MIN_DISTANCE = 0.01f;
+
+	float calculateUvDensity(std::vector<glm::vec3> const& positions, std::vector<glm::vec2> const& texCoords, std::vector<unsigned int> const& indices, int const& indicesPerTriangle)
+	{
+		if (texCoords.size() != positions.size() || positions.empty() || indicesPerTriangle < 3)
+		{
+			return 0.0f;
+		}
+
+		// Adjacency triangles keep their own corners at every other index
+		int cornerStride = indicesPerTriangle / 3;
+
+		double modelArea = 0.0;
+		double uvArea = 0.0;
+		for (size_t i = 0; i + indicesPerTriangle <= indices.size(); i += indicesPerTriangle)
+		{
+			unsigned int i0 = indices[i];
+			unsigned int i1 = indices[i + cornerStride];
+			unsigned int i2 = indices[i + cornerStride * 2];
+			if (i0 >= positions.size() || i1 >= positions.size() || i2 >= positions.size())
+			{
+				continue;
+			}
+
+			modelArea += glm::length(glm::cross(positions[i1] - positions[i0], positions[i2] - positions[i0])) * 0.5;
+
+			glm::vec2 uvEdge1 = texCoords[i1] - texCoords[i0];
+			glm::vec2 uvEdge2 = texCoords[i2] - texCoords[i0];
+			uvArea += std::abs(uvEdge1.x * uvEdge2.y - uvEdge1.y * uvEdge2.x) * 0.5;
+		}
+
+		if (modelArea <= 0.0)
+		{
+			return 0.0f;
+		}
+
+		return static_cast<float>(std::sqrt(uvArea / modelArea));
+	}
+
+	int calculateRequiredLevel(float const& texelsPerWorldUnit, float const& pixelsPerWorldUnit, int const& levelCount)
+	{
+		if (levelCount <= 1)
+		{
+			return 0;
+		}
+
+		if (pixelsPerWorldUnit <= 0.0f)
+		{
+			return levelCount - 1;
+		}
+
+		if (texelsPerWorldUnit <= pixelsPerWorldUnit)
+		{
+			return 0;
+		}
+
+		// Round down so the level is never blurrier than what trilinear filtering blends towards
+		int level = static_cast<int>(std::floor(std::log2(texelsPerWorldUnit / pixelsPerWorldUnit)));
+		return std::min(level, levelCount - 1);
+	}
+
+	void requestLevels(Material const& material, Mesh const& mesh, glm::mat4 const& modelMatrix)
+	{
+		// Without UVs every pixel samples the same texel, which the smallest level already has
+		auto camera = CameraManager::getInstance().getCurrentCamera();
+		if (!camera || mesh.getUvDensity() <= 0.0f)
+		{
+			return;
+		}
+
+		Projection const& projection = camera->getProjection();
+		glm::mat4 projectionMatrix = projection.getProjectionMatrix();
+		glm::mat4 viewModelMatrix = projection.getViewMatrix(camera->getGameObject()->getTransform()->getModel()) * modelMatrix;
+		if (!Culling::isBoxInsideClipVolume(projectionMatrix * viewModelMatrix, mesh.getBoundsMin(), mesh.getBoundsMax()))
+		{
+			return;
+		}
+
+		float scale = std::max(
+			glm::length(glm::vec3(modelMatrix[0])),
+			std::max(glm::length(glm::vec3(modelMatrix[1])), glm::length(glm::vec3(modelMatrix[2]))));
+		if (scale <= 0.0f)
+		{
+			return;
+		}
+
+		// Orthographic projections show every distance at the same size
+		float pixelsPerWorldUnit = projectionMatrix[1][1] * camera->getDisplayHeight() * 0.5f;
+		if (projectionMatrix[3][3] != 1.0f)
+		{
+			// Use the nearest point of the bounding sphere, so no part of the mesh is left blurry
+			glm::vec3 center = (mesh.getBoundsMin() + mesh.getBoundsMax()) * 0.5f;
+			float radius = glm::length(mesh.getBoundsMax() - mesh.getBoundsMin()) * 0.5f * scale;
+			float distance = glm::length(glm::vec3(viewModelMatrix * glm::vec4(center, 1.0f))) - radius;
+			pixelsPerWorldUnit /= std::max(distance, MIN_DISTANCE);
+		}
+
+		material.requestTextureLevels(mesh.getUvDensity() / scale, pixelsPerWorldUnit);
+	}
+
+}
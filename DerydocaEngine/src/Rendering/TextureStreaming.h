@@ -0,0 +1,58 @@
+#pragma once
+#include <vector>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+namespace DerydocaEngine::Rendering
+{
+	class Material;
+	class Mesh;
+}
+
+namespace DerydocaEngine::Rendering
+{
+
+	/*
+	Works out which mip level of a texture a surface needs, from how densely its UVs are spread
+	over the surface and how large the surface appears on screen. A level is needed when a pixel
+	covers no more than one of its texels, any larger level is never sampled.
+	*/
+	namespace TextureStreaming
+	{
+
+		/*
+		Calculates how many UV units a mesh spans per unit of its own space, averaged by area over
+		every triangle.
+
+		@param positions Position of each vertex
+		@param texCoords UV of each vertex
+		@param indices Indices of the triangles
+		@param indicesPerTriangle Number of indices per triangle, which is 6 for the adjacency layout
+		@return UV units per unit of model space, or 0 if the mesh has no UVs or area
+		*/
+		float calculateUvDensity(std::vector<glm::vec3> const& positions, std::vector<glm::vec2> const& texCoords, std::vector<unsigned int> const& indices, int const& indicesPerTriangle);
+
+		/*
+		Gets the largest level a surface can sample.
+
+		@param texelsPerWorldUnit Texels of the largest level per world unit of the surface
+		@param pixelsPerWorldUnit Screen pixels per world unit of the surface
+		@param levelCount Number of levels of the texture
+		@return Index of the largest level needed
+		*/
+		int calculateRequiredLevel(float const& texelsPerWorldUnit, float const& pixelsPerWorldUnit, int const& levelCount);
+
+		/*
+		Asks for the levels that the streamed textures of a material need to draw a mesh through
+		the current camera. Meshes outside of the camera's view ask for nothing.
+
+		@param material Material the mesh is drawn with
+		@param mesh Mesh being drawn
+		@param modelMatrix Matrix from the mesh's space to world space
+		*/
+		void requestLevels(Material const& material, Mesh const& mesh, glm::mat4 const& modelMatrix);
+
+	}
+
+}
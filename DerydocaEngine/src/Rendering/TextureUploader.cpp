@@ -0,0 +1,264 @@
+#include "EnginePch.h"
+#include "Rendering\TextureUploader.h"
+
+#include <algorithm>
+#include <cstring>
+#include "Rendering\Texture.h"
+
+namespace DerydocaEngine::Rendering
+{
+
+	// Frames the GPU may fall behind on the ring before the CPU has to wait for it
+	static const int REGION_COUNT = 3;
+	static const size_t DEFAULT_UPLOAD_BUDGET = 2 * 1024 * 1024;
+
+	// Chunks are a fraction of the budget, so several textures make progress in the same frame and
+	// the end of a frame's budget is not wasted on a chunk that does not fit
+	static const size_t CHUNKS_PER_BUDGET = 4;
+
+	TextureUploader::TextureUploader() :
+		m_ring(),
+		m_ringFailed(false),
+		m_jobs(),
+		m_uploadBudget(DEFAULT_UPLOAD_BUDGET),
+		m_statistics()
+	{
+	}
+
+	TextureUploader::~TextureUploader()
+	{
+	}
+
+	void TextureUploader::upload(Texture& texture, TextureUploads::UploadRect const& rect, const uint8_t* image, int const& imageWidth, int const& channels, bool const& generateMipmaps)
+	{
+		if (image == nullptr || rect.width <= 0 || rect.height <= 0 || !texture.getRendererId())
+		{
+			return;
+		}
+
+		// Textures that are not shared can not be tracked until their upload is done
+		std::weak_ptr<Texture> weakTexture = texture.weak_from_this();
+		if (!createRing() || weakTexture.expired())
+		{
+			uploadImmediately(texture, rect, image + (static_cast<size_t>(rect.y) * imageWidth + rect.x) * channels, imageWidth, channels, generateMipmaps);
+			return;
+		}
+
+		UploadJob job;
+		job.texture = weakTexture;
+		job.target = &texture;
+		job.rendererId = texture.getRendererId();
+		job.channels = channels;
+		job.generateMipmaps = generateMipmaps;
+		job.width = rect.width;
+		job.rect = rect;
+		job.nextChunk = 0;
+
+		size_t rowBytes = static_cast<size_t>(rect.width) * channels;
+		job.pixels.resize(rowBytes * rect.height);
+		for (int y = 0; y < rect.height; y++)
+		{
+			memcpy(job.pixels.data() + y * rowBytes, image + (static_cast<size_t>(rect.y + y) * imageWidth + rect.x) * channels, rowBytes);
+		}
+
+		TextureUploads::splitIntoChunks(rect, channels, getChunkSize(), job.chunks);
+		m_statistics.pendingBytes += job.pixels.size();
+		m_jobs.push_back(std::move(job));
+	}
+
+	void TextureUploader::cancel(Texture const& texture)
+	{
+		for (auto it = m_jobs.begin(); it != m_jobs.end();)
+		{
+			if (it->target != &texture)
+			{
+				it++;
+				continue;
+			}
+
+			for (size_t i = it->nextChunk; i < it->chunks.size(); i++)
+			{
+				m_statistics.pendingBytes -= static_cast<size_t>(it->chunks[i].width) * it->chunks[i].height * it->channels;
+			}
+			it = m_jobs.erase(it);
+		}
+	}
+
+	void TextureUploader::update()
+	{
+		if (m_jobs.empty())
+		{
+			m_statistics.lastFrameBytes = 0;
+			return;
+		}
+
+		if (!createRing())
+		{
+			// Nothing more can be queued, so whatever was queued before the ring was lost is finished now
+			for (auto const& job : m_jobs)
+			{
+				auto texture = job.texture.lock();
+				if (texture && texture->getRendererId() == job.rendererId)
+				{
+					uploadImmediately(*texture, job.rect, job.pixels.data(), job.width, job.channels, job.generateMipmaps);
+				}
+			}
+			m_jobs.clear();
+			m_statistics.pendingBytes = 0;
+			return;
+		}
+
+		double stallTime = m_ring.beginFrame();
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_ring.getBufferId());
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+		size_t frameBytes = 0;
+		while (!m_jobs.empty())
+		{
+			UploadJob& job = m_jobs.front();
+
+			// Textures that were released or given new storage since the upload was queued are skipped
+			auto texture = job.texture.lock();
+			bool budgetSpent = false;
+			if (texture && texture->getRendererId() == job.rendererId)
+			{
+				while (job.nextChunk < job.chunks.size())
+				{
+					TextureUploads::UploadRect const& chunk = job.chunks[job.nextChunk];
+					size_t chunkBytes = static_cast<size_t>(chunk.width) * chunk.height * job.channels;
+					if (!uploadChunk(*texture, job, chunk))
+					{
+						budgetSpent = true;
+						break;
+					}
+
+					job.nextChunk++;
+					frameBytes += chunkBytes;
+					m_statistics.pendingBytes -= chunkBytes;
+					m_statistics.chunkCount++;
+				}
+
+				if (budgetSpent)
+				{
+					break;
+				}
+
+				if (job.generateMipmaps)
+				{
+					glBindTexture(texture->getTextureType(), job.rendererId);
+					glGenerateMipmap(texture->getTextureType());
+				}
+			}
+			else
+			{
+				for (size_t i = job.nextChunk; i < job.chunks.size(); i++)
+				{
+					m_statistics.pendingBytes -= static_cast<size_t>(job.chunks[i].width) * job.chunks[i].height * job.channels;
+				}
+			}
+
+			m_jobs.pop_front();
+		}
+
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		m_ring.endFrame();
+
+		m_statistics.uploadedBytes += frameBytes;
+		m_statistics.lastFrameBytes = frameBytes;
+		m_statistics.peakFrameBytes = std::max(m_statistics.peakFrameBytes, frameBytes);
+		m_statistics.stallTime += stallTime;
+		m_statistics.peakStallTime = std::max(m_statistics.peakStallTime, stallTime);
+		if (frameBytes > 0)
+		{
+			m_statistics.uploadFrameCount++;
+		}
+	}
+
+	void TextureUploader::setUploadBudget(size_t const& bytes)
+	{
+		// The ring is sized by the budget, so it is created again with the next upload, and queued
+		// uploads are split again so their chunks fit in it
+		m_uploadBudget = std::max(bytes, static_cast<size_t>(1));
+		m_ring.destroy();
+		m_ringFailed = false;
+
+		m_statistics.pendingBytes = 0;
+		for (auto& job : m_jobs)
+		{
+			TextureUploads::splitIntoChunks(job.rect, job.channels, getChunkSize(), job.chunks);
+			job.nextChunk = 0;
+			m_statistics.pendingBytes += job.pixels.size();
+		}
+	}
+
+	void TextureUploader::printStatistics() const
+	{
+		printf("Uploaded %.1f KB of texture regions in %zu chunks over %zu frames, at most %.1f KB in a frame with a budget of %.1f KB, %.2fms waiting on the GPU (at most %.2fms in a frame), %.1f KB still queued\n",
+			m_statistics.uploadedBytes / 1024.0f,
+			m_statistics.chunkCount,
+			m_statistics.uploadFrameCount,
+			m_statistics.peakFrameBytes / 1024.0f,
+			m_uploadBudget / 1024.0f,
+			m_statistics.stallTime,
+			m_statistics.peakStallTime,
+			m_statistics.pendingBytes / 1024.0f);
+	}
+
+	bool TextureUploader::createRing()
+	{
+		if (!m_ring.isCreated() && !m_ringFailed && !m_ring.create(m_uploadBudget, REGION_COUNT))
+		{
+			std::cout << "Unable to create the texture staging ring, textures are uploaded straight from memory.\n";
+			m_ringFailed = true;
+		}
+		return !m_ringFailed;
+	}
+
+	size_t TextureUploader::getChunkSize() const
+	{
+		return std::max(m_uploadBudget / CHUNKS_PER_BUDGET, static_cast<size_t>(1));
+	}
+
+	void TextureUploader::uploadImmediately(Texture& texture, TextureUploads::UploadRect const& rect, const uint8_t* pixels, int const& rowLength, int const& channels, bool const& generateMipmaps)
+	{
+		GLenum pixelFormat = texture.channelsToPixelFormat(channels);
+		glBindTexture(texture.getTextureType(), texture.getRendererId());
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, rowLength);
+		glTexSubImage2D(texture.getTextureType(), 0, rect.x, rect.y, rect.width, rect.height, pixelFormat, GL_UNSIGNED_BYTE, pixels);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+		if (generateMipmaps)
+		{
+			glGenerateMipmap(texture.getTextureType());
+		}
+	}
+
+	bool TextureUploader::uploadChunk(Texture& texture, UploadJob& job, TextureUploads::UploadRect const& chunk)
+	{
+		size_t rowBytes = static_cast<size_t>(chunk.width) * job.channels;
+		size_t offset = 0;
+		uint8_t* destination = m_ring.map(rowBytes * chunk.height, offset);
+		if (destination == nullptr)
+		{
+			return false;
+		}
+
+		size_t sourceRowBytes = static_cast<size_t>(job.width) * job.channels;
+		const uint8_t* source = job.pixels.data() + (chunk.y - job.rect.y) * sourceRowBytes + static_cast<size_t>(chunk.x - job.rect.x) * job.channels;
+		for (int y = 0; y < chunk.height; y++)
+		{
+			memcpy(destination + y * rowBytes, source + y * sourceRowBytes, rowBytes);
+		}
+		m_ring.unmap();
+
+		// With a pixel buffer bound, the pointer is an offset into the buffer
+		glBindTexture(texture.getTextureType(), job.rendererId);
+		glTexSubImage2D(texture.getTextureType(), 0, chunk.x, chunk.y, chunk.width, chunk.height,
+			texture.channelsToPixelFormat(job.channels), GL_UNSIGNED_BYTE, reinterpret_cast<const void*>(offset));
+		return true;
+	}
+
+}
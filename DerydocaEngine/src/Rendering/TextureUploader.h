@@ -0,0 +1,124 @@
+#pragma once
+#include <deque>
+#include <memory>
+#include <vector>
+#include "Rendering\StagingRing.h"
+#include "Rendering\TextureUploads.h"
+
+namespace DerydocaEngine::Rendering
+{
+	class Texture;
+}
+
+namespace DerydocaEngine::Rendering
+{
+
+	/*
+	Copies pixels into textures through a staging ring of pixel buffers, a few chunks at a time,
+	so large uploads are spread over several frames instead of stalling one. Uploads are queued
+	from the render thread and copied into the ring at the start of each frame, within a budget of
+	bytes per frame. The driver then copies from the ring to the texture without blocking the CPU.
+	*/
+	class TextureUploader
+	{
+	public:
+		static TextureUploader& getInstance()
+		{
+			static TextureUploader instance;
+			return instance;
+		}
+
+		/* Counters of the uploads made through the ring */
+		struct Statistics
+		{
+			size_t uploadedBytes = 0;
+			size_t chunkCount = 0;
+			size_t uploadFrameCount = 0;
+			size_t lastFrameBytes = 0;
+			size_t peakFrameBytes = 0;
+			size_t pendingBytes = 0;
+			double stallTime = 0.0;
+			double peakStallTime = 0.0;
+		};
+
+		/*
+		Queues pixels to be copied into a region of a texture. The pixels are copied out of the
+		image straight away, so it can be changed or released once this returns. Must be called on
+		the render thread.
+
+		@param texture 2D texture to copy into, whose storage is already allocated
+		@param rect Region of the texture to copy into, which is also the region read from the image
+		@param image Pixels of the whole image
+		@param imageWidth Width of the image in pixels
+		@param channels Number of 8 bit channels per pixel
+		@param generateMipmaps Whether to rebuild the mip chain once the region is uploaded
+		*/
+		void upload(Texture& texture, TextureUploads::UploadRect const& rect, const uint8_t* image, int const& imageWidth, int const& channels, bool const& generateMipmaps);
+
+		/*
+		Drops any uploads queued for a texture, used when its storage is replaced.
+
+		@param texture Texture whose uploads to drop
+		*/
+		void cancel(Texture const& texture);
+
+		/*
+		Copies queued uploads into the ring until the frame's budget is spent. Must be called on the
+		render thread, once per frame, before anything is drawn.
+		*/
+		void update();
+
+		/*
+		Sets how many bytes may be uploaded each frame, which is also the size of each region of the ring.
+
+		@param bytes Upload budget of a frame in bytes
+		*/
+		void setUploadBudget(size_t const& bytes);
+		size_t getUploadBudget() const { return m_uploadBudget; }
+
+		Statistics getStatistics() const { return m_statistics; }
+
+		/* Prints how much was uploaded, the largest upload in a frame and how long the CPU waited on the GPU */
+		void printStatistics() const;
+
+		void operator=(TextureUploader const&) = delete;
+	private:
+		struct UploadJob
+		{
+			std::weak_ptr<Texture> texture;
+			const Texture* target;
+			unsigned int rendererId;
+			int channels;
+			bool generateMipmaps;
+			/* Width of the pixels, which are tightly packed rows of the whole upload */
+			int width;
+			std::vector<uint8_t> pixels;
+			TextureUploads::UploadRect rect;
+			std::vector<TextureUploads::UploadRect> chunks;
+			size_t nextChunk;
+		};
+
+		TextureUploader();
+		TextureUploader(TextureUploader const&);
+		~TextureUploader();
+
+		bool createRing();
+		size_t getChunkSize() const;
+
+		/*
+		Copies pixels straight from memory, for when the ring can not be used.
+
+		@param pixels First pixel of the region
+		@param rowLength Number of pixels from the start of one row to the next
+		*/
+		void uploadImmediately(Texture& texture, TextureUploads::UploadRect const& rect, const uint8_t* pixels, int const& rowLength, int const& channels, bool const& generateMipmaps);
+		bool uploadChunk(Texture& texture, UploadJob& job, TextureUploads::UploadRect const& chunk);
+
+		StagingRing m_ring;
+		bool m_ringFailed;
+		std::deque<UploadJob> m_jobs;
+		size_t m_uploadBudget;
+		Statistics m_statistics;
+	};
+
+}
@@ -0,0 +1,111 @@
+#include "EnginePch.h"
+#include "Rendering\TextureUploads.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace DerydocaEngine::Rendering::TextureUploads
+{
+
+	static bool isTileDirty(const uint8_t* previous, const uint8_t* current, int const& width, int const& channels, UploadRect const& tile)
+	{
+		size_t rowBytes = static_cast<size_t>(tile.width) * channels;
+		for (int y = tile.y; y < tile.y + tile.height; y++)
+		{
+			size_t offset = (static_cast<size_t>(y) * width + tile.x) * channels;
+			if (memcmp(previous + offset, current + offset, rowBytes) != 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void findDirtyRects(const uint8_t* previous, const uint8_t* current, int const& width, int const& height, int const& channels, int const& tileSize, std::vector<UploadRect>& rects)
+	{
+		rects.clear();
+		if (previous == nullptr || current == nullptr || width <= 0 || height <= 0 || tileSize <= 0)
+		{
+			return;
+		}
+
+		for (int tileY = 0; tileY < height; tileY += tileSize)
+		{
+			// Runs of changed tiles are merged, so a changed row of glyphs is a single upload
+			UploadRect run;
+			for (int tileX = 0; tileX < width; tileX += tileSize)
+			{
+				UploadRect tile;
+				tile.x = tileX;
+				tile.y = tileY;
+				tile.width = std::min(tileSize, width - tileX);
+				tile.height = std::min(tileSize, height - tileY);
+
+				if (!isTileDirty(previous, current, width, channels, tile))
+				{
+					if (run.width > 0)
+					{
+						rects.push_back(run);
+						run = UploadRect();
+					}
+					continue;
+				}
+
+				if (run.width == 0)
+				{
+					run = tile;
+				}
+				else
+				{
+					run.width += tile.width;
+				}
+			}
+
+			if (run.width > 0)
+			{
+				rects.push_back(run);
+			}
+		}
+	}
+
+	void splitIntoChunks(UploadRect const& rect, int const& channels, size_t const& maxChunkBytes, std::vector<UploadRect>& chunks)
+	{
+		chunks.clear();
+		if (rect.width <= 0 || rect.height <= 0 || channels <= 0)
+		{
+			return;
+		}
+
+		size_t rowBytes = static_cast<size_t>(rect.width) * channels;
+		if (rowBytes <= maxChunkBytes)
+		{
+			int rowsPerChunk = static_cast<int>(maxChunkBytes / rowBytes);
+			for (int y = 0; y < rect.height; y += rowsPerChunk)
+			{
+				UploadRect chunk;
+				chunk.x = rect.x;
+				chunk.y = rect.y + y;
+				chunk.width = rect.width;
+				chunk.height = std::min(rowsPerChunk, rect.height - y);
+				chunks.push_back(chunk);
+			}
+			return;
+		}
+
+		// A single row does not fit, so every row is split into columns
+		int columnsPerChunk = std::max(static_cast<int>(maxChunkBytes / channels), 1);
+		for (int y = 0; y < rect.height; y++)
+		{
+			for (int x = 0; x < rect.width; x += columnsPerChunk)
+			{
+				UploadRect chunk;
+				chunk.x = rect.x + x;
+				chunk.y = rect.y + y;
+				chunk.width = std::min(columnsPerChunk, rect.width - x);
+				chunk.height = 1;
+				chunks.push_back(chunk);
+			}
+		}
+	}
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace DerydocaEngine::Rendering
+{
+
+	/*
+	Splits texture uploads into pieces that can be spread over several frames, and finds the parts
+	of an image that changed so only those have to be uploaded again.
+	*/
+	namespace TextureUploads
+	{
+
+		/* Rectangle of pixels, with the origin at the first row of the image */
+		struct UploadRect
+		{
+			int x = 0;
+			int y = 0;
+			int width = 0;
+			int height = 0;
+		};
+
+		/*
+		Finds the parts of an image that differ from the previous version of it. The image is
+		compared in square tiles, and neighbouring changed tiles on the same row of tiles are merged
+		into a single rectangle.
+
+		@param previous Pixels the image had before
+		@param current Pixels the image has now, of the same size and channels
+		@param width Width of the image
+		@param height Height of the image
+		@param channels Number of 8 bit channels per pixel
+		@param tileSize Width and height of the tiles that are compared
+		@param rects Receives the changed rectangles
+		*/
+		void findDirtyRects(const uint8_t* previous, const uint8_t* current, int const& width, int const& height, int const& channels, int const& tileSize, std::vector<UploadRect>& rects);
+
+		/*
+		Splits a rectangle into chunks of whole rows that each fit in a number of bytes. Rows that
+		are larger than that on their own are split into columns.
+
+		@param rect Rectangle to split
+		@param channels Number of 8 bit channels per pixel
+		@param maxChunkBytes Largest size of a chunk in bytes
+		@param chunks Receives the chunks, in order from the first row
+		*/
+		void splitIntoChunks(UploadRect const& rect, int const& channels, size_t const& maxChunkBytes, std::vector<UploadRect>& chunks);
+
+	}
+
+}
@@ -0,0 +1,470 @@
+#include "EnginePch.h"
+#include "Rendering\VertexLayout.h"
+
+#include <cstring>
+#include <glm/gtc/packing.hpp>
+
+namespace DerydocaEngine::Rendering
+{
+
+	// Attribute locations bound by Shader::compileProgram
+	static const unsigned int POSITION_LOCATION = 0;
+	static const unsigned int TEXCOORD_LOCATION = 1;
+	static const unsigned int NORMAL_LOCATION = 2;
+	static const unsigned int TANGENT_LOCATION = 3;
+	static const unsigned int BITANGENT_LOCATION = 4;
+	static const unsigned int COLOR_LOCATION = 5;
+	static const unsigned int BONE_INDICES_LOCATION = 6;
+	static const unsigned int BONE_WEIGHTS_LOCATION = 7;
+
+	// Largest texture coordinate stored as a half float, below which its steps are at most 1/1024, about a texel of a 1024 texture
+	static const float MAX_HALF_TEXCOORD = 2.0f;
+
+	template<typename T>
+	static size_t countOf(std::vector<T> const* stream)
+	{
+		return stream == nullptr ? 0 : stream->size();
+	}
+
+	template<typename T>
+	static void write(uint8_t* destination, T const& value)
+	{
+		memcpy(destination, &value, sizeof(T));
+	}
+
+	VertexLayout VertexLayout::uncompressed()
+	{
+		return VertexLayout();
+	}
+
+	VertexLayout VertexLayout::selectForMesh(std::vector<glm::vec2> const& texCoords, size_t const& boneCount, bool const& octahedralNormals)
+	{
+		VertexLayout layout;
+		layout.normals = octahedralNormals ? NormalEncoding::Octahedral : NormalEncoding::Packed1010102;
+		layout.colors = ColorEncoding::Unorm8;
+		layout.boneWeights = BoneWeightEncoding::Unorm8;
+		layout.compactBoneIndices = boneCount <= 256;
+
+		// Use the most precise encoding the range of the texture coordinates allows
+		glm::vec2 minTexCoord(0.0f);
+		glm::vec2 maxTexCoord(0.0f);
+		if (texCoords.size() > 0)
+		{
+			minTexCoord = texCoords[0];
+			maxTexCoord = texCoords[0];
+			for (auto const& texCoord : texCoords)
+			{
+				minTexCoord = glm::min(minTexCoord, texCoord);
+				maxTexCoord = glm::max(maxTexCoord, texCoord);
+			}
+		}
+
+		if (minTexCoord.x >= 0.0f && minTexCoord.y >= 0.0f && maxTexCoord.x <= 1.0f && maxTexCoord.y <= 1.0f)
+		{
+			layout.texCoords = TexCoordEncoding::Unorm16;
+		}
+		else if (minTexCoord.x >= -MAX_HALF_TEXCOORD && minTexCoord.y >= -MAX_HALF_TEXCOORD && maxTexCoord.x <= MAX_HALF_TEXCOORD && maxTexCoord.y <= MAX_HALF_TEXCOORD)
+		{
+			layout.texCoords = TexCoordEncoding::HalfFloat;
+		}
+		else
+		{
+			layout.texCoords = TexCoordEncoding::Float;
+		}
+
+		return layout;
+	}
+
+	std::vector<std::string> const& VertexLayout::getShaderKeywords() const
+	{
+		static const std::vector<std::string> noKeywords;
+		static const std::vector<std::string> octahedralKeywords = { "OCTAHEDRAL_NORMALS" };
+		return normals == NormalEncoding::Octahedral ? octahedralKeywords : noKeywords;
+	}
+
+	std::string VertexLayout::getName() const
+	{
+		std::string name;
+
+		switch (normals)
+		{
+		case NormalEncoding::Packed1010102:
+			name += "n:1010102";
+			break;
+		case NormalEncoding::Octahedral:
+			name += "n:oct16";
+			break;
+		default:
+			name += "n:f32";
+			break;
+		}
+
+		switch (texCoords)
+		{
+		case TexCoordEncoding::HalfFloat:
+			name += " uv:f16";
+			break;
+		case TexCoordEncoding::Unorm16:
+			name += " uv:unorm16";
+			break;
+		default:
+			name += " uv:f32";
+			break;
+		}
+
+		name += colors == ColorEncoding::Unorm8 ? " c:unorm8" : " c:f32";
+
+		switch (boneWeights)
+		{
+		case BoneWeightEncoding::Unorm16:
+			name += " w:unorm16";
+			break;
+		case BoneWeightEncoding::Unorm8:
+			name += " w:unorm8";
+			break;
+		default:
+			name += " w:f32";
+			break;
+		}
+
+		name += compactBoneIndices ? " i:u8" : " i:u32";
+
+		return name;
+	}
+
+	bool VertexLayout::operator==(VertexLayout const& other) const
+	{
+		return normals == other.normals &&
+			texCoords == other.texCoords &&
+			colors == other.colors &&
+			boneWeights == other.boneWeights &&
+			compactBoneIndices == other.compactBoneIndices;
+	}
+
+	namespace VertexPacking
+	{
+
+		glm::vec2 encodeOctahedral(glm::vec3 const& normal)
+		{
+			glm::vec3 n = normal / (glm::abs(normal.x) + glm::abs(normal.y) + glm::abs(normal.z));
+			glm::vec2 encoded(n.x, n.y);
+
+			// Fold the lower hemisphere over the diagonals
+			if (n.z < 0.0f)
+			{
+				encoded.x = (1.0f - glm::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f);
+				encoded.y = (1.0f - glm::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f);
+			}
+
+			return encoded;
+		}
+
+		glm::vec3 decodeOctahedral(glm::vec2 const& encoded)
+		{
+			glm::vec3 n(encoded.x, encoded.y, 1.0f - glm::abs(encoded.x) - glm::abs(encoded.y));
+			float t = glm::max(-n.z, 0.0f);
+			n.x += n.x >= 0.0f ? -t : t;
+			n.y += n.y >= 0.0f ? -t : t;
+			return glm::normalize(n);
+		}
+
+		float calculateBitangentSign(glm::vec3 const& normal, glm::vec3 const& tangent, glm::vec3 const& bitangent)
+		{
+			return glm::dot(glm::cross(normal, tangent), bitangent) < 0.0f ? -1.0f : 1.0f;
+		}
+
+		std::array<uint32_t, Animation::MAX_BONES> quantizeBoneWeights(std::array<float, Animation::MAX_BONES> const& weights, uint32_t const& maxValue)
+		{
+			std::array<uint32_t, Animation::MAX_BONES> quantized;
+			quantized.fill(0);
+
+			float totalWeight = 0.0f;
+			for (auto const& weight : weights)
+			{
+				totalWeight += glm::max(weight, 0.0f);
+			}
+
+			if (totalWeight <= 0.0f)
+			{
+				return quantized;
+			}
+
+			// Round each normalized weight and remember the largest one
+			int64_t remainder = maxValue;
+			int largestIndex = 0;
+			for (int i = 0; i < Animation::MAX_BONES; i++)
+			{
+				float normalizedWeight = glm::max(weights[i], 0.0f) / totalWeight;
+				quantized[i] = static_cast<uint32_t>(normalizedWeight * maxValue + 0.5f);
+				remainder -= quantized[i];
+				if (weights[i] > weights[largestIndex])
+				{
+					largestIndex = i;
+				}
+			}
+
+			// The largest weight absorbs the rounding error since it changes it the least relatively
+			quantized[largestIndex] = static_cast<uint32_t>(quantized[largestIndex] + remainder);
+
+			return quantized;
+		}
+
+	}
+
+	VertexBufferBuilder::VertexBufferBuilder(VertexLayout const& layout, VertexStreams const& streams) :
+		m_layout(layout),
+		m_streams(streams),
+		m_attributes(),
+		m_stride(0),
+		m_uncompressedStride(0),
+		m_vertexCount(countOf(streams.positions))
+	{
+		// Only encode attributes that have data for every vertex
+		auto hasStream = [this](size_t const& count) { return count > 0 && count == m_vertexCount; };
+
+		if (hasStream(countOf(m_streams.positions)))
+		{
+			addAttribute(POSITION_LOCATION, 3, VertexAttributeType::Float, false, false, sizeof(glm::vec3));
+			m_uncompressedStride += sizeof(glm::vec3);
+		}
+
+		bool hasNormals = hasStream(countOf(m_streams.normals));
+		if (hasNormals)
+		{
+			switch (m_layout.normals)
+			{
+			case NormalEncoding::Packed1010102:
+				addAttribute(NORMAL_LOCATION, 4, VertexAttributeType::Int2101010Rev, true, false, sizeof(uint32_t));
+				break;
+			case NormalEncoding::Octahedral:
+				addAttribute(NORMAL_LOCATION, 2, VertexAttributeType::Short, true, false, sizeof(int16_t) * 2);
+				break;
+			default:
+				addAttribute(NORMAL_LOCATION, 3, VertexAttributeType::Float, false, false, sizeof(glm::vec3));
+				break;
+			}
+			m_uncompressedStride += sizeof(glm::vec3);
+		}
+
+		if (hasStream(countOf(m_streams.tangents)))
+		{
+			// The handedness of the tangent frame is stored in w
+			if (m_layout.normals == NormalEncoding::Float)
+			{
+				addAttribute(TANGENT_LOCATION, 4, VertexAttributeType::Float, false, false, sizeof(glm::vec4));
+			}
+			else
+			{
+				addAttribute(TANGENT_LOCATION, 4, VertexAttributeType::Int2101010Rev, true, false, sizeof(uint32_t));
+			}
+			m_uncompressedStride += sizeof(glm::vec3);
+		}
+
+		if (hasStream(countOf(m_streams.bitangents)))
+		{
+			// Compressed layouts rebuild the bitangent from cross(normal, tangent) * tangent.w
+			if (!m_layout.reconstructsBitangents() || !hasNormals)
+			{
+				addAttribute(BITANGENT_LOCATION, 3, VertexAttributeType::Float, false, false, sizeof(glm::vec3));
+			}
+			m_uncompressedStride += sizeof(glm::vec3);
+		}
+
+		if (hasStream(countOf(m_streams.texCoords)))
+		{
+			switch (m_layout.texCoords)
+			{
+			case TexCoordEncoding::HalfFloat:
+				addAttribute(TEXCOORD_LOCATION, 2, VertexAttributeType::HalfFloat, false, false, sizeof(uint16_t) * 2);
+				break;
+			case TexCoordEncoding::Unorm16:
+				addAttribute(TEXCOORD_LOCATION, 2, VertexAttributeType::UnsignedShort, true, false, sizeof(uint16_t) * 2);
+				break;
+			default:
+				addAttribute(TEXCOORD_LOCATION, 2, VertexAttributeType::Float, false, false, sizeof(glm::vec2));
+				break;
+			}
+			m_uncompressedStride += sizeof(glm::vec2);
+		}
+
+		if (hasStream(countOf(m_streams.colors)))
+		{
+			if (m_layout.colors == ColorEncoding::Unorm8)
+			{
+				addAttribute(COLOR_LOCATION, 4, VertexAttributeType::UnsignedByte, true, false, sizeof(uint8_t) * 4);
+			}
+			else
+			{
+				addAttribute(COLOR_LOCATION, 4, VertexAttributeType::Float, false, false, sizeof(Color));
+			}
+			m_uncompressedStride += sizeof(Color);
+		}
+
+		if (hasStream(countOf(m_streams.boneWeights)))
+		{
+			if (m_layout.compactBoneIndices)
+			{
+				addAttribute(BONE_INDICES_LOCATION, Animation::MAX_BONES, VertexAttributeType::UnsignedByte, false, true, sizeof(uint8_t) * Animation::MAX_BONES);
+			}
+			else
+			{
+				addAttribute(BONE_INDICES_LOCATION, Animation::MAX_BONES, VertexAttributeType::UnsignedInt, false, true, sizeof(uint32_t) * Animation::MAX_BONES);
+			}
+
+			switch (m_layout.boneWeights)
+			{
+			case BoneWeightEncoding::Unorm16:
+				addAttribute(BONE_WEIGHTS_LOCATION, Animation::MAX_BONES, VertexAttributeType::UnsignedShort, true, false, sizeof(uint16_t) * Animation::MAX_BONES);
+				break;
+			case BoneWeightEncoding::Unorm8:
+				addAttribute(BONE_WEIGHTS_LOCATION, Animation::MAX_BONES, VertexAttributeType::UnsignedByte, true, false, sizeof(uint8_t) * Animation::MAX_BONES);
+				break;
+			default:
+				addAttribute(BONE_WEIGHTS_LOCATION, Animation::MAX_BONES, VertexAttributeType::Float, false, false, sizeof(float) * Animation::MAX_BONES);
+				break;
+			}
+			m_uncompressedStride += sizeof(Animation::VertexBoneWeights);
+		}
+	}
+
+	void VertexBufferBuilder::addAttribute(unsigned int const& location, int const& components, VertexAttributeType const& type, bool const& normalized, bool const& integer, size_t const& size)
+	{
+		m_attributes.push_back({ location, components, type, normalized, integer, m_stride });
+		m_stride += size;
+	}
+
+	void VertexBufferBuilder::build(std::vector<uint8_t>& buffer) const
+	{
+		buffer.assign(m_stride * m_vertexCount, 0);
+
+		for (size_t v = 0; v < m_vertexCount; v++)
+		{
+			uint8_t* vertex = buffer.data() + v * m_stride;
+
+			for (auto const& attribute : m_attributes)
+			{
+				uint8_t* destination = vertex + attribute.offset;
+
+				switch (attribute.location)
+				{
+				case POSITION_LOCATION:
+					write(destination, (*m_streams.positions)[v]);
+					break;
+				case NORMAL_LOCATION:
+				{
+					glm::vec3 normal = (*m_streams.normals)[v];
+					if (m_layout.normals == NormalEncoding::Packed1010102)
+					{
+						write(destination, glm::packSnorm3x10_1x2(glm::vec4(normal, 0.0f)));
+					}
+					else if (m_layout.normals == NormalEncoding::Octahedral)
+					{
+						write(destination, glm::packSnorm2x16(VertexPacking::encodeOctahedral(normal)));
+					}
+					else
+					{
+						write(destination, normal);
+					}
+					break;
+				}
+				case TANGENT_LOCATION:
+				{
+					glm::vec3 tangent = (*m_streams.tangents)[v];
+					float sign = 1.0f;
+					if (countOf(m_streams.normals) == m_vertexCount && countOf(m_streams.bitangents) == m_vertexCount)
+					{
+						sign = VertexPacking::calculateBitangentSign((*m_streams.normals)[v], tangent, (*m_streams.bitangents)[v]);
+					}
+
+					if (attribute.type == VertexAttributeType::Float)
+					{
+						write(destination, glm::vec4(tangent, sign));
+					}
+					else
+					{
+						write(destination, glm::packSnorm3x10_1x2(glm::vec4(tangent, sign)));
+					}
+					break;
+				}
+				case BITANGENT_LOCATION:
+					write(destination, (*m_streams.bitangents)[v]);
+					break;
+				case TEXCOORD_LOCATION:
+				{
+					glm::vec2 texCoord = (*m_streams.texCoords)[v];
+					if (attribute.type == VertexAttributeType::HalfFloat)
+					{
+						write(destination, glm::packHalf2x16(texCoord));
+					}
+					else if (attribute.type == VertexAttributeType::UnsignedShort)
+					{
+						write(destination, glm::packUnorm2x16(texCoord));
+					}
+					else
+					{
+						write(destination, texCoord);
+					}
+					break;
+				}
+				case COLOR_LOCATION:
+				{
+					Color color = (*m_streams.colors)[v];
+					if (attribute.type == VertexAttributeType::UnsignedByte)
+					{
+						write(destination, glm::packUnorm4x8(glm::vec4(color.r, color.g, color.b, color.a)));
+					}
+					else
+					{
+						write(destination, color);
+					}
+					break;
+				}
+				case BONE_INDICES_LOCATION:
+				{
+					auto const& boneIds = (*m_streams.boneWeights)[v].boneIds;
+					for (int i = 0; i < Animation::MAX_BONES; i++)
+					{
+						if (attribute.type == VertexAttributeType::UnsignedByte)
+						{
+							destination[i] = static_cast<uint8_t>(boneIds[i]);
+						}
+						else
+						{
+							write(destination + i * sizeof(uint32_t), static_cast<uint32_t>(boneIds[i]));
+						}
+					}
+					break;
+				}
+				case BONE_WEIGHTS_LOCATION:
+				{
+					auto const& weights = (*m_streams.boneWeights)[v].weights;
+					if (attribute.type == VertexAttributeType::UnsignedShort)
+					{
+						auto quantized = VertexPacking::quantizeBoneWeights(weights, 0xFFFF);
+						for (int i = 0; i < Animation::MAX_BONES; i++)
+						{
+							write(destination + i * sizeof(uint16_t), static_cast<uint16_t>(quantized[i]));
+						}
+					}
+					else if (attribute.type == VertexAttributeType::UnsignedByte)
+					{
+						auto quantized = VertexPacking::quantizeBoneWeights(weights, 0xFF);
+						for (int i = 0; i < Animation::MAX_BONES; i++)
+						{
+							destination[i] = static_cast<uint8_t>(quantized[i]);
+						}
+					}
+					else
+					{
+						write(destination, weights);
+					}
+					break;
+				}
+				default:
+					break;
+				}
+			}
+		}
+	}
+
+}
@@ -0,0 +1,212 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include "Animation\VertexBoneWeights.h"
+#include "Color.h"
+
+namespace DerydocaEngine::Rendering
+{
+
+	/* How normals and tangents are stored in the vertex buffer */
+	enum class NormalEncoding
+	{
+		/* Three 32 bit floats */
+		Float,
+		/* Signed normalized 10:10:10:2, read by shaders as a regular vec3/vec4 */
+		Packed1010102,
+		/* Two signed normalized 16 bit octahedral coordinates, read through include/vertexDecode.glsl. Tangents use 10:10:10:2. */
+		Octahedral
+	};
+
+	/* How texture coordinates are stored in the vertex buffer */
+	enum class TexCoordEncoding
+	{
+		Float,
+		HalfFloat,
+		/* Unsigned normalized 16 bit, only valid for coordinates in the 0 to 1 range */
+		Unorm16
+	};
+
+	/* How vertex colors are stored in the vertex buffer */
+	enum class ColorEncoding
+	{
+		Float,
+		Unorm8
+	};
+
+	/* How bone weights are stored in the vertex buffer */
+	enum class BoneWeightEncoding
+	{
+		Float,
+		Unorm16,
+		Unorm8
+	};
+
+	/* Data type of a single vertex attribute component */
+	enum class VertexAttributeType
+	{
+		Float,
+		HalfFloat,
+		Byte,
+		UnsignedByte,
+		Short,
+		UnsignedShort,
+		UnsignedInt,
+		Int2101010Rev
+	};
+
+	/* Describes where a vertex attribute lives within an interleaved vertex */
+	struct VertexAttribute
+	{
+		/* Location the attribute is bound to in the shader */
+		unsigned int location;
+		/* Number of components in the attribute */
+		int components;
+		VertexAttributeType type;
+		/* Whether integer data is normalized to the 0 to 1 or -1 to 1 range */
+		bool normalized;
+		/* Whether the attribute is read by the shader as an integer */
+		bool integer;
+		/* Byte offset of the attribute from the start of the vertex */
+		size_t offset;
+	};
+
+	/*
+	Describes how the attributes of a mesh are compressed and interleaved into a single vertex buffer.
+	*/
+	struct VertexLayout
+	{
+		NormalEncoding normals = NormalEncoding::Float;
+		TexCoordEncoding texCoords = TexCoordEncoding::Float;
+		ColorEncoding colors = ColorEncoding::Float;
+		BoneWeightEncoding boneWeights = BoneWeightEncoding::Float;
+		/* Stores bone indices as 8 bit integers, only valid for skeletons with 256 bones or less */
+		bool compactBoneIndices = false;
+
+		/* Layout where every attribute is stored as full precision floats */
+		static VertexLayout uncompressed();
+
+		/*
+		Picks the smallest layout that can represent a mesh without visible loss of precision.
+
+		@param texCoords Texture coordinates of the mesh
+		@param boneCount Number of bones in the mesh's skeleton, zero if it is not skinned
+		@param octahedralNormals Stores normals as octahedral coordinates, for meshes drawn with shaders that decode them
+
+		@return The layout to use for the mesh
+		*/
+		static VertexLayout selectForMesh(std::vector<glm::vec2> const& texCoords, size_t const& boneCount, bool const& octahedralNormals = false);
+
+		/* Gets whether bitangents are dropped and rebuilt in the shader from the normal, tangent and the sign in the tangent's w */
+		bool reconstructsBitangents() const { return normals != NormalEncoding::Float; }
+
+		/*
+		Gets the shader keywords that make include/vertexDecode.glsl read vertices of this layout.
+		Layouts with the same keywords return the same list, so renderers can tell a change by its address.
+		*/
+		std::vector<std::string> const& getShaderKeywords() const;
+
+		/* Gets a short description of the layout, such as "n:1010102 uv:unorm16 c:unorm8 w:unorm8 i:u8" */
+		std::string getName() const;
+
+		bool operator==(VertexLayout const& other) const;
+		bool operator!=(VertexLayout const& other) const { return !(*this == other); }
+	};
+
+	/* The source data of every vertex attribute of a mesh, empty vectors for attributes that are not present */
+	struct VertexStreams
+	{
+		std::vector<glm::vec3> const* positions;
+		std::vector<glm::vec3> const* normals;
+		std::vector<glm::vec2> const* texCoords;
+		std::vector<glm::vec3> const* tangents;
+		std::vector<glm::vec3> const* bitangents;
+		std::vector<Color> const* colors;
+		std::vector<Animation::VertexBoneWeights> const* boneWeights;
+	};
+
+	namespace VertexPacking
+	{
+
+		/*
+		Maps a unit vector onto the octahedron and unfolds it to a square.
+
+		@param normal Normalized vector
+		@return Coordinates in the -1 to 1 range
+		*/
+		glm::vec2 encodeOctahedral(glm::vec3 const& normal);
+
+		/*
+		Restores a unit vector from its octahedral coordinates.
+
+		@param encoded Coordinates in the -1 to 1 range
+		@return Normalized vector
+		*/
+		glm::vec3 decodeOctahedral(glm::vec2 const& encoded);
+
+		/*
+		Calculates the handedness of a tangent frame.
+
+		@return 1 if the bitangent matches cross(normal, tangent), otherwise -1
+		*/
+		float calculateBitangentSign(glm::vec3 const& normal, glm::vec3 const& tangent, glm::vec3 const& bitangent);
+
+		/*
+		Quantizes bone weights to integers while keeping their sum exactly at the maximum value, so
+		skinned vertices do not drift from rounding.
+
+		@param weights Weights of each bone influencing the vertex
+		@param maxValue Value that represents a weight of 1
+		@return The quantized weights
+		*/
+		std::array<uint32_t, Animation::MAX_BONES> quantizeBoneWeights(std::array<float, Animation::MAX_BONES> const& weights, uint32_t const& maxValue);
+
+	}
+
+	/*
+	Builds an interleaved vertex buffer from separate attribute streams.
+	*/
+	class VertexBufferBuilder
+	{
+	public:
+		/*
+		@param layout Layout the vertices are encoded with
+		@param streams Source data of each attribute
+		*/
+		VertexBufferBuilder(VertexLayout const& layout, VertexStreams const& streams);
+
+		/* Gets the attributes in the buffer, in the order they appear within a vertex */
+		std::vector<VertexAttribute> const& getAttributes() const { return m_attributes; }
+
+		/* Gets the size of a single vertex in bytes */
+		size_t getStride() const { return m_stride; }
+
+		/* Gets the size of a single vertex in bytes if every present attribute was stored as full precision floats */
+		size_t getUncompressedStride() const { return m_uncompressedStride; }
+
+		size_t getVertexCount() const { return m_vertexCount; }
+
+		/*
+		Encodes every vertex into a buffer.
+
+		@param buffer Receives the interleaved vertex data
+		*/
+		void build(std::vector<uint8_t>& buffer) const;
+	private:
+		void addAttribute(unsigned int const& location, int const& components, VertexAttributeType const& type, bool const& normalized, bool const& integer, size_t const& size);
+
+		VertexLayout m_layout;
+		VertexStreams m_streams;
+		std::vector<VertexAttribute> m_attributes;
+		size_t m_stride;
+		size_t m_uncompressedStride;
+		size_t m_vertexCount;
+	};
+
+}
@@ -10,13 +10,45 @@ namespace DerydocaEngine::Resources
 		REGISTER_TYPE_ID(AnimationResource);
 
 		AnimationResource() :
-			m_name()
+			m_name(),
+			m_compress(true),
+			m_compressionTolerance(0.001f),
+			m_poseCache(false),
+			m_poseCacheRate(30.0f),
+			m_poseCacheKilobytes(4096),
+			m_poseCacheMinRate(10.0f),
+			m_poseCacheInterpolate(true)
 		{}
 
 		void setName(std::string const& animationName) { m_name = animationName; }
 		std::string getName() { return m_name; }
+		bool getCompress() const { return m_compress; }
+		void setCompress(bool const& compress) { m_compress = compress; }
+		float getCompressionTolerance() const { return m_compressionTolerance; }
+		void setCompressionTolerance(float const& compressionTolerance) { m_compressionTolerance = compressionTolerance; }
+		bool getPoseCache() const { return m_poseCache; }
+		void setPoseCache(bool const& poseCache) { m_poseCache = poseCache; }
+		float getPoseCacheRate() const { return m_poseCacheRate; }
+		void setPoseCacheRate(float const& poseCacheRate) { m_poseCacheRate = poseCacheRate; }
+		size_t getPoseCacheKilobytes() const { return m_poseCacheKilobytes; }
+		void setPoseCacheKilobytes(size_t const& poseCacheKilobytes) { m_poseCacheKilobytes = poseCacheKilobytes; }
+		float getPoseCacheMinRate() const { return m_poseCacheMinRate; }
+		void setPoseCacheMinRate(float const& poseCacheMinRate) { m_poseCacheMinRate = poseCacheMinRate; }
+		bool getPoseCacheInterpolate() const { return m_poseCacheInterpolate; }
+		void setPoseCacheInterpolate(bool const& poseCacheInterpolate) { m_poseCacheInterpolate = poseCacheInterpolate; }
 	private:
 		std::string m_name;
+		bool m_compress;
+		// Largest distance compression may move a point near the skin, in model units
+		float m_compressionTolerance;
+		// Bake the animation's palettes into a table shared by every instance, at a rate in poses per second and up to a size
+		bool m_poseCache;
+		float m_poseCacheRate;
+		size_t m_poseCacheKilobytes;
+		// Rate the size limit may lower the table to before the animation is sampled live instead
+		float m_poseCacheMinRate;
+		// Blend the poses around the playhead instead of taking the one before it
+		bool m_poseCacheInterpolate;
 	};
 
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "Resources\Resource.h"
+#include "Rendering\TextureCompression.h"
 
 namespace DerydocaEngine::Resources
 {
@@ -10,7 +11,9 @@ namespace DerydocaEngine::Resources
 		REGISTER_TYPE_ID(CubemapResource);
 
 		CubemapResource() :
-			m_slot(0)
+			m_slot(0),
+			m_compression(Rendering::TextureCompressionFormat::None),
+			m_compressionQuality(Rendering::TextureCompressionQuality::Normal)
 		{
 			setType(Resources::CubemapResourceType);
 		}
@@ -19,8 +22,16 @@ namespace DerydocaEngine::Resources
 		void setSlot(unsigned int const& slot) { m_slot = slot; }
 
 		unsigned int getSlot() { return m_slot; }
+
+		/* Gets the block compressed format the faces are cooked to, or None to decode them every load */
+		Rendering::TextureCompressionFormat getCompression() const { return m_compression; }
+		void setCompression(Rendering::TextureCompressionFormat const& compression) { m_compression = compression; }
+		Rendering::TextureCompressionQuality getCompressionQuality() const { return m_compressionQuality; }
+		void setCompressionQuality(Rendering::TextureCompressionQuality const& quality) { m_compressionQuality = quality; }
 	private:
 		unsigned int m_slot;
+		Rendering::TextureCompressionFormat m_compression;
+		Rendering::TextureCompressionQuality m_compressionQuality;
 	};
 
 }
@@ -0,0 +1,223 @@
+#include "EnginePch.h"
+#include "Resources\MeshCooker.h"
+
+#include <boost/uuid/uuid_io.hpp>
+#include "Helpers\HashUtils.h"
+
+namespace DerydocaEngine::Resources
+{
+
+	MeshCooker::MeshCooker() :
+		m_cacheDirectory(),
+		m_cookedLoadCount(0),
+		m_importCount(0),
+		m_cookedLoadTime(0.0),
+		m_importTime(0.0)
+	{
+	}
+
+	MeshCooker::~MeshCooker()
+	{
+	}
+
+	uint64_t MeshCooker::calculateSettingsHash(std::shared_ptr<MeshResource> const& resource, std::shared_ptr<Animation::Skeleton> const& skeleton) const
+	{
+		uint64_t hash = HASH_SEED;
+		hash = hashBytes(hash, &Rendering::CookedMesh::FORMAT_VERSION, sizeof(Rendering::CookedMesh::FORMAT_VERSION));
+		hash = hashString(hash, resource->getMeshName());
+
+		uint32_t meshIndex = resource->getMeshIndex();
+		uint32_t flags = static_cast<uint32_t>(resource->getFlags());
+		uint8_t compressVertices = resource->getCompressVertices() ? 1 : 0;
+		uint8_t octahedralNormals = resource->getOctahedralNormals() ? 1 : 0;
+		hash = hashBytes(hash, &meshIndex, sizeof(meshIndex));
+		hash = hashBytes(hash, &flags, sizeof(flags));
+		hash = hashBytes(hash, &compressVertices, sizeof(compressVertices));
+		hash = hashBytes(hash, &octahedralNormals, sizeof(octahedralNormals));
+
+		// The bone count decides whether bone indices fit in a byte
+		hash = hashString(hash, resource->hasSkeleton() ? boost::uuids::to_string(resource->getSkeletonId()) : std::string());
+		uint64_t boneCount = skeleton ? skeleton->getNumBones() : 0;
+		hash = hashBytes(hash, &boneCount, sizeof(boneCount));
+
+		return hash;
+	}
+
+	bool MeshCooker::load(std::shared_ptr<MeshResource> const& resource, uint64_t const& settingsHash, std::shared_ptr<Animation::Skeleton> const& skeleton, Files::MappedFile& file, Rendering::PackedMeshData& mesh)
+	{
+		if (m_cacheDirectory.empty())
+		{
+			return false;
+		}
+
+		std::string cookedFilePath = getCookedFilePath(resource);
+		if (!file.open(cookedFilePath))
+		{
+			return false;
+		}
+
+		Rendering::CookedMeshSource cookedSource;
+		std::vector<Rendering::CookedBoneBinding> boneBindings;
+		if (!Rendering::CookedMesh::read(file.getData(), file.getSize(), cookedSource, mesh, boneBindings) ||
+			cookedSource.settingsHash != settingsHash)
+		{
+			file.close();
+			return false;
+		}
+
+		// Bone indices are baked into the vertices, so the skeleton must still use the same ids
+		for (auto const& binding : boneBindings)
+		{
+			if (!skeleton || skeleton->getBoneID(binding.name) != binding.boneId)
+			{
+				file.close();
+				return false;
+			}
+		}
+
+		Rendering::CookedMeshSource currentSource;
+		if (!getSourceStamp(resource->getSourceFilePath(), currentSource))
+		{
+			file.close();
+			return false;
+		}
+
+		if (currentSource.sourceSize == cookedSource.sourceSize && currentSource.sourceWriteTime == cookedSource.sourceWriteTime)
+		{
+			return true;
+		}
+
+		// The file was touched, only hash it when its size and time no longer match
+		if (!hashSourceFile(resource->getSourceFilePath(), currentSource.sourceHash) ||
+			currentSource.sourceHash != cookedSource.sourceHash)
+		{
+			file.close();
+			return false;
+		}
+
+		// Same contents, so store the new stamp to skip hashing next time. The mapping has to be
+		// released before the file can be replaced.
+		currentSource.settingsHash = settingsHash;
+		std::vector<uint8_t> contents(file.getData(), file.getData() + file.getSize());
+		file.close();
+		Rendering::CookedMesh::updateSource(contents, currentSource);
+		writeFile(cookedFilePath, contents);
+
+		return file.open(cookedFilePath) &&
+			Rendering::CookedMesh::read(file.getData(), file.getSize(), cookedSource, mesh, boneBindings);
+	}
+
+	void MeshCooker::save(std::shared_ptr<MeshResource> const& resource, uint64_t const& settingsHash, Rendering::PackedMeshData const& mesh, std::vector<Rendering::CookedBoneBinding> const& boneBindings)
+	{
+		if (m_cacheDirectory.empty())
+		{
+			return;
+		}
+
+		Rendering::CookedMeshSource source;
+		if (!getSourceStamp(resource->getSourceFilePath(), source) ||
+			!hashSourceFile(resource->getSourceFilePath(), source.sourceHash))
+		{
+			return;
+		}
+		source.settingsHash = settingsHash;
+
+		std::vector<uint8_t> contents;
+		Rendering::CookedMesh::write(contents, source, mesh, boneBindings);
+
+		boost::system::error_code error;
+		boost::filesystem::create_directories(m_cacheDirectory, error);
+
+		if (!writeFile(getCookedFilePath(resource), contents))
+		{
+			std::cout << "Unable to write cooked mesh for: " << resource->getSourceFilePath() << " (" << resource->getMeshName() << ")\n";
+		}
+	}
+
+	void MeshCooker::recordLoadTime(double const& milliseconds, bool const& fromCookedMesh)
+	{
+		if (fromCookedMesh)
+		{
+			m_cookedLoadCount++;
+			m_cookedLoadTime += milliseconds;
+		}
+		else
+		{
+			m_importCount++;
+			m_importTime += milliseconds;
+		}
+	}
+
+	void MeshCooker::printStatistics() const
+	{
+		printf("Loaded %d meshes in %.2fms (%d from cooked meshes in %.2fms, %.2fms each; %d imported from source in %.2fms, %.2fms each)\n",
+			m_cookedLoadCount + m_importCount,
+			m_cookedLoadTime + m_importTime,
+			m_cookedLoadCount,
+			m_cookedLoadTime,
+			m_cookedLoadCount > 0 ? m_cookedLoadTime / m_cookedLoadCount : 0.0,
+			m_importCount,
+			m_importTime,
+			m_importCount > 0 ? m_importTime / m_importCount : 0.0);
+	}
+
+	std::string MeshCooker::getCookedFilePath(std::shared_ptr<MeshResource> const& resource) const
+	{
+		return (boost::filesystem::path(m_cacheDirectory) / (boost::uuids::to_string(resource->getId()) + ".derymesh")).string();
+	}
+
+	bool MeshCooker::getSourceStamp(std::string const& sourceFilePath, Rendering::CookedMeshSource& source) const
+	{
+		boost::system::error_code error;
+		uintmax_t size = boost::filesystem::file_size(sourceFilePath, error);
+		if (error)
+		{
+			return false;
+		}
+
+		std::time_t writeTime = boost::filesystem::last_write_time(sourceFilePath, error);
+		if (error)
+		{
+			return false;
+		}
+
+		source.sourceSize = static_cast<uint64_t>(size);
+		source.sourceWriteTime = static_cast<int64_t>(writeTime);
+		return true;
+	}
+
+	bool MeshCooker::hashSourceFile(std::string const& sourceFilePath, uint64_t& hash) const
+	{
+		Files::MappedFile sourceFile;
+		if (!sourceFile.open(sourceFilePath))
+		{
+			return false;
+		}
+
+		hash = hashBytes(HASH_SEED, sourceFile.getData(), sourceFile.getSize());
+		return true;
+	}
+
+	bool MeshCooker::writeFile(std::string const& filePath, std::vector<uint8_t> const& contents) const
+	{
+		// Write next to the destination and swap it in, so a cooked mesh is never seen half written
+		std::string temporaryFilePath = filePath + ".tmp";
+		{
+			std::ofstream file(temporaryFilePath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+			{
+				return false;
+			}
+			file.write(reinterpret_cast<const char*>(contents.data()), contents.size());
+			if (!file.good())
+			{
+				return false;
+			}
+		}
+
+		boost::system::error_code error;
+		boost::filesystem::rename(temporaryFilePath, filePath, error);
+		return !error;
+	}
+
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Animation\Skeleton.h"
+#include "Files\MappedFile.h"
+#include "Rendering\CookedMesh.h"
+#include "Resources\MeshResource.h"
+
+namespace DerydocaEngine::Resources
+{
+
+	/*
+	Keeps imported meshes on disk in the .derymesh format so they can be memory mapped and
+	uploaded as they are, instead of being imported from their source file every load. A cooked
+	mesh is rebuilt whenever the contents of its source file or its import settings change.
+	*/
+	class MeshCooker
+	{
+	public:
+		static MeshCooker& getInstance()
+		{
+			static MeshCooker instance;
+			return instance;
+		}
+
+		/*
+		Sets the directory cooked meshes are stored in. Cooking is disabled when the directory is empty.
+
+		@param directory Directory to store cooked meshes in
+		*/
+		void setCacheDirectory(std::string const& directory) { m_cacheDirectory = directory; }
+		std::string getCacheDirectory() const { return m_cacheDirectory; }
+
+		/*
+		Calculates the hash of every setting that affects how a mesh is imported.
+
+		@param resource Resource describing the mesh
+		@param skeleton Skeleton the mesh is bound to, if any
+
+		@return Hash of the import settings
+		*/
+		uint64_t calculateSettingsHash(std::shared_ptr<MeshResource> const& resource, std::shared_ptr<Animation::Skeleton> const& skeleton) const;
+
+		/*
+		Maps the cooked copy of a mesh if it is still up to date.
+
+		@param resource Resource describing the mesh
+		@param settingsHash Hash of the current import settings
+		@param skeleton Skeleton the mesh is bound to, if any
+		@param file Receives the mapping, which must outlive any use of the mesh data
+		@param mesh Receives the geometry of the mesh, pointing into the mapping
+
+		@return True if an up to date cooked mesh was found
+		*/
+		bool load(std::shared_ptr<MeshResource> const& resource, uint64_t const& settingsHash, std::shared_ptr<Animation::Skeleton> const& skeleton, Files::MappedFile& file, Rendering::PackedMeshData& mesh);
+
+		/*
+		Writes the cooked copy of a mesh.
+
+		@param resource Resource describing the mesh
+		@param settingsHash Hash of the import settings the mesh was built with
+		@param mesh Geometry of the mesh
+		@param boneBindings Bones referenced by the mesh's vertices
+		*/
+		void save(std::shared_ptr<MeshResource> const& resource, uint64_t const& settingsHash, Rendering::PackedMeshData const& mesh, std::vector<Rendering::CookedBoneBinding> const& boneBindings);
+
+		/*
+		Records how long it took to load a mesh.
+
+		@param milliseconds Time spent loading the mesh
+		@param fromCookedMesh Whether the mesh was loaded from its cooked copy
+		*/
+		void recordLoadTime(double const& milliseconds, bool const& fromCookedMesh);
+
+		/*
+		Prints how many meshes were loaded from cooked copies and how long each kind of load took.
+		*/
+		void printStatistics() const;
+
+		void operator=(MeshCooker const&) = delete;
+	private:
+		MeshCooker();
+		MeshCooker(MeshCooker const&);
+		~MeshCooker();
+
+		std::string getCookedFilePath(std::shared_ptr<MeshResource> const& resource) const;
+		bool getSourceStamp(std::string const& sourceFilePath, Rendering::CookedMeshSource& source) const;
+		bool hashSourceFile(std::string const& sourceFilePath, uint64_t& hash) const;
+		bool writeFile(std::string const& filePath, std::vector<uint8_t> const& contents) const;
+
+		std::string m_cacheDirectory;
+		int m_cookedLoadCount;
+		int m_importCount;
+		double m_cookedLoadTime;
+		double m_importTime;
+	};
+
+}
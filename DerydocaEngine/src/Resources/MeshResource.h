@@ -16,7 +16,9 @@ namespace DerydocaEngine::Resources
 			m_skeletonId(),
 			m_meshIndex(0),
 			m_meshName(),
-			m_flags()
+			m_flags(),
+			m_compressVertices(true),
+			m_octahedralNormals(false)
 		{}
 
 		void setMeshIndex(unsigned int const& meshIndex) { m_meshIndex = meshIndex; }
@@ -29,6 +31,10 @@ namespace DerydocaEngine::Resources
 		void setFlag(Rendering::MeshFlags const& flag) {
 			m_flags = (Rendering::MeshFlags)(m_flags | flag);
 		}
+		bool getCompressVertices() const { return m_compressVertices; }
+		void setCompressVertices(bool const& compressVertices) { m_compressVertices = compressVertices; }
+		bool getOctahedralNormals() const { return m_octahedralNormals; }
+		void setOctahedralNormals(bool const& octahedralNormals) { m_octahedralNormals = octahedralNormals; }
 		const boost::uuids::uuid getSkeletonId() const { return m_skeletonId; }
 		bool hasSkeleton() const { return m_hasSkeleton; }
 
@@ -38,6 +44,8 @@ namespace DerydocaEngine::Resources
 		unsigned int m_meshIndex;
 		std::string m_meshName;
 		Rendering::MeshFlags m_flags{};
+		bool m_compressVertices;
+		bool m_octahedralNormals;
 	};
 
 }
@@ -0,0 +1,257 @@
+#include "EnginePch.h"
+#include "Resources\MipResidencyPlanner.h"
+
+#include <algorithm>
+
+namespace DerydocaEngine::Resources
+{
+
+	// Roughly a second at 60 frames per second
+	static const uint64_t DEFAULT_REQUEST_LIFETIME = 60;
+
+	static const size_t DEFAULT_UPLOAD_BUDGET = 4 * 1024 * 1024;
+
+	MipResidencyPlanner::MipResidencyPlanner() :
+		m_textures(),
+		m_nextTextureId(1),
+		m_memoryBudget(0),
+		m_uploadBudget(DEFAULT_UPLOAD_BUDGET),
+		m_requestLifetime(DEFAULT_REQUEST_LIFETIME),
+		m_residentBytes(0),
+		m_pendingBytes(0),
+		m_fullBytes(0),
+		m_peakResidentBytes(0),
+		m_loadCount(0),
+		m_evictionCount(0),
+		m_deferredCount(0)
+	{
+	}
+
+	MipResidencyPlanner::~MipResidencyPlanner()
+	{
+	}
+
+	int MipResidencyPlanner::add(std::vector<size_t> const& levelSizes, int const& residentLevel)
+	{
+		PlannedTexture texture;
+		texture.levelSizes = levelSizes;
+		texture.residentLevel = std::min(std::max(residentLevel, 0), std::max(static_cast<int>(levelSizes.size()) - 1, 0));
+		texture.smallestStreamedLevel = texture.residentLevel;
+		texture.requestedLevel = texture.residentLevel;
+		texture.requestFrame = 0;
+		texture.loadingLevel = -1;
+
+		int levelCount = static_cast<int>(levelSizes.size());
+		m_residentBytes += getLevelBytes(texture, texture.residentLevel, levelCount);
+		m_fullBytes += getLevelBytes(texture, 0, levelCount);
+		m_peakResidentBytes = std::max(m_peakResidentBytes, m_residentBytes);
+
+		int textureId = m_nextTextureId++;
+		m_textures[textureId] = texture;
+		return textureId;
+	}
+
+	void MipResidencyPlanner::remove(int const& textureId)
+	{
+		auto it = m_textures.find(textureId);
+		if (it == m_textures.end())
+		{
+			return;
+		}
+
+		PlannedTexture const& texture = it->second;
+		int levelCount = static_cast<int>(texture.levelSizes.size());
+		if (texture.loadingLevel >= 0)
+		{
+			m_pendingBytes -= texture.levelSizes[texture.loadingLevel];
+		}
+		m_residentBytes -= getLevelBytes(texture, texture.residentLevel, levelCount);
+		m_fullBytes -= getLevelBytes(texture, 0, levelCount);
+		m_textures.erase(it);
+	}
+
+	void MipResidencyPlanner::request(int const& textureId, int const& level, uint64_t const& frame)
+	{
+		auto it = m_textures.find(textureId);
+		if (it == m_textures.end())
+		{
+			return;
+		}
+
+		PlannedTexture& texture = it->second;
+		int clampedLevel = std::min(std::max(level, 0), texture.smallestStreamedLevel);
+		if (texture.requestFrame != frame)
+		{
+			texture.requestedLevel = clampedLevel;
+			texture.requestFrame = frame;
+		}
+		else
+		{
+			texture.requestedLevel = std::min(texture.requestedLevel, clampedLevel);
+		}
+	}
+
+	void MipResidencyPlanner::plan(uint64_t const& frame, std::vector<LevelChange>& loads, std::vector<LevelChange>& evictions)
+	{
+		loads.clear();
+		evictions.clear();
+
+		// Split the textures that are not loading into those that need larger levels and those that
+		// hold larger levels than they need
+		typedef std::map<int, PlannedTexture>::iterator TextureIterator;
+		std::vector<TextureIterator> loadCandidates;
+		std::vector<TextureIterator> evictionCandidates;
+		for (auto it = m_textures.begin(); it != m_textures.end(); it++)
+		{
+			if (it->second.loadingLevel >= 0)
+			{
+				continue;
+			}
+
+			int wantedLevel = getWantedLevel(it->second, frame);
+			if (wantedLevel < it->second.residentLevel)
+			{
+				loadCandidates.push_back(it);
+			}
+			else if (wantedLevel > it->second.residentLevel)
+			{
+				evictionCandidates.push_back(it);
+			}
+		}
+
+		// Textures furthest from the level they need go first, so every texture on screen gets
+		// sharper before any of them gets perfect
+		std::stable_sort(loadCandidates.begin(), loadCandidates.end(), [&](TextureIterator const& textureL, TextureIterator const& textureR)
+		{
+			int gapL = textureL->second.residentLevel - getWantedLevel(textureL->second, frame);
+			int gapR = textureR->second.residentLevel - getWantedLevel(textureR->second, frame);
+			return gapL > gapR;
+		});
+
+		std::stable_sort(evictionCandidates.begin(), evictionCandidates.end(), [](TextureIterator const& textureL, TextureIterator const& textureR)
+		{
+			return textureL->second.requestFrame < textureR->second.requestFrame;
+		});
+
+		size_t nextEviction = 0;
+		auto evictNext = [&]() -> bool
+		{
+			if (nextEviction >= evictionCandidates.size())
+			{
+				return false;
+			}
+
+			TextureIterator it = evictionCandidates[nextEviction++];
+			int wantedLevel = getWantedLevel(it->second, frame);
+			m_residentBytes -= getLevelBytes(it->second, it->second.residentLevel, wantedLevel);
+			it->second.residentLevel = wantedLevel;
+			m_evictionCount++;
+			evictions.push_back({ it->first, wantedLevel });
+			return true;
+		};
+
+		size_t plannedBytes = 0;
+		for (auto const& it : loadCandidates)
+		{
+			PlannedTexture& texture = it->second;
+			int level = texture.residentLevel - 1;
+			size_t size = texture.levelSizes[level];
+			if (!loads.empty() && plannedBytes + size > m_uploadBudget)
+			{
+				continue;
+			}
+
+			while (isOverBudget(size) && evictNext())
+			{
+			}
+
+			if (isOverBudget(size))
+			{
+				m_deferredCount++;
+				continue;
+			}
+
+			texture.loadingLevel = level;
+			m_pendingBytes += size;
+			plannedBytes += size;
+			loads.push_back({ it->first, level });
+		}
+
+		// Also catch up with a budget that was lowered while nothing needed loading
+		while (isOverBudget(0) && evictNext())
+		{
+		}
+	}
+
+	void MipResidencyPlanner::completeLoad(int const& textureId)
+	{
+		auto it = m_textures.find(textureId);
+		if (it == m_textures.end() || it->second.loadingLevel < 0)
+		{
+			return;
+		}
+
+		PlannedTexture& texture = it->second;
+		size_t size = texture.levelSizes[texture.loadingLevel];
+		m_pendingBytes -= size;
+		m_residentBytes += size;
+		m_peakResidentBytes = std::max(m_peakResidentBytes, m_residentBytes);
+		m_loadCount++;
+		texture.residentLevel = texture.loadingLevel;
+		texture.loadingLevel = -1;
+	}
+
+	void MipResidencyPlanner::cancelLoad(int const& textureId)
+	{
+		auto it = m_textures.find(textureId);
+		if (it == m_textures.end() || it->second.loadingLevel < 0)
+		{
+			return;
+		}
+
+		m_pendingBytes -= it->second.levelSizes[it->second.loadingLevel];
+		it->second.loadingLevel = -1;
+	}
+
+	int MipResidencyPlanner::getResidentLevel(int const& textureId) const
+	{
+		auto it = m_textures.find(textureId);
+		return it == m_textures.end() ? -1 : it->second.residentLevel;
+	}
+
+	MipResidencyPlanner::Statistics MipResidencyPlanner::getStatistics() const
+	{
+		Statistics statistics;
+		statistics.textureCount = m_textures.size();
+		statistics.residentBytes = m_residentBytes;
+		statistics.pendingBytes = m_pendingBytes;
+		statistics.fullBytes = m_fullBytes;
+		statistics.peakResidentBytes = m_peakResidentBytes;
+		statistics.loadCount = m_loadCount;
+		statistics.evictionCount = m_evictionCount;
+		statistics.deferredCount = m_deferredCount;
+		return statistics;
+	}
+
+	int MipResidencyPlanner::getWantedLevel(PlannedTexture const& texture, uint64_t const& frame) const
+	{
+		bool requestIsCurrent = texture.requestFrame > 0 && frame - texture.requestFrame <= m_requestLifetime;
+		return requestIsCurrent ? texture.requestedLevel : texture.smallestStreamedLevel;
+	}
+
+	size_t MipResidencyPlanner::getLevelBytes(PlannedTexture const& texture, int const& firstLevel, int const& endLevel) const
+	{
+		size_t bytes = 0;
+		for (int i = firstLevel; i < endLevel; i++)
+		{
+			bytes += texture.levelSizes[i];
+		}
+		return bytes;
+	}
+
+	bool MipResidencyPlanner::isOverBudget(size_t const& extraBytes) const
+	{
+		return m_memoryBudget > 0 && m_residentBytes + m_pendingBytes + extraBytes > m_memoryBudget;
+	}
+
+}
@@ -0,0 +1,142 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace DerydocaEngine::Resources
+{
+
+	/*
+	Decides which mip levels of streamed textures should be resident. Textures start with only
+	their smallest levels resident and gain one level at a time, in the order of how far they are
+	from the level the renderer asked for. Levels are dropped again from textures that hold more
+	than they were asked for, least recently asked for first, but only to make room under the
+	memory budget. Holds no textures itself, so it can be driven without a GL context.
+	*/
+	class MipResidencyPlanner
+	{
+	public:
+		/* Level of a texture that has to be loaded, or the level a texture is cut down to */
+		struct LevelChange
+		{
+			int textureId;
+			int level;
+		};
+
+		struct Statistics
+		{
+			size_t textureCount;
+			/* Bytes of every resident level */
+			size_t residentBytes;
+			/* Bytes of the levels being loaded */
+			size_t pendingBytes;
+			/* Bytes every texture would take with its full mip chain resident */
+			size_t fullBytes;
+			size_t peakResidentBytes;
+			size_t loadCount;
+			size_t evictionCount;
+			/* Loads that were put off because nothing could be evicted to make room for them */
+			size_t deferredCount;
+		};
+
+		MipResidencyPlanner();
+		~MipResidencyPlanner();
+
+		/*
+		Starts planning a texture.
+
+		@param levelSizes Size of each level in bytes, starting with the largest
+		@param residentLevel Largest level that is resident, which levels are never dropped below
+		@return ID of the texture
+		*/
+		int add(std::vector<size_t> const& levelSizes, int const& residentLevel);
+
+		/* Stops planning a texture, forgetting any load in progress */
+		void remove(int const& textureId);
+
+		/*
+		Asks for a level of a texture to be resident. The largest level asked for during a frame
+		wins, and the request is kept for the request lifetime after it was last made.
+
+		@param textureId ID of the texture
+		@param level Largest level that is needed
+		@param frame Frame the level is needed in, counting from 1
+		*/
+		void request(int const& textureId, int const& level, uint64_t const& frame);
+
+		/*
+		Plans the loads and evictions of a frame. Every load must be followed by completeLoad or
+		cancelLoad, evictions are already applied.
+
+		@param frame Current frame
+		@param loads Receives the levels to load, each the next larger level of its texture
+		@param evictions Receives the largest level each evicted texture keeps
+		*/
+		void plan(uint64_t const& frame, std::vector<LevelChange>& loads, std::vector<LevelChange>& evictions);
+
+		/* Marks the level being loaded for a texture as resident */
+		void completeLoad(int const& textureId);
+
+		/* Forgets the level being loaded for a texture, so it is planned again */
+		void cancelLoad(int const& textureId);
+
+		/* Gets the largest resident level of a texture, or -1 if it is not planned */
+		int getResidentLevel(int const& textureId) const;
+
+		/*
+		Sets how many bytes the levels of every streamed texture may take. Loads that do not fit
+		are put off until levels of other textures can be dropped.
+
+		@param bytes Memory budget in bytes, or 0 for no budget
+		*/
+		void setMemoryBudget(size_t const& bytes) { m_memoryBudget = bytes; }
+		size_t getMemoryBudget() const { return m_memoryBudget; }
+
+		/*
+		Sets how many bytes of levels may be planned for loading in a single frame. At least one
+		level is planned per frame, however large it is.
+
+		@param bytes Upload budget of a frame in bytes
+		*/
+		void setUploadBudget(size_t const& bytes) { m_uploadBudget = bytes; }
+		size_t getUploadBudget() const { return m_uploadBudget; }
+
+		/*
+		Sets how many frames a request is kept after it was last made, so textures that go out of
+		view for a moment are not dropped and loaded again.
+
+		@param frames Lifetime of a request in frames
+		*/
+		void setRequestLifetime(uint64_t const& frames) { m_requestLifetime = frames; }
+
+		Statistics getStatistics() const;
+	private:
+		struct PlannedTexture
+		{
+			std::vector<size_t> levelSizes;
+			int residentLevel;
+			int smallestStreamedLevel;
+			int requestedLevel;
+			uint64_t requestFrame;
+			int loadingLevel;
+		};
+
+		int getWantedLevel(PlannedTexture const& texture, uint64_t const& frame) const;
+		size_t getLevelBytes(PlannedTexture const& texture, int const& firstLevel, int const& endLevel) const;
+		bool isOverBudget(size_t const& extraBytes) const;
+
+		std::map<int, PlannedTexture> m_textures;
+		int m_nextTextureId;
+		size_t m_memoryBudget;
+		size_t m_uploadBudget;
+		uint64_t m_requestLifetime;
+		size_t m_residentBytes;
+		size_t m_pendingBytes;
+		size_t m_fullBytes;
+		size_t m_peakResidentBytes;
+		size_t m_loadCount;
+		size_t m_evictionCount;
+		size_t m_deferredCount;
+	};
+
+}
@@ -0,0 +1,260 @@
+#include "EnginePch.h"
+#include "Resources\ResidencyManager.h"
+
+#include "Resources\Resource.h"
+#include "Resources\Serializers\ResourceSerializerLibrary.h"
+
+namespace DerydocaEngine::Resources
+{
+
+	// Every type that can be given a budget, in the order statistics are listed
+	static const ResourceType TRACKED_TYPES[] = {
+		MeshResourceType,
+		TextureResourceType,
+		CubemapResourceType,
+		MaterialResourceType,
+		ShaderResourceType,
+		SkeletonResourceType,
+		AnimationResourceType,
+		LevelResourceType,
+		BezierPatchMeshResourceType,
+		FontResourceType,
+		RasterFontResourceType,
+		SpriteSheetType,
+		UnknownResourceType
+	};
+
+	ResidencyManager::ResidencyManager() :
+		m_mutex(),
+		m_resources(),
+		m_budgets(),
+		m_frame(0)
+	{
+	}
+
+	ResidencyManager::~ResidencyManager()
+	{
+	}
+
+	void ResidencyManager::track(std::shared_ptr<Resource> const& resource)
+	{
+		std::shared_ptr<void> object = resource->getLoadedObjectPointer();
+		if (!object)
+		{
+			return;
+		}
+
+		TrackedResource tracked;
+		tracked.resource = resource;
+		auto serializer = Serializers::ResourceSerializerLibrary::getInstance().getSerializer(resource->getType());
+		if (serializer)
+		{
+			tracked.usage = serializer->getMemoryUsage(object);
+		}
+		object.reset();
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		tracked.lastUsedFrame = m_frame;
+		tracked.referenced = true;
+		m_resources[resource->getId()] = tracked;
+	}
+
+	void ResidencyManager::setBudget(ResourceType const& type, size_t const& cpuBytes, size_t const& gpuBytes)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		Budget& budget = m_budgets[type];
+		budget.cpuBytes = cpuBytes;
+		budget.gpuBytes = gpuBytes;
+	}
+
+	bool ResidencyManager::setBudget(std::string const& typeName, size_t const& cpuBytes, size_t const& gpuBytes)
+	{
+		for (auto const& type : TRACKED_TYPES)
+		{
+			if (getTypeName(type) == typeName)
+			{
+				setBudget(type, cpuBytes, gpuBytes);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void ResidencyManager::update()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_frame++;
+
+		// A resource counts as used for as long as anything other than the resource holds its object
+		std::map<ResourceType, ResourceMemoryUsage> typeUsage;
+		for (auto& tracked : m_resources)
+		{
+			tracked.second.referenced = tracked.second.resource->isObjectReferenced();
+			if (tracked.second.referenced)
+			{
+				tracked.second.lastUsedFrame = m_frame;
+			}
+
+			ResourceMemoryUsage& usage = typeUsage[tracked.second.resource->getType()];
+			usage.cpuBytes += tracked.second.usage.cpuBytes;
+			usage.gpuBytes += tracked.second.usage.gpuBytes;
+		}
+
+		for (auto& budget : m_budgets)
+		{
+			ResourceMemoryUsage const& usage = typeUsage[budget.first];
+			bool overCpuBudget = budget.second.cpuBytes > 0 && usage.cpuBytes > budget.second.cpuBytes;
+			bool overGpuBudget = budget.second.gpuBytes > 0 && usage.gpuBytes > budget.second.gpuBytes;
+			if (overCpuBudget || overGpuBudget)
+			{
+				evict(budget.first, budget.second, usage.cpuBytes, usage.gpuBytes);
+			}
+		}
+	}
+
+	void ResidencyManager::evict(ResourceType const& type, Budget& budget, size_t cpuBytes, size_t gpuBytes)
+	{
+		// Unload the least recently used resources first
+		std::vector<std::map<boost::uuids::uuid, TrackedResource>::iterator> candidates;
+		for (auto it = m_resources.begin(); it != m_resources.end(); it++)
+		{
+			if (it->second.resource->getType() == type && !it->second.referenced)
+			{
+				candidates.push_back(it);
+			}
+		}
+		std::stable_sort(candidates.begin(), candidates.end(), [](auto const& candidateL, auto const& candidateR)
+		{
+			return candidateL->second.lastUsedFrame < candidateR->second.lastUsedFrame;
+		});
+
+		for (auto const& candidate : candidates)
+		{
+			bool overCpuBudget = budget.cpuBytes > 0 && cpuBytes > budget.cpuBytes;
+			bool overGpuBudget = budget.gpuBytes > 0 && gpuBytes > budget.gpuBytes;
+			if (!overCpuBudget && !overGpuBudget)
+			{
+				break;
+			}
+
+			// The object may have been picked up by another thread since it was checked
+			if (!candidate->second.resource->unloadIfUnreferenced())
+			{
+				continue;
+			}
+
+			cpuBytes -= candidate->second.usage.cpuBytes;
+			gpuBytes -= candidate->second.usage.gpuBytes;
+			budget.evictionCount++;
+			m_resources.erase(candidate);
+		}
+	}
+
+	std::vector<ResidencyManager::TypeStatistics> ResidencyManager::getStatistics() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		std::vector<TypeStatistics> statistics;
+		for (auto const& type : TRACKED_TYPES)
+		{
+			TypeStatistics typeStatistics = {};
+			typeStatistics.type = type;
+			typeStatistics.name = getTypeName(type);
+
+			auto budget = m_budgets.find(type);
+			if (budget != m_budgets.end())
+			{
+				typeStatistics.cpuBudget = budget->second.cpuBytes;
+				typeStatistics.gpuBudget = budget->second.gpuBytes;
+				typeStatistics.evictionCount = budget->second.evictionCount;
+			}
+
+			statistics.push_back(typeStatistics);
+		}
+
+		for (auto const& tracked : m_resources)
+		{
+			for (auto& typeStatistics : statistics)
+			{
+				if (typeStatistics.type == tracked.second.resource->getType())
+				{
+					typeStatistics.residentCount++;
+					typeStatistics.referencedCount += tracked.second.referenced ? 1 : 0;
+					typeStatistics.cpuBytes += tracked.second.usage.cpuBytes;
+					typeStatistics.gpuBytes += tracked.second.usage.gpuBytes;
+					break;
+				}
+			}
+		}
+
+		return statistics;
+	}
+
+	std::vector<std::shared_ptr<Resource>> ResidencyManager::getResidentResources() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		std::vector<std::shared_ptr<Resource>> resources;
+		resources.reserve(m_resources.size());
+		for (auto const& tracked : m_resources)
+		{
+			resources.push_back(tracked.second.resource);
+		}
+
+		return resources;
+	}
+
+	void ResidencyManager::printStatistics() const
+	{
+		for (auto const& typeStatistics : getStatistics())
+		{
+			if (typeStatistics.residentCount == 0 && typeStatistics.evictionCount == 0)
+			{
+				continue;
+			}
+
+			printf("%s: %zu resident (%zu referenced), %.1f KB CPU, %.1f KB GPU, %zu unloaded\n",
+				typeStatistics.name.c_str(),
+				typeStatistics.residentCount,
+				typeStatistics.referencedCount,
+				typeStatistics.cpuBytes / 1024.0f,
+				typeStatistics.gpuBytes / 1024.0f,
+				typeStatistics.evictionCount);
+		}
+	}
+
+	std::string ResidencyManager::getTypeName(ResourceType const& type)
+	{
+		switch (type)
+		{
+		case MaterialResourceType:
+			return "Material";
+		case MeshResourceType:
+			return "Mesh";
+		case TextureResourceType:
+			return "Texture";
+		case CubemapResourceType:
+			return "Cubemap";
+		case LevelResourceType:
+			return "Level";
+		case ShaderResourceType:
+			return "Shader";
+		case BezierPatchMeshResourceType:
+			return "BezierPatchMesh";
+		case FontResourceType:
+			return "Font";
+		case RasterFontResourceType:
+			return "RasterFont";
+		case SpriteSheetType:
+			return "SpriteSheet";
+		case SkeletonResourceType:
+			return "Skeleton";
+		case AnimationResourceType:
+			return "Animation";
+		default:
+			return "Unknown";
+		}
+	}
+
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <boost/uuid/uuid.hpp>
+#include "Resources\ResourceType.h"
+
+namespace DerydocaEngine::Resources
+{
+	struct Resource;
+
+	/* Memory held by a loaded resource */
+	struct ResourceMemoryUsage
+	{
+		size_t cpuBytes = 0;
+		size_t gpuBytes = 0;
+	};
+
+	/*
+	Tracks how much CPU and GPU memory the loaded resources of each type use, and unloads resources
+	that nothing references once a type goes over its budget. The resources that were used least
+	recently are unloaded first. Unloaded resources are loaded again the next time they are requested.
+	*/
+	class ResidencyManager
+	{
+	public:
+		/* Memory used by every loaded resource of a single type */
+		struct TypeStatistics
+		{
+			ResourceType type;
+			std::string name;
+			size_t residentCount;
+			size_t referencedCount;
+			size_t cpuBytes;
+			size_t gpuBytes;
+			size_t cpuBudget;
+			size_t gpuBudget;
+			size_t evictionCount;
+		};
+
+		static ResidencyManager& getInstance()
+		{
+			static ResidencyManager instance;
+			return instance;
+		}
+
+		/*
+		Starts tracking a resource whose object was just loaded. Safe to call from any thread.
+
+		@param resource Resource that was loaded
+		*/
+		void track(std::shared_ptr<Resource> const& resource);
+
+		/*
+		Sets how much memory the loaded resources of a type may use before unreferenced ones are unloaded.
+
+		@param type Type of resource
+		@param cpuBytes CPU memory budget in bytes, or 0 for no budget
+		@param gpuBytes GPU memory budget in bytes, or 0 for no budget
+		*/
+		void setBudget(ResourceType const& type, size_t const& cpuBytes, size_t const& gpuBytes);
+
+		/*
+		Sets a budget by the name of the resource type, such as "Mesh" or "Texture".
+
+		@return False if no resource type has that name
+		*/
+		bool setBudget(std::string const& typeName, size_t const& cpuBytes, size_t const& gpuBytes);
+
+		/*
+		Records which resources are still referenced and unloads unreferenced ones from types that
+		are over budget. Unloading destroys graphics API objects, so this must be called from the
+		render thread, once per frame.
+		*/
+		void update();
+
+		std::vector<TypeStatistics> getStatistics() const;
+
+		/* Gets every resource whose object is loaded */
+		std::vector<std::shared_ptr<Resource>> getResidentResources() const;
+
+		/*
+		Prints the memory used by each type of resource and how many resources were unloaded.
+		*/
+		void printStatistics() const;
+
+		static std::string getTypeName(ResourceType const& type);
+
+		void operator=(ResidencyManager const&) = delete;
+	private:
+		struct TrackedResource
+		{
+			std::shared_ptr<Resource> resource;
+			ResourceMemoryUsage usage;
+			uint64_t lastUsedFrame;
+			bool referenced;
+		};
+
+		struct Budget
+		{
+			size_t cpuBytes = 0;
+			size_t gpuBytes = 0;
+			size_t evictionCount = 0;
+		};
+
+		ResidencyManager();
+		ResidencyManager(ResidencyManager const&);
+		~ResidencyManager();
+
+		void evict(ResourceType const& type, Budget& budget, size_t cpuBytes, size_t gpuBytes);
+
+		mutable std::mutex m_mutex;
+		std::map<boost::uuids::uuid, TrackedResource> m_resources;
+		std::map<ResourceType, Budget> m_budgets;
+		uint64_t m_frame;
+	};
+
+}
@@ -1,6 +1,8 @@
 #include "EnginePch.h"
 #include "Resources\Resource.h"
 #include "Files\Serializers\FileSerializerLibrary.h"
+#include "Helpers\AssimpImportCache.h"
+#include "Resources\ResidencyManager.h"
 #include "Resources\Serializers\ResourceSerializerLibrary.h"
 
 namespace DerydocaEngine::Resources
@@ -13,7 +15,8 @@ namespace DerydocaEngine::Resources
 		m_sourceFilePath(),
 		m_metaFilePath(),
 		m_resourceObject(nullptr),
-		m_resourceObjectPointer()
+		m_resourceObjectPointer(),
+		m_loadMutex()
 	{
 
 	}
@@ -21,7 +24,9 @@ namespace DerydocaEngine::Resources
 	Resource::Resource(boost::uuids::uuid const& id, std::string const& sourceFilePath, std::string const& metaFilePath, ResourceType const& type) :
 		Object(id),
 		m_sourceFilePath(sourceFilePath),
-		m_metaFilePath(metaFilePath)
+		m_metaFilePath(metaFilePath),
+		m_resourceObjectPointer(),
+		m_loadMutex()
 	{
 		auto filePath = boost::filesystem::path(sourceFilePath);
 		if (filePath.has_stem())
@@ -47,8 +52,16 @@ namespace DerydocaEngine::Resources
 
 	std::shared_ptr<void> Resource::getResourceObjectPointer()
 	{
-		if (m_resourceObjectPointer == 0)
+		std::shared_ptr<void> object;
 		{
+			// Resources can be loaded from the loader's worker threads as well as the render thread
+			std::lock_guard<std::mutex> lock(m_loadMutex);
+
+			if (m_resourceObjectPointer != 0)
+			{
+				return m_resourceObjectPointer;
+			}
+
 			// Find the loader that should be used
 			auto loader = Serializers::ResourceSerializerLibrary::getInstance().getSerializer(getType());
 
@@ -58,11 +71,66 @@ namespace DerydocaEngine::Resources
 				return nullptr;
 			}
 
-			// Load the object from the related object loader and return it
+			// Load the object from the related object loader and return it. Resources it depends on,
+			// such as the skeleton of a mesh, are often loaded from the same file and share its import.
+			Helpers::AssimpImportCache::Batch importBatch;
 			m_resourceObjectPointer = loader->deserializePointer(shared_from_this());
+			object = m_resourceObjectPointer;
 		}
 
+		// Tracked once the lock is released, the residency manager locks resources while it unloads them
+		if (object)
+		{
+			ResidencyManager::getInstance().track(shared_from_this());
+		}
+
+		return object;
+	}
+
+	std::shared_ptr<void> Resource::getLoadedObjectPointer()
+	{
+		std::lock_guard<std::mutex> lock(m_loadMutex);
 		return m_resourceObjectPointer;
 	}
 
+	std::shared_ptr<void> Resource::setResourceObjectPointer(std::shared_ptr<void> const& object)
+	{
+		bool stored = false;
+		std::shared_ptr<void> heldObject;
+		{
+			std::lock_guard<std::mutex> lock(m_loadMutex);
+			if (!m_resourceObjectPointer)
+			{
+				m_resourceObjectPointer = object;
+				stored = object != nullptr;
+			}
+			heldObject = m_resourceObjectPointer;
+		}
+
+		if (stored)
+		{
+			ResidencyManager::getInstance().track(shared_from_this());
+		}
+
+		return heldObject;
+	}
+
+	bool Resource::isObjectReferenced()
+	{
+		std::lock_guard<std::mutex> lock(m_loadMutex);
+		return m_resourceObjectPointer.use_count() > 1;
+	}
+
+	bool Resource::unloadIfUnreferenced()
+	{
+		std::lock_guard<std::mutex> lock(m_loadMutex);
+		if (!m_resourceObjectPointer || m_resourceObjectPointer.use_count() > 1)
+		{
+			return false;
+		}
+
+		m_resourceObjectPointer.reset();
+		return true;
+	}
+
 }
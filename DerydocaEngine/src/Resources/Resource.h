@@ -1,4 +1,5 @@
 #pragma once
+#include <mutex>
 #include <string>
 #include <boost/uuid/uuid.hpp>
 #include "Resources\ResourceType.h"
@@ -22,6 +23,29 @@ namespace DerydocaEngine::Resources
 		std::string getSourceFilePath() const { return m_sourceFilePath; }
 		std::string getMetaFilePath() const { return m_metaFilePath; }
 		std::shared_ptr<void> getResourceObjectPointer();
+
+		/* Gets the loaded object without loading it, or null if it has not been loaded yet */
+		std::shared_ptr<void> getLoadedObjectPointer();
+
+		/*
+		Stores an object that was loaded outside of getResourceObjectPointer, such as by the
+		ResourceLoader. An object that was loaded in the meantime is kept instead.
+
+		@param object Object that was loaded
+		@return The object held by the resource
+		*/
+		std::shared_ptr<void> setResourceObjectPointer(std::shared_ptr<void> const& object);
+
+		/* Gets whether anything other than the resource holds its loaded object */
+		bool isObjectReferenced();
+
+		/*
+		Releases the loaded object if nothing other than the resource holds it. It is loaded again
+		the next time it is requested.
+
+		@return True if the object was released
+		*/
+		bool unloadIfUnreferenced();
 		virtual unsigned long getTypeId() const = 0;
 	protected:
 		std::string m_name;
@@ -30,6 +54,7 @@ namespace DerydocaEngine::Resources
 		std::string m_metaFilePath;
 		void* m_resourceObject;
 		std::shared_ptr<void> m_resourceObjectPointer;
+		std::mutex m_loadMutex;
 	};
 
 }
@@ -0,0 +1,119 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "Resources\Resource.h"
+
+namespace DerydocaEngine::Resources
+{
+
+	/* Stage of an asynchronous load */
+	enum class ResourceLoadState
+	{
+		Queued,
+		Preparing,
+		Uploading,
+		Resident,
+		Failed
+	};
+
+	/*
+	Tracks a resource that is being loaded by the ResourceLoader. The loaded object can only be
+	taken from the handle once it is resident, so anything using it should fall back to
+	something else, such as not drawing, until then.
+	*/
+	class ResourceHandle
+	{
+	public:
+		ResourceHandle(std::shared_ptr<Resource> const& resource) :
+			m_resource(resource),
+			m_object(),
+			m_state(ResourceLoadState::Queued)
+		{
+		}
+
+		std::shared_ptr<Resource> getResource() const { return m_resource; }
+		ResourceLoadState getState() const { return m_state; }
+		bool isResident() const { return m_state == ResourceLoadState::Resident; }
+		bool hasFailed() const { return m_state == ResourceLoadState::Failed; }
+
+		/* Gets whether the load is over, whether it succeeded or not */
+		bool isFinished() const { return isResident() || hasFailed(); }
+
+		/*
+		Gets the loaded object.
+
+		@return The object, or null if it is not resident yet
+		*/
+		template<typename T>
+		std::shared_ptr<T> get() const
+		{
+			return isResident() ? std::static_pointer_cast<T>(m_object) : nullptr;
+		}
+
+		void setState(ResourceLoadState const& state) { m_state = state; }
+
+		/*
+		Marks the resource as resident. Must only be called once, by the thread that finished the load.
+
+		@param object Object that was loaded
+		*/
+		void setResident(std::shared_ptr<void> const& object)
+		{
+			m_object = object;
+			m_state = ResourceLoadState::Resident;
+		}
+
+		void operator=(ResourceHandle const&) = delete;
+	private:
+		ResourceHandle(ResourceHandle const&);
+
+		std::shared_ptr<Resource> m_resource;
+		std::shared_ptr<void> m_object;
+		std::atomic<ResourceLoadState> m_state;
+	};
+
+	/*
+	A set of loads that something depends on, such as every resource requested by a scene's
+	components or every texture used by a material.
+	*/
+	class ResourceDependencySet
+	{
+	public:
+		ResourceDependencySet() :
+			m_handles()
+		{
+		}
+
+		void add(std::shared_ptr<ResourceHandle> const& handle)
+		{
+			if (handle)
+			{
+				m_handles.push_back(handle);
+			}
+		}
+
+		std::vector<std::shared_ptr<ResourceHandle>> const& getHandles() const { return m_handles; }
+		size_t size() const { return m_handles.size(); }
+		bool empty() const { return m_handles.empty(); }
+
+		/* Gets how many of the loads are over, whether they succeeded or not */
+		size_t getFinishedCount() const
+		{
+			size_t finishedCount = 0;
+			for (auto const& handle : m_handles)
+			{
+				if (handle->isFinished())
+				{
+					finishedCount++;
+				}
+			}
+			return finishedCount;
+		}
+
+		bool isFinished() const { return getFinishedCount() == m_handles.size(); }
+	private:
+		std::vector<std::shared_ptr<ResourceHandle>> m_handles;
+	};
+
+}
@@ -0,0 +1,329 @@
+#include "EnginePch.h"
+#include "Resources\ResourceIndex.h"
+
+namespace DerydocaEngine::Resources::ResourceIndex
+{
+
+	static const char FILE_MAGIC[4] = { 'D', 'R', 'I', 'X' };
+
+	// Sanity limits so a corrupt file can not request absurd allocations or recurse forever
+	static const uint32_t MAX_RECORDS = 1 << 24;
+	static const uint32_t MAX_NODE_DEPTH = 64;
+
+	enum class NodeTag : uint8_t
+	{
+		Null,
+		Scalar,
+		Sequence,
+		Map
+	};
+
+	struct FileHeader
+	{
+		char magic[4];
+		uint32_t version;
+		uint32_t metaFileCount;
+		uint32_t treeNodeCount;
+		uint64_t treeHash;
+		uint64_t fileSize;
+	};
+
+	struct FileMetaRecord
+	{
+		uint64_t metaSize;
+		int64_t metaWriteTime;
+		uint64_t metaHash;
+		uint32_t pathLength;
+		uint32_t nodesSize;
+	};
+
+	struct FileTreeRecord
+	{
+		uint32_t nameLength;
+		uint32_t childCount;
+		uint32_t resourceCount;
+	};
+
+	template<typename T>
+	static void append(std::vector<uint8_t>& buffer, T const& value)
+	{
+		size_t offset = buffer.size();
+		buffer.resize(offset + sizeof(T));
+		memcpy(buffer.data() + offset, &value, sizeof(T));
+	}
+
+	static void appendBytes(std::vector<uint8_t>& buffer, const void* data, size_t const& size)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		buffer.insert(buffer.end(), bytes, bytes + size);
+	}
+
+	// Reads values one after another, failing once anything would be read past the end
+	class Reader
+	{
+	public:
+		Reader(const uint8_t* data, size_t const& size) :
+			m_data(data),
+			m_size(size),
+			m_offset(0)
+		{
+		}
+
+		template<typename T>
+		bool read(T& value)
+		{
+			if (sizeof(T) > m_size - m_offset)
+			{
+				return false;
+			}
+			memcpy(&value, m_data + m_offset, sizeof(T));
+			m_offset += sizeof(T);
+			return true;
+		}
+
+		bool skip(size_t const& size, const uint8_t*& data)
+		{
+			if (size > m_size - m_offset)
+			{
+				return false;
+			}
+			data = m_data + m_offset;
+			m_offset += size;
+			return true;
+		}
+
+		bool readString(size_t const& length, std::string& value)
+		{
+			const uint8_t* data;
+			if (!skip(length, data))
+			{
+				return false;
+			}
+			value.assign(reinterpret_cast<const char*>(data), length);
+			return true;
+		}
+
+		size_t getOffset() const { return m_offset; }
+	private:
+		const uint8_t* m_data;
+		size_t m_size;
+		size_t m_offset;
+	};
+
+	void write(std::vector<uint8_t>& buffer, std::vector<IndexedMetaFile> const& metaFiles, uint64_t const& treeHash, std::vector<IndexedTreeNode> const& tree)
+	{
+		FileHeader header{};
+		memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+		header.version = FORMAT_VERSION;
+		header.metaFileCount = static_cast<uint32_t>(metaFiles.size());
+		header.treeNodeCount = static_cast<uint32_t>(tree.size());
+		header.treeHash = treeHash;
+
+		buffer.clear();
+		append(buffer, header);
+
+		for (auto const& metaFile : metaFiles)
+		{
+			FileMetaRecord record;
+			record.metaSize = metaFile.stamp.size;
+			record.metaWriteTime = metaFile.stamp.writeTime;
+			record.metaHash = metaFile.stamp.hash;
+			record.pathLength = static_cast<uint32_t>(metaFile.sourceFilePath.size());
+			record.nodesSize = static_cast<uint32_t>(metaFile.resourceNodesSize);
+			append(buffer, record);
+			appendBytes(buffer, metaFile.sourceFilePath.data(), metaFile.sourceFilePath.size());
+			appendBytes(buffer, metaFile.resourceNodes, metaFile.resourceNodesSize);
+		}
+
+		for (auto const& node : tree)
+		{
+			FileTreeRecord record;
+			record.nameLength = static_cast<uint32_t>(node.name.size());
+			record.childCount = static_cast<uint32_t>(node.children.size());
+			record.resourceCount = static_cast<uint32_t>(node.resources.size());
+			append(buffer, record);
+			appendBytes(buffer, node.name.data(), node.name.size());
+			appendBytes(buffer, node.children.data(), node.children.size() * sizeof(uint32_t));
+			for (auto const& resourceId : node.resources)
+			{
+				appendBytes(buffer, resourceId.data, resourceId.static_size());
+			}
+		}
+
+		// The size is only known once everything is written
+		header.fileSize = buffer.size();
+		memcpy(buffer.data(), &header, sizeof(header));
+	}
+
+	bool read(const uint8_t* data, size_t const& size, std::vector<IndexedMetaFile>& metaFiles, uint64_t& treeHash, std::vector<IndexedTreeNode>& tree)
+	{
+		Reader reader(data, size);
+		FileHeader header;
+		if (data == nullptr ||
+			!reader.read(header) ||
+			memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 ||
+			header.version != FORMAT_VERSION ||
+			header.fileSize != size ||
+			header.metaFileCount > MAX_RECORDS ||
+			header.treeNodeCount > MAX_RECORDS)
+		{
+			return false;
+		}
+
+		treeHash = header.treeHash;
+
+		metaFiles.clear();
+		metaFiles.resize(header.metaFileCount);
+		for (auto& metaFile : metaFiles)
+		{
+			FileMetaRecord record;
+			if (!reader.read(record) ||
+				!reader.readString(record.pathLength, metaFile.sourceFilePath) ||
+				!reader.skip(record.nodesSize, metaFile.resourceNodes))
+			{
+				return false;
+			}
+			metaFile.stamp.size = record.metaSize;
+			metaFile.stamp.writeTime = record.metaWriteTime;
+			metaFile.stamp.hash = record.metaHash;
+			metaFile.resourceNodesSize = record.nodesSize;
+		}
+
+		tree.clear();
+		tree.resize(header.treeNodeCount);
+		for (auto& node : tree)
+		{
+			FileTreeRecord record;
+			if (!reader.read(record) ||
+				!reader.readString(record.nameLength, node.name) ||
+				record.childCount > header.treeNodeCount ||
+				record.resourceCount > MAX_RECORDS)
+			{
+				return false;
+			}
+
+			node.children.resize(record.childCount);
+			for (auto& child : node.children)
+			{
+				if (!reader.read(child) || child >= header.treeNodeCount)
+				{
+					return false;
+				}
+			}
+
+			node.resources.resize(record.resourceCount);
+			for (auto& resourceId : node.resources)
+			{
+				const uint8_t* idData;
+				if (!reader.skip(resourceId.static_size(), idData))
+				{
+					return false;
+				}
+				memcpy(resourceId.data, idData, resourceId.static_size());
+			}
+		}
+
+		return reader.getOffset() == size;
+	}
+
+	void encodeNode(YAML::Node const& node, std::vector<uint8_t>& buffer)
+	{
+		switch (node.Type())
+		{
+		case YAML::NodeType::Scalar:
+		{
+			std::string const& scalar = node.Scalar();
+			append(buffer, NodeTag::Scalar);
+			append(buffer, static_cast<uint32_t>(scalar.size()));
+			appendBytes(buffer, scalar.data(), scalar.size());
+			break;
+		}
+		case YAML::NodeType::Sequence:
+			append(buffer, NodeTag::Sequence);
+			append(buffer, static_cast<uint32_t>(node.size()));
+			for (auto const& child : node)
+			{
+				encodeNode(child, buffer);
+			}
+			break;
+		case YAML::NodeType::Map:
+			append(buffer, NodeTag::Map);
+			append(buffer, static_cast<uint32_t>(node.size()));
+			for (auto const& child : node)
+			{
+				encodeNode(child.first, buffer);
+				encodeNode(child.second, buffer);
+			}
+			break;
+		default:
+			append(buffer, NodeTag::Null);
+			break;
+		}
+	}
+
+	static bool decodeNode(Reader& reader, uint32_t const& depth, YAML::Node& node)
+	{
+		NodeTag tag;
+		uint32_t count = 0;
+		if (depth > MAX_NODE_DEPTH || !reader.read(tag))
+		{
+			return false;
+		}
+		if (tag != NodeTag::Null && (!reader.read(count) || count > MAX_RECORDS))
+		{
+			return false;
+		}
+
+		switch (tag)
+		{
+		case NodeTag::Null:
+			node = YAML::Node(YAML::NodeType::Null);
+			return true;
+		case NodeTag::Scalar:
+		{
+			std::string scalar;
+			if (!reader.readString(count, scalar))
+			{
+				return false;
+			}
+			node = YAML::Node(scalar);
+			return true;
+		}
+		case NodeTag::Sequence:
+			node = YAML::Node(YAML::NodeType::Sequence);
+			for (uint32_t i = 0; i < count; i++)
+			{
+				YAML::Node child;
+				if (!decodeNode(reader, depth + 1, child))
+				{
+					return false;
+				}
+				node.push_back(child);
+			}
+			return true;
+		case NodeTag::Map:
+			node = YAML::Node(YAML::NodeType::Map);
+			for (uint32_t i = 0; i < count; i++)
+			{
+				YAML::Node key;
+				YAML::Node value;
+				if (!decodeNode(reader, depth + 1, key) || !decodeNode(reader, depth + 1, value))
+				{
+					return false;
+				}
+				// Keys were unique when the meta file was parsed, so skip the lookup
+				node.force_insert(key, value);
+			}
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	bool decodeNode(const uint8_t* data, size_t const& size, YAML::Node& node)
+	{
+		Reader reader(data, size);
+		return decodeNode(reader, 0, node) && reader.getOffset() == size;
+	}
+
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <boost/uuid/uuid.hpp>
+#include "yaml-cpp\yaml.h"
+
+namespace DerydocaEngine::Resources
+{
+
+	/* Identifies the contents of a meta file at the time it was indexed */
+	struct MetaFileStamp
+	{
+		uint64_t size = 0;
+		int64_t writeTime = 0;
+		/* Hash of the contents of the meta file */
+		uint64_t hash = 0;
+	};
+
+	/*
+	Everything needed to create the resources of a single source file without parsing its meta file.
+	The encoded nodes are not owned, they point at memory such as a mapped index file.
+	*/
+	struct IndexedMetaFile
+	{
+		std::string sourceFilePath;
+		MetaFileStamp stamp;
+		/* The Resources node of the meta file, encoded with ResourceIndex::encodeNode */
+		const uint8_t* resourceNodes = nullptr;
+		size_t resourceNodesSize = 0;
+	};
+
+	/* Node of a resource tree, with its children referenced by their position in the tree */
+	struct IndexedTreeNode
+	{
+		std::string name;
+		std::vector<uint32_t> children;
+		std::vector<boost::uuids::uuid> resources;
+	};
+
+	/*
+	Reads and writes the .deryindex format, which caches the parsed meta files of a directory so
+	they do not have to be parsed again at startup, and the resource tree built from them. An index
+	is a fixed header followed by one record per meta file, and optionally the nodes of the tree in
+	depth first order.
+	*/
+	namespace ResourceIndex
+	{
+
+		/* Bump whenever the layout of the file or the encoding of the nodes changes */
+		static constexpr uint32_t FORMAT_VERSION = 1;
+
+		/*
+		Serializes the meta files of a directory.
+
+		@param buffer Receives the contents of the file
+		@param metaFiles Meta files to store
+		@param treeHash Hash of the resources the tree was built from
+		@param tree Nodes of the resource tree, the first being its root. May be empty.
+		*/
+		void write(std::vector<uint8_t>& buffer, std::vector<IndexedMetaFile> const& metaFiles, uint64_t const& treeHash, std::vector<IndexedTreeNode> const& tree);
+
+		/*
+		Reads an index without copying its encoded nodes.
+
+		@param data Contents of the file
+		@param size Size of the file in bytes
+		@param metaFiles Receives the meta files, pointing into data
+		@param treeHash Receives the hash of the resources the tree was built from
+		@param tree Receives the nodes of the resource tree
+
+		@return False if the data is not a complete index of the current version
+		*/
+		bool read(const uint8_t* data, size_t const& size, std::vector<IndexedMetaFile>& metaFiles, uint64_t& treeHash, std::vector<IndexedTreeNode>& tree);
+
+		/*
+		Encodes a YAML node and all of its children into a compact binary form.
+
+		@param node Node to encode
+		@param buffer Buffer the encoded node is appended to
+		*/
+		void encodeNode(YAML::Node const& node, std::vector<uint8_t>& buffer);
+
+		/*
+		Rebuilds a YAML node from its encoded form.
+
+		@param data Encoded node
+		@param size Size of the encoded node in bytes
+		@param node Receives the node
+
+		@return False if the data is not a complete encoded node
+		*/
+		bool decodeNode(const uint8_t* data, size_t const& size, YAML::Node& node);
+
+	}
+
+}
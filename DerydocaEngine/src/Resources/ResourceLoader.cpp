@@ -0,0 +1,282 @@
+#include "EnginePch.h"
+#include "Resources\ResourceLoader.h"
+
+#include <algorithm>
+#include "Resources\Serializers\ResourceSerializerLibrary.h"
+
+namespace DerydocaEngine::Resources
+{
+
+	ResourceLoader::Recording::Recording(ResourceDependencySet& dependencies) :
+		m_previousDependencies(nullptr)
+	{
+		ResourceLoader& loader = ResourceLoader::getInstance();
+		std::lock_guard<std::mutex> lock(loader.m_mutex);
+		m_previousDependencies = loader.m_recordedDependencies;
+		loader.m_recordedDependencies = &dependencies;
+		loader.m_recordingThread = std::this_thread::get_id();
+	}
+
+	ResourceLoader::Recording::~Recording()
+	{
+		ResourceLoader& loader = ResourceLoader::getInstance();
+		std::lock_guard<std::mutex> lock(loader.m_mutex);
+		loader.m_recordedDependencies = m_previousDependencies;
+	}
+
+	ResourceLoader::ResourceLoader() :
+		m_mutex(),
+		m_jobAvailable(),
+		m_uploadAvailable(),
+		m_workers(),
+		m_jobs(),
+		m_uploads(),
+		m_pendingHandles(),
+		m_importBatch(),
+		m_recordedDependencies(nullptr),
+		m_recordingThread(),
+		m_workerCount(0),
+		m_stopping(false),
+		m_uploadBudget(4.0),
+		m_loadedCount(0),
+		m_failedCount(0),
+		m_prepareTime(0.0),
+		m_uploadTime(0.0),
+		m_longestUploadFrame(0.0)
+	{
+	}
+
+	ResourceLoader::~ResourceLoader()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stopping = true;
+		}
+		m_jobAvailable.notify_all();
+
+		for (auto& worker : m_workers)
+		{
+			worker.join();
+		}
+	}
+
+	std::shared_ptr<ResourceHandle> ResourceLoader::load(std::shared_ptr<Resource> const& resource)
+	{
+		if (!resource)
+		{
+			return nullptr;
+		}
+
+		std::shared_ptr<void> loadedObject = resource->getLoadedObjectPointer();
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		std::shared_ptr<ResourceHandle> handle;
+		auto pendingHandle = m_pendingHandles.find(resource->getId());
+		if (pendingHandle != m_pendingHandles.end())
+		{
+			handle = pendingHandle->second;
+		}
+		else if (loadedObject)
+		{
+			handle = std::make_shared<ResourceHandle>(resource);
+			handle->setResident(loadedObject);
+		}
+		else
+		{
+			handle = std::make_shared<ResourceHandle>(resource);
+			m_pendingHandles[resource->getId()] = handle;
+			m_jobs.push_back(handle);
+
+			// Resources loaded together are often imported from the same file, so keep imports
+			// around until every pending load is over
+			if (!m_importBatch)
+			{
+				m_importBatch = std::make_unique<Helpers::AssimpImportCache::Batch>();
+			}
+
+			if (m_workers.empty())
+			{
+				startWorkers();
+			}
+			m_jobAvailable.notify_one();
+		}
+
+		if (m_recordedDependencies && std::this_thread::get_id() == m_recordingThread)
+		{
+			m_recordedDependencies->add(handle);
+		}
+
+		return handle;
+	}
+
+	void ResourceLoader::update()
+	{
+		auto startTime = std::chrono::high_resolution_clock::now();
+		std::chrono::duration<double, std::milli> elapsed(0.0);
+		bool finalized = false;
+		while (elapsed.count() < m_uploadBudget && finalizeNextUpload())
+		{
+			finalized = true;
+			elapsed = std::chrono::high_resolution_clock::now() - startTime;
+		}
+
+		if (finalized)
+		{
+			m_uploadTime += elapsed.count();
+			m_longestUploadFrame = std::max(m_longestUploadFrame, elapsed.count());
+		}
+	}
+
+	void ResourceLoader::waitFor(ResourceDependencySet const& dependencies)
+	{
+		while (!dependencies.isFinished())
+		{
+			auto startTime = std::chrono::high_resolution_clock::now();
+			if (finalizeNextUpload())
+			{
+				std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+				m_uploadTime += elapsed.count();
+				continue;
+			}
+
+			// Dependencies of queued uploads are only finished on this thread, so nothing can be
+			// finalized until a worker hands over another upload
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_uploadAvailable.wait(lock, [this]() { return findReadyUpload() != m_uploads.end(); });
+		}
+	}
+
+	size_t ResourceLoader::getPendingCount()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_pendingHandles.size();
+	}
+
+	void ResourceLoader::printStatistics() const
+	{
+		printf("Loaded %d resources asynchronously (%d failed), %.2fms preparing on %d worker threads and %.2fms uploading on the render thread, at most %.2fms in a single frame\n",
+			m_loadedCount,
+			m_failedCount,
+			m_prepareTime,
+			static_cast<int>(m_workers.size()),
+			m_uploadTime,
+			m_longestUploadFrame);
+	}
+
+	void ResourceLoader::startWorkers()
+	{
+		unsigned int workerCount = m_workerCount;
+		if (workerCount == 0)
+		{
+			// Leave a core for the render thread
+			unsigned int coreCount = std::thread::hardware_concurrency();
+			workerCount = coreCount > 1 ? coreCount - 1 : 1;
+		}
+
+		for (unsigned int i = 0; i < workerCount; i++)
+		{
+			m_workers.push_back(std::thread(&ResourceLoader::runWorker, this));
+		}
+	}
+
+	void ResourceLoader::runWorker()
+	{
+		while (true)
+		{
+			std::shared_ptr<ResourceHandle> handle;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_jobAvailable.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+				if (m_stopping)
+				{
+					return;
+				}
+
+				handle = m_jobs.front();
+				m_jobs.pop_front();
+			}
+
+			handle->setState(ResourceLoadState::Preparing);
+			auto startTime = std::chrono::high_resolution_clock::now();
+
+			PendingUpload upload;
+			upload.handle = handle;
+			auto resource = handle->getResource();
+			auto serializer = Serializers::ResourceSerializerLibrary::getInstance().getSerializer(resource->getType());
+			if (serializer)
+			{
+				upload.prepared = serializer->preparePointer(resource, upload.dependencies);
+			}
+
+			std::chrono::duration<double, std::milli> prepareTime = std::chrono::high_resolution_clock::now() - startTime;
+			handle->setState(ResourceLoadState::Uploading);
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_prepareTime += prepareTime.count();
+				m_uploads.push_back(std::move(upload));
+			}
+			m_uploadAvailable.notify_all();
+		}
+	}
+
+	std::deque<ResourceLoader::PendingUpload>::iterator ResourceLoader::findReadyUpload()
+	{
+		return std::find_if(m_uploads.begin(), m_uploads.end(), [](PendingUpload const& upload) {
+			return upload.dependencies.isFinished();
+		});
+	}
+
+	bool ResourceLoader::finalizeNextUpload()
+	{
+		PendingUpload upload;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto readyUpload = findReadyUpload();
+			if (readyUpload == m_uploads.end())
+			{
+				return false;
+			}
+
+			upload = std::move(*readyUpload);
+			m_uploads.erase(readyUpload);
+		}
+
+		auto resource = upload.handle->getResource();
+		auto serializer = Serializers::ResourceSerializerLibrary::getInstance().getSerializer(resource->getType());
+
+		// The resource may have been loaded synchronously while its files were being prepared
+		std::shared_ptr<void> object = resource->getLoadedObjectPointer();
+		if (!object && serializer)
+		{
+			object = resource->setResourceObjectPointer(serializer->finalizePointer(resource, upload.prepared));
+		}
+
+		finishLoad(upload.handle, object);
+		return true;
+	}
+
+	void ResourceLoader::finishLoad(std::shared_ptr<ResourceHandle> const& handle, std::shared_ptr<void> const& object)
+	{
+		if (object)
+		{
+			handle->setResident(object);
+			m_loadedCount++;
+		}
+		else
+		{
+			std::cout << "Unable to load resource: " << handle->getResource()->getSourceFilePath() << "\n";
+			handle->setState(ResourceLoadState::Failed);
+			m_failedCount++;
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_pendingHandles.erase(handle->getResource()->getId());
+		if (m_pendingHandles.empty())
+		{
+			m_importBatch.reset();
+		}
+	}
+
+}
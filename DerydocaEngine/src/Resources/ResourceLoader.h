@@ -0,0 +1,134 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <boost/uuid/uuid.hpp>
+#include "Helpers\AssimpImportCache.h"
+#include "Resources\ResourceHandle.h"
+
+namespace DerydocaEngine::Resources
+{
+
+	/*
+	Loads resources without stalling the render thread. Reading, decoding and processing files
+	happens on worker threads, while creating GL objects is queued for the render thread and
+	spread over frames so that only a limited amount of time is spent on uploads each frame.
+	*/
+	class ResourceLoader
+	{
+	public:
+		/*
+		Collects every load requested on the render thread while it exists, such as all the
+		resources used by the components of a scene being loaded.
+		*/
+		class Recording
+		{
+		public:
+			Recording(ResourceDependencySet& dependencies);
+			~Recording();
+
+			void operator=(Recording const&) = delete;
+		private:
+			Recording(Recording const&);
+
+			ResourceDependencySet* m_previousDependencies;
+		};
+
+		static ResourceLoader& getInstance()
+		{
+			static ResourceLoader instance;
+			return instance;
+		}
+
+		/*
+		Starts loading a resource, or finds the load that is already in progress. Can be called
+		from any thread.
+
+		@param resource Resource to load
+		@return Handle of the load, which is resident immediately if the resource was already loaded
+		*/
+		std::shared_ptr<ResourceHandle> load(std::shared_ptr<Resource> const& resource);
+
+		/*
+		Finalizes loads whose files are ready, until the upload budget of the frame is spent. At
+		least one load is finalized per call so that loads always make progress. Must be called on
+		the render thread.
+		*/
+		void update();
+
+		/*
+		Blocks until every load in a set is over, finalizing loads without a budget meanwhile. Must
+		be called on the render thread.
+
+		@param dependencies Loads to wait for
+		*/
+		void waitFor(ResourceDependencySet const& dependencies);
+
+		/*
+		Sets how long update may spend finalizing loads each frame.
+
+		@param milliseconds Upload budget of a frame
+		*/
+		void setUploadBudget(double const& milliseconds) { m_uploadBudget = milliseconds; }
+		double getUploadBudget() const { return m_uploadBudget; }
+
+		/*
+		Sets how many worker threads prepare resources. Only has an effect before the first load.
+
+		@param workerCount Number of worker threads
+		*/
+		void setWorkerCount(unsigned int const& workerCount) { m_workerCount = workerCount; }
+
+		/* Gets how many loads have been requested but are not over yet */
+		size_t getPendingCount();
+
+		/*
+		Prints how many resources were loaded and how the time was split between the worker
+		threads and the render thread.
+		*/
+		void printStatistics() const;
+
+		void operator=(ResourceLoader const&) = delete;
+	private:
+		struct PendingUpload
+		{
+			std::shared_ptr<ResourceHandle> handle;
+			std::shared_ptr<void> prepared;
+			ResourceDependencySet dependencies;
+		};
+
+		ResourceLoader();
+		ResourceLoader(ResourceLoader const&);
+		~ResourceLoader();
+
+		void startWorkers();
+		void runWorker();
+		std::deque<PendingUpload>::iterator findReadyUpload();
+		bool finalizeNextUpload();
+		void finishLoad(std::shared_ptr<ResourceHandle> const& handle, std::shared_ptr<void> const& object);
+
+		std::mutex m_mutex;
+		std::condition_variable m_jobAvailable;
+		std::condition_variable m_uploadAvailable;
+		std::vector<std::thread> m_workers;
+		std::deque<std::shared_ptr<ResourceHandle>> m_jobs;
+		std::deque<PendingUpload> m_uploads;
+		std::map<boost::uuids::uuid, std::shared_ptr<ResourceHandle>> m_pendingHandles;
+		std::unique_ptr<Helpers::AssimpImportCache::Batch> m_importBatch;
+		ResourceDependencySet* m_recordedDependencies;
+		std::thread::id m_recordingThread;
+		unsigned int m_workerCount;
+		bool m_stopping;
+		double m_uploadBudget;
+		int m_loadedCount;
+		int m_failedCount;
+		double m_prepareTime;
+		double m_uploadTime;
+		double m_longestUploadFrame;
+	};
+
+}
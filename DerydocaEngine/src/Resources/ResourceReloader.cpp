@@ -0,0 +1,249 @@
+#include "EnginePch.h"
+#include "Resources\ResourceReloader.h"
+
+#include <algorithm>
+#include "Helpers\AssimpImportCache.h"
+#include "Helpers\Statistics.h"
+#include "ObjectLibrary.h"
+#include "Resources\ResidencyManager.h"
+#include "Resources\Serializers\ResourceSerializerLibrary.h"
+#include "Scenes\SceneManager.h"
+#include "Scenes\SerializedScene.h"
+
+namespace DerydocaEngine::Resources
+{
+
+	// Shader resources are loaded from their vertex stage, so every other stage maps back to it
+	static const std::string SHADER_STAGE_EXTENSIONS[] = { ".vs", ".tcs", ".tes", ".gs", ".fs" };
+
+	// Files included by shaders, which are not resources of their own
+	static const std::string SHADER_INCLUDE_EXTENSIONS[] = { ".include", ".glsl" };
+
+	static const std::string LEVEL_EXTENSION = ".derylevel";
+
+	static std::string normalizePath(std::string const& path)
+	{
+		return boost::filesystem::absolute(path).lexically_normal().string();
+	}
+
+	template<size_t N>
+	static bool containsExtension(const std::string (&extensions)[N], std::string const& extension)
+	{
+		return std::find(std::begin(extensions), std::end(extensions), extension) != std::end(extensions);
+	}
+
+	ResourceReloader::ResourceReloader() :
+		m_mutex(),
+		m_reloads(),
+		m_scenes(),
+		m_fileWatcher()
+	{
+		m_fileWatcher.addListener([this](std::vector<std::string> const& changedFiles) {
+			reloadFiles(changedFiles);
+		});
+	}
+
+	ResourceReloader::~ResourceReloader()
+	{
+	}
+
+	void ResourceReloader::watchDirectory(boost::filesystem::path const& directory)
+	{
+		m_fileWatcher.watchDirectory(directory);
+	}
+
+	void ResourceReloader::update()
+	{
+		// Reloads wait until the resources they depend on, such as the textures of a material, are resident
+		std::vector<PendingReload> reloads;
+		std::vector<PendingScene> scenes;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto it = m_reloads.begin();
+			while (it != m_reloads.end())
+			{
+				if (it->dependencies.isFinished())
+				{
+					reloads.push_back(std::move(*it));
+					it = m_reloads.erase(it);
+				}
+				else
+				{
+					++it;
+				}
+			}
+			scenes.swap(m_scenes);
+		}
+
+		for (auto& reload : reloads)
+		{
+			finishReload(reload);
+		}
+
+		for (auto const& pendingScene : scenes)
+		{
+			finishSceneReload(pendingScene);
+		}
+	}
+
+	void ResourceReloader::reloadFiles(std::vector<std::string> const& changedFiles)
+	{
+		// Only resources that are loaded have to be reloaded, the rest read the new files whenever they load
+		std::map<std::string, std::vector<std::shared_ptr<Resource>>> resourcesByFile;
+		std::vector<std::shared_ptr<Resource>> shaderResources;
+		for (auto const& resource : ResidencyManager::getInstance().getResidentResources())
+		{
+			resourcesByFile[normalizePath(resource->getSourceFilePath())].push_back(resource);
+			if (resource->getType() == ShaderResourceType)
+			{
+				shaderResources.push_back(resource);
+			}
+		}
+
+		std::vector<std::shared_ptr<Resource>> resources;
+		std::vector<PendingScene> scenes;
+		for (auto const& changedFile : changedFiles)
+		{
+			boost::filesystem::path path(changedFile);
+			std::string extension = path.extension().string();
+
+			// Which file includes which is not tracked, so a changed include reloads every shader
+			if (containsExtension(SHADER_INCLUDE_EXTENSIONS, extension))
+			{
+				resources.insert(resources.end(), shaderResources.begin(), shaderResources.end());
+				continue;
+			}
+
+			if (containsExtension(SHADER_STAGE_EXTENSIONS, extension))
+			{
+				path.replace_extension(SHADER_STAGE_EXTENSIONS[0]);
+			}
+
+			auto fileResources = resourcesByFile.find(path.string());
+			if (fileResources != resourcesByFile.end())
+			{
+				resources.insert(resources.end(), fileResources->second.begin(), fileResources->second.end());
+			}
+
+			// Levels are parsed here, whether the scene is reloaded is decided on the render thread
+			if (extension == LEVEL_EXTENSION && boost::filesystem::exists(changedFile))
+			{
+				PendingScene pendingScene;
+				pendingScene.levelFilePath = changedFile;
+				pendingScene.scene = std::make_shared<Scenes::SerializedScene>();
+				try
+				{
+					pendingScene.scene->LoadFromFile(changedFile);
+					scenes.push_back(pendingScene);
+				}
+				catch (YAML::Exception const& e)
+				{
+					// Files are often saved while they are still being edited, so wait for the next save
+					std::cout << "Unable to reload level " << changedFile << ": " << e.what() << "\n";
+				}
+			}
+		}
+
+		std::sort(resources.begin(), resources.end());
+		resources.erase(std::unique(resources.begin(), resources.end()), resources.end());
+
+		// Resources imported from the same model file share a single import
+		Helpers::AssimpImportCache::Batch importBatch;
+
+		for (auto const& resource : resources)
+		{
+			auto serializer = Serializers::ResourceSerializerLibrary::getInstance().getSerializer(resource->getType());
+			if (!serializer || !serializer->canReloadObject())
+			{
+				std::cout << ResidencyManager::getTypeName(resource->getType()) << " resources can not be reloaded while they are loaded: " << resource->getSourceFilePath() << "\n";
+				continue;
+			}
+
+			if (!boost::filesystem::exists(resource->getSourceFilePath()))
+			{
+				continue;
+			}
+
+			PendingReload reload;
+			reload.resource = resource;
+			auto startTime = std::chrono::high_resolution_clock::now();
+			try
+			{
+				reload.prepared = serializer->preparePointer(resource, reload.dependencies);
+			}
+			catch (YAML::Exception const& e)
+			{
+				std::cout << "Unable to reload " << resource->getSourceFilePath() << ": " << e.what() << "\n";
+				continue;
+			}
+			std::chrono::duration<double, std::milli> prepareTime = std::chrono::high_resolution_clock::now() - startTime;
+			reload.prepareTime = prepareTime.count();
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_reloads.push_back(std::move(reload));
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_scenes.insert(m_scenes.end(), scenes.begin(), scenes.end());
+	}
+
+	void ResourceReloader::finishReload(PendingReload& reload)
+	{
+		// The resource may have been unloaded in the meantime, in which case it loads the new files next time
+		std::shared_ptr<void> object = reload.resource->getLoadedObjectPointer();
+		if (!object)
+		{
+			return;
+		}
+
+		auto startTime = std::chrono::high_resolution_clock::now();
+		auto serializer = Serializers::ResourceSerializerLibrary::getInstance().getSerializer(reload.resource->getType());
+		std::shared_ptr<void> reloadedObject;
+		try
+		{
+			reloadedObject = serializer->finalizePointer(reload.resource, reload.prepared);
+		}
+		catch (YAML::Exception const& e)
+		{
+			std::cout << "Unable to reload " << reload.resource->getSourceFilePath() << ": " << e.what() << "\n";
+			return;
+		}
+
+		if (!reloadedObject)
+		{
+			std::cout << "Unable to reload " << reload.resource->getSourceFilePath() << "\n";
+			return;
+		}
+
+		serializer->reloadObject(object, reloadedObject);
+
+		// The new version may use a different amount of memory
+		ResidencyManager::getInstance().track(reload.resource);
+
+		if (Helpers::Statistics::isEnabled())
+		{
+			std::chrono::duration<double, std::milli> swapTime = std::chrono::high_resolution_clock::now() - startTime;
+			printf("Reloaded %s in %.2fms on the render thread (%.2fms in the background)\n",
+				reload.resource->getSourceFilePath().c_str(),
+				swapTime.count(),
+				reload.prepareTime);
+		}
+	}
+
+	void ResourceReloader::finishSceneReload(PendingScene const& pendingScene)
+	{
+		Scenes::SceneManager& sceneManager = Scenes::SceneManager::getInstance();
+		auto activeLevel = sceneManager.getActiveLevel();
+		if (!activeLevel || normalizePath(activeLevel->getSourceFilePath()) != pendingScene.levelFilePath)
+		{
+			return;
+		}
+
+		if (Helpers::Statistics::isEnabled())
+		{
+			printf("Reloading the active scene from %s\n", pendingScene.levelFilePath.c_str());
+		}
+		sceneManager.loadScene(activeLevel, pendingScene.scene);
+	}
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include "Files\FileWatcher.h"
+#include "Resources\ResourceHandle.h"
+
+namespace DerydocaEngine::Scenes {
+	class SerializedScene;
+}
+
+namespace DerydocaEngine::Resources
+{
+
+	/*
+	Reloads the resources whose source files change while the engine is running. Changed files
+	are reported by a FileWatcher, and the resources loaded from them are read and decoded on its
+	thread. The results are swapped into the objects that are already loaded at the start of a
+	frame, so everything holding those objects picks up the new version. Resources that are not
+	loaded are left alone, since they read the new files whenever they are loaded.
+	*/
+	class ResourceReloader
+	{
+	public:
+		static ResourceReloader& getInstance()
+		{
+			static ResourceReloader instance;
+			return instance;
+		}
+
+		/*
+		Starts reloading resources whose files change in a directory or below it.
+
+		@param directory Directory to watch
+		*/
+		void watchDirectory(boost::filesystem::path const& directory);
+
+		/*
+		Swaps reloaded resources into the loaded objects, and reloads the active scene if its level
+		changed. Must be called on the render thread between frames.
+		*/
+		void update();
+
+		void operator=(ResourceReloader const&) = delete;
+	private:
+		/* A resource read from its changed files, waiting to be swapped into the loaded object */
+		struct PendingReload
+		{
+			std::shared_ptr<Resource> resource;
+			std::shared_ptr<void> prepared;
+			ResourceDependencySet dependencies;
+			double prepareTime = 0.0;
+		};
+
+		/* A level file that was parsed after it changed */
+		struct PendingScene
+		{
+			std::string levelFilePath;
+			std::shared_ptr<Scenes::SerializedScene> scene;
+		};
+
+		ResourceReloader();
+		ResourceReloader(ResourceReloader const&);
+		~ResourceReloader();
+
+		void reloadFiles(std::vector<std::string> const& changedFiles);
+		void finishReload(PendingReload& reload);
+		void finishSceneReload(PendingScene const& pendingScene);
+
+		std::mutex m_mutex;
+		std::deque<PendingReload> m_reloads;
+		std::vector<PendingScene> m_scenes;
+		Files::FileWatcher m_fileWatcher;
+	};
+
+}
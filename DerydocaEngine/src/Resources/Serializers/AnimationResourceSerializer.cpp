@@ -7,17 +7,22 @@
 #include "assimp\postprocess.h"
 #include "Animation\AnimationData.h"
 #include "Resources\AnimationResource.h"
+#include "Helpers\AssimpImportCache.h"
 #include "Helpers\AssimpUtils.h"
+#include "Helpers\Statistics.h"
 
 namespace DerydocaEngine::Resources::Serializers
 {
 
 	std::shared_ptr<void> AnimationResourceSerializer::deserializePointer(std::shared_ptr<Resource> resource)
 	{
-		Assimp::Importer importer;
-
 		auto ar = std::static_pointer_cast<AnimationResource>(resource);
-		const aiScene* scene = importer.ReadFile(resource->getSourceFilePath().c_str(), aiProcessPreset_TargetRealtime_MaxQuality);
+		auto sceneHandle = Helpers::AssimpImportCache::getInstance().getScene(resource->getSourceFilePath(), aiProcessPreset_TargetRealtime_MaxQuality);
+		if (!sceneHandle)
+		{
+			return nullptr;
+		}
+		const aiScene* scene = sceneHandle.get();
 
 		unsigned int animIndex = 0;
 		for (unsigned int i = 0; i < scene->mNumAnimations; i++)
@@ -30,7 +35,40 @@ namespace DerydocaEngine::Resources::Serializers
 			}
 		}
 
-		return Helpers::AssimpUtils::getAnimation(scene, animIndex);
+		auto animation = Helpers::AssimpUtils::getAnimation(scene, animIndex);
+		if (ar->getCompress())
+		{
+			Animation::AnimationCompression::CompressionSettings settings;
+			settings.tolerance = ar->getCompressionTolerance();
+
+			Animation::AnimationCompression::CompressionReport report;
+			if (animation->compress(Helpers::AssimpUtils::getAnimationHierarchy(scene, animIndex), settings, report) &&
+				Helpers::Statistics::isEnabled())
+			{
+				printf("Compressed animation %s in %.2fms: %zu of %zu keys, %.1f KB down to %.1f KB (%.1f:1), error at most %.4f\n",
+					animation->getName().c_str(),
+					report.compressTime,
+					report.compressedKeyCount,
+					report.rawKeyCount,
+					report.rawSize / 1024.0,
+					report.compressedSize / 1024.0,
+					report.compressedSize > 0 ? (double)report.rawSize / report.compressedSize : 0.0,
+					report.maxError);
+			}
+		}
+
+		if (ar->getPoseCache())
+		{
+			Animation::PoseCacheSettings poseCacheSettings;
+			poseCacheSettings.enabled = true;
+			poseCacheSettings.sampleRate = ar->getPoseCacheRate();
+			poseCacheSettings.maxKilobytes = ar->getPoseCacheKilobytes();
+			poseCacheSettings.minSampleRate = ar->getPoseCacheMinRate();
+			poseCacheSettings.interpolate = ar->getPoseCacheInterpolate();
+			animation->setPoseCacheSettings(poseCacheSettings);
+		}
+
+		return animation;
 	}
 
 }
@@ -8,6 +8,10 @@ namespace DerydocaEngine::Resources::Serializers
 	{
 	public:
 		virtual std::shared_ptr<void> deserializePointer(std::shared_ptr<Resource> resource);
+
+		// Animations do not own any GL objects, so they are loaded entirely on a loader thread
+		virtual std::shared_ptr<void> preparePointer(std::shared_ptr<Resource> resource, ResourceDependencySet& dependencies) { return deserializePointer(resource); }
+		virtual std::shared_ptr<void> finalizePointer(std::shared_ptr<Resource> resource, std::shared_ptr<void> prepared) { return prepared; }
 		virtual ResourceType getResourceType() { return ResourceType::AnimationResourceType; }
 	};
 
@@ -2,21 +2,108 @@
 #include "Resources\Serializers\CubemapResourceSerializer.h"
 #include "Resources\CubemapResource.h"
 #include "Rendering\Texture.h"
+#include "Resources\TextureCooker.h"
 
 namespace DerydocaEngine::Resources::Serializers
 {
 
 	std::shared_ptr<void> CubemapResourceSerializer::deserializePointer(std::shared_ptr<Resource> resource)
 	{
+		ResourceDependencySet dependencies;
+		return finalizePointer(resource, preparePointer(resource, dependencies));
+	}
+
+	std::shared_ptr<void> CubemapResourceSerializer::preparePointer(std::shared_ptr<Resource> resource, ResourceDependencySet& dependencies)
+	{
+		auto loadStartTime = std::chrono::high_resolution_clock::now();
 		auto cubemapResource = std::static_pointer_cast<CubemapResource>(resource);
+		auto prepared = std::make_shared<PreparedCubemap>();
+
+		// If the data in the source file is not matching what is expected by the resource, an empty texture is used
+		std::vector<std::string> faceFilePaths;
+		if (!getFaceFilePaths(cubemapResource, faceFilePaths))
+		{
+			return prepared;
+		}
+
+		// Compressed cubemaps are uploaded straight from a single mapped file, without decoding any face
+		TextureCooker& cooker = TextureCooker::getInstance();
+		bool compress = cubemapResource->getCompression() != Rendering::TextureCompressionFormat::None;
+		uint64_t settingsHash = compress ? cooker.calculateSettingsHash(cubemapResource) : 0;
+		prepared->fromCookedTexture = compress && cooker.load(cubemapResource, faceFilePaths, settingsHash, prepared->cookedFile, prepared->compressed);
+
+		if (!prepared->fromCookedTexture)
+		{
+			// The faces are decoded and filtered on every core, so the GL thread only has to upload them
+			if (!prepared->image.load(faceFilePaths, Rendering::MipSettings()))
+			{
+				return prepared;
+			}
 
+			if (compress)
+			{
+				cooker.cook(cubemapResource, faceFilePaths, settingsHash, prepared->image, prepared->cookedContents, prepared->compressed);
+				prepared->image.release();
+			}
+		}
+
+		std::chrono::duration<double, std::milli> prepareTime = std::chrono::high_resolution_clock::now() - loadStartTime;
+		prepared->prepareTime = prepareTime.count();
+
+		return prepared;
+	}
+
+	std::shared_ptr<void> CubemapResourceSerializer::finalizePointer(std::shared_ptr<Resource> resource, std::shared_ptr<void> preparedPointer)
+	{
+		auto prepared = std::static_pointer_cast<PreparedCubemap>(preparedPointer);
+		if (!prepared)
+		{
+			return nullptr;
+		}
+
+		auto uploadStartTime = std::chrono::high_resolution_clock::now();
+
+		auto texture = std::make_shared<Rendering::Texture>();
+		if (!prepared->compressed.levels.empty())
+		{
+			texture->updateCompressedCubemapBuffer(prepared->compressed);
+		}
+		else if (prepared->image.isLoaded())
+		{
+			texture->updateCubemapBuffer(prepared->image);
+		}
+		else
+		{
+			return texture;
+		}
+
+		std::chrono::duration<double, std::milli> uploadTime = std::chrono::high_resolution_clock::now() - uploadStartTime;
+		TextureCooker::getInstance().recordLoadTime(prepared->prepareTime + uploadTime.count(), prepared->fromCookedTexture);
+
+		return texture;
+	}
+
+	ResourceMemoryUsage CubemapResourceSerializer::getMemoryUsage(std::shared_ptr<void> const& object)
+	{
+		ResourceMemoryUsage usage;
+		usage.gpuBytes = std::static_pointer_cast<Rendering::Texture>(object)->getGpuMemoryUsage();
+		return usage;
+	}
+
+	void CubemapResourceSerializer::reloadObject(std::shared_ptr<void> const& object, std::shared_ptr<void> const& reloadedObject)
+	{
+		std::static_pointer_cast<Rendering::Texture>(object)->swap(*std::static_pointer_cast<Rendering::Texture>(reloadedObject));
+	}
+
+	bool CubemapResourceSerializer::getFaceFilePaths(std::shared_ptr<CubemapResource> const& resource, std::vector<std::string>& faceFilePaths)
+	{
 		// Load the yaml file
 		YAML::Node root = YAML::LoadFile(resource->getSourceFilePath());
 
 		YAML::Node materialParamsNode = root["MaterialParameters"];
 		if (!materialParamsNode || !materialParamsNode.IsSequence())
 		{
-			return std::make_shared<Rendering::Texture>();
+			return false;
 		}
 
 		for (unsigned int i = 0; i < materialParamsNode.size(); i++)
@@ -31,26 +118,24 @@ namespace DerydocaEngine::Resources::Serializers
 			}
 
 			// Only continue if the slot matches the one defined on the resource
-			if (slotNode.as<int>() != cubemapResource->getSlot())
+			if (slotNode.as<int>() != resource->getSlot())
 			{
 				continue;
 			}
 
-			// Grab all faces of the cubemap and build a cubemap texture from it
-			std::string xPosImage = getSourceFilePath(parameterNode, "XPos");
-			std::string xNegImage = getSourceFilePath(parameterNode, "XNeg");
-			std::string yPosImage = getSourceFilePath(parameterNode, "YPos");
-			std::string yNegImage = getSourceFilePath(parameterNode, "YNeg");
-			std::string zPosImage = getSourceFilePath(parameterNode, "ZPos");
-			std::string zNegImage = getSourceFilePath(parameterNode, "ZNeg");
-
-			// Create the cubemap texture and return the object
-			auto cubemapTexture = std::make_shared<Rendering::Texture>(xPosImage, xNegImage, yPosImage, yNegImage, zPosImage, zNegImage);
-			return cubemapTexture;
+			// Grab all faces of the cubemap
+			faceFilePaths = {
+				getSourceFilePath(parameterNode, "XPos"),
+				getSourceFilePath(parameterNode, "XNeg"),
+				getSourceFilePath(parameterNode, "YPos"),
+				getSourceFilePath(parameterNode, "YNeg"),
+				getSourceFilePath(parameterNode, "ZPos"),
+				getSourceFilePath(parameterNode, "ZNeg")
+			};
+			return true;
 		}
 
-		// If we got this far, the data in the source file is not matching what is expected by the resource
-		return std::make_shared<Rendering::Texture>();
+		return false;
 	}
 
 }
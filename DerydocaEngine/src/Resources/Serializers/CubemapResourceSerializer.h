@@ -1,5 +1,13 @@
 #pragma once
 #include "Resources\Serializers\ResourceSerializer.h"
+#include "Files\MappedFile.h"
+#include "Rendering\CubemapImage.h"
+#include "Rendering\TextureCompression.h"
+
+namespace DerydocaEngine::Resources
+{
+	struct CubemapResource;
+}
 
 namespace DerydocaEngine::Resources::Serializers
 {
@@ -8,7 +16,33 @@ namespace DerydocaEngine::Resources::Serializers
 	{
 	public:
 		virtual std::shared_ptr<void> deserializePointer(std::shared_ptr<Resource> resource);
+		virtual std::shared_ptr<void> preparePointer(std::shared_ptr<Resource> resource, ResourceDependencySet& dependencies);
+		virtual std::shared_ptr<void> finalizePointer(std::shared_ptr<Resource> resource, std::shared_ptr<void> prepared);
+		virtual ResourceMemoryUsage getMemoryUsage(std::shared_ptr<void> const& object);
+		virtual bool canReloadObject() { return true; }
+		virtual void reloadObject(std::shared_ptr<void> const& object, std::shared_ptr<void> const& reloadedObject);
 		virtual ResourceType getResourceType() { return ResourceType::CubemapResourceType; }
+
+	private:
+		/* Faces read on a loader thread, either decoded or block compressed, waiting to be uploaded */
+		struct PreparedCubemap
+		{
+			Rendering::CubemapImage image;
+			Files::MappedFile cookedFile;
+			std::vector<uint8_t> cookedContents;
+			Rendering::CompressedTextureData compressed;
+			bool fromCookedTexture = false;
+			double prepareTime = 0.0;
+		};
+
+		/*
+		Finds the faces of a cubemap in the material it belongs to.
+
+		@param resource Resource describing the cubemap
+		@param faceFilePaths Receives the source files of the faces, in the order +X, -X, +Y, -Y, +Z, -Z
+		@return False if the material has no cubemap in the resource's slot
+		*/
+		bool getFaceFilePaths(std::shared_ptr<CubemapResource> const& resource, std::vector<std::string>& faceFilePaths);
 	};
 
 }
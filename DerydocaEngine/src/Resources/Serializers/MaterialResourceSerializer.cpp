@@ -1,8 +1,10 @@
 #include "EnginePch.h"
 #include "Resources\Serializers\MaterialResourceSerializer.h"
 #include "Rendering\Material.h"
+#include "Rendering\MipGenerator.h"
 #include "Rendering\Texture.h"
 #include "Resources\Resource.h"
+#include "Resources\ResourceLoader.h"
 #include "Rendering\ShaderLibrary.h"
 
 namespace DerydocaEngine::Resources::Serializers
@@ -13,6 +15,57 @@ namespace DerydocaEngine::Resources::Serializers
 		// Load the yaml file
 		YAML::Node root = YAML::LoadFile(resource->getSourceFilePath());
 
+		return createMaterial(root, std::map<size_t, std::shared_ptr<Rendering::CubemapImage>>());
+	}
+
+	std::shared_ptr<void> MaterialResourceSerializer::preparePointer(std::shared_ptr<Resource> resource, ResourceDependencySet& dependencies)
+	{
+		auto prepared = std::make_shared<PreparedMaterial>();
+		prepared->root = YAML::LoadFile(resource->getSourceFilePath());
+
+		// Start loading the textures, the material is only created once they are all resident
+		YAML::Node parameters = prepared->root["MaterialParameters"];
+		for (size_t i = 0; i < parameters.size(); i++)
+		{
+			std::string paramType = parameters[i]["Type"].as<std::string>();
+			YAML::Node idNode = parameters[i]["ID"];
+			if (paramType == "Texture" && idNode)
+			{
+				auto texture = ObjectLibrary::getInstance().getResource(idNode.as<boost::uuids::uuid>());
+				dependencies.add(ResourceLoader::getInstance().load(texture));
+			}
+			else if (paramType == "Cubemap")
+			{
+				// Decode the faces here, so the render thread only has to upload them
+				auto cubemap = std::make_shared<Rendering::CubemapImage>();
+				cubemap->load({
+					getSourceFilePath(parameters[i], "XPos"),
+					getSourceFilePath(parameters[i], "XNeg"),
+					getSourceFilePath(parameters[i], "YPos"),
+					getSourceFilePath(parameters[i], "YNeg"),
+					getSourceFilePath(parameters[i], "ZPos"),
+					getSourceFilePath(parameters[i], "ZNeg")
+				}, Rendering::MipSettings());
+				prepared->cubemaps[i] = cubemap;
+			}
+		}
+
+		return prepared;
+	}
+
+	std::shared_ptr<void> MaterialResourceSerializer::finalizePointer(std::shared_ptr<Resource> resource, std::shared_ptr<void> prepared)
+	{
+		auto preparedMaterial = std::static_pointer_cast<PreparedMaterial>(prepared);
+		if (!preparedMaterial)
+		{
+			return nullptr;
+		}
+
+		return createMaterial(preparedMaterial->root, preparedMaterial->cubemaps);
+	}
+
+	std::shared_ptr<void> MaterialResourceSerializer::createMaterial(YAML::Node const& root, std::map<size_t, std::shared_ptr<Rendering::CubemapImage>> const& cubemaps)
+	{
 		// Load the shader specified in the file
 		boost::uuids::uuid shaderId = root["Shader"].as<boost::uuids::uuid>();
 		auto shader = Rendering::ShaderLibrary::getInstance().find(shaderId);
@@ -21,6 +74,16 @@ namespace DerydocaEngine::Resources::Serializers
 		auto material = std::make_shared<Rendering::Material>();
 		material->setShader(shader);
 
+		// Enable the shader keywords the material is built with
+		YAML::Node keywordsNode = root["Keywords"];
+		if (keywordsNode && keywordsNode.IsSequence())
+		{
+			for (size_t i = 0; i < keywordsNode.size(); i++)
+			{
+				material->enableKeyword(keywordsNode[i].as<std::string>());
+			}
+		}
+
 		// Assign all material parameters to the material
 		YAML::Node parameters = root["MaterialParameters"];
 		for (size_t i = 0; i < parameters.size(); i++)
@@ -54,6 +117,13 @@ namespace DerydocaEngine::Resources::Serializers
 				std::string paramName = parameters[i]["Name"].as<std::string>();
 				material->setBool(paramName, paramValue);
 			}
+			else if (paramType == "Cubemap" && cubemaps.count(i) > 0)
+			{
+				auto paramValue = std::make_shared<Rendering::Texture>();
+				paramValue->updateCubemapBuffer(*cubemaps.at(i));
+				std::string paramName = parameters[i]["Name"].as<std::string>();
+				material->setTexture(paramName, paramValue);
+			}
 			else if (paramType == "Cubemap")
 			{
 				std::string xpos = getSourceFilePath(parameters[i], "XPos");
@@ -71,4 +141,9 @@ namespace DerydocaEngine::Resources::Serializers
 		return material;
 	}
 
+	void MaterialResourceSerializer::reloadObject(std::shared_ptr<void> const& object, std::shared_ptr<void> const& reloadedObject)
+	{
+		std::static_pointer_cast<Rendering::Material>(object)->copyFrom(std::static_pointer_cast<Rendering::Material>(reloadedObject));
+	}
+
 }
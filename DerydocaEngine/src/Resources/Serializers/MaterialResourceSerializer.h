@@ -1,5 +1,7 @@
 #pragma once
+#include <map>
 #include "Resources\Serializers\ResourceSerializer.h"
+#include "Rendering\CubemapImage.h"
 
 namespace DerydocaEngine::Resources::Serializers
 {
@@ -8,7 +10,22 @@ namespace DerydocaEngine::Resources::Serializers
 	{
 	public:
 		virtual std::shared_ptr<void> deserializePointer(std::shared_ptr<Resource> resource);
+		virtual std::shared_ptr<void> preparePointer(std::shared_ptr<Resource> resource, ResourceDependencySet& dependencies);
+		virtual std::shared_ptr<void> finalizePointer(std::shared_ptr<Resource> resource, std::shared_ptr<void> prepared);
+		virtual bool canReloadObject() { return true; }
+		virtual void reloadObject(std::shared_ptr<void> const& object, std::shared_ptr<void> const& reloadedObject);
 		virtual ResourceType getResourceType() { return ResourceType::MaterialResourceType; }
+
+	private:
+		/* Material file read on a loader thread, along with the faces of its cubemaps */
+		struct PreparedMaterial
+		{
+			YAML::Node root;
+			/* Decoded cubemaps by the index of their parameter */
+			std::map<size_t, std::shared_ptr<Rendering::CubemapImage>> cubemaps;
+		};
+
+		std::shared_ptr<void> createMaterial(YAML::Node const& root, std::map<size_t, std::shared_ptr<Rendering::CubemapImage>> const& cubemaps);
 	};
 
 }
@@ -1,29 +1,96 @@
 #include "EnginePch.h"
 #include "Resources\Serializers\MeshResourceSerializer.h"
+#include "Resources\MeshCooker.h"
 #include "Resources\MeshResource.h"
 #include "Rendering\Mesh.h"
+#include "Rendering\TextureStreaming.h"
 #include "assimp\importer.hpp"
 #include "assimp\cimport.h"
 #include "assimp\scene.h"
 #include "assimp\postprocess.h"
 
+#include "Helpers\AssimpImportCache.h"
+#include "Helpers\Statistics.h"
 #include "MeshAdjacencyCalculator.h"
 
 namespace DerydocaEngine::Resources::Serializers
 {
 	std::shared_ptr<void> MeshResourceSerializer::deserializePointer(std::shared_ptr<Resource> resource)
 	{
+		ResourceDependencySet dependencies;
+		return finalizePointer(resource, preparePointer(resource, dependencies));
+	}
+
+	std::shared_ptr<void> MeshResourceSerializer::preparePointer(std::shared_ptr<Resource> resource, ResourceDependencySet& dependencies)
+	{
+		auto loadStartTime = std::chrono::high_resolution_clock::now();
 		auto mr = std::static_pointer_cast<MeshResource>(resource);
+		auto prepared = std::make_shared<PreparedMesh>();
 
-		std::shared_ptr<Animation::Skeleton> skeleton;
 		if (mr->hasSkeleton())
 		{
-			skeleton = ObjectLibrary::getInstance().getResourceObjectPointer<Animation::Skeleton>(mr->getSkeletonId());
+			prepared->skeleton = ObjectLibrary::getInstance().getResourceObjectPointer<Animation::Skeleton>(mr->getSkeletonId());
+		}
+
+		// Use the cooked copy of the mesh when it is up to date, it is uploaded straight from the mapped file
+		MeshCooker& cooker = MeshCooker::getInstance();
+		uint64_t settingsHash = cooker.calculateSettingsHash(mr, prepared->skeleton);
+		prepared->fromCookedMesh = cooker.load(mr, settingsHash, prepared->skeleton, prepared->cookedFile, prepared->packedMesh);
+
+		if (!prepared->fromCookedMesh && !importMesh(mr, settingsHash, *prepared))
+		{
+			return nullptr;
 		}
-		
-		Assimp::Importer importer;
 
-		const aiScene* aiScene = importer.ReadFile(resource->getSourceFilePath().c_str(), aiProcessPreset_TargetRealtime_MaxQuality);
+		std::chrono::duration<double, std::milli> prepareTime = std::chrono::high_resolution_clock::now() - loadStartTime;
+		prepared->prepareTime = prepareTime.count();
+
+		return prepared;
+	}
+
+	std::shared_ptr<void> MeshResourceSerializer::finalizePointer(std::shared_ptr<Resource> resource, std::shared_ptr<void> preparedPointer)
+	{
+		auto prepared = std::static_pointer_cast<PreparedMesh>(preparedPointer);
+		if (!prepared)
+		{
+			return nullptr;
+		}
+
+		auto uploadStartTime = std::chrono::high_resolution_clock::now();
+		auto mr = std::static_pointer_cast<MeshResource>(resource);
+
+		auto m = std::make_shared<Rendering::Mesh>(prepared->packedMesh, Rendering::MeshStorage::Arena);
+		m->setSkeleton(prepared->skeleton);
+		if (Helpers::Statistics::isEnabled())
+		{
+			m->printMemoryReport(mr->getMeshName());
+		}
+
+		m->setFlags(mr->getFlags());
+
+		std::chrono::duration<double, std::milli> uploadTime = std::chrono::high_resolution_clock::now() - uploadStartTime;
+		MeshCooker::getInstance().recordLoadTime(prepared->prepareTime + uploadTime.count(), prepared->fromCookedMesh);
+
+		return std::static_pointer_cast<void>(m);
+	}
+
+	ResourceMemoryUsage MeshResourceSerializer::getMemoryUsage(std::shared_ptr<void> const& object)
+	{
+		auto mesh = std::static_pointer_cast<Rendering::Mesh>(object);
+		ResourceMemoryUsage usage;
+		usage.cpuBytes = mesh->getCpuMemoryUsage();
+		usage.gpuBytes = mesh->getGpuMemoryUsage();
+		return usage;
+	}
+
+	bool MeshResourceSerializer::importMesh(std::shared_ptr<MeshResource> const& mr, uint64_t const& settingsHash, PreparedMesh& prepared)
+	{
+		auto sceneHandle = Helpers::AssimpImportCache::getInstance().getScene(mr->getSourceFilePath(), aiProcessPreset_TargetRealtime_MaxQuality);
+		if (!sceneHandle)
+		{
+			return false;
+		}
+		const aiScene* aiScene = sceneHandle.get();
 
 		int uvIndex = 0;
 
@@ -47,31 +114,65 @@ namespace DerydocaEngine::Resources::Serializers
 		std::vector<unsigned int> m_indices;
 		std::vector<glm::vec3> m_tangents;
 		std::vector<glm::vec3> m_bitangents;
+		std::vector<Color> m_colors;
 		std::vector<Animation::VertexBoneWeights> m_boneWeights;
 		Rendering::MeshFlags m_flags = mr->getFlags();
 
 		ProcessMeshData(mesh, m_positions, uvIndex, m_texCoords, m_normals, m_flags, m_indices, m_tangents, m_bitangents);
 
+		std::vector<Rendering::CookedBoneBinding> boneBindings;
 		if (mesh->mNumBones > 0)
 		{
-			ProcessBoneData(mesh, m_boneWeights, skeleton);
+			ProcessBoneData(mesh, m_boneWeights, prepared.skeleton);
+
+			for (unsigned int i = 0; i < mesh->mNumBones; i++)
+			{
+				std::string boneName = mesh->mBones[i]->mName.data;
+				boneBindings.push_back({ boneName, prepared.skeleton->getBoneID(boneName) });
+			}
 		}
 
-		std::shared_ptr<Rendering::Mesh> m = std::make_shared<Rendering::Mesh>(
-				m_positions,
-				m_indices,
-				m_normals,
-				m_texCoords,
-				m_tangents,
-				m_bitangents,
-				std::vector<Color>(),
-				m_boneWeights);
+		// Pick the most compact vertex layout that can represent this mesh
+		Rendering::VertexLayout vertexLayout = Rendering::VertexLayout::uncompressed();
+		if (mr->getCompressVertices())
+		{
+			size_t boneCount = prepared.skeleton ? prepared.skeleton->getNumBones() : 0;
+			vertexLayout = Rendering::VertexLayout::selectForMesh(m_texCoords, boneCount, mr->getOctahedralNormals());
+		}
 
-		m->setSkeleton(skeleton);
+		// Encode the vertices in their final form, which is both cooked and uploaded
+		Rendering::VertexStreams streams = { &m_positions, &m_normals, &m_texCoords, &m_tangents, &m_bitangents, &m_colors, &m_boneWeights };
+		Rendering::VertexBufferBuilder builder(vertexLayout, streams);
+		builder.build(prepared.vertexData);
+		int indicesPerTriangle = (m_flags & Rendering::MeshFlags::load_adjacent) ? 6 : 3;
+		float uvDensity = Rendering::TextureStreaming::calculateUvDensity(m_positions, m_texCoords, m_indices, indicesPerTriangle);
+		prepared.indices = std::move(m_indices);
 
-		m->setFlags(mr->getFlags());
+		Rendering::PackedMeshData& packedMesh = prepared.packedMesh;
+		packedMesh.layout = vertexLayout;
+		packedMesh.attributes = builder.getAttributes();
+		packedMesh.stride = builder.getStride();
+		packedMesh.uncompressedStride = builder.getUncompressedStride();
+		packedMesh.vertexData = prepared.vertexData.data();
+		packedMesh.vertexCount = builder.getVertexCount();
+		packedMesh.indices = prepared.indices.data();
+		packedMesh.indexCount = prepared.indices.size();
+		packedMesh.flags = m_flags;
+		packedMesh.uvDensity = uvDensity;
+		if (!m_positions.empty())
+		{
+			packedMesh.boundsMin = m_positions[0];
+			packedMesh.boundsMax = m_positions[0];
+			for (auto const& position : m_positions)
+			{
+				packedMesh.boundsMin = glm::min(packedMesh.boundsMin, position);
+				packedMesh.boundsMax = glm::max(packedMesh.boundsMax, position);
+			}
+		}
 
-		return std::static_pointer_cast<void>(m);
+		MeshCooker::getInstance().save(mr, settingsHash, packedMesh, boneBindings);
+
+		return true;
 	}
 
 	void MeshResourceSerializer::ProcessMeshData(
@@ -187,4 +288,9 @@ namespace DerydocaEngine::Resources::Serializers
 		}
 	}
 
+	void MeshResourceSerializer::reloadObject(std::shared_ptr<void> const& object, std::shared_ptr<void> const& reloadedObject)
+	{
+		std::static_pointer_cast<Rendering::Mesh>(object)->swap(*std::static_pointer_cast<Rendering::Mesh>(reloadedObject));
+	}
+
 }
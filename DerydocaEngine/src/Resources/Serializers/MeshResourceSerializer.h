@@ -7,6 +7,10 @@
 #include "Resources\Serializers\ResourceSerializer.h"
 #include "MeshFlags.h"
 #include "Animation\Skeleton.h"
+#include "Files\MappedFile.h"
+#include "Rendering\CookedMesh.h"
+#include "Rendering\Mesh.h"
+#include "Resources\MeshResource.h"
 
 struct aiMesh;
 
@@ -17,6 +21,9 @@ namespace DerydocaEngine::Resources::Serializers
 	{
 	public:
 		virtual std::shared_ptr<void> deserializePointer(std::shared_ptr<Resource> resource);
+		virtual std::shared_ptr<void> preparePointer(std::shared_ptr<Resource> resource, ResourceDependencySet& dependencies);
+		virtual std::shared_ptr<void> finalizePointer(std::shared_ptr<Resource> resource, std::shared_ptr<void> prepared);
+		virtual ResourceMemoryUsage getMemoryUsage(std::shared_ptr<void> const& object);
 		void ProcessMeshData(
 			aiMesh * &mesh,
 			std::vector<glm::vec3> &m_positions,
@@ -31,10 +38,24 @@ namespace DerydocaEngine::Resources::Serializers
 			aiMesh * mesh,
 			std::vector<Animation::VertexBoneWeights> &m_boneWeights,
 			const std::shared_ptr<Animation::Skeleton>& skeleton);
+		virtual bool canReloadObject() { return true; }
+		virtual void reloadObject(std::shared_ptr<void> const& object, std::shared_ptr<void> const& reloadedObject);
 		virtual ResourceType getResourceType() { return ResourceType::MeshResourceType; }
 
 	private:
+		/* Geometry of a mesh read on a loader thread, waiting to be uploaded */
+		struct PreparedMesh
+		{
+			std::shared_ptr<Animation::Skeleton> skeleton;
+			Files::MappedFile cookedFile;
+			Rendering::PackedMeshData packedMesh;
+			std::vector<uint8_t> vertexData;
+			std::vector<unsigned int> indices;
+			bool fromCookedMesh = false;
+			double prepareTime = 0.0;
+		};
 
+		bool importMesh(std::shared_ptr<MeshResource> const& mr, uint64_t const& settingsHash, PreparedMesh& prepared);
 	};
 
 }
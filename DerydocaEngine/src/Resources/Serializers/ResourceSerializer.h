@@ -6,6 +6,8 @@
 #include "Helpers\YamlTools.h"
 #include "ObjectLibrary.h"
 #include "Resources\Resource.h"
+#include "Resources\ResourceHandle.h"
+#include "Resources\ResidencyManager.h"
 
 namespace DerydocaEngine::Resources::Serializers
 {
@@ -15,6 +17,47 @@ namespace DerydocaEngine::Resources::Serializers
 	public:
 		virtual ~ResourceSerializer() {}
 		virtual std::shared_ptr<void> deserializePointer(std::shared_ptr<Resource> resource) { return nullptr; }
+
+		/*
+		Does the part of loading a resource that does not need the graphics API, such as reading
+		and decoding files. Called on a loader thread, so it must not touch any GL state.
+
+		@param resource Resource to load
+		@param dependencies Receives loads that must finish before the resource is finalized
+		@return State handed to finalizePointer
+		*/
+		virtual std::shared_ptr<void> preparePointer(std::shared_ptr<Resource> resource, ResourceDependencySet& dependencies) { return nullptr; }
+
+		/*
+		Finishes loading a resource on the render thread, creating its graphics API objects. By
+		default the whole resource is loaded here.
+
+		@param resource Resource to load
+		@param prepared State returned by preparePointer
+		@return The loaded object, or null if it could not be loaded
+		*/
+		virtual std::shared_ptr<void> finalizePointer(std::shared_ptr<Resource> resource, std::shared_ptr<void> prepared) { return deserializePointer(resource); }
+
+		/*
+		Gets how much memory a loaded object holds, used to keep each type of resource within its budget.
+
+		@param object Object loaded by this serializer
+		@return Memory held by the object
+		*/
+		virtual ResourceMemoryUsage getMemoryUsage(std::shared_ptr<void> const& object) { return ResourceMemoryUsage(); }
+
+		/* Gets whether loaded objects can take over the contents of a reloaded object */
+		virtual bool canReloadObject() { return false; }
+
+		/*
+		Replaces the contents of a loaded object with those of an object that was just loaded from
+		changed files, so everything holding the loaded object sees the new version. Called on the
+		render thread.
+
+		@param object Object held by the resource
+		@param reloadedObject Object loaded from the changed files
+		*/
+		virtual void reloadObject(std::shared_ptr<void> const& object, std::shared_ptr<void> const& reloadedObject) {}
 		virtual ResourceType getResourceType() = 0;
 
 	protected:
@@ -15,4 +15,40 @@ namespace DerydocaEngine::Resources::Serializers
 		return shader;
 	}
 
+	std::shared_ptr<void> ShaderResourceSerializer::preparePointer(std::shared_ptr<Resource> resource, ResourceDependencySet& dependencies)
+	{
+		auto shaderResource = std::static_pointer_cast<ShaderResource>(resource);
+
+		// Reading the stage files and expanding their includes does not need a GL context
+		auto prepared = std::make_shared<PreparedShader>();
+		prepared->sources = Rendering::Shader::preprocessSources(shaderResource->getRawShaderName(), {}, prepared->keywords);
+		return prepared;
+	}
+
+	std::shared_ptr<void> ShaderResourceSerializer::finalizePointer(std::shared_ptr<Resource> resource, std::shared_ptr<void> preparedPointer)
+	{
+		auto prepared = std::static_pointer_cast<PreparedShader>(preparedPointer);
+		if (!prepared)
+		{
+			return nullptr;
+		}
+
+		auto shaderResource = std::static_pointer_cast<ShaderResource>(resource);
+		return std::make_shared<Rendering::Shader>(shaderResource->getRawShaderName(), prepared->sources, prepared->keywords, Rendering::ShaderVariantKey(), std::vector<std::string>());
+	}
+
+	void ShaderResourceSerializer::reloadObject(std::shared_ptr<void> const& object, std::shared_ptr<void> const& reloadedObject)
+	{
+		auto reloadedShader = std::static_pointer_cast<Rendering::Shader>(reloadedObject);
+
+		// Keep rendering with the previous program rather than a broken one while the source is being edited
+		if (!reloadedShader->isLinked())
+		{
+			std::cerr << "Unable to link the changed shader, keeping the previous program: " << reloadedShader->GetLoadPath() << "\n";
+			return;
+		}
+
+		std::static_pointer_cast<Rendering::Shader>(object)->swapProgram(*reloadedShader);
+	}
+
 }
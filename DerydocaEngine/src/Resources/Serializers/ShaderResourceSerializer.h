@@ -1,5 +1,6 @@
 #pragma once
 #include "Resources\Serializers\ResourceSerializer.h"
+#include "Rendering\Shader.h"
 
 namespace DerydocaEngine::Resources::Serializers
 {
@@ -8,7 +9,19 @@ namespace DerydocaEngine::Resources::Serializers
 	{
 	public:
 		virtual std::shared_ptr<void> deserializePointer(std::shared_ptr<Resource> resource);
+		virtual std::shared_ptr<void> preparePointer(std::shared_ptr<Resource> resource, ResourceDependencySet& dependencies);
+		virtual std::shared_ptr<void> finalizePointer(std::shared_ptr<Resource> resource, std::shared_ptr<void> prepared);
+		virtual bool canReloadObject() { return true; }
+		virtual void reloadObject(std::shared_ptr<void> const& object, std::shared_ptr<void> const& reloadedObject);
 		virtual ResourceType getResourceType() { return ResourceType::ShaderResourceType; }
+
+	private:
+		/* Source of a shader read and preprocessed on a loader thread, waiting to be compiled */
+		struct PreparedShader
+		{
+			std::array<std::string, Rendering::Shader::NUM_SHADERS> sources;
+			std::vector<std::string> keywords;
+		};
 	};
 
 }
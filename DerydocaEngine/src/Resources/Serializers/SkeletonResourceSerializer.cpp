@@ -5,6 +5,7 @@
 #include "assimp\cimport.h"
 #include "assimp\scene.h"
 #include "assimp\postprocess.h"
+#include "Helpers\AssimpImportCache.h"
 #include "Helpers\AssimpUtils.h"
 #include "Animation\Skeleton.h"
 #include "Resources\SkeletonResource.h"
@@ -15,8 +16,12 @@ namespace DerydocaEngine::Resources::Serializers
 	std::shared_ptr<void> SkeletonResourceSerializer::deserializePointer(std::shared_ptr<Resource> resource)
 	{
 		auto sr = std::static_pointer_cast<SkeletonResource>(resource);
-		Assimp::Importer importer;
-		auto scene = importer.ReadFile(resource->getSourceFilePath().c_str(), aiProcessPreset_TargetRealtime_MaxQuality);
+		auto sceneHandle = Helpers::AssimpImportCache::getInstance().getScene(resource->getSourceFilePath(), aiProcessPreset_TargetRealtime_MaxQuality);
+		if (!sceneHandle)
+		{
+			return nullptr;
+		}
+		const aiScene* scene = sceneHandle.get();
 
 		return Helpers::AssimpUtils::getSkeleton(scene, 0);
 	}
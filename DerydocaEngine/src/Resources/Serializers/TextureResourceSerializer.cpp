@@ -2,17 +2,106 @@
 #include "Resources\Serializers\TextureResourceSerializer.h"
 #include "Rendering\Texture.h"
 #include "Resources\Resource.h"
+#include "Resources\TextureCooker.h"
+#include "Resources\TextureResource.h"
+#include "Resources\TextureStreamer.h"
 
 namespace DerydocaEngine::Resources::Serializers
 {
 
 	std::shared_ptr<void> TextureResourceSerializer::deserializePointer(std::shared_ptr<Resource> resource)
 	{
-		std::string sourceFilePath = resource->getSourceFilePath();
+		ResourceDependencySet dependencies;
+		return finalizePointer(resource, preparePointer(resource, dependencies));
+	}
+
+	std::shared_ptr<void> TextureResourceSerializer::preparePointer(std::shared_ptr<Resource> resource, ResourceDependencySet& dependencies)
+	{
+		auto loadStartTime = std::chrono::high_resolution_clock::now();
+		auto textureResource = std::static_pointer_cast<TextureResource>(resource);
+		auto prepared = std::make_shared<PreparedTexture>();
+
+		// Compressed textures are uploaded straight from the mapped cooked file, without decoding anything
+		TextureCooker& cooker = TextureCooker::getInstance();
+		bool compress = textureResource->getCompression() != Rendering::TextureCompressionFormat::None;
+		uint64_t settingsHash = compress ? cooker.calculateSettingsHash(textureResource) : 0;
+		prepared->fromCookedTexture = compress && cooker.load(textureResource, settingsHash, prepared->cookedFile, prepared->compressed);
+
+		if (!prepared->fromCookedTexture)
+		{
+			// Decoding is the slow part of loading a texture and does not need a GL context
+			if (!prepared->image.load(resource->getSourceFilePath(), true))
+			{
+				std::cout << "Unable to load image.\n";
+				return nullptr;
+			}
 
-		auto texture = std::make_shared<Rendering::Texture>(sourceFilePath);
+			if (compress)
+			{
+				cooker.cook(textureResource, settingsHash, prepared->image, prepared->cookedContents, prepared->compressed);
+			}
+			else
+			{
+				// Mips are filtered here rather than by the driver, so the GL thread only has to upload them
+				Rendering::MipGenerator::generate(prepared->image.getData(), prepared->image.getWidth(), prepared->image.getHeight(), prepared->image.getChannels(), textureResource->getMipSettings(), prepared->mipLevels);
+				prepared->channels = prepared->image.getChannels();
+			}
+			prepared->image.release();
+		}
+
+		std::chrono::duration<double, std::milli> prepareTime = std::chrono::high_resolution_clock::now() - loadStartTime;
+		prepared->prepareTime = prepareTime.count();
+
+		return prepared;
+	}
+
+	std::shared_ptr<void> TextureResourceSerializer::finalizePointer(std::shared_ptr<Resource> resource, std::shared_ptr<void> preparedPointer)
+	{
+		auto prepared = std::static_pointer_cast<PreparedTexture>(preparedPointer);
+		if (!prepared)
+		{
+			return nullptr;
+		}
 
-		return texture; 
+		auto uploadStartTime = std::chrono::high_resolution_clock::now();
+
+		auto texture = std::make_shared<Rendering::Texture>();
+		TextureStreamer& streamer = TextureStreamer::getInstance();
+		if (!prepared->compressed.levels.empty() && streamer.isEnabled() && prepared->compressed.levels.size() > 1)
+		{
+			// Only the smallest levels are uploaded now, the rest are streamed in once something
+			// on screen needs them, so the cooked file is kept until the texture is unloaded
+			texture->updateCompressedBuffer(prepared->compressed, nullptr, streamer.getInitialLevel(prepared->compressed));
+			streamer.registerTexture(texture, prepared->compressed, prepared);
+		}
+		else if (!prepared->compressed.levels.empty())
+		{
+			texture->updateCompressedBuffer(prepared->compressed, nullptr);
+		}
+		else
+		{
+			texture->updateMipmappedBuffer(prepared->mipLevels, prepared->channels, nullptr);
+		}
+
+		std::chrono::duration<double, std::milli> uploadTime = std::chrono::high_resolution_clock::now() - uploadStartTime;
+		TextureCooker::getInstance().recordLoadTime(prepared->prepareTime + uploadTime.count(), prepared->fromCookedTexture);
+
+		return texture;
+	}
+
+	ResourceMemoryUsage TextureResourceSerializer::getMemoryUsage(std::shared_ptr<void> const& object)
+	{
+		// The decoded image or cooked file is released once it is uploaded, so only the GPU copy
+		// remains. Streamed textures keep their cooked file mapped, which takes address space rather
+		// than memory, and only count the levels that are currently resident.
+		ResourceMemoryUsage usage;
+		usage.gpuBytes = std::static_pointer_cast<Rendering::Texture>(object)->getGpuMemoryUsage();
+		return usage;
+	}
+
+	void TextureResourceSerializer::reloadObject(std::shared_ptr<void> const& object, std::shared_ptr<void> const& reloadedObject)
+	{
+		std::static_pointer_cast<Rendering::Texture>(object)->swap(*std::static_pointer_cast<Rendering::Texture>(reloadedObject));
 	}
 
 }
@@ -1,5 +1,9 @@
 #pragma once
 #include "Resources\Serializers\MaterialResourceSerializer.h"
+#include "Files\MappedFile.h"
+#include "Rendering\MipGenerator.h"
+#include "Rendering\TextureCompression.h"
+#include "Rendering\TextureImage.h"
 
 namespace DerydocaEngine::Resources::Serializers
 {
@@ -8,7 +12,26 @@ namespace DerydocaEngine::Resources::Serializers
 	{
 	public:
 		virtual std::shared_ptr<void> deserializePointer(std::shared_ptr<Resource> resource);
+		virtual std::shared_ptr<void> preparePointer(std::shared_ptr<Resource> resource, ResourceDependencySet& dependencies);
+		virtual std::shared_ptr<void> finalizePointer(std::shared_ptr<Resource> resource, std::shared_ptr<void> prepared);
+		virtual ResourceMemoryUsage getMemoryUsage(std::shared_ptr<void> const& object);
+		virtual bool canReloadObject() { return true; }
+		virtual void reloadObject(std::shared_ptr<void> const& object, std::shared_ptr<void> const& reloadedObject);
 		virtual ResourceType getResourceType() { return ResourceType::TextureResourceType; }
+
+	private:
+		/* Texture read on a loader thread, either decoded or block compressed, waiting to be uploaded */
+		struct PreparedTexture
+		{
+			Rendering::TextureImage image;
+			std::vector<Rendering::MipLevel> mipLevels;
+			int channels = 0;
+			Files::MappedFile cookedFile;
+			std::vector<uint8_t> cookedContents;
+			Rendering::CompressedTextureData compressed;
+			bool fromCookedTexture = false;
+			double prepareTime = 0.0;
+		};
 	};
 
 }
@@ -0,0 +1,384 @@
+#include "EnginePch.h"
+#include "Resources\TextureCooker.h"
+
+#include <boost/uuid/uuid_io.hpp>
+#include <limits>
+#include "Helpers\HashUtils.h"
+#include "Helpers\Statistics.h"
+#include "Resources\CubemapResource.h"
+
+namespace DerydocaEngine::Resources
+{
+
+	TextureCooker::TextureCooker() :
+		m_cacheDirectory(),
+		m_mutex(),
+		m_cookedLoadCount(0),
+		m_decodedLoadCount(0),
+		m_cookedLoadTime(0.0),
+		m_decodedLoadTime(0.0),
+		m_cookCount(0),
+		m_cookTime(0.0),
+		m_uncompressedBytes(0),
+		m_compressedBytes(0),
+		m_lowestPsnr(std::numeric_limits<double>::infinity())
+	{
+	}
+
+	TextureCooker::~TextureCooker()
+	{
+	}
+
+	uint64_t TextureCooker::calculateSettingsHash(std::shared_ptr<TextureResource> const& resource) const
+	{
+		return hashSettings(resource->getCompression(), resource->getCompressionQuality(), resource->getMipSettings(), 1);
+	}
+
+	uint64_t TextureCooker::calculateSettingsHash(std::shared_ptr<CubemapResource> const& resource) const
+	{
+		return hashSettings(resource->getCompression(), resource->getCompressionQuality(), Rendering::MipSettings(), Rendering::CubemapImage::FACE_COUNT);
+	}
+
+	bool TextureCooker::load(std::shared_ptr<TextureResource> const& resource, uint64_t const& settingsHash, Files::MappedFile& file, Rendering::CompressedTextureData& texture)
+	{
+		return loadCookedFile(getCookedFilePath(resource), { resource->getSourceFilePath() }, settingsHash, file, texture) &&
+			texture.faceCount == 1;
+	}
+
+	bool TextureCooker::load(std::shared_ptr<CubemapResource> const& resource, std::vector<std::string> const& faceFilePaths, uint64_t const& settingsHash, Files::MappedFile& file, Rendering::CompressedTextureData& texture)
+	{
+		return loadCookedFile(getCookedFilePath(resource), faceFilePaths, settingsHash, file, texture) &&
+			texture.faceCount == Rendering::CubemapImage::FACE_COUNT;
+	}
+
+	void TextureCooker::cook(std::shared_ptr<TextureResource> const& resource, uint64_t const& settingsHash, Rendering::TextureImage const& image, std::vector<uint8_t>& contents, Rendering::CompressedTextureData& texture)
+	{
+		auto cookStartTime = std::chrono::high_resolution_clock::now();
+
+		// Mips are built from the source channels, so two channel normal maps can rebuild Z first
+		std::vector<Rendering::MipLevel> levels;
+		Rendering::MipGenerator::generate(image.getData(), image.getWidth(), image.getHeight(), image.getChannels(), resource->getMipSettings(), levels);
+		for (auto& level : levels)
+		{
+			std::vector<uint8_t> rgba;
+			Rendering::TextureCompression::expandToRgba(level.data.data(), level.width, level.height, image.getChannels(), rgba);
+			level.data.swap(rgba);
+		}
+
+		double psnr = compressAndWrite(resource->getSourceFilePath(), getCookedFilePath(resource), { resource->getSourceFilePath() }, settingsHash,
+			resource->getCompression(), resource->getCompressionQuality(), levels, 1, contents, texture);
+
+		// Compare against the uncompressed texture with its mip chain, as it would have been uploaded
+		std::chrono::duration<double, std::milli> cookTime = std::chrono::high_resolution_clock::now() - cookStartTime;
+		size_t uncompressedBytes = static_cast<size_t>(image.getWidth()) * image.getHeight() * image.getChannels() * 4 / 3;
+		recordCook(resource->getSourceFilePath(), texture, resource->getCompressionQuality(), cookTime.count(), uncompressedBytes, psnr);
+	}
+
+	void TextureCooker::cook(std::shared_ptr<CubemapResource> const& resource, std::vector<std::string> const& faceFilePaths, uint64_t const& settingsHash, Rendering::CubemapImage const& image, std::vector<uint8_t>& contents, Rendering::CompressedTextureData& texture)
+	{
+		auto cookStartTime = std::chrono::high_resolution_clock::now();
+
+		// The mip chains were already built when the faces were decoded. The levels of every face
+		// are compressed in one batch, so all cores stay busy until the last face is done.
+		std::vector<Rendering::MipLevel> levels;
+		size_t uncompressedBytes = 0;
+		for (int face = 0; face < Rendering::CubemapImage::FACE_COUNT; face++)
+		{
+			for (auto const& faceLevel : image.getFaceLevels(face))
+			{
+				Rendering::MipLevel level;
+				level.width = faceLevel.width;
+				level.height = faceLevel.height;
+				Rendering::TextureCompression::expandToRgba(faceLevel.data.data(), faceLevel.width, faceLevel.height, image.getChannels(), level.data);
+				levels.push_back(std::move(level));
+				uncompressedBytes += faceLevel.data.size();
+			}
+		}
+
+		std::string name = resource->getSourceFilePath() + " (cubemap slot " + std::to_string(resource->getSlot()) + ")";
+		double psnr = compressAndWrite(name, getCookedFilePath(resource), faceFilePaths, settingsHash,
+			resource->getCompression(), resource->getCompressionQuality(), levels, Rendering::CubemapImage::FACE_COUNT, contents, texture);
+
+		std::chrono::duration<double, std::milli> cookTime = std::chrono::high_resolution_clock::now() - cookStartTime;
+		recordCook(name, texture, resource->getCompressionQuality(), cookTime.count(), uncompressedBytes, psnr);
+	}
+
+	void TextureCooker::recordLoadTime(double const& milliseconds, bool const& fromCookedTexture)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (fromCookedTexture)
+		{
+			m_cookedLoadCount++;
+			m_cookedLoadTime += milliseconds;
+		}
+		else
+		{
+			m_decodedLoadCount++;
+			m_decodedLoadTime += milliseconds;
+		}
+	}
+
+	void TextureCooker::printStatistics() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		printf("Loaded %d textures in %.2fms (%d from cooked textures in %.2fms, %.2fms each; %d decoded from source in %.2fms, %.2fms each)\n",
+			m_cookedLoadCount + m_decodedLoadCount,
+			m_cookedLoadTime + m_decodedLoadTime,
+			m_cookedLoadCount,
+			m_cookedLoadTime,
+			m_cookedLoadCount > 0 ? m_cookedLoadTime / m_cookedLoadCount : 0.0,
+			m_decodedLoadCount,
+			m_decodedLoadTime,
+			m_decodedLoadCount > 0 ? m_decodedLoadTime / m_decodedLoadCount : 0.0);
+
+		if (m_cookCount > 0)
+		{
+			printf("Compressed %d textures in %.2fms, %.1f KB down to %.1f KB (%.1f:1), lowest PSNR %.2f dB\n",
+				m_cookCount,
+				m_cookTime,
+				m_uncompressedBytes / 1024.0f,
+				m_compressedBytes / 1024.0f,
+				m_compressedBytes > 0 ? static_cast<double>(m_uncompressedBytes) / m_compressedBytes : 0.0,
+				m_lowestPsnr);
+		}
+	}
+
+	uint64_t TextureCooker::hashSettings(Rendering::TextureCompressionFormat const& format, Rendering::TextureCompressionQuality const& quality, Rendering::MipSettings const& mipSettings, int const& faceCount) const
+	{
+		uint64_t hash = HASH_SEED;
+		hash = hashBytes(hash, &Rendering::CookedTexture::FORMAT_VERSION, sizeof(Rendering::CookedTexture::FORMAT_VERSION));
+
+		uint32_t compression = static_cast<uint32_t>(format);
+		uint32_t compressionQuality = static_cast<uint32_t>(quality);
+		hash = hashBytes(hash, &compression, sizeof(compression));
+		hash = hashBytes(hash, &compressionQuality, sizeof(compressionQuality));
+
+		uint32_t mipFilter = static_cast<uint32_t>(mipSettings.filter);
+		uint8_t mipFlags = (mipSettings.srgb ? 1 : 0) | (mipSettings.normalMap ? 2 : 0);
+		hash = hashBytes(hash, &mipFilter, sizeof(mipFilter));
+		hash = hashBytes(hash, &mipFlags, sizeof(mipFlags));
+		hash = hashBytes(hash, &mipSettings.alphaCutoff, sizeof(mipSettings.alphaCutoff));
+
+		// Textures hash the same as before cubemaps could be cooked, so their cooked copies stay valid
+		if (faceCount != 1)
+		{
+			hash = hashBytes(hash, &faceCount, sizeof(faceCount));
+		}
+
+		return hash;
+	}
+
+	bool TextureCooker::loadCookedFile(std::string const& cookedFilePath, std::vector<std::string> const& sourceFilePaths, uint64_t const& settingsHash, Files::MappedFile& file, Rendering::CompressedTextureData& texture)
+	{
+		if (m_cacheDirectory.empty())
+		{
+			return false;
+		}
+
+		if (!file.open(cookedFilePath))
+		{
+			return false;
+		}
+
+		Rendering::CookedTextureSource cookedSource;
+		if (!Rendering::CookedTexture::read(file.getData(), file.getSize(), cookedSource, texture) ||
+			cookedSource.settingsHash != settingsHash)
+		{
+			file.close();
+			return false;
+		}
+
+		Rendering::CookedTextureSource currentSource;
+		if (!getSourceStamp(sourceFilePaths, currentSource))
+		{
+			file.close();
+			return false;
+		}
+
+		if (currentSource.sourceSize == cookedSource.sourceSize && currentSource.sourceWriteTime == cookedSource.sourceWriteTime)
+		{
+			return true;
+		}
+
+		// A file was touched, only hash them when their size and time no longer match
+		if (!hashSourceFiles(sourceFilePaths, currentSource.sourceHash) ||
+			currentSource.sourceHash != cookedSource.sourceHash)
+		{
+			file.close();
+			return false;
+		}
+
+		// Same contents, so store the new stamp to skip hashing next time. The mapping has to be
+		// released before the file can be replaced.
+		currentSource.settingsHash = settingsHash;
+		std::vector<uint8_t> contents(file.getData(), file.getData() + file.getSize());
+		file.close();
+		Rendering::CookedTexture::updateSource(contents, currentSource);
+		writeFile(cookedFilePath, contents);
+
+		return file.open(cookedFilePath) &&
+			Rendering::CookedTexture::read(file.getData(), file.getSize(), cookedSource, texture);
+	}
+
+	double TextureCooker::compressAndWrite(
+		std::string const& name,
+		std::string const& cookedFilePath,
+		std::vector<std::string> const& sourceFilePaths,
+		uint64_t const& settingsHash,
+		Rendering::TextureCompressionFormat const& format,
+		Rendering::TextureCompressionQuality const& quality,
+		std::vector<Rendering::MipLevel> const& levels,
+		int const& faceCount,
+		std::vector<uint8_t>& contents,
+		Rendering::CompressedTextureData& texture)
+	{
+		std::vector<std::vector<uint8_t>> compressedLevels;
+		Rendering::TextureCompression::compressLevels(levels, format, quality, compressedLevels);
+
+		// Only the largest level of each face is checked, the others are mostly made of its averages
+		double psnr = std::numeric_limits<double>::infinity();
+		size_t levelsPerFace = levels.size() / faceCount;
+		for (size_t i = 0; i < levels.size(); i += levelsPerFace)
+		{
+			std::vector<uint8_t> decompressed;
+			Rendering::TextureCompression::decompress(compressedLevels[i].data(), levels[i].width, levels[i].height, format, decompressed);
+			psnr = std::min(psnr, Rendering::TextureCompression::calculatePsnr(levels[i].data.data(), decompressed.data(), levels[i].width, levels[i].height, format));
+		}
+
+		Rendering::CompressedTextureData compressed;
+		compressed.format = format;
+		compressed.faceCount = faceCount;
+		for (size_t i = 0; i < levels.size(); i++)
+		{
+			Rendering::CompressedTextureLevel compressedLevel;
+			compressedLevel.width = levels[i].width;
+			compressedLevel.height = levels[i].height;
+			compressedLevel.data = compressedLevels[i].data();
+			compressedLevel.size = compressedLevels[i].size();
+			compressed.levels.push_back(compressedLevel);
+		}
+
+		// The cooked copy keeps working without a stamp, it just can not be saved
+		Rendering::CookedTextureSource source;
+		bool hasSource = getSourceStamp(sourceFilePaths, source) &&
+			hashSourceFiles(sourceFilePaths, source.sourceHash);
+		source.settingsHash = settingsHash;
+
+		Rendering::CookedTexture::write(contents, source, compressed);
+		Rendering::CookedTexture::read(contents.data(), contents.size(), source, texture);
+
+		if (hasSource && !m_cacheDirectory.empty())
+		{
+			boost::system::error_code error;
+			boost::filesystem::create_directories(m_cacheDirectory, error);
+
+			if (!writeFile(cookedFilePath, contents))
+			{
+				std::cout << "Unable to write cooked texture for: " << name << "\n";
+			}
+		}
+
+		return levels.empty() ? 0.0 : psnr;
+	}
+
+	void TextureCooker::recordCook(std::string const& name, Rendering::CompressedTextureData const& texture, Rendering::TextureCompressionQuality const& quality, double const& cookTime, size_t const& uncompressedBytes, double const& psnr)
+	{
+		size_t compressedBytes = 0;
+		for (auto const& compressedLevel : texture.levels)
+		{
+			compressedBytes += compressedLevel.size;
+		}
+		if (Helpers::Statistics::isEnabled())
+		{
+			printf("Compressed %s to %s (%s) in %.2fms: %dx%d with %d levels%s, %.1f KB (%.1f:1), PSNR %.2f dB\n",
+				name.c_str(),
+				Rendering::TextureCompression::formatToString(texture.format).c_str(),
+				Rendering::TextureCompression::qualityToString(quality).c_str(),
+				cookTime,
+				texture.levels.empty() ? 0 : texture.levels[0].width,
+				texture.levels.empty() ? 0 : texture.levels[0].height,
+				static_cast<int>(texture.levels.size()) / std::max(texture.faceCount, 1),
+				texture.faceCount > 1 ? " on each face" : "",
+				compressedBytes / 1024.0f,
+				compressedBytes > 0 ? static_cast<double>(uncompressedBytes) / compressedBytes : 0.0,
+				psnr);
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_cookCount++;
+		m_cookTime += cookTime;
+		m_uncompressedBytes += uncompressedBytes;
+		m_compressedBytes += compressedBytes;
+		m_lowestPsnr = std::min(m_lowestPsnr, psnr);
+	}
+
+	std::string TextureCooker::getCookedFilePath(std::shared_ptr<Resource> const& resource) const
+	{
+		return (boost::filesystem::path(m_cacheDirectory) / (boost::uuids::to_string(resource->getId()) + ".dds")).string();
+	}
+
+	bool TextureCooker::getSourceStamp(std::vector<std::string> const& sourceFilePaths, Rendering::CookedTextureSource& source) const
+	{
+		// Cubemaps are built from several files, so any of them changing changes the stamp
+		source.sourceSize = 0;
+		source.sourceWriteTime = 0;
+		for (auto const& sourceFilePath : sourceFilePaths)
+		{
+			boost::system::error_code error;
+			uintmax_t size = boost::filesystem::file_size(sourceFilePath, error);
+			if (error)
+			{
+				return false;
+			}
+
+			std::time_t writeTime = boost::filesystem::last_write_time(sourceFilePath, error);
+			if (error)
+			{
+				return false;
+			}
+
+			source.sourceSize += static_cast<uint64_t>(size);
+			source.sourceWriteTime = std::max(source.sourceWriteTime, static_cast<int64_t>(writeTime));
+		}
+		return true;
+	}
+
+	bool TextureCooker::hashSourceFiles(std::vector<std::string> const& sourceFilePaths, uint64_t& hash) const
+	{
+		hash = HASH_SEED;
+		for (auto const& sourceFilePath : sourceFilePaths)
+		{
+			Files::MappedFile sourceFile;
+			if (!sourceFile.open(sourceFilePath))
+			{
+				return false;
+			}
+
+			hash = hashBytes(hash, sourceFile.getData(), sourceFile.getSize());
+		}
+		return true;
+	}
+
+	bool TextureCooker::writeFile(std::string const& filePath, std::vector<uint8_t> const& contents) const
+	{
+		// Write next to the destination and swap it in, so a cooked texture is never seen half written
+		std::string temporaryFilePath = filePath + ".tmp";
+		{
+			std::ofstream file(temporaryFilePath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+			{
+				return false;
+			}
+			file.write(reinterpret_cast<const char*>(contents.data()), contents.size());
+			if (!file.good())
+			{
+				return false;
+			}
+		}
+
+		boost::system::error_code error;
+		boost::filesystem::rename(temporaryFilePath, filePath, error);
+		return !error;
+	}
+
+}
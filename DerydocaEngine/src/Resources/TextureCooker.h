@@ -0,0 +1,163 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Files\MappedFile.h"
+#include "Rendering\CookedTexture.h"
+#include "Rendering\CubemapImage.h"
+#include "Rendering\TextureImage.h"
+#include "Resources\TextureResource.h"
+
+namespace DerydocaEngine::Resources
+{
+	struct CubemapResource;
+}
+
+namespace DerydocaEngine::Resources
+{
+
+	/*
+	Keeps block compressed copies of textures on disk as DDS files with their full mip chain, so
+	they can be memory mapped and uploaded as they are instead of being decoded every load. Only
+	textures whose meta file asks for a compression format are cooked. A cooked texture is rebuilt
+	whenever the contents of its source file or its compression settings change. Cubemaps are
+	cooked the same way, with all six faces in a single file.
+	*/
+	class TextureCooker
+	{
+	public:
+		static TextureCooker& getInstance()
+		{
+			static TextureCooker instance;
+			return instance;
+		}
+
+		/*
+		Sets the directory cooked textures are stored in. Textures are still compressed when the
+		directory is empty, but have to be compressed again every load.
+
+		@param directory Directory to store cooked textures in
+		*/
+		void setCacheDirectory(std::string const& directory) { m_cacheDirectory = directory; }
+		std::string getCacheDirectory() const { return m_cacheDirectory; }
+
+		/*
+		Calculates the hash of every setting that affects how a texture is compressed.
+
+		@param resource Resource describing the texture
+		@return Hash of the compression settings
+		*/
+		uint64_t calculateSettingsHash(std::shared_ptr<TextureResource> const& resource) const;
+		uint64_t calculateSettingsHash(std::shared_ptr<CubemapResource> const& resource) const;
+
+		/*
+		Maps the cooked copy of a texture if it is still up to date.
+
+		@param resource Resource describing the texture
+		@param settingsHash Hash of the current compression settings
+		@param file Receives the mapping, which must outlive any use of the texture data
+		@param texture Receives the compressed levels, pointing into the mapping
+
+		@return True if an up to date cooked texture was found
+		*/
+		bool load(std::shared_ptr<TextureResource> const& resource, uint64_t const& settingsHash, Files::MappedFile& file, Rendering::CompressedTextureData& texture);
+
+		/*
+		Maps the cooked copy of a cubemap if it is still up to date.
+
+		@param resource Resource describing the cubemap
+		@param faceFilePaths Source files of the faces, any of which changing makes the copy out of date
+		@param settingsHash Hash of the current compression settings
+		@param file Receives the mapping, which must outlive any use of the texture data
+		@param texture Receives the compressed levels of every face, pointing into the mapping
+
+		@return True if an up to date cooked cubemap was found
+		*/
+		bool load(std::shared_ptr<CubemapResource> const& resource, std::vector<std::string> const& faceFilePaths, uint64_t const& settingsHash, Files::MappedFile& file, Rendering::CompressedTextureData& texture);
+
+		/*
+		Builds the mip chain of a decoded image, compresses every level and writes the cooked copy.
+		Prints the time it took, the compression ratio and the PSNR of the largest level.
+
+		@param resource Resource describing the texture
+		@param settingsHash Hash of the compression settings
+		@param image Decoded source image
+		@param contents Receives the cooked texture
+		@param texture Receives the compressed levels, pointing into contents
+		*/
+		void cook(std::shared_ptr<TextureResource> const& resource, uint64_t const& settingsHash, Rendering::TextureImage const& image, std::vector<uint8_t>& contents, Rendering::CompressedTextureData& texture);
+
+		/*
+		Compresses every level of the faces of a cubemap and writes them to a single cooked copy.
+
+		@param resource Resource describing the cubemap
+		@param faceFilePaths Source files of the faces
+		@param settingsHash Hash of the compression settings
+		@param image Decoded faces with their mip chains
+		@param contents Receives the cooked cubemap
+		@param texture Receives the compressed levels of every face, pointing into contents
+		*/
+		void cook(std::shared_ptr<CubemapResource> const& resource, std::vector<std::string> const& faceFilePaths, uint64_t const& settingsHash, Rendering::CubemapImage const& image, std::vector<uint8_t>& contents, Rendering::CompressedTextureData& texture);
+
+		/*
+		Records how long it took to load a texture.
+
+		@param milliseconds Time spent loading the texture
+		@param fromCookedTexture Whether the texture was loaded from its cooked copy
+		*/
+		void recordLoadTime(double const& milliseconds, bool const& fromCookedTexture);
+
+		/*
+		Prints how many textures were loaded from cooked copies, how long each kind of load took and
+		how well the textures cooked this run were compressed.
+		*/
+		void printStatistics() const;
+
+		void operator=(TextureCooker const&) = delete;
+	private:
+		TextureCooker();
+		TextureCooker(TextureCooker const&);
+		~TextureCooker();
+
+		uint64_t hashSettings(Rendering::TextureCompressionFormat const& format, Rendering::TextureCompressionQuality const& quality, Rendering::MipSettings const& mipSettings, int const& faceCount) const;
+		bool loadCookedFile(std::string const& cookedFilePath, std::vector<std::string> const& sourceFilePaths, uint64_t const& settingsHash, Files::MappedFile& file, Rendering::CompressedTextureData& texture);
+
+		/*
+		Compresses RGBA levels, writes them to the cooked copy and reads them back into texture.
+
+		@return Lowest PSNR of the largest level of each face
+		*/
+		double compressAndWrite(
+			std::string const& name,
+			std::string const& cookedFilePath,
+			std::vector<std::string> const& sourceFilePaths,
+			uint64_t const& settingsHash,
+			Rendering::TextureCompressionFormat const& format,
+			Rendering::TextureCompressionQuality const& quality,
+			std::vector<Rendering::MipLevel> const& levels,
+			int const& faceCount,
+			std::vector<uint8_t>& contents,
+			Rendering::CompressedTextureData& texture);
+		void recordCook(std::string const& name, Rendering::CompressedTextureData const& texture, Rendering::TextureCompressionQuality const& quality, double const& cookTime, size_t const& uncompressedBytes, double const& psnr);
+		std::string getCookedFilePath(std::shared_ptr<Resource> const& resource) const;
+		bool getSourceStamp(std::vector<std::string> const& sourceFilePaths, Rendering::CookedTextureSource& source) const;
+		bool hashSourceFiles(std::vector<std::string> const& sourceFilePaths, uint64_t& hash) const;
+		bool writeFile(std::string const& filePath, std::vector<uint8_t> const& contents) const;
+
+		std::string m_cacheDirectory;
+		mutable std::mutex m_mutex;
+		int m_cookedLoadCount;
+		int m_decodedLoadCount;
+		double m_cookedLoadTime;
+		double m_decodedLoadTime;
+		int m_cookCount;
+		double m_cookTime;
+		size_t m_uncompressedBytes;
+		size_t m_compressedBytes;
+		double m_lowestPsnr;
+	};
+
+}
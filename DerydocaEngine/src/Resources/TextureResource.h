@@ -1,5 +1,7 @@
 #pragma once
 #include "Resources\Resource.h"
+#include "Rendering\MipGenerator.h"
+#include "Rendering\TextureCompression.h"
 
 namespace DerydocaEngine::Resources
 {
@@ -9,11 +11,27 @@ namespace DerydocaEngine::Resources
 	public:
 		REGISTER_TYPE_ID(TextureResource);
 
-		TextureResource()
+		TextureResource() :
+			m_compression(Rendering::TextureCompressionFormat::None),
+			m_compressionQuality(Rendering::TextureCompressionQuality::Normal),
+			m_mipSettings()
 		{
 			setType(DerydocaEngine::Resources::TextureResourceType);
 		}
 
+		/* Gets the block compressed format the texture is cooked to, or None to decode the source image every load */
+		Rendering::TextureCompressionFormat getCompression() const { return m_compression; }
+		void setCompression(Rendering::TextureCompressionFormat const& compression) { m_compression = compression; }
+		Rendering::TextureCompressionQuality getCompressionQuality() const { return m_compressionQuality; }
+		void setCompressionQuality(Rendering::TextureCompressionQuality const& quality) { m_compressionQuality = quality; }
+		/* Gets how the mip chain of the texture is filtered */
+		Rendering::MipSettings getMipSettings() const { return m_mipSettings; }
+		void setMipSettings(Rendering::MipSettings const& settings) { m_mipSettings = settings; }
+
+	private:
+		Rendering::TextureCompressionFormat m_compression;
+		Rendering::TextureCompressionQuality m_compressionQuality;
+		Rendering::MipSettings m_mipSettings;
 	};
 
 }
@@ -0,0 +1,248 @@
+#include "EnginePch.h"
+#include "Resources\TextureStreamer.h"
+
+#include <algorithm>
+#include "Rendering\Texture.h"
+
+namespace DerydocaEngine::Resources
+{
+
+	static const int DEFAULT_RESIDENT_SIZE = 64;
+
+	TextureStreamer::TextureStreamer() :
+		m_mutex(),
+		m_jobAvailable(),
+		m_thread(),
+		m_jobs(),
+		m_readLevels(),
+		m_stopping(false),
+		m_planner(),
+		m_textures(),
+		m_frame(1),
+		m_enabled(true),
+		m_residentSize(DEFAULT_RESIDENT_SIZE),
+		m_uploadedBytes(0),
+		m_readTime(0.0),
+		m_uploadTime(0.0),
+		m_longestUploadFrame(0.0)
+	{
+	}
+
+	TextureStreamer::~TextureStreamer()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stopping = true;
+		}
+		m_jobAvailable.notify_all();
+
+		if (m_thread.joinable())
+		{
+			m_thread.join();
+		}
+	}
+
+	void TextureStreamer::registerTexture(std::shared_ptr<Rendering::Texture> const& texture, Rendering::CompressedTextureData const& data, std::shared_ptr<void> const& dataOwner)
+	{
+		if (!texture || data.levels.empty())
+		{
+			return;
+		}
+
+		std::vector<size_t> levelSizes;
+		for (auto const& level : data.levels)
+		{
+			levelSizes.push_back(level.size);
+		}
+
+		int streamingId = m_planner.add(levelSizes, texture->getResidentLevel());
+		texture->setStreamingId(streamingId);
+
+		StreamedTexture streamedTexture;
+		streamedTexture.texture = texture;
+		streamedTexture.data = data;
+		streamedTexture.dataOwner = dataOwner;
+		m_textures[streamingId] = streamedTexture;
+	}
+
+	void TextureStreamer::retarget(int const& streamingId, std::weak_ptr<Rendering::Texture> const& texture)
+	{
+		auto it = m_textures.find(streamingId);
+		if (it != m_textures.end())
+		{
+			it->second.texture = texture;
+		}
+	}
+
+	void TextureStreamer::request(Rendering::Texture const& texture, int const& level)
+	{
+		if (texture.isStreamed())
+		{
+			m_planner.request(texture.getStreamingId(), level, m_frame);
+		}
+	}
+
+	void TextureStreamer::update()
+	{
+		// Textures that were unloaded release their cooked files and stop taking up the budget
+		for (auto it = m_textures.begin(); it != m_textures.end();)
+		{
+			if (it->second.texture.expired())
+			{
+				m_planner.remove(it->first);
+				it = m_textures.erase(it);
+			}
+			else
+			{
+				it++;
+			}
+		}
+
+		uploadReadLevels();
+
+		std::vector<MipResidencyPlanner::LevelChange> loads;
+		std::vector<MipResidencyPlanner::LevelChange> evictions;
+		m_planner.plan(m_frame, loads, evictions);
+		m_frame++;
+
+		for (auto const& eviction : evictions)
+		{
+			auto texture = m_textures[eviction.textureId].texture.lock();
+			if (texture)
+			{
+				texture->dropLevels(eviction.level);
+			}
+		}
+
+		if (loads.empty())
+		{
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			for (auto const& load : loads)
+			{
+				StreamedTexture const& streamedTexture = m_textures[load.textureId];
+				Rendering::CompressedTextureLevel const& level = streamedTexture.data.levels[load.level];
+				m_jobs.push_back({ load.textureId, load.level, level.data, level.size, streamedTexture.dataOwner });
+			}
+
+			if (!m_thread.joinable())
+			{
+				m_thread = std::thread(&TextureStreamer::runStreamingThread, this);
+			}
+		}
+		m_jobAvailable.notify_one();
+	}
+
+	int TextureStreamer::getInitialLevel(Rendering::CompressedTextureData const& data) const
+	{
+		for (size_t i = 0; i < data.levels.size(); i++)
+		{
+			if (std::max(data.levels[i].width, data.levels[i].height) <= m_residentSize)
+			{
+				return static_cast<int>(i);
+			}
+		}
+		return std::max(static_cast<int>(data.levels.size()) - 1, 0);
+	}
+
+	void TextureStreamer::printStatistics() const
+	{
+		MipResidencyPlanner::Statistics statistics = m_planner.getStatistics();
+		printf("Streamed %zu textures, %.1f KB resident of %.1f KB with every level (peak %.1f KB), %zu levels streamed in and %zu dropped, %zu loads put off by the memory budget\n",
+			statistics.textureCount,
+			statistics.residentBytes / 1024.0f,
+			statistics.fullBytes / 1024.0f,
+			statistics.peakResidentBytes / 1024.0f,
+			statistics.loadCount,
+			statistics.evictionCount,
+			statistics.deferredCount);
+		printf("Streamed in %.1f KB of levels, %.2fms reading on the streaming thread and %.2fms uploading on the render thread, at most %.2fms in a single frame\n",
+			m_uploadedBytes / 1024.0f,
+			m_readTime,
+			m_uploadTime,
+			m_longestUploadFrame);
+	}
+
+	void TextureStreamer::runStreamingThread()
+	{
+		while (true)
+		{
+			ReadJob job;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_jobAvailable.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+				if (m_stopping)
+				{
+					return;
+				}
+
+				job = std::move(m_jobs.front());
+				m_jobs.pop_front();
+			}
+
+			// Copying the level out of the mapping is what pages it in from disk, so the render
+			// thread never waits on the file
+			auto startTime = std::chrono::high_resolution_clock::now();
+			ReadLevel readLevel;
+			readLevel.streamingId = job.streamingId;
+			readLevel.level = job.level;
+			readLevel.data.assign(job.data, job.data + job.size);
+			std::chrono::duration<double, std::milli> readTime = std::chrono::high_resolution_clock::now() - startTime;
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_readTime += readTime.count();
+			m_readLevels.push_back(std::move(readLevel));
+		}
+	}
+
+	void TextureStreamer::uploadReadLevels()
+	{
+		// Reads of several frames can finish together, so the budget is also kept here. At least
+		// one level is uploaded so that levels larger than the budget still make progress.
+		std::vector<ReadLevel> readLevels;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			size_t bytes = 0;
+			while (!m_readLevels.empty() && (readLevels.empty() || bytes + m_readLevels.front().data.size() <= m_planner.getUploadBudget()))
+			{
+				bytes += m_readLevels.front().data.size();
+				readLevels.push_back(std::move(m_readLevels.front()));
+				m_readLevels.pop_front();
+			}
+		}
+
+		if (readLevels.empty())
+		{
+			return;
+		}
+
+		auto startTime = std::chrono::high_resolution_clock::now();
+		for (auto const& readLevel : readLevels)
+		{
+			auto it = m_textures.find(readLevel.streamingId);
+			if (it == m_textures.end())
+			{
+				continue;
+			}
+
+			auto texture = it->second.texture.lock();
+			if (!texture || texture->getResidentLevel() != readLevel.level + 1)
+			{
+				m_planner.cancelLoad(readLevel.streamingId);
+				continue;
+			}
+
+			texture->uploadCompressedLevel(readLevel.level, readLevel.data.data(), readLevel.data.size());
+			m_planner.completeLoad(readLevel.streamingId);
+			m_uploadedBytes += readLevel.data.size();
+		}
+
+		std::chrono::duration<double, std::milli> uploadTime = std::chrono::high_resolution_clock::now() - startTime;
+		m_uploadTime += uploadTime.count();
+		m_longestUploadFrame = std::max(m_longestUploadFrame, uploadTime.count());
+	}
+
+}
@@ -0,0 +1,164 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Rendering\TextureCompression.h"
+#include "Resources\MipResidencyPlanner.h"
+
+namespace DerydocaEngine::Rendering
+{
+	class Texture;
+}
+
+namespace DerydocaEngine::Resources
+{
+
+	/*
+	Streams the larger mip levels of cooked textures in and out as the renderer needs them.
+	Textures are uploaded with only their smallest levels, then the renderer asks for the levels
+	its visible surfaces need each frame. Levels are read from the cooked file on a streaming
+	thread and uploaded on the render thread within a budget of bytes per frame, while levels
+	that are no longer needed are dropped once the memory budget runs out.
+	*/
+	class TextureStreamer
+	{
+	public:
+		static TextureStreamer& getInstance()
+		{
+			static TextureStreamer instance;
+			return instance;
+		}
+
+		/*
+		Starts streaming a texture that was uploaded from its initial level. Must be called on the
+		render thread.
+
+		@param texture Texture to stream levels into
+		@param data Compressed levels of the texture
+		@param dataOwner Keeps the memory the levels point at alive, such as a mapped cooked file
+		*/
+		void registerTexture(std::shared_ptr<Rendering::Texture> const& texture, Rendering::CompressedTextureData const& data, std::shared_ptr<void> const& dataOwner);
+
+		/*
+		Points a streamed texture at another texture object, used when textures exchange their
+		GL textures on reload.
+
+		@param streamingId ID the streamer knows the texture by
+		@param texture Texture that now holds the streamed GL texture
+		*/
+		void retarget(int const& streamingId, std::weak_ptr<Rendering::Texture> const& texture);
+
+		/*
+		Asks for a level of a streamed texture to be resident. Must be called on the render thread.
+
+		@param texture Texture that is about to be drawn
+		@param level Largest level that is needed to draw it
+		*/
+		void request(Rendering::Texture const& texture, int const& level);
+
+		/*
+		Uploads levels that finished reading, drops levels to make room under the memory budget
+		and starts reading the next levels. Must be called on the render thread, once per frame,
+		after the frame's requests were made.
+		*/
+		void update();
+
+		/*
+		Gets the largest level a texture is uploaded with before it is streamed.
+
+		@param data Compressed levels of the texture
+		@return Largest level that is no larger than the resident size
+		*/
+		int getInitialLevel(Rendering::CompressedTextureData const& data) const;
+
+		/*
+		Sets whether textures loaded from now on are streamed, rather than uploaded with every level.
+
+		@param enabled Whether to stream textures
+		*/
+		void setEnabled(bool const& enabled) { m_enabled = enabled; }
+		bool isEnabled() const { return m_enabled; }
+
+		/*
+		Sets how many bytes the levels of every streamed texture may take.
+
+		@param bytes Memory budget in bytes, or 0 for no budget
+		*/
+		void setMemoryBudget(size_t const& bytes) { m_planner.setMemoryBudget(bytes); }
+
+		/*
+		Sets how many bytes of levels may be uploaded each frame.
+
+		@param bytes Upload budget of a frame in bytes
+		*/
+		void setUploadBudget(size_t const& bytes) { m_planner.setUploadBudget(bytes); }
+
+		/*
+		Sets the largest width or height of the levels that are always resident.
+
+		@param size Size of the initial level in pixels
+		*/
+		void setResidentSize(int const& size) { m_residentSize = size; }
+
+		MipResidencyPlanner::Statistics getStatistics() const { return m_planner.getStatistics(); }
+
+		/*
+		Prints how much memory the streamed textures use against what their full mip chains would
+		take, and how many levels were streamed in and out.
+		*/
+		void printStatistics() const;
+
+		void operator=(TextureStreamer const&) = delete;
+	private:
+		struct StreamedTexture
+		{
+			std::weak_ptr<Rendering::Texture> texture;
+			Rendering::CompressedTextureData data;
+			std::shared_ptr<void> dataOwner;
+		};
+
+		struct ReadJob
+		{
+			int streamingId;
+			int level;
+			const uint8_t* data;
+			size_t size;
+			std::shared_ptr<void> dataOwner;
+		};
+
+		struct ReadLevel
+		{
+			int streamingId;
+			int level;
+			std::vector<uint8_t> data;
+		};
+
+		TextureStreamer();
+		TextureStreamer(TextureStreamer const&);
+		~TextureStreamer();
+
+		void runStreamingThread();
+		void uploadReadLevels();
+
+		std::mutex m_mutex;
+		std::condition_variable m_jobAvailable;
+		std::thread m_thread;
+		std::deque<ReadJob> m_jobs;
+		std::deque<ReadLevel> m_readLevels;
+		bool m_stopping;
+		MipResidencyPlanner m_planner;
+		std::map<int, StreamedTexture> m_textures;
+		uint64_t m_frame;
+		bool m_enabled;
+		int m_residentSize;
+		size_t m_uploadedBytes;
+		double m_readTime;
+		double m_uploadTime;
+		double m_longestUploadFrame;
+	};
+
+}
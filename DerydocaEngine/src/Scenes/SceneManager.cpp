@@ -2,12 +2,15 @@
 #include "SceneManager.h"
 #include "SerializedScene.h"
 #include "ObjectLibrary.h"
+#include "Helpers\AssimpImportCache.h"
+#include "Resources\ResourceLoader.h"
 
 namespace DerydocaEngine::Scenes
 {
 
 	SceneManager::SceneManager() :
-		m_activeScene()
+		m_activeScene(),
+		m_activeLevel()
 	{
 	}
 
@@ -15,7 +18,7 @@ namespace DerydocaEngine::Scenes
 	{
 	}
 	
-	void SceneManager::loadScene(const boost::uuids::uuid& levelId)
+	void SceneManager::loadScene(const boost::uuids::uuid& levelId, bool const& waitForResources)
 	{
 		auto resource = ObjectLibrary::getInstance().getResource<Resources::LevelResource>(levelId);
 		
@@ -25,19 +28,40 @@ namespace DerydocaEngine::Scenes
 			return;
 		}
 
-		loadScene(resource);
+		loadScene(resource, waitForResources);
 	}
 
-	void SceneManager::loadScene(const std::shared_ptr<Resources::LevelResource> levelResource)
+	void SceneManager::loadScene(const std::shared_ptr<Resources::LevelResource> levelResource, bool const& waitForResources)
 	{
-		unloadScene();
-
 		auto scene = std::make_shared<Scenes::SerializedScene>();
 		scene->LoadFromFile(levelResource->getSourceFilePath());
-		scene->setUp();
+
+		loadScene(levelResource, scene, waitForResources);
+	}
+
+	void SceneManager::loadScene(const std::shared_ptr<Resources::LevelResource> levelResource, std::shared_ptr<SerializedScene> const& scene, bool const& waitForResources)
+	{
+		unloadScene();
+
+		// Resources loaded by the scene's components share imported files until the scene is loaded
+		Helpers::AssimpImportCache::Batch importBatch;
+
+		// Collect the resources the components start loading while they are deserialized
+		Resources::ResourceDependencySet dependencies;
+		{
+			Resources::ResourceLoader::Recording recording(dependencies);
+			scene->setUp();
+		}
+
+		if (waitForResources)
+		{
+			Resources::ResourceLoader::getInstance().waitFor(dependencies);
+		}
+
 		scene->getRoot()->init();
 		scene->getRoot()->postInit();
 		m_activeScene = scene;
+		m_activeLevel = levelResource;
 	}
 
 	void SceneManager::unloadScene()
@@ -49,6 +73,7 @@ namespace DerydocaEngine::Scenes
 
 		m_activeScene->tearDown();
 		m_activeScene = nullptr;
+		m_activeLevel = nullptr;
 	}
 
 }
\ No newline at end of file
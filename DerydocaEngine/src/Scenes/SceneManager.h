@@ -4,6 +4,7 @@
 
 namespace DerydocaEngine::Scenes
 {
+	class SerializedScene;
 
 	class SceneManager
 	{
@@ -16,8 +17,28 @@ namespace DerydocaEngine::Scenes
 
 		std::shared_ptr<Scene> getActiveScene() { return m_activeScene; }
 
-		void loadScene(const boost::uuids::uuid & levelId);
-		void loadScene(const std::shared_ptr<Resources::LevelResource> levelResource);
+		/* Gets the level the active scene was loaded from, or null if it was not loaded from a level */
+		std::shared_ptr<Resources::LevelResource> getActiveLevel() { return m_activeLevel; }
+
+		/*
+		Loads a scene, replacing the active scene.
+
+		@param levelId ID of the level to load
+		@param waitForResources Whether to wait until every resource the scene's components load
+		asynchronously is resident before initializing them. Components that do not render a
+		fallback while their resources load need this.
+		*/
+		void loadScene(const boost::uuids::uuid & levelId, bool const& waitForResources = true);
+		void loadScene(const std::shared_ptr<Resources::LevelResource> levelResource, bool const& waitForResources = true);
+
+		/*
+		Loads a scene whose level file was already parsed, such as on another thread.
+
+		@param levelResource Level the scene was parsed from
+		@param scene Parsed scene
+		@param waitForResources Whether to wait until the scene's resources are resident
+		*/
+		void loadScene(const std::shared_ptr<Resources::LevelResource> levelResource, std::shared_ptr<SerializedScene> const& scene, bool const& waitForResources = true);
 		void unloadScene();
 
 	private:
@@ -26,6 +47,7 @@ namespace DerydocaEngine::Scenes
 		SceneManager(const SceneManager&);
 
 		std::shared_ptr<Scene> m_activeScene;
+		std::shared_ptr<Resources::LevelResource> m_activeLevel;
 	};
 
 }
\ No newline at end of file
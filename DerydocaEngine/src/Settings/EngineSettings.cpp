@@ -9,6 +9,15 @@ namespace DerydocaEngine::Settings
 		m_width(800),
 		m_height(600),
 		m_engineResourceDirectory(),
+		m_shaderCacheDirectory(),
+		m_meshCacheDirectory(),
+		m_textureCacheDirectory(),
+		m_resourceIndexDirectory(),
+		m_resourceBudgets(),
+		m_textureStreaming(),
+		m_textureUploads(),
+		m_animation(),
+		m_statistics(false),
 		m_editorComponentsSceneIdentifier()
 	{
 		m_settingsFilePath = boost::filesystem::absolute(configFilePath);
@@ -20,6 +29,66 @@ namespace DerydocaEngine::Settings
 		if (engineNode)
 		{
 			m_engineResourceDirectory = engineNode["Resources"].as<std::string>();
+
+			YAML::Node shaderCacheNode = engineNode["ShaderCache"];
+			if (shaderCacheNode)
+			{
+				m_shaderCacheDirectory = shaderCacheNode.as<std::string>();
+			}
+
+			YAML::Node meshCacheNode = engineNode["MeshCache"];
+			if (meshCacheNode)
+			{
+				m_meshCacheDirectory = meshCacheNode.as<std::string>();
+			}
+
+			YAML::Node textureCacheNode = engineNode["TextureCache"];
+			if (textureCacheNode)
+			{
+				m_textureCacheDirectory = textureCacheNode.as<std::string>();
+			}
+
+			YAML::Node resourceIndexNode = engineNode["ResourceIndex"];
+			if (resourceIndexNode)
+			{
+				m_resourceIndexDirectory = resourceIndexNode.as<std::string>();
+			}
+
+			// Budgets are keyed by resource type name, such as Mesh or Texture
+			YAML::Node resourceBudgetsNode = engineNode["ResourceBudgets"];
+			if (resourceBudgetsNode && resourceBudgetsNode.IsMap())
+			{
+				for (auto const& budgetNode : resourceBudgetsNode)
+				{
+					ResourceBudgetSettings budget;
+					budget.cpuMegabytes = static_cast<size_t>(std::max(0, YamlTools::getIntSafe(budgetNode.second, "CPU", 0)));
+					budget.gpuMegabytes = static_cast<size_t>(std::max(0, YamlTools::getIntSafe(budgetNode.second, "GPU", 0)));
+					m_resourceBudgets[budgetNode.first.as<std::string>()] = budget;
+				}
+			}
+
+			YAML::Node textureStreamingNode = engineNode["TextureStreaming"];
+			if (textureStreamingNode)
+			{
+				m_textureStreaming.enabled = YamlTools::getIntSafe(textureStreamingNode, "Enabled", 1) != 0;
+				m_textureStreaming.gpuMegabytes = static_cast<size_t>(std::max(0, YamlTools::getIntSafe(textureStreamingNode, "GPU", 0)));
+				m_textureStreaming.uploadKilobytes = static_cast<size_t>(std::max(1, YamlTools::getIntSafe(textureStreamingNode, "UploadKB", 4096)));
+				m_textureStreaming.residentSize = std::max(1, YamlTools::getIntSafe(textureStreamingNode, "ResidentSize", 64));
+			}
+
+			YAML::Node textureUploadsNode = engineNode["TextureUploads"];
+			if (textureUploadsNode)
+			{
+				m_textureUploads.budgetKilobytes = static_cast<size_t>(std::max(1, YamlTools::getIntSafe(textureUploadsNode, "BudgetKB", 2048)));
+			}
+
+			YAML::Node animationNode = engineNode["Animation"];
+			if (animationNode)
+			{
+				m_animation.threadCount = static_cast<unsigned int>(std::max(0, YamlTools::getIntSafe(animationNode, "Threads", 0)));
+			}
+
+			m_statistics = YamlTools::getIntSafe(engineNode, "Statistics", 0) != 0;
 		}
 
 
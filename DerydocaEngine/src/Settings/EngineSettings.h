@@ -3,6 +3,7 @@
 #include <assert.h>
 #include <boost\filesystem.hpp>
 #include <boost\uuid\uuid.hpp>
+#include <map>
 #include <string>
 #include "glm/glm.hpp"
 #include "Helpers\YamlTools.h"
@@ -11,6 +12,34 @@
 namespace DerydocaEngine::Settings
 {
 
+	/* Memory the loaded resources of a type may use, in megabytes, where 0 means no budget */
+	struct ResourceBudgetSettings
+	{
+		size_t cpuMegabytes = 0;
+		size_t gpuMegabytes = 0;
+	};
+
+	/* How cooked textures stream their mip levels, where a GPU budget of 0 means no budget */
+	struct TextureStreamingSettings
+	{
+		bool enabled = true;
+		size_t gpuMegabytes = 0;
+		size_t uploadKilobytes = 4096;
+		int residentSize = 64;
+	};
+
+	/* How many kilobytes of texture pixels may be copied through the staging ring each frame */
+	struct TextureUploadSettings
+	{
+		size_t budgetKilobytes = 2048;
+	};
+
+	/* How many threads evaluate animation poses, where 0 means one per core */
+	struct AnimationSettings
+	{
+		unsigned int threadCount = 0;
+	};
+
 	class EngineSettings
 	{
 	public:
@@ -20,6 +49,15 @@ namespace DerydocaEngine::Settings
 		int getWidth() const { return m_width; }
 		int getHeight() const { return m_height; }
 		std::string getEngineResourceDirectory() const { return m_engineResourceDirectory; }
+		std::string getShaderCacheDirectory() const { return m_shaderCacheDirectory; }
+		std::string getMeshCacheDirectory() const { return m_meshCacheDirectory; }
+		std::string getTextureCacheDirectory() const { return m_textureCacheDirectory; }
+		std::string getResourceIndexDirectory() const { return m_resourceIndexDirectory; }
+		std::map<std::string, ResourceBudgetSettings> getResourceBudgets() const { return m_resourceBudgets; }
+		TextureStreamingSettings getTextureStreaming() const { return m_textureStreaming; }
+		TextureUploadSettings getTextureUploads() const { return m_textureUploads; }
+		AnimationSettings getAnimation() const { return m_animation; }
+		bool getStatistics() const { return m_statistics; }
 		std::string getEditorComponentsSceneIdentifier() const { return m_editorComponentsSceneIdentifier; }
 		std::string getEditorGuiSceneIdentifier() const { return m_editorGuiSceneIdentifier; }
 		std::string getEditorSkyboxMaterialIdentifier() const { return m_editorSkyboxMaterialIdentifier; }
@@ -28,6 +66,16 @@ namespace DerydocaEngine::Settings
 		int m_width;
 		int m_height;
 		std::string m_engineResourceDirectory;
+		std::string m_shaderCacheDirectory;
+		std::string m_meshCacheDirectory;
+		std::string m_textureCacheDirectory;
+		std::string m_resourceIndexDirectory;
+		std::map<std::string, ResourceBudgetSettings> m_resourceBudgets;
+		TextureStreamingSettings m_textureStreaming;
+		TextureUploadSettings m_textureUploads;
+		AnimationSettings m_animation;
+		// Print the timing and memory reports of the engine's systems
+		bool m_statistics;
 		std::string m_editorComponentsSceneIdentifier;
 		std::string m_editorGuiSceneIdentifier;
 		std::string m_editorSkyboxMaterialIdentifier;
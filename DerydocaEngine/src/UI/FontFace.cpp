@@ -18,6 +18,7 @@ namespace DerydocaEngine::UI
 		m_texture(std::make_shared<Rendering::Texture>()),
 		m_charImages(),
 		m_imageBuffer(nullptr),
+		m_previousImageBuffer(nullptr),
 		m_imageBufferSize(0, 0),
 		m_textureDirty(false),
 		m_lineHeight(50.0f),
@@ -35,8 +36,11 @@ namespace DerydocaEngine::UI
 		// Upload the texture to the GPU if the image buffer has changed and has not been submitted
 		if (m_textureDirty)
 		{
-			m_texture->updateBuffer(m_imageBuffer, m_imageBufferSize.x, m_imageBufferSize.y, 1, nullptr);
+			m_texture->updateChangedRegions(m_previousImageBuffer, m_imageBuffer, m_imageBufferSize.x, m_imageBufferSize.y, 1, nullptr);
 			m_textureDirty = false;
+
+			delete[] m_previousImageBuffer;
+			m_previousImageBuffer = nullptr;
 		}
 
 		return m_texture;
@@ -128,7 +132,7 @@ namespace DerydocaEngine::UI
 		packer.packImages();
 
 		// Store the image buffer
-		m_imageBuffer = packer.allocImageBuffer();
+		replaceImageBuffer(packer.allocImageBuffer());
 		m_imageBufferSize.x = packer.getWidth();
 		m_imageBufferSize.y = packer.getHeight();
 		m_textureDirty = true;
@@ -161,8 +165,7 @@ namespace DerydocaEngine::UI
 		auto r = ObjectLibrary::getInstance().getResource(imageUuid);
 		int imgw, imgh, imgch;
 		unsigned char* imageData = stbi_load(r->getSourceFilePath().c_str(), &imgw, &imgh, &imgch, 0);
-		delete[] m_imageBuffer;
-		m_imageBuffer = new unsigned char[m_imageBufferSize.x * m_imageBufferSize.y];
+		replaceImageBuffer(new unsigned char[m_imageBufferSize.x * m_imageBufferSize.y]);
 		for (int i = 0; i < m_imageBufferSize.x * m_imageBufferSize.y; i++)
 		{
 			m_imageBuffer[i] = imageData[i * imgch];
@@ -195,6 +198,22 @@ namespace DerydocaEngine::UI
 		m_textureDirty = true;
 	}
 
+	void FontFace::replaceImageBuffer(unsigned char* imageBuffer)
+	{
+		// The buffer the texture was last given is kept until the texture is updated, any buffer
+		// in between was never uploaded
+		if (m_previousImageBuffer == nullptr && !m_textureDirty)
+		{
+			m_previousImageBuffer = m_imageBuffer;
+		}
+		else
+		{
+			delete[] m_imageBuffer;
+		}
+
+		m_imageBuffer = imageBuffer;
+	}
+
 	void FontFace::saveToSerializedFile(std::string const& filePath)
 	{
 		YAML::Node root = YAML::Node();
@@ -39,11 +39,15 @@ namespace DerydocaEngine::UI
 		void loadFromSerializedFile(std::string const& filePath);
 		void saveToSerializedFile(std::string const& filePath);
 	private:
+		void replaceImageBuffer(unsigned char* imageBuffer);
+
 		glm::ivec2 m_dotsPerInch;
 		float m_fontSize;
 		std::shared_ptr<Rendering::Texture> m_texture;
 		std::map<int, Utilities::TexturePackerImage> m_charImages;
 		unsigned char* m_imageBuffer;
+		// Image buffer the texture was last given, so only the glyphs that changed are uploaded again
+		unsigned char* m_previousImageBuffer;
 		glm::ivec2 m_imageBufferSize;
 		bool m_textureDirty;
 		float m_lineHeight;
@@ -12,6 +12,7 @@ namespace DerydocaEngine::UI
 	SpriteSheet::SpriteSheet() :
 		m_sprites(),
 		m_imageBuffer(),
+		m_imageChannels(0),
 		m_largestId(0),
 		m_texture(std::make_shared<Rendering::Texture>())
 	{
@@ -60,9 +61,18 @@ namespace DerydocaEngine::UI
 			(*spriteMapRecord).second.setTexPosition(tex.getX(), tex.getY(), tex.getDX(), tex.getDY());
 		}
 
-		delete[] m_imageBuffer;
+		// Only the sprites that moved or changed are uploaded again, as long as the sheet kept its size and format
+		unsigned char* previousImageBuffer = m_imageBuffer;
 		m_imageBuffer = packer.allocImageBuffer();
-		m_texture->updateBuffer(m_imageBuffer, packer.getWidth(), packer.getHeight(), packer.getChannels(), nullptr);
+		m_texture->updateChangedRegions(
+			m_imageChannels == packer.getChannels() ? previousImageBuffer : nullptr,
+			m_imageBuffer,
+			packer.getWidth(),
+			packer.getHeight(),
+			packer.getChannels(),
+			nullptr);
+		m_imageChannels = packer.getChannels();
+		delete[] previousImageBuffer;
 	}
 
 	void SpriteSheet::addSprite(std::string const& textureId)
@@ -135,6 +145,7 @@ namespace DerydocaEngine::UI
 			auto r = ObjectLibrary::getInstance().getResource(textureUuid);
 			int imgw, imgh, imgch;
 			m_imageBuffer = stbi_load(r->getSourceFilePath().c_str(), &imgw, &imgh, &imgch, 0);
+			m_imageChannels = imgch;
 			m_texture->updateBuffer(m_imageBuffer, imgw, imgh, imgch, nullptr);
 		}
 
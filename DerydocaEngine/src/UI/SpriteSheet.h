@@ -34,6 +34,7 @@ namespace DerydocaEngine::UI
 	private:
 		std::map<int, SpriteReference> m_sprites;
 		unsigned char* m_imageBuffer;
+		int m_imageChannels;
 		unsigned int m_largestId;
 		std::shared_ptr<Rendering::Texture> m_texture;
 	};
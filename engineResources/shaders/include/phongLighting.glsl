@@ -0,0 +1,31 @@
+struct LightInfo {
+    vec4 Position; // Eye coords
+    vec4 La; // Ambient intensity
+    vec4 Ld; // Diffuse intensity
+    vec4 Ls; // Specular intensity
+};
+uniform LightInfo Lights[10];
+
+struct MaterialInfo {
+    vec4 Ka; // Ambient
+    vec4 Kd; // Diffuse
+    vec4 Ks; // Specular
+    float Shininess; // Specular power
+};
+uniform MaterialInfo Material;
+
+vec4 phongModel(vec4 position, vec3 norm, int lightIndex)
+{
+    vec3 s = normalize(vec3(Lights[lightIndex].Position - position));
+    vec3 v = normalize(-position.xyz);
+    vec3 r = reflect(-s, norm);
+    vec4 ambient = Lights[lightIndex].La * Material.Ka;
+    float sDotN = max(dot(s, norm), 0.0);
+    vec4 diffuse = Lights[lightIndex].Ld * Material.Kd * sDotN;
+    vec4 spec = vec4(0.0);
+    if(sDotN > 0.0)
+    {
+        spec = Lights[lightIndex].Ls * Material.Ks * pow(max(dot(r,v), 0.0), Material.Shininess);
+    }
+    return ambient + diffuse + spec;
+}
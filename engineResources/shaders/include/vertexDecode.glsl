@@ -0,0 +1,34 @@
+// Reads the vertex attributes that compressed vertex layouts store in another form
+#pragma keywords OCTAHEDRAL_NORMALS
+
+#ifdef OCTAHEDRAL_NORMALS
+in vec2 VertexNormal;
+#else
+in vec3 VertexNormal;
+#endif
+
+// Decodes normals stored with the octahedral vertex layout
+vec3 decodeOctahedral(vec2 encoded)
+{
+    vec3 n = vec3(encoded.xy, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+// Gets the normal of the vertex, whichever way the mesh stores it
+vec3 getVertexNormal()
+{
+#ifdef OCTAHEDRAL_NORMALS
+    return decodeOctahedral(VertexNormal);
+#else
+    return VertexNormal;
+#endif
+}
+
+// Rebuilds the bitangent dropped by compressed vertex layouts from the handedness stored in the tangent's w
+vec3 reconstructBitangent(vec3 normal, vec4 tangent)
+{
+    return cross(normal, tangent.xyz) * tangent.w;
+}
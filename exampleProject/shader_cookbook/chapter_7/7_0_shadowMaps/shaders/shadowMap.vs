@@ -1,10 +1,33 @@
 #version 400
+#pragma keywords INDIRECT_DRAW
+
+#ifdef INDIRECT_DRAW
+#extension GL_ARB_shader_storage_buffer_object : require
+#extension GL_ARB_shader_draw_parameters : require
+#endif
 
 in vec3 VertexPosition;
 
+#ifdef INDIRECT_DRAW
+// Matrices of every caster merged into the draw, indexed by the caster's base instance
+struct DrawData
+{
+    mat4 MVP;
+};
+
+layout(std430, binding = 0) readonly buffer DrawDataBuffer
+{
+    DrawData Draws[];
+};
+#else
 uniform mat4 MVP;
+#endif
 
 void main()
 {
+#ifdef INDIRECT_DRAW
+    gl_Position = Draws[gl_BaseInstanceARB].MVP * vec4(VertexPosition, 1.0);
+#else
     gl_Position = MVP * vec4(VertexPosition, 1.0);
-}
\ No newline at end of file
+#endif
+}
@@ -5,6 +5,9 @@ struct LightInfo
     vec4 Position;
     vec4 Intensity;
     mat4 ShadowMatrix;
+    int CascadeCount;
+    vec4 CascadeSplits;
+    mat4 CascadeShadowMatrices[4];
 };
 uniform LightInfo Lights[10];
 uniform int LightCount;
@@ -49,12 +52,27 @@ float getShadowInfluence(int lightIndex, vec4 ShadowCoord)
     return shadow;
 }
 
+vec4 getShadowCoord(int lightIndex)
+{
+    // Directional lights pick the first cascade that covers the fragment's view depth
+    float depth = -Position.z;
+    for(int c = 0; c < Lights[lightIndex].CascadeCount; c++)
+    {
+        if(depth <= Lights[lightIndex].CascadeSplits[c])
+        {
+            return Lights[lightIndex].CascadeShadowMatrices[c] * ModelCoord;
+        }
+    }
+
+    return Lights[lightIndex].ShadowMatrix * ModelCoord;
+}
+
 void main()
 {
     FragColor = vec4(0, 0, 0, 1);
     for(int i = 0; i < LightCount; i++)
     {
-        vec4 ShadowCoord = Lights[i].ShadowMatrix * ModelCoord;
+        vec4 ShadowCoord = getShadowCoord(i);
 
         float shadow = getShadowInfluence(i, ShadowCoord);
         vec3 diffAndSpec = ads(i);
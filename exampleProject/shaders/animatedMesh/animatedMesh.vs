@@ -1,4 +1,5 @@
 #version 400
+#pragma keywords SKINNED
 
 in vec3 VertexPosition;
 in vec3 VertexNormal;
@@ -13,8 +14,22 @@ struct LightInfo {
 };
 uniform LightInfo Lights[10];
 
-const uint MaxBoneCount = 150;
-uniform mat4 BoneMatrices[MaxBoneCount];
+#ifdef SKINNED
+// Palettes of every animated instance, one matrix column per texel
+uniform samplerBuffer BonePalettes;
+uniform int BonePaletteOffset;
+uniform int BonePaletteStride;
+
+mat4 getBoneMatrix(int boneIndex)
+{
+    int texel = (BonePaletteOffset + gl_InstanceID * BonePaletteStride + boneIndex) * 4;
+    return mat4(
+        texelFetch(BonePalettes, texel),
+        texelFetch(BonePalettes, texel + 1),
+        texelFetch(BonePalettes, texel + 2),
+        texelFetch(BonePalettes, texel + 3));
+}
+#endif
 
 uniform vec4 Kd;
 uniform vec4 Ka;
@@ -36,15 +51,19 @@ vec4 ads(int lightIndex, vec4 position, vec3 norm)
 
 void main()
 {
-    mat4 boneTransform = BoneMatrices[VertexBoneIndices[0]] * VertexBoneWeights[0];
+#ifdef SKINNED
+    mat4 boneTransform = getBoneMatrix(VertexBoneIndices[0]) * VertexBoneWeights[0];
     for(int i = 1; i < 4; i++)
     {
         int boneIndex = VertexBoneIndices[i];
         if(boneIndex > 0)
         {
-            boneTransform += BoneMatrices[boneIndex] * VertexBoneWeights[i];
+            boneTransform += getBoneMatrix(boneIndex) * VertexBoneWeights[i];
         }
     }
+#else
+    mat4 boneTransform = mat4(1.0);
+#endif
 
     vec3 eyeNorm = normalize(NormalMatrix * (boneTransform * vec4(VertexNormal, 0.0)).xyz);
     vec4 eyePosition = ModelViewMatrix * vec4(VertexPosition, 1.0);